@@ -1,4 +1,5 @@
 #include "Config.h"
+#include "../utils/AllocTracker.h"
 #include <Arduino.h>
 
 Config::Config()
@@ -32,6 +33,7 @@ bool Config::begin() {
 }
 
 bool Config::load() {
+    ALLOC_SCOPE(CONFIG);
     if (!initialized) {
         Serial.println("[Config] ERROR: Not initialized");
         return false;
@@ -65,6 +67,7 @@ bool Config::load() {
     ui.haptic_enabled = prefs.getBool("ui_haptic", true);
     ui.show_seconds = prefs.getBool("ui_seconds", true);
     ui.screen_timeout_sec = prefs.getUChar("ui_timeout", 30);
+    prefs.getString("ui_theme", ui.sound_theme, sizeof(ui.sound_theme));
 
     // Load Network settings
     prefs.getString("net_ssid", network.wifi_ssid, sizeof(network.wifi_ssid));
@@ -74,11 +77,15 @@ bool Config::load() {
     prefs.getString("net_client", network.mqtt_client_id, sizeof(network.mqtt_client_id));
     network.cloud_sync_enabled = prefs.getBool("net_sync", false);
     network.sync_interval_min = prefs.getUShort("net_interval", 5);
+    network.dashboard_enabled = prefs.getBool("net_dash", false);
+    prefs.getString("net_dash_tok", network.dashboard_token, sizeof(network.dashboard_token));
+    network.shadow_version = prefs.getUInt("net_shver", 0);
 
     // Load Power settings
     power.auto_sleep_enabled = prefs.getBool("pwr_auto", true);
     power.sleep_after_min = prefs.getUShort("pwr_timeout", 60);
-    power.wake_on_rotation = prefs.getBool("pwr_wake_rot", true);
+    power.wake_on_rotation = prefs.getBool("pwr_wake_rot", false);
+    power.motion_poll_interval_s = prefs.getUChar("pwr_mot_poll", 2);
     power.min_battery_percent = prefs.getUChar("pwr_min_bat", 10);
 
     dirty = false;
@@ -87,6 +94,7 @@ bool Config::load() {
 }
 
 bool Config::save() {
+    ALLOC_SCOPE(CONFIG);
     if (!initialized) {
         Serial.println("[Config] ERROR: Not initialized");
         return false;
@@ -116,6 +124,7 @@ bool Config::save() {
     prefs.putBool("ui_haptic", ui.haptic_enabled);
     prefs.putBool("ui_seconds", ui.show_seconds);
     prefs.putUChar("ui_timeout", ui.screen_timeout_sec);
+    prefs.putString("ui_theme", ui.sound_theme);
 
     // Save Network settings
     prefs.putString("net_ssid", network.wifi_ssid);
@@ -125,11 +134,15 @@ bool Config::save() {
     prefs.putString("net_client", network.mqtt_client_id);
     prefs.putBool("net_sync", network.cloud_sync_enabled);
     prefs.putUShort("net_interval", network.sync_interval_min);
+    prefs.putBool("net_dash", network.dashboard_enabled);
+    prefs.putString("net_dash_tok", network.dashboard_token);
+    prefs.putUInt("net_shver", network.shadow_version);
 
     // Save Power settings
     prefs.putBool("pwr_auto", power.auto_sleep_enabled);
     prefs.putUShort("pwr_timeout", power.sleep_after_min);
     prefs.putBool("pwr_wake_rot", power.wake_on_rotation);
+    prefs.putUChar("pwr_mot_poll", power.motion_poll_interval_s);
     prefs.putUChar("pwr_min_bat", power.min_battery_percent);
 
     dirty = false;
@@ -1,7 +1,7 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-#include <Preferences.h>
+#include "../utils/NvsPreferences.h"
 #include <cstdint>
 
 /**
@@ -29,6 +29,11 @@ public:
         uint16_t custom_work_min = 15;         // Custom default: 15min
         uint16_t custom_short_break_min = 3;   // Custom default: 3min
         uint16_t custom_long_break_min = 10;   // Custom default: 10min
+
+        // Auto-start policy for the session the sequence just advanced to
+        bool shouldAutoStart(bool next_is_work) const {
+            return next_is_work ? auto_start_work : auto_start_breaks;
+        }
     };
 
     // UI preferences
@@ -39,6 +44,7 @@ public:
         bool haptic_enabled = true;
         bool show_seconds = true;
         uint8_t screen_timeout_sec = 30;       // 0 = never
+        char sound_theme[24] = "default";      // SD folder /audio/themes/<name>/
     };
 
     // Network settings
@@ -50,13 +56,17 @@ public:
         char mqtt_client_id[32] = "";
         bool cloud_sync_enabled = false;
         uint16_t sync_interval_min = 5;
+        bool dashboard_enabled = false;        // HTTP dashboard (port 80) while on WiFi
+        char dashboard_token[33] = "";         // Bearer secret for /api/* ("" = API refused)
+        uint32_t shadow_version = 0;           // Last applied device shadow delta version
     };
 
     // Power management
     struct PowerSettings {
         bool auto_sleep_enabled = true;
         uint16_t sleep_after_min = 60;         // Minutes of inactivity
-        bool wake_on_rotation = true;
+        bool wake_on_rotation = false;         // Opt-in: polls the IMU from deep sleep (mA, see PowerManager)
+        uint8_t motion_poll_interval_s = 2;    // Deep sleep motion poll period (wake latency)
         uint8_t min_battery_percent = 10;      // Low battery warning
     };
 
@@ -88,7 +98,7 @@ public:
     void markDirty() { dirty = true; }
 
 private:
-    Preferences prefs;
+    NvsPreferences prefs;
     bool initialized = false;
     bool dirty = false;
 
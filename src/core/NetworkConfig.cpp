@@ -1,4 +1,5 @@
 #include "NetworkConfig.h"
+#include "../utils/AllocTracker.h"
 #include <Arduino.h>
 #include <minIniFS.h>
 #include <esp_heap_caps.h>
@@ -17,6 +18,7 @@ NetworkConfig::~NetworkConfig() {
 }
 
 bool NetworkConfig::load() {
+    ALLOC_SCOPE(NETWORK_CONFIG);
     if (!sd.isMounted()) {
         Serial.println("[NetworkConfig] ERROR: SD card not mounted");
         return false;
@@ -110,6 +112,47 @@ bool NetworkConfig::loadIniFile() {
     cloud_sync.enabled = ini.getbool("CloudSync", "Enabled", false);
     cloud_sync.sync_interval_min = ini.geti("CloudSync", "SyncIntervalMin", 5);
 
+    // Load Toggl settings
+    toggl.enabled = ini.getbool("Toggl", "Enabled", false);
+    String toggl_token = ini.gets("Toggl", "APIToken", "");
+    if (toggl_token.length() > 0) {
+        strncpy(toggl.api_token, toggl_token.c_str(), sizeof(toggl.api_token) - 1);
+        toggl.api_token[sizeof(toggl.api_token) - 1] = '\0';
+    }
+    toggl.workspace_id = ini.geti("Toggl", "WorkspaceID", 0);
+    toggl.project_id = ini.geti("Toggl", "ProjectID", 0);
+    String toggl_tags = ini.gets("Toggl", "Tags", toggl.tags);
+    strncpy(toggl.tags, toggl_tags.c_str(), sizeof(toggl.tags) - 1);
+    toggl.tags[sizeof(toggl.tags) - 1] = '\0';
+
+    // Load Google Calendar settings
+    calendar.enabled = ini.getbool("GoogleCalendar", "Enabled", false);
+    String gcal_client_id = ini.gets("GoogleCalendar", "ClientID", "");
+    if (gcal_client_id.length() > 0) {
+        strncpy(calendar.client_id, gcal_client_id.c_str(), sizeof(calendar.client_id) - 1);
+        calendar.client_id[sizeof(calendar.client_id) - 1] = '\0';
+    }
+
+    String gcal_secret = ini.gets("GoogleCalendar", "ClientSecret", "");
+    if (gcal_secret.length() > 0) {
+        strncpy(calendar.client_secret, gcal_secret.c_str(), sizeof(calendar.client_secret) - 1);
+        calendar.client_secret[sizeof(calendar.client_secret) - 1] = '\0';
+    }
+
+    String gcal_refresh = ini.gets("GoogleCalendar", "RefreshToken", "");
+    if (gcal_refresh.length() > 0) {
+        strncpy(calendar.refresh_token, gcal_refresh.c_str(), sizeof(calendar.refresh_token) - 1);
+        calendar.refresh_token[sizeof(calendar.refresh_token) - 1] = '\0';
+    }
+
+    String gcal_calendar = ini.gets("GoogleCalendar", "CalendarID", "primary");
+    if (gcal_calendar.length() > 0) {
+        strncpy(calendar.calendar_id, gcal_calendar.c_str(), sizeof(calendar.calendar_id) - 1);
+        calendar.calendar_id[sizeof(calendar.calendar_id) - 1] = '\0';
+    }
+
+    calendar.color_id = constrain(ini.geti("GoogleCalendar", "ColorID", 11), 1, 11);
+
     // Load NTP settings
     String ntp_server = ini.gets("NTP", "Server", "pool.ntp.org");
     if (ntp_server.length() > 0) {
@@ -134,6 +177,9 @@ bool NetworkConfig::loadIniFile() {
     Serial.printf("[NetworkConfig] CloudSync: %s (interval: %d min)\n",
                   cloud_sync.enabled ? "enabled" : "disabled",
                   cloud_sync.sync_interval_min);
+    Serial.printf("[NetworkConfig] Toggl: %s, Google Calendar: %s\n",
+                  toggl.enabled ? "enabled" : "disabled",
+                  calendar.enabled ? "enabled" : "disabled");
     Serial.printf("[NetworkConfig] NTP: %s (offset: %ld sec)\n",
                   ntp.server, ntp.timezone_offset);
 
@@ -141,6 +187,7 @@ bool NetworkConfig::loadIniFile() {
 }
 
 bool NetworkConfig::loadCertificates() {
+    ALLOC_SCOPE(NETWORK_CONFIG);
     if (!loaded) {
         Serial.println("[NetworkConfig] ERROR: Load configuration first with load()");
         return false;
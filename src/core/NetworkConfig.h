@@ -16,7 +16,7 @@
  * - Config (NVS): User preferences (pomodoro settings, UI, power)
  *
  * File structure:
- * - /config/network.ini - WiFi, MQTT, CloudSync, NTP configuration
+ * - /config/network.ini - WiFi, MQTT, CloudSync, Toggl, GoogleCalendar, NTP configuration
  * - /config/certs/AmazonRootCA1.pem - AWS IoT Root CA certificate
  * - /config/certs/device-certificate.pem.crt - Device certificate
  * - /config/certs/device-private.pem.key - Private key (SECRET)
@@ -74,6 +74,30 @@ public:
         uint16_t sync_interval_min = 5;       // Sync interval in minutes
     };
 
+    /**
+     * Toggl Track time entries (one per completed work session)
+     */
+    struct TogglSettings {
+        bool enabled = false;
+        char api_token[48] = "";              // Profile > API Token (SECRET)
+        uint32_t workspace_id = 0;
+        uint32_t project_id = 0;              // Optional (0 = none)
+        char tags[64] = "pomodoro";           // Comma-separated
+    };
+
+    /**
+     * Google Calendar events (one per completed work session)
+     * OAuth2 refresh token of an installed-app client, exchanged on the device
+     */
+    struct CalendarSettings {
+        bool enabled = false;
+        char client_id[96] = "";
+        char client_secret[48] = "";          // SECRET
+        char refresh_token[128] = "";         // SECRET
+        char calendar_id[96] = "primary";
+        uint8_t color_id = 11;                // 1-11 (11 = red)
+    };
+
     /**
      * NTP time synchronization settings
      */
@@ -125,6 +149,12 @@ public:
      */
     const CloudSyncSettings& getCloudSync() const { return cloud_sync; }
 
+    /**
+     * Get Toggl / Google Calendar settings
+     */
+    const TogglSettings& getToggl() const { return toggl; }
+    const CalendarSettings& getCalendar() const { return calendar; }
+
     /**
      * Get NTP settings
      */
@@ -168,6 +198,8 @@ private:
     MQTTSettings mqtt;
     CertPaths cert_paths;
     CloudSyncSettings cloud_sync;
+    TogglSettings toggl;
+    CalendarSettings calendar;
     NTPSettings ntp;
 
     // Certificate content buffers (allocated from PSRAM if available)
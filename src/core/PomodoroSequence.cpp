@@ -1,6 +1,12 @@
 #include "PomodoroSequence.h"
 #include <Arduino.h>
 
+// Classic 25/5/15 × 4: W B W B W B W LB = 4×25 + 3×5 + 15 min
+static_assert(PomodoroSequence::buildSchedule(25, 5, 15, 4, 1).count == 8, "Classic interval count");
+static_assert(PomodoroSequence::buildSchedule(25, 5, 15, 4, 1).total_min == 130, "Classic sequence length");
+static_assert(PomodoroSequence::buildSchedule(25, 5, 15, 4, 1).intervals[7].type ==
+              PomodoroSequence::SessionType::LONG_BREAK, "Long break closes the cycle");
+
 PomodoroSequence::PomodoroSequence()
     : current_session(1),
       completed_today(0),
@@ -8,27 +14,34 @@ PomodoroSequence::PomodoroSequence()
       custom_work_min(25),
       custom_short_break_min(5),
       custom_long_break_min(15),
-      custom_sessions_before_long(4) {
+      custom_sessions_before_long(4),
+      custom_num_cycles(1) {
+    rebuildSchedule();
 }
 
 void PomodoroSequence::setWorkDuration(uint16_t minutes) {
     custom_work_min = minutes;
+    rebuildSchedule();
 }
 
 void PomodoroSequence::setShortBreakDuration(uint16_t minutes) {
     custom_short_break_min = minutes;
+    rebuildSchedule();
 }
 
 void PomodoroSequence::setLongBreakDuration(uint16_t minutes) {
     custom_long_break_min = minutes;
+    rebuildSchedule();
 }
 
 void PomodoroSequence::setSessionsBeforeLong(uint8_t count) {
-    custom_sessions_before_long = constrain(count, 2, 8);  // Reasonable limits
+    custom_sessions_before_long = constrain(count, MIN_SESSIONS_BEFORE_LONG, MAX_SESSIONS_BEFORE_LONG);  // Reasonable limits
+    rebuildSchedule();
 }
 
 void PomodoroSequence::setNumCycles(uint8_t cycles) {
-    custom_num_cycles = constrain(cycles, 1, 4);  // Reasonable limits (1-4 cycles)
+    custom_num_cycles = constrain(cycles, MIN_CYCLES, MAX_CYCLES);  // Reasonable limits (1-4 cycles)
+    rebuildSchedule();
 }
 
 void PomodoroSequence::start() {
@@ -42,10 +55,11 @@ void PomodoroSequence::reset() {
 }
 
 PomodoroSequence::Session PomodoroSequence::getCurrentSession() const {
+    const Interval& interval = getInterval(current_session);
     Session session;
     session.number = current_session;
-    session.type = getSessionType(current_session);
-    session.duration_min = getSessionDuration(session.type);
+    session.type = interval.type;
+    session.duration_min = interval.duration_min;
     return session;
 }
 
@@ -58,10 +72,11 @@ PomodoroSequence::Session PomodoroSequence::getNextSession() const {
         next_session = 1;
     }
 
+    const Interval& interval = getInterval(next_session);
     Session session;
     session.number = next_session;
-    session.type = getSessionType(next_session);
-    session.duration_min = getSessionDuration(session.type);
+    session.type = interval.type;
+    session.duration_min = interval.duration_min;
     return session;
 }
 
@@ -70,10 +85,10 @@ bool PomodoroSequence::advance() {
     current_session++;
 
     // Wrap around to 1 after completing full cycle
+    // (completed_today counts work sessions, TimerStateMachine adds them on TIMEOUT)
     bool cycle_completed = false;
     if (current_session > total) {
         current_session = 1;
-        completed_today++;
         cycle_completed = true;
         Serial.println("[PomodoroSequence] Cycle completed! Starting new cycle");
     }
@@ -84,27 +99,12 @@ bool PomodoroSequence::advance() {
 // MP-51: New methods to distinguish work sessions from intervals
 
 uint8_t PomodoroSequence::getTotalWorkSessions() const {
-    return custom_sessions_before_long * custom_num_cycles;
+    return schedule_.work_sessions;
 }
 
 uint8_t PomodoroSequence::getCurrentWorkSession() const {
-    // Count completed work sessions + 1 if currently in work session
-    uint8_t completed_work = 0;
-
-    // Count work sessions before current
-    for (uint8_t i = 1; i < current_session; i++) {
-        if (getSessionType(i) == SessionType::WORK) {
-            completed_work++;
-        }
-    }
-
-    // Add 1 if currently in work session
-    if (isWorkSession()) {
-        return completed_work + 1;
-    }
-
-    // If in break, return the last work session number
-    return completed_work > 0 ? completed_work : 1;
+    // Work: its own number; break: the work session just finished
+    return getInterval(current_session).work_session;
 }
 
 uint8_t PomodoroSequence::getSessionsBeforeLong() const {
@@ -125,7 +125,7 @@ bool PomodoroSequence::isNextLongBreak() const {
 uint8_t PomodoroSequence::getTotalIntervals() const {
     // Each cycle: sessions × 2 intervals (work + break)
     // Total: cycles × sessions × 2
-    return custom_sessions_before_long * 2 * custom_num_cycles;
+    return schedule_.count;
 }
 
 // Legacy method (for compatibility during refactor)
@@ -146,6 +146,23 @@ bool PomodoroSequence::isLongBreak() const {
     return getSessionType(current_session) == SessionType::LONG_BREAK;
 }
 
+const PomodoroSequence::Interval& PomodoroSequence::getInterval(uint8_t number) const {
+    // Numbers beyond the table wrap like advance() does
+    if (number < 1) {
+        number = 1;
+    }
+    return schedule_.intervals[(number - 1) % schedule_.count];
+}
+
+uint16_t PomodoroSequence::getMinutesAfterCurrent() const {
+    const Interval& current = getInterval(current_session);
+    return schedule_.total_min - current.start_min - current.duration_min;
+}
+
+uint32_t PomodoroSequence::getSecondsToSequenceEnd(uint32_t current_remaining_s) const {
+    return current_remaining_s + static_cast<uint32_t>(getMinutesAfterCurrent()) * 60;
+}
+
 void PomodoroSequence::resetDailyCounter() {
     completed_today = 0;
 }
@@ -173,34 +190,13 @@ void PomodoroSequence::deserialize(uint32_t data) {
 
 // Private methods
 
+void PomodoroSequence::rebuildSchedule() {
+    schedule_ = buildSchedule(custom_work_min, custom_short_break_min, custom_long_break_min,
+                              custom_sessions_before_long, custom_num_cycles);
+}
+
 PomodoroSequence::SessionType PomodoroSequence::getSessionType(uint8_t session_num) const {
-    // Settings-based logic: uses only custom_sessions_before_long
-    // Pattern repeats every cycle: W-B-W-B-...-W-LB
+    // Pattern repeats every cycle: W-B-W-B-...-W-LB (see buildSchedule)
     // Example (4 sessions/cycle): W B W B W B W LB | W B W B W B W LB ...
-    uint8_t intervals_per_cycle = custom_sessions_before_long * 2;
-
-    // Long break at end of each cycle (sessions 4, 8, 12, etc.)
-    if (session_num % intervals_per_cycle == 0) {
-        return SessionType::LONG_BREAK;
-    }
-
-    // Short break on even intervals (but not long breaks)
-    if (session_num % 2 == 0) {
-        return SessionType::SHORT_BREAK;
-    }
-
-    // Work on odd intervals
-    return SessionType::WORK;
+    return getInterval(session_num).type;
 }
-
-uint16_t PomodoroSequence::getSessionDuration(SessionType type) const {
-    // All modes now use custom durations (set via setWorkDuration(), etc.)
-    // Defaults: CLASSIC (25/5/15), STUDY (45/15/15), or user-configured values
-    switch (type) {
-        case SessionType::WORK: return custom_work_min;
-        case SessionType::SHORT_BREAK: return custom_short_break_min;
-        case SessionType::LONG_BREAK: return custom_long_break_min;
-    }
-
-    return 25;  // Default fallback
-}
\ No newline at end of file
@@ -19,6 +19,13 @@
  * - Classic: 25/5/15 min, 4 sessions, 1 cycle
  * - Study: 45/15/30 min, 2 sessions, 2 cycles
  * - Custom: any duration/session/cycle combination
+ *
+ * Schedule table:
+ * The settings are compiled into a table of intervals (type, duration,
+ * work session number, start offset) by buildSchedule(), rebuilt only
+ * when a setter changes them. Per-frame queries from MainScreen are
+ * table lookups, and the remaining time to the end of the sequence
+ * ("ends at HH:MM") is a single subtraction.
  */
 class PomodoroSequence {
 public:
@@ -34,6 +41,65 @@ public:
         uint16_t duration_min;
     };
 
+    static constexpr uint8_t MIN_SESSIONS_BEFORE_LONG = 2;
+    static constexpr uint8_t MAX_SESSIONS_BEFORE_LONG = 8;
+    static constexpr uint8_t MIN_CYCLES = 1;
+    static constexpr uint8_t MAX_CYCLES = 4;
+    static constexpr uint8_t MAX_INTERVALS = MAX_SESSIONS_BEFORE_LONG * 2 * MAX_CYCLES;
+
+    struct Interval {
+        SessionType type;
+        uint8_t work_session;    // 1-based work session (breaks: the one just finished)
+        uint16_t duration_min;
+        uint16_t start_min;      // Offset from the start of the sequence
+    };
+
+    struct Schedule {
+        Interval intervals[MAX_INTERVALS];
+        uint8_t count;           // Intervals in use (sessions_before_long × 2 × num_cycles)
+        uint8_t work_sessions;
+        uint16_t total_min;      // Length of the whole sequence
+    };
+
+    /**
+     * Compile settings into a schedule table
+     * Pattern per cycle: W-B-W-B-...-W-LB (long break closes every cycle)
+     */
+    static constexpr Schedule buildSchedule(uint16_t work_min, uint16_t short_break_min,
+                                            uint16_t long_break_min, uint8_t sessions_before_long,
+                                            uint8_t num_cycles) {
+        Schedule schedule{};
+        uint8_t per_cycle = sessions_before_long * 2;
+        uint16_t count = per_cycle * num_cycles;
+        if (count > MAX_INTERVALS) {
+            count = MAX_INTERVALS;
+        }
+
+        uint16_t start_min = 0;
+        for (uint16_t i = 0; i < count; i++) {
+            uint8_t number = i + 1;
+            Interval& interval = schedule.intervals[i];
+            if (number % per_cycle == 0) {
+                interval.type = SessionType::LONG_BREAK;
+                interval.duration_min = long_break_min;
+            } else if (number % 2 == 0) {
+                interval.type = SessionType::SHORT_BREAK;
+                interval.duration_min = short_break_min;
+            } else {
+                interval.type = SessionType::WORK;
+                interval.duration_min = work_min;
+            }
+            interval.work_session = (number + 1) / 2;
+            interval.start_min = start_min;
+            start_min += interval.duration_min;
+        }
+
+        schedule.count = count;
+        schedule.work_sessions = count / 2;
+        schedule.total_min = start_min;
+        return schedule;
+    }
+
     PomodoroSequence();
 
     // Configuration (durations and cycle settings)
@@ -60,6 +126,17 @@ public:
     bool isLongBreak() const;
     bool isNextLongBreak() const;              // True if next interval is long break
 
+    // Schedule queries (table lookups)
+    const Schedule& getSchedule() const { return schedule_; }
+    const Interval& getInterval(uint8_t number) const;   // 1-based interval number
+    uint16_t getMinutesAfterCurrent() const;   // Intervals after the current one, to the end of the sequence
+
+    /**
+     * Seconds until the whole sequence ends ("ends at HH:MM" projection)
+     * @param current_remaining_s Time left in the current interval
+     */
+    uint32_t getSecondsToSequenceEnd(uint32_t current_remaining_s) const;
+
     // Internal methods (for compatibility during refactor)
     uint8_t getCurrentSessionNumber() const { return current_session; }  // Returns interval number
     uint8_t getTotalIntervals() const;         // Total intervals (sessions_before_long × 2 × num_cycles)
@@ -67,7 +144,11 @@ public:
 
     // Daily reset (call at midnight)
     void resetDailyCounter();
-    void incrementCompletedToday() { completed_today++; }
+
+    // Saturates at 255 instead of wrapping (uint8_t, shown on MainScreen)
+    void incrementCompletedToday() {
+        if (completed_today < UINT8_MAX) completed_today++;
+    }
 
     // Serialization for NVS storage
     uint32_t serialize() const;
@@ -85,8 +166,10 @@ private:
     uint8_t custom_sessions_before_long = 4;
     uint8_t custom_num_cycles = 1;
 
+    Schedule schedule_;              // Rebuilt by the setters
+
+    void rebuildSchedule();
     SessionType getSessionType(uint8_t session_num) const;
-    uint16_t getSessionDuration(SessionType type) const;
 };
 
 #endif // POMODORO_SEQUENCE_H
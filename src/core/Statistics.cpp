@@ -1,8 +1,21 @@
 #include "Statistics.h"
+#include "../utils/AllocTracker.h"
 #include "SyncPrimitives.h"
 #include "../utils/MutexGuard.h"
 #include <Arduino.h>
 #include <sys/time.h>
+#include <limits>
+
+// Day counters and totals saturate instead of wrapping on long uptimes
+template <typename T>
+static void addSaturating(T& counter, uint32_t amount) {
+    uint32_t sum = static_cast<uint32_t>(counter) + amount;
+    counter = sum > std::numeric_limits<T>::max() ? std::numeric_limits<T>::max() : static_cast<T>(sum);
+}
+
+static uint16_t clampTotal(uint32_t total) {
+    return total > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(total);
+}
 
 Statistics::Statistics()
     : initialized(false), cache_valid(false) {
@@ -32,6 +45,7 @@ bool Statistics::begin() {
 }
 
 void Statistics::recordWorkSession(uint16_t duration_min, bool completed) {
+    ALLOC_SCOPE(STATS);
     MutexGuard guard(g_stats_mutex, "g_stats_mutex", 100);
     if (!guard.isLocked()) {
         Serial.println("[Statistics] ERROR: Failed to acquire mutex in recordWorkSession");
@@ -43,10 +57,10 @@ void Statistics::recordWorkSession(uint16_t duration_min, bool completed) {
     ensureTodayExists();
 
     if (completed) {
-        today_cache.completed_sessions++;
-        today_cache.work_minutes += duration_min;
+        addSaturating(today_cache.completed_sessions, 1);
+        addSaturating(today_cache.work_minutes, duration_min);
     } else {
-        today_cache.interruptions++;
+        addSaturating(today_cache.interruptions, 1);
     }
 
     cache_valid = true;
@@ -57,6 +71,7 @@ void Statistics::recordWorkSession(uint16_t duration_min, bool completed) {
 }
 
 void Statistics::recordBreakSession(uint16_t duration_min) {
+    ALLOC_SCOPE(STATS);
     MutexGuard guard(g_stats_mutex, "g_stats_mutex", 100);
     if (!guard.isLocked()) {
         Serial.println("[Statistics] ERROR: Failed to acquire mutex in recordBreakSession");
@@ -67,7 +82,7 @@ void Statistics::recordBreakSession(uint16_t duration_min) {
 
     ensureTodayExists();
 
-    today_cache.break_minutes += duration_min;
+    addSaturating(today_cache.break_minutes, duration_min);
     cache_valid = true;
     saveTodayCache();
 
@@ -75,6 +90,7 @@ void Statistics::recordBreakSession(uint16_t duration_min) {
 }
 
 void Statistics::recordInterruption() {
+    ALLOC_SCOPE(STATS);
     MutexGuard guard(g_stats_mutex, "g_stats_mutex", 100);
     if (!guard.isLocked()) {
         Serial.println("[Statistics] ERROR: Failed to acquire mutex in recordInterruption");
@@ -85,7 +101,7 @@ void Statistics::recordInterruption() {
 
     ensureTodayExists();
 
-    today_cache.interruptions++;
+    addSaturating(today_cache.interruptions, 1);
     cache_valid = true;
     saveTodayCache();
 
@@ -114,14 +130,14 @@ Statistics::DayStats Statistics::getDate(uint32_t epoch_days) const {
     DayStats stats;
 
     // Check if key exists first (avoid NVS "NOT_FOUND" errors)
-    if (!const_cast<Preferences&>(prefs).isKey(key)) {
+    if (!const_cast<NvsPreferences&>(prefs).isKey(key)) {
         // No data for this day
         return DayStats();
     }
 
     // Read from NVS (need mutable access to prefs)
     size_t len = sizeof(DayStats);
-    if (!const_cast<Preferences&>(prefs).getBytes(key, &stats, len)) {
+    if (!const_cast<NvsPreferences&>(prefs).getBytes(key, &stats, len)) {
         // Failed to read data
         return DayStats();
     }
@@ -161,56 +177,56 @@ uint16_t Statistics::getTotalCompleted() const {
     if (!initialized) return 0;
 
     // Sum all completed sessions across all days
-    uint16_t total = 0;
+    uint32_t total = 0;
 
     for (uint8_t i = 0; i < MAX_DAYS; i++) {
         char key[16];
         snprintf(key, sizeof(key), "day_%u", i);
 
         // Check if key exists first (avoid NVS "NOT_FOUND" errors)
-        if (!const_cast<Preferences&>(prefs).isKey(key)) {
+        if (!const_cast<NvsPreferences&>(prefs).isKey(key)) {
             continue;
         }
 
         DayStats stats;
         size_t len = sizeof(DayStats);
-        if (const_cast<Preferences&>(prefs).getBytes(key, &stats, len)) {
+        if (const_cast<NvsPreferences&>(prefs).getBytes(key, &stats, len)) {
             total += stats.completed_sessions;
         }
     }
 
-    return total;
+    return clampTotal(total);
 }
 
 uint16_t Statistics::getLast7DaysTotal() const {
     DayStats days[7];
     getLast7Days(days);
 
-    uint16_t total = 0;
+    uint32_t total = 0;
     for (int i = 0; i < 7; i++) {
         total += days[i].completed_sessions;
     }
 
-    return total;
+    return clampTotal(total);
 }
 
 uint16_t Statistics::getLast30DaysTotal() const {
     DayStats days[30];
     getLast30Days(days);
 
-    uint16_t total = 0;
+    uint32_t total = 0;
     for (int i = 0; i < 30; i++) {
         total += days[i].completed_sessions;
     }
 
-    return total;
+    return clampTotal(total);
 }
 
 float Statistics::getCompletionRate() const {
     if (!initialized) return 0.0f;
 
-    uint16_t completed = 0;
-    uint16_t interrupted = 0;
+    uint32_t completed = 0;
+    uint32_t interrupted = 0;
 
     // Sum last 30 days
     DayStats days[30];
@@ -221,7 +237,7 @@ float Statistics::getCompletionRate() const {
         interrupted += days[i].interruptions;
     }
 
-    uint16_t total = completed + interrupted;
+    uint32_t total = completed + interrupted;
     if (total == 0) return 0.0f;
 
     return (completed * 100.0f) / total;
@@ -267,7 +283,11 @@ void Statistics::clear() {
 uint32_t Statistics::getTodayEpochDays() const {
     // Get current time in seconds since Unix epoch
     struct timeval tv;
+#ifdef NATIVE_BUILD
+    arduino_shim::gettimeofday(&tv, nullptr);   // Virtual wall clock in host tests
+#else
     gettimeofday(&tv, nullptr);
+#endif
     uint32_t epoch = tv.tv_sec;
 
     // Convert to days since epoch
@@ -1,7 +1,7 @@
 #ifndef STATISTICS_H
 #define STATISTICS_H
 
-#include <Preferences.h>
+#include "../utils/NvsPreferences.h"
 #include <cstdint>
 #include <ctime>
 #include <freertos/FreeRTOS.h>
@@ -54,7 +54,7 @@ public:
     void getLast7Days(DayStats* out_array) const;
     void getLast30Days(DayStats* out_array) const;
 
-    // Aggregated stats
+    // Aggregated stats (totals saturate at UINT16_MAX)
     uint16_t getTotalCompleted() const;        // All-time total
     uint16_t getLast7DaysTotal() const;
     uint16_t getLast30DaysTotal() const;
@@ -65,7 +65,7 @@ public:
     void clear();                              // Clear all statistics
 
 private:
-    Preferences prefs;
+    NvsPreferences prefs;
     bool initialized = false;
 
     static constexpr const char* NAMESPACE = "stats";
@@ -42,6 +42,7 @@ bool initSyncPrimitives() {
         Serial.println("[SyncPrimitives] ERROR: Failed to create shadowPublishQueue");
         return false;
     }
+    vQueueAddToRegistry(g_shadowPublishQueue, "shadowPublishQueue");
     Serial.println("[SyncPrimitives] ✓ shadowPublishQueue created (10 items, Core 0 → Core 1)");
 
     g_networkStatusQueue = xQueueCreate(5, sizeof(NetworkStatus));
@@ -50,6 +51,7 @@ bool initSyncPrimitives() {
         cleanupSyncPrimitives();
         return false;
     }
+    vQueueAddToRegistry(g_networkStatusQueue, "networkStatusQueue");
     Serial.println("[SyncPrimitives] ✓ networkStatusQueue created (5 items, Core 1 → Core 0)");
 
     // Create mutexes
@@ -59,6 +61,7 @@ bool initSyncPrimitives() {
         cleanupSyncPrimitives();
         return false;
     }
+    vQueueAddToRegistry(g_i2c_mutex, "i2c_mutex");
     Serial.println("[SyncPrimitives] ✓ i2c_mutex created (protects I2C bus: gyro + HMI)");
 
     g_display_mutex = xSemaphoreCreateMutex();
@@ -67,6 +70,7 @@ bool initSyncPrimitives() {
         cleanupSyncPrimitives();
         return false;
     }
+    vQueueAddToRegistry(g_display_mutex, "display_mutex");
     Serial.println("[SyncPrimitives] ✓ display_mutex created (protects M5.Display SPI)");
 
     g_stats_mutex = xSemaphoreCreateMutex();
@@ -75,6 +79,7 @@ bool initSyncPrimitives() {
         cleanupSyncPrimitives();
         return false;
     }
+    vQueueAddToRegistry(g_stats_mutex, "stats_mutex");
     Serial.println("[SyncPrimitives] ✓ stats_mutex created (protects Statistics NVS)");
 
     g_shadow_state_mutex = xSemaphoreCreateMutex();
@@ -83,6 +88,7 @@ bool initSyncPrimitives() {
         cleanupSyncPrimitives();
         return false;
     }
+    vQueueAddToRegistry(g_shadow_state_mutex, "shadow_state_mutex");
     Serial.println("[SyncPrimitives] ✓ shadow_state_mutex created (protects Shadow document)");
 
     // Create event groups
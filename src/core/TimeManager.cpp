@@ -4,7 +4,7 @@
 #include <time.h>
 
 // External global pointer (defined in main.cpp)
-extern SDManager* g_sdManager;
+extern SDWorker* g_sdWorker;
 
 TimeManager::TimeManager()
     : ntp_client(nullptr),
@@ -119,9 +119,10 @@ bool TimeManager::syncNow() {
     // Calculate midnight boundary
     calculateMidnight();
 
-    // Save to SD card emergency file (if available)
-    if (g_sdManager && g_sdManager->isMounted()) {
-        saveTimeToSD(*g_sdManager);
+    // Save to SD card emergency file (if available) - queued, the NTP
+    // path never waits for the card
+    if (g_sdWorker) {
+        saveTimeToSD(*g_sdWorker);
     }
 
     Serial.printf("[TimeManager] NTP synced: %lu (saved to RTC)\n", ntp_epoch);
@@ -383,17 +384,12 @@ bool TimeManager::loadTimeFromSD(SDManager& sd) {
     return true;
 }
 
-void TimeManager::saveTimeToSD(SDManager& sd) {
+void TimeManager::saveTimeToSD(SDWorker& sd) {
     // Only save if we have NTP-synced time
     if (!time_synced) {
         return;  // Silently skip if not synced
     }
 
-    // Validate SD is mounted
-    if (!sd.isMounted()) {
-        return;  // Silently skip if SD not available
-    }
-
     uint32_t epoch = getEpoch();
 
     // Validate epoch (must be after 2024-01-01)
@@ -401,9 +397,22 @@ void TimeManager::saveTimeToSD(SDManager& sd) {
         return;  // Don't save invalid time
     }
 
-    // Write Unix epoch timestamp as text file
-    if (sd.writeFile("/config/lasttime.txt", String(epoch))) {
-        Serial.printf("[TimeManager] Saved emergency time to SD: %lu\n", epoch);
+    // Write Unix epoch timestamp as text file. Low priority and coalesced:
+    // only the newest pending value reaches the card.
+    char text[12];
+    int len = snprintf(text, sizeof(text), "%lu", (unsigned long)epoch);
+    uint32_t id = sd.write("/config/lasttime.txt", reinterpret_cast<const uint8_t*>(text), len,
+                           onTimeSaved, nullptr, SDWorker::Priority::LOW);
+    if (id == 0) {
+        Serial.println("[TimeManager] WARN: SD queue full, time not saved");
+    }
+}
+
+void TimeManager::onTimeSaved(SDWorker::Result& result, void*) {
+    // Runs on the SD worker task
+    if (result.ok) {
+        Serial.printf("[TimeManager] Saved emergency time to SD (queued %lu ms)\n",
+                      (unsigned long)result.wait_ms);
     } else {
         Serial.println("[TimeManager] WARN: Failed to save time to SD");
     }
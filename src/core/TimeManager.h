@@ -6,6 +6,7 @@
 #include <NTPClient.h>
 #include <cstdint>
 #include <ctime>
+#include "../hardware/SDWorker.h"
 
 // Forward declaration
 class SDManager;
@@ -78,7 +79,7 @@ public:
     void update();
 
     // SD card persistence (emergency fallback only)
-    void saveTimeToSD(SDManager& sd);  // Save time to /config/lasttime.txt
+    void saveTimeToSD(SDWorker& sd);   // Queue save of time to /config/lasttime.txt (coalesced)
 
     // RTC drift compensation
     float getDriftPPM() const { return drift_ppm; }  // Parts per million
@@ -116,6 +117,7 @@ private:
     void updateDriftEstimate(uint32_t ntp_epoch);
     void calculateMidnight();
     bool loadTimeFromSD(SDManager& sd);            // Load emergency time from SD file
+    static void onTimeSaved(SDWorker::Result& result, void* ctx);  // SD worker completion
 };
 
 #endif // TIME_MANAGER_H
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "TimerStateMachine.h"
+#include "../utils/AllocTracker.h"
+#include "../utils/AudioLatency.h"
 #include "../utils/MutexGuard.h"
+#include "../utils/Placement.h"
 #include <Arduino.h>
 
 TimerStateMachine::TimerStateMachine(PomodoroSequence& seq)
@@ -12,6 +15,7 @@ TimerStateMachine::TimerStateMachine(PomodoroSequence& seq)
     if (state_mutex_ == NULL) {
         Serial.println("[TimerStateMachine] ERROR: Failed to create state mutex");
     } else {
+        vQueueAddToRegistry(state_mutex_, "timer_state_mutex");
         Serial.println("[TimerStateMachine] Mutex created (thread-safe)");
     }
 }
@@ -24,6 +28,7 @@ TimerStateMachine::~TimerStateMachine() {
 }
 
 bool TimerStateMachine::handleEvent(Event event) {
+    ALLOC_SCOPE(TIMER);
     MutexGuard guard(state_mutex_, "state_mutex", 50);
     if (!guard.isLocked()) {
         Serial.println("[TimerStateMachine] ERROR: Failed to acquire mutex in handleEvent");
@@ -111,6 +116,7 @@ bool TimerStateMachine::handleEvent(Event event) {
                 }
 
                 // Return to IDLE
+                uint32_t elapsed_ms = total_ms;
                 stopTimer();
                 bool transitioned = transition(State::IDLE);
 
@@ -118,6 +124,10 @@ bool TimerStateMachine::handleEvent(Event event) {
                 // The callback may call handleEvent(START) which needs to acquire the mutex
                 guard.unlock();
 
+                if (transitioned && session_callback) {
+                    session_callback(current_sess, elapsed_ms);
+                }
+
                 // Trigger timeout callback AFTER transitioning to IDLE
                 // This allows the callback to check the new session and auto-start if configured
                 // Skip auto-start if cycle completed - require manual start for new cycle
@@ -141,7 +151,8 @@ bool TimerStateMachine::handleEvent(Event event) {
     return false;
 }
 
-void TimerStateMachine::update(uint32_t delta_ms) {
+void HOT_IRAM TimerStateMachine::update(uint32_t delta_ms) {
+    ALLOC_SCOPE(TIMER);
     MutexGuard guard(state_mutex_, "state_mutex", 50);
     if (!guard.isLocked()) {
         Serial.println("[TimerStateMachine] ERROR: Failed to acquire mutex in update");
@@ -159,6 +170,8 @@ void TimerStateMachine::update(uint32_t delta_ms) {
     // Check for 30-second warning (only once per session)
     if (!warning_played && remaining_ms <= 30000 && remaining_ms > 29000) {
         if (audio_callback) {
+            // Checked once per update: late by up to one update interval
+            AUDIO_TRIGGER("warning", 30000 - remaining_ms);
             audio_callback("warning");
         }
         warning_played = true;
@@ -323,12 +336,17 @@ void TimerStateMachine::enterState(State new_state) {
             // Trigger audio based on session type
             if (audio_callback) {
                 auto session_type = sequence.getCurrentSession().type;
+                const char* sound = nullptr;
                 if (session_type == PomodoroSequence::SessionType::WORK) {
-                    audio_callback("work_start");
+                    sound = "work_start";
                 } else if (session_type == PomodoroSequence::SessionType::SHORT_BREAK) {
-                    audio_callback("rest_start");
+                    sound = "rest_start";
                 } else if (session_type == PomodoroSequence::SessionType::LONG_BREAK) {
-                    audio_callback("long_rest_start");
+                    sound = "long_rest_start";
+                }
+                if (sound) {
+                    AUDIO_TRIGGER(sound, 0);
+                    audio_callback(sound);
                 }
             }
             break;
@@ -54,6 +54,7 @@ public:
     using StateCallback = std::function<void(State old_state, State new_state)>;
     using TimeoutCallback = std::function<void()>;
     using AudioCallback = std::function<void(const char* sound_name)>;
+    using SessionCallback = std::function<void(const PomodoroSequence::Session& session, uint32_t elapsed_ms)>;
 
     TimerStateMachine(PomodoroSequence& sequence);
     ~TimerStateMachine();
@@ -77,6 +78,7 @@ public:
     void onStateChange(StateCallback callback) { state_callback = callback; }
     void onTimeout(TimeoutCallback callback) { timeout_callback = callback; }
     void onAudioEvent(AudioCallback callback) { audio_callback = callback; }
+    void onSessionComplete(SessionCallback callback) { session_callback = callback; }  // Timed out (not skipped/stopped)
 
     // LED controller (MP-23)
     void setLEDController(ILEDController* controller) { led_controller = controller; }
@@ -98,6 +100,7 @@ private:
     StateCallback state_callback = nullptr;
     TimeoutCallback timeout_callback = nullptr;
     AudioCallback audio_callback = nullptr;
+    SessionCallback session_callback = nullptr;
     ILEDController* led_controller = nullptr;  // MP-23: LED control
     IHapticController* haptic_controller = nullptr;  // MP-27: Haptic feedback
 
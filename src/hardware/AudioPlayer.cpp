@@ -1,72 +1,79 @@
 #include "AudioPlayer.h"
+#include "../utils/AudioLatency.h"
+#include "../utils/EnergyProfiler.h"
 #include <Arduino.h>
 
 // Include embedded audio data
 #include "audio_data.cpp"
 
-AudioPlayer::AudioPlayer()
-    : current_volume(70),
+// Theme manifest names of the embedded sounds, in Sound enum order
+static const char* const SOUND_CLIP_NAMES[] = {
+    "work_start",
+    "rest_start",
+    "long_rest_start",
+    "warning",
+};
+
+AudioPlayer::AudioPlayer(ISpeakerSink& speaker)
+    : speaker(speaker),
+      current_volume(70),
       muted(false),
       playing(false),
       sd_manager(nullptr),
+      sound_library(nullptr),
       current_source(AudioSource::FLASH),
       sd_audio_loaded(false),
-      sd_wav_work_start(nullptr),
-      sd_wav_work_start_len(0),
-      sd_wav_rest_start(nullptr),
-      sd_wav_rest_start_len(0),
-      sd_wav_long_rest_start(nullptr),
-      sd_wav_long_rest_start_len(0),
-      sd_wav_warning(nullptr),
-      sd_wav_warning_len(0) {
+      active_clip(nullptr),
+      sequence(nullptr),
+      prefetched_interval(0) {
 }
 
-// Destructor - free SD buffers
+// Destructor - unpin the clip being played (the cache owns the buffers)
 AudioPlayer::~AudioPlayer() {
-    freeSDBuffers();
+    releaseClip();
 }
 
 bool AudioPlayer::begin() {
     // Backward compatibility - use FLASH only
-    return begin(nullptr, AudioSource::FLASH);
+    return begin(nullptr, nullptr, AudioSource::FLASH);
 }
 
-bool AudioPlayer::begin(SDManager* sd_manager, AudioSource source) {
-    // M5Unified already initialized M5.Speaker
-    if (!M5.Speaker.isEnabled()) {
+bool AudioPlayer::begin(SDManager* sd_manager, SoundLibrary* library, AudioSource source) {
+    // M5Unified already initialized the speaker behind the sink
+    if (!speaker.isEnabled()) {
         Serial.println("[AudioPlayer] WARNING: Speaker not available");
         return false;
     }
 
-    // Store SD manager reference
+    // Store SD manager and theme cache references
     this->sd_manager = sd_manager;
+    this->sound_library = library;
 
-    // Set initial volume (M5.Speaker expects 0-255)
+    // Set initial volume (sink expects 0-255)
     setVolumeInternal(map(current_volume, 0, 100, 0, 255));
 
     Serial.println("[AudioPlayer] Initialized");
-    Serial.printf("[AudioPlayer] Speaker enabled: %s\n", M5.Speaker.isEnabled() ? "yes" : "no");
+    Serial.printf("[AudioPlayer] Speaker enabled: %s\n", speaker.isEnabled() ? "yes" : "no");
 
-    // Try to load audio from SD card if requested
+    // SD audio comes from the sound theme cache if requested
     if (source == AudioSource::SD_CARD || source == AudioSource::AUTO) {
-        if (sd_manager && sd_manager->isMounted()) {
-            Serial.println("[AudioPlayer] Attempting to load audio from SD card...");
-            if (loadAudioFromSD()) {
-                current_source = AudioSource::SD_CARD;
-                sd_audio_loaded = true;
-                Serial.println("[AudioPlayer] SD card audio loaded successfully");
-            } else {
-                Serial.println("[AudioPlayer] SD audio load failed");
-                if (source == AudioSource::SD_CARD) {
-                    // User explicitly requested SD only - fail
-                    Serial.println("[AudioPlayer] ERROR: SD_CARD mode but audio not available");
-                    return false;
-                } else {
-                    // AUTO mode - fallback to FLASH
-                    Serial.println("[AudioPlayer] Falling back to FLASH audio");
-                    current_source = AudioSource::FLASH;
+        if (sd_manager && sd_manager->isMounted() && sound_library) {
+            // Clips load on demand and ahead of the schedule (update());
+            // a clip not cached yet plays from FLASH
+            current_source = AudioSource::SD_CARD;
+            sd_audio_loaded = true;
+            if (source == AudioSource::SD_CARD) {
+                // Explicit SD mode: have the built-in sounds ready before the first play
+                for (const char* name : SOUND_CLIP_NAMES) {
+                    sound_library->prefetch(name);
                 }
             }
+            Serial.printf("[AudioPlayer] SD sound theme '%s', FLASH until clips are cached\n",
+                          sound_library->getTheme());
+        } else if (source == AudioSource::SD_CARD) {
+            // User explicitly requested SD only - fail
+            Serial.println("[AudioPlayer] ERROR: SD_CARD mode but audio not available");
+            return false;
         } else {
             Serial.println("[AudioPlayer] SD card not mounted, using FLASH audio");
             current_source = AudioSource::FLASH;
@@ -84,8 +91,11 @@ bool AudioPlayer::begin(SDManager* sd_manager, AudioSource source) {
 }
 
 void AudioPlayer::play(Sound sound) {
+    AUDIO_DISPATCH(soundName(sound) ? soundName(sound) : "beep");
+
     if (muted) {
         Serial.println("[AudioPlayer] Muted, skipping playback");
+        AUDIO_CANCEL();
         return;
     }
 
@@ -105,28 +115,11 @@ void AudioPlayer::play(Sound sound) {
     const uint8_t* wav_data = nullptr;
     size_t wav_len = 0;
 
-    // Try SD card first if available
-    if (sd_audio_loaded) {
-        switch (sound) {
-            case Sound::WORK_START:
-                wav_data = sd_wav_work_start;
-                wav_len = sd_wav_work_start_len;
-                break;
-            case Sound::REST_START:
-                wav_data = sd_wav_rest_start;
-                wav_len = sd_wav_rest_start_len;
-                break;
-            case Sound::LONG_REST_START:
-                wav_data = sd_wav_long_rest_start;
-                wav_len = sd_wav_long_rest_start_len;
-                break;
-            case Sound::WARNING:
-                wav_data = sd_wav_warning;
-                wav_len = sd_wav_warning_len;
-                break;
-            default:
-                break;
-        }
+    // Theme clip from the PSRAM cache (a miss queues its load)
+    const char* name = soundName(sound);
+    if (sd_audio_loaded && sound_library && name &&
+        sound_library->acquire(name, &wav_data, &wav_len)) {
+        active_clip = wav_data;
     }
 
     // Fallback to PROGMEM if SD not available or failed
@@ -155,25 +148,27 @@ void AudioPlayer::play(Sound sound) {
         }
     }
 
-    // Try to play WAV from PROGMEM
+    // Try to play WAV (SD cache or PROGMEM)
     if (!playWavFile(wav_data, wav_len)) {
         // Fallback to beep if playback fails
         Serial.println("[AudioPlayer] WAV playback failed, using beep");
+        releaseClip();
         playBeep();
     }
 }
 
 void AudioPlayer::stop() {
     if (playing) {
-        M5.Speaker.stop();
+        speaker.stop();
         playing = false;
+        ENERGY_ACTIVITY(SPEAKER, 0.0f);
         Serial.println("[AudioPlayer] Stopped playback");
     }
+    releaseClip();
 }
 
 bool AudioPlayer::isPlaying() const {
-    // M5.Speaker provides isPlaying() method
-    return M5.Speaker.isPlaying();
+    return speaker.isPlaying();
 }
 
 void AudioPlayer::setVolume(uint8_t percent) {
@@ -199,13 +194,24 @@ void AudioPlayer::unmute() {
 }
 
 void AudioPlayer::playTone(uint16_t frequency_hz, uint16_t duration_ms) {
-    if (muted) return;
+    AUDIO_DISPATCH("tone");
+
+    if (muted) {
+        AUDIO_CANCEL();
+        return;
+    }
 
     Serial.printf("[AudioPlayer] Playing tone: %u Hz, %u ms\n", frequency_hz, duration_ms);
 
-    // M5.Speaker.tone() plays a generated tone
-    M5.Speaker.tone(frequency_hz, duration_ms);
+    // Generated tone, no buffer to keep alive
+    if (!speaker.tone(frequency_hz, duration_ms)) {
+        Serial.println("[AudioPlayer] Tone playback failed");
+        AUDIO_CANCEL();
+        return;
+    }
+    AUDIO_SUBMIT();
     playing = true;
+    ENERGY_ACTIVITY(SPEAKER, current_volume / 100.0f);
 }
 
 void AudioPlayer::playBeep() {
@@ -219,8 +225,41 @@ void AudioPlayer::playWarning() {
 }
 
 void AudioPlayer::update() {
+    // Output-side timing (first sample, underruns)
+    speaker.poll();
+
     // Update playing state
+    bool was_playing = playing;
     playing = isPlaying();
+    if (was_playing && !playing) {
+        ENERGY_ACTIVITY(SPEAKER, 0.0f);
+        releaseClip();
+    }
+
+    // Next sounds of the schedule into the cache, once per interval
+    if (sd_audio_loaded && sound_library && sequence) {
+        uint8_t interval = sequence->getCurrentSessionNumber();
+        if (interval != prefetched_interval) {
+            prefetched_interval = interval;
+            sound_library->prefetchNext(*sequence);
+        }
+    }
+}
+
+bool AudioPlayer::setTheme(const char* theme) {
+    if (!sound_library) {
+        return false;
+    }
+    prefetched_interval = 0;   // Prefetch again from the new theme
+    return sound_library->setTheme(theme);
+}
+
+const char* AudioPlayer::soundName(Sound sound) {
+    size_t index = static_cast<size_t>(sound);
+    if (index < sizeof(SOUND_CLIP_NAMES) / sizeof(SOUND_CLIP_NAMES[0])) {
+        return SOUND_CLIP_NAMES[index];
+    }
+    return nullptr;   // Generated tones
 }
 
 // Private methods
@@ -231,150 +270,29 @@ bool AudioPlayer::playWavFile(const uint8_t* wav_data, size_t len) {
         return false;
     }
 
-    // Play WAV from PROGMEM using M5Unified Speaker API
-    // M5.Speaker.playWav() accepts const uint8_t* and works with PROGMEM
-    // Auto-assign to any available channel (-1), no repeat (1), no loop (false)
-    if (M5.Speaker.playWav(wav_data, len, 1, -1, false)) {
-        Serial.printf("[AudioPlayer] Playing WAV from PROGMEM (%d bytes)\n", len);
+    // Sink reads the buffer while playing (PROGMEM, or the pinned SD clip)
+    if (speaker.playWav(wav_data, len)) {
+        AUDIO_SUBMIT();
+        Serial.printf("[AudioPlayer] Playing WAV from %s (%d bytes)\n",
+                      active_clip ? "SD cache" : "PROGMEM", (int)len);
         playing = true;
+        ENERGY_ACTIVITY(SPEAKER, current_volume / 100.0f);
         return true;
     }
 
     // WAV playback failed
-    Serial.println("[AudioPlayer] M5.Speaker.playWav() failed");
+    Serial.println("[AudioPlayer] Speaker playWav() failed");
     return false;
 }
 
 void AudioPlayer::setVolumeInternal(uint8_t volume_255) {
-    // M5.Speaker.setVolume() expects 0-255
-    M5.Speaker.setVolume(volume_255);
+    speaker.setVolume(volume_255);
 }
 
-// SD card audio loading (MP-71)
-
-bool AudioPlayer::loadAudioFromSD() {
-    if (!sd_manager || !sd_manager->isMounted()) {
-        return false;
-    }
-
-    // Free any existing buffers
-    freeSDBuffers();
-
-    // Load all 4 WAV files (partial loading supported)
-    // If a file is missing, we'll use FLASH fallback for that sound
-    int loaded_count = 0;
-    size_t total_bytes = 0;
-
-    if (loadWavFromSD("/audio/work_start.wav", &sd_wav_work_start, &sd_wav_work_start_len)) {
-        loaded_count++;
-        total_bytes += sd_wav_work_start_len;
-        Serial.printf("[AudioPlayer] Loaded work_start.wav (%d bytes)\n", sd_wav_work_start_len);
-    } else {
-        Serial.println("[AudioPlayer] work_start.wav not found - using FLASH fallback");
-    }
-
-    if (loadWavFromSD("/audio/rest_start.wav", &sd_wav_rest_start, &sd_wav_rest_start_len)) {
-        loaded_count++;
-        total_bytes += sd_wav_rest_start_len;
-        Serial.printf("[AudioPlayer] Loaded rest_start.wav (%d bytes)\n", sd_wav_rest_start_len);
-    } else {
-        Serial.println("[AudioPlayer] rest_start.wav not found - using FLASH fallback");
+void AudioPlayer::releaseClip() {
+    // The speaker reads the buffer while playing: unpinned only after that
+    if (active_clip && sound_library) {
+        sound_library->release(active_clip);
     }
-
-    if (loadWavFromSD("/audio/long_rest_start.wav", &sd_wav_long_rest_start, &sd_wav_long_rest_start_len)) {
-        loaded_count++;
-        total_bytes += sd_wav_long_rest_start_len;
-        Serial.printf("[AudioPlayer] Loaded long_rest_start.wav (%d bytes)\n", sd_wav_long_rest_start_len);
-    } else {
-        Serial.println("[AudioPlayer] long_rest_start.wav not found - using FLASH fallback");
-    }
-
-    if (loadWavFromSD("/audio/warning.wav", &sd_wav_warning, &sd_wav_warning_len)) {
-        loaded_count++;
-        total_bytes += sd_wav_warning_len;
-        Serial.printf("[AudioPlayer] Loaded warning.wav (%d bytes)\n", sd_wav_warning_len);
-    } else {
-        Serial.println("[AudioPlayer] warning.wav not found - using FLASH fallback");
-    }
-
-    if (loaded_count == 0) {
-        // No files loaded - complete fallback to FLASH
-        Serial.println("[AudioPlayer] No audio files loaded from SD");
-        return false;
-    }
-
-    // Partial or complete success
-    Serial.printf("[AudioPlayer] Loaded %d of 4 audio files from SD (total: %d bytes)\n",
-                  loaded_count, total_bytes);
-    Serial.printf("[AudioPlayer] Using hybrid: SD (%d files) + FLASH (%d files)\n",
-                  loaded_count, 4 - loaded_count);
-
-    return true;
-}
-
-bool AudioPlayer::loadWavFromSD(const char* path, uint8_t** buffer, size_t* len) {
-    if (!sd_manager || !buffer || !len) {
-        return false;
-    }
-
-    // Check if file exists
-    if (!sd_manager->exists(path)) {
-        Serial.printf("[AudioPlayer] Audio file not found: %s\n", path);
-        return false;
-    }
-
-    // Read file to get size first
-    String wavData = sd_manager->readFile(path);
-    if (wavData.isEmpty()) {
-        Serial.printf("[AudioPlayer] Failed to read audio file: %s\n", path);
-        return false;
-    }
-
-    size_t fileSize = wavData.length();
-
-    // Allocate buffer in PSRAM (M5Core2 has 8MB PSRAM)
-    uint8_t* psramBuffer = (uint8_t*)ps_malloc(fileSize);
-    if (!psramBuffer) {
-        Serial.printf("[AudioPlayer] Failed to allocate %d bytes in PSRAM for %s\n", fileSize, path);
-        return false;
-    }
-
-    // Copy WAV data to PSRAM buffer
-    memcpy(psramBuffer, wavData.c_str(), fileSize);
-
-    // Return buffer and size
-    *buffer = psramBuffer;
-    *len = fileSize;
-
-    Serial.printf("[AudioPlayer] Loaded %s (%d bytes) to PSRAM\n", path, fileSize);
-    return true;
-}
-
-void AudioPlayer::freeSDBuffers() {
-    if (sd_wav_work_start) {
-        free(sd_wav_work_start);
-        sd_wav_work_start = nullptr;
-        sd_wav_work_start_len = 0;
-    }
-
-    if (sd_wav_rest_start) {
-        free(sd_wav_rest_start);
-        sd_wav_rest_start = nullptr;
-        sd_wav_rest_start_len = 0;
-    }
-
-    if (sd_wav_long_rest_start) {
-        free(sd_wav_long_rest_start);
-        sd_wav_long_rest_start = nullptr;
-        sd_wav_long_rest_start_len = 0;
-    }
-
-    if (sd_wav_warning) {
-        free(sd_wav_warning);
-        sd_wav_warning = nullptr;
-        sd_wav_warning_len = 0;
-    }
-
-    sd_audio_loaded = false;
-    Serial.println("[AudioPlayer] Freed SD audio buffers");
+    active_clip = nullptr;
 }
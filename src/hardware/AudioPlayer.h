@@ -2,8 +2,11 @@
 #define AUDIO_PLAYER_H
 
 #include "IAudioPlayer.h"
+#include "ISpeakerSink.h"
 #include "SDManager.h"
-#include <M5Unified.h>
+#include "SoundLibrary.h"
+#include "../core/PomodoroSequence.h"
+#include <Arduino.h>
 #include <cstdint>
 
 // Forward declarations for embedded audio data (from audio_data.cpp)
@@ -26,6 +29,8 @@ extern const uint32_t wav_warning_len;
  * - Volume control (0-100%)
  * - Sound effects (beep tones)
  * - Non-blocking playback
+ * - Output through an ISpeakerSink (M5SpeakerSink on the device, a fake
+ *   DMA queue in host tests)
  *
  * M5Stack Core2 Audio Hardware:
  * - Speaker: NS4168 I2S amplifier
@@ -34,8 +39,12 @@ extern const uint32_t wav_warning_len;
  * - Power: AXP192 controlled (GPIO enable)
  *
  * Audio Sources (MP-71):
- * - PRIMARY: SD card /audio/*.wav files (loaded to PSRAM)
- * - FALLBACK: PROGMEM embedded WAV data (always available)
+ * - PRIMARY: SD card sound theme (SoundLibrary passed to begin():
+ *   /audio/themes/<theme>/ manifest, or legacy flat /audio WAVs), decoded to
+ *   16 kHz mono by WavDecoder and cached in PSRAM; clips for the next
+ *   intervals are prefetched
+ * - FALLBACK: PROGMEM embedded WAV data (always available, and used for
+ *   a clip that is not cached yet)
  *
  * Sounds:
  * - WORK_START - Work session beginning (ascending tones)
@@ -51,12 +60,13 @@ public:
         AUTO        // Try SD first, fallback to FLASH
     };
 
-    AudioPlayer();
+    explicit AudioPlayer(ISpeakerSink& speaker);
     ~AudioPlayer();
 
     // Initialization
     bool begin() override;  // Uses AUTO mode (SD fallback to PROGMEM)
-    bool begin(SDManager* sd_manager, AudioSource source = AudioSource::AUTO);
+    bool begin(SDManager* sd_manager, SoundLibrary* library,
+               AudioSource source = AudioSource::AUTO);
 
     // Playback control
     void play(Sound sound) override;
@@ -86,30 +96,43 @@ public:
     AudioSource getAudioSource() const { return current_source; }
     bool isSDCardAudioAvailable() const { return sd_audio_loaded; }
 
+    /**
+     * Switch the SD sound theme (manifest read queued, clips load on demand)
+     */
+    bool setTheme(const char* theme);
+
+    /**
+     * Schedule used to prefetch the next sounds (once per interval, in update())
+     */
+    void setSequence(const PomodoroSequence* sequence) { this->sequence = sequence; }
+
+    /**
+     * Clip name of a sound in theme manifests ("work_start", ...), nullptr for tones
+     */
+    static const char* soundName(Sound sound);
+
 private:
+    ISpeakerSink& speaker;
+
     uint8_t current_volume = 70;  // 0-100%
     bool muted = false;
     bool playing = false;
 
     // SD card support (MP-71)
     SDManager* sd_manager = nullptr;
+    SoundLibrary* sound_library = nullptr;   // Not owned, nullptr if no card
     AudioSource current_source = AudioSource::FLASH;
     bool sd_audio_loaded = false;
 
-    // SD audio buffers (allocated in PSRAM)
-    uint8_t* sd_wav_work_start = nullptr;
-    size_t sd_wav_work_start_len = 0;
-    uint8_t* sd_wav_rest_start = nullptr;
-    size_t sd_wav_rest_start_len = 0;
-    uint8_t* sd_wav_long_rest_start = nullptr;
-    size_t sd_wav_long_rest_start_len = 0;
-    uint8_t* sd_wav_warning = nullptr;
-    size_t sd_wav_warning_len = 0;
+    // SD clip being played: pinned in the SoundLibrary cache until playback ends
+    const uint8_t* active_clip = nullptr;
+
+    // Prefetch of the next sounds (interval number last prefetched for)
+    const PomodoroSequence* sequence = nullptr;
+    uint8_t prefetched_interval = 0;
 
     // Internal methods
-    bool loadAudioFromSD();
-    bool loadWavFromSD(const char* path, uint8_t** buffer, size_t* len);
-    void freeSDBuffers();
+    void releaseClip();
     bool playWavFile(const uint8_t* wav_data, size_t len);
     void setVolumeInternal(uint8_t volume_255);
 };
@@ -1,5 +1,21 @@
 #include "GyroController.h"
 #include <Arduino.h>
+#include "../utils/InputTrace.h"
+
+// MPU6886 registers (wake-on-motion)
+static constexpr uint8_t MPU6886_ADDR = 0x68;
+static constexpr uint32_t MPU6886_I2C_FREQ = 400000;
+static constexpr uint8_t REG_SMPLRT_DIV = 0x19;
+static constexpr uint8_t REG_ACCEL_CONFIG2 = 0x1D;
+static constexpr uint8_t REG_ACCEL_WOM_X_THR = 0x20;      // X/Y/Z thresholds at 0x20-0x22, 4 mg/LSB
+static constexpr uint8_t REG_INT_PIN_CFG = 0x37;
+static constexpr uint8_t REG_INT_ENABLE = 0x38;
+static constexpr uint8_t REG_INT_STATUS = 0x3A;
+static constexpr uint8_t REG_ACCEL_INTEL_CTRL = 0x69;
+static constexpr uint8_t REG_PWR_MGMT_1 = 0x6B;
+static constexpr uint8_t REG_PWR_MGMT_2 = 0x6C;
+static constexpr uint8_t WOM_INT_BITS = 0xE0;              // WOM X/Y/Z (INT_ENABLE, INT_STATUS)
+static constexpr uint8_t WOM_SMPLRT_DIV = 99;              // Low-power ODR: 1 kHz / (1 + 99) = 10 Hz
 
 GyroController::GyroController()
     : current_orientation(Orientation::UNKNOWN),
@@ -56,6 +72,7 @@ void GyroController::update() {
     Gesture gesture = detectGesture(accel, gyro);
     if (gesture != Gesture::NONE) {
         last_gesture = gesture;
+        INPUT_TRACE_RECORD(IMU_GESTURE, static_cast<uint8_t>(gesture), 0, 0);
 
         switch (gesture) {
             case Gesture::FLIP:
@@ -94,6 +111,45 @@ bool GyroController::wasRotatedCCW() {
     return result;
 }
 
+bool GyroController::enableWakeOnMotion(uint16_t threshold_mg) {
+    // MPU6886 datasheet wake-on-motion sequence
+    uint8_t threshold = constrain(threshold_mg / 4, 1, 255);
+    const uint8_t sequence[][2] = {
+        {REG_PWR_MGMT_1, 0x00},                 // Awake, not cycling
+        {REG_PWR_MGMT_2, 0x07},                 // Accel on, gyro standby
+        {REG_ACCEL_CONFIG2, 0x01},              // Accel DLPF 218 Hz
+        {REG_INT_PIN_CFG, 0x20},                // Latch until INT_STATUS is read
+        {REG_INT_ENABLE, WOM_INT_BITS},
+        {REG_ACCEL_WOM_X_THR, threshold},
+        {REG_ACCEL_WOM_X_THR + 1, threshold},
+        {REG_ACCEL_WOM_X_THR + 2, threshold},
+        {REG_ACCEL_INTEL_CTRL, 0xC0},           // Enable, compare with previous sample, OR of axes
+        {REG_SMPLRT_DIV, WOM_SMPLRT_DIV},
+        {REG_PWR_MGMT_1, 0x20},                 // CYCLE: low-power accel sampling
+    };
+
+    for (const auto& write : sequence) {
+        if (!M5.In_I2C.writeRegister8(MPU6886_ADDR, write[0], write[1], MPU6886_I2C_FREQ)) {
+            Serial.printf("[GyroController] ERROR: Wake-on-motion setup failed at reg 0x%02X\n", write[0]);
+            return false;
+        }
+    }
+
+    readMotionLatch();   // Discard anything latched during setup
+    Serial.printf("[GyroController] Wake-on-motion armed (%u mg)\n", threshold * 4);
+    return true;
+}
+
+bool GyroController::wasMotionDetected() {
+    return readMotionLatch();
+}
+
+bool GyroController::readMotionLatch() {
+    // INT_STATUS clears on read
+    uint8_t status = M5.In_I2C.readRegister8(MPU6886_ADDR, REG_INT_STATUS, MPU6886_I2C_FREQ);
+    return (status & WOM_INT_BITS) != 0;
+}
+
 void GyroController::calibrate() {
     Serial.println("[GyroController] Calibrating... Keep device still");
 
@@ -15,6 +15,9 @@
  * - Gesture detection (flip, rotate 90°)
  * - Accelerometer data smoothing
  * - Polling-based (MPU6886 INT not wired to GPIO on Core2)
+ * - Low-power wake-on-motion for deep sleep: the MPU6886 runs accel-only
+ *   in cycle mode and latches motion in INT_STATUS; without an INT line
+ *   the latch is read on short timer wakes (see PowerManager)
  *
  * Coordinate system (device flat, screen up):
  * - X: Left (-) to Right (+)
@@ -59,6 +62,16 @@ public:
     void setFlipThreshold(float threshold) override { flip_threshold = threshold; }
     void setRotateThreshold(float threshold) override { rotate_threshold = threshold; }
 
+    // Wake-on-motion (deep sleep)
+    bool enableWakeOnMotion(uint16_t threshold_mg) override;
+    bool wasMotionDetected() override;
+
+    /**
+     * Read and clear the latched motion status over I2C only
+     * Usable at early boot, before M5.begin() (bus must be started).
+     */
+    static bool readMotionLatch();
+
     // Diagnostics
     void printStatus() const;
 
@@ -1,4 +1,5 @@
 #include "HapticController.h"
+#include "../utils/EnergyProfiler.h"
 #include <M5Unified.h>
 #include <Arduino.h>
 
@@ -151,12 +152,14 @@ void HapticController::startMotor() {
     // Turn ON vibration motor via AXP192 LDO3
     // Core2 vibration motor requires 3.3V on LDO3
     M5.Power.Axp192.setLDO3(3300);  // 3300mV = 3.3V
+    ENERGY_ACTIVITY(HAPTIC, 1.0f);
     Serial.println("[HapticController] Motor ON");
 }
 
 void HapticController::stopMotor() {
     // Turn OFF vibration motor
     M5.Power.Axp192.setLDO3(0);  // 0V = OFF
+    ENERGY_ACTIVITY(HAPTIC, 0.0f);
     // Note: No serial print here to avoid spam in update() loop
 }
 
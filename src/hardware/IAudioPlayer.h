@@ -13,7 +13,7 @@
  *
  * Usage:
  *   // Production code uses concrete AudioPlayer
- *   IAudioPlayer* audio = new AudioPlayer();
+ *   IAudioPlayer* audio = new AudioPlayer(*new M5SpeakerSink());
  *   audio->play(IAudioPlayer::Sound::WORK_START);
  *
  *   // Test code uses MockAudioPlayer
@@ -190,6 +190,25 @@ public:
      * @param threshold Angular velocity threshold in deg/s (default: 100.0)
      */
     virtual void setRotateThreshold(float threshold) = 0;
+
+    // ====================
+    // Wake-on-Motion (Deep Sleep)
+    // ====================
+
+    /**
+     * Put the IMU into low-power wake-on-motion mode (accel only, gyro off)
+     * Motion above the threshold latches a status flag that survives ESP32 deep sleep.
+     * The IMU stays in this mode until begin()/M5.begin() re-initializes it.
+     * @param threshold_mg Acceleration change that counts as motion (4-1020 mg)
+     * @return true if configured, false on bus error
+     */
+    virtual bool enableWakeOnMotion(uint16_t threshold_mg) = 0;
+
+    /**
+     * Check if motion was latched since the last call (clears the flag)
+     * @return true if moved, false otherwise
+     */
+    virtual bool wasMotionDetected() = 0;
 };
 
 #endif // I_GYRO_CONTROLLER_H
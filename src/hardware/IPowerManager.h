@@ -119,6 +119,15 @@ public:
      */
     virtual void wakeup() = 0;
 
+    /**
+     * Poll the IMU motion latch from the next indefinite deep sleep
+     * (Config::PowerSettings::wake_on_rotation / motion_poll_interval_s).
+     * Timer wakes, not an interrupt: costs boot current every interval.
+     * @param enabled true to wake up when a poll finds the device moved
+     * @param interval_s seconds between polls (worst-case wake latency)
+     */
+    virtual void setMotionPolling(bool enabled, uint8_t interval_s) = 0;
+
     // ====================
     // Power Consumption
     // ====================
@@ -0,0 +1,44 @@
+#ifndef I_SPEAKER_SINK_H
+#define I_SPEAKER_SINK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Speaker Sink Interface - output end of AudioPlayer
+ *
+ * AudioPlayer decides what to play; the sink owns the output path (I2S
+ * amplifier on the device) and reports output-side timing (first sample,
+ * underruns) through its SpeakerMonitor.
+ *
+ * Implementations:
+ * - M5SpeakerSink: M5.Speaker (NS4168 over I2S DMA)
+ * - FakeSpeakerSink (test/mocks): simulated DMA queue on the virtual clock
+ *
+ * Usage:
+ *   AudioPlayer* audio = new AudioPlayer(*new M5SpeakerSink());
+ */
+class ISpeakerSink {
+public:
+    virtual ~ISpeakerSink() = default;
+
+    virtual bool isEnabled() const = 0;
+
+    /**
+     * Queue a WAV clip (replaces the current sound), never waits for output
+     * The buffer must stay valid until isPlaying() turns false.
+     */
+    virtual bool playWav(const uint8_t* wav, size_t len) = 0;
+
+    virtual bool tone(uint16_t frequency_hz, uint32_t duration_ms) = 0;
+    virtual void stop() = 0;
+    virtual bool isPlaying() const = 0;
+    virtual void setVolume(uint8_t volume_255) = 0;
+
+    /**
+     * Output-side bookkeeping (first sample, underruns); every UI loop
+     */
+    virtual void poll() {}
+};
+
+#endif // I_SPEAKER_SINK_H
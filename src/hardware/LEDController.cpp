@@ -1,12 +1,17 @@
 #include "LEDController.h"
+#include "../utils/Placement.h"
+#include "../utils/EnergyProfiler.h"
 #include <Arduino.h>
 
 // FastLED hardware array (GPIO 25, SK6812, GRB order)
 #define LED_DATA_PIN 25
 CRGB LEDController::fastled_array[LEDController::LED_COUNT];
 
+static_assert(sizeof(CRGB) == 3, "fastled_array is sent as packed RGB triplets");
+
 LEDController::LEDController()
-    : current_pattern(Pattern::OFF),
+    : strip(LED_DATA_PIN, LED_COUNT),
+      current_pattern(Pattern::OFF),
       pattern_color(Color::White()),
       brightness(50) {
     // Initialize LED array to off
@@ -26,13 +31,16 @@ bool LEDController::begin() {
     bool power_status = M5.Power.getExtOutput();
     Serial.printf("[LEDController] 5V output verified: %s\n", power_status ? "ENABLED" : "DISABLED");
 
-    // MP-23: Initialize FastLED for SK6812 LEDs on GPIO 25
-    // Use WS2812B timing (compatible) but force RGB-only mode (ignore W channel)
-    // SK6812 chipset assumes RGBW but we only control RGB channels
-    FastLED.addLeds<SK6812, LED_DATA_PIN, GRB>(fastled_array, LED_COUNT);
+    // MP-23: SK6812 LEDs on GPIO 25, RGB-only (W channel ignored)
+    // Driven by the RMT peripheral directly: FastLED.show() blocks the UI
+    // task for the whole frame, LEDStripRMT returns after encoding
+    if (!strip.begin()) {
+        Serial.println("[LEDController] ERROR: RMT LED output init failed");
+        return false;
+    }
 
-    // Set normal brightness
-    FastLED.setBrightness(map(brightness, 0, 100, 0, 255));
+    // Global output scale, as FastLED.setBrightness() applied it at show()
+    strip.setScale(map(brightness, 0, 100, 0, 255));
 
     Serial.println("[LEDController] Hardware initialized (SK6812 LED bar)");
     Serial.printf("[LEDController] GPIO %d, %d LEDs, SK6812/GRB, Brightness %d%%\n",
@@ -68,7 +76,23 @@ void LEDController::show() {
         fastled_array[i] = CRGB(adjusted.r, adjusted.g, adjusted.b);
     }
 
-    FastLED.show();
+    pushFrame();
+}
+
+void LEDController::pushFrame() {
+    strip.show(reinterpret_cast<const uint8_t*>(fastled_array), LED_COUNT);
+    reportEnergy();
+}
+
+void LEDController::reportEnergy() const {
+#if ENERGY_PROFILING
+    // WS2812 current scales with the sum of channel duty cycles
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < LED_COUNT; i++) {
+        sum += fastled_array[i].r + fastled_array[i].g + fastled_array[i].b;
+    }
+    ENERGY_ACTIVITY(LEDS, sum / (LED_COUNT * 765.0f));
+#endif
 }
 
 void LEDController::powerDown() {
@@ -81,8 +105,10 @@ void LEDController::powerDown() {
     clear();
     show();
 
-    // Wait for LEDs to physically turn off
-    delay(10);
+    // Wait for the frame to latch before cutting power
+    if (!strip.waitDone(10)) {
+        Serial.println("[LEDController] WARNING: LED frame still on the wire");
+    }
 
     // Disable 5V boost (AXP192 EXTEN register)
     // This cuts power to the LED strip completely
@@ -202,7 +228,8 @@ void LEDController::triggerMilestone(uint32_t duration_ms) {
 
         // Now activate milestone protection
         milestone_active = true;
-        milestone_end_ms = millis() + duration_ms;
+        milestone_start_ms = millis();
+        milestone_duration_ms = duration_ms;
 
         Serial.printf("[LEDController] Milestone triggered! %s for %lu ms\n",
                      patternName(Pattern::CONFETTI), duration_ms);
@@ -210,8 +237,11 @@ void LEDController::triggerMilestone(uint32_t duration_ms) {
 }
 
 void LEDController::update() {
+    // Send a frame that arrived while the previous one was on the wire
+    strip.service();
+
     // MP-23: Check milestone expiration first
-    if (milestone_active && millis() >= milestone_end_ms) {
+    if (milestone_active && millis() - milestone_start_ms >= milestone_duration_ms) {
         // Milestone ended - turn off LEDs and release lock
         // State machine will set correct pattern on next update
         milestone_active = false;
@@ -224,7 +254,7 @@ void LEDController::update() {
 
 // Private methods
 
-void LEDController::updatePattern() {
+void HOT_IRAM LEDController::updatePattern() {
     uint32_t now = millis();
     uint32_t delta = now - last_update_ms;
 
@@ -280,7 +310,7 @@ void LEDController::updatePattern() {
     }
 }
 
-void LEDController::updatePulse() {
+void HOT_IRAM LEDController::updatePulse() {
     // Breathing effect: fade in/out
     const uint8_t steps = 50;
     animation_step = (animation_step + 1) % (steps * 2);
@@ -320,7 +350,7 @@ void LEDController::updateRainbow() {
         fastled_array[i].nscale8(brightness_scale);
     }
 
-    FastLED.show();
+    pushFrame();
 
     // Debug logging (every 10 frames)
     static uint8_t frame_count = 0;
@@ -357,7 +387,7 @@ void LEDController::updateConfetti() {
         fastled_array[i].nscale8(brightness_scale);
     }
 
-    FastLED.show();
+    pushFrame();
 
     // Debug logging (every 20 frames)
     static uint8_t confetti_frame_count = 0;
@@ -368,7 +398,7 @@ void LEDController::updateConfetti() {
     }
 }
 
-void LEDController::updateBlink() {
+void HOT_IRAM LEDController::updateBlink() {
     animation_step = (animation_step + 1) % 2;
 
     if (animation_step == 0) {
@@ -380,7 +410,7 @@ void LEDController::updateBlink() {
     show();
 }
 
-void LEDController::updateFlash() {
+void HOT_IRAM LEDController::updateFlash() {
     // MP-23: Flash pattern - 3× burst @ 200ms, then 1 sec pause
     // Total cycle: 6 steps (bursts) + 5 steps (pause) = 11 steps @ 200ms each
     animation_step = (animation_step + 1) % 11;
@@ -400,7 +430,7 @@ void LEDController::updateFlash() {
     show();
 }
 
-LEDController::Color LEDController::applyBrightness(Color color) const {
+LEDController::Color HOT_IRAM LEDController::applyBrightness(Color color) const {
     // MP-23: Dual brightness system - user setting × power mode multiplier
     // Example: 80% user × 60% balanced = 48% final brightness
     uint16_t effective_brightness = (brightness * power_mode_multiplier) / 100;
@@ -412,7 +442,7 @@ LEDController::Color LEDController::applyBrightness(Color color) const {
     };
 }
 
-LEDController::Color LEDController::wheelColor(uint8_t pos) const {
+LEDController::Color HOT_IRAM LEDController::wheelColor(uint8_t pos) const {
     // Rainbow color wheel (0-255 maps to full spectrum)
     pos = 255 - pos;
 
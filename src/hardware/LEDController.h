@@ -2,6 +2,7 @@
 #define LED_CONTROLLER_H
 
 #include "ILEDController.h"
+#include "LEDStripRMT.h"
 #include <M5Unified.h>
 // enable RGBW support
 #define FASTLED_EXPERIMENTAL_ESP32_RGBW_ENABLED 1
@@ -24,6 +25,9 @@
  * - GPIO 25 (data pin)
  * - 5V power
  *
+ * Output: FastLED is used for color math only; frames go out through
+ * LEDStripRMT (RMT peripheral, non-blocking) instead of FastLED.show().
+ *
  * Use cases:
  * - Timer progress indicator (fill LEDs as timer counts down)
  * - Status indication (work=red, break=green, paused=yellow)
@@ -72,6 +76,7 @@ public:
 private:
     Color leds[LED_COUNT];              // Software LED buffer
     static CRGB fastled_array[LED_COUNT];  // FastLED hardware array (MP-23)
+    LEDStripRMT strip;                  // Non-blocking RMT output for fastled_array
     Pattern current_pattern = Pattern::OFF;
     Color pattern_color = Color::White();
     uint8_t brightness = 50;  // 0-100% (user setting)
@@ -87,7 +92,8 @@ private:
 
     // Milestone celebration state (MP-23)
     bool milestone_active = false;         // Is milestone rainbow active?
-    uint32_t milestone_end_ms = 0;         // When milestone ends
+    uint32_t milestone_start_ms = 0;       // millis() when the milestone started
+    uint32_t milestone_duration_ms = 0;    // Elapsed-time check survives millis() wraparound
     Pattern saved_pattern = Pattern::OFF;  // Pattern to restore after milestone
     Color saved_color = Color::White();    // Color to restore after milestone
 
@@ -99,6 +105,8 @@ private:
     void updateBlink();
     void updateFlash();           // MP-23: 3× burst @ 200ms
     Color applyBrightness(Color color) const;
+    void pushFrame();             // fastled_array → RMT (returns immediately)
+    void reportEnergy() const;    // Pushed output to EnergyProfiler (ENERGY_PROFILING)
     Color wheelColor(uint8_t pos) const;  // Rainbow wheel helper
     const char* patternName(Pattern pattern) const;  // Pattern enum to string
 };
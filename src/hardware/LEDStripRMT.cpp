@@ -0,0 +1,221 @@
+#include "LEDStripRMT.h"
+#include <Arduino.h>
+#include <string.h>
+
+#ifndef NATIVE_BUILD
+#include <driver/rmt.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+
+static_assert(sizeof(LEDStripRMT::Item) == sizeof(rmt_item32_t), "Item must match rmt_item32_t");
+#endif
+
+static_assert(LEDStripRMT::MAX_ITEMS < LEDStripRMT::MEM_BLOCKS * 64,
+              "Frame + end marker must fit in RMT RAM (no refill ISR)");
+
+LEDStripRMT* LEDStripRMT::s_channels_[8] = {};
+
+#ifndef NATIVE_BUILD
+#define STRIP_ISR IRAM_ATTR
+
+// One TX-end callback for the whole RMT driver: dispatch by channel
+static void STRIP_ISR rmtTxEnd(rmt_channel_t channel, void* arg) {
+    (void)arg;
+    LEDStripRMT::onTxEnd(static_cast<uint8_t>(channel));
+}
+
+static inline uint32_t nowMicros() {
+    return static_cast<uint32_t>(esp_timer_get_time());
+}
+#else
+#define STRIP_ISR
+
+static inline uint32_t nowMicros() {
+    return 0;   // No µs clock in the host shim
+}
+#endif
+
+LEDStripRMT::LEDStripRMT(uint8_t gpio, uint8_t pixels, uint8_t channel)
+    : gpio_(gpio),
+      pixels_(pixels > MAX_PIXELS ? MAX_PIXELS : pixels),
+      channel_(channel),
+      scale_(255),
+      started_(false),
+      item_count_(0),
+      busy_(false),
+      pending_(false),
+      done_callback_(nullptr),
+      done_arg_(nullptr),
+      stats_{} {
+}
+
+LEDStripRMT::~LEDStripRMT() {
+    if (!started_) return;
+    waitDone(10);
+#ifndef NATIVE_BUILD
+    rmt_driver_uninstall(static_cast<rmt_channel_t>(channel_));
+#endif
+    s_channels_[channel_] = nullptr;
+}
+
+bool LEDStripRMT::begin() {
+    if (started_) return true;
+    if (channel_ + MEM_BLOCKS > 8) {
+        Serial.printf("[LEDStripRMT] ERROR: channel %u + %u blocks out of range\n",
+                      channel_, MEM_BLOCKS);
+        return false;
+    }
+
+#ifndef NATIVE_BUILD
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX(static_cast<gpio_num_t>(gpio_),
+                                                static_cast<rmt_channel_t>(channel_));
+    config.clk_div = CLK_DIV;
+    config.mem_block_num = MEM_BLOCKS;
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+
+    esp_err_t err = rmt_config(&config);
+    if (err == ESP_OK) {
+        err = rmt_driver_install(config.channel, 0, 0);
+    }
+    if (err != ESP_OK) {
+        Serial.printf("[LEDStripRMT] ERROR: RMT init failed (%s)\n", esp_err_to_name(err));
+        return false;
+    }
+    rmt_register_tx_end_callback(rmtTxEnd, nullptr);
+#endif
+
+    s_channels_[channel_] = this;
+    started_ = true;
+    Serial.printf("[LEDStripRMT] ✓ GPIO %u, %u pixels, RMT channel %u (%u blocks)\n",
+                  gpio_, pixels_, channel_, MEM_BLOCKS);
+    return true;
+}
+
+// ============================================================================
+// Frame Output
+// ============================================================================
+
+size_t LEDStripRMT::encode(const uint8_t* rgb, size_t pixels, uint8_t scale, Item* out) {
+    if (pixels > MAX_PIXELS) pixels = MAX_PIXELS;
+
+    Item zero;
+    zero.level0 = 1;
+    zero.duration0 = T0H_TICKS;
+    zero.level1 = 0;
+    zero.duration1 = T0L_TICKS;
+    Item one;
+    one.level0 = 1;
+    one.duration0 = T1H_TICKS;
+    one.level1 = 0;
+    one.duration1 = T1L_TICKS;
+
+    Item* item = out;
+    for (size_t p = 0; p < pixels; p++) {
+        const uint8_t* px = rgb + p * 3;
+        const uint8_t grb[3] = {px[1], px[0], px[2]};
+        for (uint8_t c = 0; c < 3; c++) {
+            // FastLED scale8: (x × (1 + scale)) >> 8, 255 = unchanged
+            uint8_t value = static_cast<uint8_t>((grb[c] * (1 + scale)) >> 8);
+            for (uint8_t bit = 0x80; bit; bit >>= 1) {
+                *item++ = (value & bit) ? one : zero;
+            }
+        }
+    }
+
+    size_t count = item - out;
+    if (count > 0) {
+        out[count - 1].duration1 = out[count - 1].duration1 + RESET_TICKS;   // Latch
+    }
+    return count;
+}
+
+bool LEDStripRMT::show(const uint8_t* rgb, size_t pixels) {
+    if (!started_) return false;
+
+    uint32_t t0 = nowMicros();
+    if (pending_) {
+        stats_.coalesced++;   // Previous frame never made it to the wire
+    }
+    item_count_ = encode(rgb, pixels < pixels_ ? pixels : pixels_, scale_, items_);
+    pending_ = true;
+
+    bool ok = busy_ ? true : transmit();
+
+    uint32_t elapsed = nowMicros() - t0;
+    stats_.last_show_us = elapsed;
+    if (elapsed > stats_.max_show_us) stats_.max_show_us = elapsed;
+    return ok;
+}
+
+bool LEDStripRMT::service() {
+    if (!started_ || !pending_ || busy_) return false;
+    return transmit();
+}
+
+bool LEDStripRMT::transmit() {
+    pending_ = false;
+    if (item_count_ == 0) return true;
+
+    busy_ = true;
+    stats_.frames++;
+#ifndef NATIVE_BUILD
+    // Fits in RMT RAM: the driver copies the items and starts, no waiting
+    esp_err_t err = rmt_write_items(static_cast<rmt_channel_t>(channel_),
+                                    reinterpret_cast<const rmt_item32_t*>(items_),
+                                    item_count_, false);
+    if (err != ESP_OK) {
+        busy_ = false;
+        stats_.errors++;
+        return false;
+    }
+#endif
+    // Host: stays busy until the test calls onTxEnd()
+    return true;
+}
+
+void STRIP_ISR LEDStripRMT::onTxEnd(uint8_t channel) {
+    LEDStripRMT* strip = (channel < 8) ? s_channels_[channel] : nullptr;
+    if (strip) {
+        strip->txDone();
+    }
+}
+
+void STRIP_ISR LEDStripRMT::txDone() {
+    busy_ = false;
+    stats_.completed++;
+    if (done_callback_) {
+        done_callback_(done_arg_);
+    }
+}
+
+bool LEDStripRMT::waitDone(uint32_t timeout_ms) {
+    if (!started_) return true;
+#ifndef NATIVE_BUILD
+    // Current frame, then the pending one (a frame shown just before sleep)
+    for (int pass = 0; pass < 2; pass++) {
+        if (busy_ && rmt_wait_tx_done(static_cast<rmt_channel_t>(channel_),
+                                      pdMS_TO_TICKS(timeout_ms)) != ESP_OK) {
+            return false;
+        }
+        busy_ = false;   // Driver confirmed; the ISR may still be on its way out
+        if (!pending_) break;
+        transmit();
+    }
+#else
+    (void)timeout_ms;
+#endif
+    return !busy_ && !pending_;
+}
+
+void LEDStripRMT::setDoneCallback(DoneCallback callback, void* arg) {
+    done_arg_ = arg;
+    done_callback_ = callback;
+}
+
+void LEDStripRMT::printStats() const {
+    Serial.printf("[LEDStripRMT] frames=%lu completed=%lu coalesced=%lu errors=%lu show=%lu us (max %lu)\n",
+                  (unsigned long)stats_.frames, (unsigned long)stats_.completed,
+                  (unsigned long)stats_.coalesced, (unsigned long)stats_.errors,
+                  (unsigned long)stats_.last_show_us, (unsigned long)stats_.max_show_us);
+}
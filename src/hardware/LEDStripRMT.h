@@ -0,0 +1,146 @@
+#ifndef LED_STRIP_RMT_H
+#define LED_STRIP_RMT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Non-blocking SK6812 output through the ESP32 RMT peripheral
+ *
+ * FastLED.show() runs its own RMT refill ISR and waits for the frame to
+ * finish on the calling task. LEDStripRMT encodes the frame into RMT
+ * items on the caller (10 pixels = 240 items, a few µs), copies them into
+ * RMT RAM in one go and returns; the peripheral clocks the bits out
+ * with no CPU involvement and raises one TX-end interrupt.
+ * - The whole frame fits in RMT RAM (4 memory blocks = 256 items), so
+ *   there is no refill ISR and the item buffer is free right after show()
+ * - The latch (reset) time is appended to the last bit, so TX end means
+ *   the frame is on the LEDs
+ * - show() while a frame is still on the wire never waits: the newest
+ *   frame is kept pending and sent by service() once the wire is free
+ *   (intermediate frames are dropped and counted)
+ * - Optional completion callback from the TX-end ISR (must be IRAM-safe)
+ *
+ * Color order is GRB; pixels are passed as RGB triplets. A global 0-255
+ * scale is applied while encoding (same as FastLED.setBrightness()).
+ * show()/service() must be called from one task (the UI task); the ISR
+ * only clears the busy flag.
+ *
+ * Usage:
+ *   LEDStripRMT strip(25, 10);
+ *   strip.begin();
+ *   strip.show(rgb, 10);     // Returns in µs, never blocks
+ *   strip.service();         // Every loop: sends a frame left pending
+ *
+ * Host builds (env:native): encode() is testable, no transmission.
+ */
+class LEDStripRMT {
+public:
+    static constexpr size_t MAX_PIXELS = 10;
+    static constexpr size_t BITS_PER_PIXEL = 24;
+    static constexpr size_t MAX_ITEMS = MAX_PIXELS * BITS_PER_PIXEL;
+    static constexpr uint8_t MEM_BLOCKS = 4;           // 4 × 64 items, frame + end marker
+    static constexpr uint8_t CLK_DIV = 2;              // 80 MHz / 2 = 25 ns per tick
+
+    // SK6812 timing in 25 ns ticks (datasheet ±150 ns)
+    static constexpr uint16_t T0H_TICKS = 12;          // 0.3 µs
+    static constexpr uint16_t T0L_TICKS = 36;          // 0.9 µs
+    static constexpr uint16_t T1H_TICKS = 24;          // 0.6 µs
+    static constexpr uint16_t T1L_TICKS = 24;          // 0.6 µs
+    static constexpr uint16_t RESET_TICKS = 3200;      // 80 µs latch
+
+    // Same bit layout as rmt_item32_t
+    union Item {
+        struct {
+            uint32_t duration0 : 15;
+            uint32_t level0 : 1;
+            uint32_t duration1 : 15;
+            uint32_t level1 : 1;
+        };
+        uint32_t val;
+    };
+
+    struct Stats {
+        uint32_t frames;           // Frames handed to the peripheral
+        uint32_t completed;        // TX-end interrupts
+        uint32_t coalesced;        // Pending frames replaced by a newer one
+        uint32_t errors;           // RMT driver errors
+        uint32_t last_show_us;     // CPU time of the last show() (encode + copy)
+        uint32_t max_show_us;
+    };
+
+    using DoneCallback = void (*)(void* arg);
+
+    /**
+     * @param gpio Data pin (Core2 LED bar: 25)
+     * @param pixels Number of pixels (≤ MAX_PIXELS)
+     * @param channel RMT channel; MEM_BLOCKS channels from here are used
+     */
+    LEDStripRMT(uint8_t gpio, uint8_t pixels, uint8_t channel = 0);
+    ~LEDStripRMT();
+
+    bool begin();
+
+    /**
+     * Encode and start a frame, or keep it pending while one is on the wire
+     * @param rgb Pixel data, 3 bytes per pixel (R, G, B)
+     * @return false if not started or the driver rejected the frame
+     */
+    bool show(const uint8_t* rgb, size_t pixels);
+
+    /**
+     * Send the pending frame once the previous one has completed
+     * @return true if a frame was started
+     */
+    bool service();
+
+    bool isBusy() const { return busy_; }
+    bool hasPending() const { return pending_; }
+
+    /**
+     * Wait until the newest frame is latched, sending a pending one
+     * (deep sleep: before cutting 5 V)
+     */
+    bool waitDone(uint32_t timeout_ms);
+
+    void setScale(uint8_t scale) { scale_ = scale; }
+    void setDoneCallback(DoneCallback callback, void* arg);
+
+    Stats getStats() const { return stats_; }
+    void printStats() const;
+
+    /**
+     * TX-end interrupt for a channel (RMT driver ISR; host tests call it
+     * to complete the simulated transmission)
+     */
+    static void onTxEnd(uint8_t channel);
+
+    /**
+     * Encode RGB pixels into RMT items (GRB order, MSB first, scaled)
+     * @return Number of items written (pixels × 24)
+     */
+    static size_t encode(const uint8_t* rgb, size_t pixels, uint8_t scale, Item* out);
+
+private:
+    bool transmit();
+    void txDone();
+
+    uint8_t gpio_;
+    uint8_t pixels_;
+    uint8_t channel_;
+    uint8_t scale_;
+    bool started_;
+
+    Item items_[MAX_ITEMS];
+    size_t item_count_;
+    volatile bool busy_;
+    volatile bool pending_;
+
+    DoneCallback done_callback_;
+    void* done_arg_;
+    Stats stats_;
+
+    static LEDStripRMT* s_channels_[8];   // TX-end ISR dispatch
+};
+
+#endif // LED_STRIP_RMT_H
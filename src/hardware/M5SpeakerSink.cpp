@@ -0,0 +1,51 @@
+#include "M5SpeakerSink.h"
+#include <M5Unified.h>
+
+M5SpeakerSink::M5SpeakerSink() {
+}
+
+bool M5SpeakerSink::isEnabled() const {
+    return M5.Speaker.isEnabled();
+}
+
+bool M5SpeakerSink::playWav(const uint8_t* wav, size_t len) {
+    // No repeat (1), fixed channel, stop the current sound (true)
+    if (!M5.Speaker.playWav(wav, len, 1, CHANNEL, true)) {
+        return false;
+    }
+    monitor_.start(micros(), pipelineUs(), SpeakerMonitor::wavDurationUs(wav, len));
+    return true;
+}
+
+bool M5SpeakerSink::tone(uint16_t frequency_hz, uint32_t duration_ms) {
+    if (!M5.Speaker.tone(frequency_hz, duration_ms, CHANNEL)) {
+        return false;
+    }
+    monitor_.start(micros(), pipelineUs(), duration_ms * 1000);
+    return true;
+}
+
+void M5SpeakerSink::stop() {
+    M5.Speaker.stop(CHANNEL);
+    monitor_.stop();
+}
+
+bool M5SpeakerSink::isPlaying() const {
+    return M5.Speaker.isPlaying(CHANNEL);
+}
+
+void M5SpeakerSink::setVolume(uint8_t volume_255) {
+    M5.Speaker.setVolume(volume_255);
+}
+
+void M5SpeakerSink::poll() {
+    monitor_.poll(micros(), isPlaying());
+}
+
+uint32_t M5SpeakerSink::pipelineUs() const {
+    // Audio queued ahead of a new clip: the whole DMA ring
+    auto cfg = M5.Speaker.config();
+    if (cfg.sample_rate == 0) return 0;
+    uint64_t samples = static_cast<uint64_t>(cfg.dma_buf_len) * cfg.dma_buf_count;
+    return static_cast<uint32_t>(samples * 1000000ULL / cfg.sample_rate);
+}
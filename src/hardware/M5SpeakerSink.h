@@ -0,0 +1,37 @@
+#ifndef M5_SPEAKER_SINK_H
+#define M5_SPEAKER_SINK_H
+
+#include "ISpeakerSink.h"
+#include "SpeakerMonitor.h"
+
+/**
+ * Speaker sink on M5.Speaker (NS4168 I2S amplifier, M5Stack Core2)
+ *
+ * All sounds go to mixer channel 0 (a new sound replaces the current one),
+ * so "playing" is a single channel's state. M5Unified already initialized
+ * the speaker; the sink only reads its DMA configuration for the
+ * SpeakerMonitor pipeline depth.
+ */
+class M5SpeakerSink : public ISpeakerSink {
+public:
+    M5SpeakerSink();
+
+    bool isEnabled() const override;
+    bool playWav(const uint8_t* wav, size_t len) override;
+    bool tone(uint16_t frequency_hz, uint32_t duration_ms) override;
+    void stop() override;
+    bool isPlaying() const override;
+    void setVolume(uint8_t volume_255) override;
+    void poll() override;
+
+    const SpeakerMonitor& getMonitor() const { return monitor_; }
+
+private:
+    static constexpr uint8_t CHANNEL = 0;
+
+    SpeakerMonitor monitor_;
+
+    uint32_t pipelineUs() const;
+};
+
+#endif // M5_SPEAKER_SINK_H
@@ -1,9 +1,23 @@
 #include "PowerManager.h"
+#include "GyroController.h"
 #include <Arduino.h>
+#include <esp_sleep.h>
+
+// Survive deep sleep: motion-polled sleep in progress, its period, polls without motion
+RTC_DATA_ATTR static bool s_motion_sleep = false;
+RTC_DATA_ATTR static uint8_t s_motion_interval_s = PowerManager::MOTION_CHECK_INTERVAL_S;
+RTC_DATA_ATTR static uint32_t s_motion_checks = 0;
+static bool s_woke_by_motion = false;
+
+static constexpr gpio_num_t TOUCH_INT_PIN = GPIO_NUM_39;   // FT6336U INT (Core2), ext0 wake
 
 PowerManager::PowerManager()
     : current_brightness(80),
-      current_sleep_mode(SleepMode::NONE) {
+      current_sleep_mode(SleepMode::NONE),
+      telemetry_(nullptr),
+      gyro_(nullptr),
+      wake_on_motion_(false),
+      motion_interval_s_(MOTION_CHECK_INTERVAL_S) {
 }
 
 bool PowerManager::begin() {
@@ -18,16 +32,25 @@ bool PowerManager::begin() {
 }
 
 uint8_t PowerManager::getBatteryLevel() const {
+    if (telemetry_) {
+        return telemetry_->getBatteryLevel();
+    }
     // M5.Power.getBatteryLevel() returns 0-100
     return M5.Power.getBatteryLevel();
 }
 
 float PowerManager::getBatteryVoltage() const {
+    if (telemetry_) {
+        return telemetry_->getSnapshot().battery_mv / 1000.0f;
+    }
     // Get battery voltage in millivolts, convert to volts
     return M5.Power.getBatteryVoltage() / 1000.0f;
 }
 
 bool PowerManager::isCharging() const {
+    if (telemetry_) {
+        return telemetry_->isCharging();
+    }
     return M5.Power.isCharging();
 }
 
@@ -37,6 +60,9 @@ bool PowerManager::isChargeFull() const {
 }
 
 int16_t PowerManager::getBatteryCurrent() const {
+    if (telemetry_) {
+        return telemetry_->getSnapshot().current_ma;
+    }
     // M5Unified provides getBatteryCurrent() in mA
     // Negative = discharging, Positive = charging
     return M5.Power.getBatteryCurrent();
@@ -76,15 +102,67 @@ void PowerManager::enterDeepSleep(uint32_t duration_sec) {
 
     current_sleep_mode = SleepMode::DEEP;
 
+    // Indefinite sleep with motion polling (opt-in): IMU latch + periodic timer wakes
+    if (duration_sec == 0 && wake_on_motion_ && gyro_ &&
+        gyro_->enableWakeOnMotion(MOTION_THRESHOLD_MG)) {
+        s_motion_sleep = true;
+        s_motion_interval_s = motion_interval_s_;
+        s_motion_checks = 0;
+        Serial.printf("[PowerManager] Wake on touch, motion polled every %u s\n",
+                      (unsigned)s_motion_interval_s);
+        Serial.flush();
+        M5.Power.deepSleep(s_motion_interval_s * 1000000ULL, true);
+    }
+    s_motion_sleep = false;
+
     // Configure timer wakeup (deep sleep uses seconds)
     esp_sleep_enable_timer_wakeup(duration_sec * 1000000ULL);  // microseconds
 
-    // Deep sleep (only RTC active, reset on wake)
-    M5.Power.deepSleep(duration_sec);
+    // Deep sleep (only RTC active, reset on wake; M5Unified takes microseconds, 0 = no timer)
+    M5.Power.deepSleep(duration_sec * 1000000ULL);
 
     // This code never executes (ESP32 resets after deep sleep wake)
 }
 
+void PowerManager::resumeSleepIfStill() {
+    if (!s_motion_sleep) {
+        return;
+    }
+
+    // Touch (ext0) or reset ends the motion-armed sleep
+    if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER) {
+        s_motion_sleep = false;
+        return;
+    }
+
+    // Internal bus only (M5.begin() re-initializes it for the real boot)
+    M5.In_I2C.begin(I2C_NUM_1, GPIO_NUM_21, GPIO_NUM_22);
+    if (GyroController::readMotionLatch()) {
+        s_motion_sleep = false;
+        s_woke_by_motion = true;
+        return;
+    }
+
+    // Still: back to sleep with the same wake sources
+    s_motion_checks++;
+    esp_sleep_enable_timer_wakeup(s_motion_interval_s * 1000000ULL);
+    esp_sleep_enable_ext0_wakeup(TOUCH_INT_PIN, 0);
+    esp_deep_sleep_start();
+}
+
+void PowerManager::setMotionPolling(bool enabled, uint8_t interval_s) {
+    wake_on_motion_ = enabled;
+    motion_interval_s_ = constrain(interval_s, 1, MOTION_CHECK_INTERVAL_MAX_S);
+}
+
+bool PowerManager::wokeByMotion() {
+    return s_woke_by_motion;
+}
+
+uint32_t PowerManager::getMotionChecks() {
+    return s_motion_checks;
+}
+
 void PowerManager::wakeup() {
     // Called after wake from sleep
     Serial.println("[PowerManager] Processing wakeup");
@@ -96,7 +174,12 @@ void PowerManager::wakeup() {
     esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
     switch (wakeup_reason) {
         case ESP_SLEEP_WAKEUP_TIMER:
-            Serial.println("[PowerManager] Woke by timer");
+            if (s_woke_by_motion) {
+                Serial.printf("[PowerManager] Woke by motion poll (after %lu still polls)\n",
+                              (unsigned long)s_motion_checks);
+            } else {
+                Serial.println("[PowerManager] Woke by timer");
+            }
             break;
         case ESP_SLEEP_WAKEUP_EXT0:
             Serial.println("[PowerManager] Woke by GPIO");
@@ -120,6 +203,11 @@ float PowerManager::getPowerConsumption() const {
 }
 
 uint32_t PowerManager::getEstimatedRuntime() const {
+    if (telemetry_) {
+        // Coulomb-counted charge over averaged discharge current
+        return telemetry_->getSnapshot().runtime_min;
+    }
+
     if (isCharging()) {
         return 0;  // Unlimited when charging
     }
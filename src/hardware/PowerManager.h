@@ -2,6 +2,8 @@
 #define POWER_MANAGER_H
 
 #include "IPowerManager.h"
+#include "PowerTelemetry.h"
+#include "IGyroController.h"
 #include <M5Unified.h>
 #include <cstdint>
 
@@ -21,13 +23,40 @@
  * - LiPo battery management (3.7V, 390mAh)
  * - USB-C charging (5V input)
  * - Power rail control (3.3V, 5V, display backlight)
+ *
+ * With a PowerTelemetry attached, battery readings come from its cached,
+ * filtered samples (coulomb-counted level and runtime) instead of
+ * separate I2C reads per call.
+ *
+ * Motion polling (opt-in, off by default): the MPU6886 INT line is not
+ * wired to the ESP32 on Core2, so motion cannot wake the chip - this is not
+ * wake-on-motion. With polling enabled, indefinite deep sleep arms the
+ * IMU's low-power motion latch plus a timer wake every interval;
+ * resumeSleepIfStill() (first thing in setup()) reads the latch and goes
+ * straight back to sleep if nothing moved, before the display, PSRAM
+ * users or WiFi are touched. Every poll is a full ROM boot, so it trades
+ * sleep current for up to one interval of latency. Touch still wakes
+ * immediately (ext0).
  */
 class PowerManager : public IPowerManager {
 public:
+    static constexpr uint16_t MOTION_THRESHOLD_MG = 80;     // Picked up / rotated, not table knocks
+
+    // Default poll period (= worst-case wake latency), 1..MAX accepted.
+    // Sleep current added by polling - estimated, not yet measured on a
+    // Core2: each poll is ROM boot + bootloader + one I2C read, ~250 ms at
+    // ~45 mA, i.e. ~5.6 mA average at 2 s, ~1.1 mA at 10 s, ~0.2 mA at 60 s,
+    // on top of touch-only deep sleep (tens of µA for the ESP32 itself).
+    // Measure on battery (AXP192 coulomb counter over a night) before
+    // enabling it by default.
+    static constexpr uint8_t MOTION_CHECK_INTERVAL_S = 2;
+    static constexpr uint8_t MOTION_CHECK_INTERVAL_MAX_S = 60;
+
     PowerManager();
 
     // Initialization
     bool begin() override;
+    void setTelemetry(PowerTelemetry* telemetry) { telemetry_ = telemetry; }
 
     // Battery status
     uint8_t getBatteryLevel() const override;           // 0-100%
@@ -45,6 +74,18 @@ public:
     void enterDeepSleep(uint32_t duration_sec) override;
     void wakeup() override;                              // Called after sleep wake
 
+    // Wake sources
+    void setGyroController(IGyroController* gyro) { gyro_ = gyro; }
+    void setMotionPolling(bool enabled, uint8_t interval_s) override;
+
+    /**
+     * Early boot: if this is a motion poll wake and the IMU latched no
+     * motion, re-enter deep sleep (does not return). Call before M5.begin().
+     */
+    static void resumeSleepIfStill();
+    static bool wokeByMotion();                          // A poll found motion and ended the sleep
+    static uint32_t getMotionChecks();                   // Still polls during the last sleep
+
     // Power consumption
     float getPowerConsumption() const override;          // Watts (estimated)
     uint32_t getEstimatedRuntime() const override;       // Minutes remaining (if discharging)
@@ -59,6 +100,10 @@ public:
 private:
     uint8_t current_brightness = 80;
     SleepMode current_sleep_mode = SleepMode::NONE;
+    PowerTelemetry* telemetry_ = nullptr;   // Cached readings (optional)
+    IGyroController* gyro_ = nullptr;       // Motion polling (optional)
+    bool wake_on_motion_ = false;
+    uint8_t motion_interval_s_ = MOTION_CHECK_INTERVAL_S;
 
     // Battery voltage to percentage conversion (LiPo curve)
     uint8_t voltageToPercent(float voltage) const;
@@ -0,0 +1,307 @@
+#include "PowerTelemetry.h"
+#include "../utils/EnergyProfiler.h"
+#include <Arduino.h>
+#include <string.h>
+
+#ifndef NATIVE_BUILD
+#include <M5Unified.h>
+#endif
+
+// AXP192 registers (burst layout)
+static constexpr uint8_t AXP_REG_POWER_STATUS = 0x00;   // 0x00 input status, 0x01 charge status
+static constexpr uint8_t AXP_REG_ADC_FIRST = 0x5E;      // Die temperature
+static constexpr uint8_t AXP_REG_BAT_VOLTAGE = 0x78;
+static constexpr uint8_t AXP_REG_CHARGE_CURRENT = 0x7A;
+static constexpr uint8_t AXP_REG_DISCHARGE_CURRENT = 0x7C;
+static constexpr size_t AXP_ADC_BURST = 0x7D - AXP_REG_ADC_FIRST + 1;
+
+PowerTelemetry::PowerTelemetry()
+    : head_(0),
+      count_(0),
+      outlier_run_(0),
+      state_{},
+      current_ema_(0.0f),
+      discharge_ema_(0.0f),
+      next_sample_ms_(0),
+      sample_requested_(true) {
+    memset(history_, 0, sizeof(history_));
+    state_.level = 100;          // Until the first sample (avoids a 0% flash)
+    state_.interval_ms = FAST_INTERVAL_MS;
+}
+
+// ============================================================================
+// Sampling (UI task)
+// ============================================================================
+
+bool PowerTelemetry::poll(uint32_t now_ms) {
+    if (!sample_requested_ && (int32_t)(now_ms - next_sample_ms_) < 0) {
+        return false;
+    }
+    sample_requested_ = false;
+
+    Sample sample;
+    if (!readBurst(sample)) {
+        lock();
+        state_.read_errors++;
+        next_sample_ms_ = now_ms + state_.interval_ms;
+        unlock();
+        return false;
+    }
+    sample.t_ms = now_ms;
+    return addSample(sample);
+}
+
+void PowerTelemetry::requestSample() {
+    sample_requested_ = true;
+}
+
+bool PowerTelemetry::readBurst(Sample& out) {
+#ifdef NATIVE_BUILD
+    (void)out;
+    return false;   // No PMIC on the host: tests use addSample()
+#else
+    memset(&out, 0, sizeof(out));
+
+    if (M5.Power.getType() != m5::Power_Class::pmic_t::pmic_axp192) {
+        // Other PMICs (AXP2101 on Core2 v1.1): per-value API
+        bool charging = M5.Power.isCharging() == m5::Power_Class::is_charging_t::is_charging;
+        out.battery_mv = M5.Power.getBatteryVoltage();
+        out.current_ma = M5.Power.getBatteryCurrent();
+        out.flags = FLAG_BATTERY | (charging ? FLAG_CHARGING | FLAG_EXTERNAL : 0);
+        return out.battery_mv > 0;
+    }
+
+    uint8_t status[2];
+    uint8_t adc[AXP_ADC_BURST];
+    if (!M5.Power.Axp192.readRegister(AXP_REG_POWER_STATUS, status, sizeof(status)) ||
+        !M5.Power.Axp192.readRegister(AXP_REG_ADC_FIRST, adc, sizeof(adc))) {
+        return false;
+    }
+
+    auto reg = [&adc](uint8_t r) { return adc[r - AXP_REG_ADC_FIRST]; };
+
+    // 12-bit: 1.1 mV/LSB; 13-bit currents: 0.5 mA/LSB; temperature: 0.1 °C/LSB from -144.7 °C
+    uint16_t voltage_raw = (reg(AXP_REG_BAT_VOLTAGE) << 4) | (reg(AXP_REG_BAT_VOLTAGE + 1) & 0x0F);
+    uint16_t charge_raw = (reg(AXP_REG_CHARGE_CURRENT) << 5) | (reg(AXP_REG_CHARGE_CURRENT + 1) & 0x1F);
+    uint16_t discharge_raw = (reg(AXP_REG_DISCHARGE_CURRENT) << 5) | (reg(AXP_REG_DISCHARGE_CURRENT + 1) & 0x1F);
+    uint16_t temp_raw = (reg(AXP_REG_ADC_FIRST) << 4) | (reg(AXP_REG_ADC_FIRST + 1) & 0x0F);
+
+    out.battery_mv = (voltage_raw * 11) / 10;
+    out.current_ma = ((int32_t)charge_raw - (int32_t)discharge_raw) / 2;
+    out.temp_dc = (int16_t)temp_raw - 1447;
+    out.flags = ((status[1] & 0x40) ? FLAG_CHARGING : 0) |     // Charge indication
+                ((status[0] & 0xA0) ? FLAG_EXTERNAL : 0) |     // ACIN or VBUS present
+                ((status[1] & 0x20) ? FLAG_BATTERY : 0);       // Battery connected
+    return true;
+#endif
+}
+
+// ============================================================================
+// Filtering and Integration
+// ============================================================================
+
+bool PowerTelemetry::addSample(const Sample& sample) {
+    lock();
+    if (isOutlier(sample)) {
+        state_.rejected++;
+        state_.interval_ms = FAST_INTERVAL_MS;   // Confirm soon
+        next_sample_ms_ = sample.t_ms + state_.interval_ms;
+        unlock();
+        return false;
+    }
+
+    integrate(sample);
+    updateInterval(sample);
+
+    history_[head_] = sample;
+    head_ = (head_ + 1) % HISTORY;
+    if (count_ < HISTORY) count_++;
+
+    state_.samples++;
+    state_.last_sample_ms = sample.t_ms;
+    next_sample_ms_ = sample.t_ms + state_.interval_ms;
+    unlock();
+
+#if ENERGY_PROFILING
+    // Raw reading, not the EMA: the profiler pairs it with activity in its window
+    EnergyProfiler::addSample(-sample.current_ma, sample.t_ms,
+                              !(sample.flags & FLAG_EXTERNAL));
+#endif
+    return true;
+}
+
+bool PowerTelemetry::isOutlier(const Sample& sample) {
+    // Out of range: I2C glitches read back 0 mV or saturated currents
+    if (sample.battery_mv < MIN_VALID_MV || sample.battery_mv > MAX_VALID_MV ||
+        sample.current_ma > MAX_VALID_MA || sample.current_ma < -MAX_VALID_MA) {
+        return true;
+    }
+
+    if (count_ < 3) {
+        return false;
+    }
+
+    // Median of the last three accepted voltages
+    uint16_t a = history_[(head_ + HISTORY - 1) % HISTORY].battery_mv;
+    uint16_t b = history_[(head_ + HISTORY - 2) % HISTORY].battery_mv;
+    uint16_t c = history_[(head_ + HISTORY - 3) % HISTORY].battery_mv;
+    uint16_t median = (a > b) ? ((b > c) ? b : (a > c ? c : a))
+                              : ((a > c) ? a : (b > c ? c : b));
+
+    uint16_t step = sample.battery_mv > median ? sample.battery_mv - median : median - sample.battery_mv;
+    if (step > MAX_STEP_MV && ++outlier_run_ < OUTLIER_CONFIRM) {
+        return true;
+    }
+    outlier_run_ = 0;   // Consistent, or a step that persisted (charger plugged in)
+    return false;
+}
+
+void PowerTelemetry::integrate(const Sample& sample) {
+    bool external = sample.flags & FLAG_EXTERNAL;
+    bool charging = sample.flags & FLAG_CHARGING;
+    float discharge = sample.current_ma < 0 ? -sample.current_ma : 0.0f;
+
+    if (!state_.valid) {
+        // Seed from the voltage curve
+        state_.charge_mah = CAPACITY_MAH * voltageToPercent(sample.battery_mv) / 100.0f;
+        current_ema_ = sample.current_ma;
+        discharge_ema_ = discharge;
+        state_.valid = true;
+    } else {
+        const Sample& prev = history_[(head_ + HISTORY - 1) % HISTORY];
+        uint32_t dt_ms = sample.t_ms - prev.t_ms;
+
+        if (dt_ms > SLOW_INTERVAL_MS * 6) {
+            // Gap in sampling (sleep, stalled task): re-seed rather than guess
+            state_.charge_mah = CAPACITY_MAH * voltageToPercent(sample.battery_mv) / 100.0f;
+        } else {
+            // Trapezoid: mA × ms → mAh
+            float avg_ma = (prev.current_ma + sample.current_ma) / 2.0f;
+            state_.charge_mah += avg_ma * dt_ms / 3600000.0f;
+        }
+
+        current_ema_ += (sample.current_ma - current_ema_) * 0.25f;
+        float alpha = (float)dt_ms / (DISCHARGE_AVG_MS + dt_ms);
+        discharge_ema_ += (discharge - discharge_ema_) * alpha;
+    }
+
+    // Charger terminated at full voltage: re-anchor (removes integration drift)
+    if (external && !charging && sample.battery_mv >= FULL_MV) {
+        state_.charge_mah = CAPACITY_MAH;
+    }
+    if (state_.charge_mah < 0.0f) state_.charge_mah = 0.0f;
+    if (state_.charge_mah > CAPACITY_MAH) state_.charge_mah = CAPACITY_MAH;
+
+    state_.battery_mv = sample.battery_mv;
+    state_.current_ma = (int16_t)current_ema_;
+    state_.discharge_ma = charging ? 0 : (int16_t)(discharge_ema_ + 0.5f);
+    state_.temp_c = sample.temp_dc / 10.0f;
+    state_.charging = charging;
+    state_.external_power = external;
+    state_.level = (uint8_t)(state_.charge_mah * 100.0f / CAPACITY_MAH + 0.5f);
+
+    if (charging || external || state_.discharge_ma <= 0) {
+        state_.runtime_min = 0;
+    } else {
+        state_.runtime_min = (uint32_t)(state_.charge_mah * 60.0f / state_.discharge_ma);
+    }
+}
+
+void PowerTelemetry::updateInterval(const Sample& sample) {
+    bool busy = count_ == 0 ||
+                ((history_[(head_ + HISTORY - 1) % HISTORY].flags ^ sample.flags) & FLAG_CHARGING) ||
+                (sample.current_ma - current_ema_ > STEADY_MA) ||
+                (current_ema_ - sample.current_ma > STEADY_MA) ||
+                state_.level <= 10;
+
+    if (busy) {
+        state_.interval_ms = FAST_INTERVAL_MS;
+    } else if (state_.interval_ms < SLOW_INTERVAL_MS) {
+        state_.interval_ms = state_.interval_ms * 2 < SLOW_INTERVAL_MS ? state_.interval_ms * 2 : SLOW_INTERVAL_MS;
+    }
+}
+
+uint8_t PowerTelemetry::voltageToPercent(uint16_t mv) {
+    // Open-circuit LiPo curve (mV at 0, 10, ... 100%)
+    static const uint16_t OCV_MV[11] = {3300, 3600, 3680, 3740, 3770, 3800, 3840, 3890, 3960, 4050, 4150};
+    if (mv <= OCV_MV[0]) return 0;
+    if (mv >= OCV_MV[10]) return 100;
+
+    for (uint8_t i = 1; i < 11; i++) {
+        if (mv < OCV_MV[i]) {
+            uint16_t lo = OCV_MV[i - 1];
+            return (i - 1) * 10 + (uint8_t)((mv - lo) * 10 / (OCV_MV[i] - lo));
+        }
+    }
+    return 100;
+}
+
+// ============================================================================
+// Cached Readings (any task, no I2C)
+// ============================================================================
+
+PowerTelemetry::Snapshot PowerTelemetry::getSnapshot() const {
+    lock();
+    Snapshot snapshot = state_;
+    unlock();
+    return snapshot;
+}
+
+uint8_t PowerTelemetry::getBatteryLevel() const {
+    lock();
+    uint8_t level = state_.level;
+    unlock();
+    return level;
+}
+
+bool PowerTelemetry::isCharging() const {
+    lock();
+    bool charging = state_.charging;
+    unlock();
+    return charging;
+}
+
+size_t PowerTelemetry::getHistory(Sample* out, size_t max) const {
+    lock();
+    size_t n = count_ < max ? count_ : max;
+    size_t start = (head_ + HISTORY - n) % HISTORY;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = history_[(start + i) % HISTORY];
+    }
+    unlock();
+    return n;
+}
+
+void PowerTelemetry::printStats() const {
+    Snapshot s = getSnapshot();
+    Serial.printf("[PowerTelemetry] %u%% (%.1f mAh), %u mV, %d mA (avg discharge %d mA), %.1f C, %s\n",
+                  s.level, s.charge_mah, s.battery_mv, s.current_ma, s.discharge_ma, s.temp_c,
+                  s.charging ? "charging" : (s.external_power ? "external" : "battery"));
+    Serial.printf("[PowerTelemetry] Runtime %lu min, %lu samples every %lu ms, %lu rejected, %lu read errors\n",
+                  (unsigned long)s.runtime_min, (unsigned long)s.samples, (unsigned long)s.interval_ms,
+                  (unsigned long)s.rejected, (unsigned long)s.read_errors);
+}
+
+// ============================================================================
+// Locking
+// ============================================================================
+
+#ifdef NATIVE_BUILD
+void PowerTelemetry::lock() const {
+    while (lock_.test_and_set(std::memory_order_acquire)) {
+        // spin
+    }
+}
+
+void PowerTelemetry::unlock() const {
+    lock_.clear(std::memory_order_release);
+}
+#else
+void PowerTelemetry::lock() const {
+    portENTER_CRITICAL(&lock_);
+}
+
+void PowerTelemetry::unlock() const {
+    portEXIT_CRITICAL(&lock_);
+}
+#endif
@@ -0,0 +1,151 @@
+#ifndef POWER_TELEMETRY_H
+#define POWER_TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+
+#ifdef NATIVE_BUILD
+#include <atomic>
+#endif
+
+/**
+ * Batched AXP192 power telemetry sampler
+ *
+ * M5.Power.getBatteryLevel(), isCharging() and getBatteryCurrent() are
+ * separate I2C transactions each, and a single instantaneous current
+ * reading makes a poor runtime estimate. PowerTelemetry samples the PMIC
+ * in one burst and publishes cached, filtered values:
+ * - One sample = power/charge status (0x00-0x01) + one ADC burst
+ *   (0x5E-0x7D: die temperature, battery voltage, charge and discharge
+ *   current) - two transactions instead of one per value
+ * - Adaptive rate: FAST_INTERVAL_MS while current or charge state change
+ *   (or battery low), backing off to SLOW_INTERVAL_MS when steady
+ * - Ring buffer of the last HISTORY accepted samples
+ * - Outlier filter: out-of-range readings (I2C glitches read 0 mV) and
+ *   voltage jumps against the recent median are rejected; a step that
+ *   persists for OUTLIER_CONFIRM samples is accepted as real (plug-in)
+ * - Coulomb counting: current integrated over time (trapezoid) into the
+ *   remaining charge, seeded from the open-circuit voltage curve and
+ *   re-anchored to full when charging terminates
+ * - Runtime from remaining charge / averaged discharge current (~1 min)
+ *
+ * Consumers (status bar, PowerManager, sleep logic) read getSnapshot()
+ * and never touch I2C. poll() runs on the UI task, which already owns the
+ * internal I2C bus (touch).
+ *
+ * Usage:
+ *   PowerTelemetry* power = new PowerTelemetry();
+ *   power->poll(millis());                  // Every UI loop, samples when due
+ *   uint8_t level = power->getSnapshot().level;
+ */
+class PowerTelemetry {
+public:
+    static constexpr size_t HISTORY = 32;
+    static constexpr uint16_t CAPACITY_MAH = 390;          // Core2 LiPo
+    static constexpr uint32_t FAST_INTERVAL_MS = 1000;
+    static constexpr uint32_t SLOW_INTERVAL_MS = 10000;
+    static constexpr uint16_t MIN_VALID_MV = 3000;
+    static constexpr uint16_t MAX_VALID_MV = 4500;
+    static constexpr int16_t MAX_VALID_MA = 1500;
+    static constexpr uint16_t MAX_STEP_MV = 250;           // vs median of recent samples
+    static constexpr uint8_t OUTLIER_CONFIRM = 3;
+    static constexpr int16_t STEADY_MA = 20;               // Current change that speeds sampling up
+    static constexpr uint16_t FULL_MV = 4100;              // Charge terminated above this = 100%
+    static constexpr uint32_t DISCHARGE_AVG_MS = 60000;    // Runtime averaging window
+
+    enum Flags : uint8_t {
+        FLAG_CHARGING = 0x01,    // Charger active
+        FLAG_EXTERNAL = 0x02,    // VBUS/ACIN present
+        FLAG_BATTERY = 0x04      // Battery connected
+    };
+
+    struct Sample {
+        uint32_t t_ms;
+        uint16_t battery_mv;
+        int16_t current_ma;      // + charging, - discharging
+        int16_t temp_dc;         // PMIC die temperature, 0.1 °C
+        uint8_t flags;           // Flags
+    };
+
+    struct Snapshot {
+        bool valid;              // At least one sample accepted
+        uint16_t battery_mv;
+        int16_t current_ma;      // Smoothed
+        int16_t discharge_ma;    // Averaged over DISCHARGE_AVG_MS (0 when charging)
+        float temp_c;
+        bool charging;
+        bool external_power;
+        uint8_t level;           // 0-100, coulomb counted
+        float charge_mah;
+        uint32_t runtime_min;    // 0 if charging or unknown
+        uint32_t last_sample_ms;
+        uint32_t interval_ms;    // Current sampling interval
+        uint32_t samples;
+        uint32_t rejected;
+        uint32_t read_errors;
+    };
+
+    PowerTelemetry();
+
+    /**
+     * Sample the PMIC if the adaptive interval has elapsed
+     * @return true if a sample was accepted
+     */
+    bool poll(uint32_t now_ms);
+
+    /**
+     * Filter and integrate one sample (called by poll(); tests inject directly)
+     * @return false if rejected as an outlier
+     */
+    bool addSample(const Sample& sample);
+
+    /**
+     * Sample on the next poll() (after wake, charger events)
+     */
+    void requestSample();
+
+    Snapshot getSnapshot() const;
+    uint8_t getBatteryLevel() const;
+    bool isCharging() const;
+
+    /**
+     * Copy accepted samples, oldest first
+     * @return Number copied
+     */
+    size_t getHistory(Sample* out, size_t max) const;
+
+    void printStats() const;
+
+    /**
+     * Open-circuit voltage to state of charge (LiPo curve, 0-100)
+     */
+    static uint8_t voltageToPercent(uint16_t mv);
+
+private:
+    bool readBurst(Sample& out);
+    bool isOutlier(const Sample& sample);
+    void integrate(const Sample& sample);
+    void updateInterval(const Sample& sample);
+    void lock() const;
+    void unlock() const;
+
+    Sample history_[HISTORY];
+    size_t head_;                // Next write position
+    size_t count_;
+    uint8_t outlier_run_;
+
+    Snapshot state_;
+    float current_ema_;
+    float discharge_ema_;
+    uint32_t next_sample_ms_;
+    bool sample_requested_;
+
+#ifdef NATIVE_BUILD
+    mutable std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+#else
+    mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+#endif
+};
+
+#endif // POWER_TELEMETRY_H
@@ -0,0 +1,347 @@
+#include "SDLogWriter.h"
+#include "SDManager.h"
+#include "SDWorker.h"
+#include "../utils/AllocTracker.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+SDLogWriter::SDLogWriter(SDManager& sd, const char* path)
+    : SDLogWriter(sd, path, Options()) {
+}
+
+SDLogWriter::SDLogWriter(SDManager& sd, const char* path, const Options& options)
+    : sd_(sd),
+      options_(options),
+      buffer_(nullptr),
+      io_buffer_(nullptr),
+      buffered_(0),
+      oldest_ms_(0),
+      unsynced_(false),
+      flush_requested_(false),
+      preamble_len_(0),
+      file_size_(0),
+      file_dirty_(false),
+      io_mutex_(nullptr),
+      worker_(nullptr),
+      stats_{} {
+    strncpy(path_, path ? path : "", MAX_PATH - 1);
+    path_[MAX_PATH - 1] = '\0';
+
+    // Whole units only: a full buffer is always a sector-aligned write
+    if (options_.buffer_bytes < WRITE_UNIT) {
+        options_.buffer_bytes = WRITE_UNIT;
+    }
+    options_.buffer_bytes -= options_.buffer_bytes % WRITE_UNIT;
+
+    {
+        ALLOC_SCOPE(SD);
+        buffer_ = static_cast<uint8_t*>(malloc(options_.buffer_bytes));
+        io_buffer_ = static_cast<uint8_t*>(malloc(options_.buffer_bytes));
+    }
+    io_mutex_ = xSemaphoreCreateMutex();
+
+    if (!buffer_ || !io_buffer_ || !io_mutex_) {
+        Serial.printf("[SDLogWriter] ERROR: Failed to allocate %u byte buffers for %s\n",
+                      (unsigned)options_.buffer_bytes, path_);
+        free(buffer_);
+        free(io_buffer_);
+        buffer_ = nullptr;
+        io_buffer_ = nullptr;
+    }
+}
+
+SDLogWriter::~SDLogWriter() {
+    if (worker_) {
+        worker_->detach(this);
+    }
+    close();
+    free(buffer_);
+    free(io_buffer_);
+    if (io_mutex_) {
+        vSemaphoreDelete(io_mutex_);
+    }
+}
+
+// ============================================================================
+// Producer Side (any task, RAM only)
+// ============================================================================
+
+bool SDLogWriter::append(const uint8_t* data, size_t len) {
+    if (!data || len == 0) {
+        return true;
+    }
+
+    bool stored = false;
+    bool unit_ready = false;
+
+    lock();
+    if (buffer_ && len <= options_.buffer_bytes - buffered_) {
+        memcpy(buffer_ + buffered_, data, len);
+        unit_ready = (buffered_ / WRITE_UNIT) != ((buffered_ + len) / WRITE_UNIT);
+        buffered_ += len;
+        if (!unsynced_) {
+            unsynced_ = true;
+            oldest_ms_ = millis();
+        }
+        stats_.appends++;
+        stats_.bytes_appended += len;
+        if (buffered_ > stats_.max_buffered) {
+            stats_.max_buffered = buffered_;
+        }
+        stored = true;
+    } else {
+        stats_.dropped++;
+    }
+    unlock();
+
+    if (unit_ready && worker_) {
+        worker_->notify();
+    }
+    return stored;
+}
+
+bool SDLogWriter::append(const char* text) {
+    return append(reinterpret_cast<const uint8_t*>(text), text ? strlen(text) : 0);
+}
+
+void SDLogWriter::setPreamble(const uint8_t* data, size_t len) {
+    lock();
+    preamble_len_ = (data && len <= MAX_PREAMBLE) ? len : 0;
+    if (preamble_len_) {
+        memcpy(preamble_, data, preamble_len_);
+    }
+    unlock();
+}
+
+void SDLogWriter::requestFlush() {
+    flush_requested_ = true;
+    if (worker_) {
+        worker_->notify();
+    }
+}
+
+bool SDLogWriter::needsService(uint32_t now_ms) const {
+    lock();
+    bool due = buffered_ >= WRITE_UNIT || flush_requested_ ||
+               (unsynced_ && now_ms - oldest_ms_ >= options_.flush_interval_ms);
+    unlock();
+    return due;
+}
+
+// ============================================================================
+// Card Side (SD worker)
+// ============================================================================
+
+bool SDLogWriter::service(uint32_t now_ms) {
+    if (!needsService(now_ms) || !io_mutex_) {
+        return false;
+    }
+    if (xSemaphoreTake(io_mutex_, 0) != pdTRUE) {
+        return false;   // flush()/close() in progress on another task
+    }
+
+    lock();
+    bool everything = flush_requested_ ||
+                      (unsynced_ && now_ms - oldest_ms_ >= options_.flush_interval_ms);
+    unlock();
+
+    bool wrote = writeOut(everything);
+    xSemaphoreGive(io_mutex_);
+    return wrote;
+}
+
+bool SDLogWriter::flush(uint32_t timeout_ms) {
+    if (!io_mutex_ || xSemaphoreTake(io_mutex_, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return false;
+    }
+    bool ok = writeOut(true);
+    xSemaphoreGive(io_mutex_);
+    return ok;
+}
+
+void SDLogWriter::close() {
+    if (!io_mutex_ || xSemaphoreTake(io_mutex_, pdMS_TO_TICKS(2000)) != pdTRUE) {
+        return;
+    }
+    writeOut(true);
+    if (file_) {
+        file_.close();
+    }
+    xSemaphoreGive(io_mutex_);
+}
+
+bool SDLogWriter::writeOut(bool everything) {
+    // Take whole units (or everything) out of the append buffer
+    lock();
+    size_t n = everything ? buffered_ : buffered_ - buffered_ % WRITE_UNIT;
+    if (n > 0) {
+        memcpy(io_buffer_, buffer_, n);
+        memmove(buffer_, buffer_ + n, buffered_ - n);
+        buffered_ -= n;
+    }
+    if (everything) {
+        flush_requested_ = false;
+    }
+    unlock();
+
+    bool ok = true;
+    bool opened = true;
+    size_t written = 0;
+    bool synced = false;
+
+    if (n > 0) {
+        opened = ensureOpen(n);
+        if (opened) {
+            written = file_.write(io_buffer_, n);
+            file_size_ += written;
+            file_dirty_ = true;
+            ok = (written == n);
+        } else {
+            ok = false;   // Data is lost: logging must not back up into RAM forever
+        }
+    }
+
+    if (everything && file_ && file_dirty_) {
+        file_.flush();
+        file_dirty_ = false;
+        synced = true;
+    }
+
+    lock();
+    if (!opened) {
+        stats_.open_errors++;
+    } else if (n > 0) {
+        stats_.card_writes++;
+        stats_.bytes_written += written;
+        if (!ok) stats_.write_errors++;
+    }
+    if (synced) {
+        stats_.syncs++;
+    }
+    if (everything) {
+        // Anything appended while we were writing starts a new interval
+        unsynced_ = buffered_ > 0;
+        oldest_ms_ = millis();
+    }
+    unlock();
+
+    if (!ok) {
+        Serial.printf("[SDLogWriter] WARN: Lost %u bytes for %s\n", (unsigned)(n - written), path_);
+    }
+    return n > 0 || synced;
+}
+
+bool SDLogWriter::ensureOpen(size_t incoming) {
+    if (!file_) {
+        file_ = sd_.openFile(path_, FILE_APPEND);
+        if (!file_) {
+            return false;
+        }
+        file_size_ = file_.size();
+        file_dirty_ = false;
+        if (file_size_ == 0 && preamble_len_ > 0) {
+            file_size_ += file_.write(preamble_, preamble_len_);
+            file_dirty_ = true;
+        }
+    }
+
+    if (file_size_ > preamble_len_ && file_size_ + incoming > options_.max_file_bytes) {
+        return rotate();
+    }
+    return true;
+}
+
+bool SDLogWriter::rotate() {
+    file_.close();   // Syncs
+    if (file_dirty_) {
+        lock();
+        stats_.syncs++;
+        unlock();
+        file_dirty_ = false;
+    }
+
+    // Drop the oldest, shift path.N-1 → path.N ... path → path.1
+    char from[MAX_PATH + 4];
+    char to[MAX_PATH + 4];
+    uint8_t keep = options_.keep_files;
+    if (keep > 0) {
+        snprintf(to, sizeof(to), "%s.%u", path_, keep);
+        if (sd_.exists(to)) {
+            sd_.deleteFile(to);
+        }
+        for (uint8_t i = keep - 1; i >= 1; i--) {
+            snprintf(from, sizeof(from), "%s.%u", path_, i);
+            snprintf(to, sizeof(to), "%s.%u", path_, i + 1);
+            if (sd_.exists(from)) {
+                sd_.renameFile(from, to);
+            }
+        }
+        snprintf(to, sizeof(to), "%s.1", path_);
+        sd_.renameFile(path_, to);
+    } else {
+        sd_.deleteFile(path_);
+    }
+
+    lock();
+    stats_.rotations++;
+    unlock();
+
+    file_ = sd_.openFile(path_, FILE_WRITE);
+    if (!file_) {
+        return false;
+    }
+    file_size_ = 0;
+    if (preamble_len_ > 0) {
+        file_size_ = file_.write(preamble_, preamble_len_);
+        file_dirty_ = true;
+    }
+    return true;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+SDLogWriter::Stats SDLogWriter::getStats() const {
+    lock();
+    Stats stats = stats_;
+    stats.buffered = buffered_;
+    unlock();
+    return stats;
+}
+
+void SDLogWriter::printStats() const {
+    Stats stats = getStats();
+    Serial.printf("[SDLogWriter] %s: %lu appends (%lu dropped), %lu writes, %lu syncs, %lu rotations, "
+                  "%llu B written, %u B buffered (max %u)\n",
+                  path_, (unsigned long)stats.appends, (unsigned long)stats.dropped,
+                  (unsigned long)stats.card_writes, (unsigned long)stats.syncs,
+                  (unsigned long)stats.rotations, (unsigned long long)stats.bytes_written,
+                  (unsigned)stats.buffered, (unsigned)stats.max_buffered);
+}
+
+// ============================================================================
+// Locking (buffer + stats only - never held across card I/O)
+// ============================================================================
+
+#ifdef NATIVE_BUILD
+void SDLogWriter::lock() const {
+    while (lock_.test_and_set(std::memory_order_acquire)) {
+        // spin
+    }
+}
+
+void SDLogWriter::unlock() const {
+    lock_.clear(std::memory_order_release);
+}
+#else
+void SDLogWriter::lock() const {
+    portENTER_CRITICAL(&lock_);
+}
+
+void SDLogWriter::unlock() const {
+    portEXIT_CRITICAL(&lock_);
+}
+#endif
@@ -0,0 +1,158 @@
+#ifndef SD_LOG_WRITER_H
+#define SD_LOG_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#ifdef NATIVE_BUILD
+#include <atomic>
+#endif
+
+class SDManager;
+class SDWorker;
+
+/**
+ * Persistent buffered append writer for SD logs
+ *
+ * SDManager::appendFile() opens, writes and closes the file on every call;
+ * on FAT each close is a sync (directory entry + FAT sectors), so a log
+ * line costs several metadata writes. SDLogWriter keeps one file handle
+ * open and collects appends in RAM:
+ * - append() only copies into the RAM buffer (any task, never touches SD)
+ * - service() writes whole WRITE_UNITs (sector multiples) as the buffer
+ *   fills, and writes the remainder + syncs once per flush interval
+ * - flush() / requestFlush() for explicit sync points (deep sleep)
+ * - Size-based rotation: path → path.1 → ... → path.<keep_files>, each new
+ *   file starts with the optional preamble (e.g. a binary trace header)
+ *
+ * Cluster preallocation: the Arduino FS API has no f_expand()/ftruncate,
+ * so files cannot be preallocated. Writes are instead kept to whole
+ * sectors, so FATFS never has to merge a partial sector, and the FAT is
+ * only updated at sync points.
+ *
+ * Card I/O happens in service(), called by the SD worker for attached
+ * writers (SDWorker::attach), so logging tasks never block on the card.
+ * Appends that do not fit the buffer are dropped and counted.
+ *
+ * Usage:
+ *   SDLogWriter* log = new SDLogWriter(*g_sdManager, "/logs/events.csv");
+ *   g_sdWorker->attach(log);
+ *   log->append("1735722000,WORK_START\n");
+ */
+class SDLogWriter {
+public:
+    static constexpr size_t WRITE_UNIT = 512;     // FAT sector
+    static constexpr size_t MAX_PATH = 64;
+    static constexpr size_t MAX_PREAMBLE = 64;
+
+    struct Options {
+        size_t buffer_bytes = 4096;                 // RAM buffer (multiple of WRITE_UNIT)
+        uint32_t flush_interval_ms = 5000;          // Max age of buffered data before a sync
+        uint32_t max_file_bytes = 1024 * 1024;      // Rotate when the file would exceed this
+        uint8_t keep_files = 2;                     // Rotated files kept (path.1 .. path.N)
+    };
+
+    struct Stats {
+        uint32_t appends;
+        uint32_t dropped;          // Appends rejected (buffer full / too large)
+        uint32_t card_writes;      // File write() calls
+        uint32_t syncs;            // File flush() calls (FAT sync)
+        uint32_t rotations;
+        uint32_t open_errors;
+        uint32_t write_errors;
+        uint64_t bytes_appended;
+        uint64_t bytes_written;
+        size_t max_buffered;
+        size_t buffered;
+    };
+
+    SDLogWriter(SDManager& sd, const char* path);
+    SDLogWriter(SDManager& sd, const char* path, const Options& options);
+    ~SDLogWriter();
+
+    /**
+     * Queue data (RAM copy only)
+     * @return false if dropped (buffer full or len > buffer)
+     */
+    bool append(const uint8_t* data, size_t len);
+    bool append(const char* text);
+
+    /**
+     * Bytes written at the start of every new file (copied, max MAX_PREAMBLE)
+     */
+    void setPreamble(const uint8_t* data, size_t len);
+
+    /**
+     * Ask the next service() to write everything and sync
+     */
+    void requestFlush();
+
+    /**
+     * Do due card I/O on the calling task (SD worker, tests)
+     * Skips if another task is doing I/O on this writer.
+     * @param now_ms millis()
+     * @return true if anything was written
+     */
+    bool service(uint32_t now_ms);
+
+    /**
+     * Write everything buffered and sync now (blocks on the card)
+     * @return false on error or if the I/O lock timed out
+     */
+    bool flush(uint32_t timeout_ms = 2000);
+
+    /**
+     * Flush and close the file (reopened by the next write)
+     */
+    void close();
+
+    /**
+     * Buffer has whole units to write or a sync is due
+     */
+    bool needsService(uint32_t now_ms) const;
+
+    const char* getPath() const { return path_; }
+    Stats getStats() const;
+    void printStats() const;
+
+private:
+    friend class SDWorker;
+
+    bool writeOut(bool everything);
+    bool ensureOpen(size_t incoming);
+    bool rotate();
+    void lock() const;
+    void unlock() const;
+
+    SDManager& sd_;
+    char path_[MAX_PATH];
+    Options options_;
+
+    uint8_t* buffer_;            // Filled by append()
+    uint8_t* io_buffer_;         // Written by service()
+    size_t buffered_;
+    uint32_t oldest_ms_;         // millis() of the oldest unsynced append
+    bool unsynced_;              // Data appended or written since the last sync
+    volatile bool flush_requested_;
+
+    uint8_t preamble_[MAX_PREAMBLE];
+    size_t preamble_len_;
+
+    File file_;
+    size_t file_size_;
+    bool file_dirty_;              // Written since the last sync
+    SemaphoreHandle_t io_mutex_;   // Held during card I/O (service/flush/close)
+    SDWorker* worker_;             // Woken when a unit is ready (set by attach)
+
+    Stats stats_;
+#ifdef NATIVE_BUILD
+    mutable std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+#else
+    mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+#endif
+};
+
+#endif // SD_LOG_WRITER_H
@@ -1,4 +1,5 @@
 #include "SDManager.h"
+#include "../utils/AllocTracker.h"
 #include <M5Unified.h>
 
 // M5Stack Core2 SD card pins (SPI mode)
@@ -50,7 +51,23 @@ bool SDManager::exists(const char* path) {
     return SD.exists(path);
 }
 
+size_t SDManager::fileSize(const char* path) {
+    if (!mounted_) {
+        return 0;
+    }
+
+    File file = SD.open(path, FILE_READ);
+    if (!file) {
+        return 0;
+    }
+
+    size_t size = file.isDirectory() ? 0 : file.size();
+    file.close();
+    return size;
+}
+
 String SDManager::readFile(const char* path) {
+    ALLOC_SCOPE(SD);
     if (!mounted_) {
         Serial.println("[SDManager] Cannot read: SD not mounted");
         return "";
@@ -103,6 +120,7 @@ size_t SDManager::readFile(const char* path, uint8_t* buffer, size_t max_len) {
 }
 
 bool SDManager::writeFile(const char* path, const String& data) {
+    ALLOC_SCOPE(SD);
     return writeFile(path, (const uint8_t*)data.c_str(), data.length());
 }
 
@@ -144,6 +162,7 @@ bool SDManager::writeFile(const char* path, const uint8_t* data, size_t len) {
 }
 
 bool SDManager::appendFile(const char* path, const String& data) {
+    ALLOC_SCOPE(SD);
     if (!mounted_) {
         Serial.println("[SDManager] Cannot append: SD not mounted");
         return false;
@@ -167,6 +186,60 @@ bool SDManager::appendFile(const char* path, const String& data) {
     return (written == data.length());
 }
 
+bool SDManager::appendFile(const char* path, const uint8_t* data, size_t len) {
+    ALLOC_SCOPE(SD);
+    if (!mounted_) {
+        Serial.println("[SDManager] Cannot append: SD not mounted");
+        return false;
+    }
+
+    // Ensure parent directories exist
+    if (!ensureParentDirs(path)) {
+        return false;
+    }
+
+    File file = SD.open(path, FILE_APPEND);
+    if (!file) {
+        Serial.printf("[SDManager] Failed to open file for append: %s\n", path);
+        return false;
+    }
+
+    size_t written = file.write(data, len);
+    file.close();
+
+    Serial.printf("[SDManager] Appended %d bytes to %s\n", written, path);
+    return (written == len);
+}
+
+File SDManager::openFile(const char* path, const char* mode) {
+    if (!mounted_ || !path || !mode) {
+        return File();
+    }
+
+    if (mode[0] != 'r' && !ensureParentDirs(path)) {
+        Serial.printf("[SDManager] Failed to create parent dirs for %s\n", path);
+        return File();
+    }
+
+    File file = SD.open(path, mode);
+    if (!file) {
+        Serial.printf("[SDManager] Failed to open file: %s\n", path);
+    }
+    return file;
+}
+
+bool SDManager::renameFile(const char* from, const char* to) {
+    if (!mounted_) {
+        return false;
+    }
+
+    bool result = SD.rename(from, to);
+    if (!result) {
+        Serial.printf("[SDManager] Failed to rename %s -> %s\n", from, to);
+    }
+    return result;
+}
+
 bool SDManager::deleteFile(const char* path) {
     if (!mounted_) {
         return false;
@@ -298,21 +371,35 @@ bool SDManager::ensureParentDirs(const char* path) {
         return false;
     }
 
-    // Extract parent directory path
-    String pathStr(path);
-    int lastSlash = pathStr.lastIndexOf('/');
+    // Extract parent directory path (stack copy, no heap String)
+    const char* lastSlash = strrchr(path, '/');
+    size_t parentLen = lastSlash - path;
 
-    if (lastSlash <= 0) {
+    if (parentLen == 0) {
         return true; // Root directory or no parent
     }
 
-    String parentDir = pathStr.substring(0, lastSlash);
+    char parentDir[128];
+    if (parentLen >= sizeof(parentDir)) {
+        return false;
+    }
+    memcpy(parentDir, path, parentLen);
+    parentDir[parentLen] = '\0';
 
     // Check if parent exists
-    if (SD.exists(parentDir.c_str())) {
+    if (SD.exists(parentDir)) {
         return true;
     }
 
-    // Create parent directory (recursively creates all needed dirs)
-    return mkdir(parentDir.c_str());
+    // Create each missing level (SD.mkdir() creates one directory)
+    for (size_t i = 1; i < parentLen; i++) {
+        if (parentDir[i] != '/') continue;
+        parentDir[i] = '\0';
+        if (!SD.exists(parentDir) && !SD.mkdir(parentDir)) {
+            parentDir[i] = '/';
+            break;   // Final mkdir below reports the failure
+        }
+        parentDir[i] = '/';
+    }
+    return mkdir(parentDir);
 }
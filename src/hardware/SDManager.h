@@ -42,6 +42,13 @@ public:
      */
     bool exists(const char* path);
 
+    /**
+     * @brief Get file size without reading it
+     * @param path Absolute path to file
+     * @return Size in bytes, 0 if missing or not mounted
+     */
+    size_t fileSize(const char* path);
+
     /**
      * @brief Read entire file as String
      * @param path Absolute path to file
@@ -83,6 +90,32 @@ public:
      */
     bool appendFile(const char* path, const String& data);
 
+    /**
+     * @brief Append buffer to file (creates if doesn't exist)
+     * @param path Absolute path to file
+     * @param data Source buffer
+     * @param len Number of bytes to append
+     * @return true if successful
+     */
+    bool appendFile(const char* path, const uint8_t* data, size_t len);
+
+    /**
+     * @brief Open a long-lived file handle (for SDLogWriter)
+     * Write/append modes create missing parent directories.
+     * @param path Absolute path to file
+     * @param mode FILE_READ, FILE_WRITE or FILE_APPEND
+     * @return Open file, or an invalid File on error
+     */
+    File openFile(const char* path, const char* mode);
+
+    /**
+     * @brief Rename file (target must not exist)
+     * @param from Existing path
+     * @param to New path
+     * @return true if successful
+     */
+    bool renameFile(const char* from, const char* to);
+
     /**
      * @brief Delete file
      * @param path Absolute path to file
@@ -0,0 +1,568 @@
+#include "SDWorker.h"
+#include "SDManager.h"
+#include "SDLogWriter.h"
+#include "../utils/AllocTracker.h"
+#include "../utils/StackProfiler.h"
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+
+SDWorker::SDWorker(SDManager& sd)
+    : sd_(sd),
+      next_id_(1),
+      stats_{},
+      wake_queue_(nullptr),
+      task_(nullptr),
+      stop_requested_(false) {
+    memset(slots_, 0, sizeof(slots_));
+    memset(writers_, 0, sizeof(writers_));
+
+    // Length 1: a pending token already means "work available"
+    wake_queue_ = xQueueCreate(1, sizeof(uint8_t));
+    if (wake_queue_ == nullptr) {
+        Serial.println("[SDWorker] ERROR: Failed to create wake queue");
+    }
+}
+
+SDWorker::~SDWorker() {
+    stop();
+    for (auto& slot : slots_) {
+        free(slot.data);
+        slot.data = nullptr;
+    }
+    if (wake_queue_) {
+        vQueueDelete(wake_queue_);
+    }
+}
+
+// ============================================================================
+// Worker Task
+// ============================================================================
+
+bool SDWorker::start(int core) {
+    if (task_ != nullptr) {
+        return true;
+    }
+    if (wake_queue_ == nullptr) {
+        return false;
+    }
+
+    stop_requested_ = false;
+    BaseType_t result = StackProfiler::createTaskPinnedToCore(
+        taskEntry, "sd_worker", 4096, this, 1, &task_, core);
+    if (result != pdPASS) {
+        Serial.println("[SDWorker] ERROR: Failed to create worker task");
+        task_ = nullptr;
+        return false;
+    }
+
+    Serial.printf("[SDWorker] ✓ Worker started on core %d (%u request slots)\n",
+                  core, (unsigned)QUEUE_SLOTS);
+    return true;
+}
+
+void SDWorker::stop() {
+    if (task_ == nullptr) {
+        return;
+    }
+
+    stop_requested_ = true;
+    wake();
+    while (task_ != nullptr) {
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+}
+
+void SDWorker::taskEntry(void* param) {
+    SDWorker* worker = static_cast<SDWorker*>(param);
+    uint8_t token;
+
+    while (!worker->stop_requested_) {
+        xQueueReceive(worker->wake_queue_, &token, pdMS_TO_TICKS(IDLE_WAKE_MS));
+        while (!worker->stop_requested_ && worker->processPending(1) > 0) {
+            // One request per iteration so stop() takes effect between requests
+        }
+        if (!worker->stop_requested_) {
+            worker->serviceWriters(millis());
+        }
+    }
+
+    worker->task_ = nullptr;
+    vTaskDelete(NULL);
+}
+
+void SDWorker::wake() {
+    if (wake_queue_) {
+        uint8_t token = 1;
+        xQueueSend(wake_queue_, &token, 0);   // Full = already signalled
+    }
+}
+
+// ============================================================================
+// Submission
+// ============================================================================
+
+uint32_t SDWorker::read(const char* path, Callback callback, void* ctx, Priority priority, size_t max_len) {
+    return submit(Op::READ, path, nullptr, max_len, callback, ctx, priority, false);
+}
+
+uint32_t SDWorker::write(const char* path, const uint8_t* data, size_t len, Callback callback,
+                         void* ctx, Priority priority, bool coalesce) {
+    if (!data || len == 0) {
+        lock();
+        stats_.rejected++;
+        unlock();
+        return 0;
+    }
+    return submit(Op::WRITE, path, data, len, callback, ctx, priority, coalesce);
+}
+
+uint32_t SDWorker::append(const char* path, const uint8_t* data, size_t len, Callback callback,
+                          void* ctx, Priority priority) {
+    if (!data || len == 0) {
+        lock();
+        stats_.rejected++;
+        unlock();
+        return 0;
+    }
+    return submit(Op::APPEND, path, data, len, callback, ctx, priority, false);
+}
+
+uint32_t SDWorker::exists(const char* path, Callback callback, void* ctx, Priority priority) {
+    return submit(Op::EXISTS, path, nullptr, 0, callback, ctx, priority, false);
+}
+
+uint32_t SDWorker::mkdir(const char* path, Callback callback, void* ctx, Priority priority) {
+    return submit(Op::MKDIR, path, nullptr, 0, callback, ctx, priority, false);
+}
+
+uint32_t SDWorker::remove(const char* path, Callback callback, void* ctx, Priority priority) {
+    return submit(Op::REMOVE, path, nullptr, 0, callback, ctx, priority, false);
+}
+
+uint32_t SDWorker::submit(Op op, const char* path, const uint8_t* data, size_t len, Callback callback,
+                          void* ctx, Priority priority, bool coalesce) {
+    if (!path || path[0] != '/' || strlen(path) >= MAX_PATH || priority >= Priority::COUNT) {
+        lock();
+        stats_.rejected++;
+        unlock();
+        Serial.printf("[SDWorker] Rejected request: invalid path %s\n", path ? path : "(null)");
+        return 0;
+    }
+
+    // Copy the payload outside the lock (malloc is not allowed in a critical section)
+    uint8_t* payload = nullptr;
+    if (data) {
+        ALLOC_SCOPE(SD);
+        payload = static_cast<uint8_t*>(malloc(len));
+        if (!payload) {
+            lock();
+            stats_.rejected++;
+            unlock();
+            Serial.printf("[SDWorker] Rejected request: no memory for %u bytes\n", (unsigned)len);
+            return 0;
+        }
+        memcpy(payload, data, len);
+    }
+
+    uint32_t now = millis();
+    uint8_t* superseded = nullptr;
+    uint32_t id = 0;
+
+    lock();
+
+    if (coalesce && op == Op::WRITE) {
+        // Newest queued request for this file: merge only if it is a WRITE
+        // with the same callback (anything later would change the outcome)
+        Slot* newest = nullptr;
+        for (auto& slot : slots_) {
+            if (slot.state == SlotState::QUEUED && strcmp(slot.path, path) == 0 &&
+                (!newest || slot.id > newest->id)) {
+                newest = &slot;
+            }
+        }
+        if (newest && newest->op == Op::WRITE && newest->callback == callback && newest->ctx == ctx) {
+            superseded = newest->data;
+            newest->data = payload;
+            newest->len = len;
+            newest->coalesced = true;
+            if (priority < newest->priority) {
+                newest->priority = priority;
+            }
+            id = newest->id;
+            stats_.coalesced++;
+        }
+    }
+
+    if (id == 0) {
+        Slot* free_slot = nullptr;
+        for (auto& slot : slots_) {
+            if (slot.state == SlotState::FREE) {
+                free_slot = &slot;
+                break;
+            }
+        }
+
+        if (free_slot) {
+            free_slot->state = SlotState::QUEUED;
+            free_slot->op = op;
+            free_slot->priority = priority;
+            free_slot->coalesced = false;
+            free_slot->id = next_id_++;
+            if (next_id_ == 0) next_id_ = 1;   // 0 means "rejected"
+            free_slot->queued_ms = now;
+            strncpy(free_slot->path, path, MAX_PATH - 1);
+            free_slot->path[MAX_PATH - 1] = '\0';
+            free_slot->data = payload;
+            free_slot->len = len;
+            free_slot->callback = callback;
+            free_slot->ctx = ctx;
+            id = free_slot->id;
+
+            stats_.submitted++;
+            stats_.pending++;
+            if (stats_.pending > stats_.max_pending) {
+                stats_.max_pending = stats_.pending;
+            }
+        } else {
+            stats_.rejected++;
+        }
+    }
+
+    unlock();
+
+    if (id == 0) {
+        free(payload);
+        Serial.printf("[SDWorker] WARN: Queue full, dropped request for %s\n", path);
+        return 0;
+    }
+
+    free(superseded);
+    wake();
+    return id;
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+
+SDWorker::Slot* SDWorker::nextLocked() {
+    Slot* best = nullptr;
+    for (auto& slot : slots_) {
+        if (slot.state != SlotState::QUEUED) continue;
+        if (!best || slot.priority < best->priority ||
+            (slot.priority == best->priority && slot.id < best->id)) {
+            best = &slot;
+        }
+    }
+    if (!best) {
+        return nullptr;
+    }
+
+    // Never overtake an earlier request for the same file
+    for (auto& slot : slots_) {
+        if (slot.state == SlotState::QUEUED && slot.id < best->id && strcmp(slot.path, best->path) == 0) {
+            best = &slot;
+        }
+    }
+
+    // A file with a request in progress (another caller of processPending) waits
+    for (auto& slot : slots_) {
+        if (slot.state == SlotState::RUNNING && strcmp(slot.path, best->path) == 0) {
+            return nullptr;
+        }
+    }
+    return best;
+}
+
+size_t SDWorker::processPending(size_t max_requests) {
+    size_t executed = 0;
+
+    while (executed < max_requests) {
+        lock();
+        Slot* slot = nextLocked();
+        if (slot) {
+            slot->state = SlotState::RUNNING;
+        }
+        unlock();
+
+        if (!slot) {
+            break;
+        }
+
+        uint32_t started = millis();
+        Result result = {};
+        result.id = slot->id;
+        result.op = slot->op;
+        result.coalesced = slot->coalesced;
+        result.path = slot->path;
+        result.wait_ms = started - slot->queued_ms;
+
+        execute(*slot, result);
+        result.io_ms = millis() - started;
+
+        if (slot->callback) {
+            slot->callback(result, slot->ctx);
+        }
+        free(result.data);   // nullptr if the callback took ownership
+
+        uint8_t* payload = slot->data;
+
+        lock();
+        if (result.ok) {
+            stats_.completed++;
+            if (slot->op == Op::READ) stats_.bytes_read += result.len;
+            if (slot->op == Op::WRITE || slot->op == Op::APPEND) stats_.bytes_written += result.len;
+        } else {
+            stats_.failed++;
+        }
+        if (result.wait_ms > stats_.max_wait_ms) stats_.max_wait_ms = result.wait_ms;
+        if (result.io_ms > stats_.max_io_ms) stats_.max_io_ms = result.io_ms;
+        stats_.total_io_ms += result.io_ms;
+        stats_.pending--;
+        slot->data = nullptr;
+        slot->state = SlotState::FREE;
+        unlock();
+
+        free(payload);
+        executed++;
+    }
+
+    return executed;
+}
+
+void SDWorker::execute(Slot& slot, Result& result) {
+    switch (slot.op) {
+        case Op::READ: {
+            size_t size = sd_.exists(slot.path) ? sd_.fileSize(slot.path) : 0;
+            if (size == 0) {
+                result.ok = sd_.exists(slot.path);   // Empty file: ok, no data
+                break;
+            }
+            if (slot.len > 0 && size > slot.len) {
+                size = slot.len;
+            }
+
+            ALLOC_SCOPE(SD);
+            uint8_t* buffer = static_cast<uint8_t*>(psramFound() ? ps_malloc(size + 1) : malloc(size + 1));
+            if (!buffer) {
+                Serial.printf("[SDWorker] No memory to read %s (%u bytes)\n", slot.path, (unsigned)size);
+                break;
+            }
+            result.len = sd_.readFile(slot.path, buffer, size);
+            buffer[result.len] = '\0';
+            result.ok = result.len == size;
+            result.data = buffer;
+            break;
+        }
+
+        case Op::WRITE:
+            result.ok = sd_.writeFile(slot.path, slot.data, slot.len);
+            result.len = result.ok ? slot.len : 0;
+            break;
+
+        case Op::APPEND:
+            result.ok = sd_.appendFile(slot.path, slot.data, slot.len);
+            result.len = result.ok ? slot.len : 0;
+            break;
+
+        case Op::EXISTS:
+            result.ok = sd_.exists(slot.path);
+            break;
+
+        case Op::MKDIR:
+            result.ok = sd_.mkdir(slot.path);
+            break;
+
+        case Op::REMOVE:
+            result.ok = sd_.deleteFile(slot.path);
+            break;
+    }
+}
+
+// ============================================================================
+// Log Writers
+// ============================================================================
+
+bool SDWorker::attach(SDLogWriter* writer) {
+    if (!writer) {
+        return false;
+    }
+
+    bool attached = false;
+    lock();
+    for (auto& slot : writers_) {
+        if (slot == writer) {
+            attached = true;
+            break;
+        }
+    }
+    for (auto& slot : writers_) {
+        if (!attached && slot == nullptr) {
+            slot = writer;
+            attached = true;
+        }
+    }
+    unlock();
+
+    if (!attached) {
+        Serial.printf("[SDWorker] WARN: No writer slot for %s\n", writer->getPath());
+        return false;
+    }
+    writer->worker_ = this;
+    return true;
+}
+
+void SDWorker::detach(SDLogWriter* writer) {
+    lock();
+    for (auto& slot : writers_) {
+        if (slot == writer) {
+            slot = nullptr;
+        }
+    }
+    unlock();
+    if (writer && writer->worker_ == this) {
+        writer->worker_ = nullptr;
+    }
+}
+
+size_t SDWorker::serviceWriters(uint32_t now_ms) {
+    SDLogWriter* writers[MAX_WRITERS];
+    lock();
+    memcpy(writers, writers_, sizeof(writers));
+    unlock();
+
+    size_t serviced = 0;
+    for (SDLogWriter* writer : writers) {
+        if (writer && writer->service(now_ms)) {
+            serviced++;
+        }
+    }
+    return serviced;
+}
+
+// ============================================================================
+// Completion Waits
+// ============================================================================
+
+bool SDWorker::wait(uint32_t id, uint32_t timeout_ms) {
+    for (uint32_t waited = 0; isPending(id); waited += 5) {
+        if (task_ == nullptr && processPending() > 0) {
+            continue;   // No worker: the caller does the I/O
+        }
+        if (waited >= timeout_ms) {
+            return false;   // Also when another caller is still running the request
+        }
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    return true;
+}
+
+bool SDWorker::flush(uint32_t timeout_ms) {
+    for (uint32_t waited = 0; pendingCount() > 0; waited += 5) {
+        if (task_ == nullptr) {
+            if (processPending() == 0) return false;   // Only blocked by another caller
+            continue;
+        }
+        if (waited >= timeout_ms) {
+            Serial.printf("[SDWorker] WARN: Flush timed out, %u requests pending\n",
+                          (unsigned)pendingCount());
+            return false;
+        }
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+
+    // Writers: write out and sync on the calling task
+    SDLogWriter* writers[MAX_WRITERS];
+    lock();
+    memcpy(writers, writers_, sizeof(writers));
+    unlock();
+
+    bool ok = true;
+    for (SDLogWriter* writer : writers) {
+        if (writer && !writer->flush(timeout_ms)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool SDWorker::isPending(uint32_t id) const {
+    if (id == 0) {
+        return false;
+    }
+
+    bool pending = false;
+    lock();
+    for (const auto& slot : slots_) {
+        if (slot.state != SlotState::FREE && slot.id == id) {
+            pending = true;
+            break;
+        }
+    }
+    unlock();
+    return pending;
+}
+
+size_t SDWorker::pendingCount() const {
+    lock();
+    size_t pending = stats_.pending;
+    unlock();
+    return pending;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+SDWorker::Stats SDWorker::getStats() const {
+    lock();
+    Stats stats = stats_;
+    unlock();
+    return stats;
+}
+
+void SDWorker::printStats() const {
+    Stats stats = getStats();
+    Serial.printf("[SDWorker] %lu done, %lu failed, %lu coalesced, %lu rejected, %lu pending (max %lu)\n",
+                  (unsigned long)stats.completed, (unsigned long)stats.failed,
+                  (unsigned long)stats.coalesced, (unsigned long)stats.rejected,
+                  (unsigned long)stats.pending, (unsigned long)stats.max_pending);
+    Serial.printf("[SDWorker] Max wait %lu ms, max I/O %lu ms, total I/O %lu ms, %llu B read, %llu B written\n",
+                  (unsigned long)stats.max_wait_ms, (unsigned long)stats.max_io_ms,
+                  (unsigned long)stats.total_io_ms, (unsigned long long)stats.bytes_read,
+                  (unsigned long long)stats.bytes_written);
+}
+
+void SDWorker::resetStats() {
+    lock();
+    uint32_t pending = stats_.pending;
+    stats_ = Stats{};
+    stats_.pending = pending;
+    stats_.max_pending = pending;
+    unlock();
+}
+
+// ============================================================================
+// Locking (slot table only - never held across card I/O or callbacks)
+// ============================================================================
+
+#ifdef NATIVE_BUILD
+void SDWorker::lock() const {
+    while (lock_.test_and_set(std::memory_order_acquire)) {
+        // spin
+    }
+}
+
+void SDWorker::unlock() const {
+    lock_.clear(std::memory_order_release);
+}
+#else
+void SDWorker::lock() const {
+    portENTER_CRITICAL(&lock_);
+}
+
+void SDWorker::unlock() const {
+    portEXIT_CRITICAL(&lock_);
+}
+#endif
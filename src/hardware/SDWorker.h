@@ -0,0 +1,227 @@
+#ifndef SD_WORKER_H
+#define SD_WORKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+#ifdef NATIVE_BUILD
+#include <atomic>
+#endif
+
+class SDManager;
+class SDLogWriter;
+
+/**
+ * Asynchronous SD card I/O worker
+ *
+ * SDManager calls block the calling task for the whole SPI transaction
+ * (tens of ms for a FAT directory update, seconds on a slow or failing
+ * card). The worker owns all runtime SD traffic: callers enqueue a request
+ * and return immediately; a dedicated task on the network core executes
+ * requests and reports completion through a callback.
+ *
+ * Features:
+ * - Bounded request pool (QUEUE_SLOTS, static): a full queue rejects the
+ *   request (returns 0) instead of blocking the caller
+ * - Priorities: HIGH before NORMAL before LOW, FIFO within a priority
+ * - Per-path ordering: a request never overtakes an earlier pending
+ *   request for the same file (a HIGH read still sees a queued LOW write)
+ * - Coalescing: a WRITE replaces a still-pending WRITE of the same file
+ *   (same callback, nothing queued for that file in between) - repeated
+ *   /config/lasttime.txt updates cost one SD write
+ * - Completion callbacks run on the worker task; wait() / flush() give
+ *   future-style blocking for callers that may block (setup, deep sleep)
+ * - Attached SDLogWriters are serviced (buffer write-out, periodic sync)
+ *   on the worker task between requests
+ *
+ * Payloads are copied on submit, so callers may reuse their buffers.
+ * READ results are heap buffers (PSRAM if present) with a terminating NUL
+ * after `len` bytes; a callback keeps one by setting result.data = nullptr
+ * (and free()s it later), otherwise it is freed after the callback.
+ *
+ * Usage:
+ *   g_sdWorker = new SDWorker(*g_sdManager);
+ *   g_sdWorker->start(1);
+ *   g_sdWorker->write("/config/lasttime.txt", text, len, onSaved, nullptr,
+ *                     SDWorker::Priority::LOW);
+ *   g_sdWorker->read("/audio/warning.wav", onLoaded, this);
+ *
+ * Build: all environments (host tests drive processPending() directly or
+ * run the task on the FreeRTOS shim).
+ */
+class SDWorker {
+public:
+    static constexpr size_t QUEUE_SLOTS = 16;
+    static constexpr size_t MAX_PATH = 64;          // Including NUL
+    static constexpr uint32_t IDLE_WAKE_MS = 1000;  // Worker re-checks the queue at least this often
+    static constexpr size_t MAX_WRITERS = 4;
+
+    enum class Op : uint8_t {
+        READ,       // Whole file (optionally capped) → result.data
+        WRITE,      // Create / truncate
+        APPEND,     // Create if missing
+        EXISTS,
+        MKDIR,
+        REMOVE
+    };
+
+    enum class Priority : uint8_t {
+        HIGH,       // User-visible (sound assets)
+        NORMAL,
+        LOW,        // Background persistence (time backup, traces)
+        COUNT
+    };
+
+    struct Result {
+        uint32_t id;
+        Op op;
+        bool ok;              // EXISTS: file exists
+        bool coalesced;       // WRITE absorbed later writes of the same file
+        const char* path;
+        uint8_t* data;        // READ only (see class notes on ownership)
+        size_t len;           // Bytes read / written
+        uint32_t wait_ms;     // Queued → started
+        uint32_t io_ms;       // Started → finished
+    };
+
+    typedef void (*Callback)(Result& result, void* ctx);
+
+    struct Stats {
+        uint32_t submitted;
+        uint32_t completed;
+        uint32_t failed;
+        uint32_t coalesced;     // Writes merged into a pending one
+        uint32_t rejected;      // Queue full / invalid / out of memory
+        uint32_t pending;
+        uint32_t max_pending;
+        uint32_t max_wait_ms;
+        uint32_t max_io_ms;
+        uint32_t total_io_ms;
+        uint64_t bytes_read;
+        uint64_t bytes_written;
+    };
+
+    explicit SDWorker(SDManager& sd);
+    ~SDWorker();
+
+    /**
+     * Start the worker task (StackProfiler-registered, "sd_worker")
+     * @param core Core to run on - keep it off the UI core
+     */
+    bool start(int core = 1);
+
+    /**
+     * Stop the worker task after the request in progress (pending stay queued)
+     */
+    void stop();
+
+    bool isRunning() const { return task_ != nullptr; }
+
+    // Submit (any task, never blocks on the card). Return request id, 0 = rejected.
+    uint32_t read(const char* path, Callback callback = nullptr, void* ctx = nullptr,
+                  Priority priority = Priority::NORMAL, size_t max_len = 0);
+    uint32_t write(const char* path, const uint8_t* data, size_t len, Callback callback = nullptr,
+                   void* ctx = nullptr, Priority priority = Priority::NORMAL, bool coalesce = true);
+    uint32_t append(const char* path, const uint8_t* data, size_t len, Callback callback = nullptr,
+                    void* ctx = nullptr, Priority priority = Priority::NORMAL);
+    uint32_t exists(const char* path, Callback callback, void* ctx = nullptr,
+                    Priority priority = Priority::NORMAL);
+    uint32_t mkdir(const char* path, Callback callback = nullptr, void* ctx = nullptr,
+                   Priority priority = Priority::NORMAL);
+    uint32_t remove(const char* path, Callback callback = nullptr, void* ctx = nullptr,
+                    Priority priority = Priority::NORMAL);
+
+    /**
+     * Service a log writer on the worker task (it must outlive the worker
+     * or detach first - its destructor does)
+     */
+    bool attach(SDLogWriter* writer);
+    void detach(SDLogWriter* writer);
+
+    /**
+     * Service attached writers that have work due
+     * @return Writers that wrote or synced
+     */
+    size_t serviceWriters(uint32_t now_ms);
+
+    /**
+     * Wake the worker (new request or a writer buffer ready)
+     */
+    void notify() { wake(); }
+
+    /**
+     * Execute queued requests on the calling task
+     * Used by the worker task, by tests, and by wait()/flush() when the
+     * task is not running.
+     * @param max_requests Stop after this many
+     * @return Requests executed
+     */
+    size_t processPending(size_t max_requests = QUEUE_SLOTS);
+
+    /**
+     * Block until a request has completed (callback returned)
+     * Only for tasks that may block on the card (setup, shutdown).
+     * @return false on timeout
+     */
+    bool wait(uint32_t id, uint32_t timeout_ms);
+
+    /**
+     * Block until the queue is empty and attached writers are synced
+     * (e.g. before deep sleep)
+     * @return false on timeout
+     */
+    bool flush(uint32_t timeout_ms);
+
+    bool isPending(uint32_t id) const;
+    size_t pendingCount() const;
+
+    Stats getStats() const;
+    void printStats() const;
+    void resetStats();
+
+private:
+    enum class SlotState : uint8_t { FREE, QUEUED, RUNNING };
+
+    struct Slot {
+        SlotState state;
+        Op op;
+        Priority priority;
+        bool coalesced;
+        uint32_t id;              // Also the FIFO sequence
+        uint32_t queued_ms;
+        char path[MAX_PATH];
+        uint8_t* data;            // Copied payload (WRITE/APPEND)
+        size_t len;               // Payload length, READ cap (0 = whole file)
+        Callback callback;
+        void* ctx;
+    };
+
+    uint32_t submit(Op op, const char* path, const uint8_t* data, size_t len, Callback callback,
+                    void* ctx, Priority priority, bool coalesce);
+    Slot* nextLocked();
+    void execute(Slot& slot, Result& result);
+    void lock() const;
+    void unlock() const;
+    void wake();
+
+    static void taskEntry(void* param);
+
+    SDManager& sd_;
+    Slot slots_[QUEUE_SLOTS];
+    SDLogWriter* writers_[MAX_WRITERS];
+    uint32_t next_id_;
+    Stats stats_;
+    QueueHandle_t wake_queue_;
+    TaskHandle_t task_;
+    volatile bool stop_requested_;
+#ifdef NATIVE_BUILD
+    mutable std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+#else
+    mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+#endif
+};
+
+#endif // SD_WORKER_H
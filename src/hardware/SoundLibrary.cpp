@@ -0,0 +1,578 @@
+#include "SoundLibrary.h"
+#include "WavDecoder.h"
+#include "../utils/AllocTracker.h"
+#include <Arduino.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+SoundLibrary::SoundLibrary(SDWorker& worker, size_t budget_bytes)
+    : worker_(worker),
+      budget_(budget_bytes),
+      index_state_(IndexState::NONE),
+      entry_count_(0),
+      bytes_(0),
+      tick_(0),
+      deferred_count_(0),
+      stats_{} {
+    theme_[0] = '\0';
+    memset(entries_, 0, sizeof(entries_));
+    memset(slots_, 0, sizeof(slots_));
+    memset(deferred_, 0, sizeof(deferred_));
+    memset(deferred_prefetch_, 0, sizeof(deferred_prefetch_));
+}
+
+SoundLibrary::~SoundLibrary() {
+    for (auto& slot : slots_) {
+        free(slot.data);
+    }
+}
+
+// ============================================================================
+// Theme Index
+// ============================================================================
+
+static bool isValidName(const char* name, size_t max_len) {
+    if (!name || !*name || strlen(name) >= max_len) return false;
+    return strchr(name, '/') == nullptr && strstr(name, "..") == nullptr;
+}
+
+bool SoundLibrary::setTheme(const char* theme) {
+    if (!isValidName(theme, NAME_LEN)) {
+        Serial.printf("[SoundLibrary] ERROR: Invalid theme name '%s'\n", theme ? theme : "");
+        return false;
+    }
+
+    char path[SDWorker::MAX_PATH];
+    snprintf(path, sizeof(path), "%s/%s/%s", THEMES_DIR, theme, MANIFEST_FILE);
+
+    lock();
+    strncpy(theme_, theme, NAME_LEN - 1);
+    theme_[NAME_LEN - 1] = '\0';
+    entry_count_ = 0;
+    deferred_count_ = 0;
+    index_state_ = IndexState::LOADING;
+    unlock();
+
+    if (worker_.read(path, onManifest, this, SDWorker::Priority::HIGH, MAX_MANIFEST_BYTES) == 0) {
+        lock();
+        index_state_ = IndexState::NONE;
+        unlock();
+        Serial.printf("[SoundLibrary] ERROR: SD queue full, theme '%s' not loaded\n", theme);
+        return false;
+    }
+    return true;
+}
+
+size_t SoundLibrary::parseManifest(const char* text, const char* theme, Entry* entries, size_t max) {
+    size_t count = 0;
+    const char* line = text;
+
+    while (line && *line) {
+        const char* end = strchr(line, '\n');
+        size_t line_len = end ? static_cast<size_t>(end - line) : strlen(line);
+        const char* next = end ? end + 1 : nullptr;
+
+        // Trim, skip blank lines and comments
+        const char* first = line;
+        const char* last = line + line_len;
+        while (first < last && isspace(static_cast<unsigned char>(*first))) first++;
+        while (last > first && isspace(static_cast<unsigned char>(last[-1]))) last--;
+        const char* equals = static_cast<const char*>(memchr(first, '=', last - first));
+        if (first == last || *first == '#' || !equals) {
+            line = next;
+            continue;
+        }
+
+        const char* name_end = equals;
+        while (name_end > first && isspace(static_cast<unsigned char>(name_end[-1]))) name_end--;
+        const char* file = equals + 1;
+        while (file < last && isspace(static_cast<unsigned char>(*file))) file++;
+
+        char name[NAME_LEN];
+        char file_name[SDWorker::MAX_PATH];
+        size_t name_len = name_end - first;
+        size_t file_len = last - file;
+        if (name_len == 0 || name_len >= sizeof(name) || file_len == 0 || file_len >= sizeof(file_name)) {
+            line = next;
+            continue;
+        }
+        memcpy(name, first, name_len);
+        name[name_len] = '\0';
+        memcpy(file_name, file, file_len);
+        file_name[file_len] = '\0';
+
+        // Files stay inside the theme folder
+        Entry entry;
+        int written = snprintf(entry.path, sizeof(entry.path), "%s/%s/%s", THEMES_DIR, theme, file_name);
+        if (file_name[0] == '/' || strstr(file_name, "..") ||
+            written < 0 || static_cast<size_t>(written) >= sizeof(entry.path)) {
+            Serial.printf("[SoundLibrary] Manifest: skipping '%s'\n", file_name);
+            line = next;
+            continue;
+        }
+        memcpy(entry.name, name, name_len + 1);
+
+        // A repeated name replaces the earlier line
+        size_t index = 0;
+        while (index < count && strcmp(entries[index].name, name) != 0) index++;
+        if (index == max) {
+            Serial.printf("[SoundLibrary] Manifest: more than %u clips, rest ignored\n", (unsigned)max);
+            break;
+        }
+        entries[index] = entry;
+        if (index == count) count++;
+        line = next;
+    }
+
+    return count;
+}
+
+void SoundLibrary::onManifest(SDWorker::Result& result, void* ctx) {
+    // Runs on the SD worker task
+    SoundLibrary* library = static_cast<SoundLibrary*>(ctx);
+
+    char theme[NAME_LEN];
+    library->lock();
+    memcpy(theme, library->theme_, sizeof(theme));
+    library->unlock();
+
+    char expected[SDWorker::MAX_PATH];
+    snprintf(expected, sizeof(expected), "%s/%s/%s", THEMES_DIR, theme, MANIFEST_FILE);
+    if (strcmp(result.path, expected) != 0) {
+        return;   // Theme changed while the read was queued
+    }
+
+    bool have_manifest = result.ok && result.data;
+    Entry* parsed = nullptr;
+    size_t count = 0;
+    if (have_manifest) {
+        ALLOC_SCOPE(AUDIO);
+        parsed = static_cast<Entry*>(malloc(sizeof(Entry) * MAX_CLIPS));
+        if (parsed) {
+            count = parseManifest(reinterpret_cast<const char*>(result.data), theme, parsed, MAX_CLIPS);
+        }
+    }
+
+    char deferred[MAX_DEFERRED][NAME_LEN];
+    bool deferred_prefetch[MAX_DEFERRED];
+    size_t deferred_count;
+
+    library->lock();
+    if (parsed) {
+        memcpy(library->entries_, parsed, sizeof(Entry) * count);
+    }
+    library->entry_count_ = count;
+    library->index_state_ = have_manifest ? IndexState::MANIFEST : IndexState::LEGACY;
+    deferred_count = library->deferred_count_;
+    memcpy(deferred, library->deferred_, sizeof(deferred));
+    memcpy(deferred_prefetch, library->deferred_prefetch_, sizeof(deferred_prefetch));
+    library->deferred_count_ = 0;
+    library->unlock();
+
+    free(parsed);
+    if (have_manifest) {
+        Serial.printf("[SoundLibrary] Theme '%s': %u clips\n", theme, (unsigned)count);
+    } else {
+        Serial.printf("[SoundLibrary] Theme '%s' has no %s - using %s/*.wav\n",
+                      theme, MANIFEST_FILE, LEGACY_DIR);
+    }
+
+    // Plays and prefetches that came in while the manifest was on its way
+    for (size_t i = 0; i < deferred_count; i++) {
+        library->queueLoad(deferred[i],
+                           deferred_prefetch[i] ? SDWorker::Priority::NORMAL : SDWorker::Priority::HIGH,
+                           deferred_prefetch[i]);
+    }
+}
+
+bool SoundLibrary::resolve(const char* name, char* path, size_t path_len) const {
+    lock();
+    bool found = resolveLocked(name, path, path_len);
+    unlock();
+    return found;
+}
+
+bool SoundLibrary::resolveLocked(const char* name, char* path, size_t path_len) const {
+    if (!isValidName(name, NAME_LEN)) return false;
+
+    if (index_state_ == IndexState::MANIFEST) {
+        for (size_t i = 0; i < entry_count_; i++) {
+            if (strcmp(entries_[i].name, name) == 0) {
+                int written = snprintf(path, path_len, "%s", entries_[i].path);
+                return written > 0 && static_cast<size_t>(written) < path_len;
+            }
+        }
+        return false;
+    }
+    if (index_state_ == IndexState::LEGACY) {
+        int written = snprintf(path, path_len, "%s/%s.wav", LEGACY_DIR, name);
+        return written > 0 && static_cast<size_t>(written) < path_len;
+    }
+    return false;
+}
+
+void SoundLibrary::defer(const char* name, bool prefetch) {
+    lock();
+    if (index_state_ == IndexState::LOADING) {
+        size_t i = 0;
+        while (i < deferred_count_ && strcmp(deferred_[i], name) != 0) i++;
+        if (i == deferred_count_ && i < MAX_DEFERRED && strlen(name) < NAME_LEN) {
+            strcpy(deferred_[i], name);
+            deferred_prefetch_[i] = prefetch;
+            deferred_count_++;
+        } else if (i < deferred_count_ && !prefetch) {
+            deferred_prefetch_[i] = false;   // Played: HIGH priority after all
+        }
+    }
+    unlock();
+}
+
+// ============================================================================
+// Clip Cache
+// ============================================================================
+
+bool SoundLibrary::acquire(const char* name, const uint8_t** data, size_t* len) {
+    *data = nullptr;
+    *len = 0;
+
+    char path[SDWorker::MAX_PATH];
+    lock();
+    bool known = resolveLocked(name, path, sizeof(path));
+    bool indexing = index_state_ == IndexState::LOADING;
+    Slot* slot = known ? findLocked(path) : nullptr;
+    if (slot && slot->state == SlotState::READY) {
+        slot->pins++;
+        slot->last_used = ++tick_;
+        stats_.hits++;
+        if (slot->prefetched) {
+            stats_.prefetch_hits++;
+            slot->prefetched = false;
+        }
+        *data = slot->data;
+        *len = slot->len;
+        unlock();
+        return true;
+    }
+    stats_.misses++;
+    bool loading = slot != nullptr;
+    unlock();
+
+    // Miss: this play uses the caller's fallback, the next one hits
+    if (indexing) {
+        defer(name, false);
+    } else if (known && !loading) {
+        queueLoad(name, SDWorker::Priority::HIGH, false);
+    }
+    return false;
+}
+
+void SoundLibrary::release(const uint8_t* data) {
+    if (!data) return;
+    lock();
+    for (auto& slot : slots_) {
+        if (slot.state == SlotState::READY && slot.data == data) {
+            if (slot.pins > 0) slot.pins--;
+            break;
+        }
+    }
+    unlock();
+}
+
+bool SoundLibrary::prefetch(const char* name) {
+    lock();
+    bool indexing = index_state_ == IndexState::LOADING;
+    unlock();
+    if (indexing) {
+        defer(name, true);
+        return true;
+    }
+
+    return queueLoad(name, SDWorker::Priority::NORMAL, true);
+}
+
+size_t SoundLibrary::prefetchNext(const PomodoroSequence& sequence) {
+    const char* names[3];
+    size_t count = predictNext(sequence, names, 3);
+    size_t ready = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (prefetch(names[i])) ready++;
+    }
+    return ready;
+}
+
+bool SoundLibrary::queueLoad(const char* name, SDWorker::Priority priority, bool prefetch) {
+    char path[SDWorker::MAX_PATH];
+    uint8_t* evicted = nullptr;
+
+    lock();
+    if (!resolveLocked(name, path, sizeof(path))) {
+        unlock();
+        return false;
+    }
+    Slot* slot = findLocked(path);
+    if (slot) {
+        if (slot->state == SlotState::READY) {
+            slot->last_used = ++tick_;   // Wanted soon: keep it
+        }
+        unlock();
+        return true;
+    }
+
+    for (auto& candidate : slots_) {
+        if (candidate.state == SlotState::FREE) {
+            slot = &candidate;
+            break;
+        }
+    }
+    if (!slot) {
+        slot = lruLocked(nullptr);
+    }
+    if (!slot) {
+        unlock();
+        Serial.printf("[SoundLibrary] No free cache slot for %s\n", name);
+        return false;
+    }
+    if (slot->state == SlotState::READY) {
+        evicted = slot->data;
+        bytes_ -= slot->len;
+        stats_.evictions++;
+    }
+    slot->state = SlotState::LOADING;
+    slot->prefetched = prefetch;
+    slot->pins = 0;
+    slot->data = nullptr;
+    slot->len = 0;
+    memcpy(slot->path, path, sizeof(slot->path));
+    if (prefetch) stats_.prefetches++;
+    unlock();
+
+    free(evicted);   // Not in the critical section
+
+    if (worker_.read(path, onClipLoaded, this, priority) == 0) {
+        lock();
+        slot->state = SlotState::FREE;
+        if (prefetch) stats_.prefetches--;
+        unlock();
+        return false;
+    }
+    return true;
+}
+
+void SoundLibrary::onClipLoaded(SDWorker::Result& result, void* ctx) {
+    // Runs on the SD worker task: decode here, not on the UI task
+    SoundLibrary* library = static_cast<SoundLibrary*>(ctx);
+
+    uint8_t* clip = nullptr;
+    size_t clip_len = 0;
+    bool ok = result.ok && result.data && result.len > 0;
+    if (ok) {
+        ALLOC_SCOPE(AUDIO);
+        ok = WavDecoder::convert(result.data, result.len, &clip, &clip_len);
+        if (ok && clip == result.data) {
+            result.data = nullptr;   // Already native: keep the read buffer
+        }
+    }
+
+    uint8_t* evicted[CACHE_SLOTS];
+    size_t evicted_count = 0;
+    bool rejected = false;
+
+    library->lock();
+    Slot* slot = library->findLocked(result.path);
+    if (!slot || slot->state != SlotState::LOADING) {
+        library->unlock();
+        free(clip);
+        return;
+    }
+    if (!ok) {
+        slot->state = SlotState::FREE;
+        library->stats_.load_failures++;
+        library->unlock();
+        Serial.printf("[SoundLibrary] %s: %s\n", result.path,
+                      result.ok ? "unsupported WAV format" : "not found");
+        return;
+    }
+
+    // Least recently used unpinned clips make room
+    while (library->bytes_ + clip_len > library->budget_) {
+        Slot* victim = library->lruLocked(slot);
+        if (!victim) break;
+        evicted[evicted_count++] = victim->data;
+        library->bytes_ -= victim->len;
+        victim->state = SlotState::FREE;
+        victim->data = nullptr;
+        victim->len = 0;
+        library->stats_.evictions++;
+    }
+
+    if (library->bytes_ + clip_len > library->budget_) {
+        slot->state = SlotState::FREE;
+        library->stats_.rejected++;
+        rejected = true;
+    } else {
+        slot->state = SlotState::READY;
+        slot->data = clip;
+        slot->len = clip_len;
+        slot->last_used = ++library->tick_;
+        library->bytes_ += clip_len;
+        if (library->bytes_ > library->stats_.peak_bytes) library->stats_.peak_bytes = library->bytes_;
+        library->stats_.loads++;
+    }
+    library->unlock();
+
+    for (size_t i = 0; i < evicted_count; i++) {
+        free(evicted[i]);
+    }
+    if (rejected) {
+        free(clip);
+        Serial.printf("[SoundLibrary] %s (%u bytes) does not fit the %u byte budget\n",
+                      result.path, (unsigned)clip_len, (unsigned)library->budget_);
+        return;
+    }
+    Serial.printf("[SoundLibrary] Cached %s (%u bytes), queued %lu ms\n",
+                  result.path, (unsigned)clip_len, (unsigned long)result.wait_ms);
+}
+
+bool SoundLibrary::isCached(const char* name) const {
+    char path[SDWorker::MAX_PATH];
+    lock();
+    const Slot* slot = resolveLocked(name, path, sizeof(path)) ? findLocked(path) : nullptr;
+    bool cached = slot && slot->state == SlotState::READY;
+    unlock();
+    return cached;
+}
+
+SoundLibrary::Slot* SoundLibrary::findLocked(const char* path) {
+    for (auto& slot : slots_) {
+        if (slot.state != SlotState::FREE && strcmp(slot.path, path) == 0) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+const SoundLibrary::Slot* SoundLibrary::findLocked(const char* path) const {
+    return const_cast<SoundLibrary*>(this)->findLocked(path);
+}
+
+SoundLibrary::Slot* SoundLibrary::lruLocked(const Slot* keep) {
+    Slot* oldest = nullptr;
+    for (auto& slot : slots_) {
+        if (&slot == keep || slot.state != SlotState::READY || slot.pins > 0) continue;
+        if (!oldest || slot.last_used < oldest->last_used) {
+            oldest = &slot;
+        }
+    }
+    return oldest;
+}
+
+void SoundLibrary::clear() {
+    uint8_t* dropped[CACHE_SLOTS];
+    size_t count = 0;
+
+    lock();
+    for (auto& slot : slots_) {
+        if (slot.state == SlotState::READY && slot.pins == 0) {
+            dropped[count++] = slot.data;
+            bytes_ -= slot.len;
+            slot.state = SlotState::FREE;
+            slot.data = nullptr;
+            slot.len = 0;
+        }
+    }
+    unlock();
+
+    for (size_t i = 0; i < count; i++) {
+        free(dropped[i]);
+    }
+}
+
+// ============================================================================
+// Schedule Prediction
+// ============================================================================
+
+const char* SoundLibrary::startClipFor(PomodoroSequence::SessionType type) {
+    switch (type) {
+        case PomodoroSequence::SessionType::WORK:
+            return "work_start";
+        case PomodoroSequence::SessionType::SHORT_BREAK:
+            return "rest_start";
+        case PomodoroSequence::SessionType::LONG_BREAK:
+            return "long_rest_start";
+    }
+    return "work_start";
+}
+
+size_t SoundLibrary::predictNext(const PomodoroSequence& sequence, const char** names, size_t max) {
+    const char* candidates[3] = {
+        "warning",
+        startClipFor(sequence.getNextSession().type),
+        startClipFor(sequence.getCurrentSession().type),
+    };
+
+    size_t count = 0;
+    for (const char* candidate : candidates) {
+        bool duplicate = false;
+        for (size_t i = 0; i < count; i++) {
+            if (strcmp(names[i], candidate) == 0) duplicate = true;
+        }
+        if (!duplicate && count < max) {
+            names[count++] = candidate;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+SoundLibrary::Stats SoundLibrary::getStats() const {
+    lock();
+    Stats stats = stats_;
+    stats.bytes = bytes_;
+    stats.budget_bytes = budget_;
+    stats.clips = static_cast<uint8_t>(entry_count_);
+    stats.cached = 0;
+    for (const auto& slot : slots_) {
+        if (slot.state == SlotState::READY) stats.cached++;
+    }
+    unlock();
+    return stats;
+}
+
+void SoundLibrary::printStats() const {
+    Stats stats = getStats();
+    uint32_t plays = stats.hits + stats.misses;
+    Serial.printf("[SoundLibrary] theme=%s clips=%u cached=%u %u/%u KB (peak %u KB)\n",
+                  theme_, stats.clips, stats.cached, (unsigned)(stats.bytes / 1024),
+                  (unsigned)(stats.budget_bytes / 1024), (unsigned)(stats.peak_bytes / 1024));
+    Serial.printf("[SoundLibrary] hits=%lu misses=%lu (%lu%% hit) prefetches=%lu used=%lu "
+                  "evictions=%lu failures=%lu rejected=%lu\n",
+                  (unsigned long)stats.hits, (unsigned long)stats.misses,
+                  (unsigned long)(plays ? stats.hits * 100 / plays : 0),
+                  (unsigned long)stats.prefetches, (unsigned long)stats.prefetch_hits,
+                  (unsigned long)stats.evictions, (unsigned long)stats.load_failures,
+                  (unsigned long)stats.rejected);
+}
+
+#ifdef NATIVE_BUILD
+void SoundLibrary::lock() const {
+    while (lock_.test_and_set(std::memory_order_acquire)) {
+        // spin
+    }
+}
+
+void SoundLibrary::unlock() const {
+    lock_.clear(std::memory_order_release);
+}
+#else
+void SoundLibrary::lock() const {
+    portENTER_CRITICAL(&lock_);
+}
+
+void SoundLibrary::unlock() const {
+    portEXIT_CRITICAL(&lock_);
+}
+#endif
@@ -0,0 +1,205 @@
+#ifndef SOUND_LIBRARY_H
+#define SOUND_LIBRARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "SDWorker.h"
+#include "../core/PomodoroSequence.h"
+
+#ifdef NATIVE_BUILD
+#include <atomic>
+#endif
+
+/**
+ * Sound themes on SD: manifest index + PSRAM LRU cache of decoded clips
+ *
+ * AudioPlayer used to load four fixed files at boot and keep them for the
+ * whole uptime. SoundLibrary indexes named clips per theme and keeps only
+ * what is likely to play in PSRAM:
+ * - Theme = folder THEMES_DIR/<theme>/ with a MANIFEST_FILE of
+ *   "name = file.wav" lines (# comments, files relative to the folder)
+ * - No manifest: clips resolve to the legacy LEGACY_DIR/<name>.wav layout,
+ *   so existing cards keep working
+ * - Clips are loaded by the SD worker and decoded there (WavDecoder), then
+ *   cached by path with a byte budget; least recently used clips are
+ *   evicted first, clips pinned by playback never
+ * - acquire() never touches the card: a hit returns the PSRAM buffer, a
+ *   miss queues a HIGH priority load and the caller plays its fallback
+ * - predictNext() names the clips the PomodoroSequence schedule plays
+ *   next (30 s warning, next interval's start sound) for prefetch()
+ *
+ * Manifest (/audio/themes/bells/theme.txt):
+ *   # Bells theme
+ *   work_start = up.wav
+ *   rest_start = down.wav
+ *   long_rest_start = gong.wav
+ *   warning = tick.wav
+ *
+ * Usage:
+ *   g_soundLibrary = new SoundLibrary(*g_sdWorker);
+ *   g_soundLibrary->setTheme("bells");            // Manifest read queued
+ *   g_soundLibrary->prefetchNext(*g_sequence);    // On interval change
+ *   if (g_soundLibrary->acquire("warning", &wav, &len)) {
+ *       M5.Speaker.playWav(wav, len);
+ *       ...
+ *       g_soundLibrary->release(wav);             // Playback finished
+ *   }
+ *
+ * Memory: ~2.5 KB for the index and cache table, clips in PSRAM up to the
+ * budget. The library must outlive the worker (load callbacks hold it).
+ */
+class SoundLibrary {
+public:
+    static constexpr size_t MAX_CLIPS = 16;          // Manifest entries per theme
+    static constexpr size_t CACHE_SLOTS = 12;
+    static constexpr size_t NAME_LEN = 24;           // Clip / theme name, including NUL
+    static constexpr size_t MAX_DEFERRED = 4;        // Requests made before the manifest arrived
+    static constexpr size_t DEFAULT_BUDGET_BYTES = 512 * 1024;
+    static constexpr size_t MAX_MANIFEST_BYTES = 4096;
+    static constexpr const char* THEMES_DIR = "/audio/themes";
+    static constexpr const char* MANIFEST_FILE = "theme.txt";
+    static constexpr const char* LEGACY_DIR = "/audio";
+    static constexpr const char* DEFAULT_THEME = "default";
+
+    enum class IndexState : uint8_t {
+        NONE,       // No theme selected
+        LOADING,    // Manifest read queued
+        MANIFEST,   // Clips from the theme manifest
+        LEGACY      // No manifest: LEGACY_DIR/<name>.wav
+    };
+
+    struct Stats {
+        uint32_t hits;
+        uint32_t misses;
+        uint32_t prefetches;       // Loads queued ahead of playback
+        uint32_t prefetch_hits;    // First play of a prefetched clip
+        uint32_t loads;            // Clips decoded into the cache
+        uint32_t load_failures;    // Missing / unsupported files
+        uint32_t evictions;
+        uint32_t rejected;         // Larger than what the budget can free
+        size_t bytes;
+        size_t peak_bytes;
+        size_t budget_bytes;
+        uint8_t clips;             // Manifest entries
+        uint8_t cached;
+    };
+
+    explicit SoundLibrary(SDWorker& worker, size_t budget_bytes = DEFAULT_BUDGET_BYTES);
+    ~SoundLibrary();
+
+    /**
+     * Select a theme and queue its manifest read
+     * Cached clips of the previous theme stay until the LRU evicts them.
+     * @return false if the name is invalid or the worker queue is full
+     */
+    bool setTheme(const char* theme);
+    const char* getTheme() const { return theme_; }
+    IndexState getIndexState() const { return index_state_; }
+
+    /**
+     * Cached clip for playback (any task, never blocks on the card)
+     * On a hit the clip is pinned until release(); on a miss a load is
+     * queued so the next play hits.
+     * @return true on a cache hit
+     */
+    bool acquire(const char* name, const uint8_t** data, size_t* len);
+
+    /**
+     * Unpin a clip returned by acquire()
+     */
+    void release(const uint8_t* data);
+
+    /**
+     * Queue a NORMAL priority load if the clip is not cached (refreshes
+     * its LRU age if it is)
+     * @return false if the clip is unknown or the worker queue is full
+     */
+    bool prefetch(const char* name);
+
+    /**
+     * Prefetch the clips the schedule plays next (see predictNext())
+     * @return Clips cached or on their way
+     */
+    size_t prefetchNext(const PomodoroSequence& sequence);
+
+    bool isCached(const char* name) const;
+
+    /**
+     * SD path of a clip in the current theme
+     * @return false if the theme has no such clip (or is not indexed yet)
+     */
+    bool resolve(const char* name, char* path, size_t path_len) const;
+
+    /**
+     * Clips the schedule plays next, soonest first: the 30 s warning, the
+     * next interval's start sound, and the current interval's start sound
+     * (sequence idle, waiting for a start press)
+     * @return Names written, no duplicates (static strings, manifest keys)
+     */
+    static size_t predictNext(const PomodoroSequence& sequence, const char** names, size_t max);
+    static const char* startClipFor(PomodoroSequence::SessionType type);
+
+    /**
+     * Drop every unpinned clip (theme change, low memory)
+     */
+    void clear();
+
+    Stats getStats() const;
+    void printStats() const;
+
+private:
+    enum class SlotState : uint8_t { FREE, LOADING, READY };
+
+    struct Entry {
+        char name[NAME_LEN];
+        char path[SDWorker::MAX_PATH];   // THEMES_DIR/<theme>/<file>
+    };
+
+    struct Slot {
+        SlotState state;
+        bool prefetched;          // Loaded ahead of playback, not played yet
+        uint8_t pins;
+        uint32_t last_used;       // LRU tick
+        char path[SDWorker::MAX_PATH];
+        uint8_t* data;
+        size_t len;
+    };
+
+    static void onManifest(SDWorker::Result& result, void* ctx);
+    static void onClipLoaded(SDWorker::Result& result, void* ctx);
+    static size_t parseManifest(const char* text, const char* theme, Entry* entries, size_t max);
+    bool resolveLocked(const char* name, char* path, size_t path_len) const;
+    Slot* findLocked(const char* path);
+    const Slot* findLocked(const char* path) const;
+    Slot* lruLocked(const Slot* keep);
+    /**
+     * Reserve a cache slot and queue the read (no-op if cached or loading)
+     * @return false if the clip is unknown, every slot is busy or the
+     *         worker queue is full
+     */
+    bool queueLoad(const char* name, SDWorker::Priority priority, bool prefetch);
+    void defer(const char* name, bool prefetch);
+    void lock() const;
+    void unlock() const;
+
+    SDWorker& worker_;
+    size_t budget_;
+    char theme_[NAME_LEN];
+    IndexState index_state_;
+    Entry entries_[MAX_CLIPS];
+    size_t entry_count_;
+    Slot slots_[CACHE_SLOTS];
+    size_t bytes_;
+    uint32_t tick_;
+    char deferred_[MAX_DEFERRED][NAME_LEN];
+    bool deferred_prefetch_[MAX_DEFERRED];
+    size_t deferred_count_;
+    Stats stats_;
+#ifdef NATIVE_BUILD
+    mutable std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+#else
+    mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+#endif
+};
+
+#endif // SOUND_LIBRARY_H
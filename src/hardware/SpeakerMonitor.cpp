@@ -0,0 +1,86 @@
+#include "SpeakerMonitor.h"
+#include "../utils/AudioLatency.h"
+#include <Arduino.h>
+#include <string.h>
+
+SpeakerMonitor::SpeakerMonitor()
+    : active_(false),
+      output_reported_(false),
+      submit_us_(0),
+      pipeline_us_(0),
+      duration_us_(0),
+      last_playing_us_(0),
+      stats_{} {
+}
+
+void SpeakerMonitor::start(uint32_t submit_us, uint32_t pipeline_us, uint32_t duration_us) {
+    active_ = true;
+    output_reported_ = false;
+    submit_us_ = submit_us;
+    pipeline_us_ = pipeline_us;
+    duration_us_ = duration_us;
+    last_playing_us_ = submit_us;
+    stats_.clips++;
+}
+
+void SpeakerMonitor::poll(uint32_t now_us, bool playing) {
+    if (!active_) return;
+
+    if (playing) {
+        if (!output_reported_) {
+            // Mixer has the clip: estimated to reach the DAC behind the queued audio
+            AUDIO_OUTPUT(submit_us_ + pipeline_us_);
+            output_reported_ = true;
+        }
+        last_playing_us_ = now_us;
+        return;
+    }
+
+    // Clip done: still playing after submit + duration = starved mixer
+    active_ = false;
+    if (!output_reported_) {
+        AUDIO_OUTPUT(submit_us_ + pipeline_us_);   // Shorter than a poll interval
+        output_reported_ = true;
+    }
+    if (duration_us_ == 0) return;
+    uint32_t stretch = last_playing_us_ - submit_us_;
+    if (stretch > duration_us_ + UNDERRUN_SLACK_US) {
+        uint32_t gap = stretch - duration_us_;
+        stats_.underruns++;
+        stats_.underrun_us += gap;
+        if (gap > stats_.max_underrun_us) stats_.max_underrun_us = gap;
+        AUDIO_UNDERRUN(gap);
+    }
+}
+
+void SpeakerMonitor::stop() {
+    active_ = false;
+}
+
+static uint32_t le32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint32_t SpeakerMonitor::wavDurationUs(const uint8_t* wav, size_t len) {
+    if (!wav || len < 12 || memcmp(wav, "RIFF", 4) != 0 || memcmp(wav + 8, "WAVE", 4) != 0) {
+        return 0;
+    }
+
+    uint32_t byte_rate = 0;
+    size_t offset = 12;
+    while (offset + 8 <= len) {
+        const uint8_t* chunk = wav + offset;
+        uint32_t size = le32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16 && offset + 8 + 16 <= len) {
+            byte_rate = le32(chunk + 8 + 8);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (byte_rate == 0) return 0;
+            // Clip may be shorter than the header claims (truncated buffer)
+            uint64_t bytes = size;
+            if (bytes > len - offset - 8) bytes = len - offset - 8;
+            return static_cast<uint32_t>(bytes * 1000000ULL / byte_rate);
+        }
+        offset += 8 + size + (size & 1);
+    }
+    return 0;
+}
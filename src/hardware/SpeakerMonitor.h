@@ -0,0 +1,81 @@
+#ifndef SPEAKER_MONITOR_H
+#define SPEAKER_MONITOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Output timing of a speaker sink: first sample and underruns
+ *
+ * The speaker mixer (M5.Speaker task) writes into a DMA queue that the
+ * I2S peripheral drains at the sample rate. Neither the DAC nor the DMA
+ * reports when a clip is audible, so the monitor works from what a sink
+ * can observe - submit time, DMA queue depth, clip duration and the
+ * channel's playing flag:
+ * - First sample (estimate): submit + DMA queue depth (what is ahead of
+ *   the clip), reported once the mixer has picked the clip up. Neither
+ *   the poll nor an I2S event tells when the DAC reached the clip, so
+ *   AudioLatency keeps this segment out of its measured total
+ * - Underrun: the mixer stays ahead of the DAC by the queue depth, so a
+ *   healthy clip stops "playing" at submit + duration. A clip still seen
+ *   playing later than that (+ UNDERRUN_SLACK_US) was stretched by a
+ *   starved mixer: the DMA ran dry for that long
+ *
+ * The stretch is measured against the last poll that still saw the clip
+ * playing, so a late poll (stalled UI loop) never counts as an underrun;
+ * gaps shorter than the poll interval may be missed.
+ *
+ * Usage (inside a sink):
+ *   monitor_.start(micros(), pipeline_us, SpeakerMonitor::wavDurationUs(wav, len));
+ *   monitor_.poll(micros(), playing);     // From ISpeakerSink::poll()
+ */
+class SpeakerMonitor {
+public:
+    static constexpr uint32_t UNDERRUN_SLACK_US = 20000;   // Mixer task scheduling jitter
+
+    struct Stats {
+        uint32_t clips;
+        uint32_t underruns;
+        uint32_t underrun_us;
+        uint32_t max_underrun_us;
+    };
+
+    SpeakerMonitor();
+
+    /**
+     * A clip was submitted
+     * @param pipeline_us Audio already queued ahead of it (DMA depth)
+     * @param duration_us Clip length (0 = unknown: no underrun check)
+     */
+    void start(uint32_t submit_us, uint32_t pipeline_us, uint32_t duration_us);
+
+    /**
+     * Observe the channel; reports AUDIO_OUTPUT / AUDIO_UNDERRUN
+     */
+    void poll(uint32_t now_us, bool playing);
+
+    /**
+     * Clip stopped on purpose (no underrun check)
+     */
+    void stop();
+
+    bool isActive() const { return active_; }
+    Stats getStats() const { return stats_; }
+
+    /**
+     * Length of a PCM WAV clip from its fmt/data chunks
+     * @return 0 if the header cannot be parsed
+     */
+    static uint32_t wavDurationUs(const uint8_t* wav, size_t len);
+
+private:
+    bool active_;
+    bool output_reported_;
+    uint32_t submit_us_;
+    uint32_t pipeline_us_;
+    uint32_t duration_us_;
+    uint32_t last_playing_us_;
+    Stats stats_;
+};
+
+#endif // SPEAKER_MONITOR_H
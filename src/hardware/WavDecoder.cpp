@@ -0,0 +1,478 @@
+#include "WavDecoder.h"
+#include <Arduino.h>
+#include <math.h>
+#include <new>
+#include <string.h>
+
+static constexpr uint32_t ONE = 1u << 16;       // Q16 unit (one input sample)
+static constexpr int COEF_SHIFT = 14;           // Q14 coefficients
+
+static inline uint16_t le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline void put16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static inline void put32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (v >> (8 * i)) & 0xFF;
+    }
+}
+
+WavDecoder::WavDecoder(uint32_t output_rate)
+    : output_rate_(output_rate) {
+    reset();
+}
+
+void WavDecoder::reset() {
+    state_ = State::RIFF_HEADER;
+    error_ = nullptr;
+    header_len_ = 0;
+    header_need_ = 12;
+    skip_ = 0;
+    data_left_ = 0;
+    data_unbounded_ = false;
+    has_format_ = false;
+    memset(&format_, 0, sizeof(format_));
+    frame_len_ = 0;
+    pass_through_ = false;
+    taps_ = 0;
+    step_ = ONE;
+    pos_ = 0;
+    max_out_per_in_ = 1;
+    flush_left_ = 0;
+    memset(history_, 0, sizeof(history_));
+    head_ = 0;
+}
+
+// ============================================================================
+// RIFF Parsing
+// ============================================================================
+
+size_t WavDecoder::decode(const uint8_t* in, size_t len, size_t* consumed,
+                          int16_t* out, size_t out_max) {
+    size_t used = 0;
+    size_t produced = 0;
+
+    while (used < len && state_ != State::DONE && state_ != State::ERROR) {
+        if (state_ == State::DATA) {
+            size_t n = 0;
+            produced += decodeFrames(in + used, len - used, &n, out + produced, out_max - produced);
+            used += n;
+            if (state_ == State::DATA) break;   // Output full (or input ran out)
+            continue;
+        }
+
+        if (state_ == State::SKIP) {
+            size_t n = len - used < skip_ ? len - used : skip_;
+            skip_ -= n;
+            used += n;
+            if (skip_ == 0) expect(State::CHUNK_HEADER, 8);
+            continue;
+        }
+
+        // Header states: collect header_need_ bytes, then parse
+        size_t n = header_need_ - header_len_;
+        if (n > len - used) n = len - used;
+        memcpy(header_ + header_len_, in + used, n);
+        header_len_ += n;
+        used += n;
+        if (header_len_ == header_need_) {
+            parseHeader();
+        }
+    }
+
+    if (consumed) *consumed = used;
+    return produced;
+}
+
+void WavDecoder::expect(State state, size_t bytes) {
+    state_ = state;
+    header_len_ = 0;
+    header_need_ = bytes;
+}
+
+void WavDecoder::fail(const char* error) {
+    state_ = State::ERROR;
+    error_ = error;
+}
+
+void WavDecoder::parseHeader() {
+    switch (state_) {
+        case State::RIFF_HEADER:
+            if (memcmp(header_, "RIFF", 4) != 0 || memcmp(header_ + 8, "WAVE", 4) != 0) {
+                fail("not a RIFF/WAVE file");
+                return;
+            }
+            expect(State::CHUNK_HEADER, 8);
+            return;
+
+        case State::CHUNK_HEADER: {
+            uint32_t size = le32(header_ + 4);
+            if (memcmp(header_, "fmt ", 4) == 0) {
+                if (size < 16) {
+                    fail("fmt chunk too short");
+                    return;
+                }
+                size_t body = size < sizeof(header_) ? size : sizeof(header_);
+                skip_ = (size - body) + (size & 1);
+                expect(State::FORMAT, body);
+            } else if (memcmp(header_, "data", 4) == 0) {
+                if (!has_format_) {
+                    fail("data chunk before fmt");
+                    return;
+                }
+                data_unbounded_ = (size == 0 || size == 0xFFFFFFFF);   // Streamed writers
+                data_left_ = size;
+                format_.data_bytes = data_unbounded_ ? 0 : size;
+                frame_len_ = 0;
+                state_ = State::DATA;
+            } else {
+                skip_ = size + (size & 1);   // LIST, fact, cue, ... (word aligned)
+                if (skip_ > 0) {
+                    state_ = State::SKIP;
+                } else {
+                    expect(State::CHUNK_HEADER, 8);
+                }
+            }
+            return;
+        }
+
+        case State::FORMAT:
+            if (!applyFormat(header_need_)) return;
+            if (skip_ > 0) {
+                state_ = State::SKIP;
+            } else {
+                expect(State::CHUNK_HEADER, 8);
+            }
+            return;
+
+        default:
+            return;
+    }
+}
+
+bool WavDecoder::applyFormat(uint32_t fmt_size) {
+    uint16_t tag = le16(header_);
+    Format format = {};
+    format.channels = le16(header_ + 2);
+    format.sample_rate = le32(header_ + 4);
+    format.block_align = le16(header_ + 12);
+    format.bits = le16(header_ + 14);
+
+    if (tag == FORMAT_EXTENSIBLE) {
+        if (fmt_size < 40) {
+            fail("truncated WAVE_FORMAT_EXTENSIBLE");
+            return false;
+        }
+        tag = le16(header_ + 24);   // First two bytes of the sub-format GUID
+        uint16_t valid_bits = le16(header_ + 18);
+        if (valid_bits > 0 && valid_bits <= format.bits) format.bits = valid_bits;
+    }
+    format.tag = tag;
+
+    if (tag != FORMAT_PCM && tag != FORMAT_FLOAT) {
+        fail("compressed WAV format");
+        return false;
+    }
+    if (format.channels == 0 || format.channels > MAX_CHANNELS) {
+        fail("unsupported channel count");
+        return false;
+    }
+    if (format.sample_rate < MIN_RATE || format.sample_rate > MAX_RATE) {
+        fail("unsupported sample rate");
+        return false;
+    }
+    uint16_t container = format.block_align / format.channels;
+    if (format.block_align % format.channels != 0 || container == 0 || container > 4 ||
+        format.bits == 0 || format.bits > container * 8 ||
+        (tag == FORMAT_FLOAT && container != 4)) {
+        fail("unsupported sample size");
+        return false;
+    }
+
+    format_ = format;
+    has_format_ = true;
+
+    pass_through_ = (format_.sample_rate == output_rate_);
+    step_ = static_cast<uint32_t>((static_cast<uint64_t>(format_.sample_rate) << 16) / output_rate_);
+    max_out_per_in_ = static_cast<uint8_t>((ONE + step_ - 1) / step_ + 1);
+    pos_ = 0;
+    head_ = 0;
+    memset(history_, 0, sizeof(history_));
+    if (pass_through_) {
+        taps_ = 0;
+        max_out_per_in_ = 1;
+    } else {
+        buildFilter();
+    }
+    flush_left_ = taps_ / 2;
+    return true;
+}
+
+// ============================================================================
+// Resampler
+// ============================================================================
+
+void WavDecoder::buildFilter() {
+    // Downsampling needs more taps for the same transition band in output terms
+    float ratio = static_cast<float>(format_.sample_rate) / output_rate_;
+    uint32_t taps = static_cast<uint32_t>(ceilf(TAPS_PER_RATIO * (ratio > 1.0f ? ratio : 1.0f)));
+    taps = (taps + 1) & ~1u;
+    taps_ = static_cast<uint16_t>(taps > MAX_TAPS ? MAX_TAPS : taps);
+
+    // Cutoff in cycles per input sample × 2 (1.0 = input Nyquist)
+    float cutoff = CUTOFF * (ratio > 1.0f ? 1.0f / ratio : 1.0f);
+    float half = taps_ / 2.0f;
+
+    for (uint16_t p = 0; p < PHASES; p++) {
+        // Phase p: output lies p/PHASES past the previous input sample
+        float frac = static_cast<float>(p) / PHASES;
+        float taps_f[MAX_TAPS];
+        float sum = 0.0f;
+        for (uint16_t k = 0; k < taps_; k++) {
+            float d = k - half + frac;   // Distance from input x[n-k], in input samples
+            float x = static_cast<float>(M_PI) * cutoff * d;
+            float sinc = fabsf(x) < 1e-6f ? 1.0f : sinf(x) / x;
+            float w = d / half;          // Blackman window over ±half
+            float window = 0.42f + 0.5f * cosf(static_cast<float>(M_PI) * w) +
+                           0.08f * cosf(2.0f * static_cast<float>(M_PI) * w);
+            taps_f[k] = cutoff * sinc * window;
+            sum += taps_f[k];
+        }
+
+        // Q14, normalized per phase for unity DC gain; rounding error on the peak tap
+        int16_t* h = coef_ + p * taps_;
+        int32_t total = 0;
+        uint16_t peak = 0;
+        for (uint16_t k = 0; k < taps_; k++) {
+            h[k] = static_cast<int16_t>(lroundf(taps_f[k] / sum * (1 << COEF_SHIFT)));
+            total += h[k];
+            if (h[k] > h[peak]) peak = k;
+        }
+        h[peak] = static_cast<int16_t>(h[peak] + ((1 << COEF_SHIFT) - total));
+    }
+}
+
+size_t WavDecoder::pushSample(int16_t sample, int16_t* out) {
+    if (pass_through_) {
+        out[0] = sample;
+        return 1;
+    }
+
+    head_ = head_ == 0 ? taps_ - 1 : head_ - 1;
+    history_[head_] = sample;
+    history_[head_ + taps_] = sample;
+    const int16_t* x = history_ + head_;   // x[k] = input n-k, contiguous
+
+    size_t n = 0;
+    while (pos_ < ONE) {
+        const int16_t* h = coef_ + (pos_ >> (16 - PHASE_BITS)) * taps_;
+        int32_t acc = 1 << (COEF_SHIFT - 1);
+        for (uint16_t k = 0; k < taps_; k++) {
+            acc += static_cast<int32_t>(h[k]) * x[k];
+        }
+        acc >>= COEF_SHIFT;
+        if (acc > 32767) acc = 32767;
+        if (acc < -32768) acc = -32768;
+        out[n++] = static_cast<int16_t>(acc);
+        pos_ += step_;
+    }
+    pos_ -= ONE;
+    return n;
+}
+
+int16_t WavDecoder::frameToMono(const uint8_t* frame) const {
+    uint16_t container = format_.block_align / format_.channels;
+    int32_t sum = 0;
+    for (uint16_t c = 0; c < format_.channels; c++) {
+        const uint8_t* p = frame + c * container;
+        int32_t value;
+        switch (container) {
+            case 1:
+                value = (static_cast<int32_t>(p[0]) - 128) << 8;   // 8-bit is unsigned
+                break;
+            case 2:
+                value = static_cast<int16_t>(le16(p));
+                break;
+            case 3:
+                value = static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) |
+                                             (static_cast<uint32_t>(p[1]) << 16) |
+                                             (static_cast<uint32_t>(p[2]) << 24)) >> 16;
+                break;
+            default:
+                if (format_.tag == FORMAT_FLOAT) {
+                    float f;
+                    memcpy(&f, p, sizeof(f));
+                    if (!(f > -1.0f)) f = -1.0f;   // Also catches NaN
+                    if (f > 1.0f) f = 1.0f;
+                    value = static_cast<int32_t>(f * 32767.0f);
+                } else {
+                    value = static_cast<int32_t>(le32(p)) >> 16;
+                }
+                break;
+        }
+        sum += value;
+    }
+    return static_cast<int16_t>(sum / format_.channels);
+}
+
+size_t WavDecoder::decodeFrames(const uint8_t* in, size_t len, size_t* consumed,
+                                int16_t* out, size_t out_max) {
+    const size_t frame_bytes = format_.block_align;
+    size_t used = 0;
+    size_t produced = 0;
+
+    while (used < len && (data_unbounded_ || data_left_ > 0)) {
+        if (out_max - produced < max_out_per_in_) break;
+
+        size_t n = frame_bytes - frame_len_;
+        size_t available = len - used;
+        if (!data_unbounded_ && available > data_left_) available = data_left_;
+        if (n > available) n = available;
+
+        const uint8_t* frame = nullptr;
+        if (frame_len_ == 0 && n == frame_bytes) {
+            frame = in + used;   // Whole frame in the input: no copy
+        } else {
+            memcpy(frame_ + frame_len_, in + used, n);
+            frame_len_ += n;
+            if (frame_len_ == frame_bytes) frame = frame_;
+        }
+        used += n;
+        if (!data_unbounded_) data_left_ -= n;
+
+        if (frame) {
+            frame_len_ = 0;
+            produced += pushSample(frameToMono(frame), out + produced);
+        }
+    }
+
+    if (!data_unbounded_ && data_left_ == 0) {
+        state_ = State::DONE;   // Trailing chunks (LIST after data) are ignored
+    }
+    *consumed = used;
+    return produced;
+}
+
+size_t WavDecoder::flush(int16_t* out, size_t out_max) {
+    if (!has_format_ || state_ == State::ERROR) return 0;
+
+    size_t produced = 0;
+    while (flush_left_ > 0 && out_max - produced >= max_out_per_in_) {
+        produced += pushSample(0, out + produced);
+        flush_left_--;
+    }
+    return produced;
+}
+
+bool WavDecoder::isNative() const {
+    return has_format_ && pass_through_ && format_.channels == 1 &&
+           format_.tag == FORMAT_PCM && format_.block_align == 2 && format_.bits == 16;
+}
+
+size_t WavDecoder::outputSamplesFor(uint32_t data_bytes) const {
+    if (!has_format_) return 0;
+    uint64_t frames = data_bytes / format_.block_align;
+    if (pass_through_) return static_cast<size_t>(frames);
+    return static_cast<size_t>(((frames + taps_ / 2) * output_rate_) / format_.sample_rate + 2);
+}
+
+size_t WavDecoder::estimateOutputSamples() const {
+    return outputSamplesFor(format_.data_bytes);
+}
+
+// ============================================================================
+// Whole-File Conversion
+// ============================================================================
+
+void WavDecoder::writeWavHeader(uint8_t* out, uint32_t samples, uint32_t sample_rate) {
+    uint32_t data_bytes = samples * 2;
+    memcpy(out, "RIFF", 4);
+    put32(out + 4, 36 + data_bytes);
+    memcpy(out + 8, "WAVE", 4);
+    memcpy(out + 12, "fmt ", 4);
+    put32(out + 16, 16);
+    put16(out + 20, FORMAT_PCM);
+    put16(out + 22, 1);                  // Mono
+    put32(out + 24, sample_rate);
+    put32(out + 28, sample_rate * 2);    // Byte rate
+    put16(out + 32, 2);                  // Block align
+    put16(out + 34, 16);
+    memcpy(out + 36, "data", 4);
+    put32(out + 40, data_bytes);
+}
+
+bool WavDecoder::convert(uint8_t* wav, size_t len, uint8_t** out, size_t* out_len) {
+    if (!wav || !out || !out_len) return false;
+
+    WavDecoder* decoder = new (std::nothrow) WavDecoder();
+    if (!decoder) {
+        Serial.println("[WavDecoder] ERROR: out of memory");
+        return false;
+    }
+
+    // Headers only: stops at the start of the data chunk (no output space)
+    size_t offset = 0;
+    decoder->decode(wav, len, &offset, nullptr, 0);
+    if (decoder->getState() != State::DATA) {
+        Serial.printf("[WavDecoder] Unsupported file: %s\n",
+                      decoder->getError() ? decoder->getError() : "no data chunk");
+        delete decoder;
+        return false;
+    }
+
+    const Format& format = decoder->getFormat();
+    if (decoder->isNative()) {
+        *out = wav;   // Already 16 kHz mono 16-bit: playWav() takes it as is
+        *out_len = len;
+        delete decoder;
+        return true;
+    }
+
+    uint32_t data_bytes = format.data_bytes;
+    if (data_bytes == 0 || data_bytes > len - offset) {
+        data_bytes = len - offset;   // Streamed or truncated file
+    }
+    size_t capacity = decoder->outputSamplesFor(data_bytes);
+    uint8_t* buffer = static_cast<uint8_t*>(ps_malloc(WAV_HEADER_BYTES + capacity * sizeof(int16_t)));
+    if (!buffer) {
+        Serial.printf("[WavDecoder] ERROR: %u bytes for decoded audio\n",
+                      (unsigned)(WAV_HEADER_BYTES + capacity * sizeof(int16_t)));
+        delete decoder;
+        return false;
+    }
+
+    // Chunk by chunk, as it would arrive from the card
+    int16_t* samples = reinterpret_cast<int16_t*>(buffer + WAV_HEADER_BYTES);
+    size_t written = 0;
+    const uint8_t* end = wav + offset + data_bytes;
+    const uint8_t* p = wav + offset;
+    while (p < end && decoder->getState() == State::DATA) {
+        size_t chunk = static_cast<size_t>(end - p) < CHUNK_BYTES ? end - p : CHUNK_BYTES;
+        size_t used = 0;
+        written += decoder->decode(p, chunk, &used, samples + written, capacity - written);
+        if (used == 0) break;   // Estimate exceeded: keep what fits
+        p += used;
+    }
+    written += decoder->flush(samples + written, capacity - written);
+
+    Serial.printf("[WavDecoder] %u Hz %u ch %u-bit%s -> %u Hz mono, %u samples (%u taps)\n",
+                  (unsigned)format.sample_rate, format.channels, format.bits,
+                  format.tag == FORMAT_FLOAT ? " float" : "", (unsigned)OUTPUT_RATE,
+                  (unsigned)written, decoder->getTaps());
+    delete decoder;
+
+    writeWavHeader(buffer, written, OUTPUT_RATE);
+    *out = buffer;
+    *out_len = WAV_HEADER_BYTES + written * sizeof(int16_t);
+    return true;
+}
@@ -0,0 +1,162 @@
+#ifndef WAV_DECODER_H
+#define WAV_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Streaming WAV decoder + fixed-point resampler for the Core2 speaker
+ *
+ * The embedded sounds are 16 kHz mono 16-bit PCM. User files dropped on
+ * the SD card are often 44.1/48 kHz, stereo, 8- or 24-bit, and used to go
+ * to M5.Speaker.playWav() as raw bytes. WavDecoder turns any PCM WAV into
+ * the speaker's native format, chunk by chunk:
+ * - RIFF parser as a byte-driven state machine: any chunk split, unknown
+ *   chunks (LIST, fact, cue) skipped with pad bytes, WAVE_FORMAT_EXTENSIBLE
+ * - Integer PCM 8/16/24/32-bit and IEEE float 32-bit, 1-8 channels
+ *   (averaged to mono)
+ * - Polyphase windowed-sinc resampler, Q14 coefficients and int32
+ *   accumulation: PHASES phases × up to MAX_TAPS taps, built once per file
+ *   for its rate ratio (cutoff CUTOFF × the lower Nyquist)
+ * - Bounded CPU: at most MAX_TAPS multiply-adds per output sample, i.e.
+ *   768 per ms of 16 kHz audio, whatever the input rate
+ * - Same rate as the output: samples are passed through untouched
+ *
+ * Memory: ~6.3 KB per instance (coefficient table), no allocation while
+ * decoding. Compressed formats (ADPCM, MP3-in-WAV) are rejected.
+ *
+ * Usage:
+ *   WavDecoder* decoder = new WavDecoder();
+ *   size_t used;
+ *   size_t n = decoder->decode(chunk, chunk_len, &used, out, out_max);
+ *   ...                                      // Feed the unused tail again
+ *   n = decoder->flush(out, out_max);        // Filter tail after the data chunk
+ *
+ *   // Whole file in memory (SD loader): canonical 16 kHz mono WAV in PSRAM
+ *   WavDecoder::convert(raw, raw_len, &wav, &wav_len);
+ */
+class WavDecoder {
+public:
+    static constexpr uint32_t OUTPUT_RATE = 16000;     // Core2 speaker native rate
+    static constexpr uint8_t PHASE_BITS = 6;
+    static constexpr uint16_t PHASES = 1 << PHASE_BITS;
+    static constexpr uint16_t MAX_TAPS = 48;
+    static constexpr uint16_t TAPS_PER_RATIO = 16;     // Taps per phase = 16 × max(1, in/out)
+    static constexpr float CUTOFF = 0.8f;              // Of the lower of the two Nyquists
+    static constexpr uint8_t MAX_CHANNELS = 8;
+    static constexpr uint32_t MIN_RATE = 4000;
+    static constexpr uint32_t MAX_RATE = 192000;
+    static constexpr size_t WAV_HEADER_BYTES = 44;
+    static constexpr size_t CHUNK_BYTES = 4096;        // convert() input step
+
+    enum class State : uint8_t {
+        RIFF_HEADER,
+        CHUNK_HEADER,
+        FORMAT,
+        SKIP,
+        DATA,
+        DONE,
+        ERROR
+    };
+
+    enum FormatTag : uint16_t {
+        FORMAT_PCM = 0x0001,
+        FORMAT_FLOAT = 0x0003,
+        FORMAT_EXTENSIBLE = 0xFFFE
+    };
+
+    struct Format {
+        uint16_t tag;              // FORMAT_PCM or FORMAT_FLOAT (extensible resolved)
+        uint16_t channels;
+        uint32_t sample_rate;
+        uint16_t bits;             // Valid bits per sample
+        uint16_t block_align;      // Bytes per frame (all channels)
+        uint32_t data_bytes;       // data chunk size from the header
+    };
+
+    explicit WavDecoder(uint32_t output_rate = OUTPUT_RATE);
+
+    void reset();
+
+    /**
+     * Decode a chunk of file bytes into mono samples at the output rate
+     * @param consumed Input bytes used; the rest did not fit in out and
+     *                 must be passed again
+     * @return Samples written to out
+     */
+    size_t decode(const uint8_t* in, size_t len, size_t* consumed, int16_t* out, size_t out_max);
+
+    /**
+     * Drain the resampler delay line after the data chunk (taps/2 samples)
+     * @return Samples written to out
+     */
+    size_t flush(int16_t* out, size_t out_max);
+
+    State getState() const { return state_; }
+    bool hasFormat() const { return has_format_; }
+    const Format& getFormat() const { return format_; }
+    const char* getError() const { return error_; }
+    uint16_t getTaps() const { return taps_; }
+
+    /**
+     * Already 16-bit mono at the output rate (file usable as is)
+     */
+    bool isNative() const;
+
+    /**
+     * Output samples for the whole data chunk, including the flushed tail
+     */
+    size_t estimateOutputSamples() const;
+
+    /**
+     * Whole WAV file → canonical 16-bit mono WAV at OUTPUT_RATE
+     * @param out Set to wav itself if it is already native (no copy),
+     *            else a new ps_malloc() buffer owned by the caller
+     * @return false on unsupported/corrupt files or out of memory
+     */
+    static bool convert(uint8_t* wav, size_t len, uint8_t** out, size_t* out_len);
+
+    static void writeWavHeader(uint8_t* out, uint32_t samples, uint32_t sample_rate);
+
+private:
+    void expect(State state, size_t bytes);
+    void parseHeader();
+    bool applyFormat(uint32_t fmt_size);
+    void buildFilter();
+    size_t decodeFrames(const uint8_t* in, size_t len, size_t* consumed, int16_t* out, size_t out_max);
+    int16_t frameToMono(const uint8_t* frame) const;
+    size_t pushSample(int16_t sample, int16_t* out);
+    size_t outputSamplesFor(uint32_t data_bytes) const;
+    void fail(const char* error);
+
+    uint32_t output_rate_;
+    State state_;
+    const char* error_;
+
+    // Header parsing
+    uint8_t header_[40];            // RIFF header / chunk header / fmt body
+    size_t header_len_;
+    size_t header_need_;
+    uint32_t skip_;                 // Bytes left in a skipped chunk (+ pad)
+    uint32_t data_left_;
+    bool data_unbounded_;           // data size 0 / 0xFFFFFFFF: until input ends
+    bool has_format_;
+    Format format_;
+
+    // Partial frame across decode() calls
+    uint8_t frame_[MAX_CHANNELS * 4];
+    size_t frame_len_;
+
+    // Resampler
+    bool pass_through_;
+    uint16_t taps_;
+    uint32_t step_;                 // Input samples per output sample, Q16.16
+    uint32_t pos_;                  // Next output position after the newest input, Q16
+    uint8_t max_out_per_in_;
+    uint16_t flush_left_;           // Zeros still to push through the filter
+    int16_t coef_[PHASES * MAX_TAPS];
+    int16_t history_[2 * MAX_TAPS]; // Mirrored delay line, newest at history_[head_]
+    uint16_t head_;
+};
+
+#endif // WAV_DECODER_H
@@ -6,6 +6,7 @@
 
 #include <M5Unified.h>
 #include <WiFi.h>
+#include <LittleFS.h>
 #include "ui/Renderer.h"
 #include "ui/ScreenManager.h"
 #include "core/Config.h"
@@ -16,14 +17,29 @@
 #include "core/Statistics.h"
 #include "core/SyncPrimitives.h"
 #include "hardware/SDManager.h"
+#include "hardware/SDWorker.h"
+#include "hardware/SoundLibrary.h"
 #include "hardware/ILEDController.h"
 #include "hardware/LEDController.h"
 #include "hardware/IAudioPlayer.h"
 #include "hardware/AudioPlayer.h"
+#include "hardware/M5SpeakerSink.h"
 #include "hardware/IHapticController.h"
 #include "hardware/HapticController.h"
+#include "hardware/PowerManager.h"
+#include "hardware/GyroController.h"
+#include "hardware/PowerTelemetry.h"
+#include "network/HttpServer.h"
+#include "network/Dashboard.h"
+#include "network/SessionUploader.h"
+#include "network/TlsTransport.h"
+#include "network/TrustAnchors.h"
 #include "tasks/UITask.h"
 #include "tasks/NetworkTask.h"
+#include "tasks/HttpTask.h"
+#include "tasks/UploadTask.h"
+#include "utils/StackProfiler.h"
+#include "utils/PlacementBench.h"
 
 // ============================================================================
 // Global Pointers (accessed by FreeRTOS tasks)
@@ -31,6 +47,8 @@
 
 // Hardware components
 SDManager* g_sdManager = nullptr;
+SDWorker* g_sdWorker = nullptr;     // Runtime SD I/O (nullptr if no card)
+SoundLibrary* g_soundLibrary = nullptr;   // SD sound theme clip cache (nullptr if no card)
 
 // Network configuration (loaded from SD card)
 NetworkConfig* g_networkConfig = nullptr;
@@ -50,6 +68,14 @@ Statistics* g_statistics = nullptr;
 Config* g_config = nullptr;
 ILEDController* g_ledController = nullptr;
 IHapticController* g_hapticController = nullptr;
+PowerTelemetry* g_powerTelemetry = nullptr;    // Cached PMIC readings (sampled by UITask)
+IPowerManager* g_powerManager = nullptr;
+IGyroController* g_gyroController = nullptr;   // Wake-on-motion (gestures not polled yet)
+
+// HTTP dashboard (served by httpTask on Core 1, nullptr if disabled)
+HttpServer* g_httpServer = nullptr;
+Dashboard* g_dashboard = nullptr;
+SessionUploader* g_sessionUploader = nullptr;
 
 // FreeRTOS task handles (for monitoring)
 TaskHandle_t g_uiTaskHandle = NULL;
@@ -76,6 +102,7 @@ void backgroundNTPSyncTask(void* parameter) {
 
     if (!g_networkConfig) {
         Serial.println("[Background NTP] Skipping - NetworkConfig not available");
+        StackProfiler::onTaskExit();
         vTaskDelete(NULL);  // Delete this task
         return;
     }
@@ -84,6 +111,7 @@ void backgroundNTPSyncTask(void* parameter) {
     auto wifi_settings = g_networkConfig->getWiFi();
     if (strlen(wifi_settings.ssid) == 0) {
         Serial.println("[Background NTP] ERROR: No WiFi SSID in network.ini");
+        StackProfiler::onTaskExit();
         vTaskDelete(NULL);
         return;
     }
@@ -111,6 +139,7 @@ void backgroundNTPSyncTask(void* parameter) {
     if (WiFi.status() != WL_CONNECTED) {
         Serial.println("[Background NTP] WiFi connection failed");
         WiFi.disconnect(true);
+        StackProfiler::onTaskExit();
         vTaskDelete(NULL);
         return;
     }
@@ -135,6 +164,7 @@ void backgroundNTPSyncTask(void* parameter) {
     Serial.println("[Background NTP] Complete, WiFi disconnected\n");
 
     // Delete this task (runs once only)
+    StackProfiler::onTaskExit();
     vTaskDelete(NULL);
 }
 
@@ -143,6 +173,9 @@ void backgroundNTPSyncTask(void* parameter) {
 // ============================================================================
 
 void setup() {
+    // Motion-check wake from deep sleep with no motion: straight back to sleep
+    PowerManager::resumeSleepIfStill();
+
     // Initialize M5
     auto cfg = M5.config();
     M5.begin(cfg);
@@ -181,6 +214,17 @@ void setup() {
         Serial.println("[WARN] SD card not available - using NVS/FLASH fallbacks");
     }
 
+    // SD worker on Core 1: after setup, no task touches the card directly
+    if (g_sdManager->isMounted()) {
+        g_sdWorker = new SDWorker(*g_sdManager);
+        if (g_sdWorker->start(1)) {
+            Serial.println("[OK] SD worker started on Core 1");
+        } else {
+            Serial.println("[WARN] SD worker not started - SD requests run on flush()");
+        }
+        g_soundLibrary = new SoundLibrary(*g_sdWorker);
+    }
+
     // Initialize network configuration from SD card (MP-73)
     if (g_sdManager->isMounted()) {
         g_networkConfig = new NetworkConfig(*g_sdManager);
@@ -228,8 +272,15 @@ void setup() {
     g_statistics = new Statistics();
     g_ledController = new LEDController();
     g_hapticController = new HapticController(*g_config);
-    g_audioPlayer = new AudioPlayer();
+    g_audioPlayer = new AudioPlayer(*new M5SpeakerSink());
     g_sequence = new PomodoroSequence();
+    g_powerTelemetry = new PowerTelemetry();
+    PowerManager* powerManager = new PowerManager();
+    powerManager->setTelemetry(g_powerTelemetry);
+    // No begin(): its 1 s calibration is only needed for gestures
+    g_gyroController = new GyroController();
+    powerManager->setGyroController(g_gyroController);
+    g_powerManager = powerManager;
     g_stateMachine = new TimerStateMachine(*g_sequence);
 
     // Initialize renderer
@@ -269,7 +320,11 @@ void setup() {
 
     // Initialize audio player (MP-71: SD audio with FLASH fallback)
     AudioPlayer* audioPlayer = static_cast<AudioPlayer*>(g_audioPlayer);
-    if (!audioPlayer->begin(g_sdManager, AudioPlayer::AudioSource::AUTO)) {
+    if (g_soundLibrary) {
+        g_soundLibrary->setTheme(g_config->getUI().sound_theme);
+    }
+    audioPlayer->setSequence(g_sequence);
+    if (!audioPlayer->begin(g_sdManager, g_soundLibrary, AudioPlayer::AudioSource::AUTO)) {
         Serial.println("[ERROR] Failed to initialize audio player");
     } else {
         Serial.println("[OK] Audio player initialized");
@@ -328,13 +383,8 @@ void setup() {
         auto session = g_sequence->getCurrentSession();
         auto pomodoro_settings = g_config->getPomodoro();
 
-        bool should_auto_start = false;
-        if (session.type == PomodoroSequence::SessionType::WORK) {
-            should_auto_start = pomodoro_settings.auto_start_work;
-        } else {
-            // SHORT_BREAK or LONG_BREAK
-            should_auto_start = pomodoro_settings.auto_start_breaks;
-        }
+        bool should_auto_start = pomodoro_settings.shouldAutoStart(
+            session.type == PomodoroSequence::SessionType::WORK);
 
         if (should_auto_start) {
             Serial.printf("[Main] Auto-starting next session: %s\n",
@@ -356,9 +406,10 @@ void setup() {
     // Note: M5Unified BtnA/B/C zones are fixed at y=240-320, cannot be adjusted
     // On-screen labels at y=218-240 are visual indicators only, actual touch zones are below
 
-    // Update initial status
-    uint8_t battery = M5.Power.getBatteryLevel();
-    bool charging = M5.Power.isCharging();
+    // Update initial status (first telemetry sample)
+    g_powerTelemetry->poll(millis());
+    uint8_t battery = g_powerTelemetry->getBatteryLevel();
+    bool charging = g_powerTelemetry->isCharging();
     g_screenManager->updateStatus(battery, charging, false, "IDLE", 10, 45);
 
     Serial.println("\nControls:");
@@ -372,14 +423,23 @@ void setup() {
     Serial.println("  MainScreen <-> PauseScreen (auto-managed by state machine)");
     Serial.println("\n[OK] All screens ready\n");
 
+#if PLACEMENT_BENCH
+    // Hot path cycle counts (profiling build only, before tasks compete for the cache)
+    PlacementBench::run(*g_renderer, g_ledController);
+#endif
+
     // ========================================================================
     // Create FreeRTOS Tasks (Dual-core Architecture)
     // ========================================================================
 
     Serial.println("=== Creating FreeRTOS Tasks ===");
 
+    // Stack profiler: all tasks created through it report measured stack usage
+    StackProfiler::begin();
+    StackProfiler::registerTask(xTaskGetCurrentTaskHandle(), "loopTask", getArduinoLoopTaskStackSize());
+
     // Create UI Task on Core 0 (Protocol CPU)
-    BaseType_t ui_result = xTaskCreatePinnedToCore(
+    BaseType_t ui_result = StackProfiler::createTaskPinnedToCore(
         uiTask,          // Task function
         "ui_task",       // Task name (for debugging)
         8192,            // Stack size (8KB)
@@ -396,7 +456,7 @@ void setup() {
     Serial.println("[OK] UI task created on Core 0 (8KB stack, priority 1)");
 
     // Create Network Task on Core 1 (Application CPU)
-    BaseType_t net_result = xTaskCreatePinnedToCore(
+    BaseType_t net_result = StackProfiler::createTaskPinnedToCore(
         networkTask,           // Task function
         "network_task",        // Task name (for debugging)
         10240,                 // Stack size (10KB for TLS)
@@ -414,7 +474,7 @@ void setup() {
 
     // Create Background NTP Sync Task (one-time, self-deleting)
     if (g_networkConfig) {
-        BaseType_t ntp_result = xTaskCreatePinnedToCore(
+        BaseType_t ntp_result = StackProfiler::createTaskPinnedToCore(
             backgroundNTPSyncTask,  // Task function
             "ntp_sync",            // Task name
             8192,                  // Stack size (8KB)
@@ -431,9 +491,80 @@ void setup() {
         }
     }
 
+    // Create HTTP dashboard task on Core 1 (listens while WiFi is up; opt-in, NVS net_dash)
+    if (g_config->getNetwork().dashboard_enabled) {
+        g_httpServer = new HttpServer();
+        g_dashboard = new Dashboard(*g_stateMachine, *g_sequence, *g_statistics);
+        g_dashboard->registerRoutes(*g_httpServer);
+        g_httpServer->setAccessToken(g_config->getNetwork().dashboard_token);
+        if (g_config->getNetwork().dashboard_token[0] == '\0') {
+            Serial.println("[WARN] No dashboard token (NVS net_dash_tok), /api/* refused");
+        }
+        if (LittleFS.begin(false)) {
+            g_httpServer->setAssets(&LittleFS);   // Page from data/www (uploadfs)
+        } else {
+            Serial.println("[WARN] LittleFS not mounted, dashboard serves JSON only");
+        }
+
+        BaseType_t http_result = StackProfiler::createTaskPinnedToCore(
+            httpTask,              // Task function
+            "http_task",           // Task name
+            6144,                  // Stack size (6KB)
+            g_httpServer,          // Parameter: server with routes
+            1,                     // Priority (same as UI)
+            NULL,                  // No handle needed
+            1                      // Core 1 (APP_CPU - Application CPU)
+        );
+
+        if (http_result == pdPASS) {
+            Serial.println("[OK] HTTP dashboard task created on Core 1 (6KB stack)");
+        } else {
+            Serial.println("[WARN] Failed to create HTTP dashboard task");
+        }
+    }
+
+#if ENABLE_TOGGL || ENABLE_GCAL
+    // Create Toggl / Google Calendar upload task on Core 1 (batched sync windows)
+    if (g_networkConfig && (g_networkConfig->getToggl().enabled || g_networkConfig->getCalendar().enabled)) {
+        UploadQueue* upload_queue = new UploadQueue();
+        upload_queue->begin();
+        ApiClient* toggl_api = new ApiClient(*new TlsTransport(TrustAnchors::TOGGL), SessionUploader::TOGGL_HOST);
+        ApiClient* google_api = new ApiClient(*new TlsTransport(TrustAnchors::GOOGLE), SessionUploader::GOOGLE_HOST);
+        g_sessionUploader = new SessionUploader(*upload_queue, *toggl_api, *google_api);
+#if ENABLE_TOGGL
+        g_sessionUploader->configureToggl(g_networkConfig->getToggl());
+#endif
+#if ENABLE_GCAL
+        g_sessionUploader->configureCalendar(g_networkConfig->getCalendar());
+#endif
+
+        if (g_sessionUploader->isEnabled()) {
+            g_stateMachine->onSessionComplete([](const PomodoroSequence::Session& session, uint32_t elapsed_ms) {
+                g_sessionUploader->enqueue(session, elapsed_ms);
+            });
+
+            BaseType_t upload_result = StackProfiler::createTaskPinnedToCore(
+                uploadTask,            // Task function
+                "upload_task",         // Task name
+                8192,                  // Stack size (8KB, TLS handshake)
+                g_sessionUploader,     // Parameter: configured uploader
+                1,                     // Priority (same as UI)
+                NULL,                  // No handle needed
+                1                      // Core 1 (APP_CPU - Application CPU)
+            );
+
+            if (upload_result == pdPASS) {
+                Serial.println("[OK] Session upload task created on Core 1 (8KB stack)");
+            } else {
+                Serial.println("[WARN] Failed to create session upload task");
+            }
+        }
+    }
+#endif
+
     Serial.println("\n=== Multi-core Architecture Active ===");
     Serial.println("Core 0: UI, input, state machine, audio, LEDs");
-    Serial.println("Core 1: Network (WiFi, MQTT, NTP) - skeleton in Phase 2");
+    Serial.println("Core 1: Network (WiFi, MQTT, NTP) - skeleton in Phase 2, HTTP dashboard, Toggl/GCal upload");
     Serial.println("======================================\n");
 }
 
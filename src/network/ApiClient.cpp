@@ -0,0 +1,205 @@
+#include "ApiClient.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+ApiClient::ApiClient(ITransport& transport, const char* host, uint16_t port)
+    : transport_(transport),
+      host_(host),
+      port_(port),
+      open_(false),
+      stats_{},
+      rx_pos_(0),
+      rx_len_(0) {
+}
+
+int ApiClient::request(const char* method, const char* path, const char* headers,
+                       const char* body, size_t body_len, BodySink sink) {
+    bool stale = false;
+    int status = attempt(method, path, headers, body, body_len, sink, stale);
+    if (status < 0 && stale) {
+        // Kept-alive connection closed by the server while idle: once more, fresh
+        status = attempt(method, path, headers, body, body_len, sink, stale);
+    }
+    if (status < 0) {
+        stats_.failures++;
+        Serial.printf("[ApiClient] ERROR: %s %s%s failed\n", method, host_, path);
+    }
+    return status;
+}
+
+void ApiClient::close() {
+    if (open_) {
+        transport_.stop();
+        open_ = false;
+    }
+}
+
+// ============================================================================
+// Request
+// ============================================================================
+
+bool ApiClient::ensureConnected() {
+    if (open_ && transport_.connected()) return true;
+    close();
+    if (!transport_.connect(host_, port_)) return false;
+    open_ = true;
+    stats_.connects++;
+    return true;
+}
+
+bool ApiClient::send(const char* data, size_t len) {
+    size_t written = transport_.write(reinterpret_cast<const uint8_t*>(data), len);
+    stats_.bytes_sent += written;
+    return written == len;
+}
+
+int ApiClient::attempt(const char* method, const char* path, const char* headers,
+                       const char* body, size_t body_len, const BodySink& sink, bool& stale) {
+    bool reused = open_ && transport_.connected();
+    stale = false;
+    if (!ensureConnected()) return -1;
+
+    int head_len = snprintf(head_, sizeof(head_),
+                            "%s %s HTTP/1.1\r\n"
+                            "Host: %s\r\n"
+                            "Connection: keep-alive\r\n"
+                            "Content-Length: %u\r\n"
+                            "%s\r\n",
+                            method, path, host_, (unsigned)body_len, headers ? headers : "");
+    if (head_len <= 0 || static_cast<size_t>(head_len) >= sizeof(head_)) {
+        Serial.printf("[ApiClient] ERROR: Request head for %s too long\n", path);
+        return -1;
+    }
+
+    rx_pos_ = 0;
+    rx_len_ = 0;
+    uint64_t received_before = stats_.bytes_received;
+
+    if (!send(head_, head_len) || (body_len > 0 && !send(body, body_len)) || !readLine()) {
+        stale = reused && stats_.bytes_received == received_before;
+        close();
+        return -1;
+    }
+
+    int status = 0;
+    if (sscanf(line_, "HTTP/1.%*d %d", &status) != 1) {
+        close();
+        return -1;
+    }
+
+    long content_length = -1;
+    bool chunked = false;
+    bool close_after = false;
+    while (true) {
+        if (!readLine()) {
+            close();
+            return -1;
+        }
+        if (line_[0] == '\0') break;
+        if (strncasecmp(line_, "Content-Length:", 15) == 0) {
+            content_length = strtol(line_ + 15, nullptr, 10);
+        } else if (strncasecmp(line_, "Transfer-Encoding:", 18) == 0) {
+            chunked = strstr(line_ + 18, "chunked") != nullptr;
+        } else if (strncasecmp(line_, "Connection:", 11) == 0) {
+            close_after = strstr(line_ + 11, "close") != nullptr;
+        }
+    }
+
+    bool body_ok;
+    if (strcmp(method, "HEAD") == 0 || status == 204 || status == 304) {
+        body_ok = true;
+    } else if (chunked) {
+        body_ok = readChunked(sink);
+    } else if (content_length >= 0) {
+        body_ok = readBody(static_cast<size_t>(content_length), sink);
+    } else {
+        body_ok = readUntilClose(sink);
+        close_after = true;
+    }
+
+    if (!body_ok) {
+        close();
+        return -1;
+    }
+    if (close_after) close();
+
+    stats_.requests++;
+    if (reused) stats_.reused++;
+    return status;
+}
+
+// ============================================================================
+// Response
+// ============================================================================
+
+int ApiClient::readByte() {
+    if (rx_pos_ == rx_len_) {
+        int n = transport_.read(rx_, sizeof(rx_), RESPONSE_TIMEOUT_MS);
+        if (n <= 0) return -1;
+        rx_pos_ = 0;
+        rx_len_ = static_cast<size_t>(n);
+        stats_.bytes_received += n;
+    }
+    return rx_[rx_pos_++];
+}
+
+// One line without CR/LF into line_ (longer lines are truncated)
+bool ApiClient::readLine() {
+    size_t len = 0;
+    while (true) {
+        int c = readByte();
+        if (c < 0) return false;
+        if (c == '\n') break;
+        if (c != '\r' && len < sizeof(line_) - 1) line_[len++] = static_cast<char>(c);
+    }
+    line_[len] = '\0';
+    return true;
+}
+
+bool ApiClient::readBody(size_t length, const BodySink& sink) {
+    while (length > 0) {
+        if (rx_pos_ == rx_len_) {
+            int c = readByte();   // Refill
+            if (c < 0) return false;
+            rx_pos_--;
+        }
+        size_t n = rx_len_ - rx_pos_;
+        if (n > length) n = length;
+        if (sink) sink(reinterpret_cast<const char*>(rx_ + rx_pos_), n);
+        rx_pos_ += n;
+        length -= n;
+    }
+    return true;
+}
+
+bool ApiClient::readChunked(const BodySink& sink) {
+    while (true) {
+        if (!readLine()) return false;
+        size_t size = strtoul(line_, nullptr, 16);
+        if (size == 0) break;
+        if (!readBody(size, sink) || !readLine()) return false;
+    }
+    // Trailer, up to the empty line
+    do {
+        if (!readLine()) return false;
+    } while (line_[0] != '\0');
+    return true;
+}
+
+bool ApiClient::readUntilClose(const BodySink& sink) {
+    while (true) {
+        if (rx_pos_ < rx_len_) {
+            if (sink) sink(reinterpret_cast<const char*>(rx_ + rx_pos_), rx_len_ - rx_pos_);
+            rx_pos_ = rx_len_;
+        }
+        int n = transport_.read(rx_, sizeof(rx_), RESPONSE_TIMEOUT_MS);
+        if (n < 0) return true;    // Closed: end of body
+        if (n == 0) return false;  // Timeout
+        rx_pos_ = 0;
+        rx_len_ = static_cast<size_t>(n);
+        stats_.bytes_received += n;
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef API_CLIENT_H
+#define API_CLIENT_H
+
+#include "ITransport.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+
+/**
+ * HTTP/1.1 client for one API host over a persistent connection
+ *
+ * The connection is opened on the first request and kept alive for the
+ * following ones (the session uploader sends a whole sync window over
+ * it), until close(), a "Connection: close" response or an error. A
+ * request on a kept-alive connection that the server has meanwhile closed
+ * is sent again once on a fresh connection.
+ *
+ * Responses: Content-Length, chunked or until close; the body is handed
+ * to the sink piece by piece and never buffered whole.
+ *
+ * Usage:
+ *   ApiClient api(transport, "api.track.toggl.com");
+ *   int status = api.request("POST", "/api/v9/...", "Content-Type: application/json\r\n",
+ *                            body, strlen(body));
+ *   api.close();   // End of the sync window
+ */
+class ApiClient {
+public:
+    static constexpr size_t HEAD_MAX = 1024;          // Request line + headers
+    static constexpr size_t LINE_MAX = 256;           // Response header line
+    static constexpr uint32_t RESPONSE_TIMEOUT_MS = 10000;
+
+    using BodySink = std::function<void(const char* data, size_t len)>;
+
+    struct Stats {
+        uint32_t connects;       // Connections opened (TLS handshakes on the device)
+        uint32_t requests;       // Requests answered
+        uint32_t failures;       // Transport errors / malformed responses
+        uint32_t reused;         // Requests on a kept-alive connection
+        uint64_t bytes_sent;
+        uint64_t bytes_received;
+    };
+
+    ApiClient(ITransport& transport, const char* host, uint16_t port = 443);
+
+    /**
+     * Send a request and read the response
+     * @param headers Extra header lines, each ending in "\r\n" (nullptr = none)
+     * @param sink Receives the response body (nullptr = discard)
+     * @return HTTP status, -1 on transport error
+     */
+    int request(const char* method, const char* path, const char* headers,
+                const char* body, size_t body_len, BodySink sink = nullptr);
+
+    void close();
+    bool isConnected() const { return open_; }
+
+    const char* getHost() const { return host_; }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    ITransport& transport_;
+    const char* host_;
+    uint16_t port_;
+    bool open_;
+    Stats stats_;
+
+    char head_[HEAD_MAX];
+    char line_[LINE_MAX];
+    uint8_t rx_[512];
+    size_t rx_pos_;
+    size_t rx_len_;
+
+    bool ensureConnected();
+    bool send(const char* data, size_t len);
+    int attempt(const char* method, const char* path, const char* headers,
+                const char* body, size_t body_len, const BodySink& sink, bool& stale);
+
+    int readByte();
+    bool readLine();
+    bool readBody(size_t length, const BodySink& sink);
+    bool readChunked(const BodySink& sink);
+    bool readUntilClose(const BodySink& sink);
+};
+
+#endif // API_CLIENT_H
@@ -0,0 +1,123 @@
+#include "Dashboard.h"
+#include "../utils/StackProfiler.h"
+#include <Arduino.h>
+
+Dashboard::Dashboard(TimerStateMachine& timer, PomodoroSequence& sequence, Statistics& statistics)
+    : timer_(timer),
+      sequence_(sequence),
+      statistics_(statistics) {
+}
+
+void Dashboard::registerRoutes(HttpServer& server) {
+    server.on("/api/timer", "application/json",
+              [this](const HttpServer::Request&, HttpServer::ChunkWriter& out, uint32_t& cursor) {
+                  return writeTimer(out, cursor);
+              });
+    server.on("/api/stats", "application/json",
+              [this](const HttpServer::Request& request, HttpServer::ChunkWriter& out, uint32_t& cursor) {
+                  return writeStats(request, out, cursor);
+              });
+    server.on("/api/tasks", "application/json",
+              [this, &server](const HttpServer::Request&, HttpServer::ChunkWriter& out, uint32_t& cursor) {
+                  return writeTasks(server, out, cursor);
+              });
+}
+
+// Each writer emits one piece per cursor step; a piece that does not fit
+// returns false with the cursor unchanged and is retried in the next chunk
+
+bool Dashboard::writeTimer(HttpServer::ChunkWriter& out, uint32_t& cursor) {
+    PomodoroSequence::Session session = sequence_.getCurrentSession();
+    bool written = out.printf(
+        "{\"state\":\"%s\",\"remaining_ms\":%lu,\"total_ms\":%lu,\"progress\":%u,"
+        "\"session\":{\"type\":\"%s\",\"interval\":%u,\"duration_min\":%u,"
+        "\"work_session\":%u,\"work_sessions\":%u},\"completed_today\":%u,\"uptime_ms\":%lu}",
+        timer_.getStateName(), (unsigned long)timer_.getRemainingMs(),
+        (unsigned long)timer_.getTotalMs(), (unsigned)timer_.getProgressPercent(),
+        sessionTypeName(session.type), (unsigned)session.number, (unsigned)session.duration_min,
+        (unsigned)sequence_.getCurrentWorkSession(), (unsigned)sequence_.getTotalWorkSessions(),
+        (unsigned)sequence_.getCompletedToday(), (unsigned long)millis());
+    if (written) cursor++;
+    return written;
+}
+
+bool Dashboard::writeStats(const HttpServer::Request& request, HttpServer::ChunkWriter& out,
+                           uint32_t& cursor) {
+    long days = constrain(request.paramInt("days", DEFAULT_DAYS), 1L, MAX_DAYS);
+    uint32_t today = statistics_.getToday().date_epoch_days;
+
+    if (cursor == 0) {
+        if (!out.printf("{\"today\":%lu,\"days\":[", (unsigned long)today)) return false;
+        cursor++;
+    }
+
+    // Cursor 1..days: one day each, newest first
+    while (cursor <= static_cast<uint32_t>(days)) {
+        uint32_t age = cursor - 1;
+        Statistics::DayStats day = statistics_.getDate(today - age);
+        if (!out.printf("%s{\"date\":%lu,\"completed\":%u,\"work_min\":%u,\"break_min\":%u,"
+                        "\"interruptions\":%u}",
+                        age == 0 ? "" : ",", (unsigned long)(today - age),
+                        (unsigned)day.completed_sessions, (unsigned)day.work_minutes,
+                        (unsigned)day.break_minutes, (unsigned)day.interruptions)) {
+            return false;
+        }
+        cursor++;
+    }
+
+    if (!out.printf("],\"total_completed\":%u,\"completion_rate\":%.1f}",
+                    (unsigned)statistics_.getTotalCompleted(), statistics_.getCompletionRate())) {
+        return false;
+    }
+    cursor++;
+    return true;
+}
+
+bool Dashboard::writeTasks(const HttpServer& server, HttpServer::ChunkWriter& out, uint32_t& cursor) {
+    if (cursor == 0) {
+        if (!out.printf("{\"uptime_s\":%lu,\"free_heap\":%lu,\"free_psram\":%lu,"
+                        "\"task_count\":%u,\"tasks\":[",
+                        (unsigned long)(millis() / 1000), (unsigned long)ESP.getFreeHeap(),
+                        (unsigned long)ESP.getFreePsram(), (unsigned)uxTaskGetNumberOfTasks())) {
+            return false;
+        }
+        cursor++;
+    }
+
+    // Cursor 1..N: StackProfiler records
+    size_t count = StackProfiler::getRecordCount();
+    while (cursor <= count) {
+        StackProfiler::TaskRecord record;
+        if (StackProfiler::getRecordAt(cursor - 1, record)) {
+            if (!out.printf("%s{\"name\":\"%s\",\"stack\":%lu,\"worst_used\":%lu,"
+                            "\"recommended\":%lu,\"worst_scenario\":\"%s\",\"running\":%s}",
+                            cursor == 1 ? "" : ",", record.name, (unsigned long)record.stack_size,
+                            (unsigned long)record.worst_used,
+                            (unsigned long)StackProfiler::recommendedSize(record),
+                            record.worst_scenario, record.handle ? "true" : "false")) {
+                return false;
+            }
+        }
+        cursor++;
+    }
+
+    HttpServer::Stats http = server.getStats();
+    if (!out.printf("],\"http\":{\"requests\":%u,\"errors\":%u,\"rejected\":%u,\"timeouts\":%u,"
+                    "\"active\":%u,\"peak_active\":%u,\"bytes_sent\":%llu}}",
+                    (unsigned)http.requests, (unsigned)http.errors, (unsigned)http.rejected,
+                    (unsigned)http.timeouts, (unsigned)http.active, (unsigned)http.peak_active,
+                    (unsigned long long)http.bytes_sent)) {
+        return false;
+    }
+    cursor++;
+    return true;
+}
+
+const char* Dashboard::sessionTypeName(PomodoroSequence::SessionType type) {
+    switch (type) {
+        case PomodoroSequence::SessionType::WORK:        return "work";
+        case PomodoroSequence::SessionType::SHORT_BREAK: return "short_break";
+        case PomodoroSequence::SessionType::LONG_BREAK:  return "long_break";
+        default:                                         return "?";
+    }
+}
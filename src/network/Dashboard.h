@@ -0,0 +1,49 @@
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include "HttpServer.h"
+#include "../core/PomodoroSequence.h"
+#include "../core/Statistics.h"
+#include "../core/TimerStateMachine.h"
+
+/**
+ * Dashboard JSON endpoints on the HTTP server
+ *
+ * - /api/timer: timer state, remaining/total time, current interval
+ * - /api/stats?days=N: per-day Statistics history, newest first (N 1-90,
+ *   default 7), one day per piece so long histories stream in chunks
+ * - /api/tasks: task monitor data - uptime, heap/PSRAM, per-task stack
+ *   usage (StackProfiler) and the HTTP server's own counters
+ *
+ * The page itself (data/www/index.html) is a static asset on LittleFS
+ * that polls these endpoints.
+ *
+ * Producers run on the HTTP task: they only use the thread-safe getters
+ * (Statistics and StackProfiler take their own mutex for each read).
+ *
+ * Usage:
+ *   Dashboard dashboard(*g_stateMachine, *g_sequence, *g_statistics);
+ *   dashboard.registerRoutes(server);
+ */
+class Dashboard {
+public:
+    static constexpr long MAX_DAYS = 90;
+    static constexpr long DEFAULT_DAYS = 7;
+
+    Dashboard(TimerStateMachine& timer, PomodoroSequence& sequence, Statistics& statistics);
+
+    void registerRoutes(HttpServer& server);
+
+private:
+    TimerStateMachine& timer_;
+    PomodoroSequence& sequence_;
+    Statistics& statistics_;
+
+    bool writeTimer(HttpServer::ChunkWriter& out, uint32_t& cursor);
+    bool writeStats(const HttpServer::Request& request, HttpServer::ChunkWriter& out, uint32_t& cursor);
+    bool writeTasks(const HttpServer& server, HttpServer::ChunkWriter& out, uint32_t& cursor);
+
+    static const char* sessionTypeName(PomodoroSequence::SessionType type);
+};
+
+#endif // DASHBOARD_H
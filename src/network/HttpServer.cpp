@@ -0,0 +1,548 @@
+#include "HttpServer.h"
+#include <Arduino.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#ifdef NATIVE_BUILD
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#else
+#include <lwip/sockets.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static const char RESPONSE_503[] =
+    "HTTP/1.1 503 Service Unavailable\r\n"
+    "Content-Length: 0\r\n"
+    "Retry-After: 1\r\n"
+    "Connection: close\r\n\r\n";
+
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) >= 0;
+}
+
+// ============================================================================
+// Request / ChunkWriter
+// ============================================================================
+
+bool HttpServer::Request::param(const char* name, char* out, size_t max) const {
+    size_t name_len = strlen(name);
+    const char* p = query;
+    while (*p) {
+        const char* end = strchr(p, '&');
+        size_t len = end ? static_cast<size_t>(end - p) : strlen(p);
+        if (len > name_len && strncmp(p, name, name_len) == 0 && p[name_len] == '=') {
+            size_t value_len = len - name_len - 1;
+            if (value_len >= max) value_len = max - 1;
+            memcpy(out, p + name_len + 1, value_len);
+            out[value_len] = '\0';
+            return true;
+        }
+        if (!end) break;
+        p = end + 1;
+    }
+    return false;
+}
+
+long HttpServer::Request::paramInt(const char* name, long fallback) const {
+    char value[16];
+    if (!param(name, value, sizeof(value))) return fallback;
+    char* end = nullptr;
+    long result = strtol(value, &end, 10);
+    return (end == value || *end != '\0') ? fallback : result;
+}
+
+bool HttpServer::ChunkWriter::print(const char* text) {
+    size_t len = strlen(text);
+    if (len > remaining()) return false;
+    memcpy(buffer_ + length_, text, len);
+    length_ += len;
+    return true;
+}
+
+bool HttpServer::ChunkWriter::printf(const char* format, ...) {
+    // vsnprintf needs room for the terminator; the chunk tail has it
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer_ + length_, remaining() + 1, format, args);
+    va_end(args);
+    if (n < 0 || static_cast<size_t>(n) > remaining()) {
+        return false;   // Did not fit: the next chunk starts with it
+    }
+    length_ += n;
+    return true;
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+HttpServer::HttpServer()
+    : listen_fd_(-1),
+      port_(0),
+      assets_(nullptr),
+      token_(nullptr),
+      route_count_(0),
+      connections_(new Connection[MAX_CLIENTS]),
+      stats_{} {
+    for (size_t i = 0; i < MAX_CLIENTS; i++) {
+        connections_[i].fd = -1;
+        connections_[i].state = ConnState::FREE;
+    }
+}
+
+HttpServer::~HttpServer() {
+    end();
+    delete[] connections_;
+}
+
+bool HttpServer::on(const char* path, const char* content_type, Producer producer) {
+    if (route_count_ >= MAX_ROUTES) {
+        Serial.printf("[HttpServer] ERROR: Route table full, %s not added\n", path);
+        return false;
+    }
+    routes_[route_count_++] = Route{path, content_type, producer};
+    return true;
+}
+
+bool HttpServer::begin(uint16_t port) {
+    if (listen_fd_ >= 0) return true;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        Serial.println("[HttpServer] ERROR: socket() failed");
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(fd, MAX_CLIENTS) < 0 || !setNonBlocking(fd)) {
+        Serial.printf("[HttpServer] ERROR: Cannot listen on port %u\n", port);
+        close(fd);
+        return false;
+    }
+
+    socklen_t addr_len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addr_len);
+    port_ = ntohs(addr.sin_port);
+    listen_fd_ = fd;
+    Serial.printf("[HttpServer] Listening on port %u (%u routes, %u clients max)\n",
+                  port_, (unsigned)route_count_, (unsigned)MAX_CLIENTS);
+    return true;
+}
+
+void HttpServer::end() {
+    for (size_t i = 0; i < MAX_CLIENTS; i++) {
+        if (connections_[i].state != ConnState::FREE) {
+            closeConnection(connections_[i]);
+        }
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        Serial.println("[HttpServer] Stopped");
+    }
+}
+
+// ============================================================================
+// Event loop
+// ============================================================================
+
+void HttpServer::poll(uint32_t timeout_ms) {
+    if (listen_fd_ < 0) {
+        delay(timeout_ms);
+        return;
+    }
+
+    fd_set readable;
+    fd_set writable;
+    FD_ZERO(&readable);
+    FD_ZERO(&writable);
+    FD_SET(listen_fd_, &readable);
+    int max_fd = listen_fd_;
+    for (size_t i = 0; i < MAX_CLIENTS; i++) {
+        Connection& conn = connections_[i];
+        if (conn.state == ConnState::READING) {
+            FD_SET(conn.fd, &readable);
+        } else if (conn.state == ConnState::SENDING) {
+            FD_SET(conn.fd, &writable);
+        } else {
+            continue;
+        }
+        if (conn.fd > max_fd) max_fd = conn.fd;
+    }
+
+    struct timeval tv;
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    int ready = select(max_fd + 1, &readable, &writable, nullptr, &tv);
+    if (ready < 0) {
+        return;   // EINTR / closed socket: next poll rebuilds the sets
+    }
+
+    if (ready > 0 && FD_ISSET(listen_fd_, &readable)) {
+        acceptClients();
+    }
+
+    uint32_t now = millis();
+    for (size_t i = 0; i < MAX_CLIENTS; i++) {
+        Connection& conn = connections_[i];
+        if (conn.state == ConnState::FREE) continue;
+
+        if (ready > 0 && conn.state == ConnState::READING && FD_ISSET(conn.fd, &readable)) {
+            onReadable(conn);
+        } else if (ready > 0 && conn.state == ConnState::SENDING && FD_ISSET(conn.fd, &writable)) {
+            onWritable(conn);
+        } else if (now - conn.last_activity_ms >= IDLE_TIMEOUT_MS) {
+            stats_.timeouts++;
+            closeConnection(conn);
+        }
+    }
+}
+
+void HttpServer::acceptClients() {
+    while (true) {
+        int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) return;   // Backlog empty
+
+        Connection* conn = nullptr;
+        for (size_t i = 0; i < MAX_CLIENTS; i++) {
+            if (connections_[i].state == ConnState::FREE) {
+                conn = &connections_[i];
+                break;
+            }
+        }
+
+        if (!conn || !setNonBlocking(fd)) {
+            // Best effort: a full socket buffer on a fresh connection is unlikely
+            send(fd, RESPONSE_503, sizeof(RESPONSE_503) - 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+            close(fd);
+            stats_.rejected++;
+            continue;
+        }
+
+        conn->fd = fd;
+        conn->state = ConnState::READING;
+        conn->body = Body::NONE;
+        conn->body_done = false;
+        conn->last_activity_ms = millis();
+        conn->request_len = 0;
+        conn->route = nullptr;
+        conn->cursor = 0;
+        conn->out_start = 0;
+        conn->out_end = 0;
+        stats_.active++;
+        if (stats_.active > stats_.peak_active) stats_.peak_active = stats_.active;
+    }
+}
+
+void HttpServer::onReadable(Connection& conn) {
+    size_t space = REQUEST_MAX - 1 - conn.request_len;
+    ssize_t n = recv(conn.fd, conn.request + conn.request_len, space, 0);
+    if (n <= 0) {
+        closeConnection(conn);   // Closed before sending a full request
+        return;
+    }
+    conn.request_len += n;
+    conn.request[conn.request_len] = '\0';
+    conn.last_activity_ms = millis();
+
+    if (strstr(conn.request, "\r\n\r\n") == nullptr) {
+        if (conn.request_len >= REQUEST_MAX - 1) {
+            stats_.requests++;
+            queueError(conn, 431);
+        }
+        return;   // Headers incomplete
+    }
+
+    stats_.requests++;
+    if (!parseRequest(conn)) {
+        queueError(conn, 400);
+        return;
+    }
+    startResponse(conn);
+}
+
+void HttpServer::onWritable(Connection& conn) {
+    if (conn.out_start == conn.out_end && !refill(conn)) {
+        closeConnection(conn);   // Response complete
+        return;
+    }
+
+    size_t pending = conn.out_end - conn.out_start;
+    ssize_t n = send(conn.fd, conn.out + conn.out_start, pending, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n < 0) {
+        closeConnection(conn);   // Client went away
+        return;
+    }
+    conn.out_start += n;
+    stats_.bytes_sent += n;
+    conn.last_activity_ms = millis();
+
+    if (conn.out_start == conn.out_end && conn.body_done) {
+        closeConnection(conn);
+    }
+}
+
+void HttpServer::closeConnection(Connection& conn) {
+    if (conn.fd >= 0) {
+        close(conn.fd);
+    }
+    if (conn.file) {
+        conn.file.close();
+    }
+    conn.fd = -1;
+    conn.state = ConnState::FREE;
+    if (stats_.active > 0) stats_.active--;
+}
+
+// ============================================================================
+// Requests
+// ============================================================================
+
+bool HttpServer::parseRequest(Connection& conn) {
+    // "GET /path?query HTTP/1.1"
+    Request& req = conn.parsed;
+    const char* line = conn.request;
+    const char* space = strchr(line, ' ');
+    if (!space || static_cast<size_t>(space - line) >= sizeof(req.method)) return false;
+    memcpy(req.method, line, space - line);
+    req.method[space - line] = '\0';
+
+    const char* target = space + 1;
+    const char* target_end = strchr(target, ' ');
+    if (!target_end || *target != '/') return false;
+
+    const char* question = static_cast<const char*>(memchr(target, '?', target_end - target));
+    const char* path_end = question ? question : target_end;
+    if (static_cast<size_t>(path_end - target) >= PATH_LEN) return false;
+    memcpy(req.path, target, path_end - target);
+    req.path[path_end - target] = '\0';
+
+    req.query[0] = '\0';
+    if (question) {
+        size_t query_len = target_end - question - 1;
+        if (query_len >= QUERY_LEN) return false;
+        memcpy(req.query, question + 1, query_len);
+        req.query[query_len] = '\0';
+    }
+    return true;
+}
+
+bool HttpServer::isAuthorized(const Connection& conn) const {
+    if (!token_ || *token_ == '\0') return false;
+    static const char HEADER[] = "\r\nAuthorization:";
+    static const char SCHEME[] = "Bearer ";
+
+    // Header names are case-insensitive; headers end at the blank line
+    for (const char* line = strstr(conn.request, "\r\n"); line; line = strstr(line + 2, "\r\n")) {
+        if (strncasecmp(line, HEADER, sizeof(HEADER) - 1) != 0) continue;
+        const char* value = line + sizeof(HEADER) - 1;
+        while (*value == ' ') value++;
+        if (strncasecmp(value, SCHEME, sizeof(SCHEME) - 1) != 0) return false;
+        value += sizeof(SCHEME) - 1;
+
+        // Compare the whole token (no early exit on the first mismatch)
+        const char* end = strstr(value, "\r\n");
+        size_t length = end ? static_cast<size_t>(end - value) : strlen(value);
+        size_t token_length = strlen(token_);
+        uint8_t diff = length != token_length;
+        for (size_t i = 0; i < token_length; i++) {
+            diff |= static_cast<uint8_t>(token_[i] ^ (i < length ? value[i] : 0));
+        }
+        return diff == 0;
+    }
+    return false;
+}
+
+void HttpServer::startResponse(Connection& conn) {
+    const Request& req = conn.parsed;
+    if (strcmp(req.method, "GET") != 0) {
+        queueError(conn, 405);
+        return;
+    }
+
+    if (strncmp(req.path, PROTECTED_PREFIX, strlen(PROTECTED_PREFIX)) == 0 && !isAuthorized(conn)) {
+        stats_.unauthorized++;
+        if (token_ && *token_ != '\0') {
+            queueError(conn, 401, "WWW-Authenticate: Bearer\r\n");
+        } else {
+            queueError(conn, 403);   // No token configured: API stays closed
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < route_count_; i++) {
+        if (strcmp(routes_[i].path, req.path) == 0) {
+            conn.route = &routes_[i];
+            conn.body = Body::ROUTE;
+            stats_.routes++;
+            queueHeaders(conn, 200, routes_[i].content_type,
+                         "Transfer-Encoding: chunked\r\nCache-Control: no-store\r\n", -1);
+            return;
+        }
+    }
+
+    // Asset: no directory traversal out of ASSET_ROOT
+    if (!assets_ || strstr(req.path, "..") != nullptr) {
+        queueError(conn, 404);
+        return;
+    }
+    const char* path = strcmp(req.path, "/") == 0 ? "/index.html" : req.path;
+    bool gzip = false;
+    if (!openAsset(conn, path, gzip)) {
+        queueError(conn, 404);
+        return;
+    }
+    conn.body = Body::FILE;
+    stats_.assets++;
+    queueHeaders(conn, 200, contentTypeFor(path),
+                 gzip ? "Content-Encoding: gzip\r\nCache-Control: max-age=3600\r\n"
+                      : "Cache-Control: max-age=3600\r\n",
+                 static_cast<long>(conn.file.size()));
+}
+
+bool HttpServer::openAsset(Connection& conn, const char* path, bool& gzip) {
+    char full[PATH_LEN + 16];   // ASSET_ROOT + path + ".gz"
+    snprintf(full, sizeof(full), "%s%s.gz", ASSET_ROOT, path);
+    gzip = true;
+    if (!assets_->exists(full)) {
+        full[strlen(full) - 3] = '\0';
+        gzip = false;
+        if (!assets_->exists(full)) return false;
+    }
+    conn.file = assets_->open(full, FILE_READ);
+    if (!conn.file || conn.file.isDirectory()) {
+        conn.file.close();
+        return false;
+    }
+    return true;
+}
+
+void HttpServer::queueHeaders(Connection& conn, int status, const char* content_type,
+                              const char* extra_headers, long content_length) {
+    int n = snprintf(conn.out, OUT_SIZE,
+                     "HTTP/1.1 %d %s\r\n"
+                     "Content-Type: %s\r\n"
+                     "%s"
+                     "Connection: close\r\n",
+                     status, statusText(status), content_type, extra_headers);
+    if (content_length >= 0) {
+        n += snprintf(conn.out + n, OUT_SIZE - n, "Content-Length: %ld\r\n", content_length);
+    }
+    n += snprintf(conn.out + n, OUT_SIZE - n, "\r\n");
+    conn.out_start = 0;
+    conn.out_end = n;
+    conn.state = ConnState::SENDING;
+    conn.last_activity_ms = millis();
+}
+
+void HttpServer::queueError(Connection& conn, int status, const char* extra_headers) {
+    stats_.errors++;
+    conn.body = Body::NONE;
+    conn.body_done = true;
+    queueHeaders(conn, status, "text/plain", extra_headers, 0);
+}
+
+bool HttpServer::refill(Connection& conn) {
+    if (conn.body_done) return false;
+
+    if (conn.body == Body::FILE) {
+        size_t n = conn.file.read(reinterpret_cast<uint8_t*>(conn.out), CHUNK_SIZE);
+        if (n == 0) return false;
+        conn.out_start = 0;
+        conn.out_end = n;
+        conn.body_done = conn.file.available() <= 0;
+        return true;
+    }
+
+    // Route: payload in place, then the chunk framing around it
+    char* payload = conn.out + CHUNK_HEAD;
+    ChunkWriter writer(payload, CHUNK_SIZE);
+    bool done = conn.route->producer(conn.parsed, writer, conn.cursor);
+    size_t len = writer.length();
+    if (len == 0 && !done) {
+        Serial.printf("[HttpServer] ERROR: %s piece larger than a chunk\n", conn.route->path);
+        return false;   // Truncated response: the client sees no final chunk
+    }
+
+    size_t end = CHUNK_HEAD;
+    conn.out_start = CHUNK_HEAD;
+    if (len > 0) {
+        char head[CHUNK_HEAD + 1];
+        int head_len = snprintf(head, sizeof(head), "%x\r\n", static_cast<unsigned>(len));
+        conn.out_start = CHUNK_HEAD - head_len;
+        memcpy(conn.out + conn.out_start, head, head_len);
+        end += len;
+        memcpy(conn.out + end, "\r\n", 2);
+        end += 2;
+        stats_.chunks++;
+    }
+    if (done) {
+        memcpy(conn.out + end, "0\r\n\r\n", 5);
+        end += 5;
+        conn.body_done = true;
+    }
+    conn.out_end = end;
+    return true;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+const char* HttpServer::statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 431: return "Request Header Fields Too Large";
+        case 503: return "Service Unavailable";
+        default:  return "Error";
+    }
+}
+
+const char* HttpServer::contentTypeFor(const char* path) {
+    const char* dot = strrchr(path, '.');
+    if (!dot) return "application/octet-stream";
+    if (strcmp(dot, ".html") == 0) return "text/html; charset=utf-8";
+    if (strcmp(dot, ".css") == 0) return "text/css";
+    if (strcmp(dot, ".js") == 0) return "application/javascript";
+    if (strcmp(dot, ".json") == 0) return "application/json";
+    if (strcmp(dot, ".svg") == 0) return "image/svg+xml";
+    if (strcmp(dot, ".png") == 0) return "image/png";
+    if (strcmp(dot, ".ico") == 0) return "image/x-icon";
+    return "application/octet-stream";
+}
+
+void HttpServer::printStats() const {
+    Serial.printf("\n[HttpServer] port %u: %u requests (%u routes, %u assets), %u errors\n",
+                  port_, (unsigned)stats_.requests, (unsigned)stats_.routes,
+                  (unsigned)stats_.assets, (unsigned)stats_.errors);
+    Serial.printf("[HttpServer] %u unauthorized, %u rejected (pool full), %u timed out, "
+                  "clients %u now / %u peak\n",
+                  (unsigned)stats_.unauthorized, (unsigned)stats_.rejected, (unsigned)stats_.timeouts,
+                  (unsigned)stats_.active, (unsigned)stats_.peak_active);
+    Serial.printf("[HttpServer] %u chunks, %lu KB sent\n",
+                  (unsigned)stats_.chunks, (unsigned long)(stats_.bytes_sent / 1024));
+}
@@ -0,0 +1,219 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <FS.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+
+/**
+ * Minimal HTTP/1.1 server for the on-device dashboard
+ *
+ * Single-threaded, non-blocking BSD sockets (lwIP on the device, POSIX on
+ * the host) multiplexed with select() from one task: poll() waits for
+ * socket activity, accepts clients into a fixed pool and moves each
+ * connection forward by at most one buffer per call, so one slow client
+ * never holds up the others.
+ *
+ * Responses:
+ * - Routes (exact path): a producer fills the connection's fixed chunk
+ *   buffer piece by piece and keeps its position in a cursor; every
+ *   refill goes out as one HTTP chunk (Transfer-Encoding: chunked), so
+ *   documents of any length need no String and no heap
+ * - Static assets: files below ASSET_ROOT on the assets FS (LittleFS),
+ *   read straight into the chunk buffer and sent with Content-Length; a
+ *   precompressed "<file>.gz" is preferred (Content-Encoding: gzip)
+ * - One request per connection (Connection: close)
+ *
+ * Access: paths below PROTECTED_PREFIX (the JSON API) need the shared
+ * secret from setAccessToken() as "Authorization: Bearer <token>" (401
+ * otherwise); without a token they are refused (403). Static assets (the
+ * page itself, no device data) stay public.
+ *
+ * Pool full: the new client gets an immediate 503 and is closed. Clients
+ * idle for IDLE_TIMEOUT_MS (no request, or not reading the response) are
+ * dropped.
+ *
+ * Memory: MAX_CLIENTS connections of REQUEST_MAX + CHUNK_SIZE bytes,
+ * allocated once with the server object; nothing while serving routes.
+ *
+ * Usage:
+ *   server.on("/api/timer", "application/json",
+ *       [](const HttpServer::Request& req, HttpServer::ChunkWriter& out, uint32_t& cursor) {
+ *           return out.printf("{\"state\":\"%s\"}", name);   // true = done
+ *       });
+ *   server.setAssets(&LittleFS);
+ *   server.setAccessToken(config.getNetwork().dashboard_token);
+ *   server.begin(80);
+ *   while (true) server.poll(100);   // HTTP task
+ */
+class HttpServer {
+public:
+    static constexpr size_t MAX_CLIENTS = 4;
+    static constexpr size_t MAX_ROUTES = 8;
+    static constexpr size_t REQUEST_MAX = 512;      // Request line + headers
+    static constexpr size_t CHUNK_SIZE = 1024;      // Payload per chunk / file read
+    static constexpr size_t PATH_LEN = 64;
+    static constexpr size_t QUERY_LEN = 64;
+    static constexpr uint32_t IDLE_TIMEOUT_MS = 5000;
+    static constexpr const char* ASSET_ROOT = "/www";
+    static constexpr const char* PROTECTED_PREFIX = "/api/";
+
+    struct Request {
+        char method[8];
+        char path[PATH_LEN];
+        char query[QUERY_LEN];   // After '?', without it
+
+        /**
+         * Query parameter value ("days=7")
+         * @return false if absent
+         */
+        bool param(const char* name, char* out, size_t max) const;
+        long paramInt(const char* name, long fallback) const;
+    };
+
+    /**
+     * Appends to a chunk buffer; a piece that does not fit is not written
+     */
+    class ChunkWriter {
+    public:
+        ChunkWriter(char* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity), length_(0) {}
+
+        bool print(const char* text);
+        bool printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+        size_t length() const { return length_; }
+        size_t remaining() const { return capacity_ - length_; }
+
+    private:
+        char* buffer_;
+        size_t capacity_;
+        size_t length_;
+    };
+
+    /**
+     * Writes the next pieces of a response
+     * @param cursor Producer position, 0 on the first call
+     * @return true when the document is complete
+     */
+    using Producer = std::function<bool(const Request& request, ChunkWriter& out, uint32_t& cursor)>;
+
+    struct Stats {
+        uint32_t requests;       // Parsed requests
+        uint32_t routes;         // Served by a producer
+        uint32_t assets;         // Served from the assets FS
+        uint32_t errors;         // 4xx/5xx (bad request, not found, ...)
+        uint32_t unauthorized;   // 401/403 on PROTECTED_PREFIX (also in errors)
+        uint32_t rejected;       // 503: pool full
+        uint32_t timeouts;       // Idle clients dropped
+        uint32_t chunks;         // HTTP chunks sent
+        uint64_t bytes_sent;
+        uint8_t active;          // Connections open now
+        uint8_t peak_active;
+    };
+
+    HttpServer();
+    ~HttpServer();
+
+    /**
+     * Register a route (call before begin(); path and content type not copied)
+     */
+    bool on(const char* path, const char* content_type, Producer producer);
+
+    /**
+     * Static assets below ASSET_ROOT (nullptr = routes only)
+     */
+    void setAssets(fs::FS* assets) { assets_ = assets; }
+
+    /**
+     * Shared secret for PROTECTED_PREFIX paths (not copied; nullptr or "" =
+     * refuse them)
+     */
+    void setAccessToken(const char* token) { token_ = token; }
+
+    /**
+     * Listen on all interfaces
+     * @param port 0 = any free port (host tests, see getPort())
+     */
+    bool begin(uint16_t port);
+    void end();
+    bool isListening() const { return listen_fd_ >= 0; }
+    uint16_t getPort() const { return port_; }
+
+    /**
+     * Serve: wait up to timeout_ms for activity, then advance every connection
+     */
+    void poll(uint32_t timeout_ms);
+
+    Stats getStats() const { return stats_; }
+    void printStats() const;
+
+private:
+    enum class ConnState : uint8_t {
+        FREE,
+        READING,     // Waiting for the end of the request headers
+        SENDING,     // Response in progress
+    };
+
+    enum class Body : uint8_t {
+        NONE,        // Headers only (errors)
+        ROUTE,       // Producer, chunked
+        FILE,        // Asset, Content-Length
+    };
+
+    struct Route {
+        const char* path;
+        const char* content_type;
+        Producer producer;
+    };
+
+    // Chunk framing around the payload: "<hex>\r\n" before, "\r\n0\r\n\r\n" after
+    static constexpr size_t CHUNK_HEAD = 8;
+    static constexpr size_t CHUNK_TAIL = 7;
+    static constexpr size_t OUT_SIZE = CHUNK_HEAD + CHUNK_SIZE + CHUNK_TAIL;
+
+    struct Connection {
+        int fd;
+        ConnState state;
+        Body body;
+        bool body_done;          // Last chunk / end of file queued
+        uint32_t last_activity_ms;
+        char request[REQUEST_MAX];
+        size_t request_len;
+        Request parsed;
+        const Route* route;
+        uint32_t cursor;
+        fs::File file;
+        char out[OUT_SIZE];
+        size_t out_start;        // Pending bytes: out[out_start, out_end)
+        size_t out_end;
+    };
+
+    int listen_fd_;
+    uint16_t port_;
+    fs::FS* assets_;
+    const char* token_;
+    Route routes_[MAX_ROUTES];
+    size_t route_count_;
+    Connection* connections_;   // MAX_CLIENTS, allocated once
+    Stats stats_;
+
+    void acceptClients();
+    void onReadable(Connection& conn);
+    void onWritable(Connection& conn);
+    void closeConnection(Connection& conn);
+
+    bool parseRequest(Connection& conn);
+    bool isAuthorized(const Connection& conn) const;
+    void startResponse(Connection& conn);
+    bool openAsset(Connection& conn, const char* path, bool& gzip);
+    void queueHeaders(Connection& conn, int status, const char* content_type,
+                      const char* extra_headers, long content_length);
+    void queueError(Connection& conn, int status, const char* extra_headers = "");
+    bool refill(Connection& conn);
+
+    static const char* statusText(int status);
+    static const char* contentTypeFor(const char* path);
+};
+
+#endif // HTTP_SERVER_H
@@ -0,0 +1,35 @@
+#ifndef ITRANSPORT_H
+#define ITRANSPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Byte stream to an API host (TLS on the device, plain TCP in host tests)
+ *
+ * Implementations:
+ * - TlsTransport: WiFiClientSecure (device)
+ * - LoopbackTransport: POSIX socket to 127.0.0.1 (test/mocks)
+ */
+class ITransport {
+public:
+    virtual ~ITransport() = default;
+
+    virtual bool connect(const char* host, uint16_t port) = 0;
+    virtual bool connected() = 0;
+
+    /**
+     * @return bytes written (less than len = connection broken)
+     */
+    virtual size_t write(const uint8_t* data, size_t len) = 0;
+
+    /**
+     * Read what is available, waiting up to timeout_ms for the first byte
+     * @return bytes read, 0 on timeout, -1 when the peer closed
+     */
+    virtual int read(uint8_t* data, size_t len, uint32_t timeout_ms) = 0;
+
+    virtual void stop() = 0;
+};
+
+#endif // ITRANSPORT_H
@@ -0,0 +1,467 @@
+#include "SessionUploader.h"
+#include "../utils/AllocTracker.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <time.h>
+
+static const char CREATED_WITH[] = "M5 Pomodoro Timer v2";
+static const char BATCH_BOUNDARY[] = "m5pomodoro_batch";
+
+SessionUploader::SessionUploader(UploadQueue& queue, ApiClient& toggl, ApiClient& google)
+    : queue_(queue),
+      toggl_(toggl),
+      google_(google),
+      token_expires_epoch_(0),
+      stats_{},
+      response_len_(0),
+      result_count_(0),
+      part_id_(0) {
+    toggl_auth_[0] = '\0';
+    toggl_tags_[0] = '\0';
+    access_token_[0] = '\0';
+}
+
+void SessionUploader::configureToggl(const NetworkConfig::TogglSettings& settings) {
+    toggl_settings_ = settings;
+    if (settings.enabled && (settings.api_token[0] == '\0' || settings.workspace_id == 0)) {
+        Serial.println("[SessionUploader] WARN: Toggl needs APIToken and WorkspaceID, disabled");
+        toggl_settings_.enabled = false;
+    }
+
+    // Basic auth: "<token>:api_token"
+    char credentials[sizeof(settings.api_token) + 12];
+    int len = snprintf(credentials, sizeof(credentials), "%s:api_token", settings.api_token);
+    strcpy(toggl_auth_, "Basic ");
+    base64(credentials, len, toggl_auth_ + 6, sizeof(toggl_auth_) - 6);
+
+    // Tags: "a, b" -> ["a","b"]
+    size_t out = 0;
+    toggl_tags_[out++] = '[';
+    const char* p = settings.tags;
+    while (*p) {
+        while (*p == ' ' || *p == ',') p++;
+        const char* end = p;
+        while (*end && *end != ',') end++;
+        const char* trim = end;
+        while (trim > p && trim[-1] == ' ') trim--;
+        size_t len_tag = trim - p;
+        if (len_tag > 0 && out + len_tag + 4 < sizeof(toggl_tags_) - 1) {
+            if (out > 1) toggl_tags_[out++] = ',';
+            toggl_tags_[out++] = '"';
+            memcpy(toggl_tags_ + out, p, len_tag);
+            out += len_tag;
+            toggl_tags_[out++] = '"';
+        }
+        p = end;
+    }
+    toggl_tags_[out++] = ']';
+    toggl_tags_[out] = '\0';
+}
+
+void SessionUploader::configureCalendar(const NetworkConfig::CalendarSettings& settings) {
+    calendar_settings_ = settings;
+    if (settings.enabled && (settings.client_id[0] == '\0' || settings.refresh_token[0] == '\0')) {
+        Serial.println("[SessionUploader] WARN: Google Calendar needs ClientID and RefreshToken, disabled");
+        calendar_settings_.enabled = false;
+    }
+    access_token_[0] = '\0';
+    token_expires_epoch_ = 0;
+}
+
+bool SessionUploader::enqueue(const PomodoroSequence::Session& session, uint32_t elapsed_ms) {
+    ALLOC_SCOPE(NETWORK);
+    if (session.type != PomodoroSequence::SessionType::WORK || targets() == 0) return false;
+
+    struct timeval now;
+#ifdef NATIVE_BUILD
+    arduino_shim::gettimeofday(&now, nullptr);   // Virtual wall clock in host tests
+#else
+    gettimeofday(&now, nullptr);
+#endif
+    if (now.tv_sec < static_cast<time_t>(MIN_VALID_EPOCH)) {
+        Serial.println("[SessionUploader] WARN: Clock not set, session not queued");
+        stats_.skipped++;
+        return false;
+    }
+
+    bool queued = queue_.push(static_cast<uint32_t>(now.tv_sec), static_cast<uint16_t>(elapsed_ms / 1000),
+                              static_cast<uint8_t>(session.type), session.number, targets());
+    if (queued) stats_.enqueued++;
+    return queued;
+}
+
+bool SessionUploader::isDue(uint32_t now_epoch) const {
+    return due(UploadQueue::TOGGL, now_epoch) || due(UploadQueue::GCAL, now_epoch);
+}
+
+bool SessionUploader::runWindow(uint32_t now_epoch) {
+    ALLOC_SCOPE(NETWORK);
+    stats_.windows++;
+    size_t count = queue_.snapshot(batch_, UploadQueue::CAPACITY);
+
+    // Targets disabled since the sessions were queued: nothing to upload to
+    uint8_t disabled = static_cast<uint8_t>(~targets()) & (UploadQueue::TOGGL | UploadQueue::GCAL);
+    for (size_t i = 0; i < count; i++) {
+        if (batch_[i].pending & disabled) {
+            queue_.settle(batch_[i].id, disabled, 0);
+            batch_[i].pending &= ~disabled;
+        }
+    }
+
+    bool ok = true;
+    if (due(UploadQueue::TOGGL, now_epoch)) {
+        bool uploaded = uploadToggl(count);
+        finishTarget(UploadQueue::TOGGL, uploaded, now_epoch);
+        ok = ok && uploaded;
+    }
+    if (due(UploadQueue::GCAL, now_epoch)) {
+        bool uploaded = uploadCalendar(count, now_epoch);
+        finishTarget(UploadQueue::GCAL, uploaded, now_epoch);
+        ok = ok && uploaded;
+    }
+
+    // End of the wake window: no idle connections while the radio sleeps
+    toggl_.close();
+    google_.close();
+    queue_.commit();
+
+    Serial.printf("[SessionUploader] Window %lu: %u sessions still queued%s\n",
+                  (unsigned long)stats_.windows, (unsigned)queue_.size(), ok ? "" : " (retry scheduled)");
+    return ok;
+}
+
+void SessionUploader::printStats() const {
+    const ApiClient::Stats& toggl = toggl_.getStats();
+    const ApiClient::Stats& google = google_.getStats();
+    Serial.printf("\n[SessionUploader] %lu windows, %lu sessions queued (%u pending), %lu skipped, %lu dropped\n",
+                  (unsigned long)stats_.windows, (unsigned long)stats_.enqueued, (unsigned)queue_.size(),
+                  (unsigned long)stats_.skipped, (unsigned long)queue_.getDropped());
+    Serial.printf("[SessionUploader] Toggl: %lu uploaded, %lu rejected, %lu requests over %lu connections, %lu failed windows\n",
+                  (unsigned long)stats_.toggl.uploaded, (unsigned long)stats_.toggl.rejected,
+                  (unsigned long)stats_.toggl.requests, (unsigned long)toggl.connects,
+                  (unsigned long)stats_.toggl.failed_windows);
+    Serial.printf("[SessionUploader] GCal: %lu uploaded, %lu rejected, %lu requests over %lu connections, %lu failed windows\n",
+                  (unsigned long)stats_.gcal.uploaded, (unsigned long)stats_.gcal.rejected,
+                  (unsigned long)stats_.gcal.requests, (unsigned long)google.connects,
+                  (unsigned long)stats_.gcal.failed_windows);
+}
+
+// ============================================================================
+// Window
+// ============================================================================
+
+uint8_t SessionUploader::targets() const {
+    uint8_t bits = 0;
+    if (toggl_settings_.enabled) bits |= UploadQueue::TOGGL;
+    if (calendar_settings_.enabled) bits |= UploadQueue::GCAL;
+    return bits;
+}
+
+bool SessionUploader::due(UploadQueue::Target target, uint32_t now_epoch) const {
+    return (targets() & target) &&
+           queue_.pendingFor(target) > 0 &&
+           now_epoch >= queue_.getBackoff(target).retry_at_epoch;
+}
+
+void SessionUploader::finishTarget(UploadQueue::Target target, bool ok, uint32_t now_epoch) {
+    UploadQueue::Backoff backoff = queue_.getBackoff(target);
+    if (ok) {
+        backoff.failures = 0;
+        backoff.retry_at_epoch = 0;
+    } else {
+        if (backoff.failures < 0xFF) backoff.failures++;
+        uint32_t delay_s = BACKOFF_MAX_S;
+        if (backoff.failures <= 16) {
+            delay_s = BACKOFF_BASE_S << (backoff.failures - 1);
+            if (delay_s > BACKOFF_MAX_S) delay_s = BACKOFF_MAX_S;
+        }
+        backoff.retry_at_epoch = now_epoch + delay_s;
+        (target == UploadQueue::TOGGL ? stats_.toggl : stats_.gcal).failed_windows++;
+        Serial.printf("[SessionUploader] %s: retry in %lu s (failure %u)\n",
+                      target == UploadQueue::TOGGL ? "Toggl" : "GCal",
+                      (unsigned long)delay_s, (unsigned)backoff.failures);
+    }
+    queue_.setBackoff(target, backoff);
+}
+
+bool SessionUploader::isRetryable(int status) {
+    return status < 0 || status == 401 || status == 403 || status == 408 ||
+           status == 429 || status >= 500;
+}
+
+// ============================================================================
+// Toggl Track (API v9)
+// ============================================================================
+
+bool SessionUploader::uploadToggl(size_t count) {
+    char path[64];
+    snprintf(path, sizeof(path), "/api/v9/workspaces/%lu/time_entries",
+             (unsigned long)toggl_settings_.workspace_id);
+    char headers[sizeof(toggl_auth_) + 64];
+    snprintf(headers, sizeof(headers), "Authorization: %s\r\nContent-Type: application/json\r\n",
+             toggl_auth_);
+    char project[32] = "";
+    if (toggl_settings_.project_id != 0) {
+        snprintf(project, sizeof(project), "\"project_id\":%lu,", (unsigned long)toggl_settings_.project_id);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const UploadQueue::Entry& entry = batch_[i];
+        if (!(entry.pending & UploadQueue::TOGGL)) continue;
+
+        char start[24];
+        char stop[24];
+        formatTime(entry.end_epoch - entry.duration_s, start, sizeof(start));
+        formatTime(entry.end_epoch, stop, sizeof(stop));
+        int len = snprintf(body_, sizeof(body_),
+                           "{\"created_with\":\"%s\",\"description\":\"Pomodoro #%u\","
+                           "\"workspace_id\":%lu,%s\"start\":\"%s\",\"stop\":\"%s\","
+                           "\"duration\":%u,\"tags\":%s}",
+                           CREATED_WITH, (unsigned)entry.session_number,
+                           (unsigned long)toggl_settings_.workspace_id, project, start, stop,
+                           (unsigned)entry.duration_s, toggl_tags_);
+
+        int status = toggl_.request("POST", path, headers, body_, len);
+        stats_.toggl.requests++;
+        if (status >= 200 && status < 300) {
+            queue_.settle(entry.id, UploadQueue::TOGGL, 0);
+            stats_.toggl.uploaded++;
+        } else if (!isRetryable(status)) {
+            Serial.printf("[SessionUploader] ERROR: Toggl rejected session #%lu (HTTP %d), dropped\n",
+                          (unsigned long)entry.id, status);
+            queue_.settle(entry.id, UploadQueue::TOGGL, 0);
+            stats_.toggl.rejected++;
+        } else {
+            // Auth failures wait for a config fix without using up attempts
+            bool auth = status == 401 || status == 403;
+            if (auth) Serial.println("[SessionUploader] ERROR: Toggl auth failed, check APIToken");
+            queue_.settle(entry.id, 0, auth ? 0 : UploadQueue::TOGGL);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Google Calendar (batch API)
+// ============================================================================
+
+bool SessionUploader::refreshAccessToken(uint32_t now_epoch) {
+    if (access_token_[0] != '\0' && now_epoch + 60 < token_expires_epoch_) return true;
+
+    char client_id[128];
+    char secret[64];
+    char refresh[192];
+    urlEncode(calendar_settings_.client_id, client_id, sizeof(client_id));
+    urlEncode(calendar_settings_.client_secret, secret, sizeof(secret));
+    urlEncode(calendar_settings_.refresh_token, refresh, sizeof(refresh));
+    int len = snprintf(body_, sizeof(body_),
+                       "client_id=%s&client_secret=%s&refresh_token=%s&grant_type=refresh_token",
+                       client_id, secret, refresh);
+
+    response_len_ = 0;
+    int status = google_.request("POST", "/oauth2/v4/token",
+                                 "Content-Type: application/x-www-form-urlencoded\r\n", body_, len,
+                                 [this](const char* data, size_t n) { collectResponse(data, n); });
+    stats_.gcal.requests++;
+    if (status != 200) {
+        Serial.printf("[SessionUploader] ERROR: Google token refresh failed (HTTP %d)\n", status);
+        return false;
+    }
+
+    // {"access_token": "ya29...", "expires_in": 3599, ...}
+    const char* key = strstr(response_, "\"access_token\"");
+    const char* value = key ? strchr(key + 14, '"') : nullptr;
+    const char* end = value ? strchr(value + 1, '"') : nullptr;
+    if (!end || static_cast<size_t>(end - value - 1) >= sizeof(access_token_)) {
+        Serial.println("[SessionUploader] ERROR: No usable access_token in Google response");
+        return false;
+    }
+    memcpy(access_token_, value + 1, end - value - 1);
+    access_token_[end - value - 1] = '\0';
+
+    long expires_in = 3600;
+    const char* expires = strstr(response_, "\"expires_in\"");
+    if (expires) {
+        const char* colon = strchr(expires, ':');
+        if (colon) expires_in = strtol(colon + 1, nullptr, 10);
+    }
+    token_expires_epoch_ = now_epoch + static_cast<uint32_t>(expires_in);
+    return true;
+}
+
+bool SessionUploader::uploadCalendar(size_t count, uint32_t now_epoch) {
+    if (!refreshAccessToken(now_epoch)) return false;
+
+    char headers[sizeof(access_token_) + 96];
+    snprintf(headers, sizeof(headers),
+             "Authorization: Bearer %s\r\nContent-Type: multipart/mixed; boundary=%s\r\n",
+             access_token_, BATCH_BOUNDARY);
+    char calendar[sizeof(calendar_settings_.calendar_id) * 3];
+    urlEncode(calendar_settings_.calendar_id, calendar, sizeof(calendar));
+
+    static constexpr size_t CLOSING = sizeof(BATCH_BOUNDARY) + 8;   // "--<boundary>--\r\n"
+    size_t next = 0;
+    while (true) {
+        // One request: as many events as fit in the body
+        size_t indices[GCAL_BATCH_MAX];
+        size_t parts = 0;
+        size_t len = 0;
+        for (; next < count && parts < GCAL_BATCH_MAX; next++) {
+            const UploadQueue::Entry& entry = batch_[next];
+            if (!(entry.pending & UploadQueue::GCAL)) continue;
+
+            char start[24];
+            char end[24];
+            formatTime(entry.end_epoch - entry.duration_s, start, sizeof(start));
+            formatTime(entry.end_epoch, end, sizeof(end));
+            int part = snprintf(body_ + len, sizeof(body_) - len,
+                                "--%s\r\n"
+                                "Content-Type: application/http\r\n"
+                                "Content-ID: <item-%lu>\r\n\r\n"
+                                "POST /calendar/v3/calendars/%s/events HTTP/1.1\r\n"
+                                "Content-Type: application/json\r\n\r\n"
+                                "{\"summary\":\"Pomodoro #%u\",\"description\":\"Created by %s\","
+                                "\"start\":{\"dateTime\":\"%s\"},\"end\":{\"dateTime\":\"%s\"},"
+                                "\"colorId\":\"%u\"}\r\n",
+                                BATCH_BOUNDARY, (unsigned long)entry.id, calendar,
+                                (unsigned)entry.session_number, CREATED_WITH, start, end,
+                                (unsigned)calendar_settings_.color_id);
+            if (part < 0 || len + part + CLOSING >= sizeof(body_)) break;   // Next request
+            len += part;
+            indices[parts++] = next;
+        }
+        if (parts == 0) return true;
+        len += snprintf(body_ + len, sizeof(body_) - len, "--%s--\r\n", BATCH_BOUNDARY);
+
+        result_count_ = 0;
+        response_len_ = 0;
+        part_id_ = 0;
+        int status = google_.request("POST", "/batch/calendar/v3", headers, body_, len,
+                                     [this](const char* data, size_t n) { scanBatchResponse(data, n); });
+        stats_.gcal.requests++;
+
+        if (status == 401) {
+            // Access token revoked/expired early: refresh in the next window
+            access_token_[0] = '\0';
+            token_expires_epoch_ = 0;
+        }
+        if (status != 200) {
+            Serial.printf("[SessionUploader] ERROR: Google batch failed (HTTP %d)\n", status);
+            bool counts = status != 401 && status != 403;
+            for (size_t i = 0; i < parts; i++) {
+                queue_.settle(batch_[indices[i]].id, 0, counts ? UploadQueue::GCAL : 0);
+            }
+            return false;
+        }
+
+        // Per-event status from the multipart response (matched by Content-ID)
+        bool ok = true;
+        for (size_t i = 0; i < parts; i++) {
+            const UploadQueue::Entry& entry = batch_[indices[i]];
+            int part_status = -1;
+            for (size_t r = 0; r < result_count_; r++) {
+                if (results_[r].id == entry.id) part_status = results_[r].status;
+            }
+            if (part_status >= 200 && part_status < 300) {
+                queue_.settle(entry.id, UploadQueue::GCAL, 0);
+                stats_.gcal.uploaded++;
+            } else if (!isRetryable(part_status)) {
+                Serial.printf("[SessionUploader] ERROR: Google rejected session #%lu (HTTP %d), dropped\n",
+                              (unsigned long)entry.id, part_status);
+                queue_.settle(entry.id, UploadQueue::GCAL, 0);
+                stats_.gcal.rejected++;
+            } else {
+                queue_.settle(entry.id, 0, UploadQueue::GCAL);
+                ok = false;
+            }
+        }
+        if (!ok) return false;
+    }
+}
+
+// ============================================================================
+// Response parsing
+// ============================================================================
+
+void SessionUploader::collectResponse(const char* data, size_t len) {
+    size_t room = sizeof(response_) - 1 - response_len_;
+    if (len > room) len = room;
+    memcpy(response_ + response_len_, data, len);
+    response_len_ += len;
+    response_[response_len_] = '\0';
+}
+
+// Line scanner over the multipart body: "Content-ID: <response-item-N>"
+// followed by the part's "HTTP/1.1 <status>" line
+void SessionUploader::scanBatchResponse(const char* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        if (c != '\n') {
+            if (c != '\r' && response_len_ < sizeof(response_) - 1) response_[response_len_++] = c;
+            continue;
+        }
+        response_[response_len_] = '\0';
+        response_len_ = 0;
+
+        if (strncasecmp(response_, "Content-ID:", 11) == 0) {
+            const char* item = strstr(response_, "item-");
+            part_id_ = item ? strtoul(item + 5, nullptr, 10) : 0;
+        } else if (strncmp(response_, "HTTP/1.", 7) == 0 && part_id_ != 0) {
+            int status = 0;
+            if (sscanf(response_, "HTTP/1.%*d %d", &status) == 1 && result_count_ < GCAL_BATCH_MAX) {
+                results_[result_count_++] = {part_id_, status};
+            }
+            part_id_ = 0;
+        }
+    }
+}
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+void SessionUploader::formatTime(uint32_t epoch, char* out, size_t max) {
+    time_t t = static_cast<time_t>(epoch);
+    struct tm utc;
+    gmtime_r(&t, &utc);
+    strftime(out, max, "%Y-%m-%dT%H:%M:%SZ", &utc);
+}
+
+size_t SessionUploader::base64(const char* in, size_t len, char* out, size_t max) {
+    static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t o = 0;
+    for (size_t i = 0; i < len && o + 4 < max; i += 3) {
+        uint32_t n = static_cast<uint8_t>(in[i]) << 16;
+        if (i + 1 < len) n |= static_cast<uint8_t>(in[i + 1]) << 8;
+        if (i + 2 < len) n |= static_cast<uint8_t>(in[i + 2]);
+        out[o++] = ALPHABET[(n >> 18) & 0x3F];
+        out[o++] = ALPHABET[(n >> 12) & 0x3F];
+        out[o++] = i + 1 < len ? ALPHABET[(n >> 6) & 0x3F] : '=';
+        out[o++] = i + 2 < len ? ALPHABET[n & 0x3F] : '=';
+    }
+    out[o] = '\0';
+    return o;
+}
+
+size_t SessionUploader::urlEncode(const char* in, char* out, size_t max) {
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    size_t o = 0;
+    for (; *in && o + 3 < max; in++) {
+        char c = *in;
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '_' || c == '.' || c == '~') {
+            out[o++] = c;
+        } else {
+            out[o++] = '%';
+            out[o++] = HEX_DIGITS[(static_cast<uint8_t>(c) >> 4) & 0x0F];
+            out[o++] = HEX_DIGITS[static_cast<uint8_t>(c) & 0x0F];
+        }
+    }
+    out[o] = '\0';
+    return o;
+}
@@ -0,0 +1,137 @@
+#ifndef SESSION_UPLOADER_H
+#define SESSION_UPLOADER_H
+
+#include "ApiClient.h"
+#include "UploadQueue.h"
+#include "../core/NetworkConfig.h"
+#include "../core/PomodoroSequence.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Uploads completed work sessions to Toggl Track and Google Calendar
+ *
+ * Sessions are queued (UploadQueue, NVS) when they complete and uploaded
+ * in sync windows: the upload task wakes WiFi every sync interval and
+ * calls runWindow(), which sends everything due over one persistent
+ * connection per API host and closes them at the end of the window. So
+ * connections (TLS handshakes) per day follow the number of windows, not
+ * the number of sessions:
+ * - Google Calendar: all queued events in one batch request
+ *   (POST /batch/calendar/v3, up to GCAL_BATCH_MAX per request), plus an
+ *   OAuth2 token refresh on the same connection when the access token
+ *   expired (tokens last an hour, so at most one refresh per window)
+ * - Toggl Track: API v9 has no bulk create, so one POST per time entry,
+ *   back to back on the kept-alive connection
+ *
+ * Failures: a window that fails for a target (network error, 429, 5xx,
+ * 401/403) keeps the entries queued and backs that target off
+ * exponentially (BACKOFF_BASE_S doubling up to BACKOFF_MAX_S, stored with
+ * the queue); other 4xx rejections drop the entry for that target.
+ *
+ * Threading: enqueue() is called from the UI core, runWindow() from the
+ * upload task; they only share the (mutex-protected) queue.
+ *
+ * Usage:
+ *   SessionUploader uploader(queue, toggl_api, google_api);
+ *   uploader.configureToggl(netConfig.getToggl());
+ *   uploader.enqueue(session, elapsed_ms);    // Session complete
+ *   if (uploader.isDue(now)) uploader.runWindow(now);
+ */
+class SessionUploader {
+public:
+    static constexpr uint32_t BACKOFF_BASE_S = 60;
+    static constexpr uint32_t BACKOFF_MAX_S = 3600;
+    static constexpr size_t GCAL_BATCH_MAX = 20;
+    static constexpr size_t BODY_SIZE = 4096;          // Request body (one batch)
+    static constexpr size_t RESPONSE_SIZE = 1024;      // Kept part of a response body
+    static constexpr uint32_t MIN_VALID_EPOCH = 1704067200;   // 2024-01-01: clock set
+
+    static constexpr const char* TOGGL_HOST = "api.track.toggl.com";
+    static constexpr const char* GOOGLE_HOST = "www.googleapis.com";
+
+    struct TargetStats {
+        uint32_t uploaded;       // Entries accepted
+        uint32_t rejected;       // Entries dropped (4xx)
+        uint32_t requests;       // HTTP requests (incl. token refresh)
+        uint32_t failed_windows; // Windows that ended in backoff
+    };
+
+    struct Stats {
+        uint32_t windows;
+        uint32_t enqueued;
+        uint32_t skipped;        // Not queued: clock not set
+        TargetStats toggl;
+        TargetStats gcal;
+    };
+
+    SessionUploader(UploadQueue& queue, ApiClient& toggl, ApiClient& google);
+
+    void configureToggl(const NetworkConfig::TogglSettings& settings);
+    void configureCalendar(const NetworkConfig::CalendarSettings& settings);
+    bool isEnabled() const { return targets() != 0; }
+
+    /**
+     * Queue a completed work session (breaks are not uploaded)
+     * @param elapsed_ms Timed duration of the session
+     */
+    bool enqueue(const PomodoroSequence::Session& session, uint32_t elapsed_ms);
+
+    /**
+     * Anything queued for an enabled target whose backoff has expired
+     */
+    bool isDue(uint32_t now_epoch) const;
+
+    /**
+     * Upload everything due, then close the connections and persist the queue
+     * @return true if nothing due failed
+     */
+    bool runWindow(uint32_t now_epoch);
+
+    const Stats& getStats() const { return stats_; }
+    void printStats() const;
+
+private:
+    struct BatchResult {
+        uint32_t id;
+        int status;
+    };
+
+    UploadQueue& queue_;
+    ApiClient& toggl_;
+    ApiClient& google_;
+
+    NetworkConfig::TogglSettings toggl_settings_;
+    NetworkConfig::CalendarSettings calendar_settings_;
+    char toggl_auth_[96];            // "Basic <base64(token:api_token)>"
+    char toggl_tags_[96];            // JSON array
+    char access_token_[256];
+    uint32_t token_expires_epoch_;
+
+    Stats stats_;
+    UploadQueue::Entry batch_[UploadQueue::CAPACITY];
+    char body_[BODY_SIZE];
+    char response_[RESPONSE_SIZE];
+    size_t response_len_;
+    BatchResult results_[GCAL_BATCH_MAX];
+    size_t result_count_;
+    uint32_t part_id_;
+
+    uint8_t targets() const;
+    bool due(UploadQueue::Target target, uint32_t now_epoch) const;
+    void finishTarget(UploadQueue::Target target, bool ok, uint32_t now_epoch);
+
+    bool uploadToggl(size_t count);
+    bool uploadCalendar(size_t count, uint32_t now_epoch);
+    bool refreshAccessToken(uint32_t now_epoch);
+
+    void collectResponse(const char* data, size_t len);
+    void scanBatchResponse(const char* data, size_t len);
+
+    static bool isRetryable(int status);
+    static void formatTime(uint32_t epoch, char* out, size_t max);
+    static size_t base64(const char* in, size_t len, char* out, size_t max);
+    static size_t urlEncode(const char* in, char* out, size_t max);
+};
+
+#endif // SESSION_UPLOADER_H
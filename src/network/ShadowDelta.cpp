@@ -0,0 +1,318 @@
+#include "ShadowDelta.h"
+#include <Arduino.h>
+#include "../core/PomodoroSequence.h"
+#include "../hardware/IAudioPlayer.h"
+#include "../hardware/IPowerManager.h"
+
+// ============================================================================
+// Field table (shadow name → Config field; ranges as in SettingsScreen, except
+// sessions/cycles which use the limits PomodoroSequence actually accepts)
+// ============================================================================
+
+enum class ShadowDeltaProcessor::Field : uint8_t {
+    WORK_MIN,
+    SHORT_BREAK_MIN,
+    LONG_BREAK_MIN,
+    SESSIONS_BEFORE_LONG,
+    NUM_CYCLES,
+    AUTO_START_BREAKS,
+    AUTO_START_WORK,
+    BRIGHTNESS,
+    SOUND_ENABLED,
+    VOLUME,
+    HAPTIC_ENABLED,
+    SHOW_SECONDS,
+    SCREEN_TIMEOUT_SEC,
+    AUTO_SLEEP,
+    SLEEP_AFTER_MIN,
+    WAKE_ON_ROTATION,
+    MIN_BATTERY,
+};
+
+struct ShadowDeltaProcessor::FieldSpec {
+    const char* key;
+    Field field;
+    bool is_bool;
+    int32_t min;
+    int32_t max;
+};
+
+const ShadowDeltaProcessor::FieldSpec ShadowDeltaProcessor::FIELDS[] = {
+    {"pomodoroDuration",   Field::WORK_MIN,             false, 1, 90},
+    {"shortRestDuration",  Field::SHORT_BREAK_MIN,      false, 1, 15},
+    {"longRestDuration",   Field::LONG_BREAK_MIN,       false, 10, 30},
+    {"sessionsBeforeLong", Field::SESSIONS_BEFORE_LONG, false,
+     PomodoroSequence::MIN_SESSIONS_BEFORE_LONG, PomodoroSequence::MAX_SESSIONS_BEFORE_LONG},
+    {"cycles",             Field::NUM_CYCLES,           false,
+     PomodoroSequence::MIN_CYCLES, PomodoroSequence::MAX_CYCLES},
+    {"autoStartBreaks",    Field::AUTO_START_BREAKS,    true,  0, 1},
+    {"autoStartWork",      Field::AUTO_START_WORK,      true,  0, 1},
+    {"brightness",         Field::BRIGHTNESS,           false, 0, 100},
+    {"soundEnabled",       Field::SOUND_ENABLED,        true,  0, 1},
+    {"volume",             Field::VOLUME,               false, 0, 100},
+    {"hapticEnabled",      Field::HAPTIC_ENABLED,       true,  0, 1},
+    {"showSeconds",        Field::SHOW_SECONDS,         true,  0, 1},
+    {"screenTimeout",      Field::SCREEN_TIMEOUT_SEC,   false, 0, 255},   // uint8_t in Config
+    {"autoSleep",          Field::AUTO_SLEEP,           true,  0, 1},
+    {"sleepAfterMin",      Field::SLEEP_AFTER_MIN,      false, 0, 600},
+    {"gyroWake",           Field::WAKE_ON_ROTATION,     true,  0, 1},
+    {"minBattery",         Field::MIN_BATTERY,          false, 5, 50},
+};
+
+const size_t ShadowDeltaProcessor::FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+int32_t ShadowDeltaProcessor::readField(Field field, const Config::PomodoroSettings& p,
+                                        const Config::UISettings& u, const Config::PowerSettings& w) {
+    switch (field) {
+        case Field::WORK_MIN: return p.work_duration_min;
+        case Field::SHORT_BREAK_MIN: return p.short_break_min;
+        case Field::LONG_BREAK_MIN: return p.long_break_min;
+        case Field::SESSIONS_BEFORE_LONG: return p.sessions_before_long;
+        case Field::NUM_CYCLES: return p.num_cycles;
+        case Field::AUTO_START_BREAKS: return p.auto_start_breaks;
+        case Field::AUTO_START_WORK: return p.auto_start_work;
+        case Field::BRIGHTNESS: return u.brightness;
+        case Field::SOUND_ENABLED: return u.sound_enabled;
+        case Field::VOLUME: return u.sound_volume;
+        case Field::HAPTIC_ENABLED: return u.haptic_enabled;
+        case Field::SHOW_SECONDS: return u.show_seconds;
+        case Field::SCREEN_TIMEOUT_SEC: return u.screen_timeout_sec;
+        case Field::AUTO_SLEEP: return w.auto_sleep_enabled;
+        case Field::SLEEP_AFTER_MIN: return w.sleep_after_min;
+        case Field::WAKE_ON_ROTATION: return w.wake_on_rotation;
+        case Field::MIN_BATTERY: return w.min_battery_percent;
+    }
+    return 0;
+}
+
+void ShadowDeltaProcessor::writeField(Field field, int32_t v, Config::PomodoroSettings& p,
+                                      Config::UISettings& u, Config::PowerSettings& w) {
+    switch (field) {
+        case Field::WORK_MIN: p.work_duration_min = static_cast<uint16_t>(v); break;
+        case Field::SHORT_BREAK_MIN: p.short_break_min = static_cast<uint16_t>(v); break;
+        case Field::LONG_BREAK_MIN: p.long_break_min = static_cast<uint16_t>(v); break;
+        case Field::SESSIONS_BEFORE_LONG: p.sessions_before_long = static_cast<uint8_t>(v); break;
+        case Field::NUM_CYCLES: p.num_cycles = static_cast<uint8_t>(v); break;
+        case Field::AUTO_START_BREAKS: p.auto_start_breaks = v != 0; break;
+        case Field::AUTO_START_WORK: p.auto_start_work = v != 0; break;
+        case Field::BRIGHTNESS: u.brightness = static_cast<uint8_t>(v); break;
+        case Field::SOUND_ENABLED: u.sound_enabled = v != 0; break;
+        case Field::VOLUME: u.sound_volume = static_cast<uint8_t>(v); break;
+        case Field::HAPTIC_ENABLED: u.haptic_enabled = v != 0; break;
+        case Field::SHOW_SECONDS: u.show_seconds = v != 0; break;
+        case Field::SCREEN_TIMEOUT_SEC: u.screen_timeout_sec = static_cast<uint8_t>(v); break;
+        case Field::AUTO_SLEEP: w.auto_sleep_enabled = v != 0; break;
+        case Field::SLEEP_AFTER_MIN: w.sleep_after_min = static_cast<uint16_t>(v); break;
+        case Field::WAKE_ON_ROTATION: w.wake_on_rotation = v != 0; break;
+        case Field::MIN_BATTERY: w.min_battery_percent = static_cast<uint8_t>(v); break;
+    }
+}
+
+uint32_t ShadowDeltaProcessor::fieldBit(Field field) {
+    return 1UL << static_cast<uint8_t>(field);
+}
+
+// Field groups as changed_mask_ bits (Field enum order)
+static constexpr uint32_t POMODORO_FIELDS = 0x007F;   // WORK_MIN .. AUTO_START_WORK
+static constexpr uint32_t SEQUENCE_FIELDS = 0x001F;   // Durations, sessions, cycles
+static constexpr uint32_t DURATION_FIELDS = 0x0007;
+static constexpr uint32_t UI_FIELDS = 0x1F80;         // BRIGHTNESS .. SCREEN_TIMEOUT_SEC
+static constexpr uint32_t POWER_FIELDS = 0x1E000;     // AUTO_SLEEP .. MIN_BATTERY
+
+// ============================================================================
+// Processor
+// ============================================================================
+
+ShadowDeltaProcessor::ShadowDeltaProcessor(Config& config, PomodoroSequence& sequence,
+                                           IAudioPlayer* audio, IPowerManager* power)
+    : config_(config),
+      sequence_(sequence),
+      audio_(audio),
+      power_(power),
+      pending_save_(false),
+      stats_{},
+      version_(0),
+      has_version_(false),
+      changed_mask_(0),
+      result_{} {
+}
+
+ShadowDeltaProcessor::Result ShadowDeltaProcessor::apply(const char* json, size_t len) {
+    stats_.deltas++;
+
+    // Stage on copies; Config is only touched once the whole document parsed
+    pomodoro_ = config_.getPomodoro();
+    ui_ = config_.getUI();
+    power_settings_ = config_.getPower();
+    version_ = 0;
+    has_version_ = false;
+    changed_mask_ = 0;
+    result_ = Result{Status::INVALID, 0, 0, 0, 0};
+
+    bool ok = JsonScanner::scan(json, len, [this](const JsonScanner::Path& path,
+                                                  const JsonScanner::Value& value) {
+        onValue(path, value);
+    });
+
+    if (!ok || !has_version_) {
+        stats_.invalid++;
+        Serial.printf("[ShadowDelta] Dropped %s delta (%u bytes)\n",
+                      ok ? "unversioned" : "malformed", (unsigned)len);
+        result_ = Result{Status::INVALID, 0, 0, 0, 0};
+        return result_;
+    }
+
+    result_.version = version_;
+    uint32_t last = config_.getNetwork().shadow_version;
+    if (version_ <= last) {
+        stats_.stale++;
+        result_.status = Status::STALE;
+        result_.rejected = 0;
+        result_.unknown = 0;
+        Serial.printf("[ShadowDelta] Stale delta v%lu (applied v%lu)\n",
+                      (unsigned long)version_, (unsigned long)last);
+        return result_;
+    }
+
+    // Keep only the fields whose final value differs (repeated keys: last wins)
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        Field f = FIELDS[i].field;
+        if (readField(f, pomodoro_, ui_, power_settings_) ==
+            readField(f, config_.getPomodoro(), config_.getUI(), config_.getPower())) {
+            changed_mask_ &= ~fieldBit(f);
+        }
+    }
+    for (uint32_t m = changed_mask_; m; m &= m - 1) {
+        result_.changed++;
+    }
+
+    commit();
+
+    stats_.fields_changed += result_.changed;
+    stats_.fields_rejected += result_.rejected;
+    if (result_.changed > 0) {
+        stats_.applied++;
+        result_.status = Status::APPLIED;
+    } else {
+        result_.status = Status::NO_CHANGE;
+    }
+    Serial.printf("[ShadowDelta] v%lu: %u changed, %u rejected, %u unknown\n",
+                  (unsigned long)version_, result_.changed, result_.rejected, result_.unknown);
+    return result_;
+}
+
+void ShadowDeltaProcessor::onValue(const JsonScanner::Path& path, const JsonScanner::Value& value) {
+    if (path.depth == 1 && path.keyIs(0, "version")) {
+        if (value.isInteger() && value.asLong() >= 0) {
+            version_ = static_cast<uint32_t>(value.asLong());
+            has_version_ = true;
+        }
+        return;
+    }
+
+    // state.settings.<key> (delta topic) or state.desired.settings.<key>
+    size_t key_level;
+    if (path.depth == 3 && path.keyIs(0, "state") && path.keyIs(1, "settings")) {
+        key_level = 2;
+    } else if (path.depth == 4 && path.keyIs(0, "state") && path.keyIs(1, "desired") &&
+               path.keyIs(2, "settings")) {
+        key_level = 3;
+    } else {
+        return;   // metadata, timestamp, other sections
+    }
+
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        if (path.keyIs(key_level, FIELDS[i].key)) {
+            if (!stage(FIELDS[i], value)) {
+                result_.rejected++;
+            }
+            return;
+        }
+    }
+    result_.unknown++;
+}
+
+bool ShadowDeltaProcessor::stage(const FieldSpec& spec, const JsonScanner::Value& value) {
+    int32_t v;
+    if (spec.is_bool) {
+        if (value.type != JsonScanner::Type::BOOL) return false;
+        v = value.asBool() ? 1 : 0;
+    } else {
+        if (!value.isInteger()) return false;
+        long n = value.asLong();
+        if (n < spec.min || n > spec.max) return false;
+        v = static_cast<int32_t>(n);
+    }
+    writeField(spec.field, v, pomodoro_, ui_, power_settings_);
+    changed_mask_ |= fieldBit(spec.field);
+    return true;
+}
+
+void ShadowDeltaProcessor::commit() {
+    if (changed_mask_ & POMODORO_FIELDS) {
+        // MP-50: remote durations that match neither preset become the Custom template
+        if (changed_mask_ & DURATION_FIELDS) {
+            bool is_classic = (pomodoro_.work_duration_min == 25 && pomodoro_.short_break_min == 5 &&
+                               pomodoro_.long_break_min == 15);
+            bool is_study = (pomodoro_.work_duration_min == 45 && pomodoro_.short_break_min == 15 &&
+                             pomodoro_.long_break_min == 30);
+            if (!is_classic && !is_study) {
+                pomodoro_.custom_work_min = pomodoro_.work_duration_min;
+                pomodoro_.custom_short_break_min = pomodoro_.short_break_min;
+                pomodoro_.custom_long_break_min = pomodoro_.long_break_min;
+            }
+        }
+        config_.setPomodoro(pomodoro_);
+    }
+    if (changed_mask_ & SEQUENCE_FIELDS) {
+        // Same order as ScreenManager::reloadTimerConfig()
+        sequence_.setSessionsBeforeLong(pomodoro_.sessions_before_long);
+        sequence_.setNumCycles(pomodoro_.num_cycles);
+        sequence_.setWorkDuration(pomodoro_.work_duration_min);
+        sequence_.setShortBreakDuration(pomodoro_.short_break_min);
+        sequence_.setLongBreakDuration(pomodoro_.long_break_min);
+    }
+
+    if (changed_mask_ & UI_FIELDS) {
+        config_.setUI(ui_);
+    }
+    if ((changed_mask_ & fieldBit(Field::VOLUME)) && audio_) {
+        audio_->setVolume(ui_.sound_volume);
+    }
+    if ((changed_mask_ & fieldBit(Field::BRIGHTNESS)) && power_) {
+        power_->setBrightness(ui_.brightness);
+    }
+
+    if (changed_mask_ & POWER_FIELDS) {
+        config_.setPower(power_settings_);
+    }
+
+    // Version is recorded even when nothing changed, so a replay stays stale
+    Config::NetworkSettings network = config_.getNetwork();
+    network.shadow_version = version_;
+    config_.setNetwork(network);
+    pending_save_ = true;
+}
+
+bool ShadowDeltaProcessor::flush() {
+    if (!pending_save_) {
+        return true;
+    }
+    if (!config_.save()) {
+        Serial.println("[ShadowDelta] ERROR: Config save failed");
+        return false;
+    }
+    pending_save_ = false;
+    stats_.saves++;
+    return true;
+}
+
+void ShadowDeltaProcessor::printStats() const {
+    Serial.printf("\nShadow Delta: v%lu, %lu deltas (%lu applied, %lu stale, %lu invalid)\n",
+                  (unsigned long)getVersion(), (unsigned long)stats_.deltas,
+                  (unsigned long)stats_.applied, (unsigned long)stats_.stale,
+                  (unsigned long)stats_.invalid);
+    Serial.printf("  Fields: %lu changed, %lu rejected, %lu saves\n",
+                  (unsigned long)stats_.fields_changed, (unsigned long)stats_.fields_rejected,
+                  (unsigned long)stats_.saves);
+}
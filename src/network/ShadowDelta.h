@@ -0,0 +1,124 @@
+#ifndef SHADOW_DELTA_H
+#define SHADOW_DELTA_H
+
+#include "../core/Config.h"
+#include "../utils/JsonScanner.h"
+#include <stddef.h>
+#include <stdint.h>
+
+class PomodoroSequence;
+class IAudioPlayer;
+class IPowerManager;
+
+/**
+ * Applies AWS IoT shadow delta documents to Config
+ *
+ * Input is the payload of .../shadow/update/delta
+ * ({"version":N,"state":{"settings":{...}}}); the desired-state layout
+ * {"state":{"desired":{"settings":{...}}}} is accepted too. The document is
+ * scanned in place with JsonScanner (no DOM) and only the settings fields
+ * whose value differs from Config are applied, together with the subsystem
+ * they drive:
+ * - durations, sessionsBeforeLong, cycles → PomodoroSequence
+ * - volume → IAudioPlayer::setVolume()
+ * - brightness → IPowerManager::setBrightness()
+ *
+ * Ordering: a delta whose version is not newer than the last applied one
+ * (persisted in Config as net_shver) is dropped as stale. Changes are
+ * staged while scanning, so a malformed document or an out-of-range value
+ * never leaves Config half-updated (out-of-range fields are rejected one
+ * by one, the rest still apply).
+ *
+ * Persistence: apply() only updates Config in RAM; flush() saves it once
+ * for the whole batch of deltas received since the last flush.
+ *
+ * Not thread-safe: call from the task that owns Config (UI task, Core 0).
+ * Not wired to MQTT yet: the delivery path from the network task lands
+ * with the MQTT client.
+ *
+ * Usage:
+ *   ShadowDeltaProcessor deltas(config, sequence, audio, power);
+ *   deltas.apply(payload, length);   // Each delta received
+ *   deltas.flush();                  // Once per batch
+ */
+class ShadowDeltaProcessor {
+public:
+    enum class Status : uint8_t {
+        APPLIED,      // Newer version, at least one field changed
+        NO_CHANGE,    // Newer version, all fields already matched
+        STALE,        // Version not newer than the last applied
+        INVALID       // Malformed JSON or no version
+    };
+
+    struct Result {
+        Status status;
+        uint32_t version;
+        uint8_t changed;      // Fields applied
+        uint8_t rejected;     // Known fields with wrong type or out of range
+        uint8_t unknown;      // Settings fields this firmware does not have
+    };
+
+    struct Stats {
+        uint32_t deltas;
+        uint32_t applied;
+        uint32_t stale;
+        uint32_t invalid;
+        uint32_t fields_changed;
+        uint32_t fields_rejected;
+        uint32_t saves;
+    };
+
+    ShadowDeltaProcessor(Config& config, PomodoroSequence& sequence,
+                         IAudioPlayer* audio = nullptr, IPowerManager* power = nullptr);
+
+    /**
+     * Apply one delta document (need not be null-terminated)
+     */
+    Result apply(const char* json, size_t len);
+
+    /**
+     * Save Config if any delta was accepted since the last flush
+     * @return true if nothing to save or the save succeeded
+     */
+    bool flush();
+
+    bool hasPendingSave() const { return pending_save_; }
+    uint32_t getVersion() const { return config_.getNetwork().shadow_version; }
+    const Stats& getStats() const { return stats_; }
+
+    void printStats() const;
+
+private:
+    enum class Field : uint8_t;
+    struct FieldSpec;
+    static const FieldSpec FIELDS[];
+    static const size_t FIELD_COUNT;
+
+    Config& config_;
+    PomodoroSequence& sequence_;
+    IAudioPlayer* audio_;
+    IPowerManager* power_;
+    bool pending_save_;
+    Stats stats_;
+
+    // Staging for the delta being scanned
+    Config::PomodoroSettings pomodoro_;
+    Config::UISettings ui_;
+    Config::PowerSettings power_settings_;
+    uint32_t version_;
+    bool has_version_;
+    uint32_t changed_mask_;
+    Result result_;
+
+    static int32_t readField(Field field, const Config::PomodoroSettings& p,
+                             const Config::UISettings& u, const Config::PowerSettings& w);
+    static void writeField(Field field, int32_t v, Config::PomodoroSettings& p,
+                           Config::UISettings& u, Config::PowerSettings& w);
+    static uint32_t fieldBit(Field field);
+
+    void onValue(const JsonScanner::Path& path, const JsonScanner::Value& value);
+    bool stage(const FieldSpec& spec, const JsonScanner::Value& value);
+    void commit();
+};
+
+#endif // SHADOW_DELTA_H
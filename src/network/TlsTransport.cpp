@@ -0,0 +1,47 @@
+#include "TlsTransport.h"
+#include <Arduino.h>
+
+TlsTransport::TlsTransport(const char* root_ca_pem)
+    : root_ca_(root_ca_pem) {
+    if (root_ca_ && root_ca_[0] != '\0') {
+        client_.setCACert(root_ca_);
+    }
+}
+
+bool TlsTransport::connect(const char* host, uint16_t port) {
+    if (!root_ca_ || root_ca_[0] == '\0') {
+        Serial.printf("[TlsTransport] ERROR: No root CA for %s, refusing to connect\n", host);
+        return false;
+    }
+    client_.setHandshakeTimeout(CONNECT_TIMEOUT_MS / 1000);
+    if (!client_.connect(host, port, CONNECT_TIMEOUT_MS)) {
+        char error[64];
+        client_.lastError(error, sizeof(error));
+        Serial.printf("[TlsTransport] ERROR: Connect to %s:%u failed: %s\n", host, port, error);
+        return false;
+    }
+    return true;
+}
+
+bool TlsTransport::connected() {
+    return client_.connected();
+}
+
+size_t TlsTransport::write(const uint8_t* data, size_t len) {
+    return client_.write(data, len);
+}
+
+int TlsTransport::read(uint8_t* data, size_t len, uint32_t timeout_ms) {
+    uint32_t start = millis();
+    while (client_.available() <= 0) {
+        if (!client_.connected()) return -1;
+        if (millis() - start >= timeout_ms) return 0;
+        vTaskDelay(pdMS_TO_TICKS(READ_POLL_MS));
+    }
+    int n = client_.read(data, len);
+    return n < 0 ? 0 : n;
+}
+
+void TlsTransport::stop() {
+    client_.stop();
+}
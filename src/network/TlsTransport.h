@@ -0,0 +1,35 @@
+#ifndef TLS_TRANSPORT_H
+#define TLS_TRANSPORT_H
+
+#include "ITransport.h"
+#include <WiFiClientSecure.h>
+
+/**
+ * TLS transport on WiFiClientSecure (mbedTLS)
+ *
+ * One session per transport: the ApiClient on top keeps it open across
+ * requests, so the handshake is paid once per sync window.
+ *
+ * Server verification: the certificate chain is always checked against
+ * the root CA bundle (PEM, kept by the caller - see TrustAnchors). There is
+ * no unauthenticated fallback: without a bundle connect() fails.
+ */
+class TlsTransport : public ITransport {
+public:
+    explicit TlsTransport(const char* root_ca_pem);
+
+    bool connect(const char* host, uint16_t port) override;
+    bool connected() override;
+    size_t write(const uint8_t* data, size_t len) override;
+    int read(uint8_t* data, size_t len, uint32_t timeout_ms) override;
+    void stop() override;
+
+private:
+    static constexpr uint32_t CONNECT_TIMEOUT_MS = 10000;
+    static constexpr uint32_t READ_POLL_MS = 5;
+
+    WiFiClientSecure client_;
+    const char* root_ca_;
+};
+
+#endif // TLS_TRANSPORT_H
@@ -0,0 +1,24 @@
+#ifndef TRUST_ANCHORS_H
+#define TRUST_ANCHORS_H
+
+/**
+ * Root CA bundles for the upload hosts (PEM, in flash)
+ *
+ * TlsTransport needs a trust anchor to connect at all; these are the roots
+ * the Toggl and Google API certificates chain to, compiled in so sync
+ * works without an SD card. Each bundle is several PEM blocks back to back
+ * (mbedTLS loads them as one CA chain), so a host moving between the listed
+ * CAs keeps working. Refresh from the Mozilla CA store when a root nears
+ * its expiry (earliest: GlobalSign Root CA, 2028-01-28).
+ *
+ * Usage:
+ *   TlsTransport toggl_tls(TrustAnchors::TOGGL);
+ */
+namespace TrustAnchors {
+
+extern const char TOGGL[];    // api.track.toggl.com
+extern const char GOOGLE[];   // www.googleapis.com
+
+}  // namespace TrustAnchors
+
+#endif // TRUST_ANCHORS_H
@@ -0,0 +1,188 @@
+#include "UploadQueue.h"
+#include "../utils/AllocTracker.h"
+#include "../utils/MutexGuard.h"
+#include <Arduino.h>
+#include <stddef.h>
+#include <string.h>
+
+UploadQueue::UploadQueue()
+    : initialized_(false),
+      dirty_(false),
+      dropped_(0),
+      data_{},
+      mutex_(xSemaphoreCreateMutex()) {
+    data_.version = VERSION;
+    data_.next_id = 1;
+    if (mutex_ == NULL) {
+        Serial.println("[UploadQueue] ERROR: Failed to create mutex");
+    } else {
+        vQueueAddToRegistry(mutex_, "upload_queue_mutex");
+    }
+}
+
+UploadQueue::~UploadQueue() {
+    prefs_.end();
+    if (mutex_ != NULL) {
+        vSemaphoreDelete(mutex_);
+        mutex_ = NULL;
+    }
+}
+
+bool UploadQueue::begin() {
+    ALLOC_SCOPE(NETWORK);
+    if (!prefs_.begin(NAMESPACE, false)) {
+        Serial.println("[UploadQueue] ERROR: Failed to open NVS namespace");
+        return false;
+    }
+
+    MutexGuard guard(mutex_, "upload_queue_mutex", 100);
+    if (!guard.isLocked()) return false;
+
+    size_t stored = prefs_.getBytesLength(KEY);
+    size_t header = offsetof(Stored, entries);
+    Stored loaded{};
+    if (stored >= header && stored <= sizeof(Stored) &&
+        prefs_.getBytes(KEY, &loaded, stored) == stored &&
+        loaded.version == VERSION && loaded.count <= CAPACITY &&
+        stored == header + loaded.count * sizeof(Entry)) {
+        data_ = loaded;
+    } else if (stored > 0) {
+        Serial.println("[UploadQueue] WARN: Stored queue invalid, starting empty");
+    }
+
+    initialized_ = true;
+    Serial.printf("[UploadQueue] Initialized (%u pending sessions)\n", (unsigned)data_.count);
+    return true;
+}
+
+bool UploadQueue::push(uint32_t end_epoch, uint16_t duration_s, uint8_t session_type,
+                       uint8_t session_number, uint8_t targets) {
+    ALLOC_SCOPE(NETWORK);
+    if (!initialized_ || targets == 0) return false;
+
+    MutexGuard guard(mutex_, "upload_queue_mutex", 100);
+    if (!guard.isLocked()) {
+        Serial.println("[UploadQueue] ERROR: Failed to acquire mutex in push");
+        return false;
+    }
+
+    if (data_.count == CAPACITY) {
+        Serial.printf("[UploadQueue] WARN: Queue full, dropping session #%lu\n",
+                      (unsigned long)data_.entries[0].id);
+        removeAt(0);
+        dropped_++;
+    }
+
+    Entry& entry = data_.entries[data_.count++];
+    memset(&entry, 0, sizeof(entry));
+    entry.id = data_.next_id++;
+    entry.end_epoch = end_epoch;
+    entry.duration_s = duration_s;
+    entry.session_type = session_type;
+    entry.session_number = session_number;
+    entry.pending = targets;
+    return save();
+}
+
+size_t UploadQueue::snapshot(Entry* out, size_t max) const {
+    MutexGuard guard(mutex_, "upload_queue_mutex", 100);
+    if (!guard.isLocked()) return 0;
+
+    size_t n = data_.count < max ? data_.count : max;
+    memcpy(out, data_.entries, n * sizeof(Entry));
+    return n;
+}
+
+size_t UploadQueue::size() const {
+    MutexGuard guard(mutex_, "upload_queue_mutex", 100);
+    return guard.isLocked() ? data_.count : 0;
+}
+
+size_t UploadQueue::pendingFor(Target target) const {
+    MutexGuard guard(mutex_, "upload_queue_mutex", 100);
+    if (!guard.isLocked()) return 0;
+
+    size_t n = 0;
+    for (size_t i = 0; i < data_.count; i++) {
+        if (data_.entries[i].pending & target) n++;
+    }
+    return n;
+}
+
+void UploadQueue::settle(uint32_t id, uint8_t done, uint8_t failed) {
+    MutexGuard guard(mutex_, "upload_queue_mutex", 100);
+    if (!guard.isLocked()) return;
+
+    for (size_t i = 0; i < data_.count; i++) {
+        Entry& entry = data_.entries[i];
+        if (entry.id != id) continue;
+
+        entry.pending &= ~done;
+        if (failed && entry.attempts < 0xFF) entry.attempts++;
+        if (entry.pending != 0 && entry.attempts >= MAX_ATTEMPTS) {
+            Serial.printf("[UploadQueue] WARN: Session #%lu dropped after %u attempts\n",
+                          (unsigned long)id, (unsigned)entry.attempts);
+            entry.pending = 0;
+            dropped_++;
+        }
+        if (entry.pending == 0) removeAt(i);
+        dirty_ = true;
+        return;
+    }
+}
+
+UploadQueue::Backoff UploadQueue::getBackoff(Target target) const {
+    MutexGuard guard(mutex_, "upload_queue_mutex", 100);
+    return guard.isLocked() ? data_.backoff[indexOf(target)] : Backoff{};
+}
+
+void UploadQueue::setBackoff(Target target, const Backoff& backoff) {
+    MutexGuard guard(mutex_, "upload_queue_mutex", 100);
+    if (!guard.isLocked()) return;
+
+    Backoff& current = data_.backoff[indexOf(target)];
+    if (current.retry_at_epoch == backoff.retry_at_epoch && current.failures == backoff.failures) {
+        return;
+    }
+    current = backoff;
+    dirty_ = true;
+}
+
+bool UploadQueue::commit() {
+    MutexGuard guard(mutex_, "upload_queue_mutex", 100);
+    if (!guard.isLocked()) return false;
+    return dirty_ ? save() : true;
+}
+
+void UploadQueue::clear() {
+    MutexGuard guard(mutex_, "upload_queue_mutex", 100);
+    if (!guard.isLocked()) return;
+
+    data_.count = 0;
+    memset(data_.backoff, 0, sizeof(data_.backoff));
+    if (initialized_) save();
+}
+
+// ============================================================================
+// Private (mutex held)
+// ============================================================================
+
+bool UploadQueue::save() {
+    size_t len = offsetof(Stored, entries) + data_.count * sizeof(Entry);
+    if (prefs_.putBytes(KEY, &data_, len) != len) {
+        Serial.println("[UploadQueue] ERROR: Failed to write queue to NVS");
+        return false;
+    }
+    dirty_ = false;
+    return true;
+}
+
+void UploadQueue::removeAt(size_t index) {
+    memmove(&data_.entries[index], &data_.entries[index + 1],
+            (data_.count - index - 1) * sizeof(Entry));
+    data_.count--;
+}
+
+size_t UploadQueue::indexOf(Target target) {
+    return target == GCAL ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+#ifndef UPLOAD_QUEUE_H
+#define UPLOAD_QUEUE_H
+
+#include "../utils/NvsPreferences.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Persistent queue of completed sessions waiting for upload
+ *
+ * Filled from the UI core when a session completes, drained by the session
+ * uploader on the network core; all access is under one mutex. Each entry
+ * carries a bit per target (Toggl, Google Calendar) still to be uploaded
+ * and leaves the queue when all its bits are cleared or after
+ * MAX_ATTEMPTS failed uploads.
+ *
+ * Storage: one NVS blob (namespace "uploadq") with the entries and the
+ * per-target retry backoff, so pending uploads and backoff survive reboots
+ * and deep sleep. push() writes it (one write per session); the uploader's
+ * changes are written once per sync window by commit().
+ *
+ * Full queue: the oldest entry is dropped.
+ */
+class UploadQueue {
+public:
+    static constexpr size_t CAPACITY = 32;
+    static constexpr uint8_t MAX_ATTEMPTS = 10;
+
+    enum Target : uint8_t {
+        TOGGL = 0x01,
+        GCAL = 0x02,
+    };
+    static constexpr size_t TARGET_COUNT = 2;
+
+    struct Entry {
+        uint32_t id;             // Unique, increasing
+        uint32_t end_epoch;      // Session end (UTC)
+        uint16_t duration_s;     // Timed duration (start = end - duration)
+        uint8_t session_type;    // PomodoroSequence::SessionType
+        uint8_t session_number;
+        uint8_t pending;         // Target bits still to upload
+        uint8_t attempts;        // Failed upload attempts
+        uint8_t reserved[2];
+    };
+
+    struct Backoff {
+        uint32_t retry_at_epoch; // No upload before (0 = now)
+        uint8_t failures;        // Consecutive failed windows
+        uint8_t reserved[3];
+    };
+
+    UploadQueue();
+    ~UploadQueue();
+
+    /**
+     * Open NVS and load the stored queue
+     */
+    bool begin();
+
+    /**
+     * Append a session for the given targets and persist
+     * @return false if not started or targets is 0
+     */
+    bool push(uint32_t end_epoch, uint16_t duration_s, uint8_t session_type,
+              uint8_t session_number, uint8_t targets);
+
+    /**
+     * Copy of the queued entries, oldest first
+     * @return number of entries copied
+     */
+    size_t snapshot(Entry* out, size_t max) const;
+
+    size_t size() const;
+    size_t pendingFor(Target target) const;
+
+    /**
+     * Record an upload result (entry may have been dropped meanwhile)
+     * @param done Targets uploaded (or permanently rejected)
+     * @param failed Targets that failed and will be retried
+     */
+    void settle(uint32_t id, uint8_t done, uint8_t failed);
+
+    Backoff getBackoff(Target target) const;
+    void setBackoff(Target target, const Backoff& backoff);
+
+    /**
+     * Persist changes made by settle()/setBackoff()
+     */
+    bool commit();
+
+    void clear();
+
+    uint32_t getDropped() const { return dropped_; }
+
+private:
+    static constexpr const char* NAMESPACE = "uploadq";
+    static constexpr const char* KEY = "queue";
+    static constexpr uint8_t VERSION = 1;
+
+    struct Stored {
+        uint8_t version;
+        uint8_t count;
+        uint8_t reserved[2];
+        uint32_t next_id;
+        Backoff backoff[TARGET_COUNT];
+        Entry entries[CAPACITY];   // Only count entries are written
+    };
+
+    NvsPreferences prefs_;
+    bool initialized_;
+    bool dirty_;
+    uint32_t dropped_;
+    Stored data_;
+    SemaphoreHandle_t mutex_;
+
+    bool save();
+    void removeAt(size_t index);
+    static size_t indexOf(Target target);
+};
+
+#endif // UPLOAD_QUEUE_H
@@ -0,0 +1,32 @@
+#include "HttpTask.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include "../network/HttpServer.h"
+
+static constexpr uint16_t HTTP_PORT = 80;
+static constexpr uint32_t POLL_TIMEOUT_MS = 100;      // select() wait per loop
+static constexpr uint32_t OFFLINE_CHECK_MS = 1000;    // WiFi down: check again
+
+void httpTask(void* parameter) {
+    HttpServer* server = static_cast<HttpServer*>(parameter);
+    Serial.printf("[HttpTask] Starting on Core %d\n", xPortGetCoreID());
+
+    while (true) {
+        bool online = WiFi.status() == WL_CONNECTED;
+
+        if (online && !server->isListening()) {
+            if (server->begin(HTTP_PORT)) {
+                Serial.printf("[HttpTask] Dashboard at http://%s/\n",
+                              WiFi.localIP().toString().c_str());
+            }
+        } else if (!online && server->isListening()) {
+            server->end();
+        }
+
+        if (server->isListening()) {
+            server->poll(POLL_TIMEOUT_MS);
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(OFFLINE_CHECK_MS));
+        }
+    }
+}
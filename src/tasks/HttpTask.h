@@ -0,0 +1,36 @@
+#ifndef HTTP_TASK_H
+#define HTTP_TASK_H
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * HTTP dashboard task for Core 1 (APP_CPU)
+ *
+ * Runs the dashboard HttpServer: listens on port 80 while WiFi is
+ * connected (stops when it drops) and serves from poll(), which sleeps in
+ * select() until a client needs attention. Kept off Core 0 so serving
+ * never competes with UI frames.
+ *
+ * The task never brings WiFi up itself: STA is only connected during the
+ * boot NTP sync and the upload task's sync windows, so the dashboard is
+ * reachable then and not in between. Keeping STA associated for it would
+ * cost the radio's idle current around the clock, which is why the
+ * dashboard is opt-in (network.dashboard_enabled, off by default).
+ *
+ * Usage:
+ *   xTaskCreatePinnedToCore(
+ *       httpTask,        // Task function
+ *       "http_task",     // Task name
+ *       6144,            // Stack size (6KB)
+ *       g_httpServer,    // Parameter: HttpServer* with routes registered
+ *       1,               // Priority (same as UI)
+ *       NULL,            // Task handle
+ *       1                // Core 1 (APP_CPU)
+ *   );
+ *
+ * @param parameter HttpServer* to run
+ */
+void httpTask(void* parameter);
+
+#endif // HTTP_TASK_H
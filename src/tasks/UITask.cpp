@@ -8,6 +8,22 @@
 #include "../core/Config.h"
 #include "../core/SleepState.h"
 #include "../hardware/IPowerManager.h"
+#include "../hardware/PowerTelemetry.h"
+#include "../utils/AllocTracker.h"
+#include "../utils/NvsAccounting.h"
+#include "../utils/StackProfiler.h"
+#include "../utils/PCSampler.h"
+#include "../utils/InputTrace.h"
+#include "../utils/FrameStallDetector.h"
+#include "../utils/EnergyProfiler.h"
+#include "../utils/AudioLatency.h"
+#include "../hardware/SDManager.h"
+#include "../hardware/SDWorker.h"
+#include "../hardware/SDLogWriter.h"
+#include "../hardware/SoundLibrary.h"
+#include "../network/HttpServer.h"
+#include "../network/SessionUploader.h"
+#include <time.h>
 
 /**
  * UI Task (Core 0 - Protocol CPU)
@@ -45,12 +61,24 @@ extern PomodoroSequence* g_sequence;
 extern TimeManager* g_timeManager;
 extern Config* g_config;
 extern IPowerManager* g_powerManager;
+extern PowerTelemetry* g_powerTelemetry;
+extern SDManager* g_sdManager;
+extern SDWorker* g_sdWorker;
+extern SoundLibrary* g_soundLibrary;
+extern HttpServer* g_httpServer;
+extern SessionUploader* g_sessionUploader;
 
 // Task timing
 static uint32_t g_lastUpdate = 0;
 static uint32_t g_lastSecond = 0;
 static uint32_t g_lastTaskMonitor = 0;  // MP-47: Task monitoring
-static uint8_t g_last_valid_battery = 100;
+static uint32_t g_lastTraceFlush = 0;   // Input trace SD flush
+static SDLogWriter* g_traceLog = nullptr;   // Input trace file (serviced by the SD worker)
+static constexpr uint32_t TRACE_FLUSH_INTERVAL_MS = 10000;
+#if ENERGY_PROFILING
+static uint32_t g_energyBusyUs = 0;      // UI loop time outside vTaskDelay this second
+static uint32_t g_energyWindowUs = 0;    // Start of the busy measurement window
+#endif
 
 // Idle tracking for sleep mode (MP-30)
 static uint32_t g_lastInteraction = 0;  // Last user interaction timestamp
@@ -63,11 +91,38 @@ void uiTask(void* parameter) {
     Serial.printf("[UITask] Priority: %d\n", uxTaskPriorityGet(NULL));
     Serial.printf("[UITask] Stack size: %d bytes\n", uxTaskGetStackHighWaterMark(NULL) * 4);
 
+#if PC_SAMPLING
+    // Profiling build: sample this core's PCs (timer interrupt allocated on Core 0)
+    PCSampler::begin();
+#endif
+
+#if FRAME_STALL_DETECT
+    // Profiling build: frame heartbeats watched from Core 1, backtrace on overrun
+    FrameStallDetector::begin();
+    FrameStallDetector::startMonitor(1);
+#endif
+
+#if INPUT_TRACE
+    // Trace build: record inputs for host replay (file named after wall clock)
+    InputTrace::begin(static_cast<uint32_t>(time(nullptr)));
+    if (g_sdManager && g_sdWorker) {
+        SDLogWriter::Options trace_options;
+        trace_options.max_file_bytes = 4 * 1024 * 1024;   // ~500k events per file
+        g_traceLog = new SDLogWriter(*g_sdManager, InputTrace::getPath(), trace_options);
+        g_sdWorker->attach(g_traceLog);
+    }
+#endif
+
     g_lastUpdate = millis();
     g_lastSecond = millis();
     g_lastInteraction = millis();  // Initialize idle tracking
 
     while (true) {
+        STALL_FRAME_BEGIN();
+#if ENERGY_PROFILING
+        uint32_t frame_start_us = micros();
+#endif
+
         // Poll M5 hardware (touch, buttons, I2C sensors)
         M5.update();
 
@@ -96,14 +151,18 @@ void uiTask(void* parameter) {
 
         if (deltaMs >= 33) {
             g_lastUpdate = now;
+            ALLOC_SCOPE(UI_FRAME);  // Frame path catch-all (nested scopes refine it)
 
             // Update ScreenManager (which updates active screen)
+            STALL_PHASE(SCREEN_UPDATE);
             g_screenManager->update(deltaMs);
 
             // Update audio player (track playing state)
+            STALL_PHASE(AUDIO);
             g_audioPlayer->update();
 
             // Update LED controller (animate patterns - MP-23)
+            STALL_PHASE(LEDS);
             g_ledController->update();
 
             // MP-27: If milestone ended and LED is OFF, refresh pattern based on timer state
@@ -124,30 +183,31 @@ void uiTask(void* parameter) {
             }
 
             // Update haptic controller (state machine for rhythm patterns - MP-27)
+            STALL_PHASE(HAPTIC);
             g_hapticController->update();
 
             // Draw active screen
+            STALL_PHASE(DRAW);
             g_screenManager->draw(*g_renderer);
 
             // Push to display
+            STALL_PHASE(PUSH);
             g_renderer->update();
         }
 
+        // Power telemetry: one PMIC burst when the adaptive interval is due
+        STALL_PHASE(STATUS);
+        g_powerTelemetry->poll(now);
+
         // Update status bar every second
         if (now - g_lastSecond >= 1000) {
             g_lastSecond = now;
+            STALL_PHASE(STATUS);
 
-            // Update battery and time (with validation to avoid 0% glitches)
-            uint8_t battery = M5.Power.getBatteryLevel();
-
-            // Validate battery reading (M5.Power can return 0 on I2C glitches)
-            if (battery == 0 || battery > 100) {
-                battery = g_last_valid_battery;  // Use last known good value
-            } else {
-                g_last_valid_battery = battery;
-            }
-
-            bool charging = M5.Power.isCharging();
+            // Battery from cached telemetry (glitch readings filtered there)
+            PowerTelemetry::Snapshot power = g_powerTelemetry->getSnapshot();
+            uint8_t battery = power.level;
+            bool charging = power.charging;
 
             // Get actual time from TimeManager (RTC + NTP)
             uint8_t hour = 0, minute = 0;
@@ -156,6 +216,15 @@ void uiTask(void* parameter) {
                 g_timeManager->getLocalTime(timeinfo);
                 hour = timeinfo.tm_hour;
                 minute = timeinfo.tm_min;
+
+                // Midnight reset of the "completed today" counter, only on trusted time:
+                // a default/SD fallback date jumps when NTP corrects it, which is not a midnight
+                TimeManager::TimeSource source = g_timeManager->getTimeSource();
+                bool time_valid = g_timeManager->isTimeSynced() || source == TimeManager::TimeSource::RTC;
+                if (time_valid && g_timeManager->isMidnightCrossed()) {
+                    Serial.printf("[UITask] New day, %u completed yesterday\n", g_sequence->getCompletedToday());
+                    g_sequence->resetDailyCounter();
+                }
             }
 
             // Check WiFi status - show connected if:
@@ -177,11 +246,36 @@ void uiTask(void* parameter) {
             }
 
             g_screenManager->updateStatus(battery, charging, wifi_status, mode, hour, minute);
+
+#if ENERGY_PROFILING
+            // Once-per-second subsystem levels (LEDs, speaker, haptic report on change)
+            uint32_t now_us = micros();
+            uint32_t window_us = now_us - g_energyWindowUs;
+            if (g_energyWindowUs != 0 && window_us > 0) {
+                ENERGY_ACTIVITY(CPU, static_cast<float>(g_energyBusyUs) / window_us);
+            }
+            g_energyBusyUs = 0;
+            g_energyWindowUs = now_us;
+            ENERGY_ACTIVITY(BACKLIGHT, M5.Display.getBrightness() / 255.0f);
+            ENERGY_ACTIVITY(WIFI, WiFi.getMode() != WIFI_OFF ? 1.0f : 0.0f);
+            EnergyProfiler::setTimerState(static_cast<uint8_t>(state), now);
+#endif
         }
 
+#if INPUT_TRACE
+        // Hand recorded inputs to the trace log (RAM copy, the SD worker writes it)
+        if (g_traceLog && (now - g_lastTraceFlush >= TRACE_FLUSH_INTERVAL_MS ||
+                            InputTrace::getStats().pending >= InputTrace::BUFFER_RECORDS / 2)) {
+            g_lastTraceFlush = now;
+            STALL_PHASE(TRACE_FLUSH);
+            InputTrace::flushTo(*g_traceLog);
+        }
+#endif
+
         // Task monitoring (MP-47): Print task statistics every 30 seconds
         if (now - g_lastTaskMonitor >= 30000) {
             g_lastTaskMonitor = now;
+            STALL_PHASE(MONITOR);
 
             Serial.println("\n=== FreeRTOS Task Monitor (MP-47) ===");
             Serial.printf("Uptime: %lu seconds\n", now / 1000);
@@ -189,30 +283,68 @@ void uiTask(void* parameter) {
             Serial.printf("Free PSRAM: %u bytes\n", ESP.getFreePsram());
             Serial.printf("Total tasks: %u\n", uxTaskGetNumberOfTasks());
 
-            // Print key task information
-            extern TaskHandle_t g_uiTaskHandle;
-            extern TaskHandle_t g_networkTaskHandle;
+            // Per-task stack usage (measured worst case + recommended size)
+            StackProfiler::sampleAll();
+            StackProfiler::printReport();
+            StackProfiler::saveIfChanged();
 
-            Serial.println("\nKey Tasks:");
-            if (g_uiTaskHandle) {
-                Serial.printf("  ui_task (Core 0):      Stack free=%u bytes, Priority=%u\n",
-                             uxTaskGetStackHighWaterMark(g_uiTaskHandle) * 4,
-                             uxTaskPriorityGet(g_uiTaskHandle));
+            if (g_sdWorker) {
+                g_sdWorker->printStats();
+            }
+            if (g_soundLibrary) {
+                g_soundLibrary->printStats();
             }
-            if (g_networkTaskHandle) {
-                Serial.printf("  network_task (Core 1): Stack free=%u bytes, Priority=%u\n",
-                             uxTaskGetStackHighWaterMark(g_networkTaskHandle) * 4,
-                             uxTaskPriorityGet(g_networkTaskHandle));
+            if (g_httpServer) {
+                g_httpServer->printStats();
             }
+            if (g_sessionUploader) {
+                g_sessionUploader->printStats();
+            }
+            g_powerTelemetry->printStats();
 
             Serial.println("\nSync Status:");
             Serial.println("  Mutexes: No timeouts detected");
             Serial.println("  Queues: Active (network status messages)");
             Serial.println("  Both cores running: YES");
             Serial.println("=========================================\n");
+
+#if ALLOC_TRACKING
+            AllocTracker::printReport();
+#endif
+
+#if NVS_ACCOUNTING
+            NvsAccounting::printReport();
+#endif
+
+#if PC_SAMPLING
+            PCSampler::printReport();
+#endif
+
+#if FRAME_STALL_DETECT
+            FrameStallDetector::printReport();
+#endif
+
+#if ENERGY_PROFILING
+            EnergyProfiler::printReport();
+#endif
+
+#if AUDIO_LATENCY_TRACE
+            AudioLatency::printReport();
+#endif
+
+#if INPUT_TRACE
+            InputTrace::Stats trace = InputTrace::getStats();
+            Serial.printf("[InputTrace] %lu events, %lu dropped, %lu bytes, %lu write errors -> %s\n",
+                          trace.recorded, trace.dropped, trace.flushed_bytes,
+                          trace.write_errors, InputTrace::getPath());
+            if (g_traceLog) {
+                g_traceLog->printStats();
+            }
+#endif
         }
 
         // MP-30: Check sleep conditions (adaptive: light sleep <30min, deep sleep >=30min)
+        STALL_PHASE(SLEEP_CHECK);
         auto power_settings = g_config->getPower();
         if (power_settings.auto_sleep_enabled && power_settings.sleep_after_min > 0) {
             // Calculate idle duration
@@ -228,7 +360,7 @@ void uiTask(void* parameter) {
 
                 if (sleep_eligible) {
                     // Check DC power condition (skip sleep if charging and configured)
-                    bool is_charging = M5.Power.isCharging();
+                    bool is_charging = g_powerTelemetry->isCharging();
                     bool skip_sleep = is_charging && !power_settings.sleep_on_dc_power;
 
                     if (!skip_sleep) {
@@ -246,12 +378,20 @@ void uiTask(void* parameter) {
                         // Save state to RTC memory
                         SleepState::save(*g_stateMachine, *g_sequence, led_pattern);
 
+#if INPUT_TRACE
+                        if (g_traceLog) InputTrace::flushTo(*g_traceLog);
+#endif
+                        // Queued SD writes (trace, time backup) must land before power-down
+                        if (g_sdWorker) g_sdWorker->flush(2000);
+
                         // Power down LEDs (clear + disable 5V boost)
                         g_ledController->powerDown();
                         delay(100);  // Wait for power to stabilize
 
                         // Enter deep sleep (device will reset on wake)
-                        g_powerManager->enterDeepSleep(0);  // Infinite sleep, wake on touch
+                        g_powerManager->setMotionPolling(power_settings.wake_on_rotation,
+                                                         power_settings.motion_poll_interval_s);
+                        g_powerManager->enterDeepSleep(0);  // Infinite sleep, wake on touch (or motion poll)
 
                         // Note: Code never reaches here (ESP32 resets on wake)
                     } else {
@@ -263,6 +403,10 @@ void uiTask(void* parameter) {
         }
 
         // Small delay to prevent watchdog and allow other tasks to run
+        STALL_FRAME_END();
+#if ENERGY_PROFILING
+        g_energyBusyUs += micros() - frame_start_us;
+#endif
         vTaskDelay(pdMS_TO_TICKS(1));
     }
 }
@@ -0,0 +1,60 @@
+#include "UploadTask.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <sys/time.h>
+#include "../core/NetworkConfig.h"
+#include "../network/SessionUploader.h"
+
+extern NetworkConfig* g_networkConfig;   // Defined in main.cpp
+
+static constexpr uint32_t CHECK_INTERVAL_MS = 1000;    // Queue / backoff check
+static constexpr uint32_t WIFI_TIMEOUT_MS = 15000;
+
+static bool wifiUp() {
+    const NetworkConfig::WiFiSettings& wifi = g_networkConfig->getWiFi();
+    Serial.printf("[UploadTask] Connecting to WiFi: %s\n", wifi.ssid);
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(wifi.ssid, wifi.password);
+
+    uint32_t start_ms = millis();
+    while (WiFi.status() != WL_CONNECTED && millis() - start_ms < WIFI_TIMEOUT_MS) {
+        vTaskDelay(pdMS_TO_TICKS(250));
+    }
+    return WiFi.status() == WL_CONNECTED;
+}
+
+void uploadTask(void* parameter) {
+    SessionUploader* uploader = static_cast<SessionUploader*>(parameter);
+    uint32_t interval_ms = g_networkConfig->getCloudSync().sync_interval_min * 60000UL;
+    Serial.printf("[UploadTask] Starting on Core %d (sync every %lu min)\n",
+                  xPortGetCoreID(), (unsigned long)(interval_ms / 60000));
+
+    // First window one interval after boot, so sessions of a short run batch up
+    uint32_t last_window_ms = millis();
+
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(CHECK_INTERVAL_MS));
+
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        uint32_t now_epoch = static_cast<uint32_t>(now.tv_sec);
+        if (millis() - last_window_ms < interval_ms || !uploader->isDue(now_epoch)) {
+            continue;
+        }
+        last_window_ms = millis();
+
+        // Wake window: radio on only for the uploads unless something else holds it
+        bool own_wifi = WiFi.status() != WL_CONNECTED;
+        if (own_wifi && !wifiUp()) {
+            Serial.println("[UploadTask] WiFi connection failed, next window later");
+            WiFi.disconnect(true);
+            continue;
+        }
+
+        uploader->runWindow(now_epoch);
+
+        if (own_wifi) {
+            WiFi.disconnect(true);
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef UPLOAD_TASK_H
+#define UPLOAD_TASK_H
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * Toggl / Google Calendar upload task for Core 1 (APP_CPU)
+ *
+ * Opens a sync window every CloudSync SyncIntervalMin (network.ini) when
+ * the SessionUploader has sessions due: brings WiFi up if it is off
+ * (credentials from g_networkConfig), runs the window, and turns WiFi off
+ * again if it was the one to bring it up. Between windows the task only
+ * wakes once a second to check the queue.
+ *
+ * Usage:
+ *   xTaskCreatePinnedToCore(
+ *       uploadTask,        // Task function
+ *       "upload_task",     // Task name
+ *       8192,              // Stack size (8KB, TLS handshake)
+ *       g_sessionUploader, // Parameter: configured SessionUploader*
+ *       1,                 // Priority (same as UI)
+ *       NULL,              // Task handle
+ *       1                  // Core 1 (APP_CPU)
+ *   );
+ *
+ * @param parameter SessionUploader* to run
+ */
+void uploadTask(void* parameter);
+
+#endif // UPLOAD_TASK_H
@@ -0,0 +1,154 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <array>
+#include <initializer_list>
+#include <stddef.h>
+#include <stdint.h>
+#include "Renderer.h"
+
+/**
+ * Compile-time screen layout
+ *
+ * Screens declare their widget boxes as constexpr tables built from these
+ * helpers, so positions, hit-test rectangles and dirty regions are resolved
+ * by the compiler; constructors and draw code only read constants.
+ * Overlaps and boxes leaving their area are caught with static_assert next
+ * to the table.
+ *
+ * Usage:
+ *   struct Layout {
+ *       static constexpr auto ROWS = layout::column(10, 50, 300, {{32, 10}, {20, 10}});
+ *   };
+ *   static_assert(layout::disjoint(Layout::ROWS), "Rows overlap");
+ *   static_assert(layout::inside(layout::CONTENT, Layout::ROWS), "Rows leave the content area");
+ *   slider_.setBounds(Layout::ROWS[0]);
+ */
+namespace layout {
+
+struct Box {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+
+    constexpr int16_t right() const { return x + w; }
+    constexpr int16_t bottom() const { return y + h; }
+    constexpr int16_t centerX() const { return x + w / 2; }
+    constexpr int16_t centerY() const { return y + h / 2; }
+
+    constexpr bool contains(int16_t px, int16_t py) const {
+        return px >= x && px < x + w && py >= y && py < y + h;
+    }
+    constexpr bool overlaps(const Box& other) const {
+        return x < other.right() && other.x < right() && y < other.bottom() && other.y < bottom();
+    }
+    constexpr bool inside(const Box& area) const {
+        return x >= area.x && y >= area.y && right() <= area.right() && bottom() <= area.bottom();
+    }
+
+    constexpr operator Renderer::Rect() const { return Renderer::Rect{x, y, w, h}; }
+};
+
+// Box of width w / height h centered horizontally in area, starting at y
+constexpr Box centeredX(const Box& area, int16_t y, int16_t w, int16_t h) {
+    return Box{static_cast<int16_t>(area.x + (area.w - w) / 2), y, w, h};
+}
+
+// Box of height h vertically centered between top and bottom
+constexpr Box centeredY(int16_t x, int16_t top, int16_t bottom, int16_t w, int16_t h) {
+    return Box{x, static_cast<int16_t>(top + (bottom - top) / 2 - h / 2), w, h};
+}
+
+// Box of height h directly below another, after gap
+constexpr Box below(const Box& above, int16_t gap, int16_t x, int16_t w, int16_t h) {
+    return Box{x, static_cast<int16_t>(above.bottom() + gap), w, h};
+}
+
+// Vertical stack: each row is height + gap to the next (CSS-style margin-bottom)
+struct Row {
+    int16_t height;
+    int16_t gap_after;
+};
+
+template <size_t N>
+constexpr std::array<Box, N> column(int16_t x, int16_t y, int16_t w, const Row (&rows)[N]) {
+    std::array<Box, N> result{};
+    for (size_t i = 0; i < N; i++) {
+        result[i] = Box{x, y, w, rows[i].height};
+        y = static_cast<int16_t>(y + rows[i].height + rows[i].gap_after);
+    }
+    return result;
+}
+
+// Horizontal row of N equal boxes with gap between them
+template <size_t N>
+constexpr std::array<Box, N> spread(int16_t x, int16_t y, int16_t w, int16_t h, int16_t gap) {
+    std::array<Box, N> result{};
+    for (size_t i = 0; i < N; i++) {
+        result[i] = Box{static_cast<int16_t>(x + i * (w + gap)), y, w, h};
+    }
+    return result;
+}
+
+template <size_t N>
+constexpr int16_t bottomOf(const std::array<Box, N>& boxes) {
+    int16_t bottom = 0;
+    for (size_t i = 0; i < N; i++) {
+        if (boxes[i].bottom() > bottom) bottom = boxes[i].bottom();
+    }
+    return bottom;
+}
+
+// No two boxes share a pixel
+constexpr bool disjoint(std::initializer_list<Box> boxes) {
+    for (const Box* a = boxes.begin(); a != boxes.end(); ++a) {
+        for (const Box* b = a + 1; b != boxes.end(); ++b) {
+            if (a->overlaps(*b)) return false;
+        }
+    }
+    return true;
+}
+
+template <size_t N>
+constexpr bool disjoint(const std::array<Box, N>& boxes) {
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = i + 1; j < N; j++) {
+            if (boxes[i].overlaps(boxes[j])) return false;
+        }
+    }
+    return true;
+}
+
+// Every box lies within area
+constexpr bool inside(const Box& area, std::initializer_list<Box> boxes) {
+    for (const Box& box : boxes) {
+        if (!box.inside(area)) return false;
+    }
+    return true;
+}
+
+template <size_t N>
+constexpr bool inside(const Box& area, const std::array<Box, N>& boxes) {
+    for (size_t i = 0; i < N; i++) {
+        if (!boxes[i].inside(area)) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Shared screen frame (320×240, status bar on top, hardware button bar below)
+// ============================================================================
+
+constexpr Box SCREEN = {0, 0, 320, 240};
+constexpr Box STATUS_BAR = {0, 0, 320, 20};
+constexpr Box BUTTON_BAR = {0, 218, 320, 22};                 // HardwareButtonBar (ScreenManager)
+constexpr Box CONTENT = {0, STATUS_BAR.bottom(), 320,
+                         static_cast<int16_t>(BUTTON_BAR.y - STATUS_BAR.bottom())};
+
+static_assert(disjoint({STATUS_BAR, CONTENT, BUTTON_BAR}), "Screen frame overlaps");
+static_assert(BUTTON_BAR.bottom() == SCREEN.bottom(), "Button bar must end at the bottom edge");
+
+}  // namespace layout
+
+#endif // LAYOUT_H
@@ -1,17 +1,19 @@
 #include "Renderer.h"
+#include "../utils/AllocTracker.h"
+#include "../utils/Placement.h"
 #include <Arduino.h>
 
 // Rect helper methods
-bool Renderer::Rect::intersects(const Rect& other) const {
+bool HOT_IRAM Renderer::Rect::intersects(const Rect& other) const {
     return !(x + w < other.x || other.x + other.w < x ||
              y + h < other.y || other.y + other.h < y);
 }
 
-bool Renderer::Rect::contains(int16_t px, int16_t py) const {
+bool HOT_IRAM Renderer::Rect::contains(int16_t px, int16_t py) const {
     return (px >= x && px < x + w && py >= y && py < y + h);
 }
 
-void Renderer::Rect::merge(const Rect& other) {
+void HOT_IRAM Renderer::Rect::merge(const Rect& other) {
     int16_t x2 = max(x + w, other.x + other.w);
     int16_t y2 = max(y + h, other.y + other.h);
     x = min(x, other.x);
@@ -68,7 +70,7 @@ bool Renderer::begin() {
     Serial.printf("[Renderer] Sprite buffer created at %p\n", sprite_buffer);
 
     // Verify buffer is in PSRAM (PSRAM addresses: 0x3F800000-0x3FC00000)
-    if ((uint32_t)sprite_buffer >= 0x3F800000 && (uint32_t)sprite_buffer < 0x3FC00000) {
+    if ((uintptr_t)sprite_buffer >= 0x3F800000 && (uintptr_t)sprite_buffer < 0x3FC00000) {
         Serial.println("[Renderer] ✓ Buffer successfully allocated in PSRAM");
     } else {
         Serial.printf("[Renderer] WARNING: Buffer at %p is NOT in PSRAM (heap)\n", sprite_buffer);
@@ -132,7 +134,8 @@ void Renderer::update() {
     }
 }
 
-void Renderer::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+void HOT_IRAM Renderer::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+    ALLOC_SCOPE(RENDERER);
     // Clip to screen bounds
     if (x < 0) { w += x; x = 0; }
     if (y < 0) { h += y; y = 0; }
@@ -152,15 +155,14 @@ void Renderer::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
     }
 
     // Add as new dirty rectangle
-    if (dirty_rects.size() < MAX_DIRTY_RECTS) {
-        dirty_rects.push_back(rect);
-    } else {
+    if (!dirty_rects.push_back(rect)) {
         // Too many dirty rects, mark full screen
         markFullScreenDirty();
     }
 }
 
 void Renderer::markFullScreenDirty() {
+    ALLOC_SCOPE(RENDERER);
     dirty_rects.clear();
     dirty_rects.push_back({0, 0, SCREEN_WIDTH, SCREEN_HEIGHT});
 }
@@ -192,6 +194,17 @@ void Renderer::drawString(int16_t x, int16_t y, const char* text, const lgfx::IF
     markDirty(x - text_w / 2, y - text_h / 2, text_w, text_h);
 }
 
+void Renderer::drawString(int16_t x, int16_t y, const char* text, const lgfx::IFont* font, Color color,
+                          const Rect& dirty) {
+    if (font) {
+        canvas.setFont(font);
+    }
+
+    canvas.setTextColor(color.rgb565);
+    canvas.drawString(text, x, y);
+    markDirty(dirty.x, dirty.y, dirty.w, dirty.h);
+}
+
 void Renderer::drawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Color color) {
     canvas.drawLine(x1, y1, x2, y2, color.rgb565);
 
@@ -252,7 +265,7 @@ int16_t Renderer::fontHeight(const lgfx::IFont* font) {
 
 // Private methods
 
-void Renderer::optimizeDirtyRects() {
+void HOT_IRAM Renderer::optimizeDirtyRects() {
     if (dirty_rects.size() <= 1) {
         return;  // Nothing to optimize
     }
@@ -266,7 +279,7 @@ void Renderer::optimizeDirtyRects() {
             for (size_t j = i + 1; j < dirty_rects.size(); j++) {
                 if (dirty_rects[i].intersects(dirty_rects[j])) {
                     dirty_rects[i].merge(dirty_rects[j]);
-                    dirty_rects.erase(dirty_rects.begin() + j);
+                    dirty_rects.eraseUnordered(j);   // Order is irrelevant for pushing
                     merged = true;
                     break;
                 }
@@ -276,7 +289,7 @@ void Renderer::optimizeDirtyRects() {
     }
 }
 
-bool Renderer::shouldFullRefresh() const {
+bool HOT_IRAM Renderer::shouldFullRefresh() const {
     if (dirty_rects.size() == 1 &&
         dirty_rects[0].w == SCREEN_WIDTH &&
         dirty_rects[0].h == SCREEN_HEIGHT) {
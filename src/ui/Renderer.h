@@ -2,7 +2,7 @@
 #define RENDERER_H
 
 #include <M5Unified.h>
-#include <vector>
+#include "../utils/FixedContainers.h"
 
 /**
  * Rendering engine with double-buffered canvas and dirty rectangle optimization
@@ -58,10 +58,14 @@ public:
     void markFullScreenDirty();
     void clearDirty();
     bool isDirty() const { return !dirty_rects.empty(); }
+    size_t getDirtyRectCount() const { return dirty_rects.size(); }   // Pending until update()
 
     // Drawing primitives
     void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, Color color, bool filled = false);
     void drawString(int16_t x, int16_t y, const char* text, const lgfx::IFont* font, Color color);
+    // Fixed text box (compile-time layout): marks dirty without measuring the text
+    void drawString(int16_t x, int16_t y, const char* text, const lgfx::IFont* font, Color color,
+                    const Rect& dirty);
     void drawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Color color);
     void drawCircle(int16_t x, int16_t y, int16_t radius, Color color, bool filled = false);
     void drawTriangle(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, Color color, bool filled = false);
@@ -79,10 +83,14 @@ public:
     // Constants
     static constexpr int16_t SCREEN_WIDTH = 320;
     static constexpr int16_t SCREEN_HEIGHT = 240;
+    static constexpr uint8_t MAX_DIRTY_RECTS = 10;   // More marks are merged
 
 private:
+    // Dirty rectangle optimization
+    static constexpr float FULL_SCREEN_THRESHOLD = 0.5f;  // 50% coverage = full refresh
+
     LGFX_Sprite canvas;
-    std::vector<Rect> dirty_rects;
+    StaticVector<Rect, MAX_DIRTY_RECTS> dirty_rects;   // Inline, no heap in the frame loop
 
     // Performance tracking
     uint32_t last_update_time = 0;
@@ -90,10 +98,6 @@ private:
     uint32_t frame_count = 0;
     float current_fps = 0.0f;
 
-    // Dirty rectangle optimization
-    static constexpr uint8_t MAX_DIRTY_RECTS = 10;
-    static constexpr float FULL_SCREEN_THRESHOLD = 0.5f;  // 50% coverage = full refresh
-
     // Helper methods
     void optimizeDirtyRects();
     bool shouldFullRefresh() const;
@@ -1,5 +1,7 @@
 #include "ScreenManager.h"
+#include "Layout.h"
 #include "../core/SyncPrimitives.h"
+#include "../utils/InputTrace.h"
 #include <M5Unified.h>
 
 ScreenManager::ScreenManager(TimerStateMachine& state_machine,
@@ -28,7 +30,7 @@ ScreenManager::ScreenManager(TimerStateMachine& state_machine,
       ntp_synced_(false) {
 
     // Configure hardware button bar
-    button_bar_.setBounds(0, 218, 320, 22);
+    button_bar_.setBounds(layout::BUTTON_BAR.x, layout::BUTTON_BAR.y, layout::BUTTON_BAR.w, layout::BUTTON_BAR.h);
     updateButtonLabels();  // Set initial labels for MainScreen
 
     Serial.println("[ScreenManager] Initialized with 4 screens");
@@ -112,6 +114,9 @@ void ScreenManager::update(uint32_t deltaMs) {
     // Check for network status updates from Core 1 (MP-47)
     handleNetworkStatus();
 
+    // Advance the timer whichever screen is shown (it kept still on Stats/Settings)
+    state_machine_.update(deltaMs);
+
     // Check for state-driven auto-navigation (PAUSED <-> MainScreen)
     checkAutoNavigation();
 
@@ -154,6 +159,12 @@ void ScreenManager::draw(Renderer& renderer) {
 }
 
 void ScreenManager::handleTouch(int16_t x, int16_t y, bool pressed) {
+    if (pressed) {
+        INPUT_TRACE_RECORD(TOUCH_DOWN, 0, x, y);
+    } else {
+        INPUT_TRACE_RECORD(TOUCH_UP, 0, x, y);
+    }
+
     // Forward touch events to active screen
     switch (current_screen_) {
         case ScreenID::MAIN:
@@ -187,6 +198,7 @@ void ScreenManager::handleHardwareButtons() {
 
     if (M5.BtnA.wasPressed()) {
         Serial.println("[ScreenManager] BtnA pressed");
+        INPUT_TRACE_RECORD(BUTTON, InputTrace::BUTTON_A, 0, 0);
         haptic_controller_.trigger(IHapticController::Pattern::BUTTON_PRESS);  // MP-27: 50ms buzz
         switch (current_screen_) {
             case ScreenID::MAIN:
@@ -207,6 +219,7 @@ void ScreenManager::handleHardwareButtons() {
 
     if (M5.BtnB.wasPressed()) {
         Serial.println("[ScreenManager] BtnB pressed");
+        INPUT_TRACE_RECORD(BUTTON, InputTrace::BUTTON_B, 0, 0);
         haptic_controller_.trigger(IHapticController::Pattern::BUTTON_PRESS);  // MP-27: 50ms buzz
         switch (current_screen_) {
             case ScreenID::MAIN:
@@ -227,6 +240,7 @@ void ScreenManager::handleHardwareButtons() {
 
     if (M5.BtnC.wasPressed()) {
         Serial.println("[ScreenManager] BtnC pressed");
+        INPUT_TRACE_RECORD(BUTTON, InputTrace::BUTTON_C, 0, 0);
         haptic_controller_.trigger(IHapticController::Pattern::BUTTON_PRESS);  // MP-27: 50ms buzz
         switch (current_screen_) {
             case ScreenID::MAIN:
@@ -44,6 +44,8 @@ using NavigationCallback = std::function<void(ScreenID target)>;
  * - Auto-navigation: PAUSED state → PauseScreen, resume → MainScreen
  * - Duck-typed interface (no base class, all screens have same method signatures)
  * - Status bar updates propagate to all screens
+ * - update() advances the TimerStateMachine on every screen, so a running
+ *   session keeps counting while Stats or Settings is open
  *
  * Architecture:
  * - All screens are stack-allocated members (always exist)
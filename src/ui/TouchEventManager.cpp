@@ -1,14 +1,23 @@
 #include "TouchEventManager.h"
+#include <Arduino.h>
+#include "../utils/AllocTracker.h"
+#include "../utils/Placement.h"
 #include <algorithm>
 
 TouchEventManager::TouchEventManager()
     : active_widget_(nullptr) {
 }
 
-void TouchEventManager::addWidget(Widget* widget) {
-    if (widget) {
-        widgets_.push_back(widget);
+bool TouchEventManager::addWidget(Widget* widget) {
+    ALLOC_SCOPE(TOUCH);
+    if (!widget) {
+        return false;
     }
+    if (!widgets_.push_back(widget)) {
+        Serial.printf("[TouchEventManager] ERROR: Widget table full (%u)\n", (unsigned)MAX_WIDGETS);
+        return false;
+    }
+    return true;
 }
 
 void TouchEventManager::removeWidget(Widget* widget) {
@@ -29,11 +38,11 @@ void TouchEventManager::clearWidgets() {
     active_widget_ = nullptr;
 }
 
-void TouchEventManager::handleTouch(int16_t x, int16_t y, bool pressed) {
+void HOT_IRAM TouchEventManager::handleTouch(int16_t x, int16_t y, bool pressed) {
     if (pressed) {
         // Touch down - find topmost hit widget (reverse iteration = top first)
-        for (auto it = widgets_.rbegin(); it != widgets_.rend(); ++it) {
-            Widget* widget = *it;
+        for (size_t i = widgets_.size(); i-- > 0;) {
+            Widget* widget = widgets_[i];
 
             // Skip invisible or disabled widgets
             if (!widget->isVisible() || !widget->isEnabled()) {
@@ -2,7 +2,7 @@
 #define TOUCH_EVENT_MANAGER_H
 
 #include "widgets/Widget.h"
-#include <vector>
+#include "../utils/FixedContainers.h"
 
 /**
  * TouchEventManager - Centralized touch event routing
@@ -46,6 +46,8 @@
  */
 class TouchEventManager {
 public:
+    static constexpr size_t MAX_WIDGETS = 32;   // SettingsScreen registers 20
+
     TouchEventManager();
 
     /**
@@ -53,8 +55,9 @@ public:
      * Widgets are stored in registration order; last added = top layer (Z-order).
      *
      * @param widget Pointer to widget (must remain valid while registered)
+     * @return false if widget is null or MAX_WIDGETS are already registered
      */
-    void addWidget(Widget* widget);
+    bool addWidget(Widget* widget);
 
     /**
      * Unregister a widget from touch event routing.
@@ -104,7 +107,7 @@ public:
     Widget* getActiveWidget() const { return active_widget_; }
 
 private:
-    std::vector<Widget*> widgets_;    // Z-order: first=bottom, last=top
+    StaticVector<Widget*, MAX_WIDGETS> widgets_;  // Z-order: first=bottom, last=top
     Widget* active_widget_;           // Widget that received onTouch (for matching onRelease)
 };
 
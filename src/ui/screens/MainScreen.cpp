@@ -13,24 +13,29 @@ MainScreen::MainScreen(TimerStateMachine& state_machine,
     : state_machine_(state_machine),
       sequence_(sequence),
       navigate_callback_(navigate_callback),
-      last_update_ms_(0) {
+      last_update_ms_(0),
+      clock_hour_(0),
+      clock_minute_(0),
+      ends_at_minute_(-1) {
     // Note: needs_redraw_ inherited from Screen base class, initialized to false
 
-    TIMER_HEIGHT = uint16_t(TIMER_FONT.height);
+    // Layout is fixed at compile time: flag a font swap that no longer fits its boxes
+    if (TIMER_FONT.height != Layout::TIMER_FONT_HEIGHT || SMALL_FONT.height != Layout::TEXT_FONT_HEIGHT) {
+        Serial.printf("[MainScreen] WARNING: font heights %d/%d differ from layout %d/%d\n",
+                      TIMER_FONT.height, SMALL_FONT.height,
+                      Layout::TIMER_FONT_HEIGHT, Layout::TEXT_FONT_HEIGHT);
+    }
 
     strcpy(task_name_, "Focus Session");
+    ends_at_[0] = '\0';
 
     // Configure widgets with layout positions
-    // Status bar at top (320×20)
-    status_bar_.setBounds(0, 0, SCREEN_WIDTH, STATUS_BAR_HEIGHT);
+    status_bar_.setBounds(Layout::STATUS_BAR);
 
-    // Sequence indicator below status bar (200×20, centered, below mode label)
-    sequence_indicator_.setBounds(60, STATUS_BAR_HEIGHT + MODE_LABEL_HEIGHT + 5, 200, SEQUENCE_HEIGHT);
+    sequence_indicator_.setBounds(Layout::SEQUENCE);
     sequence_indicator_.setDotsPerGroup(4);  // Classic mode default
 
-    // Progress bar in middle (280×20, centered)
-    int16_t progress_y = STATUS_BAR_HEIGHT + MODE_LABEL_HEIGHT + SEQUENCE_HEIGHT + TIMER_HEIGHT + TIMER_GAP * 2;
-    progress_bar_.setBounds(20, progress_y, 280, PROGRESS_HEIGHT);
+    progress_bar_.setBounds(Layout::PROGRESS);
     progress_bar_.setShowPercentage(false);  // Don't show percentage on timer progress
     progress_bar_.setColor(Renderer::Color(TFT_RED));
 
@@ -54,11 +59,12 @@ void MainScreen::updateStatus(uint8_t battery, bool charging, bool wifi,
     status_bar_.updateWiFi(wifi);
     status_bar_.updateMode(mode);
     status_bar_.updateTime(hour, minute);
+    clock_hour_ = hour;
+    clock_minute_ = minute;
 }
 
 void MainScreen::update(uint32_t deltaMs) {
-    // Update state machine (MP-23: also updates LEDs via TimerStateMachine)
-    state_machine_.update(deltaMs);
+    // State machine is advanced by ScreenManager::update() on every screen
 
     // Update progress bar (0% at start, 100% at end)
     uint8_t progress = state_machine_.getProgressPercent();
@@ -100,6 +106,9 @@ void MainScreen::update(uint32_t deltaMs) {
                                    completed_sessions,
                                    in_break);
 
+    // Projected end of the whole sequence (schedule table lookup)
+    updateEndsAt();
+
     // Update button visibility based on state
     updateButtons();
 
@@ -157,16 +166,23 @@ void MainScreen::drawModeLabel(Renderer& renderer) {
     snprintf(label, sizeof(label), "Session %d/%d",
              current_work_session, total_work_sessions);
 
-    int16_t y = STATUS_BAR_HEIGHT + 5;
+    int16_t y = Layout::MODE_LABEL.y;
     renderer.setTextDatum(TC_DATUM);  // Top-center
-    renderer.drawString(SCREEN_WIDTH / 2, y, label,
+    renderer.drawString(Layout::MODE_LABEL.centerX(), y, label,
                        &fonts::Font2, Renderer::Color(TFT_CYAN));
 
+    // Draw projected end of the sequence
+    if (ends_at_[0] != '\0') {
+        renderer.setTextDatum(TL_DATUM);  // Top-left
+        renderer.drawString(Layout::MODE_LABEL.x, y, ends_at_,
+                           &fonts::Font2, Renderer::Color(TFT_LIGHTGRAY));
+    }
+
     // Draw today's completion count badge
     char count_str[8];
     snprintf(count_str, sizeof(count_str), "%d", sequence_.getCompletedToday());
     renderer.setTextDatum(TR_DATUM);  // Top-right
-    renderer.drawString(SCREEN_WIDTH - 10, y, count_str,
+    renderer.drawString(Layout::COUNT_BADGE.right(), y, count_str,
                        &fonts::Font4, Renderer::Color(TFT_GREEN));
 }
 
@@ -189,9 +205,6 @@ void MainScreen::drawTimer(Renderer& renderer) {
     char time_str[6];
     snprintf(time_str, sizeof(time_str), "%02d:%02d", minutes, seconds);
 
-    // Calculate position
-    int16_t y = STATUS_BAR_HEIGHT + MODE_LABEL_HEIGHT + SEQUENCE_HEIGHT + TIMER_GAP + TIMER_FONT.height/2;
-
     // Draw time in large font
     renderer.setTextDatum(MC_DATUM);  // Middle-center
     Renderer::Color time_color = Renderer::Color(TFT_WHITE);
@@ -207,38 +220,41 @@ void MainScreen::drawTimer(Renderer& renderer) {
         time_color = Renderer::Color(TFT_YELLOW);
     }
 
-    renderer.drawString(SCREEN_WIDTH / 2, y, time_str,
-                       &TIMER_FONT, time_color);
+    // Fixed box: no text measurement per frame
+    renderer.drawString(Layout::TIMER.centerX(), Layout::TIMER.centerY(), time_str,
+                       &TIMER_FONT, time_color, Layout::TIMER);
 }
 
 void MainScreen::drawTaskName(Renderer& renderer) {
-    // Calculate position based on whether progress bar is visible
-    // If progress bar visible: place below it with spacing
-    // If no progress bar: center in remaining space below timer
+    // Below the progress bar when it is visible, otherwise below the timer
     auto state = state_machine_.getState();
     bool progress_visible = (state == TimerStateMachine::State::ACTIVE ||
                             state == TimerStateMachine::State::PAUSED);
+    const layout::Box& box = progress_visible ? Layout::TASK_ACTIVE : Layout::TASK_IDLE;
 
-    int16_t y;
-    int16_t controls_bottom;
-    int16_t available_space;
-
-    // timer bottom
-    controls_bottom = STATUS_BAR_HEIGHT + MODE_LABEL_HEIGHT + SEQUENCE_HEIGHT + TIMER_HEIGHT + TIMER_GAP;
+    renderer.setTextDatum(MC_DATUM);  // Middle-center for better vertical centering
+    renderer.drawString(box.centerX(), box.centerY(), task_name_,
+                       &fonts::Font2, Renderer::Color(TFT_LIGHTGRAY));
+}
 
-    // progress bar bottom if visible
-    if (progress_visible) {
-        controls_bottom += PROGRESS_HEIGHT + TIMER_GAP;
+void MainScreen::updateEndsAt() {
+    // Time left in the current interval (idle: the whole interval, not started yet)
+    uint32_t remaining_s;
+    if (state_machine_.getState() == TimerStateMachine::State::IDLE) {
+        remaining_s = static_cast<uint32_t>(sequence_.getCurrentSession().duration_min) * 60;
+    } else {
+        remaining_s = state_machine_.getRemainingMs() / 1000;
     }
 
-    // Calculate available space
-    available_space = SCREEN_HEIGHT - controls_bottom - STATUS_BAR_HEIGHT;
-
-    y = controls_bottom + (available_space / 2);
+    // Round up: the sequence ends during that minute
+    uint32_t total_min = (sequence_.getSecondsToSequenceEnd(remaining_s) + 59) / 60;
+    int16_t minute_of_day = (clock_hour_ * 60 + clock_minute_ + total_min) % (24 * 60);
 
-    renderer.setTextDatum(MC_DATUM);  // Middle-center for better vertical centering
-    renderer.drawString(SCREEN_WIDTH / 2, y, task_name_,
-                       &fonts::Font2, Renderer::Color(TFT_LIGHTGRAY));
+    if (minute_of_day != ends_at_minute_) {
+        ends_at_minute_ = minute_of_day;
+        snprintf(ends_at_, sizeof(ends_at_), "ends %02d:%02d",
+                 minute_of_day / 60, minute_of_day % 60);
+    }
 }
 
 void MainScreen::updateButtons() {
@@ -4,6 +4,7 @@
 #include <functional>
 #include "../Screen.h"
 #include "../Renderer.h"
+#include "../Layout.h"
 #include "../widgets/StatusBar.h"
 #include "../widgets/ProgressBar.h"
 #include "../widgets/SequenceIndicator.h"
@@ -24,7 +25,7 @@ using NavigationCallback = std::function<void(ScreenID)>;
  * ┌─────────────────────────────────┐
  * │ [WiFi][Mode][Time][Battery]     │ ← StatusBar (20px)
  * ├─────────────────────────────────┤
- * │      Session 2/4  [Classic]     │ ← Mode label (20px)
+ * │ ends 11:40  Session 2/4      3  │ ← Mode label (20px)
  * │           ● ● ○ ○                │ ← SequenceIndicator (20px)
  * ├─────────────────────────────────┤
  * │           24:35                  │ ← Timer display (80px, large font)
@@ -35,12 +36,16 @@ using NavigationCallback = std::function<void(ScreenID)>;
  * │ [Start]  [Pause]  [Stats]       │ ← Action buttons (40px)
  * └─────────────────────────────────┘
  *
+ * Positions are resolved at compile time in MainScreen::Layout and checked
+ * with static_assert below the class.
+ *
  * Features:
  * - Real-time countdown timer
  * - Visual progress indication
  * - Session tracking with dots
  * - State-based button visibility
  * - Today's completion count badge
+ * - "ends HH:MM" projection for the rest of the sequence
  */
 class MainScreen : public Screen {
 public:
@@ -60,6 +65,33 @@ public:
     // Screen-specific methods
     void setTaskName(const char* task);
 
+    /**
+     * Widget and text boxes (pixels, 320×240)
+     * Text boxes use the font line height; the constructor warns if the
+     * fonts in use do not match.
+     */
+    struct Layout {
+        static constexpr int16_t TEXT_FONT_HEIGHT = 16;     // fonts::Font2
+        static constexpr int16_t BADGE_FONT_HEIGHT = 26;    // fonts::Font4
+        static constexpr int16_t TIMER_FONT_HEIGHT = 75;    // fonts::Font8
+        static constexpr int16_t GAP = 10;
+        static constexpr int16_t TASK_AREA_BOTTOM = 220;    // Task name centered above this
+
+        static constexpr layout::Box STATUS_BAR = layout::STATUS_BAR;
+        // "ends HH:MM" left, "Session X/Y" centered, count badge right
+        static constexpr layout::Box MODE_LABEL = {10, 25, 300, TEXT_FONT_HEIGHT};
+        static constexpr layout::Box COUNT_BADGE = {270, 25, 40, BADGE_FONT_HEIGHT};
+        static constexpr layout::Box SEQUENCE = layout::centeredX(layout::SCREEN, 45, 200, 20);
+        static constexpr layout::Box TIMER =
+            layout::centeredX(layout::SCREEN, SEQUENCE.bottom() + 5, 280, TIMER_FONT_HEIGHT);
+        static constexpr layout::Box PROGRESS = layout::below(TIMER, GAP, 20, 280, 20);
+        // Task name: centered below the timer, or below the progress bar when shown
+        static constexpr layout::Box TASK_IDLE =
+            layout::centeredY(10, TIMER.bottom(), TASK_AREA_BOTTOM, 300, TEXT_FONT_HEIGHT);
+        static constexpr layout::Box TASK_ACTIVE =
+            layout::centeredY(10, PROGRESS.bottom(), TASK_AREA_BOTTOM, 300, TEXT_FONT_HEIGHT);
+    };
+
 private:
     TimerStateMachine& state_machine_;
     PomodoroSequence& sequence_;
@@ -74,30 +106,36 @@ private:
     // State
     char task_name_[64];
     uint32_t last_update_ms_;
-    int16_t TIMER_HEIGHT;
+    uint8_t clock_hour_;           // Wall clock from updateStatus()
+    uint8_t clock_minute_;
+    int16_t ends_at_minute_;       // Minute of day the sequence ends, -1 = not computed yet
+    char ends_at_[12];             // "ends HH:MM" (reformatted only when the minute changes)
     // Note: needs_redraw_ inherited from Screen base class
 
     #define SMALL_FONT fonts::Font2
     #define TIMER_FONT fonts::Font8
 
-    // Layout constants
-    static constexpr int16_t SCREEN_WIDTH = 320;
-    static constexpr int16_t SCREEN_HEIGHT = 240;
-    static constexpr int16_t STATUS_BAR_HEIGHT = 20;
-    static constexpr int16_t MODE_LABEL_HEIGHT = 20;
-    static constexpr int16_t SEQUENCE_HEIGHT = 20;
-    // Space between elements
-    static constexpr int16_t TIMER_GAP = 10;
-    static constexpr int16_t TASK_LABEL_GAP = 8;
-    static constexpr int16_t PROGRESS_HEIGHT = 20;
-    static constexpr int16_t TASK_HEIGHT = 30;
-    static constexpr int16_t BUTTON_HEIGHT = 40;
-
     // Drawing helpers
     void drawModeLabel(Renderer& renderer);
     void drawTimer(Renderer& renderer);
     void drawTaskName(Renderer& renderer);
     void updateButtons();
+    void updateEndsAt();
 };
 
+static_assert(layout::inside(layout::CONTENT, {MainScreen::Layout::MODE_LABEL, MainScreen::Layout::COUNT_BADGE,
+                                               MainScreen::Layout::SEQUENCE, MainScreen::Layout::TIMER,
+                                               MainScreen::Layout::PROGRESS, MainScreen::Layout::TASK_IDLE,
+                                               MainScreen::Layout::TASK_ACTIVE}),
+              "MainScreen: box outside the content area");
+static_assert(layout::disjoint({MainScreen::Layout::MODE_LABEL, MainScreen::Layout::SEQUENCE,
+                                MainScreen::Layout::TIMER, MainScreen::Layout::PROGRESS,
+                                MainScreen::Layout::TASK_ACTIVE}),
+              "MainScreen: boxes overlap (progress bar visible)");
+static_assert(layout::disjoint({MainScreen::Layout::COUNT_BADGE, MainScreen::Layout::SEQUENCE,
+                                MainScreen::Layout::TIMER}),
+              "MainScreen: count badge overlaps the sequence dots or timer");
+static_assert(!MainScreen::Layout::TASK_IDLE.overlaps(MainScreen::Layout::TIMER),
+              "MainScreen: task name overlaps the timer");
+
 #endif // MAINSCREEN_H
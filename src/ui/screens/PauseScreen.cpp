@@ -1,5 +1,5 @@
 #include "PauseScreen.h"
-#include "../../hardware/LEDController.h"
+#include "../../hardware/ILEDController.h"
 #include <M5Unified.h>
 #include <stdio.h>
 
@@ -11,161 +11,120 @@ SettingsScreen::SettingsScreen(Config& config, NavigationCallback navigate_callb
     // Note: needs_redraw_ inherited from Screen base class
 
     // Configure status bar
-    status_bar_.setBounds(0, 0, SCREEN_WIDTH, STATUS_BAR_HEIGHT);
+    status_bar_.setBounds(Layout::STATUS_BAR);
 
     // Note: Hardware buttons replaced custom touch buttons
     // BtnA (left): Back to Main
     // BtnB (center): Prev page (enabled if not on first page)
     // BtnC (right): Next page (enabled if not on last page)
 
-    // Calculate widget positions (CSS-style cumulative Y positioning)
-    int16_t widget_start_y = STATUS_BAR_HEIGHT + TITLE_HEIGHT + 5;
-    int16_t y = widget_start_y;
+    // Widget positions come from the compile-time Layout tables
 
     // Page 0: Timer settings (3 sliders)
-    slider_work_duration_.setBounds(10, y, 300, WIDGET_HEIGHT);
+    slider_work_duration_.setBounds(Layout::PAGE0[0]);
     slider_work_duration_.setLabel("Work:");
     slider_work_duration_.setRange(1, 90);  // TODO(ChistokhinSV): return back to (5, 90)
     slider_work_duration_.setDisplayMode(Slider::DisplayMode::TIME_MIN);
     slider_work_duration_.setCallback([this](uint16_t val) { this->onWorkDurationChange(val); });
-    slider_work_duration_.setMarginBottom(10);
-    y += slider_work_duration_.getTotalHeight();
 
-    slider_short_break_.setBounds(10, y, 300, WIDGET_HEIGHT);
+    slider_short_break_.setBounds(Layout::PAGE0[1]);
     slider_short_break_.setLabel("Short Break:");
     slider_short_break_.setRange(1, 15);  // MP-50: Increased from 10 to support Study mode
     slider_short_break_.setDisplayMode(Slider::DisplayMode::TIME_MIN);
     slider_short_break_.setCallback([this](uint16_t val) { this->onShortBreakChange(val); });
-    slider_short_break_.setMarginBottom(10);
-    y += slider_short_break_.getTotalHeight();
 
-    slider_long_break_.setBounds(10, y, 300, WIDGET_HEIGHT);
+    slider_long_break_.setBounds(Layout::PAGE0[2]);
     slider_long_break_.setLabel("Long Break:");
     slider_long_break_.setRange(10, 30);
     slider_long_break_.setDisplayMode(Slider::DisplayMode::TIME_MIN);
     slider_long_break_.setCallback([this](uint16_t val) { this->onLongBreakChange(val); });
-    slider_long_break_.setMarginBottom(10);
-    y += slider_long_break_.getTotalHeight();
 
     // MP-50: Mode preset buttons (3 buttons × 100px, 4px gaps, Y=176)
-    int16_t btn_width = 100;
-    int16_t btn_height = 40;
-    int16_t btn_gap = 4;
-    int16_t btn_x = 6;  // Left margin
-
-    button_mode_classic_.setBounds(btn_x, y, btn_width, btn_height);
+    button_mode_classic_.setBounds(Layout::MODE_BUTTONS[0]);
     button_mode_classic_.setLabel("Classic", "25/5/15");
     button_mode_classic_.setCallback([this]() { this->onModeClassic(); });
 
-    button_mode_study_.setBounds(btn_x + btn_width + btn_gap, y, btn_width, btn_height);
+    button_mode_study_.setBounds(Layout::MODE_BUTTONS[1]);
     button_mode_study_.setLabel("Study", "45/15/30");
     button_mode_study_.setCallback([this]() { this->onModeStudy(); });
 
-    button_mode_custom_.setBounds(btn_x + 2 * (btn_width + btn_gap), y, btn_width, btn_height);
+    button_mode_custom_.setBounds(Layout::MODE_BUTTONS[2]);
     button_mode_custom_.setLabel("Custom", "...");  // Will be updated in loadFromConfig()
     button_mode_custom_.setCallback([this]() { this->onModeCustom(); });
 
     // Page 1: Timer settings (2 sliders + 2 toggles)
-    y = widget_start_y;
-    slider_sessions_.setBounds(10, y, 300, WIDGET_HEIGHT);
+    slider_sessions_.setBounds(Layout::PAGE1[0]);
     slider_sessions_.setLabel("Per Cycle:");
     slider_sessions_.setRange(1, 8);
     slider_sessions_.setDisplayMode(Slider::DisplayMode::NUMERIC);
     slider_sessions_.setCallback([this](uint16_t val) { this->onSessionsChange(val); });
-    slider_sessions_.setMarginBottom(10);
-    y += slider_sessions_.getTotalHeight();
 
-    slider_cycles_.setBounds(10, y, 300, WIDGET_HEIGHT);
+    slider_cycles_.setBounds(Layout::PAGE1[1]);
     slider_cycles_.setLabel("Cycles:");
     slider_cycles_.setRange(1, 4);
     slider_cycles_.setDisplayMode(Slider::DisplayMode::NUMERIC);
     slider_cycles_.setCallback([this](uint16_t val) { this->onCyclesChange(val); });
-    slider_cycles_.setMarginBottom(10);
-    y += slider_cycles_.getTotalHeight();
 
-    toggle_auto_break_.setBounds(10, y, 300, 20);  // Toggle height = 20px
+    toggle_auto_break_.setBounds(Layout::PAGE1[2]);
     toggle_auto_break_.setLabel("Auto-start breaks");
     toggle_auto_break_.setCallback([this](bool val) { this->onAutoBreakChange(val); });
-    toggle_auto_break_.setMarginBottom(10);
-    y += toggle_auto_break_.getTotalHeight();
 
-    toggle_auto_work_.setBounds(10, y, 300, 20);  // Toggle height = 20px
+    toggle_auto_work_.setBounds(Layout::PAGE1[3]);
     toggle_auto_work_.setLabel("Auto-start work");
     toggle_auto_work_.setCallback([this](bool val) { this->onAutoWorkChange(val); });
-    toggle_auto_work_.setMarginBottom(10);
 
     // Page 2: UI settings (1 slider + 1 toggle + 1 slider)
-    y = widget_start_y;
-    slider_brightness_.setBounds(10, y, 300, WIDGET_HEIGHT);
+    slider_brightness_.setBounds(Layout::PAGE2[0]);
     slider_brightness_.setLabel("Brightness:");
     slider_brightness_.setRange(0, 100);
     slider_brightness_.setDisplayMode(Slider::DisplayMode::PERCENTAGE);
     slider_brightness_.setCallback([this](uint16_t val) { this->onBrightnessChange(val); });
-    slider_brightness_.setMarginBottom(10);
-    y += slider_brightness_.getTotalHeight();
 
-    toggle_sound_.setBounds(10, y, 300, 20);  // Toggle height = 20px
+    toggle_sound_.setBounds(Layout::PAGE2[1]);
     toggle_sound_.setLabel("Sound enabled");
     toggle_sound_.setCallback([this](bool val) { this->onSoundChange(val); });
-    toggle_sound_.setMarginBottom(10);
-    y += toggle_sound_.getTotalHeight();
 
-    slider_volume_.setBounds(10, y, 300, WIDGET_HEIGHT);
+    slider_volume_.setBounds(Layout::PAGE2[2]);
     slider_volume_.setLabel("Volume:");
     slider_volume_.setRange(0, 100);
     slider_volume_.setDisplayMode(Slider::DisplayMode::PERCENTAGE);
     slider_volume_.setCallback([this](uint16_t val) { this->onVolumeChange(val); });
-    slider_volume_.setMarginBottom(10);
 
     // Page 3: UI settings (2 toggles + 1 slider)
-    y = widget_start_y;
-    toggle_haptic_.setBounds(10, y, 300, 20);  // Toggle height = 20px
+    toggle_haptic_.setBounds(Layout::PAGE3[0]);
     toggle_haptic_.setLabel("Haptic feedback");
     toggle_haptic_.setCallback([this](bool val) { this->onHapticChange(val); });
-    toggle_haptic_.setMarginBottom(10);
-    y += toggle_haptic_.getTotalHeight();
 
-    toggle_show_seconds_.setBounds(10, y, 300, 20);  // Toggle height = 20px
+    toggle_show_seconds_.setBounds(Layout::PAGE3[1]);
     toggle_show_seconds_.setLabel("Show seconds");
     toggle_show_seconds_.setCallback([this](bool val) { this->onShowSecondsChange(val); });
-    toggle_show_seconds_.setMarginBottom(10);
-    y += toggle_show_seconds_.getTotalHeight();
 
-    slider_timeout_.setBounds(10, y, 300, WIDGET_HEIGHT);
+    slider_timeout_.setBounds(Layout::PAGE3[2]);
     slider_timeout_.setLabel("Timeout:");
     slider_timeout_.setRange(0, 600);
     slider_timeout_.setDisplayMode(Slider::DisplayMode::TIME_SEC);
     slider_timeout_.setCallback([this](uint16_t val) { this->onTimeoutChange(val); });
-    slider_timeout_.setMarginBottom(10);
 
     // Page 4: Power settings (1 toggle + 1 slider + 1 toggle + 1 slider)
-    y = widget_start_y;
-    toggle_auto_sleep_.setBounds(10, y, 300, 20);  // Toggle height = 20px
+    toggle_auto_sleep_.setBounds(Layout::PAGE4[0]);
     toggle_auto_sleep_.setLabel("Auto-sleep");
     toggle_auto_sleep_.setCallback([this](bool val) { this->onAutoSleepChange(val); });
-    toggle_auto_sleep_.setMarginBottom(10);
-    y += toggle_auto_sleep_.getTotalHeight();
 
-    slider_sleep_after_.setBounds(10, y, 300, WIDGET_HEIGHT);
+    slider_sleep_after_.setBounds(Layout::PAGE4[1]);
     slider_sleep_after_.setLabel("Sleep after:");
     slider_sleep_after_.setRange(0, 600);
     slider_sleep_after_.setDisplayMode(Slider::DisplayMode::TIME_MIN);
     slider_sleep_after_.setCallback([this](uint16_t val) { this->onSleepAfterChange(val); });
-    slider_sleep_after_.setMarginBottom(10);
-    y += slider_sleep_after_.getTotalHeight();
 
-    toggle_wake_rotation_.setBounds(10, y, 300, 20);  // Toggle height = 20px
-    toggle_wake_rotation_.setLabel("Wake on rotation");
+    toggle_wake_rotation_.setBounds(Layout::PAGE4[2]);
+    toggle_wake_rotation_.setLabel("Sleep motion poll");
     toggle_wake_rotation_.setCallback([this](bool val) { this->onWakeRotationChange(val); });
-    toggle_wake_rotation_.setMarginBottom(10);
-    y += toggle_wake_rotation_.getTotalHeight();
 
-    slider_min_battery_.setBounds(10, y, 300, WIDGET_HEIGHT);
+    slider_min_battery_.setBounds(Layout::PAGE4[3]);
     slider_min_battery_.setLabel("Low battery:");
     slider_min_battery_.setRange(5, 50);
     slider_min_battery_.setDisplayMode(Slider::DisplayMode::PERCENTAGE);
     slider_min_battery_.setCallback([this](uint16_t val) { this->onMinBatteryChange(val); });
-    slider_min_battery_.setMarginBottom(10);
 
     // Register all touch-enabled widgets with TouchEventManager
     // Note: Widget visibility is controlled by update() based on current_page_
@@ -364,21 +323,18 @@ void SettingsScreen::drawTitle(Renderer& renderer) {
              page_name, current_page_ + 1, TOTAL_PAGES);
 
     renderer.setTextDatum(TL_DATUM);
-    renderer.drawString(10, STATUS_BAR_HEIGHT + 5, title,
+    renderer.drawString(Layout::TITLE.x, Layout::TITLE.y, title,
                        &fonts::Font2, Renderer::Color(TFT_CYAN));
 }
 
 void SettingsScreen::drawPageIndicator(Renderer& renderer) {
     // Draw page dots (right side of title area)
-    int16_t dot_x = SCREEN_WIDTH - 80;  // Adjusted for 5 dots
-    int16_t dot_y = STATUS_BAR_HEIGHT + 12;
-    int16_t dot_spacing = 15;
-
     for (uint8_t i = 0; i < TOTAL_PAGES; i++) {
         bool is_current = (i == current_page_);
         Renderer::Color color = is_current ? Renderer::Color(TFT_CYAN) : Renderer::Color(0x632C);  // Gray in RGB565
 
-        renderer.drawCircle(dot_x + i * dot_spacing, dot_y, 4, color, true);
+        const layout::Box& dot = Layout::PAGE_DOTS[i];
+        renderer.drawCircle(dot.centerX(), dot.centerY(), dot.w / 2, color, true);
     }
 }
 
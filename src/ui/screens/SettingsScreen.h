@@ -4,6 +4,7 @@
 #include <functional>
 #include "../Screen.h"
 #include "../Renderer.h"
+#include "../Layout.h"
 #include "../widgets/StatusBar.h"
 #include "../widgets/Button.h"
 #include "../widgets/Slider.h"
@@ -35,6 +36,9 @@ using ConfigChangedCallback = std::function<void()>;  // Notify parent when conf
  * │   [← Back]  [Prev] [Next]       │ ← Navigation (35px)
  * └─────────────────────────────────┘
  *
+ * Widget positions for every page are resolved at compile time in
+ * SettingsScreen::Layout and checked with static_assert below the class.
+ *
  * Pages:
  * - Page 0: Timer settings (6 options)
  * - Page 1: UI settings (6 options)
@@ -68,6 +72,30 @@ public:
     void getButtonLabels(const char*& btnA, const char*& btnB, const char*& btnC,
                         bool& enabledA, bool& enabledB, bool& enabledC);
 
+    /**
+     * Widget boxes per page (pixels, 320×240)
+     * Rows stack from WIDGETS_Y with a 10px gap; heights match the widgets
+     * (Slider thumb 32px, Toggle 20px).
+     */
+    struct Layout {
+        static constexpr layout::Row SLIDER = {32, 10};
+        static constexpr layout::Row TOGGLE = {20, 10};
+        static constexpr int16_t X = 10;
+        static constexpr int16_t W = 300;
+        static constexpr int16_t WIDGETS_Y = 50;            // Status bar + title (25px) + 5
+
+        static constexpr layout::Box STATUS_BAR = layout::STATUS_BAR;
+        static constexpr layout::Box TITLE = {10, 25, 220, 16};          // Font2, top-left
+        static constexpr auto PAGE_DOTS = layout::spread<5>(236, 28, 8, 8, 7);  // r=4, 15px apart
+
+        static constexpr auto PAGE0 = layout::column(X, WIDGETS_Y, W, {SLIDER, SLIDER, SLIDER});
+        static constexpr auto MODE_BUTTONS = layout::spread<3>(6, layout::bottomOf(PAGE0) + 10, 100, 40, 4);
+        static constexpr auto PAGE1 = layout::column(X, WIDGETS_Y, W, {SLIDER, SLIDER, TOGGLE, TOGGLE});
+        static constexpr auto PAGE2 = layout::column(X, WIDGETS_Y, W, {SLIDER, TOGGLE, SLIDER});
+        static constexpr auto PAGE3 = layout::column(X, WIDGETS_Y, W, {TOGGLE, TOGGLE, SLIDER});
+        static constexpr auto PAGE4 = layout::column(X, WIDGETS_Y, W, {TOGGLE, SLIDER, TOGGLE, SLIDER});
+    };
+
 private:
     Config& config_;
     NavigationCallback navigate_callback_;
@@ -110,14 +138,7 @@ private:
     // State
     uint8_t current_page_;
     static constexpr uint8_t TOTAL_PAGES = 5;
-
-    // Layout constants
-    static constexpr int16_t SCREEN_WIDTH = 320;
-    static constexpr int16_t SCREEN_HEIGHT = 240;
-    static constexpr int16_t STATUS_BAR_HEIGHT = 20;
-    static constexpr int16_t TITLE_HEIGHT = 25;
-    static constexpr int16_t WIDGET_HEIGHT = 32;  // Match slider button height
-    static constexpr int16_t NAV_HEIGHT = 35;
+    static_assert(Layout::PAGE_DOTS.size() == TOTAL_PAGES, "SettingsScreen: one page dot per page");
 
     // Drawing helpers
     void drawTitle(Renderer& renderer);
@@ -159,4 +180,22 @@ private:
     void onMinBatteryChange(uint16_t value);
 };
 
+static_assert(layout::disjoint({SettingsScreen::Layout::TITLE, SettingsScreen::Layout::PAGE_DOTS[0],
+                                SettingsScreen::Layout::PAGE_DOTS[4], SettingsScreen::Layout::PAGE0[0]}),
+              "SettingsScreen: title row overlaps the widgets");
+static_assert(layout::disjoint(SettingsScreen::Layout::PAGE0) &&
+              layout::disjoint(SettingsScreen::Layout::MODE_BUTTONS) &&
+              layout::disjoint(SettingsScreen::Layout::PAGE1) &&
+              layout::disjoint(SettingsScreen::Layout::PAGE2) &&
+              layout::disjoint(SettingsScreen::Layout::PAGE3) &&
+              layout::disjoint(SettingsScreen::Layout::PAGE4),
+              "SettingsScreen: widgets on one page overlap");
+static_assert(layout::inside(layout::CONTENT, SettingsScreen::Layout::PAGE0) &&
+              layout::inside(layout::CONTENT, SettingsScreen::Layout::MODE_BUTTONS) &&
+              layout::inside(layout::CONTENT, SettingsScreen::Layout::PAGE1) &&
+              layout::inside(layout::CONTENT, SettingsScreen::Layout::PAGE2) &&
+              layout::inside(layout::CONTENT, SettingsScreen::Layout::PAGE3) &&
+              layout::inside(layout::CONTENT, SettingsScreen::Layout::PAGE4),
+              "SettingsScreen: widget runs into the status or button bar");
+
 #endif // SETTINGSSCREEN_H
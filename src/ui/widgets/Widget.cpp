@@ -1,6 +1,7 @@
 #include "Widget.h"
+#include "../../utils/Placement.h"
 
-bool Widget::hitTest(int16_t x, int16_t y) const {
+bool HOT_IRAM Widget::hitTest(int16_t x, int16_t y) const {
     if (!visible_ || !enabled_) {
         return false;
     }
@@ -38,6 +38,7 @@ public:
 
     // Position and bounds
     void setBounds(int16_t x, int16_t y, int16_t w, int16_t h);
+    void setBounds(const Renderer::Rect& rect) { setBounds(rect.x, rect.y, rect.w, rect.h); }
     Renderer::Rect getBounds() const { return bounds_; }
 
     // CSS-style margins (layout only, not interactive)
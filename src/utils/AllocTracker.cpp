@@ -0,0 +1,523 @@
+#include "AllocTracker.h"
+
+#if ALLOC_TRACKING
+
+#include <atomic>
+#include <string.h>
+
+#ifdef NATIVE_BUILD
+#include <stdio.h>
+#define ALLOC_LOG(...) printf(__VA_ARGS__)
+#else
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <esp_heap_caps.h>
+#define ALLOC_LOG(...) Serial.printf(__VA_ARGS__)
+#endif
+
+// Live pointer table size (power of two). 2048 × 12 bytes = 24KB of .bss
+#ifndef ALLOC_TRACKER_MAX_LIVE
+#define ALLOC_TRACKER_MAX_LIVE 2048
+#endif
+
+static_assert((ALLOC_TRACKER_MAX_LIVE & (ALLOC_TRACKER_MAX_LIVE - 1)) == 0,
+              "ALLOC_TRACKER_MAX_LIVE must be a power of two");
+
+// ============================================================================
+// Tracker State (static, never heap-allocated)
+// ============================================================================
+
+namespace {
+
+constexpr size_t SUBSYSTEM_COUNT = static_cast<size_t>(AllocTracker::Subsystem::COUNT);
+constexpr uint32_t LIVE_MASK = ALLOC_TRACKER_MAX_LIVE - 1;
+constexpr uint32_t LIVE_LIMIT = ALLOC_TRACKER_MAX_LIVE - ALLOC_TRACKER_MAX_LIVE / 8;  // 87.5% load
+constexpr uint32_t SITE_MASK = AllocTracker::MAX_SITES - 1;
+constexpr uint8_t NO_SITE = 0xFF;
+
+static_assert((AllocTracker::MAX_SITES & SITE_MASK) == 0, "MAX_SITES must be a power of two");
+
+struct LiveEntry {
+    uintptr_t ptr;       // 0 = empty slot
+    uint32_t size;
+    uint8_t subsystem;
+};
+
+AllocTracker::SubsystemStats s_stats[SUBSYSTEM_COUNT];
+AllocTracker::CallSite s_sites[AllocTracker::MAX_SITES];
+LiveEntry s_live[ALLOC_TRACKER_MAX_LIVE];
+uint32_t s_live_count = 0;
+uint32_t s_untracked_allocs = 0;
+uint32_t s_untracked_frees = 0;
+uint32_t s_site_overflow = 0;
+
+// ----------------------------------------------------------------------------
+// Lock: spinlock, no allocation, short critical sections only
+// ----------------------------------------------------------------------------
+
+#ifdef NATIVE_BUILD
+std::atomic_flag s_lock = ATOMIC_FLAG_INIT;
+
+inline void lock() {
+    while (s_lock.test_and_set(std::memory_order_acquire)) {
+        // spin
+    }
+}
+
+inline void unlock() {
+    s_lock.clear(std::memory_order_release);
+}
+#else
+portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+inline void lock() {
+    portENTER_CRITICAL(&s_lock);
+}
+
+inline void unlock() {
+    portEXIT_CRITICAL(&s_lock);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// Scope context: per thread on host, per core on device
+// ----------------------------------------------------------------------------
+
+#ifdef NATIVE_BUILD
+thread_local uint8_t t_subsystem = 0;
+thread_local uint32_t t_site = 0;
+
+inline uint8_t& ctxSubsystem() { return t_subsystem; }
+inline uint32_t& ctxSite() { return t_site; }
+#else
+uint8_t s_ctx_subsystem[portNUM_PROCESSORS] = {};
+uint32_t s_ctx_site[portNUM_PROCESSORS] = {};
+
+inline uint8_t& ctxSubsystem() { return s_ctx_subsystem[xPortGetCoreID()]; }
+inline uint32_t& ctxSite() { return s_ctx_site[xPortGetCoreID()]; }
+#endif
+
+// ----------------------------------------------------------------------------
+// Table helpers (call with lock held)
+// ----------------------------------------------------------------------------
+
+inline uint32_t liveHome(uintptr_t ptr) {
+    return (static_cast<uint32_t>(ptr >> 3) * 2654435761u) & LIVE_MASK;
+}
+
+bool liveInsert(uintptr_t ptr, uint32_t size, uint8_t subsystem) {
+    if (s_live_count >= LIVE_LIMIT) {
+        return false;
+    }
+
+    uint32_t i = liveHome(ptr);
+    while (s_live[i].ptr != 0) {
+        i = (i + 1) & LIVE_MASK;
+    }
+
+    s_live[i].ptr = ptr;
+    s_live[i].size = size;
+    s_live[i].subsystem = subsystem;
+    s_live_count++;
+    return true;
+}
+
+// Linear probing removal with backward shift (no tombstones)
+bool liveRemove(uintptr_t ptr, LiveEntry& out) {
+    uint32_t i = liveHome(ptr);
+    while (s_live[i].ptr != ptr) {
+        if (s_live[i].ptr == 0) {
+            return false;
+        }
+        i = (i + 1) & LIVE_MASK;
+    }
+
+    out = s_live[i];
+
+    uint32_t j = i;
+    while (true) {
+        j = (j + 1) & LIVE_MASK;
+        if (s_live[j].ptr == 0) {
+            break;
+        }
+        uint32_t k = liveHome(s_live[j].ptr);
+        // Move entry j into the hole at i unless its home lies cyclically in (i, j]
+        bool in_range = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+        if (!in_range) {
+            s_live[i] = s_live[j];
+            i = j;
+        }
+    }
+
+    s_live[i].ptr = 0;
+    s_live_count--;
+    return true;
+}
+
+void recordSite(uint32_t hash, uint8_t subsystem, uint32_t size) {
+    uint32_t i = hash & SITE_MASK;
+    for (size_t probe = 0; probe < AllocTracker::MAX_SITES; probe++) {
+        AllocTracker::CallSite& site = s_sites[i];
+        if (site.count == 0) {
+            site.hash = hash;
+            site.subsystem = static_cast<AllocTracker::Subsystem>(subsystem);
+        }
+        if (site.hash == hash) {
+            site.count++;
+            site.bytes += size;
+            return;
+        }
+        i = (i + 1) & SITE_MASK;
+    }
+    s_site_overflow++;
+}
+
+}  // namespace
+
+// ============================================================================
+// Hook Entry Points
+// ============================================================================
+
+void AllocTracker::onAlloc(void* ptr, size_t size, uintptr_t caller) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    uint8_t subsystem = ctxSubsystem();
+    uint32_t site = ctxSite() ^ (static_cast<uint32_t>(caller) * 2654435761u);
+    uint32_t bytes = static_cast<uint32_t>(size);
+
+    lock();
+
+    SubsystemStats& stats = s_stats[subsystem];
+    stats.alloc_count++;
+    stats.total_bytes += bytes;
+
+    if (liveInsert(reinterpret_cast<uintptr_t>(ptr), bytes, subsystem)) {
+        stats.live_bytes += bytes;
+        if (stats.live_bytes > stats.peak_bytes) {
+            stats.peak_bytes = stats.live_bytes;
+        }
+    } else {
+        s_untracked_allocs++;
+    }
+
+    recordSite(site, subsystem, bytes);
+
+    unlock();
+}
+
+void AllocTracker::onFree(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    lock();
+
+    LiveEntry entry;
+    if (liveRemove(reinterpret_cast<uintptr_t>(ptr), entry)) {
+        SubsystemStats& stats = s_stats[entry.subsystem];
+        stats.free_count++;
+        stats.live_bytes -= entry.size;
+    } else {
+        s_untracked_frees++;
+    }
+
+    unlock();
+}
+
+// ============================================================================
+// Scope
+// ============================================================================
+
+AllocTracker::Scope::Scope(Subsystem subsystem, uint32_t site_hash)
+    : prev_subsystem_(ctxSubsystem()),
+      prev_site_(ctxSite()) {
+    ctxSubsystem() = static_cast<uint8_t>(subsystem);
+    ctxSite() = site_hash;
+}
+
+AllocTracker::Scope::~Scope() {
+    ctxSubsystem() = prev_subsystem_;
+    ctxSite() = prev_site_;
+}
+
+AllocTracker::Subsystem AllocTracker::currentSubsystem() {
+    return static_cast<Subsystem>(ctxSubsystem());
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+AllocTracker::SubsystemStats AllocTracker::getStats(Subsystem subsystem) {
+    size_t index = static_cast<size_t>(subsystem);
+    if (index >= SUBSYSTEM_COUNT) {
+        return SubsystemStats{};
+    }
+
+    lock();
+    SubsystemStats stats = s_stats[index];
+    unlock();
+    return stats;
+}
+
+AllocTracker::SubsystemStats AllocTracker::getTotals() {
+    SubsystemStats totals{};
+
+    lock();
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; i++) {
+        totals.alloc_count += s_stats[i].alloc_count;
+        totals.free_count += s_stats[i].free_count;
+        totals.live_bytes += s_stats[i].live_bytes;
+        totals.peak_bytes += s_stats[i].peak_bytes;  // Sum of per-subsystem peaks (upper bound)
+        totals.total_bytes += s_stats[i].total_bytes;
+    }
+    unlock();
+
+    return totals;
+}
+
+uint32_t AllocTracker::getUntrackedAllocs() {
+    return s_untracked_allocs;
+}
+
+uint32_t AllocTracker::getUntrackedFrees() {
+    return s_untracked_frees;
+}
+
+size_t AllocTracker::getTopSites(CallSite* out, size_t max_sites) {
+    if (!out || max_sites == 0) {
+        return 0;
+    }
+
+    // Snapshot under lock, sort outside (selection sort, table is tiny)
+    CallSite snapshot[MAX_SITES];
+    lock();
+    memcpy(snapshot, s_sites, sizeof(snapshot));
+    unlock();
+
+    size_t found = 0;
+    while (found < max_sites) {
+        size_t best = MAX_SITES;
+        for (size_t i = 0; i < MAX_SITES; i++) {
+            if (snapshot[i].count == 0) continue;
+            if (best == MAX_SITES || snapshot[i].bytes > snapshot[best].bytes) {
+                best = i;
+            }
+        }
+        if (best == MAX_SITES) break;
+
+        out[found++] = snapshot[best];
+        snapshot[best].count = 0;  // Exclude from next pass
+    }
+
+    return found;
+}
+
+void AllocTracker::reset() {
+    lock();
+    memset(s_stats, 0, sizeof(s_stats));
+    memset(s_sites, 0, sizeof(s_sites));
+    memset(s_live, 0, sizeof(s_live));
+    s_live_count = 0;
+    s_untracked_allocs = 0;
+    s_untracked_frees = 0;
+    s_site_overflow = 0;
+    unlock();
+}
+
+const char* AllocTracker::subsystemName(Subsystem subsystem) {
+    switch (subsystem) {
+        case Subsystem::UNTAGGED: return "UNTAGGED";
+        case Subsystem::UI_FRAME: return "UI_FRAME";
+        case Subsystem::RENDERER: return "RENDERER";
+        case Subsystem::TOUCH: return "TOUCH";
+        case Subsystem::SCREENS: return "SCREENS";
+        case Subsystem::TIMER: return "TIMER";
+        case Subsystem::SEQUENCE: return "SEQUENCE";
+        case Subsystem::STATS: return "STATS";
+        case Subsystem::CONFIG: return "CONFIG";
+        case Subsystem::SD: return "SD";
+        case Subsystem::NETWORK_CONFIG: return "NETWORK_CONFIG";
+        case Subsystem::AUDIO: return "AUDIO";
+        case Subsystem::LED: return "LED";
+        case Subsystem::NETWORK: return "NETWORK";
+        default: return "UNKNOWN";
+    }
+}
+
+void AllocTracker::printReport() {
+    // Snapshot first: printing may allocate (Serial.printf) and must not hold the lock
+    SubsystemStats stats[SUBSYSTEM_COUNT];
+    lock();
+    memcpy(stats, s_stats, sizeof(stats));
+    uint32_t live_count = s_live_count;
+    uint32_t untracked_allocs = s_untracked_allocs;
+    uint32_t untracked_frees = s_untracked_frees;
+    uint32_t site_overflow = s_site_overflow;
+    unlock();
+
+    ALLOC_LOG("\n=== Heap Allocation Tracker ===\n");
+    ALLOC_LOG("%-15s %8s %8s %9s %9s %10s\n", "Subsystem", "Allocs", "Frees", "Live", "Peak", "Total");
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; i++) {
+        if (stats[i].alloc_count == 0 && stats[i].free_count == 0) continue;
+        ALLOC_LOG("%-15s %8lu %8lu %9lu %9lu %10lu\n",
+                  subsystemName(static_cast<Subsystem>(i)),
+                  (unsigned long)stats[i].alloc_count,
+                  (unsigned long)stats[i].free_count,
+                  (unsigned long)stats[i].live_bytes,
+                  (unsigned long)stats[i].peak_bytes,
+                  (unsigned long)stats[i].total_bytes);
+    }
+
+    CallSite top[8];
+    size_t top_count = getTopSites(top, 8);
+    if (top_count > 0) {
+        ALLOC_LOG("Top call sites (by bytes):\n");
+        for (size_t i = 0; i < top_count; i++) {
+            ALLOC_LOG("  0x%08lX %-15s count=%lu bytes=%lu\n",
+                      (unsigned long)top[i].hash,
+                      subsystemName(top[i].subsystem),
+                      (unsigned long)top[i].count,
+                      (unsigned long)top[i].bytes);
+        }
+    }
+
+    ALLOC_LOG("Live pointers: %lu/%u, untracked allocs=%lu frees=%lu, site overflow=%lu\n",
+              (unsigned long)live_count, (unsigned)ALLOC_TRACKER_MAX_LIVE,
+              (unsigned long)untracked_allocs, (unsigned long)untracked_frees,
+              (unsigned long)site_overflow);
+    ALLOC_LOG("===============================\n");
+}
+
+// ============================================================================
+// Allocator Hooks
+// ============================================================================
+
+#define ALLOC_CALLER() reinterpret_cast<uintptr_t>(__builtin_return_address(0))
+
+#ifdef NATIVE_BUILD
+
+// Host interposer: definitions in the executable take precedence over libc
+// for every caller, including operator new in the shared libstdc++.
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) noexcept {
+    void* ptr = __libc_malloc(size);
+    AllocTracker::onAlloc(ptr, size, ALLOC_CALLER());
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    void* ptr = __libc_calloc(count, size);
+    AllocTracker::onAlloc(ptr, count * size, ALLOC_CALLER());
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) noexcept {
+    void* new_ptr = __libc_realloc(ptr, size);
+    if (new_ptr != nullptr || size == 0) {
+        AllocTracker::onFree(ptr);
+    }
+    AllocTracker::onAlloc(new_ptr, size, ALLOC_CALLER());
+    return new_ptr;
+}
+
+void free(void* ptr) noexcept {
+    AllocTracker::onFree(ptr);
+    __libc_free(ptr);
+}
+
+}  // extern "C"
+
+#else
+
+// Device hooks via -Wl,--wrap=<symbol> (see env:m5stack-core2-alloctrack).
+// free() is not wrapped: newlib's free() calls heap_caps_free(), which is.
+extern "C" {
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_heap_caps_malloc(size_t size, uint32_t caps);
+void* __real_heap_caps_calloc(size_t count, size_t size, uint32_t caps);
+void* __real_heap_caps_realloc(void* ptr, size_t size, uint32_t caps);
+void __real_heap_caps_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    void* ptr = __real_malloc(size);
+    AllocTracker::onAlloc(ptr, size, ALLOC_CALLER());
+    return ptr;
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    void* ptr = __real_calloc(count, size);
+    AllocTracker::onAlloc(ptr, count * size, ALLOC_CALLER());
+    return ptr;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    void* new_ptr = __real_realloc(ptr, size);
+    if (new_ptr != nullptr || size == 0) {
+        AllocTracker::onFree(ptr);
+    }
+    AllocTracker::onAlloc(new_ptr, size, ALLOC_CALLER());
+    return new_ptr;
+}
+
+void* __wrap_heap_caps_malloc(size_t size, uint32_t caps) {
+    void* ptr = __real_heap_caps_malloc(size, caps);
+    AllocTracker::onAlloc(ptr, size, ALLOC_CALLER());
+    return ptr;
+}
+
+void* __wrap_heap_caps_calloc(size_t count, size_t size, uint32_t caps) {
+    void* ptr = __real_heap_caps_calloc(count, size, caps);
+    AllocTracker::onAlloc(ptr, count * size, ALLOC_CALLER());
+    return ptr;
+}
+
+void* __wrap_heap_caps_realloc(void* ptr, size_t size, uint32_t caps) {
+    void* new_ptr = __real_heap_caps_realloc(ptr, size, caps);
+    if (new_ptr != nullptr || size == 0) {
+        AllocTracker::onFree(ptr);
+    }
+    AllocTracker::onAlloc(new_ptr, size, ALLOC_CALLER());
+    return new_ptr;
+}
+
+void __wrap_heap_caps_free(void* ptr) {
+    AllocTracker::onFree(ptr);
+    __real_heap_caps_free(ptr);
+}
+
+}  // extern "C"
+
+#endif  // NATIVE_BUILD
+
+#else  // !ALLOC_TRACKING
+
+// Tracking compiled out: queries return empty data, no hooks installed
+
+void AllocTracker::onAlloc(void*, size_t, uintptr_t) {}
+void AllocTracker::onFree(void*) {}
+AllocTracker::Subsystem AllocTracker::currentSubsystem() { return Subsystem::UNTAGGED; }
+const char* AllocTracker::subsystemName(Subsystem) { return "UNTAGGED"; }
+AllocTracker::SubsystemStats AllocTracker::getStats(Subsystem) { return SubsystemStats{}; }
+AllocTracker::SubsystemStats AllocTracker::getTotals() { return SubsystemStats{}; }
+uint32_t AllocTracker::getUntrackedAllocs() { return 0; }
+uint32_t AllocTracker::getUntrackedFrees() { return 0; }
+size_t AllocTracker::getTopSites(CallSite*, size_t) { return 0; }
+void AllocTracker::reset() {}
+void AllocTracker::printReport() {}
+
+AllocTracker::Scope::Scope(Subsystem, uint32_t) : prev_subsystem_(0), prev_site_(0) {}
+AllocTracker::Scope::~Scope() {}
+
+#endif  // ALLOC_TRACKING
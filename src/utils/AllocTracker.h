@@ -0,0 +1,155 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef ALLOC_TRACKING
+#define ALLOC_TRACKING 0
+#endif
+
+/**
+ * Heap allocation tracker with per-subsystem attribution
+ *
+ * Records every heap allocation made while tracking is compiled in and
+ * attributes it to the subsystem scope that was active on the calling
+ * context (ALLOC_SCOPE). Answers "who allocates what" for the hidden
+ * allocators in the tree: std::vector growth in Renderer/TouchEventManager,
+ * Arduino String in SDManager/NetworkConfig, std::function captures.
+ *
+ * Hooks:
+ * - Device: linker wrapping (-Wl,--wrap=malloc,...) of malloc/calloc/realloc
+ *   and heap_caps_malloc/calloc/realloc/free. free() reaches heap_caps_free
+ *   internally, so only the heap_caps layer is wrapped for frees.
+ * - Host (NATIVE_BUILD): malloc/free/calloc/realloc interposed in the
+ *   executable, forwarding to glibc's __libc_* entry points. Covers
+ *   operator new/delete in the shared libstdc++ as well.
+ *
+ * Per subsystem: allocation/free counts, live bytes, peak live bytes and
+ * total bytes. Per call site (scope site hash ^ caller address): count and
+ * bytes, top sites kept in a fixed table.
+ *
+ * Memory: everything lives in fixed static tables, the tracker never
+ * allocates. Frees are attributed to the subsystem that made the
+ * allocation via a live-pointer table (ALLOC_TRACKER_MAX_LIVE entries);
+ * allocations that do not fit are counted as "untracked".
+ *
+ * Scope context:
+ * - Device: one scope slot per core (tasks are pinned, scopes are short).
+ *   A task preempted inside a scope can mis-attribute a few allocations of
+ *   another task on the same core - acceptable for a diagnostics build.
+ * - Host: one scope slot per thread.
+ *
+ * Usage:
+ *   void Renderer::markDirty(...) {
+ *       ALLOC_SCOPE(RENDERER);
+ *       dirty_rects.push_back(rect);   // attributed to RENDERER
+ *   }
+ *
+ *   AllocTracker::printReport();       // from the task monitor
+ *
+ * Build: env:m5stack-core2-alloctrack (device), env:native (host).
+ * With ALLOC_TRACKING=0 the scopes compile to nothing and no hooks exist.
+ */
+class AllocTracker {
+public:
+    enum class Subsystem : uint8_t {
+        UNTAGGED,        // Allocation outside any scope
+        UI_FRAME,        // UITask frame loop (catch-all for the frame path)
+        RENDERER,        // Renderer dirty rects, canvas
+        TOUCH,           // TouchEventManager widget list
+        SCREENS,         // ScreenManager / screens / widgets
+        TIMER,           // TimerStateMachine + callbacks
+        SEQUENCE,        // PomodoroSequence
+        STATS,           // Statistics (NVS)
+        CONFIG,          // Config (NVS)
+        SD,              // SDManager file I/O
+        NETWORK_CONFIG,  // NetworkConfig INI / certificates
+        AUDIO,           // AudioPlayer buffers
+        LED,             // LEDController
+        NETWORK,         // NetworkTask, WiFi, NTP
+        COUNT
+    };
+
+    struct SubsystemStats {
+        uint32_t alloc_count;   // Successful allocations
+        uint32_t free_count;    // Frees of tracked pointers
+        uint32_t live_bytes;    // Currently allocated
+        uint32_t peak_bytes;    // High-water mark of live_bytes
+        uint32_t total_bytes;   // Cumulative bytes allocated
+    };
+
+    struct CallSite {
+        uint32_t hash;          // Scope site hash ^ caller address
+        Subsystem subsystem;
+        uint32_t count;
+        uint32_t bytes;
+    };
+
+    // Table sizes (fixed, no heap)
+    static constexpr size_t MAX_SITES = 64;
+
+    // Hook entry points (called from the malloc wrappers)
+    static void onAlloc(void* ptr, size_t size, uintptr_t caller);
+    static void onFree(void* ptr);
+
+    // Scope management
+    static Subsystem currentSubsystem();
+    static const char* subsystemName(Subsystem subsystem);
+
+    // Queries (snapshots, safe to call from any task)
+    static SubsystemStats getStats(Subsystem subsystem);
+    static SubsystemStats getTotals();
+    static uint32_t getUntrackedAllocs();   // Live table full
+    static uint32_t getUntrackedFrees();     // Pointer not in live table
+    static size_t getTopSites(CallSite* out, size_t max_sites);  // Sorted by bytes
+
+    // Reset counters (live pointers are forgotten, peaks restart at 0)
+    static void reset();
+
+    // Print per-subsystem table and top call sites (Serial on device, stdout on host)
+    static void printReport();
+
+    static constexpr bool isEnabled() { return ALLOC_TRACKING != 0; }
+
+    // Compile-time FNV-1a hash of a scope location (file + line)
+    static constexpr uint32_t siteHash(const char* file, uint32_t line) {
+        uint32_t h = 2166136261u;
+        for (const char* p = file; *p; ++p) {
+            h = (h ^ static_cast<uint8_t>(*p)) * 16777619u;
+        }
+        return (h ^ line) * 16777619u;
+    }
+
+    /**
+     * RAII subsystem scope
+     *
+     * Sets the active subsystem tag for the current context and restores the
+     * previous one on destruction, so scopes nest (UI_FRAME → RENDERER → ...).
+     */
+    class Scope {
+    public:
+        Scope(Subsystem subsystem, uint32_t site_hash);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        uint8_t prev_subsystem_;
+        uint32_t prev_site_;
+    };
+};
+
+#define ALLOC_SCOPE_CONCAT_INNER(a, b) a##b
+#define ALLOC_SCOPE_CONCAT(a, b) ALLOC_SCOPE_CONCAT_INNER(a, b)
+
+#if ALLOC_TRACKING
+#define ALLOC_SCOPE(subsystem) \
+    AllocTracker::Scope ALLOC_SCOPE_CONCAT(_alloc_scope_, __LINE__)( \
+        AllocTracker::Subsystem::subsystem, AllocTracker::siteHash(__FILE__, __LINE__))
+#else
+#define ALLOC_SCOPE(subsystem) do {} while (0)
+#endif
+
+#endif // ALLOC_TRACKER_H
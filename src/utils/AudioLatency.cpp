@@ -0,0 +1,273 @@
+#include "AudioLatency.h"
+
+#if AUDIO_LATENCY_TRACE
+
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+
+#ifdef NATIVE_BUILD
+#include <stdio.h>
+#define LATENCY_LOG(...) printf(__VA_ARGS__)
+#else
+#include <freertos/FreeRTOS.h>
+#define LATENCY_LOG(...) Serial.printf(__VA_ARGS__)
+#endif
+
+// ============================================================================
+// Tracer State (static, never heap-allocated)
+// ============================================================================
+
+namespace {
+
+constexpr size_t S = AudioLatency::STAGES;
+
+AudioLatency::Event s_current;
+bool s_in_flight = false;
+AudioLatency::Event s_history[AudioLatency::HISTORY];
+size_t s_history_next = 0;
+size_t s_history_count = 0;
+AudioLatency::Stats s_stats;
+
+// ----------------------------------------------------------------------------
+// Lock: spinlock, no allocation, short critical sections only
+// ----------------------------------------------------------------------------
+
+#ifdef NATIVE_BUILD
+std::atomic_flag s_lock = ATOMIC_FLAG_INIT;
+
+inline void lock() {
+    while (s_lock.test_and_set(std::memory_order_acquire)) {
+        // spin
+    }
+}
+
+inline void unlock() {
+    s_lock.clear(std::memory_order_release);
+}
+#else
+portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+inline void lock() {
+    portENTER_CRITICAL(&s_lock);
+}
+
+inline void unlock() {
+    portEXIT_CRITICAL(&s_lock);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// Event bookkeeping (call with lock held)
+// ----------------------------------------------------------------------------
+
+void addSample(AudioLatency::Segment& segment, uint32_t us) {
+    if (segment.count == 0 || us < segment.min_us) segment.min_us = us;
+    if (us > segment.max_us) segment.max_us = us;
+    segment.total_us += us;
+    segment.count++;
+}
+
+void startLocked(const char* name, uint32_t now_us, AudioLatency::Stage stage) {
+    if (s_in_flight) {
+        s_stats.superseded++;
+    }
+    memset(&s_current, 0, sizeof(s_current));
+    strncpy(s_current.name, name ? name : "?", AudioLatency::NAME_LEN - 1);
+    size_t index = static_cast<size_t>(stage);
+    s_current.at_us[index] = now_us;
+    s_current.reached[index] = true;
+    s_in_flight = true;
+}
+
+void markLocked(AudioLatency::Stage stage, uint32_t now_us) {
+    if (!s_in_flight) return;
+    size_t index = static_cast<size_t>(stage);
+    if (s_current.reached[index]) return;   // First time counts (retries, repeated polls)
+    s_current.at_us[index] = now_us;
+    s_current.reached[index] = true;
+}
+
+void finishLocked() {
+    size_t first = S;
+    size_t previous = S;
+    for (size_t i = 0; i < S; i++) {
+        if (!s_current.reached[i]) continue;
+        if (first == S) first = i;
+        if (previous != S) {
+            addSample(s_stats.stage[i], s_current.at_us[i] - s_current.at_us[previous]);
+        }
+        previous = i;
+    }
+    // OUTPUT is an estimate (submit + DMA depth): measured total stops at SUBMIT
+    size_t submit = static_cast<size_t>(AudioLatency::Stage::SUBMIT);
+    addSample(s_stats.measured, s_current.at_us[submit] - s_current.at_us[first]);
+    s_stats.events++;
+
+    s_history[s_history_next] = s_current;
+    s_history_next = (s_history_next + 1) % AudioLatency::HISTORY;
+    if (s_history_count < AudioLatency::HISTORY) s_history_count++;
+    s_in_flight = false;
+}
+
+}  // namespace
+
+// ============================================================================
+// Hooks
+// ============================================================================
+
+void AudioLatency::trigger(const char* name, uint32_t schedule_late_ms, uint32_t now_us) {
+    lock();
+    startLocked(name, now_us, Stage::TRIGGER);
+    s_current.schedule_late_ms = schedule_late_ms;
+    if (schedule_late_ms > 0) {
+        addSample(s_stats.schedule_late, schedule_late_ms * 1000);
+    }
+    unlock();
+}
+
+void AudioLatency::dispatch(const char* name, uint32_t now_us) {
+    lock();
+    size_t submit = static_cast<size_t>(Stage::SUBMIT);
+    if (s_in_flight && !s_current.reached[submit]) {
+        // The triggered sound arriving (or play() falling back to a tone)
+        markLocked(Stage::DISPATCH, now_us);
+    } else {
+        startLocked(name, now_us, Stage::DISPATCH);   // Played directly (UI beep)
+    }
+    unlock();
+}
+
+void AudioLatency::submit(uint32_t now_us) {
+    lock();
+    markLocked(Stage::SUBMIT, now_us);
+    unlock();
+}
+
+void AudioLatency::output(uint32_t at_us) {
+    lock();
+    size_t submit = static_cast<size_t>(Stage::SUBMIT);
+    if (s_in_flight && s_current.reached[submit]) {
+        markLocked(Stage::OUTPUT, at_us);
+        finishLocked();
+    }
+    unlock();
+}
+
+void AudioLatency::cancel() {
+    lock();
+    if (s_in_flight) {
+        s_stats.cancelled++;
+        s_in_flight = false;
+    }
+    unlock();
+}
+
+void AudioLatency::underrun(uint32_t gap_us) {
+    lock();
+    s_stats.underruns++;
+    s_stats.underrun_us += gap_us;
+    if (gap_us > s_stats.max_underrun_us) s_stats.max_underrun_us = gap_us;
+    unlock();
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+AudioLatency::Stats AudioLatency::getStats() {
+    lock();
+    Stats stats = s_stats;
+    unlock();
+    return stats;
+}
+
+size_t AudioLatency::getHistory(Event* out, size_t max) {
+    lock();
+    size_t count = s_history_count < max ? s_history_count : max;
+    for (size_t i = 0; i < count; i++) {
+        size_t index = (s_history_next + HISTORY - 1 - i) % HISTORY;
+        out[i] = s_history[index];
+    }
+    unlock();
+    return count;
+}
+
+void AudioLatency::reset() {
+    lock();
+    memset(&s_current, 0, sizeof(s_current));
+    memset(s_history, 0, sizeof(s_history));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_in_flight = false;
+    s_history_next = 0;
+    s_history_count = 0;
+    unlock();
+}
+
+const char* AudioLatency::stageName(Stage stage) {
+    switch (stage) {
+        case Stage::TRIGGER:  return "trigger";
+        case Stage::DISPATCH: return "dispatch";
+        case Stage::SUBMIT:   return "submit";
+        case Stage::OUTPUT:   return "output~";
+        default:              return "?";
+    }
+}
+
+void AudioLatency::printReport() {
+    Stats stats = getStats();
+    Event history[HISTORY];
+    size_t count = getHistory(history, HISTORY);
+
+    LATENCY_LOG("\n=== Audio Latency ===\n");
+    LATENCY_LOG("%u sounds, %u cancelled, %u superseded before output\n",
+                (unsigned)stats.events, (unsigned)stats.cancelled, (unsigned)stats.superseded);
+    LATENCY_LOG("%-20s %6s %9s %9s %9s\n", "segment (ms)", "count", "min", "mean", "max");
+
+    auto row = [](const char* label, const Segment& segment) {
+        LATENCY_LOG("%-20s %6u %9.2f %9.2f %9.2f\n", label, (unsigned)segment.count,
+                    segment.min_us / 1000.0f, segment.meanUs() / 1000.0f, segment.max_us / 1000.0f);
+    };
+    row("trigger->dispatch", stats.stage[static_cast<size_t>(Stage::DISPATCH)]);
+    row("dispatch->submit", stats.stage[static_cast<size_t>(Stage::SUBMIT)]);
+    row("measured total", stats.measured);
+    row("submit->output est", stats.stage[static_cast<size_t>(Stage::OUTPUT)]);
+    row("trigger late", stats.schedule_late);
+    LATENCY_LOG("Underruns: %u (%.1f ms total, max %.1f ms)\n", (unsigned)stats.underruns,
+                stats.underrun_us / 1000.0f, stats.max_underrun_us / 1000.0f);
+
+    for (size_t i = 0; i < count; i++) {
+        const Event& event = history[i];
+        size_t first = 0;
+        while (first < S && !event.reached[first]) first++;
+        LATENCY_LOG("  %-16s", event.name);
+        for (size_t s = first + 1; s < S; s++) {
+            if (!event.reached[s]) continue;
+            LATENCY_LOG(" %s +%.1f", stageName(static_cast<Stage>(s)),
+                        (event.at_us[s] - event.at_us[first]) / 1000.0f);
+        }
+        if (event.schedule_late_ms > 0) {
+            LATENCY_LOG(" (trigger %u ms late)", (unsigned)event.schedule_late_ms);
+        }
+        LATENCY_LOG("\n");
+    }
+    LATENCY_LOG("=====================\n");
+}
+
+#else  // !AUDIO_LATENCY_TRACE
+
+// Tracing compiled out: hooks do nothing, queries return empty data
+
+void AudioLatency::trigger(const char*, uint32_t, uint32_t) {}
+void AudioLatency::dispatch(const char*, uint32_t) {}
+void AudioLatency::submit(uint32_t) {}
+void AudioLatency::output(uint32_t) {}
+void AudioLatency::cancel() {}
+void AudioLatency::underrun(uint32_t) {}
+AudioLatency::Stats AudioLatency::getStats() { return Stats{}; }
+size_t AudioLatency::getHistory(Event*, size_t) { return 0; }
+void AudioLatency::printReport() {}
+void AudioLatency::reset() {}
+const char* AudioLatency::stageName(Stage) { return "?"; }
+
+#endif  // AUDIO_LATENCY_TRACE
@@ -0,0 +1,126 @@
+#ifndef AUDIO_LATENCY_H
+#define AUDIO_LATENCY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef AUDIO_LATENCY_TRACE
+#define AUDIO_LATENCY_TRACE 0
+#endif
+
+/**
+ * Audio event-to-sound latency tracer
+ *
+ * A sound goes through TimerStateMachine (audio callback), the main.cpp
+ * dispatch lambda, AudioPlayer::play() (stop() first, cache lookup) and
+ * the speaker sink before the DAC outputs anything. Each sound is one
+ * event timestamped (µs) at four stages:
+ * - TRIGGER: the state machine decides to play (warning, session start)
+ * - DISPATCH: AudioPlayer::play() / playTone() entered
+ * - SUBMIT: the clip was handed to the speaker
+ * - OUTPUT: first sample at the DAC, estimated by the sink's SpeakerMonitor
+ *   as submit + DMA queue depth (nothing on the device timestamps the DAC)
+ *
+ * Per segment (trigger→dispatch, dispatch→submit, submit→output) and the
+ * measured total (first stage → submit): count, min, mean, max. The
+ * submit→output segment is an estimate and is reported apart, never added
+ * to the measured total. Scheduled events also carry how late the
+ * trigger itself was (the 30 s warning is checked once per timer update,
+ * so it fires up to one update interval after the 30 s mark). Sounds
+ * played without a trigger (UI beeps) start at DISPATCH.
+ *
+ * Speaker underruns (DMA ran dry while a clip still had samples) are
+ * counted with their total gap.
+ *
+ * Memory: one event in flight + HISTORY completed events (~0.5 KB static).
+ *
+ * Usage:
+ *   AUDIO_TRIGGER("warning", late_ms);    // TimerStateMachine
+ *   AUDIO_DISPATCH("warning");            // AudioPlayer::play()
+ *   AUDIO_SUBMIT();                       // Clip queued on the speaker
+ *   AUDIO_OUTPUT(first_sample_us);        // Speaker sink
+ *   AudioLatency::printReport();          // Task monitor
+ *
+ * Build: env:m5stack-core2-profile (device), env:native (host).
+ * With AUDIO_LATENCY_TRACE=0 the hooks compile to nothing.
+ */
+class AudioLatency {
+public:
+    enum class Stage : uint8_t {
+        TRIGGER,
+        DISPATCH,
+        SUBMIT,
+        OUTPUT,
+        COUNT
+    };
+
+    static constexpr size_t STAGES = static_cast<size_t>(Stage::COUNT);
+    static constexpr size_t HISTORY = 8;
+    static constexpr size_t NAME_LEN = 16;
+
+    struct Event {
+        char name[NAME_LEN];
+        uint32_t at_us[STAGES];       // Stage timestamps; 0 = not reached
+        bool reached[STAGES];
+        uint32_t schedule_late_ms;    // Trigger behind its due time
+    };
+
+    struct Segment {
+        uint32_t count;
+        uint32_t min_us;
+        uint32_t max_us;
+        uint64_t total_us;
+
+        uint32_t meanUs() const { return count ? static_cast<uint32_t>(total_us / count) : 0; }
+    };
+
+    struct Stats {
+        Segment stage[STAGES];        // [s] = previous reached stage → s (TRIGGER unused)
+        Segment measured;             // First stage → SUBMIT (OUTPUT is estimated)
+        Segment schedule_late;        // Scheduled triggers, in µs
+        uint32_t events;              // Reached OUTPUT (mixer picked the clip up)
+        uint32_t cancelled;           // Muted / playback failed
+        uint32_t superseded;          // Next sound started before OUTPUT
+        uint32_t underruns;
+        uint64_t underrun_us;
+        uint32_t max_underrun_us;
+    };
+
+    static void trigger(const char* name, uint32_t schedule_late_ms, uint32_t now_us);
+    static void dispatch(const char* name, uint32_t now_us);
+    static void submit(uint32_t now_us);
+    static void output(uint32_t at_us);
+    static void cancel();
+    static void underrun(uint32_t gap_us);
+
+    static Stats getStats();
+
+    /**
+     * Completed events, newest first
+     * @return Events written
+     */
+    static size_t getHistory(Event* out, size_t max);
+
+    static void printReport();
+    static void reset();
+
+    static const char* stageName(Stage stage);
+};
+
+#if AUDIO_LATENCY_TRACE
+#define AUDIO_TRIGGER(name, late_ms) AudioLatency::trigger((name), (late_ms), micros())
+#define AUDIO_DISPATCH(name) AudioLatency::dispatch((name), micros())
+#define AUDIO_SUBMIT() AudioLatency::submit(micros())
+#define AUDIO_OUTPUT(at_us) AudioLatency::output(at_us)
+#define AUDIO_CANCEL() AudioLatency::cancel()
+#define AUDIO_UNDERRUN(gap_us) AudioLatency::underrun(gap_us)
+#else
+#define AUDIO_TRIGGER(name, late_ms) do {} while (0)
+#define AUDIO_DISPATCH(name) do {} while (0)
+#define AUDIO_SUBMIT() do {} while (0)
+#define AUDIO_OUTPUT(at_us) do {} while (0)
+#define AUDIO_CANCEL() do {} while (0)
+#define AUDIO_UNDERRUN(gap_us) do {} while (0)
+#endif
+
+#endif // AUDIO_LATENCY_H
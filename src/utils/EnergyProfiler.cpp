@@ -0,0 +1,410 @@
+#include "EnergyProfiler.h"
+
+#if ENERGY_PROFILING
+
+#include <Arduino.h>
+#include <atomic>
+#include <math.h>
+#include <string.h>
+
+#ifdef NATIVE_BUILD
+#include <stdio.h>
+#define ENERGY_LOG(...) printf(__VA_ARGS__)
+#else
+#include <freertos/FreeRTOS.h>
+#define ENERGY_LOG(...) Serial.printf(__VA_ARGS__)
+#endif
+
+// ============================================================================
+// Profiler State (static, never heap-allocated)
+// ============================================================================
+
+namespace {
+
+constexpr size_t N = EnergyProfiler::SUBSYSTEMS;
+constexpr size_t T = EnergyProfiler::TERMS;
+constexpr uint32_t MIN_SAMPLES = 2 * EnergyProfiler::TERMS;
+constexpr double RIDGE = 1e-3;   // × total weight, on subsystem terms only
+
+// Weighted normal equations, term 0 = baseline (weights in seconds)
+struct Regression {
+    double xtx[T][T];
+    double xty[T];
+    double yy;
+    uint32_t samples;
+};
+
+struct StateTotals {
+    double ms;
+    double activity_ms[N];       // Σ activity × dt
+    double charge_ma_ms;         // Σ measured current × dt
+};
+
+// Activity window since the last current sample, split by timer state
+float s_level[N];
+double s_window_integral[N];     // level × ms
+StateTotals s_window_states[EnergyProfiler::STATES];
+uint32_t s_window_start_ms = 0;
+uint32_t s_advanced_ms = 0;
+bool s_window_open = false;
+uint8_t s_state = 0;
+
+Regression s_reg;
+StateTotals s_states[EnergyProfiler::STATES];
+uint32_t s_discarded = 0;        // Windows on external power or too long
+
+// ----------------------------------------------------------------------------
+// Lock: spinlock, no allocation, short critical sections only
+// ----------------------------------------------------------------------------
+
+#ifdef NATIVE_BUILD
+std::atomic_flag s_lock = ATOMIC_FLAG_INIT;
+
+inline void lock() {
+    while (s_lock.test_and_set(std::memory_order_acquire)) {
+        // spin
+    }
+}
+
+inline void unlock() {
+    s_lock.clear(std::memory_order_release);
+}
+#else
+portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+inline void lock() {
+    portENTER_CRITICAL(&s_lock);
+}
+
+inline void unlock() {
+    portEXIT_CRITICAL(&s_lock);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// Window bookkeeping (call with lock held)
+// ----------------------------------------------------------------------------
+
+void advanceLocked(uint32_t now_ms) {
+    if (!s_window_open) return;
+    uint32_t dt = now_ms - s_advanced_ms;
+    if (static_cast<int32_t>(dt) <= 0) return;
+    StateTotals& state = s_window_states[s_state];
+    state.ms += dt;
+    for (size_t i = 0; i < N; i++) {
+        s_window_integral[i] += s_level[i] * dt;
+        state.activity_ms[i] += s_level[i] * dt;
+    }
+    s_advanced_ms = now_ms;
+}
+
+void openWindowLocked(uint32_t now_ms) {
+    memset(s_window_integral, 0, sizeof(s_window_integral));
+    memset(s_window_states, 0, sizeof(s_window_states));
+    s_window_start_ms = now_ms;
+    s_advanced_ms = now_ms;
+    s_window_open = true;
+}
+
+// Solve a·x = b in place (Gaussian elimination, partial pivoting)
+bool solve(double a[T][T], double b[T], double x[T]) {
+    for (size_t col = 0; col < T; col++) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < T; row++) {
+            if (fabs(a[row][col]) > fabs(a[pivot][col])) pivot = row;
+        }
+        if (fabs(a[pivot][col]) < 1e-12) return false;
+        if (pivot != col) {
+            for (size_t k = 0; k < T; k++) {
+                double tmp = a[col][k];
+                a[col][k] = a[pivot][k];
+                a[pivot][k] = tmp;
+            }
+            double tmp = b[col];
+            b[col] = b[pivot];
+            b[pivot] = tmp;
+        }
+        for (size_t row = col + 1; row < T; row++) {
+            double f = a[row][col] / a[col][col];
+            for (size_t k = col; k < T; k++) {
+                a[row][k] -= f * a[col][k];
+            }
+            b[row] -= f * b[col];
+        }
+    }
+    for (size_t i = T; i-- > 0;) {
+        double sum = b[i];
+        for (size_t k = i + 1; k < T; k++) {
+            sum -= a[i][k] * x[k];
+        }
+        x[i] = sum / a[i][i];
+    }
+    return true;
+}
+
+const char* const SUBSYSTEM_NAMES[N] = {
+    "backlight", "leds", "speaker", "haptic", "wifi", "cpu"
+};
+
+const char* const STATE_NAMES[EnergyProfiler::STATES] = {
+    "IDLE", "ACTIVE", "PAUSED"
+};
+
+}  // namespace
+
+// ============================================================================
+// Activity Hooks
+// ============================================================================
+
+void EnergyProfiler::setActivity(Subsystem subsystem, float level, uint32_t now_ms) {
+    size_t index = static_cast<size_t>(subsystem);
+    if (index >= N) return;
+    if (level < 0.0f) level = 0.0f;
+    if (level > 1.0f) level = 1.0f;
+
+    lock();
+    advanceLocked(now_ms);
+    s_level[index] = level;
+    unlock();
+}
+
+void EnergyProfiler::setTimerState(uint8_t state, uint32_t now_ms) {
+    if (state >= STATES) return;
+
+    lock();
+    advanceLocked(now_ms);
+    s_state = state;
+    unlock();
+}
+
+void EnergyProfiler::addSample(float discharge_ma, uint32_t now_ms, bool on_battery) {
+    lock();
+    if (!s_window_open) {
+        openWindowLocked(now_ms);
+        unlock();
+        return;
+    }
+
+    advanceLocked(now_ms);
+    uint32_t dt_ms = now_ms - s_window_start_ms;
+    if (!on_battery || dt_ms == 0 || dt_ms > MAX_SAMPLE_GAP_MS) {
+        s_discarded++;
+        openWindowLocked(now_ms);
+        unlock();
+        return;
+    }
+
+    // Mean activity over the window is the regressor
+    double x[T];
+    x[0] = 1.0;
+    for (size_t i = 0; i < N; i++) {
+        x[i + 1] = s_window_integral[i] / dt_ms;
+    }
+    double w = dt_ms / 1000.0;
+    double y = discharge_ma;
+
+    for (size_t r = 0; r < T; r++) {
+        for (size_t c = 0; c < T; c++) {
+            s_reg.xtx[r][c] += w * x[r] * x[c];
+        }
+        s_reg.xty[r] += w * x[r] * y;
+    }
+    s_reg.yy += w * y * y;
+    s_reg.samples++;
+
+    // A window spanning a state change is split by time; the measured
+    // current is the window mean, so charge is split the same way
+    for (uint8_t st = 0; st < EnergyProfiler::STATES; st++) {
+        const StateTotals& part = s_window_states[st];
+        StateTotals& totals = s_states[st];
+        totals.ms += part.ms;
+        for (size_t i = 0; i < N; i++) {
+            totals.activity_ms[i] += part.activity_ms[i];
+        }
+        totals.charge_ma_ms += y * part.ms;
+    }
+
+    openWindowLocked(now_ms);
+    unlock();
+}
+
+// ============================================================================
+// Model
+// ============================================================================
+
+EnergyProfiler::Model EnergyProfiler::fit() {
+    lock();
+    Regression reg = s_reg;
+    unlock();
+
+    Model model = {};
+    model.samples = reg.samples;
+    double sum_w = reg.xtx[0][0];
+    model.hours = static_cast<float>(sum_w / 3600.0);
+    if (reg.samples < MIN_SAMPLES || sum_w <= 0.0) {
+        return model;
+    }
+
+    double a[T][T];
+    double b[T];
+    double coef[T] = {};
+    memcpy(a, reg.xtx, sizeof(a));
+    memcpy(b, reg.xty, sizeof(b));
+    for (size_t i = 1; i < T; i++) {
+        a[i][i] += RIDGE * sum_w;
+    }
+    if (!solve(a, b, coef)) {
+        return model;
+    }
+
+    // Weighted residuals from the normal equations: SSE = yy - 2bᵀXᵀy + bᵀXᵀXb
+    double fitted = 0.0;
+    double quad = 0.0;
+    for (size_t r = 0; r < T; r++) {
+        fitted += coef[r] * reg.xty[r];
+        for (size_t c = 0; c < T; c++) {
+            quad += coef[r] * reg.xtx[r][c] * coef[c];
+        }
+    }
+    double sse = reg.yy - 2.0 * fitted + quad;
+    if (sse < 0.0) sse = 0.0;
+    double mean_y = reg.xty[0] / sum_w;
+    double sst = reg.yy - sum_w * mean_y * mean_y;
+
+    model.valid = true;
+    model.baseline_ma = static_cast<float>(coef[0]);
+    for (size_t i = 0; i < N; i++) {
+        model.ma[i] = static_cast<float>(coef[i + 1]);
+        double mean = reg.xtx[0][i + 1] / sum_w;
+        double variance = reg.xtx[i + 1][i + 1] / sum_w - mean * mean;
+        model.excited[i] = variance > 0.0 && sqrt(variance) >= MIN_EXCITATION;
+    }
+    model.r2 = sst > 0.0 ? static_cast<float>(1.0 - sse / sst) : 1.0f;
+    model.rms_error_ma = static_cast<float>(sqrt(sse / sum_w));
+    return model;
+}
+
+namespace {
+
+EnergyProfiler::Attribution attributeTotals(const EnergyProfiler::Model& model,
+                                            const StateTotals& totals) {
+    EnergyProfiler::Attribution out = {};
+    out.hours = static_cast<float>(totals.ms / 3600000.0);
+    if (totals.ms <= 0.0) return out;
+
+    // Average current over the state's time = mAh drawn per hour in it
+    out.measured_ma = static_cast<float>(totals.charge_ma_ms / totals.ms);
+    if (!model.valid) return out;
+
+    out.baseline_mah_per_hour = model.baseline_ma;
+    for (size_t i = 0; i < N; i++) {
+        out.mah_per_hour[i] = static_cast<float>(model.ma[i] * totals.activity_ms[i] / totals.ms);
+    }
+    return out;
+}
+
+}  // namespace
+
+EnergyProfiler::Attribution EnergyProfiler::attribute(const Model& model) {
+    StateTotals sum = {};
+    lock();
+    for (uint8_t s = 0; s < STATES; s++) {
+        sum.ms += s_states[s].ms;
+        sum.charge_ma_ms += s_states[s].charge_ma_ms;
+        for (size_t i = 0; i < N; i++) {
+            sum.activity_ms[i] += s_states[s].activity_ms[i];
+        }
+    }
+    unlock();
+    return attributeTotals(model, sum);
+}
+
+EnergyProfiler::Attribution EnergyProfiler::attribute(const Model& model, uint8_t state) {
+    if (state >= STATES) return Attribution{};
+    lock();
+    StateTotals totals = s_states[state];
+    unlock();
+    return attributeTotals(model, totals);
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+const char* EnergyProfiler::subsystemName(Subsystem subsystem) {
+    size_t index = static_cast<size_t>(subsystem);
+    return index < N ? SUBSYSTEM_NAMES[index] : "?";
+}
+
+void EnergyProfiler::reset() {
+    lock();
+    memset(&s_reg, 0, sizeof(s_reg));
+    memset(s_states, 0, sizeof(s_states));
+    memset(s_level, 0, sizeof(s_level));
+    memset(s_window_integral, 0, sizeof(s_window_integral));
+    memset(s_window_states, 0, sizeof(s_window_states));
+    s_window_open = false;
+    s_state = 0;
+    s_discarded = 0;
+    unlock();
+}
+
+void EnergyProfiler::printReport() {
+    // Snapshot first: printing must not hold the spinlock
+    Model model = fit();
+    Attribution total = attribute(model);
+    Attribution states[STATES];
+    for (uint8_t s = 0; s < STATES; s++) {
+        states[s] = attribute(model, s);
+    }
+    lock();
+    uint32_t discarded = s_discarded;
+    unlock();
+
+    ENERGY_LOG("\n=== Energy Attribution ===\n");
+    ENERGY_LOG("On battery: %.2f h, %lu samples (%lu windows discarded)\n",
+               total.hours, (unsigned long)model.samples, (unsigned long)discarded);
+    if (!model.valid) {
+        ENERGY_LOG("Not enough battery samples for a fit (need %lu)\n",
+                   (unsigned long)MIN_SAMPLES);
+        ENERGY_LOG("==========================\n");
+        return;
+    }
+
+    ENERGY_LOG("Model: baseline %.1f mA, R2=%.3f, rms %.1f mA\n",
+               model.baseline_ma, model.r2, model.rms_error_ma);
+    ENERGY_LOG("%-10s %8s  %8s %8s %8s %8s\n",
+               "Subsystem", "mA@100%", "all", STATE_NAMES[0], STATE_NAMES[1], STATE_NAMES[2]);
+    ENERGY_LOG("%-10s %8s  %8.1f %8.1f %8.1f %8.1f\n", "baseline", "",
+               total.baseline_mah_per_hour, states[0].baseline_mah_per_hour,
+               states[1].baseline_mah_per_hour, states[2].baseline_mah_per_hour);
+    for (size_t i = 0; i < N; i++) {
+        ENERGY_LOG("%-10s %8.1f%c %8.1f %8.1f %8.1f %8.1f\n",
+                   SUBSYSTEM_NAMES[i], model.ma[i], model.excited[i] ? ' ' : '*',
+                   total.mah_per_hour[i], states[0].mah_per_hour[i],
+                   states[1].mah_per_hour[i], states[2].mah_per_hour[i]);
+    }
+    ENERGY_LOG("%-10s %8s  %8.1f %8.1f %8.1f %8.1f\n", "measured", "",
+               total.measured_ma, states[0].measured_ma,
+               states[1].measured_ma, states[2].measured_ma);
+    ENERGY_LOG("%-10s %8s  %8.2f %8.2f %8.2f %8.2f\n", "hours", "",
+               total.hours, states[0].hours, states[1].hours, states[2].hours);
+    ENERGY_LOG("(mAh per hour; * = activity never varied, folded into baseline)\n");
+    ENERGY_LOG("==========================\n");
+}
+
+#else  // !ENERGY_PROFILING
+
+// Profiling compiled out: hooks do nothing, queries return empty data
+
+void EnergyProfiler::setActivity(Subsystem, float, uint32_t) {}
+void EnergyProfiler::setTimerState(uint8_t, uint32_t) {}
+void EnergyProfiler::addSample(float, uint32_t, bool) {}
+EnergyProfiler::Model EnergyProfiler::fit() { return Model{}; }
+EnergyProfiler::Attribution EnergyProfiler::attribute(const Model&) { return Attribution{}; }
+EnergyProfiler::Attribution EnergyProfiler::attribute(const Model&, uint8_t) { return Attribution{}; }
+void EnergyProfiler::printReport() {}
+void EnergyProfiler::reset() {}
+const char* EnergyProfiler::subsystemName(Subsystem) { return "?"; }
+
+#endif  // ENERGY_PROFILING
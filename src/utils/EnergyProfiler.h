@@ -0,0 +1,121 @@
+#ifndef ENERGY_PROFILER_H
+#define ENERGY_PROFILER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef ENERGY_PROFILING
+#define ENERGY_PROFILING 0
+#endif
+
+/**
+ * Per-subsystem energy attribution profiler
+ *
+ * The battery current is one number; where it goes is not measured
+ * anywhere. Controllers report how active their subsystem is (0.0-1.0)
+ * and every battery current sample (PowerTelemetry, on battery only) is
+ * paired with the time-weighted mean activity since the previous sample.
+ * A least-squares fit over all samples gives a linear current model:
+ *
+ *   I = baseline + Σ ma[s] × activity[s]
+ *
+ * where ma[s] is the subsystem's draw at full activity. The report turns
+ * it into mAh per hour by subsystem (ma[s] × mean activity), overall and
+ * per timer state, next to the measured average for comparison.
+ *
+ * Activity levels reported:
+ * - BACKLIGHT: display brightness / 255 (UITask, once per second)
+ * - LEDS: sum of RGB output / full white, i.e. brightness × power_mode_multiplier
+ *   × pattern (LEDController, on every push)
+ * - SPEAKER: volume while playing (AudioPlayer)
+ * - HAPTIC: motor on/off (HapticController)
+ * - WIFI: radio on (UITask, once per second)
+ * - CPU: UI task busy fraction at 240 MHz (UITask, once per second)
+ *
+ * The baseline absorbs everything not reported (ESP32 idle, PMIC, PSRAM).
+ * A subsystem that never changes during the session is indistinguishable
+ * from the baseline; a small ridge term keeps its coefficient near 0
+ * instead of letting it blow up, and the report flags it as unexcited.
+ *
+ * Memory: fixed static accumulators (~1 KB), never allocates.
+ *
+ * Usage:
+ *   ENERGY_ACTIVITY(HAPTIC, 1.0f);              // Motor on
+ *   EnergyProfiler::setTimerState(state, millis());
+ *   EnergyProfiler::addSample(discharge_ma, millis(), on_battery);
+ *   EnergyProfiler::printReport();               // from the task monitor
+ *
+ * Build: env:m5stack-core2-profile (device), env:native (host).
+ * With ENERGY_PROFILING=0 the hooks compile to nothing.
+ */
+class EnergyProfiler {
+public:
+    enum class Subsystem : uint8_t {
+        BACKLIGHT,
+        LEDS,
+        SPEAKER,
+        HAPTIC,
+        WIFI,
+        CPU,
+        COUNT
+    };
+
+    static constexpr size_t SUBSYSTEMS = static_cast<size_t>(Subsystem::COUNT);
+    static constexpr size_t TERMS = SUBSYSTEMS + 1;      // + baseline
+    static constexpr uint8_t STATES = 3;                 // TimerStateMachine::State (IDLE, ACTIVE, PAUSED)
+    static constexpr uint32_t MAX_SAMPLE_GAP_MS = 60000; // Longer gaps are not paired with activity
+    static constexpr float MIN_EXCITATION = 0.05f;       // Activity std-dev below this = unexcited
+
+    struct Model {
+        bool valid;                  // Enough samples for a fit
+        float baseline_ma;
+        float ma[SUBSYSTEMS];        // Draw at full activity
+        bool excited[SUBSYSTEMS];    // Activity varied enough to be attributed
+        float r2;
+        float rms_error_ma;
+        uint32_t samples;
+        float hours;
+    };
+
+    struct Attribution {
+        float hours;                         // Time on battery in this state
+        float measured_ma;                   // Average measured discharge (= mAh per hour)
+        float baseline_mah_per_hour;
+        float mah_per_hour[SUBSYSTEMS];
+    };
+
+    /**
+     * Report a subsystem's current activity (held until the next report)
+     * @param level 0.0 (off) to 1.0 (full draw), clamped
+     */
+    static void setActivity(Subsystem subsystem, float level, uint32_t now_ms);
+
+    /**
+     * Report the timer state samples are attributed to
+     */
+    static void setTimerState(uint8_t state, uint32_t now_ms);
+
+    /**
+     * Battery current sample; closes the activity window since the last one
+     * @param discharge_ma Battery discharge current (positive)
+     * @param on_battery false on external power: window discarded
+     */
+    static void addSample(float discharge_ma, uint32_t now_ms, bool on_battery);
+
+    static Model fit();
+    static Attribution attribute(const Model& model);            // Whole session
+    static Attribution attribute(const Model& model, uint8_t state);
+    static void printReport();
+    static void reset();
+
+    static const char* subsystemName(Subsystem subsystem);
+};
+
+#if ENERGY_PROFILING
+#define ENERGY_ACTIVITY(subsystem, level) \
+    EnergyProfiler::setActivity(EnergyProfiler::Subsystem::subsystem, (level), millis())
+#else
+#define ENERGY_ACTIVITY(subsystem, level) do {} while (0)
+#endif
+
+#endif // ENERGY_PROFILER_H
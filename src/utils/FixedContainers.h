@@ -0,0 +1,450 @@
+#ifndef FIXED_CONTAINERS_H
+#define FIXED_CONTAINERS_H
+
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Fixed-capacity containers for hot paths (header-only, no heap)
+ *
+ * Storage is part of the object, so a container costs the same whether it
+ * is empty or full and never calls malloc - nothing to fragment PSRAM/DRAM
+ * and nothing for AllocTracker to see in the frame loop.
+ * - StaticVector<T, N>: vector API over an inline array; push_back()
+ *   returns false when full instead of growing
+ * - RingBuffer<T, N>: FIFO, N a power of two; push() refuses when full,
+ *   pushOverwrite() drops the oldest
+ * - FlatMap<K, V, N>: sorted keys in a StaticVector, binary search lookup
+ * - IntrusiveList<T>: doubly linked list through an IntrusiveListNode<T>
+ *   base of T; the list owns nothing, linking is O(1)
+ *
+ * Bounds checks (index, front/back/pop on empty, double-linking a node)
+ * are compiled in when FIXED_CONTAINER_CHECKS is 1: host builds and device
+ * builds with CORE_DEBUG_LEVEL >= 4. A failed check prints the container
+ * and aborts (backtrace on the device). Capacity is never an error: callers
+ * check the bool result.
+ *
+ * Not thread-safe: same rules as the std containers they replace.
+ */
+
+#ifndef FIXED_CONTAINER_CHECKS
+#if defined(NATIVE_BUILD) || (defined(CORE_DEBUG_LEVEL) && CORE_DEBUG_LEVEL >= 4)
+#define FIXED_CONTAINER_CHECKS 1
+#else
+#define FIXED_CONTAINER_CHECKS 0
+#endif
+#endif
+
+namespace fixed_containers {
+
+[[noreturn]] inline void checkFailed(const char* container, const char* what) {
+    fprintf(stderr, "[FixedContainers] ERROR: %s: %s\n", container, what);
+    abort();
+}
+
+}  // namespace fixed_containers
+
+#if FIXED_CONTAINER_CHECKS
+#define FIXED_CHECK(cond, container, what) \
+    do { if (!(cond)) fixed_containers::checkFailed(container, what); } while (0)
+#else
+#define FIXED_CHECK(cond, container, what) do { } while (0)
+#endif
+
+// ============================================================================
+// StaticVector
+// ============================================================================
+
+template <typename T, size_t N>
+class StaticVector {
+public:
+    static_assert(N > 0, "StaticVector capacity must be > 0");
+
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    StaticVector() : size_(0) {}
+    StaticVector(const StaticVector& other) : size_(0) {
+        for (const T& item : other) push_back(item);
+    }
+    StaticVector& operator=(const StaticVector& other) {
+        if (this != &other) {
+            clear();
+            for (const T& item : other) push_back(item);
+        }
+        return *this;
+    }
+    ~StaticVector() { clear(); }
+
+    bool push_back(const T& value) { return emplace_back(value); }
+
+    template <typename... Args>
+    bool emplace_back(Args&&... args) {
+        if (size_ >= N) return false;
+        new (&data()[size_]) T(std::forward<Args>(args)...);
+        size_++;
+        return true;
+    }
+
+    void pop_back() {
+        FIXED_CHECK(size_ > 0, "StaticVector", "pop_back() on empty");
+        data()[--size_].~T();
+    }
+
+    // Shifts the tail down (order kept), returns the element after the erased one
+    iterator erase(iterator pos) { return erase(pos, pos + 1); }
+
+    iterator erase(iterator first, iterator last) {
+        FIXED_CHECK(first >= begin() && first <= last && last <= end(), "StaticVector", "erase() range");
+        iterator out = first;
+        for (iterator it = last; it != end(); ++it, ++out) {
+            *out = std::move(*it);
+        }
+        size_t removed = static_cast<size_t>(last - first);
+        for (size_t i = 0; i < removed; i++) pop_back();
+        return first;
+    }
+
+    // O(1) erase when order does not matter: last element moves into pos
+    void eraseUnordered(size_t index) {
+        FIXED_CHECK(index < size_, "StaticVector", "eraseUnordered() index");
+        if (index != size_ - 1) data()[index] = std::move(data()[size_ - 1]);
+        pop_back();
+    }
+
+    void clear() {
+        if (!std::is_trivially_destructible<T>::value) {
+            for (size_t i = 0; i < size_; i++) data()[i].~T();
+        }
+        size_ = 0;
+    }
+
+    T& operator[](size_t index) {
+        FIXED_CHECK(index < size_, "StaticVector", "index out of range");
+        return data()[index];
+    }
+    const T& operator[](size_t index) const {
+        FIXED_CHECK(index < size_, "StaticVector", "index out of range");
+        return data()[index];
+    }
+
+    T& front() { return (*this)[0]; }
+    T& back() {
+        FIXED_CHECK(size_ > 0, "StaticVector", "back() on empty");
+        return data()[size_ - 1];
+    }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const {
+        FIXED_CHECK(size_ > 0, "StaticVector", "back() on empty");
+        return data()[size_ - 1];
+    }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size_; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == N; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    alignas(T) unsigned char storage_[N * sizeof(T)];
+    size_t size_;
+
+    T* data() { return reinterpret_cast<T*>(storage_); }
+    const T* data() const { return reinterpret_cast<const T*>(storage_); }
+};
+
+// ============================================================================
+// RingBuffer
+// ============================================================================
+
+template <typename T, size_t N>
+class RingBuffer {
+public:
+    static_assert(N > 0 && (N & (N - 1)) == 0, "RingBuffer capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "RingBuffer holds trivially copyable items");
+
+    RingBuffer() : head_(0), count_(0) {}
+
+    bool push(const T& value) {
+        if (count_ == N) return false;
+        items_[(head_ + count_) & MASK] = value;
+        count_++;
+        return true;
+    }
+
+    // Always stores; drops the oldest item when full (returns false then)
+    bool pushOverwrite(const T& value) {
+        if (count_ < N) return push(value);
+        items_[head_] = value;
+        head_ = (head_ + 1) & MASK;
+        return false;
+    }
+
+    bool pop(T& out) {
+        if (count_ == 0) return false;
+        out = items_[head_];
+        head_ = (head_ + 1) & MASK;
+        count_--;
+        return true;
+    }
+
+    // 0 = oldest
+    T& operator[](size_t index) {
+        FIXED_CHECK(index < count_, "RingBuffer", "index out of range");
+        return items_[(head_ + index) & MASK];
+    }
+    const T& operator[](size_t index) const {
+        FIXED_CHECK(index < count_, "RingBuffer", "index out of range");
+        return items_[(head_ + index) & MASK];
+    }
+
+    T& front() { return (*this)[0]; }
+    T& back() {
+        FIXED_CHECK(count_ > 0, "RingBuffer", "back() on empty");
+        return items_[(head_ + count_ - 1) & MASK];
+    }
+
+    void clear() { head_ = 0; count_ = 0; }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == N; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    static constexpr size_t MASK = N - 1;
+
+    T items_[N];
+    size_t head_;
+    size_t count_;
+};
+
+// ============================================================================
+// FlatMap
+// ============================================================================
+
+template <typename K, typename V, size_t N>
+class FlatMap {
+public:
+    struct Entry {
+        K key;
+        V value;
+    };
+
+    using iterator = Entry*;
+    using const_iterator = const Entry*;
+
+    // Inserts or updates; false only when full and key is new
+    bool insert(const K& key, const V& value) {
+        size_t pos = lowerBound(key);
+        if (pos < entries_.size() && entries_[pos].key == key) {
+            entries_[pos].value = value;
+            return true;
+        }
+        if (entries_.full()) return false;
+        entries_.push_back(entries_.empty() ? Entry{key, value} : entries_.back());
+        for (size_t i = entries_.size() - 1; i > pos; i--) {
+            entries_[i] = entries_[i - 1];
+        }
+        entries_[pos] = Entry{key, value};
+        return true;
+    }
+
+    V* find(const K& key) {
+        size_t pos = indexOf(key);
+        return pos < entries_.size() ? &entries_[pos].value : nullptr;
+    }
+    const V* find(const K& key) const {
+        size_t pos = indexOf(key);
+        return pos < entries_.size() ? &entries_[pos].value : nullptr;
+    }
+
+    bool contains(const K& key) const { return find(key) != nullptr; }
+
+    bool erase(const K& key) {
+        size_t pos = indexOf(key);
+        if (pos >= entries_.size()) return false;
+        entries_.erase(entries_.begin() + pos);
+        return true;
+    }
+
+    void clear() { entries_.clear(); }
+
+    // Sorted by key
+    iterator begin() { return entries_.begin(); }
+    iterator end() { return entries_.end(); }
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
+
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+    bool full() const { return entries_.full(); }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    StaticVector<Entry, N> entries_;
+
+    size_t lowerBound(const K& key) const {
+        size_t lo = 0;
+        size_t hi = entries_.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (entries_[mid].key < key) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    // size() when absent
+    size_t indexOf(const K& key) const {
+        size_t pos = lowerBound(key);
+        return (pos < entries_.size() && entries_[pos].key == key) ? pos : entries_.size();
+    }
+};
+
+// ============================================================================
+// IntrusiveList
+// ============================================================================
+
+template <typename T>
+class IntrusiveList;
+
+template <typename T>
+class IntrusiveListNode {
+public:
+    IntrusiveListNode() : prev_(nullptr), next_(nullptr), linked_(false) {}
+    IntrusiveListNode(const IntrusiveListNode&) : IntrusiveListNode() {}   // Copies start unlinked
+    IntrusiveListNode& operator=(const IntrusiveListNode&) { return *this; }
+
+    bool isLinked() const { return linked_; }
+
+private:
+    friend class IntrusiveList<T>;
+    T* prev_;
+    T* next_;
+    bool linked_;
+};
+
+template <typename T>
+class IntrusiveList {
+public:
+    class iterator {
+    public:
+        explicit iterator(T* node) : node_(node) {}
+        T& operator*() const { return *node_; }
+        T* operator->() const { return node_; }
+        iterator& operator++() {
+            node_ = static_cast<IntrusiveListNode<T>*>(node_)->next_;
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return node_ == other.node_; }
+        bool operator!=(const iterator& other) const { return node_ != other.node_; }
+
+    private:
+        T* node_;
+    };
+
+    IntrusiveList() : head_(nullptr), tail_(nullptr), size_(0) {}
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+    ~IntrusiveList() { clear(); }
+
+    void push_back(T& item) {
+        Node& node = hook(item);
+        FIXED_CHECK(!node.linked_, "IntrusiveList", "node already linked");
+        node.prev_ = tail_;
+        node.next_ = nullptr;
+        node.linked_ = true;
+        if (tail_) {
+            hook(*tail_).next_ = &item;
+        } else {
+            head_ = &item;
+        }
+        tail_ = &item;
+        size_++;
+    }
+
+    void push_front(T& item) {
+        Node& node = hook(item);
+        FIXED_CHECK(!node.linked_, "IntrusiveList", "node already linked");
+        node.prev_ = nullptr;
+        node.next_ = head_;
+        node.linked_ = true;
+        if (head_) {
+            hook(*head_).prev_ = &item;
+        } else {
+            tail_ = &item;
+        }
+        head_ = &item;
+        size_++;
+    }
+
+    // Caller guarantees item is in this list (checked: it is linked somewhere)
+    void remove(T& item) {
+        Node& node = hook(item);
+        FIXED_CHECK(node.linked_, "IntrusiveList", "remove() of unlinked node");
+        if (node.prev_) {
+            hook(*node.prev_).next_ = node.next_;
+        } else {
+            head_ = node.next_;
+        }
+        if (node.next_) {
+            hook(*node.next_).prev_ = node.prev_;
+        } else {
+            tail_ = node.prev_;
+        }
+        node.prev_ = nullptr;
+        node.next_ = nullptr;
+        node.linked_ = false;
+        size_--;
+    }
+
+    T* pop_front() {
+        T* item = head_;
+        if (item) remove(*item);
+        return item;
+    }
+
+    void clear() {
+        while (head_) remove(*head_);
+    }
+
+    T& front() {
+        FIXED_CHECK(head_ != nullptr, "IntrusiveList", "front() on empty");
+        return *head_;
+    }
+    T& back() {
+        FIXED_CHECK(tail_ != nullptr, "IntrusiveList", "back() on empty");
+        return *tail_;
+    }
+
+    iterator begin() const { return iterator(head_); }
+    iterator end() const { return iterator(nullptr); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    using Node = IntrusiveListNode<T>;
+
+    T* head_;
+    T* tail_;
+    size_t size_;
+
+    static Node& hook(T& item) { return static_cast<Node&>(item); }
+};
+
+#endif // FIXED_CONTAINERS_H
@@ -0,0 +1,409 @@
+#include "FrameStallDetector.h"
+
+#if FRAME_STALL_DETECT
+
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "StackProfiler.h"
+
+#ifdef NATIVE_BUILD
+#include <stdio.h>
+#define STALL_LOG(...) printf(__VA_ARGS__)
+#define STALL_PERSIST
+#else
+#include <esp_attr.h>
+#include <esp_debug_helpers.h>
+#include <freertos/xtensa_context.h>
+#define STALL_LOG(...) Serial.printf(__VA_ARGS__)
+#define STALL_PERSIST RTC_NOINIT_ATTR
+
+#ifndef FRAME_STALL_TIMER
+#define FRAME_STALL_TIMER 2  // Hardware timer 2 (group 1, timer 0) - PCSampler uses 3
+#endif
+#endif
+
+// ============================================================================
+// State
+// ============================================================================
+
+namespace {
+
+using StallRecord = FrameStallDetector::StallRecord;
+
+constexpr uint32_t LOG_MAGIC = 0x5354414C;   // "STAL"
+
+// Ring buffer in RTC memory (device): survives resets, not power loss
+struct StallLog {
+    uint32_t magic;
+    uint16_t boot;
+    uint32_t next_seq;
+    uint32_t head;                                    // Next write slot
+    uint32_t count;
+    StallRecord ring[FrameStallDetector::RING_SIZE];
+};
+
+STALL_PERSIST StallLog s_log;
+
+// Heartbeat (UI task writes, monitor reads)
+std::atomic<uint32_t> s_frame_seq{0};
+std::atomic<uint32_t> s_frame_start{0};
+std::atomic<uint8_t> s_phase{0};
+
+// Monitor side
+uint32_t s_captured_seq = UINT32_MAX;        // Frame already recorded
+uint32_t s_stall_seq = UINT32_MAX;           // Frame of the newest stall
+int32_t s_stall_index = -1;                  // Its ring slot (frame_ms fix-up)
+
+FrameStallDetector::Stats s_stats;
+bool s_started = false;
+TaskHandle_t s_monitor_task = nullptr;
+
+#ifndef NATIVE_BUILD
+TaskHandle_t s_ui_task = nullptr;
+hw_timer_t* s_timer = nullptr;
+volatile int32_t s_capture_index = -1;       // Slot the capture ISR fills
+#endif
+
+// ----------------------------------------------------------------------------
+// Lock: spinlock, no allocation, short critical sections only
+// ----------------------------------------------------------------------------
+
+#ifdef NATIVE_BUILD
+std::atomic_flag s_lock = ATOMIC_FLAG_INIT;
+
+inline void lock() {
+    while (s_lock.test_and_set(std::memory_order_acquire)) {
+        // spin
+    }
+}
+
+inline void unlock() {
+    s_lock.clear(std::memory_order_release);
+}
+#else
+portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+inline void lock() {
+    portENTER_CRITICAL(&s_lock);
+}
+
+inline void unlock() {
+    portEXIT_CRITICAL(&s_lock);
+}
+#endif
+
+bool logValid() {
+    return s_log.magic == LOG_MAGIC &&
+           s_log.head < FrameStallDetector::RING_SIZE &&
+           s_log.count <= FrameStallDetector::RING_SIZE;
+}
+
+// Set the final duration of a stalled frame once (call with lock held)
+void closeStallLocked(uint32_t seq, uint32_t duration_ms) {
+    if (s_stall_seq != seq || s_stall_index < 0) return;
+    StallRecord& record = s_log.ring[s_stall_index];
+    if (record.frame_ms == 0) {
+        record.frame_ms = duration_ms;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Backtrace capture (device): one-shot timer ISR on the UI core
+// ----------------------------------------------------------------------------
+
+#ifndef NATIVE_BUILD
+// Return address → call instruction address (strip window size bits)
+inline uint32_t IRAM_ATTR callerPC(uint32_t pc) {
+    if (pc & 0x80000000) {
+        pc = (pc & 0x3FFFFFFF) | 0x40000000;
+    }
+    return pc - 3;
+}
+
+void IRAM_ATTR onCaptureTimer() {
+    int32_t index = s_capture_index;
+    if (index < 0 || s_ui_task == nullptr) return;
+    s_capture_index = -1;
+
+    TaskHandle_t current = xTaskGetCurrentTaskHandleForCPU(xPortGetCoreID());
+
+    // pxTopOfStack (first TCB field): interrupt frame if the UI task was
+    // running, context switch (solicited) frame if it was blocked
+    const void* saved = *reinterpret_cast<void* const*>(s_ui_task);
+    esp_backtrace_frame_t frame;
+    const XtExcFrame* exc = static_cast<const XtExcFrame*>(saved);
+    if (exc->exit != 0) {
+        frame.pc = exc->pc;
+        frame.sp = exc->a1;
+        frame.next_pc = exc->a0;
+    } else {
+        const XtSolFrame* sol = static_cast<const XtSolFrame*>(saved);
+        frame.pc = sol->pc;
+        frame.sp = sol->a1;
+        frame.next_pc = sol->a0;
+    }
+
+    portENTER_CRITICAL_ISR(&s_lock);
+    StallRecord& record = s_log.ring[index];
+    record.running = (current == s_ui_task);
+    record.depth = 0;
+    record.pc[record.depth] = frame.pc;
+    record.sp[record.depth] = frame.sp;
+    record.depth++;
+    while (record.depth < FrameStallDetector::MAX_DEPTH && frame.next_pc != 0 &&
+           esp_backtrace_get_next_frame(&frame)) {
+        record.pc[record.depth] = callerPC(frame.pc);
+        record.sp[record.depth] = frame.sp;
+        record.depth++;
+    }
+    portEXIT_CRITICAL_ISR(&s_lock);
+}
+
+void armCapture(int32_t index) {
+    if (s_timer == nullptr) return;
+    s_capture_index = index;
+    timerWrite(s_timer, 0);
+    timerAlarmWrite(s_timer, 10, false);   // 10us, one shot
+    timerAlarmEnable(s_timer);
+}
+#endif
+
+void monitorTask(void* parameter) {
+    (void)parameter;
+    while (true) {
+        FrameStallDetector::poll();
+        vTaskDelay(pdMS_TO_TICKS(FrameStallDetector::POLL_MS));
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Control
+// ============================================================================
+
+bool FrameStallDetector::begin(uint32_t threshold_ms) {
+    lock();
+    if (!logValid()) {
+        memset(&s_log, 0, sizeof(s_log));
+        s_log.magic = LOG_MAGIC;
+    }
+    s_log.boot++;
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.boot = s_log.boot;
+    s_stats.threshold_ms = threshold_ms > 0 ? threshold_ms : DEFAULT_THRESHOLD_MS;
+    s_captured_seq = UINT32_MAX;
+    s_stall_seq = UINT32_MAX;
+    s_stall_index = -1;
+    unlock();
+
+    s_frame_seq.store(0);
+    s_frame_start.store(millis());
+    s_phase.store(static_cast<uint8_t>(Phase::IDLE));
+
+#ifndef NATIVE_BUILD
+    // Capture interrupt is allocated on the calling (UI) core
+    s_ui_task = xTaskGetCurrentTaskHandle();
+    if (s_timer == nullptr) {
+        s_timer = timerBegin(FRAME_STALL_TIMER, 80, true);   // 1MHz
+        if (s_timer == nullptr) {
+            Serial.println("[FrameStall] WARNING: No capture timer, stalls without backtrace");
+        } else {
+            timerAttachInterrupt(s_timer, &onCaptureTimer, true);
+        }
+    }
+#endif
+
+    s_started = true;
+    STALL_LOG("[FrameStall] ✓ Watching frames > %lu ms (boot %u, %lu earlier stalls)\n",
+              (unsigned long)s_stats.threshold_ms, (unsigned)s_log.boot,
+              (unsigned long)s_log.count);
+    return true;
+}
+
+bool FrameStallDetector::startMonitor(int core) {
+    if (s_monitor_task != nullptr) return true;
+
+    // Above the network task: polling must not starve behind it
+    BaseType_t result = StackProfiler::createTaskPinnedToCore(
+        monitorTask, "stall_mon", 3072, NULL, 2, &s_monitor_task, core);
+    if (result != pdPASS) {
+        STALL_LOG("[FrameStall] ERROR: Failed to create monitor task\n");
+        return false;
+    }
+    return true;
+}
+
+void FrameStallDetector::clear() {
+    lock();
+    memset(&s_log, 0, sizeof(s_log));
+    s_log.magic = LOG_MAGIC;
+    s_log.boot = s_stats.boot;
+    s_stall_index = -1;
+    s_stall_seq = UINT32_MAX;
+    unlock();
+}
+
+// ============================================================================
+// Heartbeats (UI task)
+// ============================================================================
+
+void FrameStallDetector::frameStart() {
+    uint32_t now = millis();
+    uint32_t seq = s_frame_seq.load(std::memory_order_relaxed);
+
+    // Previous iteration stalled outside its busy part (IDLE): close it here
+    lock();
+    closeStallLocked(seq, now - s_frame_start.load(std::memory_order_relaxed));
+    unlock();
+
+    s_phase.store(static_cast<uint8_t>(Phase::INPUT), std::memory_order_relaxed);
+    s_frame_start.store(now, std::memory_order_relaxed);
+    s_frame_seq.store(seq + 1, std::memory_order_release);
+}
+
+void FrameStallDetector::setPhase(Phase phase) {
+    s_phase.store(static_cast<uint8_t>(phase), std::memory_order_relaxed);
+}
+
+void FrameStallDetector::frameEnd() {
+    uint32_t now = millis();
+    uint32_t duration = now - s_frame_start.load(std::memory_order_relaxed);
+    uint8_t phase = s_phase.load(std::memory_order_relaxed);
+    s_phase.store(static_cast<uint8_t>(Phase::IDLE), std::memory_order_relaxed);
+
+    lock();
+    s_stats.frames++;
+    if (duration > s_stats.worst_ms) {
+        s_stats.worst_ms = duration;
+        s_stats.worst_phase = phase;
+    }
+    closeStallLocked(s_frame_seq.load(std::memory_order_relaxed), duration);
+    unlock();
+}
+
+// ============================================================================
+// Monitor
+// ============================================================================
+
+bool FrameStallDetector::poll() {
+    if (!s_started) return false;
+
+    uint32_t seq = s_frame_seq.load(std::memory_order_acquire);
+    uint32_t start = s_frame_start.load(std::memory_order_relaxed);
+    uint32_t age = millis() - start;
+    uint8_t phase = s_phase.load(std::memory_order_relaxed);
+
+    if (age < s_stats.threshold_ms || seq == s_captured_seq) {
+        return false;
+    }
+    s_captured_seq = seq;
+
+    lock();
+    int32_t index = static_cast<int32_t>(s_log.head);
+    StallRecord& record = s_log.ring[index];
+    memset(&record, 0, sizeof(record));
+    record.seq = s_log.next_seq++;
+    record.boot = s_log.boot;
+    record.phase = phase;
+    record.uptime_ms = start;
+    record.detected_ms = age;
+    s_log.head = (s_log.head + 1) % RING_SIZE;
+    if (s_log.count < RING_SIZE) s_log.count++;
+    s_stall_seq = seq;
+    s_stall_index = index;
+    s_stats.stalls++;
+    unlock();
+
+#ifndef NATIVE_BUILD
+    armCapture(index);
+#endif
+
+    STALL_LOG("[FrameStall] Frame stalled > %lu ms in %s\n",
+              (unsigned long)age, phaseName(phase));
+    return true;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+FrameStallDetector::Stats FrameStallDetector::getStats() {
+    lock();
+    Stats stats = s_stats;
+    unlock();
+    return stats;
+}
+
+size_t FrameStallDetector::getStalls(StallRecord* out, size_t max_records) {
+    if (!out || max_records == 0) return 0;
+
+    lock();
+    size_t count = s_log.count < max_records ? s_log.count : max_records;
+    for (size_t i = 0; i < count; i++) {
+        size_t slot = (s_log.head + RING_SIZE - 1 - i) % RING_SIZE;
+        out[i] = s_log.ring[slot];
+    }
+    unlock();
+    return count;
+}
+
+const char* FrameStallDetector::phaseName(uint8_t phase) {
+    static const char* names[] = {
+        "IDLE", "INPUT", "SCREEN_UPDATE", "AUDIO", "LEDS", "HAPTIC",
+        "DRAW", "PUSH", "STATUS", "TRACE_FLUSH", "MONITOR", "SLEEP_CHECK"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(Phase::COUNT),
+                  "Phase names out of sync");
+    return phase < static_cast<uint8_t>(Phase::COUNT) ? names[phase] : "?";
+}
+
+void FrameStallDetector::printReport() {
+    Stats stats = getStats();
+    StallRecord records[RING_SIZE];
+    size_t count = getStalls(records, RING_SIZE);
+
+    STALL_LOG("\n=== Frame Stalls (> %lu ms) ===\n", (unsigned long)stats.threshold_ms);
+    STALL_LOG("Boot %u: %lu frames, %lu stalls, worst %lu ms (%s)\n",
+              (unsigned)stats.boot, (unsigned long)stats.frames, (unsigned long)stats.stalls,
+              (unsigned long)stats.worst_ms, phaseName(stats.worst_phase));
+
+    for (size_t i = 0; i < count; i++) {
+        const StallRecord& r = records[i];
+        STALL_LOG("#%lu boot %u at %lu ms: %s %lu ms, phase %s, %s\n",
+                  (unsigned long)r.seq, (unsigned)r.boot, (unsigned long)r.uptime_ms,
+                  r.frame_ms ? "frame" : "frame >", (unsigned long)(r.frame_ms ? r.frame_ms : r.detected_ms),
+                  phaseName(r.phase), r.depth == 0 ? "no backtrace" : r.running ? "running" : "blocked");
+        if (r.depth == 0) continue;
+
+        // ESP-IDF panic format: decoded by the esp32_exception_decoder monitor filter
+        STALL_LOG("Backtrace:");
+        for (uint8_t d = 0; d < r.depth; d++) {
+            STALL_LOG(" 0x%08lx:0x%08lx", (unsigned long)r.pc[d], (unsigned long)r.sp[d]);
+        }
+        STALL_LOG("\n");
+    }
+    STALL_LOG("==============================\n");
+}
+
+#else  // !FRAME_STALL_DETECT
+
+// Detector compiled out
+
+bool FrameStallDetector::begin(uint32_t) { return false; }
+bool FrameStallDetector::startMonitor(int) { return false; }
+void FrameStallDetector::frameStart() {}
+void FrameStallDetector::setPhase(Phase) {}
+void FrameStallDetector::frameEnd() {}
+bool FrameStallDetector::poll() { return false; }
+FrameStallDetector::Stats FrameStallDetector::getStats() { return Stats{}; }
+size_t FrameStallDetector::getStalls(StallRecord*, size_t) { return 0; }
+const char* FrameStallDetector::phaseName(uint8_t) { return "?"; }
+void FrameStallDetector::printReport() {}
+void FrameStallDetector::clear() {}
+
+#endif  // FRAME_STALL_DETECT
@@ -0,0 +1,151 @@
+#ifndef FRAME_STALL_DETECTOR_H
+#define FRAME_STALL_DETECTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef FRAME_STALL_DETECT
+#define FRAME_STALL_DETECT 0
+#endif
+
+/**
+ * Frame stall detector with backtrace capture
+ *
+ * Turns visible UI hitches (NVS commit in Statistics, SD access, a
+ * MutexGuard waiting on another core, a long Serial report) into
+ * decodable profiles. The UI task sends a heartbeat at the start of every
+ * loop iteration and marks the phase it is in; a monitor task on the other
+ * core polls the heartbeat. When an iteration runs longer than the
+ * threshold, the monitor captures the UI task's backtrace and phase once
+ * per stalled frame and stores them in a ring buffer.
+ *
+ * Backtrace capture (device): the monitor arms a one-shot hardware timer
+ * whose interrupt is allocated on the UI core (begin() runs in the UI
+ * task). The ISR reads the UI task's saved context from its TCB
+ * (pxTopOfStack): the interrupt frame if the UI task was running, the
+ * context switch frame if it was blocked. From there it walks the windowed
+ * call stack with esp_backtrace_get_next_frame(). "running" in the report
+ * tells CPU-bound stalls (drawing, parsing) from blocked ones (mutex, SD,
+ * queue).
+ *
+ * Persistence: the ring lives in RTC memory (RTC_NOINIT), so stalls
+ * survive a software reset, panic or watchdog reset (not a power cycle).
+ * Records from earlier boots are kept and printed with their boot number.
+ *
+ * Output: printReport() prints one "Backtrace:" line per stall in the
+ * ESP-IDF panic format; the esp32_exception_decoder monitor filter turns
+ * it into function/file/line.
+ *
+ * Limitations:
+ * - A frame stalled with interrupts masked is captured once they unmask
+ * - Stalls shorter than threshold + POLL_MS may be missed
+ * - Host builds (NATIVE_BUILD) record phase and duration without a backtrace
+ *
+ * Usage:
+ *   FrameStallDetector::begin();          // In the UI task
+ *   FrameStallDetector::startMonitor(1);  // Monitor on the other core
+ *   while (true) {
+ *       STALL_FRAME_BEGIN();
+ *       STALL_PHASE(DRAW);
+ *       ...
+ *       STALL_FRAME_END();
+ *   }
+ *
+ * Build: env:m5stack-core2-profile (FRAME_STALL_DETECT=1), env:native.
+ */
+class FrameStallDetector {
+public:
+    static constexpr uint32_t DEFAULT_THRESHOLD_MS = 100;
+    static constexpr uint32_t POLL_MS = 10;            // Monitor poll interval
+    static constexpr size_t RING_SIZE = 8;             // Stalls kept (RTC memory)
+    static constexpr size_t MAX_DEPTH = 12;            // Backtrace frames per stall
+
+    // Where the UI task was when the frame stalled (UITask loop order)
+    enum class Phase : uint8_t {
+        IDLE,            // Between iterations (vTaskDelay / not scheduled)
+        INPUT,           // M5.update(), buttons, touch
+        SCREEN_UPDATE,   // ScreenManager::update (timer, navigation)
+        AUDIO,
+        LEDS,
+        HAPTIC,
+        DRAW,            // ScreenManager::draw
+        PUSH,            // Renderer::update (SPI transfer)
+        STATUS,          // Status bar (battery, RTC, WiFi)
+        TRACE_FLUSH,     // Input trace → SD
+        MONITOR,         // Task monitor reports
+        SLEEP_CHECK,
+        COUNT
+    };
+
+    struct StallRecord {
+        uint32_t seq;            // Stall number (across boots)
+        uint16_t boot;           // Boot number the stall happened in
+        uint8_t phase;           // Phase at capture
+        uint8_t depth;           // Backtrace frames (0 = none captured)
+        uint32_t uptime_ms;      // Frame start (millis)
+        uint32_t detected_ms;    // Frame age when the monitor caught it
+        uint32_t frame_ms;       // Final frame duration (0 if the frame never ended)
+        bool running;            // UI task was on the CPU (not blocked)
+        uint32_t pc[MAX_DEPTH];
+        uint32_t sp[MAX_DEPTH];
+    };
+
+    struct Stats {
+        uint32_t frames;         // This boot
+        uint32_t stalls;         // This boot
+        uint32_t worst_ms;       // Longest frame this boot
+        uint8_t worst_phase;     // Phase of the longest frame at its end
+        uint16_t boot;
+        uint32_t threshold_ms;
+    };
+
+    /**
+     * Initialize (call from the UI task: the capture interrupt is allocated
+     * on the calling core). Keeps stalls from previous boots.
+     */
+    static bool begin(uint32_t threshold_ms = DEFAULT_THRESHOLD_MS);
+
+    /**
+     * Start the monitor task (polls every POLL_MS)
+     * @param core Core to run on - the one the UI task does NOT run on
+     */
+    static bool startMonitor(int core = 1);
+
+    // Heartbeats (UI task)
+    static void frameStart();
+    static void setPhase(Phase phase);
+    static void frameEnd();
+
+    /**
+     * Check the heartbeat once (monitor task, or tests with virtual time)
+     * @return true if a new stall was recorded
+     */
+    static bool poll();
+
+    // Queries
+    static Stats getStats();
+    static size_t getStalls(StallRecord* out, size_t max_records);   // Newest first
+    static const char* phaseName(uint8_t phase);
+
+    /**
+     * Print stats and one Backtrace: line per recorded stall
+     */
+    static void printReport();
+
+    /**
+     * Forget all stalls including previous boots
+     */
+    static void clear();
+};
+
+#if FRAME_STALL_DETECT
+#define STALL_FRAME_BEGIN() FrameStallDetector::frameStart()
+#define STALL_PHASE(phase) FrameStallDetector::setPhase(FrameStallDetector::Phase::phase)
+#define STALL_FRAME_END() FrameStallDetector::frameEnd()
+#else
+#define STALL_FRAME_BEGIN() do {} while (0)
+#define STALL_PHASE(phase) do {} while (0)
+#define STALL_FRAME_END() do {} while (0)
+#endif
+
+#endif // FRAME_STALL_DETECTOR_H
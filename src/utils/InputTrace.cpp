@@ -0,0 +1,272 @@
+#include "InputTrace.h"
+#include <string.h>
+
+#if INPUT_TRACE
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <atomic>
+#include "../hardware/SDLogWriter.h"
+
+#ifdef NATIVE_BUILD
+#define TRACE_LOG(...) printf(__VA_ARGS__)
+#else
+#include <freertos/FreeRTOS.h>
+#define TRACE_LOG(...) Serial.printf(__VA_ARGS__)
+#endif
+
+// ============================================================================
+// Recorder State (static, never heap-allocated)
+// ============================================================================
+
+namespace {
+
+using Record = InputTrace::Record;
+
+Record s_ring[InputTrace::BUFFER_RECORDS];
+size_t s_head = 0;           // Next write slot
+size_t s_count = 0;          // Records in the ring
+
+InputTrace::Header s_header;
+InputTrace::Stats s_stats;
+uint32_t s_last_ms = 0;      // Time of the last stored record
+bool s_recording = false;
+bool s_header_pending = false;
+
+char s_path[40] = "";
+bool s_preamble_set = false;
+// Drain buffer for SD writes (static: keeps 1KB off the UI task stack)
+uint8_t s_io[sizeof(InputTrace::Header) + 128 * sizeof(Record)];
+
+// ----------------------------------------------------------------------------
+// Lock: spinlock, no allocation, short critical sections only
+// ----------------------------------------------------------------------------
+
+#ifdef NATIVE_BUILD
+std::atomic_flag s_lock = ATOMIC_FLAG_INIT;
+
+inline void lock() {
+    while (s_lock.test_and_set(std::memory_order_acquire)) {
+        // spin
+    }
+}
+
+inline void unlock() {
+    s_lock.clear(std::memory_order_release);
+}
+#else
+portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+inline void lock() {
+    portENTER_CRITICAL(&s_lock);
+}
+
+inline void unlock() {
+    portEXIT_CRITICAL(&s_lock);
+}
+#endif
+
+void pushLocked(uint16_t dt_ms, InputTrace::EventType type, uint8_t arg, int16_t x, int16_t y) {
+    Record& r = s_ring[s_head];
+    r.dt_ms = dt_ms;
+    r.type = static_cast<uint8_t>(type);
+    r.arg = arg;
+    r.x = x;
+    r.y = y;
+    s_head = (s_head + 1) % InputTrace::BUFFER_RECORDS;
+    s_count++;
+}
+
+}  // namespace
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void InputTrace::begin(uint32_t start_epoch) {
+    uint32_t now = millis();
+
+    lock();
+    s_head = 0;
+    s_count = 0;
+    memset(&s_stats, 0, sizeof(s_stats));
+    memcpy(s_header.magic, "M5IT", 4);
+    s_header.version = FORMAT_VERSION;
+    s_header.record_size = sizeof(Record);
+    s_header.flags = 0;
+    s_header.start_ms = now;
+    s_header.start_epoch = start_epoch;
+    s_last_ms = now;
+    s_header_pending = true;
+    s_recording = true;
+    unlock();
+
+    s_preamble_set = false;
+    if (start_epoch > 0) {
+        snprintf(s_path, sizeof(s_path), "/traces/input_%lu.bin", (unsigned long)start_epoch);
+    } else {
+        snprintf(s_path, sizeof(s_path), "/traces/input.bin");
+    }
+
+    TRACE_LOG("[InputTrace] ✓ Recording (%u records buffer)\n", (unsigned)BUFFER_RECORDS);
+}
+
+void InputTrace::stop() {
+    lock();
+    s_recording = false;
+    unlock();
+}
+
+bool InputTrace::isRecording() {
+    return s_recording;
+}
+
+void InputTrace::record(EventType type, uint8_t arg, int16_t x, int16_t y) {
+    uint32_t now = millis();
+
+    lock();
+    if (!s_recording) {
+        unlock();
+        return;
+    }
+
+    // Long idle periods are bridged with GAP records, all or nothing
+    uint32_t dt = now - s_last_ms;
+    size_t gaps = dt / (MAX_DT_MS + 1u);
+    if (s_count + gaps + 1 > BUFFER_RECORDS) {
+        s_stats.dropped++;
+        unlock();
+        return;
+    }
+
+    for (size_t i = 0; i < gaps; i++) {
+        pushLocked(MAX_DT_MS, EventType::GAP, 0, 0, 0);
+        dt -= MAX_DT_MS;
+    }
+    pushLocked(static_cast<uint16_t>(dt), type, arg, x, y);
+    s_last_ms = now;
+    s_stats.recorded++;
+    unlock();
+}
+
+size_t InputTrace::drain(uint8_t* out, size_t max_bytes) {
+    size_t written = 0;
+
+    lock();
+    if (s_header_pending) {
+        if (max_bytes < sizeof(Header)) {
+            unlock();
+            return 0;
+        }
+        memcpy(out, &s_header, sizeof(Header));
+        written = sizeof(Header);
+        s_header_pending = false;
+    }
+
+    size_t tail = (s_head + BUFFER_RECORDS - s_count) % BUFFER_RECORDS;
+    while (s_count > 0 && written + sizeof(Record) <= max_bytes) {
+        memcpy(out + written, &s_ring[tail], sizeof(Record));
+        written += sizeof(Record);
+        tail = (tail + 1) % BUFFER_RECORDS;
+        s_count--;
+    }
+    s_stats.flushed_bytes += written;
+    unlock();
+
+    return written;
+}
+
+InputTrace::Stats InputTrace::getStats() {
+    lock();
+    Stats stats = s_stats;
+    stats.pending = s_count;
+    unlock();
+    return stats;
+}
+
+// ============================================================================
+// SD Output
+// ============================================================================
+
+bool InputTrace::flushTo(SDLogWriter& log) {
+    bool ok = true;
+    size_t len;
+    while ((len = drain(s_io, sizeof(s_io))) > 0) {
+        const uint8_t* data = s_io;
+        if (!s_preamble_set) {
+            // First chunk starts with the header: the writer puts it at the
+            // start of every file it creates (including rotated ones)
+            log.setPreamble(s_io, sizeof(Header));
+            data += sizeof(Header);
+            len -= sizeof(Header);
+            s_preamble_set = true;
+        }
+        if (len > 0 && !log.append(data, len)) {
+            lock();
+            s_stats.write_errors++;
+            unlock();
+            ok = false;
+            break;   // Drained records are lost, keep the input path non-blocking
+        }
+    }
+    return ok;
+}
+
+const char* InputTrace::getPath() {
+    return s_path;
+}
+
+#else  // !INPUT_TRACE
+
+// Recording compiled out: hooks do nothing, nothing to drain
+
+void InputTrace::begin(uint32_t) {}
+void InputTrace::stop() {}
+bool InputTrace::isRecording() { return false; }
+void InputTrace::record(EventType, uint8_t, int16_t, int16_t) {}
+size_t InputTrace::drain(uint8_t*, size_t) { return 0; }
+InputTrace::Stats InputTrace::getStats() { return Stats{}; }
+bool InputTrace::flushTo(SDLogWriter&) { return true; }
+const char* InputTrace::getPath() { return ""; }
+
+#endif  // INPUT_TRACE
+
+// ============================================================================
+// Reader (always available: decoding needs no recorder)
+// ============================================================================
+
+InputTrace::Reader::Reader(const uint8_t* data, size_t len)
+    : data_(data), len_(len), offset_(sizeof(Header)), t_ms_(0), header_{}, valid_(false) {
+    if (data_ && len_ >= sizeof(Header)) {
+        memcpy(&header_, data_, sizeof(Header));
+        valid_ = memcmp(header_.magic, "M5IT", 4) == 0 &&
+                 header_.version == FORMAT_VERSION &&
+                 header_.record_size == sizeof(Record);
+    }
+}
+
+bool InputTrace::Reader::next(Event& out) {
+    if (!valid_) return false;
+
+    Record r;
+    while (offset_ + sizeof(Record) <= len_) {
+        memcpy(&r, data_ + offset_, sizeof(Record));
+        offset_ += sizeof(Record);
+        t_ms_ += r.dt_ms;
+
+        if (r.type == static_cast<uint8_t>(EventType::GAP)) continue;
+
+        out.t_ms = t_ms_;
+        out.type = static_cast<EventType>(r.type);
+        out.arg = r.arg;
+        out.x = r.x;
+        out.y = r.y;
+        return true;
+    }
+    return false;
+}
+
+void InputTrace::Reader::rewind() {
+    offset_ = sizeof(Header);
+    t_ms_ = 0;
+}
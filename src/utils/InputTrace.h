@@ -0,0 +1,183 @@
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef INPUT_TRACE
+#define INPUT_TRACE 0
+#endif
+
+class SDLogWriter;
+
+/**
+ * Input trace recorder (touch, hardware buttons, IMU gestures)
+ *
+ * Records every user input the UI consumes with a millisecond timestamp
+ * into a compact binary trace, so a real usage session can be replayed on
+ * the host against the real UI code (test/sim/InputReplayer.h) and turned
+ * into a repeatable performance benchmark.
+ *
+ * Hooks:
+ * - ScreenManager::handleTouch(): TOUCH_DOWN / TOUCH_UP with coordinates
+ * - ScreenManager::handleHardwareButtons(): BUTTON (arg = BUTTON_A/B/C)
+ * - GyroController::update(): IMU_GESTURE (arg = IGyroController::Gesture)
+ *
+ * Trace format (little endian, all fields fixed size):
+ * - Header (16 bytes): magic "M5IT", version, record size, flags,
+ *   millis() and wall clock (epoch seconds, 0 if unknown) at begin()
+ * - Records (8 bytes): dt_ms since the previous record, type, arg, x, y.
+ *   Gaps longer than 65535 ms are split with GAP records (dt only).
+ *
+ * Recording goes into a fixed ring buffer (BUFFER_RECORDS) behind a
+ * spinlock, callable from any task. The UI task drains it into an
+ * SDLogWriter periodically (flushTo), so no file I/O happens on the input
+ * path; the SD worker writes the log out. Each file the writer creates
+ * (including rotated ones) starts with the header, so record times in a
+ * rotated file count from the start of that file's records.
+ * When the buffer is full new records are dropped and counted; the next
+ * stored record still carries the correct time delta.
+ *
+ * Usage:
+ *   InputTrace::begin(time(nullptr));                       // UITask start
+ *   INPUT_TRACE_RECORD(TOUCH_DOWN, 0, x, y);                // input hooks
+ *   InputTrace::flushTo(*traceLog);                         // every few seconds
+ *
+ *   InputTrace::Reader reader(data, len);                   // host replay
+ *   InputTrace::Event event;
+ *   while (reader.next(event)) { ... }
+ *
+ * Build: env:m5stack-core2-inputtrace (device), env:native (host).
+ * With INPUT_TRACE=0 the hooks compile to nothing.
+ */
+class InputTrace {
+public:
+    static constexpr size_t BUFFER_RECORDS = 512;          // 4KB ring buffer
+    static constexpr uint8_t FORMAT_VERSION = 1;
+    static constexpr uint16_t MAX_DT_MS = 0xFFFF;
+
+    enum class EventType : uint8_t {
+        TOUCH_DOWN = 1,
+        TOUCH_UP = 2,
+        BUTTON = 3,       // arg: BUTTON_A/B/C
+        IMU_GESTURE = 4,  // arg: IGyroController::Gesture
+        GAP = 5           // Time filler only, never returned by Reader
+    };
+
+    enum Button : uint8_t {
+        BUTTON_A = 0,
+        BUTTON_B = 1,
+        BUTTON_C = 2
+    };
+
+    struct Header {
+        char magic[4];           // "M5IT"
+        uint8_t version;
+        uint8_t record_size;     // sizeof(Record)
+        uint16_t flags;          // Reserved (0)
+        uint32_t start_ms;       // millis() at begin()
+        uint32_t start_epoch;    // Wall clock at begin(), 0 if not synced
+    };
+
+    struct Record {
+        uint16_t dt_ms;          // Since previous record
+        uint8_t type;            // EventType
+        uint8_t arg;
+        int16_t x;
+        int16_t y;
+    };
+
+    // Decoded event with absolute time since begin()
+    struct Event {
+        uint32_t t_ms;
+        EventType type;
+        uint8_t arg;
+        int16_t x;
+        int16_t y;
+    };
+
+    struct Stats {
+        uint32_t recorded;       // Events stored in the buffer
+        uint32_t dropped;        // Events lost to a full buffer
+        uint32_t flushed_bytes;  // Bytes handed to drain()/flushTo()
+        uint32_t write_errors;   // Chunks the SD log writer did not accept
+        uint32_t pending;        // Records waiting in the buffer
+    };
+
+    /**
+     * Start a new trace (clears the buffer and counters)
+     * @param start_epoch Wall clock for the header and file name (0 = unknown)
+     */
+    static void begin(uint32_t start_epoch = 0);
+
+    /**
+     * Stop recording (buffered records can still be drained)
+     */
+    static void stop();
+
+    static bool isRecording();
+
+    /**
+     * Record one input event at millis()
+     */
+    static void record(EventType type, uint8_t arg = 0, int16_t x = 0, int16_t y = 0);
+
+    /**
+     * Move buffered records into `out` (header first on the first drain)
+     * Only whole records are copied.
+     * @return Bytes written to `out`
+     */
+    static size_t drain(uint8_t* out, size_t max_bytes);
+
+    static Stats getStats();
+
+    /**
+     * Move buffered records into the trace log writer (RAM copy, never
+     * waits for the card). The header becomes the writer's preamble.
+     * @param log Writer for getPath() (/traces/input_<epoch>.bin)
+     * @return true if nothing was pending or all records were accepted
+     */
+    static bool flushTo(SDLogWriter& log);
+
+    /**
+     * Path of the current trace file
+     */
+    static const char* getPath();
+
+    /**
+     * Decoder for a serialized trace (host replay, tools)
+     */
+    class Reader {
+    public:
+        Reader(const uint8_t* data, size_t len);
+
+        // Header present and matches this format version
+        bool valid() const { return valid_; }
+        const Header& header() const { return header_; }
+
+        // Next input event (GAP records folded into the time base)
+        bool next(Event& out);
+
+        void rewind();
+
+    private:
+        const uint8_t* data_;
+        size_t len_;
+        size_t offset_;
+        uint32_t t_ms_;
+        Header header_;
+        bool valid_;
+    };
+};
+
+static_assert(sizeof(InputTrace::Header) == 16, "Trace header layout is part of the file format");
+static_assert(sizeof(InputTrace::Record) == 8, "Trace record layout is part of the file format");
+
+#if INPUT_TRACE
+#define INPUT_TRACE_RECORD(type, arg, x, y) \
+    InputTrace::record(InputTrace::EventType::type, (arg), (x), (y))
+#else
+#define INPUT_TRACE_RECORD(type, arg, x, y) do {} while (0)
+#endif
+
+#endif // INPUT_TRACE_H
@@ -0,0 +1,266 @@
+#include "JsonScanner.h"
+#include <string.h>
+
+// ============================================================================
+// Values and paths
+// ============================================================================
+
+bool JsonScanner::Value::isInteger() const {
+    if (type != Type::NUMBER) return false;
+    for (size_t i = 0; i < len; i++) {
+        char c = raw[i];
+        if (c == '.' || c == 'e' || c == 'E') return false;
+    }
+    return true;
+}
+
+long JsonScanner::Value::asLong() const {
+    if (type != Type::NUMBER) return 0;
+    size_t i = 0;
+    bool negative = false;
+    if (i < len && raw[i] == '-') {
+        negative = true;
+        i++;
+    }
+    long value = 0;
+    for (; i < len && raw[i] >= '0' && raw[i] <= '9'; i++) {
+        if (value > 100000000L) {
+            value = 1000000000L;   // Saturate; callers range-check anyway
+            break;
+        }
+        value = value * 10 + (raw[i] - '0');
+    }
+    return negative ? -value : value;
+}
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool JsonScanner::Value::copyString(char* out, size_t max) const {
+    if (type != Type::STRING || max == 0) return false;
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        char c = raw[i];
+        if (c == '\\' && i + 1 < len) {
+            char e = raw[++i];
+            switch (e) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'u': {
+                    int code = 0;
+                    for (size_t k = 0; k < 4 && i + 1 < len; k++) {
+                        code = (code << 4) | hexDigit(raw[++i]);
+                    }
+                    c = (code > 0 && code < 0x80) ? static_cast<char>(code) : '?';
+                    break;
+                }
+                default: c = e; break;   // \" \\ \/
+            }
+        }
+        if (n + 1 >= max) return false;
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    return true;
+}
+
+bool JsonScanner::Path::keyIs(size_t i, const char* name) const {
+    if (i >= depth) return false;
+    size_t len = strlen(name);
+    return key_len[i] == len && memcmp(key[i], name, len) == 0;
+}
+
+bool JsonScanner::Path::is(const char* dotted) const {
+    size_t level = 0;
+    const char* p = dotted;
+    while (true) {
+        const char* dot = strchr(p, '.');
+        size_t len = dot ? static_cast<size_t>(dot - p) : strlen(p);
+        if (level >= depth || key_len[level] != len || memcmp(key[level], p, len) != 0) {
+            return false;
+        }
+        level++;
+        if (!dot) break;
+        p = dot + 1;
+    }
+    return level == depth;
+}
+
+// ============================================================================
+// Scanner (recursive descent, depth bounded by the path stack)
+// ============================================================================
+
+namespace {
+
+struct Cursor {
+    const char* p;
+    const char* end;
+    JsonScanner::Path path;
+    const JsonScanner::Visitor& visit;
+
+    void skipWs() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+    }
+
+    // Leaves p after the closing quote; start/len cover the content
+    bool string(const char*& start, size_t& len) {
+        if (p >= end || *p != '"') return false;
+        start = ++p;
+        while (p < end) {
+            char c = *p;
+            if (c == '"') {
+                len = static_cast<size_t>(p - start);
+                p++;
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) return false;
+            if (c == '\\') {
+                if (++p >= end) return false;
+                if (*p == 'u') {
+                    for (int k = 0; k < 4; k++) {
+                        if (++p >= end || hexDigit(*p) < 0) return false;
+                    }
+                } else if (!strchr("\"\\/bfnrt", *p)) {
+                    return false;
+                }
+            }
+            p++;
+        }
+        return false;
+    }
+
+    bool number(const char*& start, size_t& len) {
+        start = p;
+        if (p < end && *p == '-') p++;
+        const char* digits = p;
+        while (p < end && *p >= '0' && *p <= '9') p++;
+        if (p == digits) return false;
+        if (p < end && *p == '.') {
+            digits = ++p;
+            while (p < end && *p >= '0' && *p <= '9') p++;
+            if (p == digits) return false;
+        }
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            p++;
+            if (p < end && (*p == '+' || *p == '-')) p++;
+            digits = p;
+            while (p < end && *p >= '0' && *p <= '9') p++;
+            if (p == digits) return false;
+        }
+        len = static_cast<size_t>(p - start);
+        return true;
+    }
+
+    bool literal(const char* word) {
+        size_t len = strlen(word);
+        if (static_cast<size_t>(end - p) < len || memcmp(p, word, len) != 0) return false;
+        p += len;
+        return true;
+    }
+
+    bool scalar(JsonScanner::Type type, const char* start, size_t len) {
+        JsonScanner::Value value = {type, start, len};
+        visit(path, value);
+        return true;
+    }
+
+    bool value() {
+        skipWs();
+        if (p >= end) return false;
+        const char* start = p;
+        size_t len = 0;
+        switch (*p) {
+            case '{': return object();
+            case '[': return array();
+            case '"':
+                return string(start, len) && scalar(JsonScanner::Type::STRING, start, len);
+            case 't':
+                return literal("true") && scalar(JsonScanner::Type::BOOL, start, 4);
+            case 'f':
+                return literal("false") && scalar(JsonScanner::Type::BOOL, start, 5);
+            case 'n':
+                return literal("null") && scalar(JsonScanner::Type::NUL, start, 4);
+            default:
+                return number(start, len) && scalar(JsonScanner::Type::NUMBER, start, len);
+        }
+    }
+
+    bool object() {
+        if (path.depth >= JsonScanner::MAX_DEPTH) return false;
+        uint8_t level = path.depth++;
+        p++;   // '{'
+        skipWs();
+        if (p < end && *p == '}') {
+            p++;
+            path.depth--;
+            return true;
+        }
+        while (true) {
+            skipWs();
+            const char* key;
+            size_t key_len;
+            if (!string(key, key_len) || key_len > 255) return false;
+            path.key[level] = key;
+            path.key_len[level] = static_cast<uint8_t>(key_len);
+            skipWs();
+            if (p >= end || *p != ':') return false;
+            p++;
+            if (!value()) return false;
+            skipWs();
+            if (p >= end) return false;
+            if (*p == ',') {
+                p++;
+                continue;
+            }
+            if (*p != '}') return false;
+            p++;
+            path.depth--;
+            return true;
+        }
+    }
+
+    bool array() {
+        if (path.depth >= JsonScanner::MAX_DEPTH) return false;
+        uint8_t level = path.depth++;
+        path.key[level] = p;
+        path.key_len[level] = 0;
+        p++;   // '['
+        skipWs();
+        if (p < end && *p == ']') {
+            p++;
+            path.depth--;
+            return true;
+        }
+        while (true) {
+            if (!value()) return false;
+            skipWs();
+            if (p >= end) return false;
+            if (*p == ',') {
+                p++;
+                continue;
+            }
+            if (*p != ']') return false;
+            p++;
+            path.depth--;
+            return true;
+        }
+    }
+};
+
+}  // namespace
+
+bool JsonScanner::scan(const char* json, size_t len, const Visitor& visit) {
+    if (!json) return false;
+    Cursor cursor{json, json + len, {}, visit};
+    cursor.path.depth = 0;
+    if (!cursor.value()) return false;
+    cursor.skipWs();
+    return cursor.p == cursor.end;
+}
@@ -0,0 +1,76 @@
+#ifndef JSON_SCANNER_H
+#define JSON_SCANNER_H
+
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Streaming JSON scanner over a caller-owned buffer
+ *
+ * Walks a document once and reports every scalar (string, number, bool,
+ * null) together with the chain of object keys that leads to it. Nothing
+ * is copied or allocated: keys and values point into the input buffer, and
+ * nesting is tracked in a fixed path stack of MAX_DEPTH levels. There is
+ * no DOM, so a consumer picks the fields it knows and ignores the rest.
+ *
+ * Array elements are reported with an empty key at their level.
+ *
+ * Usage:
+ *   JsonScanner::scan(buf, len, [&](const JsonScanner::Path& path,
+ *                                   const JsonScanner::Value& value) {
+ *       if (path.is("state.settings.volume")) volume = value.asLong();
+ *   });
+ */
+class JsonScanner {
+public:
+    static constexpr size_t MAX_DEPTH = 8;
+
+    enum class Type : uint8_t {
+        STRING,
+        NUMBER,
+        BOOL,
+        NUL
+    };
+
+    struct Value {
+        Type type;
+        const char* raw;     // Token in the buffer (strings: between the quotes, escapes kept)
+        size_t len;
+
+        bool asBool() const { return type == Type::BOOL && raw[0] == 't'; }
+        bool isInteger() const;
+        long asLong() const;
+        /**
+         * Copy a string value with escapes decoded (\uXXXX outside ASCII → '?')
+         * @return false if not a string or it does not fit in max (with the 0)
+         */
+        bool copyString(char* out, size_t max) const;
+    };
+
+    struct Path {
+        const char* key[MAX_DEPTH];
+        uint8_t key_len[MAX_DEPTH];
+        uint8_t depth;
+
+        /**
+         * Compare against a dotted key chain ("state.settings.volume")
+         */
+        bool is(const char* dotted) const;
+        /**
+         * Key at level i equals name (escapes not decoded)
+         */
+        bool keyIs(size_t i, const char* name) const;
+    };
+
+    using Visitor = std::function<void(const Path& path, const Value& value)>;
+
+    /**
+     * Scan a complete document (one top-level value, trailing whitespace allowed)
+     * @return false on malformed input or nesting deeper than MAX_DEPTH; values
+     *         before the error have already been reported
+     */
+    static bool scan(const char* json, size_t len, const Visitor& visit);
+};
+
+#endif // JSON_SCANNER_H
@@ -0,0 +1,508 @@
+#include "NvsAccounting.h"
+
+#if NVS_ACCOUNTING
+
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+
+#ifdef NATIVE_BUILD
+#include <stdio.h>
+#define NVS_LOG(...) printf(__VA_ARGS__)
+#else
+#include <freertos/FreeRTOS.h>
+#define NVS_LOG(...) Serial.printf(__VA_ARGS__)
+#endif
+
+// ============================================================================
+// Accounting State (static, never heap-allocated)
+// ============================================================================
+
+namespace {
+
+using ItemType = NvsAccounting::ItemType;
+
+struct KeySlot {
+    NvsAccounting::KeyStats stats;
+    uint32_t value_hash;     // FNV-1a of the live value (identical-write detection)
+    uint32_t value_len;
+    int8_t page;             // Page holding the live copy
+    uint8_t span;            // Entries of the live copy
+    bool live;
+};
+
+KeySlot s_keys[NvsAccounting::MAX_KEYS];
+size_t s_key_count = 0;
+
+NvsAccounting::PageStats s_pages[NvsAccounting::MAX_PAGES];
+uint32_t s_order[NvsAccounting::MAX_PAGES];   // Activation / free order (IDF page list order)
+uint32_t s_seq = 0;
+uint8_t s_page_count = 0;
+int8_t s_active = -1;
+
+NvsAccounting::Totals s_totals;
+bool s_started = false;
+
+// ----------------------------------------------------------------------------
+// Lock: spinlock, no allocation, short critical sections only
+// ----------------------------------------------------------------------------
+
+#ifdef NATIVE_BUILD
+std::atomic_flag s_lock = ATOMIC_FLAG_INIT;
+
+inline void lock() {
+    while (s_lock.test_and_set(std::memory_order_acquire)) {
+        // spin
+    }
+}
+
+inline void unlock() {
+    s_lock.clear(std::memory_order_release);
+}
+#else
+portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+inline void lock() {
+    portENTER_CRITICAL(&s_lock);
+}
+
+inline void unlock() {
+    portEXIT_CRITICAL(&s_lock);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// Page model (call with lock held)
+// ----------------------------------------------------------------------------
+
+void resetLocked(uint32_t partition_size) {
+    memset(s_keys, 0, sizeof(s_keys));
+    memset(s_pages, 0, sizeof(s_pages));
+    memset(&s_totals, 0, sizeof(s_totals));
+    s_key_count = 0;
+
+    uint32_t pages = partition_size / NvsAccounting::PAGE_SIZE;
+    if (pages < 2) pages = 2;   // NVS needs at least one data page + reserve
+    if (pages > NvsAccounting::MAX_PAGES) pages = NvsAccounting::MAX_PAGES;
+    s_page_count = static_cast<uint8_t>(pages);
+
+    for (uint8_t i = 0; i < s_page_count; i++) {
+        s_pages[i].state = NvsAccounting::PAGE_FREE;
+        s_order[i] = i;
+    }
+    s_seq = s_page_count;
+    s_active = -1;
+    s_started = true;
+}
+
+inline void ensureStarted() {
+    if (!s_started) {
+        resetLocked(NvsAccounting::DEFAULT_PARTITION_SIZE);
+    }
+}
+
+uint8_t freePageCount() {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < s_page_count; i++) {
+        if (s_pages[i].state == NvsAccounting::PAGE_FREE) count++;
+    }
+    return count;
+}
+
+int8_t takeFreePage() {
+    int8_t oldest = -1;
+    for (uint8_t i = 0; i < s_page_count; i++) {
+        if (s_pages[i].state != NvsAccounting::PAGE_FREE) continue;
+        if (oldest < 0 || s_order[i] < s_order[oldest]) oldest = i;
+    }
+    if (oldest >= 0) {
+        s_pages[oldest].state = NvsAccounting::PAGE_ACTIVE;
+        s_pages[oldest].used = 0;
+        s_pages[oldest].erased = 0;
+        s_order[oldest] = s_seq++;
+    }
+    return oldest;
+}
+
+// Reclaim the full page with the most erased entries into the reserve page
+// (ties: the oldest page, like the IDF page list walk)
+bool collectGarbage() {
+    int8_t victim = -1;
+    for (uint8_t i = 0; i < s_page_count; i++) {
+        if (s_pages[i].state != NvsAccounting::PAGE_FULL) continue;
+        if (victim < 0 || s_pages[i].erased > s_pages[victim].erased ||
+            (s_pages[i].erased == s_pages[victim].erased && s_order[i] < s_order[victim])) {
+            victim = i;
+        }
+    }
+    if (victim < 0 || s_pages[victim].erased == 0) {
+        return false;   // Everything is live: partition full
+    }
+
+    int8_t target = takeFreePage();
+    if (target < 0) return false;
+
+    for (size_t i = 0; i < s_key_count; i++) {
+        KeySlot& slot = s_keys[i];
+        if (!slot.live || slot.page != victim) continue;
+        slot.page = target;
+        s_pages[target].used += slot.span;
+        s_totals.relocated += slot.span;
+    }
+
+    s_pages[victim].state = NvsAccounting::PAGE_FREE;
+    s_pages[victim].used = 0;
+    s_pages[victim].erased = 0;
+    s_pages[victim].erase_count++;
+    s_order[victim] = s_seq++;
+
+    s_totals.gc_runs++;
+    s_totals.page_erases++;
+    s_active = target;
+    return true;
+}
+
+// Page that receives `span` new entries, -1 if there is no space
+int8_t allocate(uint8_t span) {
+    if (span > NvsAccounting::ENTRIES_PER_PAGE) return -1;
+
+    for (uint8_t attempt = 0; attempt <= s_page_count * 2; attempt++) {
+        if (s_active >= 0 && s_pages[s_active].used + span <= NvsAccounting::ENTRIES_PER_PAGE) {
+            s_pages[s_active].used += span;
+            return s_active;
+        }
+        if (s_active >= 0) {
+            s_pages[s_active].state = NvsAccounting::PAGE_FULL;
+            s_active = -1;
+        }
+        if (freePageCount() >= 2) {
+            s_active = takeFreePage();
+            continue;
+        }
+        if (!collectGarbage()) {
+            return -1;
+        }
+    }
+    return -1;
+}
+
+void eraseItem(KeySlot& slot) {
+    if (!slot.live) return;
+    s_pages[slot.page].erased += slot.span;
+    slot.live = false;
+    slot.stats.removes++;
+    s_totals.removes++;
+}
+
+// ----------------------------------------------------------------------------
+// Key table helpers (call with lock held)
+// ----------------------------------------------------------------------------
+
+uint32_t hashValue(const void* data, size_t len) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ bytes[i]) * 16777619u;
+    }
+    return h;
+}
+
+void copyName(char* dst, const char* src) {
+    strncpy(dst, src ? src : "", 15);
+    dst[15] = '\0';
+}
+
+KeySlot* findKey(const char* ns, const char* key, bool create) {
+    for (size_t i = 0; i < s_key_count; i++) {
+        if (strncmp(s_keys[i].stats.ns, ns, 15) == 0 && strncmp(s_keys[i].stats.key, key, 15) == 0) {
+            return &s_keys[i];
+        }
+    }
+    if (!create || s_key_count >= NvsAccounting::MAX_KEYS) {
+        return nullptr;
+    }
+
+    KeySlot& slot = s_keys[s_key_count++];
+    memset(&slot, 0, sizeof(slot));
+    copyName(slot.stats.ns, ns);
+    copyName(slot.stats.key, key);
+    return &slot;
+}
+
+void writeItem(KeySlot& slot, ItemType type, const void* data, size_t len) {
+    slot.stats.puts++;
+    s_totals.puts++;
+
+    uint32_t hash = hashValue(data, len);
+    if (slot.live && slot.stats.type == type && slot.value_len == len && slot.value_hash == hash) {
+        slot.stats.skipped++;
+        s_totals.skipped++;
+        return;
+    }
+
+    uint8_t span = static_cast<uint8_t>(NvsAccounting::entriesFor(type, len));
+    int8_t page = allocate(span);
+    if (page < 0) {
+        s_totals.failed_writes++;
+        return;
+    }
+
+    // New copy is written first, then the old one is marked erased (it may
+    // have been relocated by a GC run during allocate)
+    if (slot.live) {
+        s_pages[slot.page].erased += slot.span;
+    }
+    slot.live = true;
+    slot.page = page;
+    slot.span = span;
+    slot.value_hash = hash;
+    slot.value_len = len;
+    slot.stats.type = type;
+
+    slot.stats.writes++;
+    slot.stats.bytes += len;
+    slot.stats.entries += span;
+    s_totals.writes++;
+    s_totals.bytes += len;
+    s_totals.entries += span;
+}
+
+const char* pageStateName(uint8_t state) {
+    switch (state) {
+        case NvsAccounting::PAGE_FREE: return "FREE";
+        case NvsAccounting::PAGE_ACTIVE: return "ACTIVE";
+        case NvsAccounting::PAGE_FULL: return "FULL";
+        default: return "?";
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void NvsAccounting::begin(uint32_t partition_size) {
+    lock();
+    resetLocked(partition_size);
+    unlock();
+}
+
+uint32_t NvsAccounting::entriesFor(ItemType type, size_t len) {
+    switch (type) {
+        case ItemType::STR:
+            return 1 + (len + ENTRY_SIZE - 1) / ENTRY_SIZE;       // len includes '\0'
+        case ItemType::BLOB:
+            return 2 + (len + ENTRY_SIZE - 1) / ENTRY_SIZE;       // Data header + data + index
+        default:
+            return 1;                                              // Integers live in the header
+    }
+}
+
+void NvsAccounting::onOpen(const char* ns, bool read_only) {
+    if (read_only || !ns) return;   // Read-only open never creates the namespace
+
+    lock();
+    ensureStarted();
+    KeySlot* slot = findKey("", ns, true);
+    if (!slot) {
+        s_totals.untracked++;
+    } else if (!slot->live) {
+        uint8_t index = 0;
+        writeItem(*slot, ItemType::U8, &index, sizeof(index));
+    }
+    unlock();
+}
+
+void NvsAccounting::onWrite(const char* ns, const char* key, ItemType type, const void* data, size_t len) {
+    if (!ns || !key) return;
+
+    lock();
+    ensureStarted();
+    KeySlot* slot = findKey(ns, key, true);
+    if (!slot) {
+        s_totals.untracked++;
+    } else {
+        writeItem(*slot, type, data, len);
+    }
+    unlock();
+}
+
+void NvsAccounting::onRemove(const char* ns, const char* key) {
+    if (!ns || !key) return;
+
+    lock();
+    ensureStarted();
+    KeySlot* slot = findKey(ns, key, false);
+    if (slot) {
+        eraseItem(*slot);
+    }
+    unlock();
+}
+
+void NvsAccounting::onClear(const char* ns) {
+    if (!ns) return;
+
+    lock();
+    ensureStarted();
+    for (size_t i = 0; i < s_key_count; i++) {
+        if (strncmp(s_keys[i].stats.ns, ns, 15) == 0) {
+            eraseItem(s_keys[i]);
+        }
+    }
+    unlock();
+}
+
+NvsAccounting::Totals NvsAccounting::getTotals() {
+    lock();
+    Totals totals = s_totals;
+    unlock();
+    return totals;
+}
+
+bool NvsAccounting::getKey(const char* ns, const char* key, KeyStats& out) {
+    lock();
+    KeySlot* slot = findKey(ns, key, false);
+    if (slot) out = slot->stats;
+    unlock();
+    return slot != nullptr;
+}
+
+size_t NvsAccounting::getTopKeys(KeyStats* out, size_t max_keys) {
+    size_t count = 0;
+    lock();
+    for (size_t i = 0; i < s_key_count; i++) {
+        const KeyStats& stats = s_keys[i].stats;
+        if (stats.puts == 0) continue;
+
+        // Insertion into the sorted output (small N)
+        size_t pos;
+        if (count < max_keys) {
+            pos = count++;
+        } else if (max_keys > 0 && out[max_keys - 1].entries < stats.entries) {
+            pos = max_keys - 1;   // Replaces the smallest
+        } else {
+            continue;
+        }
+        while (pos > 0 && out[pos - 1].entries < stats.entries) {
+            out[pos] = out[pos - 1];
+            pos--;
+        }
+        out[pos] = stats;
+    }
+    unlock();
+    return count;
+}
+
+size_t NvsAccounting::getPages(PageStats* out, size_t max_pages) {
+    lock();
+    ensureStarted();
+    size_t count = s_page_count < max_pages ? s_page_count : max_pages;
+    memcpy(out, s_pages, count * sizeof(PageStats));
+    unlock();
+    return count;
+}
+
+uint32_t NvsAccounting::getLiveEntries() {
+    uint32_t live = 0;
+    lock();
+    for (size_t i = 0; i < s_key_count; i++) {
+        if (s_keys[i].live) live += s_keys[i].span;
+    }
+    unlock();
+    return live;
+}
+
+NvsAccounting::LifetimeProjection NvsAccounting::projectLifetime(float days, uint32_t endurance_cycles) {
+    LifetimeProjection projection = {};
+    projection.days = days;
+
+    lock();
+    ensureStarted();
+    uint32_t total = s_totals.page_erases;
+    for (uint8_t i = 0; i < s_page_count; i++) {
+        if (s_pages[i].erase_count > projection.worst_page_erases) {
+            projection.worst_page_erases = s_pages[i].erase_count;
+        }
+    }
+    unlock();
+
+    if (days <= 0.0f) return projection;
+
+    projection.erases_per_day = total / days;
+    projection.worst_page_erases_per_day = projection.worst_page_erases / days;
+    if (projection.worst_page_erases > 0) {
+        projection.years = endurance_cycles / projection.worst_page_erases_per_day / 365.0f;
+    }
+    return projection;
+}
+
+void NvsAccounting::printReport(float days) {
+    if (days <= 0.0f) {
+        days = millis() / 86400000.0f;
+    }
+
+    // Snapshot first: printing must not hold the spinlock
+    KeyStats top[12];
+    size_t top_count = getTopKeys(top, 12);
+    PageStats pages[MAX_PAGES];
+    size_t page_count = getPages(pages, MAX_PAGES);
+    Totals totals = getTotals();
+    uint32_t live = getLiveEntries();
+    LifetimeProjection projection = projectLifetime(days);
+
+    NVS_LOG("\n=== NVS Write Accounting ===\n");
+    NVS_LOG("Partition: %u pages, live entries %lu/%lu\n",
+            (unsigned)page_count, (unsigned long)live,
+            (unsigned long)((page_count - 1) * ENTRIES_PER_PAGE));
+    NVS_LOG("%-12s %-15s %7s %7s %7s %8s %8s\n",
+            "Namespace", "Key", "Puts", "Skipped", "Writes", "Bytes", "Entries");
+    for (size_t i = 0; i < top_count; i++) {
+        NVS_LOG("%-12s %-15s %7lu %7lu %7lu %8lu %8lu\n",
+                top[i].ns[0] ? top[i].ns : "<ns>", top[i].key,
+                (unsigned long)top[i].puts, (unsigned long)top[i].skipped,
+                (unsigned long)top[i].writes, (unsigned long)top[i].bytes,
+                (unsigned long)top[i].entries);
+    }
+    NVS_LOG("Totals: puts=%lu skipped=%lu writes=%lu bytes=%lu entries=%lu removes=%lu\n",
+            (unsigned long)totals.puts, (unsigned long)totals.skipped,
+            (unsigned long)totals.writes, (unsigned long)totals.bytes,
+            (unsigned long)totals.entries, (unsigned long)totals.removes);
+    NVS_LOG("GC: runs=%lu relocated=%lu erases=%lu failed=%lu untracked=%lu\n",
+            (unsigned long)totals.gc_runs, (unsigned long)totals.relocated,
+            (unsigned long)totals.page_erases, (unsigned long)totals.failed_writes,
+            (unsigned long)totals.untracked);
+    for (size_t i = 0; i < page_count; i++) {
+        NVS_LOG("  page %u: %-6s used=%3u erased=%3u erases=%lu\n",
+                (unsigned)i, pageStateName(pages[i].state), pages[i].used,
+                pages[i].erased, (unsigned long)pages[i].erase_count);
+    }
+    if (projection.years > 0.0f) {
+        NVS_LOG("Lifetime: %.2f erases/day, worst page %.3f/day -> %.1f years @ %lu cycles (%.2f days)\n",
+                projection.erases_per_day, projection.worst_page_erases_per_day,
+                projection.years, (unsigned long)FLASH_ENDURANCE_CYCLES, projection.days);
+    } else {
+        NVS_LOG("Lifetime: no page erases in %.2f days\n", projection.days);
+    }
+    NVS_LOG("============================\n");
+}
+
+#else  // !NVS_ACCOUNTING
+
+// Accounting compiled out: hooks do nothing, queries return empty data
+
+void NvsAccounting::begin(uint32_t) {}
+void NvsAccounting::onOpen(const char*, bool) {}
+void NvsAccounting::onWrite(const char*, const char*, ItemType, const void*, size_t) {}
+void NvsAccounting::onRemove(const char*, const char*) {}
+void NvsAccounting::onClear(const char*) {}
+uint32_t NvsAccounting::entriesFor(ItemType, size_t) { return 0; }
+NvsAccounting::Totals NvsAccounting::getTotals() { return Totals{}; }
+bool NvsAccounting::getKey(const char*, const char*, KeyStats&) { return false; }
+size_t NvsAccounting::getTopKeys(KeyStats*, size_t) { return 0; }
+size_t NvsAccounting::getPages(PageStats*, size_t) { return 0; }
+uint32_t NvsAccounting::getLiveEntries() { return 0; }
+NvsAccounting::LifetimeProjection NvsAccounting::projectLifetime(float, uint32_t) { return LifetimeProjection{}; }
+void NvsAccounting::printReport(float) {}
+
+#endif  // NVS_ACCOUNTING
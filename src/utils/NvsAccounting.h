@@ -0,0 +1,153 @@
+#ifndef NVS_ACCOUNTING_H
+#define NVS_ACCOUNTING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef NVS_ACCOUNTING
+#define NVS_ACCOUNTING 0
+#endif
+
+/**
+ * NVS write accounting and flash wear model
+ *
+ * Counts every Preferences write made through NvsPreferences (Config,
+ * Statistics, StackProfiler) per namespace/key, and replays it against a
+ * model of the ESP-IDF NVS page layout to estimate how many flash sector
+ * erases the writes cost. Storage changes (fewer keys, batching, skipping
+ * unchanged values) should be judged by the erase count, not by guesswork.
+ *
+ * NVS model (ESP-IDF 4.4, nvs_page.cpp / nvs_pagemanager.cpp):
+ * - Partition split into 4KB pages, 126 entries of 32 bytes per page
+ * - Item sizes: integer 1 entry, string 1 + ceil(len+1 / 32),
+ *   blob 1 data header + ceil(len / 32) + 1 index entry, namespace 1 entry
+ * - Writes append to the active page, the previous copy is marked erased
+ * - Writing identical data is skipped (no flash write)
+ * - One free page is always kept in reserve. When the active page is full
+ *   and only the reserve is left, the full page with the most erased
+ *   entries is garbage collected: live items are copied to the reserve,
+ *   the sector is erased (one erase cycle) and becomes the new reserve
+ *
+ * Per key: put calls, skipped identical writes, flash writes, payload bytes
+ * and entries written. Per page: erase count. Projection: worst-page erase
+ * rate against the flash endurance (100k cycles) → years of lifetime.
+ *
+ * On the device the page model starts from an empty partition at boot, so
+ * the per-key counters are exact but the erase projection only becomes
+ * meaningful after the live set has been rewritten. Use the host simulator
+ * (test/sim/NvsLifetimeSim.h) to project lifetime from a usage profile.
+ *
+ * Memory: fixed static tables, never allocates.
+ *
+ * Usage:
+ *   NvsPreferences prefs;              // Drop-in for Preferences
+ *   prefs.begin("stats", false);
+ *   prefs.putBytes("day_3", &day, sizeof(day));   // accounted
+ *
+ *   NvsAccounting::printReport();      // from the task monitor
+ *
+ * Build: env:m5stack-core2-profile (device), env:native (host).
+ * With NVS_ACCOUNTING=0 the hooks compile to nothing.
+ */
+class NvsAccounting {
+public:
+    // NVS item types as stored on flash (Preferences::putBool → U8, putFloat → BLOB)
+    enum class ItemType : uint8_t {
+        U8,
+        U16,
+        U32,
+        I32,
+        U64,
+        STR,
+        BLOB
+    };
+
+    struct KeyStats {
+        char ns[16];            // Namespace ("" for namespace entries)
+        char key[16];           // Key (namespace name for namespace entries)
+        ItemType type;
+        uint32_t puts;          // put*() calls
+        uint32_t skipped;       // Identical data, no flash write
+        uint32_t writes;        // Flash writes
+        uint32_t bytes;         // Payload bytes written
+        uint32_t entries;       // 32-byte entries written (incl. headers)
+        uint32_t removes;       // remove()/clear() of a live item
+    };
+
+    struct Totals {
+        uint32_t puts;
+        uint32_t skipped;
+        uint32_t writes;
+        uint32_t bytes;
+        uint32_t entries;
+        uint32_t removes;
+        uint32_t gc_runs;           // Garbage collections (each erases one page)
+        uint32_t relocated;         // Live entries copied by GC
+        uint32_t page_erases;       // Sector erases (GC)
+        uint32_t failed_writes;     // No space even after GC (ESP_ERR_NVS_NOT_ENOUGH_SPACE)
+        uint32_t untracked;         // Key table full
+    };
+
+    struct PageStats {
+        uint8_t state;              // PageState
+        uint8_t used;               // Entries written since last erase
+        uint8_t erased;             // Of which marked erased
+        uint32_t erase_count;       // Sector erases
+    };
+
+    struct LifetimeProjection {
+        float days;                 // Observation window
+        float erases_per_day;       // All pages
+        float worst_page_erases_per_day;
+        uint32_t worst_page_erases;
+        float years;                // Until the worst page reaches endurance (0 = no erases yet)
+    };
+
+    enum PageState : uint8_t {
+        PAGE_FREE,
+        PAGE_ACTIVE,
+        PAGE_FULL
+    };
+
+    // NVS format constants (ESP-IDF)
+    static constexpr uint32_t PAGE_SIZE = 4096;
+    static constexpr uint32_t ENTRY_SIZE = 32;
+    static constexpr uint32_t ENTRIES_PER_PAGE = 126;
+    static constexpr uint32_t DEFAULT_PARTITION_SIZE = 0x5000;   // partitions.csv "nvs"
+    static constexpr uint32_t FLASH_ENDURANCE_CYCLES = 100000;   // Per sector
+
+    // Table sizes (fixed, no heap)
+    static constexpr size_t MAX_KEYS = 160;
+    static constexpr size_t MAX_PAGES = 16;
+
+    // Reset counters and start the page model on an empty partition
+    static void begin(uint32_t partition_size = DEFAULT_PARTITION_SIZE);
+
+    // Hooks (called by NvsPreferences)
+    static void onOpen(const char* ns, bool read_only);
+    static void onWrite(const char* ns, const char* key, ItemType type, const void* data, size_t len);
+    static void onRemove(const char* ns, const char* key);
+    static void onClear(const char* ns);
+
+    // Entries an item of this type/length occupies
+    static uint32_t entriesFor(ItemType type, size_t len);
+
+    // Queries (snapshots, safe to call from any task)
+    static Totals getTotals();
+    static bool getKey(const char* ns, const char* key, KeyStats& out);
+    static size_t getTopKeys(KeyStats* out, size_t max_keys);      // Sorted by entries written
+    static size_t getPages(PageStats* out, size_t max_pages);
+    static uint32_t getLiveEntries();
+
+    // Lifetime from the erases observed over `days` of usage
+    static LifetimeProjection projectLifetime(float days,
+                                              uint32_t endurance_cycles = FLASH_ENDURANCE_CYCLES);
+
+    // Print per-key table, page wear and projection (Serial on device, stdout on host)
+    // days = 0 → uptime on device
+    static void printReport(float days = 0.0f);
+
+    static constexpr bool isEnabled() { return NVS_ACCOUNTING != 0; }
+};
+
+#endif // NVS_ACCOUNTING_H
@@ -0,0 +1,125 @@
+#ifndef NVS_PREFERENCES_H
+#define NVS_PREFERENCES_H
+
+#include <Preferences.h>
+#include <string.h>
+#include "NvsAccounting.h"
+
+/**
+ * Preferences with NVS write accounting
+ *
+ * Drop-in replacement for Preferences: the write methods used in the tree
+ * (put*, remove, clear) forward to Preferences and report successful writes
+ * to NvsAccounting with the NVS item type they map to. Reads are inherited
+ * unchanged. With NVS_ACCOUNTING=0 every method is a plain forward.
+ *
+ * Usage:
+ *   NvsPreferences prefs;
+ *   prefs.begin("config", false);
+ *   prefs.putUShort("pom_work", 25);   // NVS item U16, 1 entry
+ */
+class NvsPreferences : public Preferences {
+public:
+    using ItemType = NvsAccounting::ItemType;
+
+    bool begin(const char* name, bool read_only = false, const char* partition_label = nullptr) {
+        bool ok = Preferences::begin(name, read_only, partition_label);
+#if NVS_ACCOUNTING
+        if (ok) {
+            strncpy(ns_, name, sizeof(ns_) - 1);
+            ns_[sizeof(ns_) - 1] = '\0';
+            read_only_ = read_only;
+            NvsAccounting::onOpen(ns_, read_only);
+        }
+#endif
+        return ok;
+    }
+
+    void end() {
+        Preferences::end();
+#if NVS_ACCOUNTING
+        ns_[0] = '\0';
+#endif
+    }
+
+    bool clear() {
+        bool ok = Preferences::clear();
+#if NVS_ACCOUNTING
+        if (ok) NvsAccounting::onClear(ns_);
+#endif
+        return ok;
+    }
+
+    bool remove(const char* key) {
+        bool ok = Preferences::remove(key);
+#if NVS_ACCOUNTING
+        if (ok) NvsAccounting::onRemove(ns_, key);
+#endif
+        return ok;
+    }
+
+    size_t putUChar(const char* key, uint8_t value) {
+        return track(key, ItemType::U8, &value, sizeof(value), Preferences::putUChar(key, value));
+    }
+
+    size_t putUShort(const char* key, uint16_t value) {
+        return track(key, ItemType::U16, &value, sizeof(value), Preferences::putUShort(key, value));
+    }
+
+    size_t putUInt(const char* key, uint32_t value) {
+        return track(key, ItemType::U32, &value, sizeof(value), Preferences::putUInt(key, value));
+    }
+
+    size_t putInt(const char* key, int32_t value) {
+        return track(key, ItemType::I32, &value, sizeof(value), Preferences::putInt(key, value));
+    }
+
+    size_t putULong(const char* key, uint32_t value) {
+        return track(key, ItemType::U32, &value, sizeof(value), Preferences::putULong(key, value));
+    }
+
+    size_t putBool(const char* key, bool value) {
+        uint8_t stored = value ? 1 : 0;   // nvs_set_u8
+        return track(key, ItemType::U8, &stored, sizeof(stored), Preferences::putBool(key, value));
+    }
+
+    size_t putFloat(const char* key, float value) {
+        return track(key, ItemType::BLOB, &value, sizeof(value), Preferences::putFloat(key, value));
+    }
+
+    size_t putString(const char* key, const char* value) {
+        size_t written = Preferences::putString(key, value);
+#if NVS_ACCOUNTING
+        // Returns strlen(), so an empty string reports 0 even when stored
+        if (value && (written > 0 || value[0] == '\0') && writable()) {
+            NvsAccounting::onWrite(ns_, key, ItemType::STR, value, strlen(value) + 1);
+        }
+#endif
+        return written;
+    }
+
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        return track(key, ItemType::BLOB, value, len, Preferences::putBytes(key, value, len));
+    }
+
+private:
+#if NVS_ACCOUNTING
+    char ns_[16] = "";
+    bool read_only_ = true;
+
+    bool writable() const { return ns_[0] != '\0' && !read_only_; }
+#endif
+
+    size_t track(const char* key, ItemType type, const void* value, size_t len, size_t written) {
+#if NVS_ACCOUNTING
+        if (written > 0 && writable()) {
+            NvsAccounting::onWrite(ns_, key, type, value, len);
+        }
+#else
+        (void)key; (void)type; (void)value; (void)len;
+#endif
+        return written;
+    }
+};
+
+#endif // NVS_PREFERENCES_H
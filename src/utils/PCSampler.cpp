@@ -0,0 +1,202 @@
+#include "PCSampler.h"
+
+#if PC_SAMPLING && !defined(NATIVE_BUILD)
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/xtensa_context.h>
+#include <esp_attr.h>
+
+#ifndef PC_SAMPLER_TIMER
+#define PC_SAMPLER_TIMER 3  // Hardware timer 3 (group 1, timer 1) - unused by this project
+#endif
+
+static_assert((PCSampler::TABLE_SIZE & (PCSampler::TABLE_SIZE - 1)) == 0,
+              "TABLE_SIZE must be a power of two");
+
+// ============================================================================
+// State (written only by the ISR on the sampled core)
+// ============================================================================
+
+static hw_timer_t* s_timer = nullptr;
+static DRAM_ATTR PCSampler::Sample s_table[PCSampler::TABLE_SIZE];
+static DRAM_ATTR volatile uint32_t s_region_counts[static_cast<size_t>(PCSampler::Region::COUNT)];
+static DRAM_ATTR volatile uint32_t s_total = 0;
+static DRAM_ATTR volatile uint32_t s_dropped = 0;   // Table full
+static DRAM_ATTR volatile uint32_t s_no_task = 0;   // Before scheduler start
+static int s_core = -1;
+
+static inline PCSampler::Region IRAM_ATTR classifyPC(uint32_t pc) {
+    if (pc >= 0x40080000 && pc < 0x400A0000) return PCSampler::Region::IRAM;
+    if (pc >= 0x400D0000 && pc < 0x40400000) return PCSampler::Region::FLASH;
+    if (pc >= 0x40000000 && pc < 0x40070000) return PCSampler::Region::ROM;
+    return PCSampler::Region::OTHER;
+}
+
+static void IRAM_ATTR onSampleTimer() {
+    TaskHandle_t task = xTaskGetCurrentTaskHandleForCPU(xPortGetCoreID());
+    if (task == NULL) {
+        s_no_task = s_no_task + 1;
+        return;
+    }
+
+    // pxTopOfStack (first TCB field) = interrupted task's saved exception frame
+    const XtExcFrame* frame = *reinterpret_cast<XtExcFrame* const*>(task);
+    uint32_t pc = static_cast<uint32_t>(frame->pc);
+
+    s_total = s_total + 1;
+    size_t region = static_cast<size_t>(classifyPC(pc));
+    s_region_counts[region] = s_region_counts[region] + 1;
+
+    // Open addressing, bounded probe
+    uint32_t slot = ((pc >> 2) * 2654435761u) & (PCSampler::TABLE_SIZE - 1);
+    for (size_t probe = 0; probe < 16; probe++) {
+        PCSampler::Sample& entry = s_table[slot];
+        if (entry.pc == pc) {
+            entry.count++;
+            return;
+        }
+        if (entry.count == 0) {
+            entry.pc = pc;
+            entry.count = 1;
+            return;
+        }
+        slot = (slot + 1) & (PCSampler::TABLE_SIZE - 1);
+    }
+    s_dropped = s_dropped + 1;
+}
+
+// ============================================================================
+// Control
+// ============================================================================
+
+bool PCSampler::begin(uint32_t hz) {
+    if (s_timer != nullptr) {
+        return true;
+    }
+
+    hz = constrain(hz, 100, 10000);
+
+    // Interrupt is allocated on the calling core - call from the task to profile
+    s_timer = timerBegin(PC_SAMPLER_TIMER, 80, true);  // 80MHz APB / 80 = 1MHz
+    if (s_timer == nullptr) {
+        Serial.println("[PCSampler] ERROR: Failed to start timer");
+        return false;
+    }
+
+    timerAttachInterrupt(s_timer, &onSampleTimer, true);
+    timerAlarmWrite(s_timer, 1000000 / hz, true);
+    timerAlarmEnable(s_timer);
+
+    s_core = xPortGetCoreID();
+    Serial.printf("[PCSampler] ✓ Sampling core %d at %lu Hz\n", s_core, (unsigned long)hz);
+    return true;
+}
+
+void PCSampler::stop() {
+    if (s_timer == nullptr) return;
+
+    timerAlarmDisable(s_timer);
+    timerDetachInterrupt(s_timer);
+    timerEnd(s_timer);
+    s_timer = nullptr;
+}
+
+void PCSampler::reset() {
+    bool running = (s_timer != nullptr);
+    if (running) timerAlarmDisable(s_timer);
+
+    memset(s_table, 0, sizeof(s_table));
+    for (size_t i = 0; i < static_cast<size_t>(Region::COUNT); i++) {
+        s_region_counts[i] = 0;
+    }
+    s_total = 0;
+    s_dropped = 0;
+    s_no_task = 0;
+
+    if (running) timerAlarmEnable(s_timer);
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+uint32_t PCSampler::getTotalSamples() {
+    return s_total;
+}
+
+uint32_t PCSampler::getRegionSamples(Region region) {
+    size_t index = static_cast<size_t>(region);
+    return index < static_cast<size_t>(Region::COUNT) ? s_region_counts[index] : 0;
+}
+
+PCSampler::Region PCSampler::classify(uint32_t pc) {
+    return classifyPC(pc);
+}
+
+size_t PCSampler::getTopSamples(Sample* out, size_t max_samples) {
+    if (!out || max_samples == 0) return 0;
+
+    // Single pass insertion into a sorted top-N (no copy of the 8KB table)
+    size_t found = 0;
+    for (size_t i = 0; i < TABLE_SIZE; i++) {
+        Sample entry = s_table[i];  // ISR may update concurrently; counts only grow
+        if (entry.count == 0) continue;
+
+        if (found == max_samples && entry.count <= out[found - 1].count) continue;
+
+        size_t pos = (found < max_samples) ? found++ : found - 1;
+        while (pos > 0 && out[pos - 1].count < entry.count) {
+            out[pos] = out[pos - 1];
+            pos--;
+        }
+        out[pos] = entry;
+    }
+    return found;
+}
+
+void PCSampler::printReport() {
+    uint32_t total = s_total;
+    if (total == 0) {
+        Serial.println("[PCSampler] No samples yet");
+        return;
+    }
+
+    Serial.println("\n=== PC Sampler ===");
+    Serial.printf("Core %d, %lu samples (dropped=%lu, pre-scheduler=%lu)\n",
+                  s_core, (unsigned long)total,
+                  (unsigned long)s_dropped, (unsigned long)s_no_task);
+
+    static const char* region_names[] = {"IRAM", "FLASH", "ROM", "OTHER"};
+    for (size_t i = 0; i < static_cast<size_t>(Region::COUNT); i++) {
+        uint32_t count = s_region_counts[i];
+        Serial.printf("  %-5s %6lu (%lu.%lu%%)\n", region_names[i], (unsigned long)count,
+                      (unsigned long)(count * 100 / total),
+                      (unsigned long)((count * 1000 / total) % 10));
+    }
+
+    Sample top[REPORT_TOP];
+    size_t count = getTopSamples(top, REPORT_TOP);
+    for (size_t i = 0; i < count; i++) {
+        Serial.printf("PCPROF 0x%08lX %lu %s\n", (unsigned long)top[i].pc,
+                      (unsigned long)top[i].count,
+                      region_names[static_cast<size_t>(classifyPC(top[i].pc))]);
+    }
+    Serial.println("==================");
+}
+
+#else  // !PC_SAMPLING
+
+// Profiling compiled out
+
+bool PCSampler::begin(uint32_t) { return false; }
+void PCSampler::stop() {}
+void PCSampler::reset() {}
+uint32_t PCSampler::getTotalSamples() { return 0; }
+uint32_t PCSampler::getRegionSamples(Region) { return 0; }
+size_t PCSampler::getTopSamples(Sample*, size_t) { return 0; }
+PCSampler::Region PCSampler::classify(uint32_t) { return Region::OTHER; }
+void PCSampler::printReport() {}
+
+#endif  // PC_SAMPLING
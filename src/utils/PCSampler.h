@@ -0,0 +1,81 @@
+#ifndef PC_SAMPLER_H
+#define PC_SAMPLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef PC_SAMPLING
+#define PC_SAMPLING 0
+#endif
+
+/**
+ * Statistical PC sampler (profiling build only)
+ *
+ * A hardware timer interrupt fires at a fixed rate on the core that called
+ * begin() and records the program counter of the code it interrupted. The
+ * histogram shows where that core spends its time; functions that are hot
+ * AND execute from flash are the candidates for IRAM placement
+ * (see Placement.h), because every cache miss on them competes with PSRAM
+ * canvas traffic.
+ *
+ * How the interrupted PC is found: on entry to a level-1 interrupt the
+ * FreeRTOS port saves the interrupted task's context (XtExcFrame) on its
+ * stack and stores that stack pointer in pxCurrentTCB->pxTopOfStack (the
+ * first TCB field). The ISR reads frame->pc from there.
+ *
+ * Limitations:
+ * - Code running with interrupts masked (critical sections, other ISRs)
+ *   is never sampled; samples land right after it instead
+ * - One core per sampler (UI core 0 is the interesting one)
+ *
+ * Memory regions (ESP32):
+ * - IRAM:  0x40080000 - 0x400A0000 (no cache)
+ * - Flash: 0x400D0000 - 0x40400000 (through cache)
+ * - ROM:   0x40000000 - 0x40070000
+ *
+ * Output: printReport() prints "PCPROF 0x<pc> <count>" lines; resolve with
+ *   python tools/pc_profile.py monitor.log .pio/build/<env>/firmware.elf
+ *
+ * Build: env:m5stack-core2-profile (PC_SAMPLING=1).
+ */
+class PCSampler {
+public:
+    static constexpr size_t TABLE_SIZE = 1024;     // Distinct PCs (power of two)
+    static constexpr size_t REPORT_TOP = 48;       // PCs printed per report
+    static constexpr uint32_t DEFAULT_HZ = 1000;   // Not a multiple of the 30 FPS frame rate
+
+    enum class Region : uint8_t {
+        IRAM,
+        FLASH,
+        ROM,
+        OTHER,
+        COUNT
+    };
+
+    struct Sample {
+        uint32_t pc;
+        uint32_t count;
+    };
+
+    /**
+     * Start sampling the calling core
+     * @param hz Sample rate (100-10000)
+     * @return true if timer started
+     */
+    static bool begin(uint32_t hz = DEFAULT_HZ);
+
+    static void stop();
+    static void reset();
+
+    static uint32_t getTotalSamples();
+    static uint32_t getRegionSamples(Region region);
+    static size_t getTopSamples(Sample* out, size_t max_samples);
+    static Region classify(uint32_t pc);
+
+    /**
+     * Print region split and top PCs (PCPROF lines)
+     */
+    static void printReport();
+};
+
+#endif // PC_SAMPLER_H
@@ -0,0 +1,42 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+/**
+ * Code/data placement annotations for hot paths
+ *
+ * By default all code executes from flash through the 32KB cache, which it
+ * shares with PSRAM accesses from the 150KB canvas. Functions that run every
+ * frame and showed up in PC sampling (env:m5stack-core2-profile) can be
+ * moved to internal IRAM so they never miss in the cache:
+ *
+ *   HOT_IRAM  - function body placed in IRAM (IRAM_ATTR)
+ *   HOT_DRAM  - constant table placed in internal DRAM (DRAM_ATTR)
+ *
+ * Rules for the hot set:
+ * - Keep it small: IRAM is ~128KB total, shared with WiFi/BT and ISRs
+ * - Only annotate functions proven hot by sampling, re-measure with
+ *   PlacementBench after adding one
+ * - Functions are NOT made ISR/cache-disabled safe by this: they may still
+ *   call flash code (Serial, FastLED, std::function)
+ *
+ * Off by default: IRAM is scarce and no PlacementBench / PC sampling
+ * numbers have been recorded yet that show a win on the device. Enable with
+ * -DHOT_PATH_IN_IRAM=1 (env:m5stack-core2-profile-iram) to compare against
+ * env:m5stack-core2-profile, and record the numbers before turning it on for
+ * production builds. Compiles to nothing on host builds.
+ */
+
+#ifndef HOT_PATH_IN_IRAM
+#define HOT_PATH_IN_IRAM 0
+#endif
+
+#if HOT_PATH_IN_IRAM && !defined(NATIVE_BUILD)
+#include <esp_attr.h>
+#define HOT_IRAM IRAM_ATTR
+#define HOT_DRAM DRAM_ATTR
+#else
+#define HOT_IRAM
+#define HOT_DRAM
+#endif
+
+#endif // PLACEMENT_H
@@ -0,0 +1,145 @@
+#include "PlacementBench.h"
+
+#if PLACEMENT_BENCH && !defined(NATIVE_BUILD)
+
+#include <Arduino.h>
+#include <algorithm>
+#include "Placement.h"
+#include "../ui/Renderer.h"
+#include "../ui/TouchEventManager.h"
+#include "../ui/widgets/Widget.h"
+#include "../core/PomodoroSequence.h"
+#include "../core/TimerStateMachine.h"
+#include "../hardware/ILEDController.h"
+
+namespace {
+
+constexpr size_t EVICT_BYTES = 64 * 1024;  // 2× the flash/PSRAM cache
+uint8_t* s_evict_buffer = nullptr;
+
+// Stream PSRAM through the cache so code and data fetched from flash are evicted
+void evictCache() {
+    if (!s_evict_buffer) return;
+
+    volatile uint32_t sink = 0;
+    for (size_t i = 0; i < EVICT_BYTES; i += 32) {  // One read per cache line
+        sink += s_evict_buffer[i];
+    }
+    (void)sink;
+}
+
+template <typename Op>
+PlacementBench::Result measure(const char* name, Op op) {
+    static uint32_t cold[PlacementBench::ITERATIONS];
+    static uint32_t warm[PlacementBench::ITERATIONS];
+
+    for (uint16_t i = 0; i < PlacementBench::ITERATIONS; i++) {
+        evictCache();
+        uint32_t start = ESP.getCycleCount();
+        op(i);
+        cold[i] = ESP.getCycleCount() - start;
+    }
+
+    op(0);  // Warm up
+    for (uint16_t i = 0; i < PlacementBench::ITERATIONS; i++) {
+        uint32_t start = ESP.getCycleCount();
+        op(i);
+        warm[i] = ESP.getCycleCount() - start;
+    }
+
+    std::sort(cold, cold + PlacementBench::ITERATIONS);
+    std::sort(warm, warm + PlacementBench::ITERATIONS);
+
+    return {name,
+            cold[0], cold[PlacementBench::ITERATIONS / 2],
+            warm[0], warm[PlacementBench::ITERATIONS / 2]};
+}
+
+// Minimal widget for touch dispatch (bounds hit test only)
+class BenchWidget : public Widget {
+public:
+    void draw(Renderer& renderer) override { (void)renderer; }
+};
+
+// Deterministic pseudo-random rects (same sequence in every build)
+uint32_t s_seed = 12345;
+int16_t nextRand(int16_t range) {
+    s_seed = s_seed * 1103515245u + 12345u;
+    return static_cast<int16_t>((s_seed >> 16) % range);
+}
+
+}  // namespace
+
+void PlacementBench::run(Renderer& renderer, ILEDController* leds) {
+    s_evict_buffer = static_cast<uint8_t*>(ps_malloc(EVICT_BYTES));
+    if (!s_evict_buffer) {
+        Serial.println("[PlacementBench] WARNING: No PSRAM, cold results invalid");
+    }
+
+    Result results[4];
+    size_t count = 0;
+
+    // Renderer dirty rect merge/clip
+    results[count++] = measure("dirty_rects", [&](uint16_t) {
+        for (uint8_t r = 0; r < 8; r++) {
+            renderer.markDirty(nextRand(300), nextRand(220), 10 + nextRand(60), 10 + nextRand(40));
+        }
+        renderer.clearDirty();
+    });
+
+    // Timer tick on an active session (own instances, no callbacks)
+    {
+        PomodoroSequence sequence;
+        TimerStateMachine timer(sequence);
+        timer.handleEvent(TimerStateMachine::Event::START);
+        results[count++] = measure("timer_update", [&](uint16_t) {
+            timer.update(1);
+        });
+    }
+
+    // Touch dispatch across a full screen of widgets (worst case: miss all but last)
+    {
+        BenchWidget widgets[12];
+        TouchEventManager touch;
+        for (uint8_t i = 0; i < 12; i++) {
+            widgets[i].setBounds((i % 4) * 80, (i / 4) * 70, 70, 60);
+            touch.addWidget(&widgets[i]);
+        }
+        results[count++] = measure("touch_dispatch", [&](uint16_t) {
+            touch.handleTouch(5, 5, true);    // Bottom widget (reverse iteration)
+            touch.handleTouch(5, 5, false);
+        });
+    }
+
+    // LED brightness math (no show(), no RMT traffic)
+    if (leds) {
+        results[count++] = measure("led_setall", [&](uint16_t i) {
+            leds->setAll({static_cast<uint8_t>(i), 128, 255});
+        });
+        leds->clear();
+    }
+
+    renderer.markFullScreenDirty();
+
+    Serial.printf("\n=== Placement Bench (HOT_PATH_IN_IRAM=%d, %u iterations) ===\n",
+                  HOT_PATH_IN_IRAM, ITERATIONS);
+    Serial.printf("%-16s %10s %10s %10s %10s\n", "Case", "cold_min", "cold_med", "warm_min", "warm_med");
+    for (size_t i = 0; i < count; i++) {
+        Serial.printf("%-16s %10lu %10lu %10lu %10lu\n", results[i].name,
+                      (unsigned long)results[i].cold_min, (unsigned long)results[i].cold_median,
+                      (unsigned long)results[i].warm_min, (unsigned long)results[i].warm_median);
+    }
+    Serial.println("(cycles @ 240MHz)");
+
+    free(s_evict_buffer);
+    s_evict_buffer = nullptr;
+}
+
+#else  // !PLACEMENT_BENCH
+
+void PlacementBench::run(Renderer& renderer, ILEDController* leds) {
+    (void)renderer;
+    (void)leds;
+}
+
+#endif  // PLACEMENT_BENCH
@@ -0,0 +1,46 @@
+#ifndef PLACEMENT_BENCH_H
+#define PLACEMENT_BENCH_H
+
+#include <stdint.h>
+
+#ifndef PLACEMENT_BENCH
+#define PLACEMENT_BENCH 0
+#endif
+
+class Renderer;
+class ILEDController;
+
+/**
+ * Cycle-count benchmarks for the hot paths annotated in Placement.h
+ *
+ * Each case is timed with the CPU cycle counter (CCOUNT) in two modes:
+ * - cold: the cache is thrashed first by streaming 64KB of PSRAM, which is
+ *         what the canvas push does to flash-resident code every frame
+ * - warm: back-to-back repetitions, code and data already cached
+ *
+ * Cases:
+ * - dirty_rects:    Renderer::markDirty() × 8 random rects + clearDirty()
+ * - timer_update:   TimerStateMachine::update() on an active session
+ * - touch_dispatch: TouchEventManager::handleTouch() over 12 widgets
+ * - led_setall:     ILEDController::setAll() (brightness math, no show())
+ *
+ * Compare env:m5stack-core2-profile-iram (HOT_PATH_IN_IRAM=1) against
+ * env:m5stack-core2-profile (HOT_PATH_IN_IRAM=0). Call run() from
+ * setup() before the tasks start; it leaves the renderer fully dirty.
+ */
+class PlacementBench {
+public:
+    static constexpr uint16_t ITERATIONS = 200;
+
+    struct Result {
+        const char* name;
+        uint32_t cold_min;
+        uint32_t cold_median;
+        uint32_t warm_min;
+        uint32_t warm_median;
+    };
+
+    static void run(Renderer& renderer, ILEDController* leds);
+};
+
+#endif // PLACEMENT_BENCH_H
@@ -0,0 +1,330 @@
+#include "StackProfiler.h"
+#include "MutexGuard.h"
+#include <Arduino.h>
+#include <string.h>
+
+#ifndef NATIVE_BUILD
+#include "NvsPreferences.h"
+#endif
+
+// ============================================================================
+// State
+// ============================================================================
+
+static SemaphoreHandle_t s_mutex = NULL;
+static StackProfiler::TaskRecord s_records[StackProfiler::MAX_TASKS];
+static size_t s_record_count = 0;
+static char s_scenario[StackProfiler::NAME_LEN] = "boot";
+static bool s_dirty = false;  // Worst case increased since last save
+
+#ifndef NATIVE_BUILD
+static const char* PREFS_NAMESPACE = "stackprof";
+#endif
+
+static void copyName(char* dest, const char* src) {
+    strncpy(dest, src ? src : "", StackProfiler::NAME_LEN - 1);
+    dest[StackProfiler::NAME_LEN - 1] = '\0';
+}
+
+// ============================================================================
+// Setup / Registration
+// ============================================================================
+
+bool StackProfiler::begin() {
+    if (s_mutex != NULL) {
+        return true;  // Already initialized
+    }
+
+    s_mutex = xSemaphoreCreateMutex();
+    if (s_mutex == NULL) {
+        Serial.println("[StackProfiler] ERROR: Failed to create mutex");
+        return false;
+    }
+
+    Serial.println("[StackProfiler] ✓ Initialized");
+    return true;
+}
+
+BaseType_t StackProfiler::createTaskPinnedToCore(TaskFunction_t function, const char* name,
+                                                 uint32_t stack_size, void* param,
+                                                 UBaseType_t priority, TaskHandle_t* handle,
+                                                 BaseType_t core) {
+    // Record first: the task may run to onTaskExit() before the create call
+    // returns, and finds its record by name
+    bool tracked = registerTask(NULL, name, stack_size);
+
+    // Need the handle for sampling even if the caller doesn't
+    TaskHandle_t created = NULL;
+    BaseType_t result = xTaskCreatePinnedToCore(function, name, stack_size, param,
+                                                priority, &created, core);
+    if (result != pdPASS) {
+        return result;
+    }
+
+    if (handle) {
+        *handle = created;
+    }
+
+    if (tracked) {
+        MutexGuard guard(s_mutex, "stackprof_mutex", 100);
+        TaskRecord* record = guard.isLocked() ? findRecord(name) : nullptr;
+        if (record && !record->exited) {
+            record->handle = created;  // Not once exited: the handle may be freed
+        }
+    }
+    return result;
+}
+
+bool StackProfiler::registerTask(TaskHandle_t handle, const char* name, uint32_t stack_size) {
+    if (!begin()) {
+        return false;
+    }
+
+    MutexGuard guard(s_mutex, "stackprof_mutex", 100);
+    if (!guard.isLocked()) {
+        return false;
+    }
+
+    // Re-registration of a known name (task recreated) keeps its worst case
+    TaskRecord* record = findRecord(name);
+    if (!record) {
+        if (s_record_count >= MAX_TASKS) {
+            Serial.printf("[StackProfiler] WARNING: Table full, %s not tracked\n", name);
+            return false;
+        }
+        record = &s_records[s_record_count++];
+        memset(record, 0, sizeof(TaskRecord));
+        copyName(record->name, name);
+        loadPersisted(*record);
+    }
+
+    record->handle = handle;
+    record->stack_size = stack_size;
+    record->exited = false;
+    return true;
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+void StackProfiler::sampleRecord(TaskRecord& record) {
+    if (record.handle == NULL) {
+        return;  // Task exited, worst case is final
+    }
+
+    uint32_t free_bytes = uxTaskGetStackHighWaterMark(record.handle);
+    uint32_t used = (free_bytes < record.stack_size) ? record.stack_size - free_bytes : 0;
+    record.samples++;
+
+    if (used > record.worst_used) {
+        record.worst_used = used;
+        copyName(record.worst_scenario, s_scenario);
+        s_dirty = true;
+    }
+}
+
+void StackProfiler::sampleAll() {
+    if (s_mutex == NULL) return;
+
+    MutexGuard guard(s_mutex, "stackprof_mutex", 100);
+    if (!guard.isLocked()) return;
+
+    for (size_t i = 0; i < s_record_count; i++) {
+        sampleRecord(s_records[i]);
+    }
+}
+
+void StackProfiler::onTaskExit() {
+    if (s_mutex == NULL) return;
+
+    MutexGuard guard(s_mutex, "stackprof_mutex", 100);
+    if (!guard.isLocked()) return;
+
+    // By name: the creator may not have stored the handle yet
+    TaskRecord* record = findRecord(pcTaskGetName(NULL));
+    if (record) {
+        record->handle = xTaskGetCurrentTaskHandle();
+        sampleRecord(*record);
+        record->handle = NULL;  // Never touch the handle again
+        record->exited = true;
+    }
+}
+
+void StackProfiler::setScenario(const char* scenario) {
+    if (s_mutex == NULL) {
+        copyName(s_scenario, scenario);
+        return;
+    }
+
+    MutexGuard guard(s_mutex, "stackprof_mutex", 100);
+    copyName(s_scenario, scenario);
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+StackProfiler::TaskRecord* StackProfiler::findRecord(const char* name) {
+    for (size_t i = 0; i < s_record_count; i++) {
+        if (strncmp(s_records[i].name, name, NAME_LEN - 1) == 0) {
+            return &s_records[i];
+        }
+    }
+    return nullptr;
+}
+
+bool StackProfiler::getRecord(const char* name, TaskRecord& out) {
+    if (s_mutex == NULL) return false;
+
+    MutexGuard guard(s_mutex, "stackprof_mutex", 100);
+    if (!guard.isLocked()) return false;
+
+    TaskRecord* record = findRecord(name);
+    if (!record) return false;
+
+    out = *record;
+    return true;
+}
+
+bool StackProfiler::getRecordAt(size_t index, TaskRecord& out) {
+    if (s_mutex == NULL) return false;
+
+    MutexGuard guard(s_mutex, "stackprof_mutex", 100);
+    if (!guard.isLocked() || index >= s_record_count) return false;
+
+    out = s_records[index];
+    return true;
+}
+
+size_t StackProfiler::getRecordCount() {
+    return s_record_count;
+}
+
+uint32_t StackProfiler::recommendedSize(const TaskRecord& record) {
+    uint32_t margin = record.worst_used * MARGIN_PERCENT / 100;
+    if (margin < MIN_HEADROOM) {
+        margin = MIN_HEADROOM;
+    }
+
+    uint32_t size = record.worst_used + margin;
+    return (size + SIZE_GRANULARITY - 1) / SIZE_GRANULARITY * SIZE_GRANULARITY;
+}
+
+// ============================================================================
+// Persistence (NVS)
+// ============================================================================
+
+void StackProfiler::loadPersisted(TaskRecord& record) {
+#ifndef NATIVE_BUILD
+    NvsPreferences prefs;
+    if (prefs.begin(PREFS_NAMESPACE, true)) {  // Read-only
+        record.worst_used = prefs.getUInt(record.name, 0);
+        if (record.worst_used > 0) {
+            copyName(record.worst_scenario, "persisted");
+        }
+        prefs.end();
+    }
+#else
+    (void)record;
+#endif
+}
+
+void StackProfiler::saveIfChanged() {
+    if (s_mutex == NULL || !s_dirty) return;
+
+    // Snapshot under lock, write NVS outside it
+    TaskRecord snapshot[MAX_TASKS];
+    size_t count;
+    {
+        MutexGuard guard(s_mutex, "stackprof_mutex", 100);
+        if (!guard.isLocked()) return;
+        memcpy(snapshot, s_records, sizeof(snapshot));
+        count = s_record_count;
+        s_dirty = false;
+    }
+
+#ifndef NATIVE_BUILD
+    NvsPreferences prefs;
+    if (!prefs.begin(PREFS_NAMESPACE, false)) {
+        Serial.println("[StackProfiler] ERROR: Failed to open NVS namespace");
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        // Only ever grows: one NVS write per task per new worst case
+        if (snapshot[i].worst_used > prefs.getUInt(snapshot[i].name, 0)) {
+            prefs.putUInt(snapshot[i].name, snapshot[i].worst_used);
+        }
+    }
+    prefs.end();
+#else
+    (void)count;
+#endif
+}
+
+void StackProfiler::reset(bool clear_persisted) {
+    if (s_mutex != NULL) {
+        MutexGuard guard(s_mutex, "stackprof_mutex", 100);
+        memset(s_records, 0, sizeof(s_records));
+        s_record_count = 0;
+        s_dirty = false;
+        copyName(s_scenario, "boot");
+    }
+
+#ifndef NATIVE_BUILD
+    if (clear_persisted) {
+        NvsPreferences prefs;
+        if (prefs.begin(PREFS_NAMESPACE, false)) {
+            prefs.clear();
+            prefs.end();
+        }
+    }
+#else
+    (void)clear_persisted;
+#endif
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+void StackProfiler::printReport() {
+    if (s_mutex == NULL) return;
+
+    TaskRecord snapshot[MAX_TASKS];
+    size_t count;
+    {
+        MutexGuard guard(s_mutex, "stackprof_mutex", 100);
+        if (!guard.isLocked()) return;
+        memcpy(snapshot, s_records, sizeof(snapshot));
+        count = s_record_count;
+    }
+
+    Serial.println("\n=== Stack Profiler ===");
+    Serial.printf("%-15s %7s %7s %7s %7s  %s\n", "Task", "Size", "Worst", "Rec.", "Delta", "Worst in");
+
+    int32_t total_delta = 0;
+    for (size_t i = 0; i < count; i++) {
+        const TaskRecord& r = snapshot[i];
+        uint32_t rec = recommendedSize(r);
+        int32_t delta = (int32_t)r.stack_size - (int32_t)rec;  // >0: reclaimable, <0: undersized
+        total_delta += delta;
+
+        Serial.printf("%-15s %7lu %7lu %7lu %+7ld  %s%s\n",
+                      r.name,
+                      (unsigned long)r.stack_size,
+                      (unsigned long)r.worst_used,
+                      (unsigned long)rec,
+                      (long)delta,
+                      r.worst_scenario[0] ? r.worst_scenario : "-",
+                      r.exited ? " (exited)" : "");
+
+        if (delta < 0) {
+            Serial.printf("  WARNING: %s needs %ld more bytes of stack\n", r.name, (long)-delta);
+        }
+    }
+
+    Serial.printf("Reclaimable internal RAM at recommended sizes: %ld bytes\n", (long)total_delta);
+    Serial.println("======================");
+}
@@ -0,0 +1,128 @@
+#ifndef STACK_PROFILER_H
+#define STACK_PROFILER_H
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <stdint.h>
+
+/**
+ * Stack usage profiler for FreeRTOS tasks
+ *
+ * Replaces guessed stack sizes with measured ones. Every task is created
+ * through StackProfiler::createTaskPinnedToCore() (same signature as
+ * xTaskCreatePinnedToCore), which registers its configured size. The kernel
+ * paints new stacks with 0xA5, so the deepest point a task ever reached can
+ * be read back at any time via the high-water mark.
+ *
+ * Features:
+ * - Per-task worst case (bytes used) across all samples
+ * - Scenario labels: which scenario produced the worst case
+ *   (e.g. "boot", "ntp_sync", "settings_ui", "host_replay")
+ * - Self-deleting tasks sample themselves on exit (onTaskExit)
+ * - Worst cases persisted in NVS ("stackprof") so they accumulate
+ *   across reboots and usage sessions
+ * - Recommended size = used + 25% (min 1KB headroom), rounded to 512B
+ *
+ * Units: ESP-IDF stack depth and high-water marks are in BYTES
+ * (StackType_t is uint8_t), unlike vanilla FreeRTOS words.
+ *
+ * Host replay (env:native): the FreeRTOS shim in test/native runs tasks on
+ * pthreads with painted stacks, so the same profiler measures host runs.
+ * Host frames differ from Xtensa - use host numbers to compare scenarios,
+ * size the device from device numbers.
+ *
+ * Usage:
+ *   StackProfiler::begin();
+ *   StackProfiler::createTaskPinnedToCore(uiTask, "ui_task", 8192, NULL, 1, &handle, 0);
+ *   ...
+ *   StackProfiler::sampleAll();    // Periodically (task monitor)
+ *   StackProfiler::printReport();  // Sizes, worst case, recommendation
+ */
+class StackProfiler {
+public:
+    static constexpr size_t MAX_TASKS = 8;
+    static constexpr size_t NAME_LEN = 16;
+    static constexpr uint32_t MARGIN_PERCENT = 25;      // Headroom over measured worst case
+    static constexpr uint32_t MIN_HEADROOM = 1024;      // ISR/exception frames, printf worst case
+    static constexpr uint32_t SIZE_GRANULARITY = 512;   // Round recommendations up to this
+
+    struct TaskRecord {
+        char name[NAME_LEN];
+        TaskHandle_t handle;         // NULL until created and once exited
+        uint32_t stack_size;         // Configured size (bytes)
+        uint32_t worst_used;         // Deepest usage seen (bytes)
+        uint32_t samples;            // Number of samples taken
+        char worst_scenario[NAME_LEN];  // Scenario active when worst_used was seen
+        bool exited;                 // Sampled by onTaskExit(), worst case is final
+    };
+
+    /**
+     * Create profiler mutex
+     * Call once before creating tasks (persisted worst cases load on registration).
+     */
+    static bool begin();
+
+    /**
+     * Create a task and register it for profiling
+     * Same parameters and result as xTaskCreatePinnedToCore().
+     * The record is created before the task starts, so a task that exits
+     * right away is still sampled.
+     */
+    static BaseType_t createTaskPinnedToCore(TaskFunction_t function, const char* name,
+                                             uint32_t stack_size, void* param,
+                                             UBaseType_t priority, TaskHandle_t* handle,
+                                             BaseType_t core);
+
+    /**
+     * Register an existing task (e.g. Arduino loopTask)
+     */
+    static bool registerTask(TaskHandle_t handle, const char* name, uint32_t stack_size);
+
+    /**
+     * Sample all live tasks, update worst cases
+     */
+    static void sampleAll();
+
+    /**
+     * Sample the calling task and mark it as exited
+     * Call right before vTaskDelete(NULL) in self-deleting tasks. The record
+     * is found by task name (pcTaskGetName).
+     */
+    static void onTaskExit();
+
+    /**
+     * Label subsequent samples (max 15 chars, copied)
+     */
+    static void setScenario(const char* scenario);
+
+    // Queries
+    static bool getRecord(const char* name, TaskRecord& out);
+    static bool getRecordAt(size_t index, TaskRecord& out);   // 0..getRecordCount()-1
+    static size_t getRecordCount();
+    static uint32_t recommendedSize(const TaskRecord& record);
+
+    /**
+     * Persist worst cases to NVS (only if any increased since last save)
+     * No-op on host builds.
+     */
+    static void saveIfChanged();
+
+    /**
+     * Print per-task table with recommended sizes
+     */
+    static void printReport();
+
+    /**
+     * Forget all tasks and worst cases (tests, or after resizing stacks)
+     * @param clear_persisted Also erase the NVS namespace
+     */
+    static void reset(bool clear_persisted = false);
+
+private:
+    static TaskRecord* findRecord(const char* name);
+    static void sampleRecord(TaskRecord& record);
+    static void loadPersisted(TaskRecord& record);
+};
+
+#endif // STACK_PROFILER_H
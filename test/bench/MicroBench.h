@@ -0,0 +1,237 @@
+#ifndef MICRO_BENCH_H
+#define MICRO_BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "../../src/utils/AllocTracker.h"
+
+/**
+ * Microbenchmark harness with a tracked baseline file (host only)
+ *
+ * A case calls its body in rounds of about ROUND_NS, sized from a warm-up
+ * of `ops` calls, and keeps the fastest of ROUNDS rounds. Time is the CPU
+ * time of the calling thread (CLOCK_THREAD_CPUTIME_ID), so time spent
+ * descheduled on a busy host does not count; short rounds and the minimum
+ * drop the remaining interference (interrupts, cache eviction). Heap
+ * allocations per op are counted with AllocTracker in an untimed round.
+ *
+ * Machine speed: right before each case a fixed reference workload (LCG +
+ * table updates, no project code) is timed the same way. On a VM, host
+ * contention slows everything alike and shows up as time of the guest
+ * thread, so the limit is scaled by reference now / reference at baseline
+ * (never below 1).
+ *
+ * Baseline: plain text, one case per line
+ * ("name ns_per_op allocs_per_op reference_ns"), '#' comments. check()
+ * fails a case when
+ * - allocations per op differ from the baseline (deterministic, exact), or
+ * - time per op exceeds baseline × machine scale × tolerance + SLACK_NS
+ * Cases missing from the baseline fail too, so new cases get recorded.
+ * expect() runs and checks in one go and re-times a case that came out
+ * SLOWER up to RETRIES times (best result counts) before failing it; when
+ * recording it always takes the best of RETRIES + 1 runs.
+ *
+ * Timings are only comparable on the machine and compiler that wrote the
+ * baseline. Environment:
+ * - MICROBENCH_UPDATE=1    rewrite the baseline with the current results
+ * - MICROBENCH_TOLERANCE=x allowed slowdown factor (default 2.0)
+ *
+ * Usage:
+ *   MicroBench bench("test/bench/baseline.txt");
+ *   EXPECT_TRUE(bench.expect("rect.merge", 10000, [&](uint32_t i) { a.merge(rects[i & 63]); }));
+ */
+class MicroBench {
+public:
+    static constexpr int ROUNDS = 30;
+    static constexpr double ROUND_NS = 200000.0;
+    static constexpr int RETRIES = 2;
+    static constexpr double DEFAULT_TOLERANCE = 2.0;
+    static constexpr double SLACK_NS = 2.0;   // Absorbs timer granularity on sub-10 ns cases
+
+    struct Result {
+        std::string name;
+        double ns_per_op;
+        double allocs_per_op;
+        double reference_ns;    // Reference workload, timed just before
+    };
+
+    explicit MicroBench(const char* baseline_path)
+        : path_(baseline_path), tolerance_(DEFAULT_TOLERANCE), update_(false) {
+        const char* update = getenv("MICROBENCH_UPDATE");
+        update_ = update && update[0] == '1';
+        const char* tolerance = getenv("MICROBENCH_TOLERANCE");
+        if (tolerance && atof(tolerance) >= 1.0) {
+            tolerance_ = atof(tolerance);
+        }
+        load();
+    }
+
+    // Keep a value alive so the optimizer cannot drop the work producing it
+    template <typename T>
+    static void keep(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    template <typename Body>
+    Result run(const char* name, uint32_t ops, Body&& body) {
+        double reference = bestNsPerOp(1000, [](uint32_t i) { keep(referenceWork(i)); });
+        double ns = bestNsPerOp(ops, body);
+
+        AllocTracker::reset();
+        for (uint32_t n = 0; n < ops; n++) body(n);
+        uint32_t allocs = AllocTracker::getTotals().alloc_count;
+
+        return {name, ns, static_cast<double>(allocs) / ops, reference};
+    }
+
+    // run() + check(), re-timing a case that failed on time (always when recording)
+    template <typename Body>
+    bool expect(const char* name, uint32_t ops, Body&& body) {
+        Result result = run(name, ops, body);
+        const Result* base = find(result.name);
+        for (int retry = 0; retry < RETRIES && (update_ || (base && !withinTime(result, *base))); retry++) {
+            Result again = run(name, ops, body);
+            if (again.ns_per_op < result.ns_per_op) result = again;
+        }
+        return check(result);
+    }
+
+    /**
+     * Compare against the baseline (or record it with MICROBENCH_UPDATE=1)
+     * @return false on a regression or a case missing from the baseline
+     */
+    bool check(const Result& result) {
+        const Result* base = find(result.name);
+
+        if (update_) {
+            if (base) {
+                *const_cast<Result*>(base) = result;
+            } else {
+                entries_.push_back(result);
+            }
+            printf("  [MicroBench] %-28s %9.1f ns/op %6.2f allocs/op (recorded)\n",
+                   result.name.c_str(), result.ns_per_op, result.allocs_per_op);
+            return save();
+        }
+
+        if (!base) {
+            printf("  [MicroBench] %-28s %9.1f ns/op %6.2f allocs/op - not in %s (run with MICROBENCH_UPDATE=1)\n",
+                   result.name.c_str(), result.ns_per_op, result.allocs_per_op, path_.c_str());
+            return false;
+        }
+
+        double scale = machineScale(result, *base);
+        bool time_ok = withinTime(result, *base);
+        bool allocs_ok = result.allocs_per_op < base->allocs_per_op + 0.005 &&
+                         result.allocs_per_op > base->allocs_per_op - 0.005;
+        printf("  [MicroBench] %-28s %9.1f ns/op (baseline %.1f, %.2fx, machine %.2fx) %6.2f allocs/op%s%s\n",
+               result.name.c_str(), result.ns_per_op, base->ns_per_op,
+               base->ns_per_op > 0.0 ? result.ns_per_op / base->ns_per_op : 0.0, scale,
+               result.allocs_per_op,
+               time_ok ? "" : "  SLOWER",
+               allocs_ok ? "" : "  ALLOCS CHANGED");
+        return time_ok && allocs_ok;
+    }
+
+    double getTolerance() const { return tolerance_; }
+    bool isUpdating() const { return update_; }
+
+private:
+    std::string path_;
+    double tolerance_;
+    bool update_;
+    std::vector<Result> entries_;
+
+    static double machineScale(const Result& result, const Result& base) {
+        double scale = base.reference_ns > 0.0 ? result.reference_ns / base.reference_ns : 1.0;
+        return scale < 1.0 ? 1.0 : scale;
+    }
+
+    bool withinTime(const Result& result, const Result& base) const {
+        return result.ns_per_op <= base.ns_per_op * machineScale(result, base) * tolerance_ + SLACK_NS;
+    }
+
+    // Fixed CPU + L1 workload (~1 µs), independent of the code under test
+    static uint32_t referenceWork(uint32_t seed) {
+        static uint32_t table[256];
+        uint32_t x = seed | 1;
+        for (int n = 0; n < 512; n++) {
+            x = x * 1103515245u + 12345u;
+            table[(x >> 8) & 255] += x >> 24;
+        }
+        return x ^ table[seed & 255];
+    }
+
+    // Warm-up of `ops` calls sizes the rounds to ~ROUND_NS, fastest round wins
+    template <typename Body>
+    static double bestNsPerOp(uint32_t ops, Body&& body) {
+        double start = threadNs();
+        for (uint32_t i = 0; i < ops; i++) body(i);
+        double warmup_ns = threadNs() - start;
+        uint32_t batch = ops;
+        if (warmup_ns > 0.0) {
+            double fit = ops * ROUND_NS / warmup_ns;
+            batch = fit < 1.0 ? 1 : (fit > ops ? ops : static_cast<uint32_t>(fit));
+        }
+
+        double best = 0.0;
+        uint32_t i = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            start = threadNs();
+            for (uint32_t n = 0; n < batch; n++) body(i++);
+            double ns = threadNs() - start;
+            if (round == 0 || ns < best) best = ns;
+        }
+        return best / batch;
+    }
+
+    static double threadNs() {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return ts.tv_sec * 1e9 + ts.tv_nsec;
+    }
+
+    const Result* find(const std::string& name) const {
+        for (const auto& entry : entries_) {
+            if (entry.name == name) return &entry;
+        }
+        return nullptr;
+    }
+
+    void load() {
+        FILE* file = fopen(path_.c_str(), "r");
+        if (!file) return;
+        char line[160];
+        while (fgets(line, sizeof(line), file)) {
+            char name[64];
+            double ns = 0.0, allocs = 0.0, reference = 0.0;
+            if (line[0] == '#' || sscanf(line, "%63s %lf %lf %lf", name, &ns, &allocs, &reference) < 3) continue;
+            entries_.push_back({name, ns, allocs, reference});
+        }
+        fclose(file);
+    }
+
+    bool save() const {
+        FILE* file = fopen(path_.c_str(), "w");
+        if (!file) {
+            printf("  [MicroBench] ERROR: cannot write %s\n", path_.c_str());
+            return false;
+        }
+        fprintf(file, "# Microbenchmark baseline for test/test_microbench.cpp (env:native)\n");
+        fprintf(file, "# Regenerate on the reference machine: MICROBENCH_UPDATE=1\n");
+        fprintf(file, "# name ns_per_op allocs_per_op reference_ns\n");
+        for (const auto& entry : entries_) {
+            fprintf(file, "%-28s %9.2f %6.2f %9.2f\n", entry.name.c_str(), entry.ns_per_op,
+                    entry.allocs_per_op, entry.reference_ns);
+        }
+        fclose(file);
+        return true;
+    }
+};
+
+#endif // MICRO_BENCH_H
@@ -0,0 +1,147 @@
+#ifndef FAKE_SPEAKER_SINK_H
+#define FAKE_SPEAKER_SINK_H
+
+#include <Arduino.h>
+#include <algorithm>
+#include <deque>
+#include "../../src/hardware/ISpeakerSink.h"
+#include "../../src/hardware/SpeakerMonitor.h"
+
+/**
+ * Fake speaker sink: simulated I2S DMA queue on the virtual clock
+ *
+ * Models the M5.Speaker output path at 1 ms resolution:
+ * - DMA ring of pipeline_ms slots, drained by the DAC one slot per ms
+ * - Mixer refills the ring (clip data, silence when idle) after each drain;
+ *   isPlaying() while the mixer still has clip data to write
+ * - setStarved(true): the mixer stops writing (busy CPU), the ring drains
+ *   and the DAC outputs nothing once it is empty
+ *
+ * Records the ground truth the SpeakerMonitor estimates: when the first
+ * clip sample reached the DAC, and how long the DAC had no clip data in
+ * the middle of a clip. Goes through the same SpeakerMonitor as
+ * M5SpeakerSink, so AUDIO_OUTPUT / AUDIO_UNDERRUN are reported as on the
+ * device.
+ *
+ * Usage in Tests:
+ *   FakeSpeakerSink speaker(64);           // 64 ms DMA ring
+ *   AudioPlayer player(speaker);
+ *   player.play(IAudioPlayer::Sound::WARNING);
+ *   speaker.advance(10); player.update();  // Virtual time + UI loop
+ */
+class FakeSpeakerSink : public ISpeakerSink {
+public:
+    explicit FakeSpeakerSink(uint32_t pipeline_ms)
+        : pipeline_ms_(pipeline_ms), dma_(pipeline_ms, false) {}
+
+    // ========================================
+    // ISpeakerSink Interface Implementation
+    // ========================================
+
+    bool isEnabled() const override { return true; }
+
+    bool playWav(const uint8_t* wav, size_t len) override {
+        uint32_t duration_us = SpeakerMonitor::wavDurationUs(wav, len);
+        if (duration_us == 0) return false;
+        last_wav_ = wav;
+        last_wav_len_ = len;
+        startClip(duration_us / 1000);
+        monitor_.start(micros(), pipeline_ms_ * 1000, duration_us);
+        return true;
+    }
+
+    bool tone(uint16_t, uint32_t duration_ms) override {
+        startClip(duration_ms);
+        monitor_.start(micros(), pipeline_ms_ * 1000, duration_ms * 1000);
+        return true;
+    }
+
+    void stop() override {
+        clip_remaining_ms_ = 0;
+        monitor_.stop();
+    }
+
+    bool isPlaying() const override { return clip_remaining_ms_ > 0; }
+    void setVolume(uint8_t volume_255) override { volume_ = volume_255; }
+    void poll() override { monitor_.poll(micros(), isPlaying()); }
+
+    // ========================================
+    // Simulation Control
+    // ========================================
+
+    /**
+     * Advance the virtual clock (arduino_shim) ms by ms, running the DMA
+     */
+    void advance(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            arduino_shim::advanceMillis(1);
+            step();
+        }
+    }
+
+    void setStarved(bool starved) { starved_ = starved; }
+
+    // ========================================
+    // Ground Truth
+    // ========================================
+
+    bool firstSampleOut() const { return first_sample_out_; }
+    uint32_t firstSampleMs() const { return first_sample_ms_; }   // Virtual clock
+    uint32_t underrunMs() const { return underrun_ms_; }          // DAC starved mid-clip
+    uint8_t getVolume() const { return volume_; }
+    const uint8_t* lastWav() const { return last_wav_; }          // Buffer of the last playWav()
+    size_t lastWavLen() const { return last_wav_len_; }
+    const SpeakerMonitor& getMonitor() const { return monitor_; }
+
+private:
+    uint32_t pipeline_ms_;
+    std::deque<bool> dma_;            // true = clip sample, false = silence
+    uint32_t clip_remaining_ms_ = 0;  // Not yet written by the mixer
+    uint32_t clip_queued_ms_ = 0;     // Written, not yet at the DAC
+    bool starved_ = false;
+    bool first_sample_out_ = false;
+    uint32_t first_sample_ms_ = 0;
+    uint32_t underrun_ms_ = 0;
+    uint8_t volume_ = 0;
+    const uint8_t* last_wav_ = nullptr;
+    size_t last_wav_len_ = 0;
+    SpeakerMonitor monitor_;
+
+    void startClip(uint32_t duration_ms) {
+        // Replaces the current sound: its queued samples are not clip data
+        std::fill(dma_.begin(), dma_.end(), false);
+        clip_queued_ms_ = 0;
+        clip_remaining_ms_ = duration_ms;
+        first_sample_out_ = false;
+    }
+
+    void step() {
+        // DAC: one slot per ms
+        if (dma_.empty()) {
+            if (clip_remaining_ms_ > 0 || clip_queued_ms_ > 0) underrun_ms_++;
+        } else {
+            bool clip_sample = dma_.front();
+            dma_.pop_front();
+            if (clip_sample) {
+                clip_queued_ms_--;
+                if (!first_sample_out_) {
+                    first_sample_out_ = true;
+                    first_sample_ms_ = millis();
+                }
+            }
+        }
+
+        // Mixer: refill the ring unless starved
+        if (starved_) return;
+        while (dma_.size() < pipeline_ms_) {
+            bool clip_sample = clip_remaining_ms_ > 0;
+            if (clip_sample) {
+                clip_remaining_ms_--;
+                clip_queued_ms_++;
+            }
+            dma_.push_back(clip_sample);
+        }
+    }
+};
+
+#endif // FAKE_SPEAKER_SINK_H
@@ -0,0 +1,75 @@
+#ifndef LOOPBACK_TRANSPORT_H
+#define LOOPBACK_TRANSPORT_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string.h>
+#include <string>
+#include "../../src/network/ITransport.h"
+
+/**
+ * Plain TCP transport to a local mock server (host tests)
+ *
+ * Stands in for TlsTransport: connect() ignores the API host name and
+ * port and goes to 127.0.0.1:<port> instead, so ApiClient still sends the
+ * real Host header. Reads wait in poll() (real time, not the virtual
+ * clock).
+ */
+class LoopbackTransport : public ITransport {
+public:
+    explicit LoopbackTransport(uint16_t port) : port_(port) {}
+    ~LoopbackTransport() override { stop(); }
+
+    bool connect(const char* host, uint16_t port) override {
+        (void)port;
+        stop();
+        last_host_ = host;
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port_);
+        if (::connect(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+            stop();
+            return false;
+        }
+        return true;
+    }
+
+    bool connected() override { return fd_ >= 0; }
+
+    size_t write(const uint8_t* data, size_t len) override {
+        if (fd_ < 0) return 0;
+        ssize_t n = ::send(fd_, data, len, MSG_NOSIGNAL);
+        return n < 0 ? 0 : static_cast<size_t>(n);
+    }
+
+    int read(uint8_t* data, size_t len, uint32_t timeout_ms) override {
+        if (fd_ < 0) return -1;
+        struct pollfd pfd = {fd_, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, static_cast<int>(timeout_ms));
+        if (ready == 0) return 0;
+        ssize_t n = ::recv(fd_, data, len, 0);
+        return n > 0 ? static_cast<int>(n) : -1;
+    }
+
+    void stop() override {
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    const std::string& lastHost() const { return last_host_; }
+
+private:
+    uint16_t port_;
+    int fd_ = -1;
+    std::string last_host_;
+};
+
+#endif // LOOPBACK_TRANSPORT_H
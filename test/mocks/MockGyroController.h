@@ -101,6 +101,18 @@ public:
         set_rotate_threshold_count_++;
     }
 
+    bool enableWakeOnMotion(uint16_t threshold_mg) override {
+        wake_on_motion_threshold_ = threshold_mg;
+        wake_on_motion_enabled_ = true;
+        return true;
+    }
+
+    bool wasMotionDetected() override {
+        bool result = motion_flag_;
+        motion_flag_ = false;  // Clear flag (non-const behavior)
+        return result;
+    }
+
     // ========================================
     // Test Simulation Methods
     // ========================================
@@ -142,6 +154,13 @@ public:
         last_gesture_ = Gesture::ROTATE_CCW;
     }
 
+    /**
+     * Simulate motion latched while in wake-on-motion mode
+     */
+    void simulateMotion() {
+        motion_flag_ = true;
+    }
+
     /**
      * Set accelerometer data for testing
      */
@@ -195,6 +214,12 @@ public:
      */
     float rotateThreshold() const { return rotate_threshold_; }
 
+    /**
+     * Check if enableWakeOnMotion() was called, and with which threshold
+     */
+    bool wakeOnMotionEnabled() const { return wake_on_motion_enabled_; }
+    uint16_t wakeOnMotionThreshold() const { return wake_on_motion_threshold_; }
+
     /**
      * Reset all state for next test
      */
@@ -206,6 +231,9 @@ public:
         flip_flag_ = false;
         rotate_cw_flag_ = false;
         rotate_ccw_flag_ = false;
+        motion_flag_ = false;
+        wake_on_motion_enabled_ = false;
+        wake_on_motion_threshold_ = 0;
         accel_ = {0, 0, 0};
         gyro_ = {0, 0, 0};
         flip_threshold_ = 0.7f;
@@ -236,6 +264,11 @@ private:
     mutable bool flip_flag_ = false;
     mutable bool rotate_cw_flag_ = false;
     mutable bool rotate_ccw_flag_ = false;
+    bool motion_flag_ = false;
+
+    // Wake-on-motion
+    bool wake_on_motion_enabled_ = false;
+    uint16_t wake_on_motion_threshold_ = 0;
 
     // Sensor data
     AccelData accel_ = {0, 0, 0};
@@ -0,0 +1,113 @@
+#ifndef MOCK_HAPTIC_CONTROLLER_H
+#define MOCK_HAPTIC_CONTROLLER_H
+
+#include "../../src/hardware/IHapticController.h"
+
+/**
+ * Mock Haptic Controller for Unit Testing
+ *
+ * Provides fake implementation of IHapticController for testing without hardware.
+ *
+ * Features:
+ * - Counts trigger() calls per pattern
+ * - Honors setEnabled(false) like the real controller (triggers ignored)
+ * - No actual AXP192 LDO3 / vibration motor access
+ *
+ * Usage in Tests:
+ *   MockHapticController haptic;
+ *   stateMachine.setHapticController(&haptic);
+ *   // ... run a session to completion
+ *
+ *   ASSERT_EQ(1, haptic.triggerCount(IHapticController::Pattern::TIMER_COMPLETE));
+ */
+class MockHapticController : public IHapticController {
+public:
+    static constexpr int PATTERN_COUNT = 5;
+
+    MockHapticController() = default;
+
+    // ========================================
+    // IHapticController Interface Implementation
+    // ========================================
+
+    bool begin() override {
+        begin_called_ = true;
+        return true;
+    }
+
+    void trigger(Pattern pattern) override {
+        if (!enabled_) return;
+        trigger_counts_[static_cast<int>(pattern)]++;
+        total_triggers_++;
+        last_pattern_ = pattern;
+    }
+
+    void update() override {
+        update_count_++;
+    }
+
+    void setEnabled(bool enabled) override {
+        enabled_ = enabled;
+    }
+
+    bool isEnabled() const override {
+        return enabled_;
+    }
+
+    // ========================================
+    // Test Inspection Methods
+    // ========================================
+
+    /**
+     * Check if begin() was called
+     */
+    bool beginCalled() const { return begin_called_; }
+
+    /**
+     * Get number of trigger() calls for a pattern
+     */
+    int triggerCount(Pattern pattern) const {
+        return trigger_counts_[static_cast<int>(pattern)];
+    }
+
+    /**
+     * Get number of trigger() calls across all patterns
+     */
+    int totalTriggers() const { return total_triggers_; }
+
+    /**
+     * Get last triggered pattern
+     */
+    Pattern lastPattern() const { return last_pattern_; }
+
+    /**
+     * Get number of update() calls
+     */
+    int updateCount() const { return update_count_; }
+
+    /**
+     * Reset all state for next test
+     */
+    void reset() {
+        begin_called_ = false;
+        enabled_ = true;
+        last_pattern_ = Pattern::BUTTON_PRESS;
+        for (int i = 0; i < PATTERN_COUNT; i++) {
+            trigger_counts_[i] = 0;
+        }
+        total_triggers_ = 0;
+        update_count_ = 0;
+    }
+
+private:
+    bool begin_called_ = false;
+    bool enabled_ = true;
+    Pattern last_pattern_ = Pattern::BUTTON_PRESS;
+
+    // Call counters
+    int trigger_counts_[PATTERN_COUNT] = {};
+    int total_triggers_ = 0;
+    int update_count_ = 0;
+};
+
+#endif // MOCK_HAPTIC_CONTROLLER_H
@@ -71,6 +71,11 @@ public:
         show_count_++;
     }
 
+    void powerDown() override {
+        clear();
+        power_down_count_++;
+    }
+
     void setBrightness(uint8_t percent) override {
         brightness_ = (percent > 100) ? 100 : percent;
         set_brightness_count_++;
@@ -93,6 +98,20 @@ public:
         set_progress_count_++;
     }
 
+    Pattern getPattern() const override {
+        return current_pattern_;
+    }
+
+    void setStatePattern(TimerState state) override {
+        last_state_pattern_ = state;
+        set_state_pattern_count_++;
+    }
+
+    void triggerMilestone(uint32_t duration_ms = 10000) override {
+        last_milestone_duration_ms_ = duration_ms;
+        milestone_count_++;
+    }
+
     void update() override {
         update_count_++;
     }
@@ -191,6 +210,31 @@ public:
      */
     int updateCount() const { return update_count_; }
 
+    /**
+     * Get number of powerDown() calls
+     */
+    int powerDownCount() const { return power_down_count_; }
+
+    /**
+     * Get number of setStatePattern() calls
+     */
+    int setStatePatternCount() const { return set_state_pattern_count_; }
+
+    /**
+     * Get last timer state passed to setStatePattern()
+     */
+    TimerState lastStatePattern() const { return last_state_pattern_; }
+
+    /**
+     * Get number of triggerMilestone() calls
+     */
+    int milestoneCount() const { return milestone_count_; }
+
+    /**
+     * Get duration passed to the last triggerMilestone()
+     */
+    uint32_t lastMilestoneDurationMs() const { return last_milestone_duration_ms_; }
+
     /**
      * Check if specific pattern was ever set
      */
@@ -228,6 +272,8 @@ public:
         last_pixel_color_ = Color::Black();
         progress_percent_ = 0;
         progress_color_ = Color::Green();
+        last_state_pattern_ = TimerState::IDLE;
+        last_milestone_duration_ms_ = 0;
 
         set_all_count_ = 0;
         set_pixel_count_ = 0;
@@ -237,6 +283,9 @@ public:
         set_pattern_count_ = 0;
         set_progress_count_ = 0;
         update_count_ = 0;
+        power_down_count_ = 0;
+        set_state_pattern_count_ = 0;
+        milestone_count_ = 0;
 
         pattern_history_.clear();
 
@@ -267,6 +316,8 @@ private:
     Color last_pixel_color_ = Color::Black();
     uint8_t progress_percent_ = 0;
     Color progress_color_ = Color::Green();
+    TimerState last_state_pattern_ = TimerState::IDLE;
+    uint32_t last_milestone_duration_ms_ = 0;
 
     // Call counters
     int set_all_count_ = 0;
@@ -277,6 +328,9 @@ private:
     int set_pattern_count_ = 0;
     int set_progress_count_ = 0;
     int update_count_ = 0;
+    int power_down_count_ = 0;
+    int set_state_pattern_count_ = 0;
+    int milestone_count_ = 0;
 
     // History
     std::vector<Pattern> pattern_history_;
@@ -81,6 +81,11 @@ public:
         current_sleep_mode_ = SleepMode::NONE;
     }
 
+    void setMotionPolling(bool enabled, uint8_t interval_s) override {
+        wake_on_motion_ = enabled;
+        motion_poll_interval_s_ = interval_s;
+    }
+
     float getPowerConsumption() const override {
         return power_consumption_;
     }
@@ -178,6 +183,12 @@ public:
      */
     uint32_t lastDeepSleepDuration() const { return last_deep_sleep_duration_; }
 
+    /**
+     * Check if motion polling is armed for deep sleep, and its period
+     */
+    bool wakeOnMotion() const { return wake_on_motion_; }
+    uint8_t motionPollInterval() const { return motion_poll_interval_s_; }
+
     /**
      * Get number of setBrightness() calls
      */
@@ -215,6 +226,8 @@ public:
 
         last_light_sleep_duration_ = 0;
         last_deep_sleep_duration_ = 0;
+        wake_on_motion_ = false;
+        motion_poll_interval_s_ = 0;
 
         set_brightness_count_ = 0;
         light_sleep_count_ = 0;
@@ -246,6 +259,8 @@ private:
     // Last values
     uint32_t last_light_sleep_duration_ = 0;
     uint32_t last_deep_sleep_duration_ = 0;
+    bool wake_on_motion_ = false;
+    uint8_t motion_poll_interval_s_ = 0;
 
     // Call counters
     int set_brightness_count_ = 0;
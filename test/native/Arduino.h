@@ -0,0 +1,118 @@
+#ifndef NATIVE_ARDUINO_SHIM_H
+#define NATIVE_ARDUINO_SHIM_H
+
+/**
+ * Minimal Arduino core shim for host builds (env:native)
+ *
+ * Provides just enough of the Arduino API for the hardware-independent
+ * modules (core/, utils/) to compile and run under googletest:
+ * - millis()/micros()/delay() on a virtual clock advanced by the test
+ *   (micros() has millisecond resolution)
+ * - arduino_shim::gettimeofday() on an optional virtual wall clock (NTP
+ *   time), so code keyed on the calendar day (Statistics) can be driven
+ *   through days. Not a macro over ::gettimeofday: host-built code calls it
+ *   explicitly under #ifdef NATIVE_BUILD
+ * - Serial: printf/print/println, silent unless echo is enabled
+ * - constrain/map/min/max helpers, PROGMEM (plain const data on the host)
+ * - ESP heap/PSRAM queries (fixed values), ps_malloc on the host heap
+ * - String (WString.h)
+ *
+ * Not a hardware emulator - M5Unified has its own UI-level shim (M5Unified.h).
+ */
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <atomic>
+#include "WString.h"
+
+namespace arduino_shim {
+
+// Virtual clock (ms), advanced explicitly by tests or by delay()
+inline std::atomic<uint32_t> g_millis{0};
+
+inline void setMillis(uint32_t ms) { g_millis.store(ms); }
+inline void advanceMillis(uint32_t ms) { g_millis.fetch_add(ms); }
+
+// Virtual wall clock (seconds since epoch), 0 = use the host clock
+inline std::atomic<int64_t> g_epoch_s{0};
+
+inline void setEpoch(int64_t seconds) { g_epoch_s.store(seconds); }
+inline void advanceEpoch(int64_t seconds) { g_epoch_s.fetch_add(seconds); }
+
+inline int gettimeofday(struct timeval* tv, void* tz) {
+    int64_t epoch = g_epoch_s.load();
+    if (epoch == 0) return ::gettimeofday(tv, nullptr);
+    (void)tz;
+    tv->tv_sec = static_cast<time_t>(epoch);
+    tv->tv_usec = 0;
+    return 0;
+}
+
+}  // namespace arduino_shim
+
+inline uint32_t millis() { return arduino_shim::g_millis.load(); }
+inline uint32_t micros() { return arduino_shim::g_millis.load() * 1000; }
+inline void delay(uint32_t ms) { arduino_shim::advanceMillis(ms); }
+
+using std::min;
+using std::max;
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+/**
+ * Host Serial: discards output by default so test logs stay readable.
+ * Call Serial.setEcho(true) to mirror output to stdout while debugging.
+ */
+class HostSerial {
+public:
+    void begin(unsigned long) {}
+    void setEcho(bool echo) { echo_ = echo; }
+
+    size_t printf(const char* format, ...) {
+        if (!echo_) return 0;
+        va_list args;
+        va_start(args, format);
+        int n = vprintf(format, args);
+        va_end(args);
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+
+    size_t print(const char* text) { return printf("%s", text); }
+    size_t println(const char* text = "") { return printf("%s\n", text); }
+    size_t println(int value) { return printf("%d\n", value); }
+
+private:
+    bool echo_ = false;
+};
+
+inline HostSerial Serial;
+
+// Heap/PSRAM figures for log lines (Core2: 8MB PSRAM)
+class HostEsp {
+public:
+    uint32_t getFreeHeap() const { return 200 * 1024; }
+    uint32_t getPsramSize() const { return 8 * 1024 * 1024; }
+    uint32_t getFreePsram() const { return 4 * 1024 * 1024; }
+};
+
+inline HostEsp ESP;
+
+inline bool psramFound() { return true; }
+inline void* ps_malloc(size_t size) { return malloc(size); }
+
+#endif // NATIVE_ARDUINO_SHIM_H
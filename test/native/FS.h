@@ -0,0 +1,275 @@
+#ifndef NATIVE_FS_SHIM_H
+#define NATIVE_FS_SHIM_H
+
+/**
+ * Arduino fs::FS / fs::File on a host directory (host builds)
+ *
+ * The "card" is a directory chosen by the test (fs_shim::mount()); virtual
+ * paths ("/config/lasttime.txt") map below it. Semantics follow the
+ * ESP32 VFS/FATFS behaviour the firmware relies on:
+ * - open() modes FILE_READ / FILE_WRITE (truncate) / FILE_APPEND
+ * - mkdir() creates one level only, open() does not create directories
+ * - name() is the basename, path() the full virtual path
+ *
+ * I/O accounting: every open/close/read/write call and every FAT sync is
+ * counted (fs_shim::stats()). On FATFS a sync (directory entry + FAT
+ * update) happens on flush() and on close() of a file that was written,
+ * so syncs is the number to compare between write strategies.
+ *
+ * Latency: fs_shim::setLatencyMs() makes each open() sleep for real time,
+ * standing in for a slow SPI card when testing asynchronous callers.
+ */
+
+#include "WString.h"
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs_shim {
+
+struct IoStats {
+    uint32_t opens;
+    uint32_t closes;
+    uint32_t reads;          // read() calls
+    uint32_t writes;         // write()/print() calls
+    uint32_t syncs;          // FAT syncs (flush, close after write)
+    uint32_t removes;
+    uint32_t mkdirs;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+};
+
+struct Counters {
+    std::atomic<uint32_t> opens{0}, closes{0}, reads{0}, writes{0}, syncs{0}, removes{0}, mkdirs{0};
+    std::atomic<uint64_t> bytes_read{0}, bytes_written{0};
+};
+
+inline std::string g_root;                    // Host directory backing the card ("" = no card)
+inline Counters g_io;
+inline std::atomic<uint32_t> g_latency_ms{0};
+
+inline void mount(const char* host_dir) { g_root = host_dir ? host_dir : ""; }
+inline void unmount() { g_root.clear(); }
+inline bool mounted() { return !g_root.empty(); }
+inline void setLatencyMs(uint32_t ms) { g_latency_ms.store(ms); }
+
+inline void resetStats() {
+    g_io.opens = 0; g_io.closes = 0; g_io.reads = 0; g_io.writes = 0;
+    g_io.syncs = 0; g_io.removes = 0; g_io.mkdirs = 0;
+    g_io.bytes_read = 0; g_io.bytes_written = 0;
+}
+
+inline IoStats stats() {
+    return IoStats{g_io.opens, g_io.closes, g_io.reads, g_io.writes, g_io.syncs,
+                   g_io.removes, g_io.mkdirs, g_io.bytes_read, g_io.bytes_written};
+}
+
+inline std::string hostPath(const char* path) {
+    return g_root + (path ? path : "");
+}
+
+inline void cardDelay() {
+    uint32_t ms = g_latency_ms.load();
+    if (ms > 0) std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+}  // namespace fs_shim
+
+namespace fs {
+
+class File {
+public:
+    File() = default;
+
+    explicit operator bool() const { return impl_ && (impl_->fp || impl_->dir); }
+
+    size_t write(const uint8_t* buf, size_t size) {
+        if (!impl_ || !impl_->fp || !buf) return 0;
+        size_t n = fwrite(buf, 1, size, impl_->fp);
+        fs_shim::g_io.writes++;
+        fs_shim::g_io.bytes_written += n;
+        if (n > 0) impl_->dirty = true;
+        return n;
+    }
+    size_t write(uint8_t b) { return write(&b, 1); }
+    size_t print(const String& text) { return write(reinterpret_cast<const uint8_t*>(text.c_str()), text.length()); }
+    size_t print(const char* text) { return text ? write(reinterpret_cast<const uint8_t*>(text), strlen(text)) : 0; }
+
+    int available() {
+        if (!impl_ || !impl_->fp) return 0;
+        long pos = ftell(impl_->fp);
+        return pos < 0 ? 0 : static_cast<int>(size() - static_cast<size_t>(pos));
+    }
+
+    int read() {
+        uint8_t b;
+        return read(&b, 1) == 1 ? b : -1;
+    }
+
+    size_t read(uint8_t* buf, size_t size) {
+        if (!impl_ || !impl_->fp || !buf) return 0;
+        size_t n = fread(buf, 1, size, impl_->fp);
+        fs_shim::g_io.reads++;
+        fs_shim::g_io.bytes_read += n;
+        return n;
+    }
+
+    size_t size() const {
+        if (!impl_ || !impl_->fp) return 0;
+        fflush(impl_->fp);
+        struct stat st;
+        return fstat(fileno(impl_->fp), &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+    }
+
+    size_t position() const {
+        if (!impl_ || !impl_->fp) return 0;
+        long pos = ftell(impl_->fp);
+        return pos < 0 ? 0 : static_cast<size_t>(pos);
+    }
+
+    bool seek(uint32_t pos) {
+        return impl_ && impl_->fp && fseek(impl_->fp, static_cast<long>(pos), SEEK_SET) == 0;
+    }
+
+    void flush() {
+        if (!impl_ || !impl_->fp) return;
+        fflush(impl_->fp);
+        fs_shim::g_io.syncs++;
+        impl_->dirty = false;
+    }
+
+    void close() { impl_.reset(); }
+
+    bool isDirectory() const { return impl_ && impl_->dir; }
+
+    File openNextFile(const char* mode = FILE_READ);
+
+    const char* name() const {
+        if (!impl_) return "";
+        size_t slash = impl_->path.rfind('/');
+        return impl_->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+    }
+
+    const char* path() const { return impl_ ? impl_->path.c_str() : ""; }
+
+private:
+    friend class FS;
+
+    struct Impl {
+        FILE* fp = nullptr;
+        DIR* dir = nullptr;
+        std::string path;          // Virtual path
+        bool dirty = false;        // Written since the last sync
+
+        ~Impl() {
+            if (fp) {
+                fclose(fp);
+                fs_shim::g_io.closes++;
+                if (dirty) fs_shim::g_io.syncs++;
+            }
+            if (dir) closedir(dir);
+        }
+    };
+
+    std::shared_ptr<Impl> impl_;
+};
+
+class FS {
+public:
+    virtual ~FS() = default;
+
+    File open(const char* path, const char* mode = FILE_READ, bool create = false) {
+        (void)create;
+        File file;
+        if (!fs_shim::mounted() || !path || path[0] != '/') return file;
+        fs_shim::cardDelay();
+
+        std::string host = fs_shim::hostPath(path);
+        struct stat st;
+        bool is_dir = stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+
+        auto impl = std::make_shared<File::Impl>();
+        impl->path = path;
+        if (is_dir) {
+            if (strcmp(mode, FILE_READ) != 0) return file;
+            impl->dir = opendir(host.c_str());
+            if (!impl->dir) return file;
+        } else {
+            const char* host_mode = mode[0] == 'w' ? "wb" : (mode[0] == 'a' ? "ab" : "rb");
+            impl->fp = fopen(host.c_str(), host_mode);
+            if (!impl->fp) return file;
+            fs_shim::g_io.opens++;
+        }
+        file.impl_ = impl;
+        return file;
+    }
+
+    File open(const String& path, const char* mode = FILE_READ) { return open(path.c_str(), mode); }
+
+    bool exists(const char* path) {
+        if (!fs_shim::mounted() || !path) return false;
+        struct stat st;
+        return stat(fs_shim::hostPath(path).c_str(), &st) == 0;
+    }
+    bool exists(const String& path) { return exists(path.c_str()); }
+
+    bool remove(const char* path) {
+        if (!fs_shim::mounted() || !path) return false;
+        fs_shim::g_io.removes++;
+        return unlink(fs_shim::hostPath(path).c_str()) == 0;
+    }
+
+    bool rename(const char* from, const char* to) {
+        if (!fs_shim::mounted() || !from || !to) return false;
+        return ::rename(fs_shim::hostPath(from).c_str(), fs_shim::hostPath(to).c_str()) == 0;
+    }
+
+    bool mkdir(const char* path) {
+        if (!fs_shim::mounted() || !path) return false;
+        fs_shim::g_io.mkdirs++;
+        return ::mkdir(fs_shim::hostPath(path).c_str(), 0755) == 0;
+    }
+    bool mkdir(const String& path) { return mkdir(path.c_str()); }
+
+    bool rmdir(const char* path) {
+        if (!fs_shim::mounted() || !path) return false;
+        return ::rmdir(fs_shim::hostPath(path).c_str()) == 0;
+    }
+};
+
+inline File File::openNextFile(const char* mode) {
+    File next;
+    if (!impl_ || !impl_->dir) return next;
+
+    struct dirent* entry;
+    while ((entry = readdir(impl_->dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) break;
+    }
+    if (!entry) return next;
+
+    std::string child = impl_->path;
+    if (child.empty() || child.back() != '/') child += '/';
+    child += entry->d_name;
+
+    FS fs;
+    return fs.open(child.c_str(), mode);
+}
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif // NATIVE_FS_SHIM_H
@@ -0,0 +1,119 @@
+#ifndef NATIVE_FASTLED_SHIM_H
+#define NATIVE_FASTLED_SHIM_H
+
+/**
+ * FastLED color math for host builds (env:native)
+ *
+ * LEDController uses FastLED for pixel math only (frames go out through
+ * LEDStripRMT), so this provides just CRGB / CHSV and the helpers it calls:
+ * - nscale8(), fill_rainbow(), fadeToBlackBy(), CRGB += CHSV
+ * - random8() / random16() on FastLED's 16-bit LCG (fixed seed, so
+ *   CONFETTI sparkles are reproducible in tests)
+ *
+ * scale8 and the saturating add match FastLED bit for bit; HSV → RGB is the
+ * plain six-sector spectrum rather than FastLED's "rainbow" curve, so
+ * hues come out slightly different from the device.
+ */
+
+#include <stdint.h>
+
+inline uint8_t scale8(uint8_t i, uint8_t scale) {
+    return static_cast<uint8_t>((static_cast<uint16_t>(i) * (1 + static_cast<uint16_t>(scale))) >> 8);
+}
+
+inline uint8_t qadd8(uint8_t a, uint8_t b) {
+    uint16_t sum = static_cast<uint16_t>(a) + b;
+    return sum > 255 ? 255 : static_cast<uint8_t>(sum);
+}
+
+struct CHSV {
+    uint8_t h;
+    uint8_t s;
+    uint8_t v;
+
+    CHSV() : h(0), s(0), v(0) {}
+    CHSV(uint8_t hue, uint8_t sat, uint8_t val) : h(hue), s(sat), v(val) {}
+};
+
+struct CRGB {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    CRGB(const CHSV& hsv);
+
+    CRGB& nscale8(uint8_t scale) {
+        r = scale8(r, scale);
+        g = scale8(g, scale);
+        b = scale8(b, scale);
+        return *this;
+    }
+
+    CRGB& fadeToBlackBy(uint8_t amount) { return nscale8(255 - amount); }
+
+    CRGB& operator+=(const CRGB& other) {
+        r = qadd8(r, other.r);
+        g = qadd8(g, other.g);
+        b = qadd8(b, other.b);
+        return *this;
+    }
+};
+
+inline void hsv2rgb_spectrum(const CHSV& hsv, CRGB& rgb) {
+    uint8_t region = hsv.h / 43;
+    uint8_t remainder = static_cast<uint8_t>((hsv.h - region * 43) * 6);
+    uint8_t p = scale8(hsv.v, 255 - hsv.s);
+    uint8_t q = scale8(hsv.v, 255 - scale8(hsv.s, remainder));
+    uint8_t t = scale8(hsv.v, 255 - scale8(hsv.s, 255 - remainder));
+
+    switch (region) {
+        case 0:  rgb = CRGB(hsv.v, t, p); break;
+        case 1:  rgb = CRGB(q, hsv.v, p); break;
+        case 2:  rgb = CRGB(p, hsv.v, t); break;
+        case 3:  rgb = CRGB(p, q, hsv.v); break;
+        case 4:  rgb = CRGB(t, p, hsv.v); break;
+        default: rgb = CRGB(hsv.v, p, q); break;
+    }
+}
+
+inline CRGB::CRGB(const CHSV& hsv) { hsv2rgb_spectrum(hsv, *this); }
+
+inline void fill_rainbow(CRGB* leds, int count, uint8_t initial_hue, uint8_t delta_hue = 5) {
+    CHSV hsv(initial_hue, 240, 255);
+    for (int i = 0; i < count; i++) {
+        leds[i] = hsv;
+        hsv.h = static_cast<uint8_t>(hsv.h + delta_hue);
+    }
+}
+
+inline void fadeToBlackBy(CRGB* leds, uint16_t count, uint8_t amount) {
+    for (uint16_t i = 0; i < count; i++) {
+        leds[i].fadeToBlackBy(amount);
+    }
+}
+
+namespace fastled_shim {
+    inline uint16_t rand16seed = 1337;
+}
+
+inline uint16_t random16() {
+    fastled_shim::rand16seed = static_cast<uint16_t>(fastled_shim::rand16seed * 2053 + 13849);
+    return fastled_shim::rand16seed;
+}
+
+inline uint16_t random16(uint16_t limit) {
+    return static_cast<uint16_t>((static_cast<uint32_t>(random16()) * limit) >> 16);
+}
+
+inline uint8_t random8() {
+    uint16_t r = random16();
+    return static_cast<uint8_t>(static_cast<uint8_t>(r) + static_cast<uint8_t>(r >> 8));
+}
+
+inline uint8_t random8(uint8_t limit) {
+    return static_cast<uint8_t>((static_cast<uint16_t>(random8()) * limit) >> 8);
+}
+
+#endif // NATIVE_FASTLED_SHIM_H
@@ -0,0 +1,29 @@
+#ifndef NATIVE_LITTLEFS_SHIM_H
+#define NATIVE_LITTLEFS_SHIM_H
+
+/**
+ * Arduino LittleFS on the host directory (see FS.h)
+ *
+ * Shares the fs_shim root with SD: tests put flash assets (data/ image
+ * layout, e.g. /www/index.html) below the same mounted directory.
+ */
+
+#include "FS.h"
+
+class LittleFSFS : public fs::FS {
+public:
+    bool begin(bool format_if_failed = false, const char* base_path = "/littlefs",
+               uint8_t max_open_files = 10, const char* partition_label = "spiffs") {
+        (void)format_if_failed; (void)base_path; (void)max_open_files; (void)partition_label;
+        return fs_shim::mounted();
+    }
+
+    void end() {}
+
+    size_t totalBytes() { return 0x9E0000; }   // spiffs partition (partitions.csv)
+    size_t usedBytes() { return 0; }
+};
+
+inline LittleFSFS LittleFS;
+
+#endif // NATIVE_LITTLEFS_SHIM_H
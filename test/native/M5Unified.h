@@ -0,0 +1,386 @@
+#ifndef NATIVE_M5UNIFIED_SHIM_H
+#define NATIVE_M5UNIFIED_SHIM_H
+
+/**
+ * Minimal M5Unified/M5GFX shim for host builds (env:native)
+ *
+ * Covers the subset used by src/ui so the real Renderer, ScreenManager,
+ * screens and widgets run on the host (input replay, UI benchmarks):
+ * - LGFX_Sprite/M5Canvas: real RGB565 framebuffer; fills, lines, circles,
+ *   triangles and text (one filled box per glyph) cost pixel work roughly
+ *   proportional to the device, so relative frame times are meaningful
+ * - Fonts: fixed-width approximations of the GFX fonts (Font0/2/4/6/8)
+ * - M5.Display: push target, counts pushSprite() calls and pixels
+ * - M5.BtnA/B/C, M5.Touch: inputs injected by the test, edge-triggered on
+ *   the next M5.update() like the real button/touch state machines
+ * - M5.Power, M5.Imu: settable values
+ *
+ * Not a pixel-exact renderer: glyph shapes and anti-aliasing are not modelled.
+ */
+
+#include <Arduino.h>   // Pulled in by M5Unified on the device too
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+// ============================================================================
+// Colors and text datum (values as in LovyanGFX)
+// ============================================================================
+
+#define TFT_BLACK       0x0000
+#define TFT_NAVY        0x000F
+#define TFT_DARKGREEN   0x03E0
+#define TFT_DARKCYAN    0x03EF
+#define TFT_MAROON      0x7800
+#define TFT_PURPLE      0x780F
+#define TFT_OLIVE       0x7BE0
+#define TFT_LIGHTGREY   0xD69A
+#define TFT_LIGHTGRAY   0xD69A
+#define TFT_DARKGREY    0x7BEF
+#define TFT_DARKGRAY    0x7BEF
+#define TFT_BLUE        0x001F
+#define TFT_GREEN       0x07E0
+#define TFT_CYAN        0x07FF
+#define TFT_RED         0xF800
+#define TFT_MAGENTA     0xF81F
+#define TFT_YELLOW      0xFFE0
+#define TFT_WHITE       0xFFFF
+#define TFT_ORANGE      0xFDA0
+#define TFT_GREENYELLOW 0xB7E0
+#define TFT_PINK        0xFE19
+
+enum textdatum_t : uint8_t {
+    TL_DATUM = 0,
+    TC_DATUM = 1,
+    TR_DATUM = 2,
+    ML_DATUM = 4,
+    MC_DATUM = 5,
+    MR_DATUM = 6,
+    BL_DATUM = 8,
+    BC_DATUM = 9,
+    BR_DATUM = 10
+};
+
+namespace lgfx {
+
+/**
+ * Font metrics only: average glyph width and line height (pixels, size 1)
+ */
+struct IFont {
+    uint8_t glyph_width;
+    uint8_t height;
+};
+
+namespace fonts {
+inline const IFont Font0{6, 8};      // GLCD 5x7
+inline const IFont Font2{8, 16};
+inline const IFont Font4{14, 26};
+inline const IFont Font6{27, 48};    // Digits only on the device
+inline const IFont Font8{55, 75};    // Digits only on the device
+}  // namespace fonts
+
+}  // namespace lgfx
+
+namespace fonts = lgfx::fonts;
+
+// ============================================================================
+// Display and sprite
+// ============================================================================
+
+class M5HostDisplay {
+public:
+    static constexpr int16_t WIDTH = 320;
+    static constexpr int16_t HEIGHT = 240;
+
+    void receive(const uint16_t* pixels, int16_t w, int16_t h) {
+        pushes_++;
+        pixels_pushed_ += static_cast<uint64_t>(w) * h;
+        // Copy like the SPI transfer would read the whole buffer
+        size_t count = static_cast<size_t>(std::min<int16_t>(w, WIDTH)) * std::min<int16_t>(h, HEIGHT);
+        if (frame_.size() < count) frame_.resize(count);
+        memcpy(frame_.data(), pixels, count * sizeof(uint16_t));
+    }
+
+    uint32_t pushCount() const { return pushes_; }
+    uint64_t pixelsPushed() const { return pixels_pushed_; }
+    const std::vector<uint16_t>& frame() const { return frame_; }
+    void resetCounters() { pushes_ = 0; pixels_pushed_ = 0; }
+
+private:
+    uint32_t pushes_ = 0;
+    uint64_t pixels_pushed_ = 0;
+    std::vector<uint16_t> frame_;
+};
+
+class LGFX_Sprite {
+public:
+    LGFX_Sprite() = default;
+    ~LGFX_Sprite() { deleteSprite(); }
+
+    void setColorDepth(int bits) { (void)bits; }
+    void setPsram(bool enabled) { (void)enabled; }
+
+    void* createSprite(int16_t w, int16_t h) {
+        width_ = w;
+        height_ = h;
+        buffer_.assign(static_cast<size_t>(w) * h, 0);
+        return buffer_.data();
+    }
+
+    void deleteSprite() {
+        buffer_.clear();
+        buffer_.shrink_to_fit();
+        width_ = height_ = 0;
+    }
+
+    int16_t width() const { return width_; }
+    int16_t height() const { return height_; }
+    const uint16_t* buffer() const { return buffer_.data(); }
+    uint16_t readPixel(int16_t x, int16_t y) const {
+        return inside(x, y) ? buffer_[static_cast<size_t>(y) * width_ + x] : 0;
+    }
+
+    void fillScreen(uint16_t color) { fillRect(0, 0, width_, height_, color); }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        int32_t x0 = std::max<int32_t>(x, 0), y0 = std::max<int32_t>(y, 0);
+        int32_t x1 = std::min<int32_t>(x + w, width_), y1 = std::min<int32_t>(y + h, height_);
+        for (int32_t row = y0; row < y1; row++) {
+            uint16_t* line = &buffer_[static_cast<size_t>(row) * width_];
+            std::fill(line + x0, line + std::max(x0, x1), color);
+        }
+    }
+
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        fillRect(x, y, w, 1, color);
+        fillRect(x, y + h - 1, w, 1, color);
+        fillRect(x, y, 1, h, color);
+        fillRect(x + w - 1, y, 1, h, color);
+    }
+
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+        int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+        int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+        int err = dx + dy;
+        while (true) {
+            setPixel(x0, y0, color);
+            if (x0 == x1 && y0 == y1) break;
+            int e2 = 2 * err;
+            if (e2 >= dy) { err += dy; x0 += sx; }
+            if (e2 <= dx) { err += dx; y0 += sy; }
+        }
+    }
+
+    void drawCircle(int16_t cx, int16_t cy, int16_t r, uint16_t color) {
+        int x = r, y = 0, err = 1 - r;
+        while (x >= y) {
+            setPixel(cx + x, cy + y, color); setPixel(cx + y, cy + x, color);
+            setPixel(cx - y, cy + x, color); setPixel(cx - x, cy + y, color);
+            setPixel(cx - x, cy - y, color); setPixel(cx - y, cy - x, color);
+            setPixel(cx + y, cy - x, color); setPixel(cx + x, cy - y, color);
+            y++;
+            if (err < 0) { err += 2 * y + 1; } else { x--; err += 2 * (y - x) + 1; }
+        }
+    }
+
+    void fillCircle(int16_t cx, int16_t cy, int16_t r, uint16_t color) {
+        for (int16_t dy = -r; dy <= r; dy++) {
+            int16_t half = static_cast<int16_t>(isqrt(r * r - dy * dy));
+            fillRect(cx - half, cy + dy, 2 * half + 1, 1, color);
+        }
+    }
+
+    void drawTriangle(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+                      int16_t x3, int16_t y3, uint16_t color) {
+        drawLine(x1, y1, x2, y2, color);
+        drawLine(x2, y2, x3, y3, color);
+        drawLine(x3, y3, x1, y1, color);
+    }
+
+    void fillTriangle(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+                      int16_t x3, int16_t y3, uint16_t color) {
+        int16_t min_y = std::min({y1, y2, y3}), max_y = std::max({y1, y2, y3});
+        for (int16_t y = min_y; y <= max_y; y++) {
+            int16_t xs[3];
+            int n = 0;
+            edgeX(x1, y1, x2, y2, y, xs, n);
+            edgeX(x2, y2, x3, y3, y, xs, n);
+            edgeX(x3, y3, x1, y1, y, xs, n);
+            if (n == 0) continue;
+            int16_t lo = *std::min_element(xs, xs + n), hi = *std::max_element(xs, xs + n);
+            fillRect(lo, y, hi - lo + 1, 1, color);
+        }
+    }
+
+    // Text: one filled box per non-space glyph (cost ~ glyph area)
+    void setFont(const lgfx::IFont* font) { font_ = font ? font : &lgfx::fonts::Font0; }
+    void setTextColor(uint16_t color) { text_color_ = color; }
+    void setTextDatum(textdatum_t datum) { datum_ = datum; }
+    void setTextSize(float size) { text_size_ = size > 0.0f ? size : 1.0f; }
+
+    int16_t textWidth(const char* text) const {
+        return text ? static_cast<int16_t>(strlen(text) * font_->glyph_width * text_size_) : 0;
+    }
+
+    int16_t fontHeight() const { return static_cast<int16_t>(font_->height * text_size_); }
+
+    int16_t drawString(const char* text, int16_t x, int16_t y) {
+        if (!text) return 0;
+        int16_t w = textWidth(text), h = fontHeight();
+        int16_t left = x - ((datum_ & 3) == 1 ? w / 2 : (datum_ & 3) == 2 ? w : 0);
+        int16_t top = y - ((datum_ >> 2) == 1 ? h / 2 : (datum_ >> 2) == 2 ? h : 0);
+        int16_t gw = static_cast<int16_t>(font_->glyph_width * text_size_);
+        for (const char* p = text; *p; ++p, left += gw) {
+            if (*p != ' ') fillRect(left + 1, top + 1, gw - 2, h - 2, text_color_);
+        }
+        return w;
+    }
+
+    void pushSprite(M5HostDisplay* display, int16_t x, int16_t y) {
+        (void)x; (void)y;
+        display->receive(buffer_.data(), width_, height_);
+    }
+
+private:
+    std::vector<uint16_t> buffer_;
+    int16_t width_ = 0;
+    int16_t height_ = 0;
+    const lgfx::IFont* font_ = &lgfx::fonts::Font0;
+    uint16_t text_color_ = TFT_WHITE;
+    textdatum_t datum_ = TL_DATUM;
+    float text_size_ = 1.0f;
+
+    bool inside(int16_t x, int16_t y) const { return x >= 0 && y >= 0 && x < width_ && y < height_; }
+
+    void setPixel(int16_t x, int16_t y, uint16_t color) {
+        if (inside(x, y)) buffer_[static_cast<size_t>(y) * width_ + x] = color;
+    }
+
+    static int isqrt(int v) {
+        int r = 0;
+        while ((r + 1) * (r + 1) <= v) r++;
+        return r;
+    }
+
+    static void edgeX(int16_t xa, int16_t ya, int16_t xb, int16_t yb, int16_t y, int16_t* xs, int& n) {
+        if ((y < ya && y < yb) || (y > ya && y > yb)) return;
+        if (ya == yb) { if (n < 3) xs[n++] = xa; if (n < 3) xs[n++] = xb; return; }
+        if (n < 3) xs[n++] = static_cast<int16_t>(xa + (xb - xa) * (y - ya) / (yb - ya));
+    }
+};
+
+using M5Canvas = LGFX_Sprite;
+
+// ============================================================================
+// Inputs and peripherals
+// ============================================================================
+
+/**
+ * Button: press() queues a press, the next M5.update() makes wasPressed()
+ * true for exactly one update cycle (like the debounced device button).
+ */
+class M5HostButton {
+public:
+    void press() { pending_ = true; }
+    bool wasPressed() const { return pressed_; }
+    bool wasReleased() const { return released_; }
+    bool isPressed() const { return pressed_; }
+
+    void update() {
+        released_ = pressed_;
+        pressed_ = pending_;
+        pending_ = false;
+    }
+
+private:
+    bool pending_ = false;
+    bool pressed_ = false;
+    bool released_ = false;
+};
+
+class M5HostTouch {
+public:
+    struct Detail {
+        int16_t x = 0;
+        int16_t y = 0;
+        bool pressed = false;
+        bool released = false;
+        bool wasPressed() const { return pressed; }
+        bool wasReleased() const { return released; }
+    };
+
+    void press(int16_t x, int16_t y) { queue(x, y, true); }
+    void release(int16_t x, int16_t y) { queue(x, y, false); }
+
+    Detail getDetail() const { return detail_; }
+
+    void update() {
+        detail_ = Detail{};
+        if (pending_count_ == 0) return;
+        detail_ = pending_[0];
+        memmove(pending_, pending_ + 1, (pending_count_ - 1) * sizeof(Detail));
+        pending_count_--;
+    }
+
+private:
+    Detail detail_;
+    Detail pending_[8];
+    uint8_t pending_count_ = 0;
+
+    void queue(int16_t x, int16_t y, bool down) {
+        if (pending_count_ >= 8) return;
+        Detail& d = pending_[pending_count_++];
+        d.x = x;
+        d.y = y;
+        d.pressed = down;
+        d.released = !down;
+    }
+};
+
+class M5HostPower {
+public:
+    int32_t getBatteryLevel() const { return battery_level; }
+    bool isCharging() const { return charging; }
+    void setExtOutput(bool enable) { ext_output = enable; }
+    bool getExtOutput() const { return ext_output; }
+
+    int32_t battery_level = 80;
+    bool charging = false;
+    bool ext_output = false;    // 5V boost (LED bar)
+};
+
+class M5HostImu {
+public:
+    bool isEnabled() const { return enabled; }
+    bool getAccel(float* x, float* y, float* z) const { *x = accel[0]; *y = accel[1]; *z = accel[2]; return enabled; }
+    bool getGyro(float* x, float* y, float* z) const { *x = gyro[0]; *y = gyro[1]; *z = gyro[2]; return enabled; }
+
+    bool enabled = true;
+    float accel[3] = {0.0f, 0.0f, 1.0f};   // Face up
+    float gyro[3] = {0.0f, 0.0f, 0.0f};
+};
+
+class M5HostUnified {
+public:
+    void update() {
+        BtnA.update();
+        BtnB.update();
+        BtnC.update();
+        Touch.update();
+    }
+
+    M5HostDisplay Display;
+    M5HostButton BtnA;
+    M5HostButton BtnB;
+    M5HostButton BtnC;
+    M5HostTouch Touch;
+    M5HostPower Power;
+    M5HostImu Imu;
+};
+
+inline M5HostUnified M5;
+
+#endif // NATIVE_M5UNIFIED_SHIM_H
@@ -0,0 +1,155 @@
+#ifndef NATIVE_PREFERENCES_SHIM_H
+#define NATIVE_PREFERENCES_SHIM_H
+
+/**
+ * In-memory Preferences (NVS) shim for host builds (env:native)
+ *
+ * Same API subset as the ESP32 Arduino Preferences library used by Config
+ * and Statistics. All instances share one process-wide store, so data
+ * written by one Preferences object is visible to the next begin() on the
+ * same namespace - like NVS across a reboot. Call
+ * preferences_shim::clearAll() between tests.
+ *
+ * preferences_shim::setWriteDelayUs() makes every put*() block like a slow
+ * NVS commit (for contention tests that hold a mutex across NVS writes).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace preferences_shim {
+
+using Blob = std::vector<uint8_t>;
+using Namespace = std::map<std::string, Blob>;
+
+inline std::mutex g_mutex;
+inline std::map<std::string, Namespace> g_store;
+inline std::atomic<uint32_t> g_write_delay_us{0};
+
+inline void setWriteDelayUs(uint32_t us) { g_write_delay_us.store(us); }
+
+inline void clearAll() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_store.clear();
+}
+
+}  // namespace preferences_shim
+
+class Preferences {
+public:
+    bool begin(const char* name, bool read_only = false, const char* partition = nullptr) {
+        (void)partition;
+        if (!name || strlen(name) > 15) return false;  // NVS key/namespace limit
+        name_ = name;
+        read_only_ = read_only;
+        open_ = true;
+        return true;
+    }
+
+    void end() { open_ = false; }
+
+    bool clear() {
+        if (!writable()) return false;
+        std::lock_guard<std::mutex> lock(preferences_shim::g_mutex);
+        preferences_shim::g_store[name_].clear();
+        return true;
+    }
+
+    bool remove(const char* key) {
+        if (!writable()) return false;
+        std::lock_guard<std::mutex> lock(preferences_shim::g_mutex);
+        return preferences_shim::g_store[name_].erase(key) > 0;
+    }
+
+    bool isKey(const char* key) {
+        std::lock_guard<std::mutex> lock(preferences_shim::g_mutex);
+        auto& ns = preferences_shim::g_store[name_];
+        return open_ && ns.find(key) != ns.end();
+    }
+
+    size_t putUChar(const char* key, uint8_t value) { return putValue(key, value); }
+    size_t putUShort(const char* key, uint16_t value) { return putValue(key, value); }
+    size_t putUInt(const char* key, uint32_t value) { return putValue(key, value); }
+    size_t putInt(const char* key, int32_t value) { return putValue(key, value); }
+    size_t putULong(const char* key, uint32_t value) { return putValue(key, value); }
+    size_t putBool(const char* key, bool value) { return putValue(key, static_cast<uint8_t>(value)); }
+    size_t putFloat(const char* key, float value) { return putValue(key, value); }
+
+    uint8_t getUChar(const char* key, uint8_t default_value = 0) { return getValue(key, default_value); }
+    uint16_t getUShort(const char* key, uint16_t default_value = 0) { return getValue(key, default_value); }
+    uint32_t getUInt(const char* key, uint32_t default_value = 0) { return getValue(key, default_value); }
+    int32_t getInt(const char* key, int32_t default_value = 0) { return getValue(key, default_value); }
+    uint32_t getULong(const char* key, uint32_t default_value = 0) { return getValue(key, default_value); }
+    bool getBool(const char* key, bool default_value = false) {
+        return getValue(key, static_cast<uint8_t>(default_value)) != 0;
+    }
+    float getFloat(const char* key, float default_value = 0.0f) { return getValue(key, default_value); }
+
+    size_t putString(const char* key, const char* value) {
+        if (!value) return 0;
+        return putBytes(key, value, strlen(value) + 1) ? strlen(value) : 0;
+    }
+
+    size_t getString(const char* key, char* value, size_t max_len) {
+        size_t len = getBytesLength(key);
+        if (len == 0 || !value || max_len < len) return 0;
+        return getBytes(key, value, max_len);
+    }
+
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        if (!writable() || !key || strlen(key) > 15 || (!value && len > 0)) return 0;
+        const uint8_t* bytes = static_cast<const uint8_t*>(value);
+        if (uint32_t delay_us = preferences_shim::g_write_delay_us.load()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+        }
+        std::lock_guard<std::mutex> lock(preferences_shim::g_mutex);
+        preferences_shim::g_store[name_][key] = preferences_shim::Blob(bytes, bytes + len);
+        return len;
+    }
+
+    size_t getBytesLength(const char* key) {
+        std::lock_guard<std::mutex> lock(preferences_shim::g_mutex);
+        auto& ns = preferences_shim::g_store[name_];
+        auto it = ns.find(key);
+        return (open_ && it != ns.end()) ? it->second.size() : 0;
+    }
+
+    size_t getBytes(const char* key, void* buf, size_t max_len) {
+        std::lock_guard<std::mutex> lock(preferences_shim::g_mutex);
+        auto& ns = preferences_shim::g_store[name_];
+        auto it = ns.find(key);
+        if (!open_ || it == ns.end() || !buf || max_len < it->second.size()) return 0;
+        memcpy(buf, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+
+private:
+    std::string name_;
+    bool read_only_ = false;
+    bool open_ = false;
+
+    bool writable() const { return open_ && !read_only_; }
+
+    template <typename T>
+    size_t putValue(const char* key, T value) {
+        return putBytes(key, &value, sizeof(T));
+    }
+
+    template <typename T>
+    T getValue(const char* key, T default_value) {
+        T value;
+        if (getBytesLength(key) != sizeof(T)) return default_value;
+        getBytes(key, &value, sizeof(T));
+        return value;
+    }
+};
+
+#endif // NATIVE_PREFERENCES_SHIM_H
@@ -0,0 +1,40 @@
+#ifndef NATIVE_SD_SHIM_H
+#define NATIVE_SD_SHIM_H
+
+/**
+ * Arduino SD library on the host directory card (see FS.h)
+ *
+ * begin() succeeds once a test has called fs_shim::mount(); the card then
+ * reports as SDHC with a fixed 16 GB capacity.
+ */
+
+#include "FS.h"
+#include "SPI.h"
+
+typedef enum {
+    CARD_NONE,
+    CARD_MMC,
+    CARD_SD,
+    CARD_SDHC,
+    CARD_UNKNOWN
+} sdcard_type_t;
+
+class SDFS : public fs::FS {
+public:
+    bool begin(uint8_t ss_pin = 4, SPIClass& spi = SPI, uint32_t frequency = 4000000,
+               const char* mountpoint = "/sd", uint8_t max_files = 5, bool format_if_empty = false) {
+        (void)ss_pin; (void)spi; (void)frequency; (void)mountpoint; (void)max_files; (void)format_if_empty;
+        return fs_shim::mounted();
+    }
+
+    void end() {}
+
+    sdcard_type_t cardType() { return fs_shim::mounted() ? CARD_SDHC : CARD_NONE; }
+    uint64_t cardSize() { return totalBytes(); }
+    uint64_t totalBytes() { return 16ull * 1024 * 1024 * 1024; }
+    uint64_t usedBytes() { return 0; }
+};
+
+inline SDFS SD;
+
+#endif // NATIVE_SD_SHIM_H
@@ -0,0 +1,11 @@
+#ifndef NATIVE_SPI_SHIM_H
+#define NATIVE_SPI_SHIM_H
+
+/**
+ * SPIClass placeholder (host builds): only passed through to SD.begin()
+ */
+class SPIClass {};
+
+inline SPIClass SPI;
+
+#endif // NATIVE_SPI_SHIM_H
@@ -0,0 +1,80 @@
+#ifndef NATIVE_WSTRING_SHIM_H
+#define NATIVE_WSTRING_SHIM_H
+
+/**
+ * Arduino String on std::string (host builds)
+ *
+ * Covers the subset used by SDManager / NetworkConfig style code:
+ * construction from text and numbers, concatenation, search, substring,
+ * trim and toInt. Index-returning methods use -1 for "not found", as on
+ * the device.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+class String {
+public:
+    String() = default;
+    String(const char* text) : s_(text ? text : "") {}
+    String(const std::string& text) : s_(text) {}
+    explicit String(char c) : s_(1, c) {}
+    explicit String(int value) : s_(std::to_string(value)) {}
+    explicit String(unsigned int value) : s_(std::to_string(value)) {}
+    explicit String(long value) : s_(std::to_string(value)) {}
+    explicit String(unsigned long value) : s_(std::to_string(value)) {}
+
+    const char* c_str() const { return s_.c_str(); }
+    unsigned int length() const { return static_cast<unsigned int>(s_.size()); }
+    bool isEmpty() const { return s_.empty(); }
+    bool reserve(unsigned int size) { s_.reserve(size); return true; }
+
+    char operator[](unsigned int index) const { return index < s_.size() ? s_[index] : 0; }
+    char charAt(unsigned int index) const { return (*this)[index]; }
+
+    String& operator+=(const String& other) { s_ += other.s_; return *this; }
+    String& operator+=(const char* text) { if (text) s_ += text; return *this; }
+    String& operator+=(char c) { s_ += c; return *this; }
+    bool concat(const String& other) { s_ += other.s_; return true; }
+    bool concat(char c) { s_ += c; return true; }
+
+    friend String operator+(String lhs, const String& rhs) { lhs += rhs; return lhs; }
+    friend String operator+(String lhs, const char* rhs) { lhs += rhs; return lhs; }
+
+    bool operator==(const String& other) const { return s_ == other.s_; }
+    bool operator==(const char* text) const { return s_ == (text ? text : ""); }
+    bool operator!=(const String& other) const { return s_ != other.s_; }
+    bool operator!=(const char* text) const { return !(*this == text); }
+
+    int indexOf(char c, unsigned int from = 0) const { return pos(s_.find(c, from)); }
+    int indexOf(const char* text, unsigned int from = 0) const { return pos(s_.find(text, from)); }
+    int lastIndexOf(char c) const { return pos(s_.rfind(c)); }
+    bool startsWith(const char* prefix) const { return s_.rfind(prefix, 0) == 0; }
+    bool endsWith(const char* suffix) const {
+        std::string tail(suffix);
+        return s_.size() >= tail.size() && s_.compare(s_.size() - tail.size(), tail.size(), tail) == 0;
+    }
+
+    String substring(unsigned int from) const { return from < s_.size() ? String(s_.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (to > s_.size()) to = static_cast<unsigned int>(s_.size());
+        return from < to ? String(s_.substr(from, to - from)) : String();
+    }
+
+    void trim() {
+        const char* ws = " \t\r\n";
+        size_t first = s_.find_first_not_of(ws);
+        if (first == std::string::npos) { s_.clear(); return; }
+        s_ = s_.substr(first, s_.find_last_not_of(ws) - first + 1);
+    }
+
+    long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+
+private:
+    static int pos(size_t p) { return p == std::string::npos ? -1 : static_cast<int>(p); }
+
+    std::string s_;
+};
+
+#endif // NATIVE_WSTRING_SHIM_H
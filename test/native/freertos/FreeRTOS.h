@@ -0,0 +1,30 @@
+#ifndef NATIVE_FREERTOS_SHIM_H
+#define NATIVE_FREERTOS_SHIM_H
+
+/**
+ * FreeRTOS shim for host builds (env:native)
+ *
+ * Maps the subset of the ESP-IDF FreeRTOS API used by this project onto
+ * pthreads so task code can run unmodified in host replays. Ticks are 1 ms
+ * (configTICK_RATE_HZ = 1000, as on the device).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+#define portTICK_PERIOD_MS 1
+#define portNUM_PROCESSORS 2
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+#endif // NATIVE_FREERTOS_SHIM_H
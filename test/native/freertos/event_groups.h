@@ -0,0 +1,104 @@
+#ifndef NATIVE_FREERTOS_EVENT_GROUPS_SHIM_H
+#define NATIVE_FREERTOS_EVENT_GROUPS_SHIM_H
+
+/**
+ * FreeRTOS event group API on std::mutex + condition variable (host builds)
+ *
+ * 24 usable bits as on the ESP32 (configUSE_16_BIT_TICKS = 0). Counts
+ * xEventGroupWaitBits() timeouts for the contention harness.
+ */
+
+#include "FreeRTOS.h"
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+typedef TickType_t EventBits_t;
+
+namespace freertos_shim {
+
+constexpr EventBits_t EVENT_BITS_MASK = 0x00FFFFFFu;
+
+struct EventGroup {
+    std::mutex mutex;
+    std::condition_variable changed;
+    EventBits_t bits = 0;
+
+    std::atomic<uint32_t> sets{0};
+    std::atomic<uint32_t> waits{0};
+    std::atomic<uint32_t> wait_timeouts{0};
+};
+
+}  // namespace freertos_shim
+
+typedef freertos_shim::EventGroup* EventGroupHandle_t;
+
+inline EventGroupHandle_t xEventGroupCreate() {
+    return new freertos_shim::EventGroup();
+}
+
+inline void vEventGroupDelete(EventGroupHandle_t group) {
+    delete group;
+}
+
+inline EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    if (!group) return 0;
+    EventBits_t result;
+    {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        group->bits |= (bits & freertos_shim::EVENT_BITS_MASK);
+        result = group->bits;
+    }
+    group->sets.fetch_add(1, std::memory_order_relaxed);
+    group->changed.notify_all();
+    return result;
+}
+
+// Returns the bits before clearing (FreeRTOS semantics)
+inline EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    if (!group) return 0;
+    std::lock_guard<std::mutex> lock(group->mutex);
+    EventBits_t previous = group->bits;
+    group->bits &= ~bits;
+    return previous;
+}
+
+inline EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    if (!group) return 0;
+    std::lock_guard<std::mutex> lock(group->mutex);
+    return group->bits;
+}
+
+inline EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits_to_wait,
+                                       BaseType_t clear_on_exit, BaseType_t wait_for_all,
+                                       TickType_t ticks) {
+    if (!group) return 0;
+    group->waits.fetch_add(1, std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> lock(group->mutex);
+    auto satisfied = [&] {
+        EventBits_t match = group->bits & bits_to_wait;
+        return wait_for_all ? match == bits_to_wait : match != 0;
+    };
+
+    bool ok;
+    if (ticks == portMAX_DELAY) {
+        group->changed.wait(lock, satisfied);
+        ok = true;
+    } else {
+        ok = group->changed.wait_for(lock, std::chrono::milliseconds(ticks), satisfied);
+    }
+
+    EventBits_t result = group->bits;
+    if (ok && clear_on_exit) {
+        group->bits &= ~bits_to_wait;
+    }
+    if (!ok) {
+        group->wait_timeouts.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+#endif // NATIVE_FREERTOS_EVENT_GROUPS_SHIM_H
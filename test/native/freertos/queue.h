@@ -0,0 +1,143 @@
+#ifndef NATIVE_FREERTOS_QUEUE_SHIM_H
+#define NATIVE_FREERTOS_QUEUE_SHIM_H
+
+/**
+ * FreeRTOS queue API on std::mutex + condition variables (host builds)
+ *
+ * Copy-by-value ring buffer with the FreeRTOS blocking semantics (ticks =
+ * ms, 0 = poll, portMAX_DELAY = forever). Each queue counts sends, failed
+ * sends (drops when the caller used a zero/short timeout), receives and
+ * its fill high-water mark for the contention harness.
+ */
+
+#include "FreeRTOS.h"
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace freertos_shim {
+
+struct Queue {
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::vector<uint8_t> storage;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head = 0;
+    UBaseType_t count = 0;
+
+    char name[24] = "queue";
+    std::atomic<uint32_t> sends{0};
+    std::atomic<uint32_t> send_failures{0};
+    std::atomic<uint32_t> receives{0};
+    std::atomic<uint32_t> high_water{0};
+
+    template <typename Predicate>
+    bool waitFor(std::unique_lock<std::mutex>& lock, std::condition_variable& cv,
+                 TickType_t ticks, Predicate ready) {
+        if (ticks == portMAX_DELAY) {
+            cv.wait(lock, ready);
+            return true;
+        }
+        return cv.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+    }
+};
+
+}  // namespace freertos_shim
+
+typedef freertos_shim::Queue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    if (length == 0 || item_size == 0) return nullptr;
+    auto* queue = new freertos_shim::Queue();
+    queue->length = length;
+    queue->item_size = item_size;
+    queue->storage.resize(static_cast<size_t>(length) * item_size);
+    return queue;
+}
+
+inline void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
+
+inline BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    if (!queue) return pdFALSE;
+
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!queue->waitFor(lock, queue->not_full, ticks,
+                        [queue] { return queue->count < queue->length; })) {
+        queue->send_failures.fetch_add(1, std::memory_order_relaxed);
+        return pdFALSE;  // errQUEUE_FULL
+    }
+
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->storage[static_cast<size_t>(tail) * queue->item_size], item, queue->item_size);
+    queue->count++;
+    queue->sends.fetch_add(1, std::memory_order_relaxed);
+    if (queue->count > queue->high_water.load(std::memory_order_relaxed)) {
+        queue->high_water.store(queue->count, std::memory_order_relaxed);
+    }
+
+    lock.unlock();
+    queue->not_empty.notify_one();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    return xQueueSendToBack(queue, item, ticks);
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void* buffer, TickType_t ticks) {
+    if (!queue) return pdFALSE;
+
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!queue->waitFor(lock, queue->not_empty, ticks, [queue] { return queue->count > 0; })) {
+        return pdFALSE;
+    }
+
+    memcpy(buffer, &queue->storage[static_cast<size_t>(queue->head) * queue->item_size],
+           queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    queue->receives.fetch_add(1, std::memory_order_relaxed);
+
+    lock.unlock();
+    queue->not_full.notify_one();
+    return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    if (!queue) return 0;
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->count;
+}
+
+inline UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+    if (!queue) return 0;
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->length - queue->count;
+}
+
+inline BaseType_t xQueueReset(QueueHandle_t queue) {
+    if (!queue) return pdFALSE;
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->head = 0;
+        queue->count = 0;
+    }
+    queue->not_full.notify_all();
+    return pdPASS;
+}
+
+inline void vQueueAddToRegistry(QueueHandle_t queue, const char* name) {
+    if (!queue || !name) return;
+    strncpy(queue->name, name, sizeof(queue->name) - 1);
+    queue->name[sizeof(queue->name) - 1] = '\0';
+}
+
+#endif // NATIVE_FREERTOS_QUEUE_SHIM_H
@@ -0,0 +1,87 @@
+#ifndef NATIVE_FREERTOS_SEMPHR_SHIM_H
+#define NATIVE_FREERTOS_SEMPHR_SHIM_H
+
+/**
+ * FreeRTOS mutex API on std::timed_mutex (host builds)
+ *
+ * Each mutex carries LockStats (sync_monitor.h): takes, timeouts, wait and
+ * hold latency. Name mutexes with vQueueAddToRegistry() (as on the device)
+ * and give them a lock-order rank with freertos_shim::setLockRank().
+ */
+
+#include "FreeRTOS.h"
+#include "sync_monitor.h"
+#include <chrono>
+#include <mutex>
+
+namespace freertos_shim {
+
+struct Semaphore {
+    std::timed_mutex mutex;
+    LockStats stats;
+};
+
+}  // namespace freertos_shim
+
+typedef freertos_shim::Semaphore* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+    auto* sem = new freertos_shim::Semaphore();
+    freertos_shim::SyncMonitor::registerLock(sem->stats);
+    return sem;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t sem) {
+    if (!sem) return;
+    freertos_shim::SyncMonitor::unregisterLock(sem->stats);
+    delete sem;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    if (!sem) return pdFALSE;
+
+    auto start = std::chrono::steady_clock::now();
+    bool locked;
+    if (ticks == portMAX_DELAY) {
+        sem->mutex.lock();
+        locked = true;
+    } else {
+        locked = sem->mutex.try_lock_for(std::chrono::milliseconds(ticks));
+    }
+
+    if (!locked) {
+        sem->stats.timeouts.fetch_add(1, std::memory_order_relaxed);
+        return pdFALSE;
+    }
+
+    auto waited = std::chrono::steady_clock::now() - start;
+    sem->stats.takes.fetch_add(1, std::memory_order_relaxed);
+    sem->stats.wait_us.record(static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(waited).count()));
+    freertos_shim::SyncMonitor::onAcquired(sem->stats);
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    if (!sem) return pdFALSE;
+    freertos_shim::SyncMonitor::onReleased(sem->stats);
+    sem->mutex.unlock();
+    return pdTRUE;
+}
+
+inline void vQueueAddToRegistry(SemaphoreHandle_t sem, const char* name) {
+    if (!sem || !name) return;
+    strncpy(sem->stats.name, name, sizeof(sem->stats.name) - 1);
+    sem->stats.name[sizeof(sem->stats.name) - 1] = '\0';
+}
+
+namespace freertos_shim {
+
+// Lock-order rank: lower ranks must be taken first (-1 = unranked)
+inline void setLockRank(SemaphoreHandle_t sem, int rank) {
+    if (sem) sem->stats.rank = rank;
+}
+
+}  // namespace freertos_shim
+
+#endif // NATIVE_FREERTOS_SEMPHR_SHIM_H
@@ -0,0 +1,282 @@
+#ifndef NATIVE_FREERTOS_SYNC_MONITOR_H
+#define NATIVE_FREERTOS_SYNC_MONITOR_H
+
+/**
+ * Contention instrumentation for the host FreeRTOS shim
+ *
+ * Every shim mutex records take count, timeouts and wait latency. When the
+ * monitor is enabled, acquisitions are also checked against lock order:
+ * - Ranked: mutexes given a rank (setLockRank) must be taken in increasing
+ *   rank order (SyncPrimitives.h: i2c → display → stats → shadow_state)
+ * - Inversion: any two mutexes observed nested both as A→B and B→A,
+ *   ranked or not (potential deadlock even if it never happened)
+ *
+ * Used by the contention harness (test/stress). Counters and histograms are
+ * always on; the lock-order checks only run after enable(true).
+ */
+
+#include "task.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace freertos_shim {
+
+/**
+ * Lock-free log-linear latency histogram (microseconds)
+ * Exact below 64 us, then 16 sub-buckets per power of two (≤6.25% error).
+ */
+class LatencyHistogram {
+public:
+    static constexpr uint32_t LINEAR = 64;
+    static constexpr uint32_t SUB_BUCKETS = 16;
+    static constexpr uint32_t BUCKETS = LINEAR + (32 - 6) * SUB_BUCKETS;
+
+    void record(uint32_t us) {
+        buckets_[bucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        uint32_t prev = max_.load(std::memory_order_relaxed);
+        while (us > prev && !max_.compare_exchange_weak(prev, us, std::memory_order_relaxed)) {}
+    }
+
+    uint32_t count() const { return count_.load(); }
+    uint32_t max() const { return max_.load(); }
+
+    // Samples in the bucket holding `us` and above
+    uint32_t countAtLeast(uint32_t us) const {
+        uint32_t total = 0;
+        for (uint32_t i = bucketFor(us); i < BUCKETS; i++) {
+            total += buckets_[i].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // Upper bound of the bucket holding the given percentile (0-100)
+    uint32_t percentile(double pct) const {
+        uint32_t total = count();
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(total * pct / 100.0 + 0.5);
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < BUCKETS; i++) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                uint32_t upper = bucketUpper(i);
+                return upper < max() ? upper : max();
+            }
+        }
+        return max();
+    }
+
+    void reset() {
+        for (auto& bucket : buckets_) bucket.store(0);
+        count_.store(0);
+        max_.store(0);
+    }
+
+private:
+    std::atomic<uint32_t> buckets_[BUCKETS] = {};
+    std::atomic<uint32_t> count_{0};
+    std::atomic<uint32_t> max_{0};
+
+    static uint32_t bucketFor(uint32_t us) {
+        if (us < LINEAR) return us;
+        uint32_t exponent = 31 - __builtin_clz(us);          // ≥ 6
+        uint32_t sub = (us >> (exponent - 4)) & (SUB_BUCKETS - 1);
+        return LINEAR + (exponent - 6) * SUB_BUCKETS + sub;
+    }
+
+    static uint32_t bucketUpper(uint32_t index) {
+        if (index < LINEAR) return index;
+        uint32_t exponent = (index - LINEAR) / SUB_BUCKETS + 6;
+        uint32_t sub = (index - LINEAR) % SUB_BUCKETS;
+        uint64_t upper = ((uint64_t)(SUB_BUCKETS + sub + 1) << (exponent - 4)) - 1;
+        return upper > 0xFFFFFFFFu ? 0xFFFFFFFFu : static_cast<uint32_t>(upper);
+    }
+};
+
+/**
+ * Per-mutex statistics (embedded in the shim semaphore)
+ */
+struct LockStats {
+    char name[24] = "mutex";
+    int rank = -1;                       // -1 = unranked
+    uint8_t id = 0xFF;                   // Slot in the inversion matrix (0xFF = untracked)
+    std::atomic<uint32_t> takes{0};
+    std::atomic<uint32_t> timeouts{0};
+    LatencyHistogram wait_us;            // Time blocked in xSemaphoreTake (successful)
+    LatencyHistogram hold_us;            // Time between take and give
+};
+
+struct LockOrderViolation {
+    char held[24];
+    char acquired[24];
+    char task[16];                       // First task seen doing it
+    bool ranked;                         // true = rank order, false = A→B/B→A inversion
+    uint32_t count;
+};
+
+class SyncMonitor {
+public:
+    static constexpr uint8_t MAX_LOCKS = 32;
+    static constexpr uint8_t MAX_HELD = 8;
+    static constexpr uint8_t MAX_VIOLATIONS = 32;
+
+    static void enable(bool on) { state().enabled.store(on); }
+    static bool isEnabled() { return state().enabled.load(); }
+
+    // Called by the shim when a mutex is created/deleted
+    static void registerLock(LockStats& lock) {
+        std::lock_guard<std::mutex> guard(state().mutex);
+        for (uint8_t id = 0; id < MAX_LOCKS; id++) {
+            if (state().slots[id]) continue;
+            state().slots[id] = &lock;
+            lock.id = id;
+            break;
+        }
+        snprintf(lock.name, sizeof(lock.name), "mutex#%u", lock.id);
+    }
+
+    static void unregisterLock(LockStats& lock) {
+        if (lock.id >= MAX_LOCKS) return;
+        std::lock_guard<std::mutex> guard(state().mutex);
+        state().slots[lock.id] = nullptr;
+        for (uint8_t i = 0; i < MAX_LOCKS; i++) {
+            state().edges[lock.id][i] = false;
+            state().edges[i][lock.id] = false;
+        }
+    }
+
+    // Live mutex by registry name (vQueueAddToRegistry), nullptr if none
+    static const LockStats* findLock(const char* name) {
+        std::lock_guard<std::mutex> guard(state().mutex);
+        for (LockStats* lock : state().slots) {
+            if (lock && strcmp(lock->name, name) == 0) return lock;
+        }
+        return nullptr;
+    }
+
+    static void onAcquired(LockStats& lock) {
+        Held& held = heldStack();
+        if (isEnabled()) {
+            for (uint8_t i = 0; i < held.depth; i++) {
+                checkPair(*held.locks[i], lock);
+            }
+        }
+        if (held.depth < MAX_HELD) {
+            held.locks[held.depth] = &lock;
+            held.since[held.depth] = std::chrono::steady_clock::now();
+            held.depth++;
+        }
+    }
+
+    static void onReleased(LockStats& lock) {
+        Held& held = heldStack();
+        for (int i = held.depth - 1; i >= 0; i--) {   // Releases may be out of order
+            if (held.locks[i] != &lock) continue;
+            auto held_for = std::chrono::steady_clock::now() - held.since[i];
+            lock.hold_us.record(static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(held_for).count()));
+            for (uint8_t j = i; j + 1 < held.depth; j++) {
+                held.locks[j] = held.locks[j + 1];
+                held.since[j] = held.since[j + 1];
+            }
+            held.depth--;
+            return;
+        }
+    }
+
+    static size_t getViolations(LockOrderViolation* out, size_t max_count) {
+        std::lock_guard<std::mutex> guard(state().mutex);
+        size_t count = state().violation_count < max_count ? state().violation_count : max_count;
+        memcpy(out, state().violations, count * sizeof(LockOrderViolation));
+        return count;
+    }
+
+    static uint32_t getViolationTotal() {
+        std::lock_guard<std::mutex> guard(state().mutex);
+        uint32_t total = 0;
+        for (size_t i = 0; i < state().violation_count; i++) {
+            total += state().violations[i].count;
+        }
+        return total;
+    }
+
+    // Forget observed nesting and violations (mutex stats are per object)
+    static void reset() {
+        std::lock_guard<std::mutex> guard(state().mutex);
+        memset(state().edges, 0, sizeof(state().edges));
+        state().violation_count = 0;
+    }
+
+private:
+    struct Held {
+        LockStats* locks[MAX_HELD];
+        std::chrono::steady_clock::time_point since[MAX_HELD];
+        uint8_t depth = 0;
+    };
+
+    struct State {
+        std::atomic<bool> enabled{false};
+        std::mutex mutex;
+        LockStats* slots[MAX_LOCKS] = {};
+        bool edges[MAX_LOCKS][MAX_LOCKS] = {};   // [held][acquired] seen nested
+        LockOrderViolation violations[MAX_VIOLATIONS];
+        size_t violation_count = 0;
+    };
+
+    static State& state() {
+        static State s;
+        return s;
+    }
+
+    static Held& heldStack() {
+        static thread_local Held held;
+        return held;
+    }
+
+    static void checkPair(const LockStats& held, const LockStats& acquired) {
+        if (&held == &acquired || held.id >= MAX_LOCKS || acquired.id >= MAX_LOCKS) return;
+
+        bool ranked = held.rank >= 0 && acquired.rank >= 0 && acquired.rank < held.rank;
+
+        std::lock_guard<std::mutex> guard(state().mutex);
+        state().edges[held.id][acquired.id] = true;
+        bool inverted = state().edges[acquired.id][held.id];
+
+        if (ranked || inverted) {
+            addViolation(held, acquired, ranked);
+        }
+    }
+
+    static void addViolation(const LockStats& held, const LockStats& acquired, bool ranked) {
+        State& s = state();
+        for (size_t i = 0; i < s.violation_count; i++) {
+            LockOrderViolation& v = s.violations[i];
+            if (v.ranked == ranked && strcmp(v.held, held.name) == 0 &&
+                strcmp(v.acquired, acquired.name) == 0) {
+                v.count++;
+                return;
+            }
+        }
+        if (s.violation_count >= MAX_VIOLATIONS) return;
+
+        LockOrderViolation& v = s.violations[s.violation_count++];
+        strncpy(v.held, held.name, sizeof(v.held) - 1);
+        v.held[sizeof(v.held) - 1] = '\0';
+        strncpy(v.acquired, acquired.name, sizeof(v.acquired) - 1);
+        v.acquired[sizeof(v.acquired) - 1] = '\0';
+        const char* task = t_current ? t_current->name : "main";
+        strncpy(v.task, task, sizeof(v.task) - 1);
+        v.task[sizeof(v.task) - 1] = '\0';
+        v.ranked = ranked;
+        v.count = 1;
+    }
+};
+
+}  // namespace freertos_shim
+
+#endif // NATIVE_FREERTOS_SYNC_MONITOR_H
@@ -0,0 +1,213 @@
+#ifndef NATIVE_FREERTOS_TASK_SHIM_H
+#define NATIVE_FREERTOS_TASK_SHIM_H
+
+/**
+ * FreeRTOS task API on pthreads (host replay scheduler)
+ *
+ * Each task runs on its own pthread with a caller-provided stack that is
+ * painted with the FreeRTOS fill byte (0xA5) before the thread starts, so
+ * uxTaskGetStackHighWaterMark() works the same way as on the device.
+ *
+ * Stack sizes: the requested depth is in bytes (ESP-IDF convention). Host
+ * frames are larger (64-bit pointers, no windowed registers), so the real
+ * stack is NATIVE_STACK_SCALE times bigger and high-water marks are
+ * divided back down. Numbers from host replays are therefore estimates for
+ * comparing scenarios, not a substitute for on-device measurements.
+ */
+
+#include "FreeRTOS.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef NATIVE_STACK_SCALE
+#define NATIVE_STACK_SCALE 4
+#endif
+
+typedef void (*TaskFunction_t)(void*);
+
+namespace freertos_shim {
+
+constexpr uint8_t STACK_FILL_BYTE = 0xA5;
+
+struct Task {
+    pthread_t thread;
+    uint8_t* stack;            // Lowest address (stack grows down)
+    size_t stack_bytes;        // Host stack size (scaled)
+    uint32_t requested_bytes;  // Depth requested by the caller
+    TaskFunction_t function;
+    void* param;
+    char name[16];
+    UBaseType_t priority;
+    BaseType_t core;
+    std::atomic<bool> finished{false};
+};
+
+inline thread_local Task* t_current = nullptr;
+inline std::mutex g_tasks_mutex;
+inline std::vector<Task*> g_tasks;
+
+inline void* taskEntry(void* arg) {
+    Task* task = static_cast<Task*>(arg);
+    t_current = task;
+    task->function(task->param);
+    task->finished = true;  // Task returned without vTaskDelete (not allowed on device)
+    return nullptr;
+}
+
+/**
+ * Join every task that has finished or deleted itself, free their stacks.
+ * Tasks still running are left alone. Returns number of tasks still alive.
+ */
+inline size_t reapTasks() {
+    std::lock_guard<std::mutex> lock(g_tasks_mutex);
+    size_t alive = 0;
+    for (auto it = g_tasks.begin(); it != g_tasks.end();) {
+        Task* task = *it;
+        if (task->finished) {
+            pthread_join(task->thread, nullptr);
+            free(task->stack);
+            delete task;
+            it = g_tasks.erase(it);
+        } else {
+            alive++;
+            ++it;
+        }
+    }
+    return alive;
+}
+
+/**
+ * Wait until every task has finished (or timeout). Returns true if all done.
+ */
+inline bool waitForAllTasks(uint32_t timeout_ms = 5000) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (reapTasks() > 0) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}  // namespace freertos_shim
+
+typedef freertos_shim::Task* TaskHandle_t;
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name,
+                                          uint32_t stack_depth, void* param,
+                                          UBaseType_t priority, TaskHandle_t* handle,
+                                          BaseType_t core) {
+    using namespace freertos_shim;
+
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t bytes = static_cast<size_t>(stack_depth) * NATIVE_STACK_SCALE;
+    if (bytes < static_cast<size_t>(PTHREAD_STACK_MIN)) bytes = static_cast<size_t>(PTHREAD_STACK_MIN);
+    bytes = (bytes + page - 1) / page * page;
+
+    uint8_t* stack = static_cast<uint8_t*>(aligned_alloc(page, bytes));
+    if (!stack) return pdFAIL;
+    memset(stack, STACK_FILL_BYTE, bytes);  // Paint before the thread touches it
+
+    Task* task = new Task();
+    task->stack = stack;
+    task->stack_bytes = bytes;
+    task->requested_bytes = stack_depth;
+    task->function = function;
+    task->param = param;
+    strncpy(task->name, name ? name : "", sizeof(task->name) - 1);
+    task->priority = priority;
+    task->core = core;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, bytes);
+
+    {
+        std::lock_guard<std::mutex> lock(g_tasks_mutex);
+        if (pthread_create(&task->thread, &attr, taskEntry, task) != 0) {
+            pthread_attr_destroy(&attr);
+            free(stack);
+            delete task;
+            return pdFAIL;
+        }
+        g_tasks.push_back(task);
+    }
+    pthread_attr_destroy(&attr);
+
+    if (handle) *handle = task;
+    return pdPASS;
+}
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return freertos_shim::t_current;
+}
+
+inline char* pcTaskGetName(TaskHandle_t task) {
+    static char main_name[] = "main";
+    if (!task) task = freertos_shim::t_current;
+    return task ? task->name : main_name;
+}
+
+/**
+ * Free stack in bytes at the deepest point reached so far (device units).
+ * Returns 0 for the host main thread (not created through the shim).
+ */
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    if (!task) task = freertos_shim::t_current;
+    if (!task) return 0;
+
+    size_t untouched = 0;
+    while (untouched < task->stack_bytes &&
+           task->stack[untouched] == freertos_shim::STACK_FILL_BYTE) {
+        untouched++;
+    }
+    return static_cast<UBaseType_t>(untouched / NATIVE_STACK_SCALE);
+}
+
+inline UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+    if (!task) task = freertos_shim::t_current;
+    return task ? task->priority : 1;
+}
+
+inline UBaseType_t uxTaskGetNumberOfTasks() {
+    std::lock_guard<std::mutex> lock(freertos_shim::g_tasks_mutex);
+    return static_cast<UBaseType_t>(freertos_shim::g_tasks.size());
+}
+
+inline BaseType_t xPortGetCoreID() {
+    TaskHandle_t task = freertos_shim::t_current;
+    return (task && task->core != tskNO_AFFINITY) ? task->core : 0;
+}
+
+inline void vTaskDelay(TickType_t ticks) {
+    if (ticks == 0) {
+        sched_yield();
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+/**
+ * Only self-deletion (vTaskDelete(NULL)) is supported, which is the only
+ * form used in this project. The pthread exits; reapTasks() frees it.
+ */
+inline void vTaskDelete(TaskHandle_t task) {
+    TaskHandle_t self = freertos_shim::t_current;
+    if (task == nullptr || task == self) {
+        if (self) {
+            self->finished = true;
+            pthread_exit(nullptr);
+        }
+    }
+}
+
+#endif // NATIVE_FREERTOS_TASK_SHIM_H
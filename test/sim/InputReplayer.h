@@ -0,0 +1,341 @@
+#ifndef INPUT_REPLAYER_H
+#define INPUT_REPLAYER_H
+
+#include <Arduino.h>
+#include <M5Unified.h>
+#include <Preferences.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "../../src/core/Config.h"
+#include "../../src/core/PomodoroSequence.h"
+#include "../../src/core/Statistics.h"
+#include "../../src/core/SyncPrimitives.h"
+#include "../../src/core/TimerStateMachine.h"
+#include "../../src/ui/Renderer.h"
+#include "../../src/ui/ScreenManager.h"
+#include "../../src/utils/InputTrace.h"
+#include "../mocks/MockAudioPlayer.h"
+#include "../mocks/MockHapticController.h"
+#include "../mocks/MockLEDController.h"
+
+/**
+ * Deterministic UI replay of a recorded input trace (host only)
+ *
+ * Feeds an InputTrace recording into the real UI stack - ScreenManager,
+ * screens, widgets, Renderer, TimerStateMachine, PomodoroSequence - built
+ * against the M5Unified shim, and measures what each input costs. A real
+ * usage session captured on the device becomes a repeatable benchmark:
+ * replay the same trace before and after a UI change and compare.
+ *
+ * Loop model (mirrors UITask):
+ * - Virtual clock (arduino_shim::setMillis) at trace time, nothing sleeps
+ * - Each loop iteration: M5.update(), handleHardwareButtons(), touch
+ *   detail → handleTouch(); one trace event is injected per iteration
+ *   through M5.BtnX.press() / M5.Touch.press()/release()
+ * - Frame every frame_ms: ScreenManager::update, LED/haptic/audio update,
+ *   draw(), Renderer::update()
+ * - Status bar update every second (fixed battery, clock from trace time)
+ * - Timeout callback applies the main.cpp auto-start policy
+ *
+ * Measurements (host wall clock, std::chrono::steady_clock):
+ * - Frame cost for every frame; redraw = frame that pushed to M5.Display
+ * - Per event: handler cost, wait until the next frame (virtual ms), cost
+ *   of that frame and whether it redrew
+ *
+ * Host microseconds are only comparable with other host runs. Redraw
+ * counts, pixels pushed and the virtual wait are deterministic: the same
+ * trace always produces the same values.
+ *
+ * IMU gestures are counted but not applied: no UI code consumes
+ * GyroController gestures yet.
+ *
+ * Usage:
+ *   InputTrace::Reader reader(data, len);
+ *   InputReplayer replayer;
+ *   auto report = replayer.run(reader);
+ *   report.print();
+ */
+class InputReplayer {
+public:
+    using Clock = std::chrono::steady_clock;
+    using EventType = InputTrace::EventType;
+
+    static constexpr uint8_t EVENT_TYPES = 6;   // Indexed by EventType value
+
+    struct Options {
+        Config::PomodoroSettings pomodoro;
+        uint16_t frame_ms = 33;                 // UITask frame interval
+        uint32_t tail_ms = 1000;                // Keep running after the last event
+    };
+
+    struct EventResult {
+        InputTrace::Event event;
+        uint32_t handle_us;                     // Button / touch handler cost
+        uint32_t wait_ms;                       // Virtual time until the next frame
+        uint32_t frame_us;                      // Cost of that frame
+        bool redrawn;                           // That frame pushed to the display
+        bool applied;                           // False for IMU gestures
+    };
+
+    struct TypeStats {
+        uint32_t count;
+        uint32_t redrawn;
+        uint64_t handle_us_sum;
+        uint32_t handle_us_max;
+        uint64_t latency_us_sum;                // wait + handler + frame
+        uint32_t latency_us_max;
+    };
+
+    struct Report {
+        uint32_t duration_ms = 0;
+        uint32_t frames = 0;
+        uint32_t redraw_frames = 0;
+        uint64_t pixels_pushed = 0;
+        uint32_t frame_us_p50 = 0;
+        uint32_t frame_us_p99 = 0;
+        uint32_t frame_us_max = 0;
+        uint32_t redraw_us_p50 = 0;             // Frames that pushed only
+        uint32_t redraw_us_max = 0;
+        TypeStats per_type[EVENT_TYPES] = {};
+        std::vector<EventResult> events;
+        ScreenID final_screen = ScreenID::MAIN;
+        TimerStateMachine::State final_state = TimerStateMachine::State::IDLE;
+
+        void print() const {
+            static const char* names[EVENT_TYPES] = {"", "touch_down", "touch_up", "button", "imu", "gap"};
+            printf("\n=== Input Replay: %lu events, %.1f s ===\n",
+                   (unsigned long)events.size(), duration_ms / 1000.0);
+            printf("Frames: %lu, redraws: %lu, pixels pushed: %llu\n",
+                   (unsigned long)frames, (unsigned long)redraw_frames,
+                   (unsigned long long)pixels_pushed);
+            printf("Frame cost: p50 %lu us, p99 %lu us, max %lu us (redraw p50 %lu us, max %lu us)\n",
+                   (unsigned long)frame_us_p50, (unsigned long)frame_us_p99,
+                   (unsigned long)frame_us_max, (unsigned long)redraw_us_p50,
+                   (unsigned long)redraw_us_max);
+            printf("%-11s %6s %8s %12s %12s %14s %14s\n",
+                   "event", "count", "redrawn", "handle avg", "handle max", "latency avg", "latency max");
+            for (uint8_t t = 1; t < EVENT_TYPES; t++) {
+                const TypeStats& s = per_type[t];
+                if (s.count == 0) continue;
+                printf("%-11s %6lu %8lu %9lu us %9lu us %11lu us %11lu us\n", names[t],
+                       (unsigned long)s.count, (unsigned long)s.redrawn,
+                       (unsigned long)(s.handle_us_sum / s.count), (unsigned long)s.handle_us_max,
+                       (unsigned long)(s.latency_us_sum / s.count), (unsigned long)s.latency_us_max);
+            }
+            if (per_type[static_cast<uint8_t>(EventType::IMU_GESTURE)].count > 0) {
+                printf("(imu gestures recorded but not consumed by the UI)\n");
+            }
+        }
+    };
+
+    InputReplayer() = default;
+    explicit InputReplayer(const Options& options) : options_(options) {}
+
+    Report run(InputTrace::Reader& reader) {
+        preferences_shim::clearAll();   // Settings saved during one replay must not leak into the next
+        initSyncPrimitives();
+        arduino_shim::setMillis(0);
+        M5.Display.resetCounters();
+        M5.update();                    // Drop inputs left over from a previous run
+
+        Report report;
+        {
+            Harness ui(options_.pomodoro);
+            replay(reader, ui, report);
+            report.final_screen = ui.screens.getCurrentScreen();
+            report.final_state = ui.timer.getState();
+        }
+
+        cleanupSyncPrimitives();
+        return report;
+    }
+
+private:
+    // Everything main.cpp wires up for the UI task, with mock hardware
+    struct Harness {
+        PomodoroSequence sequence;
+        TimerStateMachine timer;
+        Statistics statistics;
+        Config config;
+        MockLEDController leds;
+        MockHapticController haptic;
+        MockAudioPlayer audio;
+        Renderer renderer;
+        bool configured;     // Config loaded before the screens read it (main.cpp order)
+        ScreenManager screens;
+
+        explicit Harness(const Config::PomodoroSettings& pomodoro)
+            : timer(sequence),
+              configured(configure(pomodoro)),
+              screens(timer, sequence, statistics, config, leds, haptic) {
+            renderer.begin();
+        }
+
+        bool configure(const Config::PomodoroSettings& pomodoro) {
+            config.begin();
+            config.setPomodoro(pomodoro);
+            statistics.begin();
+
+            sequence.setSessionsBeforeLong(pomodoro.sessions_before_long);
+            sequence.setNumCycles(pomodoro.num_cycles);
+            sequence.setWorkDuration(pomodoro.work_duration_min);
+            sequence.setShortBreakDuration(pomodoro.short_break_min);
+            sequence.setLongBreakDuration(pomodoro.long_break_min);
+
+            timer.setLEDController(&leds);
+            timer.setHapticController(&haptic);
+            timer.onAudioEvent([this](const char* name) {
+                if (strcmp(name, "work_start") == 0) audio.play(IAudioPlayer::Sound::WORK_START);
+                else if (strcmp(name, "rest_start") == 0) audio.play(IAudioPlayer::Sound::REST_START);
+                else if (strcmp(name, "long_rest_start") == 0) audio.play(IAudioPlayer::Sound::LONG_REST_START);
+                else if (strcmp(name, "warning") == 0) audio.play(IAudioPlayer::Sound::WARNING);
+            });
+            timer.onTimeout([this]() {
+                bool work = sequence.getCurrentSession().type == PomodoroSequence::SessionType::WORK;
+                if (config.getPomodoro().shouldAutoStart(work)) {
+                    timer.handleEvent(TimerStateMachine::Event::START);
+                } else {
+                    timer.indicateSessionReady();
+                }
+            });
+            return true;
+        }
+    };
+
+    Options options_;
+
+    static uint32_t elapsedUs(Clock::time_point start) {
+        return static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+    }
+
+    static uint32_t percentile(std::vector<uint32_t>& values, uint32_t pct) {
+        if (values.empty()) return 0;
+        size_t index = (values.size() - 1) * pct / 100;
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    static void inject(const InputTrace::Event& event) {
+        switch (event.type) {
+            case EventType::TOUCH_DOWN: M5.Touch.press(event.x, event.y); break;
+            case EventType::TOUCH_UP: M5.Touch.release(event.x, event.y); break;
+            case EventType::BUTTON:
+                if (event.arg == InputTrace::BUTTON_A) M5.BtnA.press();
+                else if (event.arg == InputTrace::BUTTON_B) M5.BtnB.press();
+                else if (event.arg == InputTrace::BUTTON_C) M5.BtnC.press();
+                break;
+            default:
+                break;   // IMU gestures: no consumer
+        }
+    }
+
+    void replay(InputTrace::Reader& reader, Harness& ui, Report& report) {
+        std::vector<uint32_t> frame_us;
+        std::vector<uint32_t> redraw_us;
+        size_t awaiting = 0;   // First event not yet resolved by a frame
+
+        InputTrace::Event next;
+        bool have_next = reader.next(next);
+        uint32_t end_ms = options_.tail_ms;
+        uint32_t now = 0, last_frame = 0, last_second = 0;
+
+        while (have_next || now < end_ms) {
+            // Next loop iteration: the next event or the next frame, whichever comes first
+            uint32_t wake = last_frame + options_.frame_ms;
+            if (have_next && next.t_ms < wake) wake = std::max(now, next.t_ms);
+            now = wake;
+            arduino_shim::setMillis(now);
+
+            // Input (UITask: M5.update → buttons → touch detail)
+            bool injected = false;
+            EventResult result = {};
+            if (have_next && next.t_ms <= now) {
+                result.event = next;
+                result.applied = next.type != EventType::IMU_GESTURE;
+                inject(next);
+                injected = true;
+                end_ms = next.t_ms + options_.tail_ms;
+                have_next = reader.next(next);
+            }
+
+            auto input_start = Clock::now();
+            M5.update();
+            ui.screens.handleHardwareButtons();
+            auto touch = M5.Touch.getDetail();
+            if (touch.wasPressed()) ui.screens.handleTouch(touch.x, touch.y, true);
+            if (touch.wasReleased()) ui.screens.handleTouch(touch.x, touch.y, false);
+            if (injected) {
+                result.handle_us = elapsedUs(input_start);
+                result.wait_ms = now;   // Frame time subtracted when resolved
+                report.events.push_back(result);
+            }
+
+            // Frame (UITask: update → LEDs/haptics/audio → draw → push)
+            if (now - last_frame >= options_.frame_ms) {
+                uint32_t delta = now - last_frame;
+                last_frame = now;
+                uint32_t pushes = M5.Display.pushCount();
+
+                auto frame_start = Clock::now();
+                ui.screens.update(delta);
+                ui.audio.update();
+                ui.leds.update();
+                ui.haptic.update();
+                ui.screens.draw(ui.renderer);
+                ui.renderer.update();
+                uint32_t cost = elapsedUs(frame_start);
+
+                bool redrawn = M5.Display.pushCount() != pushes;
+                report.frames++;
+                frame_us.push_back(cost);
+                if (redrawn) {
+                    report.redraw_frames++;
+                    redraw_us.push_back(cost);
+                }
+
+                for (; awaiting < report.events.size(); awaiting++) {
+                    EventResult& e = report.events[awaiting];
+                    e.wait_ms = now - e.wait_ms;
+                    e.frame_us = cost;
+                    e.redrawn = redrawn;
+                }
+            }
+
+            // Status bar (UITask: once per second)
+            if (now - last_second >= 1000) {
+                last_second = now;
+                uint32_t minutes = 9 * 60 + now / 60000;   // Trace starts at 09:00
+                ui.screens.updateStatus(80, false, false, "IDLE",
+                                        static_cast<uint8_t>((minutes / 60) % 24),
+                                        static_cast<uint8_t>(minutes % 60));
+            }
+        }
+
+        report.duration_ms = now;
+        report.pixels_pushed = M5.Display.pixelsPushed();
+
+        for (const EventResult& e : report.events) {
+            TypeStats& s = report.per_type[static_cast<uint8_t>(e.event.type) % EVENT_TYPES];
+            uint32_t latency = e.wait_ms * 1000 + e.handle_us + e.frame_us;
+            s.count++;
+            s.redrawn += e.redrawn ? 1 : 0;
+            s.handle_us_sum += e.handle_us;
+            s.handle_us_max = std::max(s.handle_us_max, e.handle_us);
+            s.latency_us_sum += latency;
+            s.latency_us_max = std::max(s.latency_us_max, latency);
+        }
+
+        report.frame_us_p50 = percentile(frame_us, 50);
+        report.frame_us_p99 = percentile(frame_us, 99);
+        report.frame_us_max = frame_us.empty() ? 0 : *std::max_element(frame_us.begin(), frame_us.end());
+        report.redraw_us_p50 = percentile(redraw_us, 50);
+        report.redraw_us_max = redraw_us.empty() ? 0 : *std::max_element(redraw_us.begin(), redraw_us.end());
+    }
+};
+
+#endif // INPUT_REPLAYER_H
@@ -0,0 +1,203 @@
+#ifndef MOCK_API_SERVER_H
+#define MOCK_API_SERVER_H
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Scripted HTTP/1.1 API server on 127.0.0.1 (host tests)
+ *
+ * Stands in for api.track.toggl.com / www.googleapis.com behind a
+ * LoopbackTransport. One background thread serves one connection at a
+ * time with keep-alive: requests (Content-Length bodies) are recorded with
+ * the index of the connection they came on, and answered by the test's
+ * handler.
+ *
+ * Reply options:
+ * - chunked: body sent as two HTTP chunks
+ * - close: "Connection: close" and close after the reply
+ * - drop_after: close after the reply without saying so (stale keep-alive)
+ *
+ * Usage:
+ *   MockApiServer api([](const MockApiServer::Request& req) {
+ *       return MockApiServer::Reply{201, "{\"id\":1}"};
+ *   });
+ *   LoopbackTransport transport(api.port());
+ */
+class MockApiServer {
+public:
+    struct Request {
+        std::string method;
+        std::string path;
+        std::string headers;
+        std::string body;
+        size_t connection;       // 1-based connection index
+    };
+
+    struct Reply {
+        int status = 200;
+        std::string body;
+        bool chunked = false;
+        bool close = false;
+        bool drop_after = false;
+    };
+
+    using Handler = std::function<Reply(const Request&)>;
+
+    explicit MockApiServer(Handler handler) : handler_(std::move(handler)) {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        listen(listen_fd_, 4);
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~MockApiServer() {
+        stop_.store(true);
+        thread_.join();
+        close(listen_fd_);
+    }
+
+    uint16_t port() const { return port_; }
+
+    void setHandler(Handler handler) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handler_ = std::move(handler);
+    }
+
+    std::vector<Request> requests() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_;
+    }
+
+    size_t connections() const { return connections_.load(); }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests_.clear();
+        connections_.store(0);
+    }
+
+private:
+    static constexpr int POLL_MS = 20;
+
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+    std::atomic<size_t> connections_{0};
+    mutable std::mutex mutex_;
+    Handler handler_;
+    std::vector<Request> requests_;
+
+    bool wait(int fd) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        while (!stop_.load()) {
+            if (::poll(&pfd, 1, POLL_MS) > 0) return true;
+        }
+        return false;
+    }
+
+    void run() {
+        while (wait(listen_fd_)) {
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) continue;
+            size_t index = connections_.fetch_add(1) + 1;
+            serve(fd, index);
+            close(fd);
+        }
+    }
+
+    // Keep-alive loop: one request after the other until the client closes
+    void serve(int fd, size_t index) {
+        std::string buffer;
+        char chunk[2048];
+        while (true) {
+            size_t head_end;
+            while ((head_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                if (!wait(fd)) return;
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) return;
+                buffer.append(chunk, n);
+            }
+
+            Request request;
+            request.connection = index;
+            std::string head = buffer.substr(0, head_end + 2);
+            size_t line_end = head.find("\r\n");
+            std::string line = head.substr(0, line_end);
+            size_t sp1 = line.find(' ');
+            size_t sp2 = line.find(' ', sp1 + 1);
+            request.method = line.substr(0, sp1);
+            request.path = line.substr(sp1 + 1, sp2 - sp1 - 1);
+            request.headers = head.substr(line_end + 2);
+
+            size_t length = 0;
+            const char* cl = strcasestr(request.headers.c_str(), "Content-Length:");
+            if (cl) length = strtoul(cl + 15, nullptr, 10);
+            while (buffer.size() < head_end + 4 + length) {
+                if (!wait(fd)) return;
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) return;
+                buffer.append(chunk, n);
+            }
+            request.body = buffer.substr(head_end + 4, length);
+            buffer.erase(0, head_end + 4 + length);
+
+            Reply reply;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                requests_.push_back(request);
+                reply = handler_(request);
+            }
+            sendReply(fd, reply);
+            if (reply.close || reply.drop_after) return;
+        }
+    }
+
+    static void sendReply(int fd, const Reply& reply) {
+        char head[256];
+        std::string out;
+        if (reply.chunked) {
+            snprintf(head, sizeof(head), "HTTP/1.1 %d Mock\r\nTransfer-Encoding: chunked\r\n%s\r\n",
+                     reply.status, reply.close ? "Connection: close\r\n" : "");
+            out = head;
+            size_t half = reply.body.size() / 2;
+            const std::string parts[2] = {reply.body.substr(0, half), reply.body.substr(half)};
+            for (const std::string& part : parts) {
+                if (part.empty()) continue;
+                snprintf(head, sizeof(head), "%zx\r\n", part.size());
+                out += head + part + "\r\n";
+            }
+            out += "0\r\n\r\n";
+        } else {
+            snprintf(head, sizeof(head), "HTTP/1.1 %d Mock\r\nContent-Length: %zu\r\n%s\r\n",
+                     reply.status, reply.body.size(), reply.close ? "Connection: close\r\n" : "");
+            out = head + reply.body;
+        }
+        send(fd, out.data(), out.size(), MSG_NOSIGNAL);
+    }
+};
+
+#endif // MOCK_API_SERVER_H
@@ -0,0 +1,145 @@
+#ifndef NVS_LIFETIME_SIM_H
+#define NVS_LIFETIME_SIM_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "PomodoroSimulator.h"
+#include "../../src/core/Config.h"
+#include "../../src/core/Statistics.h"
+#include "../../src/core/SyncPrimitives.h"
+#include "../../src/utils/NvsAccounting.h"
+
+/**
+ * Flash lifetime projection from a simulated usage profile (host only)
+ *
+ * Replays days of use through the real Config and Statistics code (via
+ * NvsPreferences → NvsAccounting) and reports the NVS writes, page erases
+ * and projected flash lifetime of the `nvs` partition:
+ * - Sessions per day come from PomodoroSimulator (same scripted user)
+ * - Each completed work session / break / pause / stop becomes the
+ *   Statistics::record*() call it should produce
+ * - Settings changes: Config::save() after changing one value
+ * - The wall clock (arduino_shim::setEpoch) advances one day at a time, so
+ *   Statistics rolls over to a new day_N key like on the device
+ *
+ * Compare storage changes by running the same profile before and after and
+ * comparing page_erases / projection.years.
+ *
+ * Usage:
+ *   NvsLifetimeSim::UsageProfile profile;
+ *   NvsLifetimeSim sim(profile);
+ *   auto result = sim.run(365);
+ *   result.print();
+ */
+class NvsLifetimeSim {
+public:
+    struct UsageProfile {
+        PomodoroSimulator::SimConfig day;          // Timer settings + scripted user
+        uint8_t active_days_per_week = 5;          // Remaining days: device idle
+        uint8_t settings_saves_per_week = 2;       // Settings screen "save"
+        uint32_t partition_size = NvsAccounting::DEFAULT_PARTITION_SIZE;
+    };
+
+    struct Result {
+        uint32_t days = 0;
+        uint32_t stats_records = 0;                // Statistics::record*() calls
+        uint32_t config_saves = 0;
+        NvsAccounting::Totals totals = {};
+        NvsAccounting::LifetimeProjection projection = {};
+
+        void print() const {
+            printf("\n=== NVS Lifetime Projection (%lu days) ===\n", (unsigned long)days);
+            printf("Statistics records: %lu, config saves: %lu\n",
+                   (unsigned long)stats_records, (unsigned long)config_saves);
+            printf("Writes: %lu (%lu skipped), entries: %lu, bytes: %lu\n",
+                   (unsigned long)totals.writes, (unsigned long)totals.skipped,
+                   (unsigned long)totals.entries, (unsigned long)totals.bytes);
+            printf("GC: %lu page erases, %lu entries relocated\n",
+                   (unsigned long)totals.page_erases, (unsigned long)totals.relocated);
+            printf("Erases/day: %.3f, worst page: %.4f/day -> %.0f years\n",
+                   projection.erases_per_day, projection.worst_page_erases_per_day,
+                   projection.years);
+        }
+    };
+
+    explicit NvsLifetimeSim(const UsageProfile& profile) : profile_(profile) {}
+
+    Result run(uint32_t days) {
+        preferences_shim::clearAll();
+        NvsAccounting::begin(profile_.partition_size);
+        initSyncPrimitives();
+
+        Result result;
+        result.days = days;
+        {
+            PomodoroSimulator simulator(profile_.day);
+            Config config;
+            Statistics statistics;
+
+            arduino_shim::setEpoch(EPOCH_START);
+            config.begin();
+            statistics.begin();
+
+            uint32_t save_credit = 0;
+            for (uint32_t day = 0; day < days; day++) {
+                arduino_shim::setEpoch(EPOCH_START + static_cast<int64_t>(day) * 86400);
+
+                if (day % 7 < profile_.active_days_per_week) {
+                    result.stats_records += recordDay(statistics, simulator.runDay(day));
+                }
+
+                // Spread settings saves evenly over the week
+                save_credit += profile_.settings_saves_per_week;
+                while (save_credit >= 7) {
+                    save_credit -= 7;
+                    changeSetting(config, result.config_saves);
+                    config.save();
+                    result.config_saves++;
+                }
+            }
+
+            result.totals = NvsAccounting::getTotals();
+            result.projection = NvsAccounting::projectLifetime(static_cast<float>(days));
+        }
+
+        arduino_shim::setEpoch(0);
+        cleanupSyncPrimitives();
+        return result;
+    }
+
+private:
+    static constexpr int64_t EPOCH_START = 1735722000;   // 2025-01-01 09:00 UTC
+
+    UsageProfile profile_;
+
+    uint32_t recordDay(Statistics& statistics, const PomodoroSimulator::DayReport& day) {
+        const auto& pomodoro = profile_.day.pomodoro;
+        uint32_t records = 0;
+
+        for (uint32_t i = 0; i < day.work_completed; i++, records++) {
+            statistics.recordWorkSession(pomodoro.work_duration_min, true);
+        }
+        for (uint32_t i = 0; i < day.breaks_completed; i++, records++) {
+            statistics.recordBreakSession(pomodoro.short_break_min);
+        }
+        for (uint32_t i = 0; i < day.pauses + day.stops; i++, records++) {
+            statistics.recordInterruption();
+        }
+        return records;
+    }
+
+    // One value changes per save (brightness / volume alternate)
+    static void changeSetting(Config& config, uint32_t n) {
+        Config::UISettings ui = config.getUI();
+        if (n % 2 == 0) {
+            ui.brightness = ui.brightness == 80 ? 60 : 80;
+        } else {
+            ui.sound_volume = ui.sound_volume == 70 ? 50 : 70;
+        }
+        config.setUI(ui);
+    }
+};
+
+#endif // NVS_LIFETIME_SIM_H
@@ -0,0 +1,496 @@
+#ifndef POMODORO_SIMULATOR_H
+#define POMODORO_SIMULATOR_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <string.h>
+#include "../../src/core/Config.h"
+#include "../../src/core/PomodoroSequence.h"
+#include "../../src/core/TimerStateMachine.h"
+#include "../mocks/MockLEDController.h"
+#include "../mocks/MockHapticController.h"
+
+/**
+ * Virtual-time simulator for TimerStateMachine + PomodoroSequence (host only)
+ *
+ * Drives the real state machine and sequence through whole simulated days
+ * with a scripted user, on a virtual clock (arduino_shim::setMillis), with
+ * mock LED and haptic controllers attached. Nothing sleeps.
+ *
+ * Timing model (matches MainScreen on the device):
+ * - The UI frame grid is fixed at frame_ms; every frame calls
+ *   update(frame_ms), then applies the user actions that are due
+ * - The timeout callback applies the same auto-start policy as main.cpp
+ *   (Config::PomodoroSettings::shouldAutoStart), otherwise shows the
+ *   session-ready indicator and the user starts the session manually
+ *
+ * Fast mode (default) skips idle frames and collapses runs of active frames
+ * into one update(n × frame_ms) call. Runs are split at the frame where the
+ * 30s warning window opens and at the timeout frame, so every callback fires
+ * on the same frame as with per-frame stepping - only update_calls differs.
+ * Set exact_frames to step every frame of the day (slow, for cross-checks).
+ * frame_ms must be below 1000 (the warning window is one second wide).
+ *
+ * Scripted user, per day:
+ * - Works between day_start_min and day_end_min (STOP at day end)
+ * - Manual starts after a random delay (start_delay_min_s..max_s)
+ * - Per session, at most one interruption: STOP (stop_pct), SKIP of a break
+ *   (skip_break_pct) or PAUSE for pause_min_s..pause_max_s (pause_pct)
+ * - Randomness is a seeded xorshift per (seed, day): same seed, same days
+ *
+ * Usage:
+ *   PomodoroSimulator::SimConfig cfg;
+ *   cfg.pomodoro.auto_start_work = true;
+ *   PomodoroSimulator sim(cfg);
+ *   auto summary = sim.run(1000);
+ *   summary.print();
+ */
+class PomodoroSimulator {
+public:
+    using State = TimerStateMachine::State;
+    using Event = TimerStateMachine::Event;
+
+    struct UserBehaviour {
+        uint16_t day_start_min = 9 * 60;     // 09:00
+        uint16_t day_end_min = 17 * 60;      // 17:00
+        uint16_t start_delay_min_s = 5;      // Manual start reaction time
+        uint16_t start_delay_max_s = 120;
+        uint8_t pause_pct = 20;              // Chance a session gets paused
+        uint16_t pause_min_s = 30;
+        uint16_t pause_max_s = 600;
+        uint8_t skip_break_pct = 10;         // Chance a break gets skipped
+        uint8_t stop_pct = 3;                // Chance a session gets stopped
+    };
+
+    struct SimConfig {
+        Config::PomodoroSettings pomodoro;
+        UserBehaviour user;
+        uint16_t frame_ms = 33;              // UI task frame (~30 FPS)
+        uint32_t seed = 1;
+        bool exact_frames = false;
+    };
+
+    static constexpr uint8_t STATE_COUNT = 3;
+
+    /**
+     * Per-day counters. Everything except update_calls must be identical
+     * between fast and exact mode.
+     */
+    struct DayReport {
+        uint32_t transitions[STATE_COUNT][STATE_COUNT];  // [from][to]
+        uint32_t events_accepted;
+        uint32_t events_rejected;
+
+        uint32_t work_completed;         // TIMEOUT of a work session
+        uint32_t breaks_completed;
+        uint32_t cycles_completed;
+        uint32_t auto_starts;
+        uint32_t manual_starts;
+        uint32_t pauses;
+        uint32_t skips;
+        uint32_t stops;
+        uint32_t completed_today;        // PomodoroSequence counter at day end
+
+        // Callback fan-out
+        uint32_t state_callbacks;
+        uint32_t timeout_callbacks;
+        uint32_t audio_work_start;
+        uint32_t audio_rest_start;
+        uint32_t audio_long_rest_start;
+        uint32_t audio_warning;
+        uint32_t led_state_patterns;
+        uint32_t led_milestones;
+        uint32_t haptic_triggers;
+
+        // Timing error: active wall time (virtual) minus session duration
+        int64_t timing_error_sum_ms;
+        int32_t timing_error_max_ms;     // Largest |error|
+        uint32_t timed_sessions;
+
+        uint32_t update_calls;
+
+        bool sameAs(const DayReport& o) const {
+            return memcmp(transitions, o.transitions, sizeof(transitions)) == 0 &&
+                   events_accepted == o.events_accepted &&
+                   events_rejected == o.events_rejected &&
+                   work_completed == o.work_completed &&
+                   breaks_completed == o.breaks_completed &&
+                   cycles_completed == o.cycles_completed &&
+                   auto_starts == o.auto_starts &&
+                   manual_starts == o.manual_starts &&
+                   pauses == o.pauses && skips == o.skips && stops == o.stops &&
+                   completed_today == o.completed_today &&
+                   state_callbacks == o.state_callbacks &&
+                   timeout_callbacks == o.timeout_callbacks &&
+                   audio_work_start == o.audio_work_start &&
+                   audio_rest_start == o.audio_rest_start &&
+                   audio_long_rest_start == o.audio_long_rest_start &&
+                   audio_warning == o.audio_warning &&
+                   led_state_patterns == o.led_state_patterns &&
+                   led_milestones == o.led_milestones &&
+                   haptic_triggers == o.haptic_triggers &&
+                   timing_error_sum_ms == o.timing_error_sum_ms &&
+                   timing_error_max_ms == o.timing_error_max_ms &&
+                   timed_sessions == o.timed_sessions;
+        }
+    };
+
+    struct Summary {
+        uint32_t days = 0;
+        DayReport totals = {};
+        int32_t timing_error_max_ms = 0;
+
+        void print() const {
+            if (days == 0) return;
+            printf("=== Pomodoro Simulator: %u days ===\n", (unsigned)days);
+            static const char* names[STATE_COUNT] = {"IDLE", "ACTIVE", "PAUSED"};
+            for (uint8_t from = 0; from < STATE_COUNT; from++) {
+                for (uint8_t to = 0; to < STATE_COUNT; to++) {
+                    if (totals.transitions[from][to] == 0) continue;
+                    printf("  %-6s -> %-6s %8.2f/day\n", names[from], names[to],
+                           perDay(totals.transitions[from][to]));
+                }
+            }
+            printf("  sessions: work %.2f, break %.2f, cycles %.2f/day\n",
+                   perDay(totals.work_completed), perDay(totals.breaks_completed),
+                   perDay(totals.cycles_completed));
+            printf("  starts: auto %.2f, manual %.2f | pause %.2f, skip %.2f, stop %.2f/day\n",
+                   perDay(totals.auto_starts), perDay(totals.manual_starts),
+                   perDay(totals.pauses), perDay(totals.skips), perDay(totals.stops));
+            printf("  events: accepted %.2f, rejected %.2f/day\n",
+                   perDay(totals.events_accepted), perDay(totals.events_rejected));
+            printf("  callbacks/day: state %.2f, timeout %.2f, audio %.2f, led %.2f, haptic %.2f\n",
+                   perDay(totals.state_callbacks), perDay(totals.timeout_callbacks),
+                   perDay(totals.audio_work_start + totals.audio_rest_start +
+                          totals.audio_long_rest_start + totals.audio_warning),
+                   perDay(totals.led_state_patterns + totals.led_milestones),
+                   perDay(totals.haptic_triggers));
+            printf("  timing error: mean %.1f ms, max |%d| ms over %u sessions\n",
+                   totals.timed_sessions ?
+                       (double)totals.timing_error_sum_ms / totals.timed_sessions : 0.0,
+                   (int)timing_error_max_ms, (unsigned)totals.timed_sessions);
+            printf("  update() calls: %.0f/day\n", perDay(totals.update_calls));
+        }
+
+    private:
+        double perDay(uint32_t value) const { return (double)value / days; }
+    };
+
+    explicit PomodoroSimulator(const SimConfig& config)
+        : config_(config), timer_(sequence_) {
+        const auto& pomodoro = config_.pomodoro;
+        sequence_.setSessionsBeforeLong(pomodoro.sessions_before_long);
+        sequence_.setNumCycles(pomodoro.num_cycles);
+        sequence_.setWorkDuration(pomodoro.work_duration_min);
+        sequence_.setShortBreakDuration(pomodoro.short_break_min);
+        sequence_.setLongBreakDuration(pomodoro.long_break_min);
+
+        timer_.setLEDController(&leds_);
+        timer_.setHapticController(&haptic_);
+        timer_.onStateChange([this](State from, State to) { onStateChange(from, to); });
+        timer_.onTimeout([this]() { onTimeout(); });
+        timer_.onAudioEvent([this](const char* name) { onAudio(name); });
+    }
+
+    /**
+     * Simulate one day (day index seeds the RNG together with config.seed)
+     */
+    DayReport runDay(uint32_t day) {
+        timer_.reset();
+        sequence_.reset();
+        sequence_.resetDailyCounter();
+        leds_.reset();
+        haptic_.reset();
+        report_ = DayReport{};
+        rng_ = config_.seed * 0x9E3779B9u ^ (day + 1) * 0x85EBCA6Bu;
+        if (rng_ == 0) rng_ = 1;  // xorshift has no zero state
+        pending_.valid = false;
+        interruption_done_ = false;
+
+        const uint32_t f = config_.frame_ms;
+        const uint32_t day_start = alignToFrame(config_.user.day_start_min * 60000u);
+        const uint32_t day_end = config_.user.day_end_min * 60000u;
+        setNow(day_start);
+
+        while (now_ < day_end) {
+            if (timer_.getState() == State::IDLE && !pending_.valid) {
+                schedule(Event::START, now_ + randomRange(config_.user.start_delay_min_s,
+                                                          config_.user.start_delay_max_s) * 1000u);
+            }
+
+            uint32_t next = pending_.valid && pending_.at_ms < day_end ? pending_.at_ms : day_end;
+            uint32_t frames = framesUntil(next);
+
+            if (config_.exact_frames) {
+                frames = 1;
+            } else if (timer_.getState() == State::ACTIVE) {
+                uint32_t remaining = timer_.getRemainingMs();
+                uint32_t timeout_frames = (remaining + f - 1) / f;
+                if (timeout_frames < frames) frames = timeout_frames;
+
+                // Next call must start exactly at the frame the warning window opens
+                if (remaining > 30000) {
+                    uint32_t warning_frames = (remaining - 30000 + f - 1) / f;
+                    if (warning_frames < frames) frames = warning_frames;
+                }
+            }
+
+            if (frames == 0) frames = 1;
+            setNow(now_ + frames * f);
+
+            if (config_.exact_frames || timer_.getState() == State::ACTIVE) {
+                in_update_ = true;
+                timer_.update(frames * f);
+                in_update_ = false;
+                report_.update_calls++;
+            }
+
+            if (pending_.valid && pending_.at_ms <= now_ && now_ < day_end) {
+                applyPending();
+            }
+        }
+
+        // End of the working day
+        pending_.valid = false;
+        if (timer_.getState() != State::IDLE) {
+            sendEvent(Event::STOP);
+        }
+
+        report_.completed_today = sequence_.getCompletedToday();
+        report_.led_state_patterns = leds_.setStatePatternCount();
+        report_.led_milestones = leds_.milestoneCount();
+        report_.haptic_triggers = haptic_.totalTriggers();
+        return report_;
+    }
+
+    /**
+     * Simulate consecutive days and aggregate the reports
+     */
+    Summary run(uint32_t days) {
+        Summary summary;
+        for (uint32_t day = 0; day < days; day++) {
+            DayReport day_report = runDay(day);
+            accumulate(summary.totals, day_report);
+            int32_t max_error = day_report.timing_error_max_ms;
+            if (max_error > summary.timing_error_max_ms) summary.timing_error_max_ms = max_error;
+            summary.days++;
+        }
+        return summary;
+    }
+
+    const TimerStateMachine& timer() const { return timer_; }
+    const PomodoroSequence& sequence() const { return sequence_; }
+
+private:
+    struct PendingAction {
+        bool valid;
+        Event event;
+        uint32_t at_ms;
+    };
+
+    SimConfig config_;
+    PomodoroSequence sequence_;
+    TimerStateMachine timer_;
+    MockLEDController leds_;
+    MockHapticController haptic_;
+
+    DayReport report_ = {};
+    PendingAction pending_ = {};
+    uint32_t rng_ = 1;
+    uint32_t now_ = 0;
+    bool in_update_ = false;
+    bool in_timeout_callback_ = false;
+    bool interruption_done_ = false;
+
+    // Session timing (virtual ms)
+    uint32_t session_start_ms_ = 0;
+    uint32_t session_paused_ms_ = 0;
+    uint32_t pause_start_ms_ = 0;
+    uint32_t session_total_ms_ = 0;
+    bool session_is_work_ = false;
+
+    void setNow(uint32_t ms) {
+        now_ = ms;
+        arduino_shim::setMillis(ms);
+    }
+
+    uint32_t alignToFrame(uint32_t ms) const {
+        return (ms + config_.frame_ms - 1) / config_.frame_ms * config_.frame_ms;
+    }
+
+    uint32_t framesUntil(uint32_t at_ms) const {
+        if (at_ms <= now_) return 1;
+        return (at_ms - now_ + config_.frame_ms - 1) / config_.frame_ms;
+    }
+
+    uint32_t nextRandom() {
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 17;
+        rng_ ^= rng_ << 5;
+        return rng_;
+    }
+
+    uint32_t randomRange(uint32_t low, uint32_t high) {
+        return high > low ? low + nextRandom() % (high - low + 1) : low;
+    }
+
+    bool chance(uint8_t pct) { return nextRandom() % 100 < pct; }
+
+    void schedule(Event event, uint32_t at_ms) {
+        pending_ = {true, event, at_ms};
+    }
+
+    bool sendEvent(Event event) {
+        bool accepted = timer_.handleEvent(event);
+        if (accepted) {
+            report_.events_accepted++;
+        } else {
+            report_.events_rejected++;
+        }
+        return accepted;
+    }
+
+    void applyPending() {
+        Event event = pending_.event;
+        pending_.valid = false;
+
+        if (sendEvent(event)) {
+            switch (event) {
+                case Event::START:  report_.manual_starts++; break;
+                case Event::PAUSE:  report_.pauses++; break;
+                case Event::SKIP:   report_.skips++; break;
+                case Event::STOP:   report_.stops++; break;
+                default: break;
+            }
+        }
+    }
+
+    // Roll at most one interruption per session, at a random point of it
+    void planInterruption() {
+        if (interruption_done_) return;
+        interruption_done_ = true;
+
+        const UserBehaviour& user = config_.user;
+        uint32_t offset = randomRange(1, session_total_ms_ > 1 ? session_total_ms_ - 1 : 1);
+        uint32_t roll = nextRandom() % 100;
+        uint32_t stop_below = user.stop_pct;
+        uint32_t skip_below = stop_below + (session_is_work_ ? 0u : user.skip_break_pct);
+        uint32_t pause_below = skip_below + user.pause_pct;
+
+        if (roll < stop_below) {
+            schedule(Event::STOP, now_ + offset);
+        } else if (roll < skip_below) {
+            schedule(Event::SKIP, now_ + offset);
+        } else if (roll < pause_below) {
+            schedule(Event::PAUSE, now_ + offset);
+        }
+    }
+
+    // ========================================
+    // State machine callbacks
+    // ========================================
+
+    void onStateChange(State from, State to) {
+        report_.state_callbacks++;
+        report_.transitions[static_cast<int>(from)][static_cast<int>(to)]++;
+
+        if (from == State::IDLE && to == State::ACTIVE) {
+            session_start_ms_ = now_;
+            session_paused_ms_ = 0;
+            session_total_ms_ = timer_.getTotalMs();
+            session_is_work_ = sequence_.isWorkSession();
+            interruption_done_ = false;
+            pending_.valid = false;
+            planInterruption();
+        } else if (from == State::ACTIVE && to == State::PAUSED) {
+            pause_start_ms_ = now_;
+            schedule(Event::RESUME, now_ + randomRange(config_.user.pause_min_s,
+                                                       config_.user.pause_max_s) * 1000u);
+        } else if (from == State::PAUSED && to == State::ACTIVE) {
+            session_paused_ms_ += now_ - pause_start_ms_;
+        } else if (from == State::ACTIVE && to == State::IDLE && in_update_) {
+            // Reached zero inside update(): session completed by TIMEOUT
+            pending_.valid = false;
+            recordTiming();
+            if (session_is_work_) {
+                report_.work_completed++;
+            } else {
+                report_.breaks_completed++;
+            }
+            // Sequence already advanced; a wrap back to session 1 means cycle complete
+            if (sequence_.getCurrentSessionNumber() == 1) {
+                report_.cycles_completed++;
+            }
+        }
+    }
+
+    void onTimeout() {
+        report_.timeout_callbacks++;
+
+        // Same policy as main.cpp's timeout callback
+        bool next_is_work = sequence_.isWorkSession();
+        if (config_.pomodoro.shouldAutoStart(next_is_work)) {
+            if (sendEvent(Event::START)) {
+                report_.auto_starts++;
+            }
+        } else {
+            timer_.indicateSessionReady();
+        }
+    }
+
+    void onAudio(const char* name) {
+        if (strcmp(name, "work_start") == 0) {
+            report_.audio_work_start++;
+        } else if (strcmp(name, "rest_start") == 0) {
+            report_.audio_rest_start++;
+        } else if (strcmp(name, "long_rest_start") == 0) {
+            report_.audio_long_rest_start++;
+        } else if (strcmp(name, "warning") == 0) {
+            report_.audio_warning++;
+        }
+    }
+
+    void recordTiming() {
+        int32_t active_ms = static_cast<int32_t>(now_ - session_start_ms_ - session_paused_ms_);
+        int32_t error = active_ms - static_cast<int32_t>(session_total_ms_);
+        int32_t magnitude = error < 0 ? -error : error;
+
+        report_.timing_error_sum_ms += error;
+        report_.timed_sessions++;
+        if (magnitude > report_.timing_error_max_ms) {
+            report_.timing_error_max_ms = magnitude;
+        }
+    }
+
+    static void accumulate(DayReport& total, const DayReport& day) {
+        for (uint8_t from = 0; from < STATE_COUNT; from++) {
+            for (uint8_t to = 0; to < STATE_COUNT; to++) {
+                total.transitions[from][to] += day.transitions[from][to];
+            }
+        }
+        total.events_accepted += day.events_accepted;
+        total.events_rejected += day.events_rejected;
+        total.work_completed += day.work_completed;
+        total.breaks_completed += day.breaks_completed;
+        total.cycles_completed += day.cycles_completed;
+        total.auto_starts += day.auto_starts;
+        total.manual_starts += day.manual_starts;
+        total.pauses += day.pauses;
+        total.skips += day.skips;
+        total.stops += day.stops;
+        total.state_callbacks += day.state_callbacks;
+        total.timeout_callbacks += day.timeout_callbacks;
+        total.audio_work_start += day.audio_work_start;
+        total.audio_rest_start += day.audio_rest_start;
+        total.audio_long_rest_start += day.audio_long_rest_start;
+        total.audio_warning += day.audio_warning;
+        total.led_state_patterns += day.led_state_patterns;
+        total.led_milestones += day.led_milestones;
+        total.haptic_triggers += day.haptic_triggers;
+        total.timing_error_sum_ms += day.timing_error_sum_ms;
+        total.timed_sessions += day.timed_sessions;
+        total.update_calls += day.update_calls;
+    }
+};
+
+#endif // POMODORO_SIMULATOR_H
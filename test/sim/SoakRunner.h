@@ -0,0 +1,648 @@
+#ifndef SOAK_RUNNER_H
+#define SOAK_RUNNER_H
+
+#include <Arduino.h>
+#include <M5Unified.h>
+#include <Preferences.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "../../src/core/Config.h"
+#include "../../src/core/PomodoroSequence.h"
+#include "../../src/core/Statistics.h"
+#include "../../src/core/SyncPrimitives.h"
+#include "../../src/core/TimerStateMachine.h"
+#include "../../src/hardware/LEDController.h"
+#include "../../src/hardware/LEDStripRMT.h"
+#include "../../src/ui/Renderer.h"
+#include "../../src/ui/ScreenManager.h"
+#include "../../src/utils/AllocTracker.h"
+#include "../../src/utils/NvsAccounting.h"
+#include "../mocks/MockHapticController.h"
+
+/**
+ * Accelerated multi-day soak of the UI loop (host only)
+ *
+ * Runs the real UI stack - ScreenManager and screens, Renderer,
+ * TimerStateMachine, PomodoroSequence, Statistics on the Preferences shim,
+ * LEDController through the FastLED shim and LEDStripRMT - for weeks of
+ * virtual time with a scripted user, and samples resources at every
+ * midnight. Problems that only show after long uptime (leaks, counter
+ * overflows, millis() wraparound, midnight rollovers, timer drift) show up
+ * in seconds.
+ *
+ * Loop model (mirrors UITask, one frame per iteration):
+ * - Input: due user action → M5.BtnX.press(), M5.update(),
+ *   handleHardwareButtons()
+ * - Frame: ScreenManager::update(now - last_frame), LED update + the
+ *   OFF-pattern refresh, haptic update, draw(), Renderer::update();
+ *   the simulated LED transfer completes before the next frame (onTxEnd)
+ * - Status tick once per second: updateStatus(), and resetDailyCounter()
+ *   when the day changed (TimeManager::isMidnightCrossed() on the device)
+ * - Timeout callback applies the main.cpp auto-start policy
+ * - Timed-out sessions go to Statistics (work/break minutes), each pause
+ *   counts as an interruption. Audio events are counted at the state
+ *   machine callback (no player).
+ *
+ * Virtual time:
+ * - millis() starts at start_millis (default: wraps 36 h in, mid-session)
+ * - Wall clock (arduino_shim::setEpoch) starts at midnight UTC, local = UTC
+ * - While in use (working hours, a session runs, a screen other than Main,
+ *   confetti) runs of frames are coalesced into one iteration of
+ *   n × frame_ms, split where something is due: a user action (the step
+ *   ends one frame before it, so the press lands in a frame_ms frame like
+ *   on the device), the 30 s warning window, the timeout, the end of the
+ *   confetti. Otherwise (nights, device untouched) steps of max_step_ms.
+ *   No step is longer than max_step_ms or crosses midnight or the start of
+ *   the working day. frame_ms must be below 1000 (warning window width).
+ *
+ * Scripted user, seeded xorshift (same seed, same weeks):
+ * - Starts work sessions manually between day_start_min and day_end_min
+ *   (breaks auto-start with the default settings)
+ * - Per session at most one interruption: PAUSE for pause_min_s..max_s
+ *   (pause_pct) or a look at the Stats screen for 5..60 s (glance_pct)
+ *
+ * Checks (DayReport per day, Report for the run):
+ * - Timer drift: per session, active time minus duration. The timeout
+ *   lands on a frame (less than one frame late) and a start or resume costs
+ *   at most one frame (the frame delta already began before the button);
+ *   anything beyond that is drift (drifted_sessions)
+ * - completed_today at the end of a day equals that day's work sessions;
+ *   Statistics holds one record per day with that day's sessions / pauses
+ * - Heap: AllocTracker live bytes after each day (day 0 warms up: first
+ *   Stats visit, lazily grown buffers)
+ * - Queues: peak Renderer dirty rects per frame; NVS live entries and writes
+ *   (history_days of Statistics records are seeded first, so a device in
+ *   steady state stays flat)
+ * - LED milestones (confetti): shortest / longest observed duration
+ *
+ * Usage:
+ *   SoakRunner::Options options;
+ *   options.days = 30;
+ *   SoakRunner soak(options);
+ *   auto report = soak.run();
+ *   report.print();
+ */
+class SoakRunner {
+public:
+    using State = TimerStateMachine::State;
+
+    static constexpr uint32_t DAY_MS = 86400000u;
+
+    struct Options {
+        Config::PomodoroSettings pomodoro;
+        uint32_t days = 30;
+        uint16_t frame_ms = 33;                 // UITask frame (30 FPS)
+        uint32_t max_step_ms = 60000;           // Longest iteration (idle, or coalesced frames)
+        uint32_t start_millis = 0u - 36u * 3600000u;
+        int64_t start_epoch = 1735689600;       // 2025-01-01 00:00 UTC
+        uint16_t day_start_min = 9 * 60;        // 09:00
+        uint16_t day_end_min = 17 * 60;         // 17:00 (no new sessions after)
+        uint16_t start_delay_min_s = 5;         // Manual start reaction time
+        uint16_t start_delay_max_s = 120;
+        uint8_t pause_pct = 20;
+        uint16_t pause_min_s = 30;
+        uint16_t pause_max_s = 300;
+        uint8_t glance_pct = 25;                // Open Stats mid-session
+        uint16_t history_days = 90;             // Statistics records before day 0 (NVS in steady state)
+        uint32_t seed = 1;
+    };
+
+    struct DayReport {
+        uint32_t day;
+        uint32_t frames;                        // Loop iterations (coalesced frames count once)
+        uint32_t redraws;                       // Frames that pushed to the display
+        uint32_t dirty_peak;                    // Most dirty rects pending at a push
+        uint32_t work_completed;
+        uint32_t breaks_completed;
+        uint32_t pauses;
+        uint32_t glances;
+        uint32_t milestones;                    // LED confetti celebrations
+        uint32_t audio_events;
+        uint8_t completed_today;                // PomodoroSequence before the rollover
+        uint32_t timed_sessions;
+        int32_t timing_error_max_ms;            // Largest |error| of the day
+        uint32_t drifted_sessions;              // |error| above one frame per start/resume + 1
+        uint32_t heap_live_bytes;               // AllocTracker after the day
+        uint32_t heap_allocs;                   // Allocations during the day
+        uint32_t nvs_live_entries;
+        uint32_t nvs_writes;                    // During the day
+        bool millis_wrapped;                    // millis() passed 0 during the day
+    };
+
+    struct Report {
+        std::vector<DayReport> days;
+        uint32_t milestone_min_ms = 0;
+        uint32_t milestone_max_ms = 0;
+        uint32_t stats_mismatched_days = 0;     // Statistics day record != what the user did
+        uint32_t final_millis = 0;
+        ScreenID final_screen = ScreenID::MAIN;
+        State final_state = State::IDLE;
+
+        DayReport totals() const {
+            DayReport total = {};
+            for (const DayReport& d : days) {
+                total.frames += d.frames;
+                total.redraws += d.redraws;
+                total.dirty_peak = d.dirty_peak > total.dirty_peak ? d.dirty_peak : total.dirty_peak;
+                total.work_completed += d.work_completed;
+                total.breaks_completed += d.breaks_completed;
+                total.pauses += d.pauses;
+                total.glances += d.glances;
+                total.milestones += d.milestones;
+                total.audio_events += d.audio_events;
+                total.timed_sessions += d.timed_sessions;
+                if (d.timing_error_max_ms > total.timing_error_max_ms) {
+                    total.timing_error_max_ms = d.timing_error_max_ms;
+                }
+                total.drifted_sessions += d.drifted_sessions;
+                total.heap_allocs += d.heap_allocs;
+                total.nvs_writes += d.nvs_writes;
+            }
+            return total;
+        }
+
+        // Resource curves: one row per simulated day
+        void print() const {
+            if (days.empty()) return;
+            DayReport total = totals();
+            printf("\n=== Soak: %lu days ===\n", (unsigned long)days.size());
+            printf("%4s %8s %7s %5s %4s %4s %5s %5s %6s %8s %9s %7s %6s %5s\n",
+                   "day", "frames", "redraws", "dirty", "work", "brk", "pause", "today",
+                   "err ms", "drifted", "heap live", "allocs", "nvs", "nvs w");
+            for (const DayReport& d : days) {
+                printf("%4lu %8lu %7lu %5lu %4lu %4lu %5lu %5u %6ld %8lu %9lu %7lu %6lu %5lu%s\n",
+                       (unsigned long)d.day, (unsigned long)d.frames, (unsigned long)d.redraws,
+                       (unsigned long)d.dirty_peak, (unsigned long)d.work_completed,
+                       (unsigned long)d.breaks_completed, (unsigned long)d.pauses,
+                       (unsigned)d.completed_today, (long)d.timing_error_max_ms,
+                       (unsigned long)d.drifted_sessions, (unsigned long)d.heap_live_bytes,
+                       (unsigned long)d.heap_allocs, (unsigned long)d.nvs_live_entries,
+                       (unsigned long)d.nvs_writes, d.millis_wrapped ? "  (millis wrapped)" : "");
+            }
+            printf("Sessions: %lu work, %lu breaks, %lu timed, %lu drifted (max |error| %ld ms)\n",
+                   (unsigned long)total.work_completed, (unsigned long)total.breaks_completed,
+                   (unsigned long)total.timed_sessions, (unsigned long)total.drifted_sessions,
+                   (long)total.timing_error_max_ms);
+            printf("User: %lu pauses, %lu stats glances | LED milestones %lu (%lu..%lu ms) | audio %lu\n",
+                   (unsigned long)total.pauses, (unsigned long)total.glances,
+                   (unsigned long)total.milestones, (unsigned long)milestone_min_ms,
+                   (unsigned long)milestone_max_ms, (unsigned long)total.audio_events);
+            printf("Frames: %lu, redraws %lu, dirty rects peak %lu | NVS writes %lu | millis() now %lu\n",
+                   (unsigned long)total.frames, (unsigned long)total.redraws,
+                   (unsigned long)total.dirty_peak, (unsigned long)total.nvs_writes,
+                   (unsigned long)final_millis);
+        }
+    };
+
+    SoakRunner() = default;
+    explicit SoakRunner(const Options& options) : options_(options) {}
+
+    Report run() {
+        preferences_shim::clearAll();
+        AllocTracker::reset();          // Track every block of the run (frees of older blocks don't count)
+        initSyncPrimitives();
+        NvsAccounting::begin();
+        seedHistory();
+        arduino_shim::setMillis(options_.start_millis);
+        arduino_shim::setEpoch(options_.start_epoch);
+        M5.Display.resetCounters();
+        M5.update();                    // Drop inputs left over from a previous run
+
+        Report report;
+        {
+            Harness ui(*this, options_.pomodoro);
+            soak(ui, report);
+            report.final_screen = ui.screens.getCurrentScreen();
+            report.final_state = ui.timer.getState();
+            report.final_millis = millis();
+            statistics_ = nullptr;
+        }
+
+        cleanupSyncPrimitives();
+        arduino_shim::setMillis(0);
+        arduino_shim::setEpoch(0);
+        return report;
+    }
+
+private:
+    enum class Action : uint8_t { START, PAUSE, RESUME, STATS, BACK };
+
+    struct Pending {
+        bool valid;
+        Action action;
+        uint64_t at_ms;
+    };
+
+    // Everything main.cpp wires up for the UI task, real LEDs, mock haptics
+    struct Harness {
+        PomodoroSequence sequence;
+        TimerStateMachine timer;
+        Statistics statistics;
+        Config config;
+        LEDController leds;
+        MockHapticController haptic;
+        Renderer renderer;
+        bool configured;     // Config loaded before the screens read it (main.cpp order)
+        ScreenManager screens;
+
+        Harness(SoakRunner& soak, const Config::PomodoroSettings& pomodoro)
+            : timer(sequence),
+              configured(configure(soak, pomodoro)),
+              screens(timer, sequence, statistics, config, leds, haptic) {
+            renderer.begin();
+        }
+
+        bool configure(SoakRunner& soak, const Config::PomodoroSettings& pomodoro) {
+            config.begin();
+            config.setPomodoro(pomodoro);
+            statistics.begin();
+            leds.begin();
+
+            sequence.setSessionsBeforeLong(pomodoro.sessions_before_long);
+            sequence.setNumCycles(pomodoro.num_cycles);
+            sequence.setWorkDuration(pomodoro.work_duration_min);
+            sequence.setShortBreakDuration(pomodoro.short_break_min);
+            sequence.setLongBreakDuration(pomodoro.long_break_min);
+
+            timer.setLEDController(&leds);
+            timer.setHapticController(&haptic);
+            timer.onAudioEvent([&soak](const char*) { soak.day_.audio_events++; });
+            timer.onStateChange([&soak](State from, State to) { soak.onStateChange(from, to); });
+            timer.onSessionComplete([&soak](const PomodoroSequence::Session& session, uint32_t elapsed_ms) {
+                soak.onSessionComplete(session, elapsed_ms);
+            });
+            timer.onTimeout([this]() {
+                bool work = sequence.getCurrentSession().type == PomodoroSequence::SessionType::WORK;
+                if (config.getPomodoro().shouldAutoStart(work)) {
+                    timer.handleEvent(TimerStateMachine::Event::START);
+                } else {
+                    timer.indicateSessionReady();
+                }
+            });
+            soak.statistics_ = &statistics;
+            soak.timer_ = &timer;
+            return true;
+        }
+    };
+
+    Options options_;
+    Statistics* statistics_ = nullptr;
+    TimerStateMachine* timer_ = nullptr;
+
+    // Virtual time
+    uint64_t t_ = 0;                    // ms since the start (midnight, day 0)
+    bool in_frame_ = false;
+
+    // User
+    uint32_t rng_ = 1;
+    Pending pending_ = {};
+
+    // Current session
+    uint64_t session_start_ = 0;
+    uint64_t session_paused_ms_ = 0;
+    uint64_t pause_start_ = 0;
+    uint32_t session_total_ms_ = 0;
+    uint32_t session_starts_ = 0;       // Manual start + resumes (one frame of slack each)
+
+    // LED milestone tracking
+    bool confetti_ = false;
+    uint64_t confetti_start_ = 0;
+
+    // Per-day bookkeeping
+    DayReport day_ = {};
+    std::vector<uint16_t> work_by_day_;
+    std::vector<uint16_t> pauses_by_day_;
+
+    // A device that has been in use: every Statistics day slot already written
+    void seedHistory() {
+        Statistics history;
+        history.begin();
+        for (uint32_t day = options_.history_days; day > 0; day--) {
+            arduino_shim::setEpoch(options_.start_epoch - static_cast<int64_t>(day) * 86400);
+            history.recordWorkSession(options_.pomodoro.work_duration_min, true);
+        }
+    }
+
+    // ========================================
+    // Loop
+    // ========================================
+
+    void soak(Harness& ui, Report& report) {
+        rng_ = options_.seed * 0x9E3779B9u;
+        if (rng_ == 0) rng_ = 1;  // xorshift has no zero state
+        pending_.valid = false;
+        t_ = 0;
+        work_by_day_.assign(options_.days, 0);
+        pauses_by_day_.assign(options_.days, 0);
+        report.milestone_min_ms = UINT32_MAX;
+
+        uint32_t last_frame = millis();
+        uint32_t last_second = millis();
+        uint32_t last_day = static_cast<uint32_t>(options_.start_epoch / 86400);
+        uint32_t current_day = 0;
+        beginDay(0, ui);
+
+        // Steps land exactly on midnight (advance() never crosses it)
+        while (true) {
+            advance(ui);
+
+            // Midnight: close the day before the status tick rolls counters over
+            uint32_t today = static_cast<uint32_t>(t_ / DAY_MS);
+            if (today != current_day) {
+                endDay(ui, report);
+                if (today >= options_.days) break;
+                current_day = today;
+                beginDay(today, ui);
+            }
+            uint32_t now = millis();
+            if (now < last_frame) day_.millis_wrapped = true;
+
+            // Input (UITask: M5.update → buttons)
+            if (pending_.valid && pending_.at_ms <= t_) {
+                applyPending(ui);
+            }
+            M5.update();
+            ui.screens.handleHardwareButtons();
+
+            // Frame (UITask: every iteration here, delta via uint32_t millis like the device)
+            uint32_t delta = now - last_frame;
+            last_frame = now;
+            frame(ui, delta, report);
+
+            // Status bar once per second, midnight rollover of the daily counter
+            if (now - last_second >= 1000) {
+                last_second = now;
+                uint64_t epoch = static_cast<uint64_t>(options_.start_epoch) + t_ / 1000;
+                uint32_t minute = static_cast<uint32_t>((epoch / 60) % 1440);
+                ui.screens.updateStatus(80, false, false, "IDLE",
+                                        static_cast<uint8_t>(minute / 60), static_cast<uint8_t>(minute % 60));
+                uint32_t day = static_cast<uint32_t>(epoch / 86400);
+                if (day != last_day) {
+                    last_day = day;
+                    ui.sequence.resetDailyCounter();
+                }
+            }
+
+            scheduleUser(ui);
+        }
+        if (report.milestone_min_ms == UINT32_MAX) report.milestone_min_ms = 0;
+
+        report.stats_mismatched_days = checkStatistics(ui);
+    }
+
+    // Next loop iteration: a coalesced run of frames while in use, a long step otherwise
+    void advance(Harness& ui) {
+        const uint64_t f = options_.frame_ms;
+        uint64_t time_of_day = t_ % DAY_MS;
+        uint64_t work_start = options_.day_start_min * 60000ull;
+        uint64_t work_end = options_.day_end_min * 60000ull;
+        bool working = time_of_day >= work_start && time_of_day < work_end;
+        State state = ui.timer.getState();
+        bool busy = working || pending_.valid || state != State::IDLE ||
+                    ui.screens.getCurrentScreen() != ScreenID::MAIN || confetti_;
+
+        uint64_t step = options_.max_step_ms;
+        if (busy) {
+            uint64_t frames = step / f;
+            if (pending_.valid) {
+                // Stop one frame short: the press then lands in a single frame
+                uint64_t until = framesUntil(pending_.at_ms);
+                if (until > 1) until--;
+                if (until < frames) frames = until;
+            }
+            if (state == State::ACTIVE) {
+                uint64_t remaining = ui.timer.getRemainingMs();
+                uint64_t timeout_frames = (remaining + f - 1) / f;
+                if (timeout_frames < frames) frames = timeout_frames;
+                // Next update() must start exactly at the frame the warning window opens
+                if (remaining > 30000) {
+                    uint64_t warning_frames = (remaining - 30000 + f - 1) / f;
+                    if (warning_frames < frames) frames = warning_frames;
+                }
+            }
+            if (confetti_) {
+                uint64_t until = framesUntil(confetti_start_ + 10000);
+                if (until < frames) frames = until;
+            }
+            if (state == State::IDLE && !pending_.valid) frames = 1;   // scheduleUser() decides
+            step = (frames == 0 ? 1 : frames) * f;
+        }
+
+        uint64_t boundary = time_of_day < work_start ? t_ - time_of_day + work_start
+                                                     : t_ - time_of_day + DAY_MS;
+        if (t_ + step > boundary) step = boundary - t_;
+        t_ += step;
+        arduino_shim::advanceMillis(static_cast<uint32_t>(step));
+        arduino_shim::setEpoch(options_.start_epoch + static_cast<int64_t>(t_ / 1000));
+    }
+
+    uint64_t framesUntil(uint64_t at_ms) const {
+        if (at_ms <= t_) return 1;
+        return (at_ms - t_ + options_.frame_ms - 1) / options_.frame_ms;
+    }
+
+    void frame(Harness& ui, uint32_t delta, Report& report) {
+        uint32_t pushes = M5.Display.pushCount();
+
+        in_frame_ = true;
+        ui.screens.update(delta);
+        in_frame_ = false;
+
+        ui.leds.update();
+        LEDStripRMT::onTxEnd(0);        // Transfer done well before the next frame
+        if (ui.leds.getPattern() == ILEDController::Pattern::OFF) {
+            // UITask: refresh the state pattern once a milestone ended
+            State state = ui.timer.getState();
+            if (state == State::ACTIVE) {
+                ui.leds.setStatePattern(ui.sequence.isWorkSession() ? ILEDController::TimerState::WORK_ACTIVE
+                                                                    : ILEDController::TimerState::BREAK_ACTIVE);
+            } else if (state == State::PAUSED) {
+                ui.leds.setStatePattern(ILEDController::TimerState::PAUSED);
+            }
+        }
+        trackMilestone(ui, report);
+
+        ui.haptic.update();
+        ui.screens.draw(ui.renderer);
+        uint32_t dirty = static_cast<uint32_t>(ui.renderer.getDirtyRectCount());
+        if (dirty > day_.dirty_peak) day_.dirty_peak = dirty;
+        ui.renderer.update();
+
+        day_.frames++;
+        if (M5.Display.pushCount() != pushes) day_.redraws++;
+    }
+
+    void trackMilestone(Harness& ui, Report& report) {
+        bool confetti = ui.leds.getPattern() == ILEDController::Pattern::CONFETTI;
+        if (confetti && !confetti_) {
+            confetti_start_ = t_;
+            day_.milestones++;
+        } else if (!confetti && confetti_) {
+            uint32_t duration = static_cast<uint32_t>(t_ - confetti_start_);
+            if (duration < report.milestone_min_ms) report.milestone_min_ms = duration;
+            if (duration > report.milestone_max_ms) report.milestone_max_ms = duration;
+        }
+        confetti_ = confetti;
+    }
+
+    // ========================================
+    // Day boundaries
+    // ========================================
+
+    void beginDay(uint32_t day, Harness& ui) {
+        day_ = DayReport{};
+        day_.day = day;
+        day_.heap_allocs = AllocTracker::getTotals().alloc_count;   // Start value, delta at endDay
+        day_.nvs_writes = NvsAccounting::getTotals().writes;
+        ui.haptic.reset();
+    }
+
+    void endDay(Harness& ui, Report& report) {
+        day_.completed_today = ui.sequence.getCompletedToday();
+        day_.heap_allocs = AllocTracker::getTotals().alloc_count - day_.heap_allocs;
+        day_.nvs_writes = NvsAccounting::getTotals().writes - day_.nvs_writes;
+        day_.nvs_live_entries = NvsAccounting::getLiveEntries();
+
+        if (report.days.empty()) report.days.reserve(options_.days);
+        day_.heap_live_bytes = AllocTracker::getTotals().live_bytes;
+        report.days.push_back(day_);
+    }
+
+    // Statistics day records (one per midnight) against what the user did
+    uint32_t checkStatistics(Harness& ui) const {
+        uint32_t first_day = static_cast<uint32_t>(options_.start_epoch / 86400);
+        uint32_t mismatched = 0;
+        for (uint32_t day = 0; day < options_.days; day++) {
+            Statistics::DayStats stats = ui.statistics.getDate(first_day + day);
+            uint8_t pauses = pauses_by_day_[day] > UINT8_MAX ? UINT8_MAX : static_cast<uint8_t>(pauses_by_day_[day]);
+            if (stats.completed_sessions != work_by_day_[day] || stats.interruptions != pauses) {
+                mismatched++;
+            }
+        }
+        return mismatched;
+    }
+
+    // ========================================
+    // Scripted user
+    // ========================================
+
+    uint32_t nextRandom() {
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 17;
+        rng_ ^= rng_ << 5;
+        return rng_;
+    }
+
+    uint32_t randomRange(uint32_t low, uint32_t high) {
+        return high > low ? low + nextRandom() % (high - low + 1) : low;
+    }
+
+    void schedule(Action action, uint64_t at_ms) {
+        pending_ = {true, action, at_ms};
+    }
+
+    void scheduleUser(Harness& ui) {
+        if (pending_.valid) return;
+        uint64_t time_of_day = t_ % DAY_MS;
+        bool working = time_of_day >= options_.day_start_min * 60000ull &&
+                       time_of_day < options_.day_end_min * 60000ull;
+        if (working && ui.timer.getState() == State::IDLE && ui.screens.getCurrentScreen() == ScreenID::MAIN) {
+            schedule(Action::START, t_ + randomRange(options_.start_delay_min_s,
+                                                     options_.start_delay_max_s) * 1000ull);
+        }
+    }
+
+    void applyPending(Harness& ui) {
+        Action action = pending_.action;
+        pending_.valid = false;
+        ScreenID screen = ui.screens.getCurrentScreen();
+        State state = ui.timer.getState();
+
+        switch (action) {
+            case Action::START:
+                if (screen == ScreenID::MAIN && state == State::IDLE) M5.BtnA.press();
+                break;
+            case Action::PAUSE:
+                if (screen == ScreenID::MAIN && state == State::ACTIVE) M5.BtnA.press();
+                break;
+            case Action::RESUME:
+                if (screen == ScreenID::PAUSE && state == State::PAUSED) M5.BtnA.press();
+                break;
+            case Action::STATS:
+                if (screen == ScreenID::MAIN) {
+                    M5.BtnB.press();
+                    day_.glances++;
+                    schedule(Action::BACK, t_ + randomRange(5, 60) * 1000ull);
+                }
+                break;
+            case Action::BACK:
+                if (screen == ScreenID::STATS) M5.BtnA.press();
+                break;
+        }
+    }
+
+    // ========================================
+    // State machine callbacks
+    // ========================================
+
+    void onStateChange(State from, State to) {
+        if (from == State::IDLE && to == State::ACTIVE) {
+            session_start_ = t_;
+            session_paused_ms_ = 0;
+            session_total_ms_ = timer_->getTotalMs();
+            session_starts_ = in_frame_ ? 0 : 1;   // Auto-start inside update(): no frame lost
+            if (!(pending_.valid && pending_.action == Action::BACK)) {
+                pending_.valid = false;
+                planInterruption();
+            }
+        } else if (from == State::ACTIVE && to == State::PAUSED) {
+            pause_start_ = t_;
+            day_.pauses++;
+            uint32_t day = static_cast<uint32_t>(t_ / DAY_MS);
+            if (day < pauses_by_day_.size()) pauses_by_day_[day]++;
+            statistics_->recordInterruption();
+            schedule(Action::RESUME, t_ + randomRange(options_.pause_min_s, options_.pause_max_s) * 1000ull);
+        } else if (from == State::PAUSED && to == State::ACTIVE) {
+            session_paused_ms_ += t_ - pause_start_;
+            session_starts_++;
+        }
+    }
+
+    // Roll at most one interruption per session, at a random point of it
+    void planInterruption() {
+        uint64_t offset = randomRange(1000, session_total_ms_ > 2000 ? session_total_ms_ - 1000 : 1000);
+        uint32_t roll = nextRandom() % 100;
+        if (roll < options_.pause_pct) {
+            schedule(Action::PAUSE, t_ + offset);
+        } else if (roll < static_cast<uint32_t>(options_.pause_pct) + options_.glance_pct) {
+            schedule(Action::STATS, t_ + offset);
+        }
+    }
+
+    void onSessionComplete(const PomodoroSequence::Session& session, uint32_t elapsed_ms) {
+        // Timing: active virtual time against the session length
+        int64_t active = static_cast<int64_t>(t_ - session_start_ - session_paused_ms_);
+        int64_t error = active - static_cast<int64_t>(session_total_ms_);
+        int64_t magnitude = error < 0 ? -error : error;
+        day_.timed_sessions++;
+        if (magnitude > day_.timing_error_max_ms) day_.timing_error_max_ms = static_cast<int32_t>(magnitude);
+        if (magnitude > static_cast<int64_t>(options_.frame_ms) * (session_starts_ + 1)) day_.drifted_sessions++;
+
+        if (pending_.valid && pending_.action != Action::BACK) pending_.valid = false;
+
+        uint16_t minutes = static_cast<uint16_t>(elapsed_ms / 60000);
+        if (session.type == PomodoroSequence::SessionType::WORK) {
+            day_.work_completed++;
+            uint32_t day = static_cast<uint32_t>(t_ / DAY_MS);
+            if (day < work_by_day_.size()) work_by_day_[day]++;
+            statistics_->recordWorkSession(minutes, true);
+        } else {
+            day_.breaks_completed++;
+            statistics_->recordBreakSession(minutes);
+        }
+    }
+};
+
+#endif // SOAK_RUNNER_H
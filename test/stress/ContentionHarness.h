@@ -0,0 +1,546 @@
+#ifndef CONTENTION_HARNESS_H
+#define CONTENTION_HARNESS_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <freertos/queue.h>
+#include <freertos/event_groups.h>
+#include <freertos/sync_monitor.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "../../src/core/SyncPrimitives.h"
+#include "../../src/core/Statistics.h"
+#include "../../src/core/PomodoroSequence.h"
+#include "../../src/core/TimerStateMachine.h"
+#include "../../src/utils/MutexGuard.h"
+
+/**
+ * Dual-core contention stress harness for SyncPrimitives (host only)
+ *
+ * Runs the three loops that share the global sync objects on real threads
+ * (FreeRTOS shim tasks, pthreads underneath), with randomized hold times:
+ * - uiTask (core 0): drains networkStatusQueue, ticks a real
+ *   TimerStateMachine (state changes → shadowPublishQueue + shadow_state),
+ *   renders under display_mutex (sometimes reading Statistics inside it,
+ *   i.e. display → stats), records finished sessions to Statistics
+ * - sensorTask (core 0): polls the I2C bus under i2c_mutex, occasionally
+ *   flashing the display from inside it (i2c → display)
+ * - networkTask (core 1): publishes shadow updates (stats → shadow_state
+ *   snapshot, then a lock-free "TLS" delay), posts NetworkStatus, flaps
+ *   the networkEvents bits
+ *
+ * Reported: lock-order violations (ranked i2c → display → stats → shadow
+ * plus A→B/B→A inversions), MutexGuard timeouts, wait/hold percentiles per
+ * mutex, queue drops and high-water marks, UI frame time percentiles.
+ *
+ * Hold times come from per-task seeded RNGs, but thread interleaving is up
+ * to the host scheduler: compare runs by their percentiles, not exact
+ * counts. On a loaded host a run may also do less work in duration_ms;
+ * min_frames extends it until the UI loop has run that many frames. A
+ * holder descheduled for 50-100 ms times out a guard without any bug, so
+ * check timeouts relative to the run: each one needs a long hold
+ * (long_holds) and long holds must be rare among the takes of the lock.
+ * Faults can be injected (reversed lock order in the network task,
+ * slow NVS commits, slow publish) to check the detectors.
+ *
+ * Usage:
+ *   ContentionHarness::Config config;
+ *   config.duration_ms = 1000;
+ *   ContentionHarness harness(config);
+ *   auto report = harness.run();
+ *   report.print();
+ */
+class ContentionHarness {
+public:
+    struct Config {
+        uint32_t duration_ms = 1000;
+        uint32_t min_frames = 0;           // Run on past duration_ms (up to 10×) until this many UI frames
+        uint32_t seed = 1;
+
+        // Loop periods
+        uint16_t ui_frame_ms = 33;
+        uint16_t sensor_period_ms = 5;
+        uint16_t network_poll_ms = 10;     // xQueueReceive timeout on shadowPublishQueue
+
+        // Randomized hold times (us)
+        uint32_t i2c_hold_min_us = 50;
+        uint32_t i2c_hold_max_us = 400;
+        uint32_t render_hold_min_us = 1000;
+        uint32_t render_hold_max_us = 8000;
+        uint32_t shadow_hold_min_us = 20;
+        uint32_t shadow_hold_max_us = 200;
+        uint32_t publish_min_us = 500;     // Outside any lock (network I/O)
+        uint32_t publish_max_us = 3000;
+
+        // Behaviour mix (percent per iteration)
+        uint8_t ui_event_pct = 5;          // Random timer event per frame
+        uint8_t render_stats_pct = 20;     // Render reads Statistics (display → stats)
+        uint8_t sensor_flash_pct = 2;      // Sensor flashes display (i2c → display)
+        uint8_t status_pct = 10;           // Network posts a NetworkStatus
+        uint8_t link_flap_pct = 2;         // Network toggles WiFi/MQTT bits
+
+        uint32_t timer_speedup = 600;      // Virtual timer ms per real ms (sessions end quickly)
+        uint8_t shadow_burst = 1;          // Shadow updates queued per state change
+
+        // Fault injection
+        bool inject_inversion = false;     // Network takes shadow_state → stats
+        uint32_t nvs_write_delay_us = 0;   // Preferences put*() latency (held under stats)
+    };
+
+    static constexpr uint8_t LOCK_COUNT = 5;   // 4 global + timer state
+    static constexpr uint8_t QUEUE_COUNT = 2;
+    static constexpr uint8_t MAX_VIOLATIONS = 16;
+    static constexpr uint32_t LONG_HOLD_US = 50000;   // Shortest MutexGuard timeout in the loops
+
+    struct LockReport {
+        char name[24];
+        int rank;
+        uint32_t takes;
+        uint32_t timeouts;
+        uint32_t wait_p50_us, wait_p99_us, wait_max_us;
+        uint32_t hold_p50_us, hold_p99_us, hold_max_us;
+        uint32_t long_holds;               // Holds ≥ LONG_HOLD_US (long enough to time out a guard)
+    };
+
+    struct QueueReport {
+        char name[24];
+        uint32_t length;
+        uint32_t sends;
+        uint32_t drops;
+        uint32_t receives;
+        uint32_t high_water;
+    };
+
+    struct Report {
+        uint32_t duration_ms;              // Actual run time (min_frames may extend it)
+        LockReport locks[LOCK_COUNT];
+        QueueReport queues[QUEUE_COUNT];
+        freertos_shim::LockOrderViolation violations[MAX_VIOLATIONS];
+        size_t violation_count;
+        uint32_t ranked_violations;        // Occurrences, not distinct pairs
+        uint32_t inversions;
+
+        uint32_t frames;
+        uint32_t frame_p50_us, frame_p99_us, frame_max_us;
+        uint32_t frames_over_budget;       // Frame work longer than ui_frame_ms
+
+        uint32_t event_polls;
+        uint32_t event_poll_misses;        // WiFi bit not set when UI polled
+        uint32_t state_changes;
+        uint32_t sessions_recorded;
+        uint32_t publishes;
+
+        uint32_t totalTimeouts() const {
+            uint32_t total = 0;
+            for (const auto& lock : locks) total += lock.timeouts;
+            return total;
+        }
+
+        uint32_t totalTakes() const {
+            uint32_t total = 0;
+            for (const auto& lock : locks) total += lock.takes;
+            return total;
+        }
+
+        const LockReport* lock(const char* name) const {
+            for (const auto& entry : locks) {
+                if (strcmp(entry.name, name) == 0) return &entry;
+            }
+            return nullptr;
+        }
+
+        const QueueReport* queue(const char* name) const {
+            for (const auto& entry : queues) {
+                if (strcmp(entry.name, name) == 0) return &entry;
+            }
+            return nullptr;
+        }
+
+        void print() const {
+            printf("=== Contention Harness: %lu ms ===\n", (unsigned long)duration_ms);
+            printf("%-20s %4s %7s %5s %8s %8s %8s %8s %8s\n", "Mutex", "rank", "takes", "t/o",
+                   "wait50", "wait99", "waitmax", "hold99", "holdmax");
+            for (const auto& l : locks) {
+                printf("%-20s %4d %7lu %5lu %8lu %8lu %8lu %8lu %8lu\n", l.name, l.rank,
+                       (unsigned long)l.takes, (unsigned long)l.timeouts,
+                       (unsigned long)l.wait_p50_us, (unsigned long)l.wait_p99_us,
+                       (unsigned long)l.wait_max_us, (unsigned long)l.hold_p99_us,
+                       (unsigned long)l.hold_max_us);
+            }
+            printf("%-20s %6s %7s %7s %8s %6s\n", "Queue", "length", "sends", "drops", "receives", "peak");
+            for (const auto& q : queues) {
+                printf("%-20s %6lu %7lu %7lu %8lu %6lu\n", q.name, (unsigned long)q.length,
+                       (unsigned long)q.sends, (unsigned long)q.drops,
+                       (unsigned long)q.receives, (unsigned long)q.high_water);
+            }
+            printf("UI frames: %lu, work p50 %lu us, p99 %lu us, max %lu us, over budget %lu\n",
+                   (unsigned long)frames, (unsigned long)frame_p50_us,
+                   (unsigned long)frame_p99_us, (unsigned long)frame_max_us,
+                   (unsigned long)frames_over_budget);
+            printf("Timer state changes %lu, sessions recorded %lu, publishes %lu, "
+                   "WiFi poll misses %lu/%lu\n",
+                   (unsigned long)state_changes, (unsigned long)sessions_recorded,
+                   (unsigned long)publishes, (unsigned long)event_poll_misses,
+                   (unsigned long)event_polls);
+            printf("Lock-order violations: %lu ranked, %lu inversions\n",
+                   (unsigned long)ranked_violations, (unsigned long)inversions);
+            for (size_t i = 0; i < violation_count; i++) {
+                const auto& v = violations[i];
+                printf("  %s: holding %s, took %s (task %s) ×%lu\n",
+                       v.ranked ? "RANK" : "INVERSION", v.held, v.acquired, v.task,
+                       (unsigned long)v.count);
+            }
+        }
+    };
+
+    explicit ContentionHarness(const Config& config) : config_(config) {}
+
+    Report run() {
+        using namespace freertos_shim;
+
+        preferences_shim::clearAll();
+        preferences_shim::setWriteDelayUs(0);
+        SyncMonitor::reset();
+        SyncMonitor::enable(true);
+
+        if (!initSyncPrimitives()) {
+            return Report{};
+        }
+        setLockRank(g_i2c_mutex, 0);
+        setLockRank(g_display_mutex, 1);
+        setLockRank(g_stats_mutex, 2);
+        setLockRank(g_shadow_state_mutex, 3);
+
+        Report report = {};
+        {
+            Statistics statistics;
+            PomodoroSequence sequence;
+            sequence.setWorkDuration(1);
+            sequence.setShortBreakDuration(1);
+            sequence.setLongBreakDuration(1);
+            TimerStateMachine timer(sequence);
+
+            statistics_ = &statistics;
+            sequence_ = &sequence;
+            timer_ = &timer;
+            statistics.begin();
+            preferences_shim::setWriteDelayUs(config_.nvs_write_delay_us);
+
+            timer.onStateChange([this](TimerStateMachine::State, TimerStateMachine::State to) {
+                onTimerStateChange(static_cast<uint8_t>(to));
+            });
+            timer.onTimeout([this]() { timer_->handleEvent(TimerStateMachine::Event::START); });
+
+            stop_.store(false);
+            auto started = std::chrono::steady_clock::now();
+            xTaskCreatePinnedToCore(uiTaskEntry, "uiTask", 8192, this, 2, nullptr, 0);
+            xTaskCreatePinnedToCore(sensorTaskEntry, "sensorTask", 4096, this, 3, nullptr, 0);
+            xTaskCreatePinnedToCore(networkTaskEntry, "networkTask", 8192, this, 1, nullptr, 1);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(config_.duration_ms));
+            for (uint32_t waited = 0; frame_us_.count() < config_.min_frames &&
+                                      waited < 9 * config_.duration_ms; waited += 10) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));   // Slow host: same work, more time
+            }
+            stop_.store(true);
+            uint32_t ran_ms = elapsedUs(started) / 1000;
+            waitForAllTasks(5000);
+
+            preferences_shim::setWriteDelayUs(0);
+            collect(report);
+            report.duration_ms = ran_ms;
+            statistics_ = nullptr;
+            sequence_ = nullptr;
+            timer_ = nullptr;
+        }
+
+        SyncMonitor::enable(false);
+        cleanupSyncPrimitives();
+        return report;
+    }
+
+private:
+    Config config_;
+    std::atomic<bool> stop_{false};
+    Statistics* statistics_ = nullptr;
+    PomodoroSequence* sequence_ = nullptr;
+    TimerStateMachine* timer_ = nullptr;
+
+    std::atomic<uint32_t> state_changes_{0};
+    std::atomic<uint32_t> sessions_recorded_{0};
+    std::atomic<uint32_t> publishes_{0};
+    std::atomic<uint32_t> event_polls_{0};
+    std::atomic<uint32_t> event_poll_misses_{0};
+    freertos_shim::LatencyHistogram frame_us_;
+    std::atomic<uint32_t> frames_over_budget_{0};
+    uint8_t last_shadow_state_ = 0;        // Guarded by g_shadow_state_mutex
+
+    // ========================================
+    // Helpers
+    // ========================================
+
+    struct Rng {
+        uint32_t state;
+        explicit Rng(uint32_t seed) : state(seed ? seed : 1) {}
+        uint32_t next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t range(uint32_t low, uint32_t high) {
+            return high > low ? low + next() % (high - low + 1) : low;
+        }
+        bool chance(uint8_t pct) { return next() % 100 < pct; }
+    };
+
+    // Spin for short holds (like a bus transfer), sleep for long ones
+    static void holdFor(uint32_t us) {
+        if (us >= 1000) {
+            std::this_thread::sleep_for(std::chrono::microseconds(us));
+            return;
+        }
+        auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+        while (std::chrono::steady_clock::now() < until) {}
+    }
+
+    static uint32_t elapsedUs(std::chrono::steady_clock::time_point since) {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - since).count());
+    }
+
+    // Called by the timer with its state mutex held (timer → shadow_state, timer → stats)
+    void onTimerStateChange(uint8_t new_state) {
+        state_changes_.fetch_add(1);
+
+        {
+            MutexGuard guard(g_shadow_state_mutex, "g_shadow_state_mutex", 50);
+            if (guard.isLocked()) {
+                last_shadow_state_ = new_state;
+            }
+        }
+
+        ShadowUpdate update = {};
+        update.type = ShadowUpdate::Type::TIMER_STATE;
+        update.timestamp = millis();
+        update.state = new_state;
+        update.completed = sequence_->getCompletedToday();
+        for (uint8_t i = 0; i < config_.shadow_burst; i++) {
+            xQueueSend(g_shadowPublishQueue, &update, 0);  // Drop if full (as on device)
+        }
+    }
+
+    // ========================================
+    // Task loops
+    // ========================================
+
+    static void uiTaskEntry(void* param) {
+        static_cast<ContentionHarness*>(param)->uiLoop();
+        vTaskDelete(NULL);
+    }
+
+    static void sensorTaskEntry(void* param) {
+        static_cast<ContentionHarness*>(param)->sensorLoop();
+        vTaskDelete(NULL);
+    }
+
+    static void networkTaskEntry(void* param) {
+        static_cast<ContentionHarness*>(param)->networkLoop();
+        vTaskDelete(NULL);
+    }
+
+    void uiLoop() {
+        Rng rng(config_.seed * 0x9E3779B9u + 1);
+        const uint32_t budget_us = config_.ui_frame_ms * 1000u;
+        timer_->handleEvent(TimerStateMachine::Event::START);
+
+        while (!stop_.load()) {
+            auto frame_start = std::chrono::steady_clock::now();
+
+            // Network status (ScreenManager drains up to 5 per frame)
+            NetworkStatus status;
+            for (uint8_t i = 0; i < 5 && xQueueReceive(g_networkStatusQueue, &status, 0) == pdTRUE; i++) {}
+
+            event_polls_.fetch_add(1);
+            EventBits_t bits = xEventGroupWaitBits(g_networkEvents, NETWORK_WIFI_CONNECTED,
+                                                   pdFALSE, pdFALSE, 0);
+            if (!(bits & NETWORK_WIFI_CONNECTED)) {
+                event_poll_misses_.fetch_add(1);
+            }
+
+            // Timer tick (+ random user event)
+            uint32_t completed_before = sequence_->getCompletedToday();
+            if (rng.chance(config_.ui_event_pct)) {
+                switch (timer_->getState()) {
+                    case TimerStateMachine::State::IDLE:
+                        timer_->handleEvent(TimerStateMachine::Event::START);
+                        break;
+                    case TimerStateMachine::State::ACTIVE:
+                        timer_->handleEvent(TimerStateMachine::Event::PAUSE);
+                        break;
+                    case TimerStateMachine::State::PAUSED:
+                        timer_->handleEvent(TimerStateMachine::Event::RESUME);
+                        break;
+                }
+            }
+            timer_->update(config_.ui_frame_ms * config_.timer_speedup);
+            if (sequence_->getCompletedToday() != completed_before) {
+                statistics_->recordWorkSession(1, true);   // stats (NVS write) from Core 0
+                sessions_recorded_.fetch_add(1);
+            }
+
+            // Render
+            {
+                MutexGuard guard(g_display_mutex, "g_display_mutex", 50);
+                if (guard.isLocked()) {
+                    if (rng.chance(config_.render_stats_pct)) {
+                        statistics_->getToday();             // display → stats
+                    }
+                    holdFor(rng.range(config_.render_hold_min_us, config_.render_hold_max_us));
+                }
+            }
+
+            uint32_t work_us = elapsedUs(frame_start);
+            frame_us_.record(work_us);
+            if (work_us > budget_us) {
+                frames_over_budget_.fetch_add(1);
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(budget_us - work_us));
+            }
+        }
+    }
+
+    void sensorLoop() {
+        Rng rng(config_.seed * 0x9E3779B9u + 2);
+
+        while (!stop_.load()) {
+            {
+                MutexGuard guard(g_i2c_mutex, "g_i2c_mutex", 100);
+                if (guard.isLocked()) {
+                    holdFor(rng.range(config_.i2c_hold_min_us, config_.i2c_hold_max_us));
+
+                    if (rng.chance(config_.sensor_flash_pct)) {
+                        MutexGuard display(g_display_mutex, "g_display_mutex", 50);  // i2c → display
+                        if (display.isLocked()) {
+                            holdFor(rng.range(50, 300));
+                        }
+                    }
+                }
+            }
+            vTaskDelay(pdMS_TO_TICKS(config_.sensor_period_ms));
+        }
+    }
+
+    void networkLoop() {
+        Rng rng(config_.seed * 0x9E3779B9u + 3);
+        xEventGroupSetBits(g_networkEvents, NETWORK_WIFI_CONNECTED | NETWORK_MQTT_CONNECTED);
+
+        while (!stop_.load()) {
+            ShadowUpdate update;
+            if (xQueueReceive(g_shadowPublishQueue, &update, pdMS_TO_TICKS(config_.network_poll_ms)) == pdTRUE) {
+                publishSnapshot(rng);
+                holdFor(rng.range(config_.publish_min_us, config_.publish_max_us));  // TLS write
+                publishes_.fetch_add(1);
+            }
+
+            if (rng.chance(config_.status_pct)) {
+                NetworkStatus status = {};
+                status.event = NetworkStatus::Event::MQTT_CONNECTED;
+                status.timestamp = millis();
+                xQueueSend(g_networkStatusQueue, &status, 0);   // Drop if full (as on device)
+            }
+
+            if (rng.chance(config_.link_flap_pct)) {
+                if (xEventGroupGetBits(g_networkEvents) & NETWORK_WIFI_CONNECTED) {
+                    xEventGroupClearBits(g_networkEvents, NETWORK_WIFI_CONNECTED | NETWORK_MQTT_CONNECTED);
+                } else {
+                    xEventGroupSetBits(g_networkEvents, NETWORK_WIFI_CONNECTED | NETWORK_MQTT_CONNECTED);
+                }
+            }
+        }
+    }
+
+    // Consistent stats + shadow snapshot for the shadow document
+    void publishSnapshot(Rng& rng) {
+        if (config_.inject_inversion) {
+            MutexGuard shadow(g_shadow_state_mutex, "g_shadow_state_mutex", 50);
+            if (!shadow.isLocked()) return;
+            MutexGuard stats(g_stats_mutex, "g_stats_mutex", 100);  // Wrong order
+            holdFor(rng.range(config_.shadow_hold_min_us, config_.shadow_hold_max_us));
+            return;
+        }
+
+        MutexGuard stats(g_stats_mutex, "g_stats_mutex", 100);
+        if (!stats.isLocked()) return;
+        MutexGuard shadow(g_shadow_state_mutex, "g_shadow_state_mutex", 50);
+        if (!shadow.isLocked()) return;
+        holdFor(rng.range(config_.shadow_hold_min_us, config_.shadow_hold_max_us));
+    }
+
+    // ========================================
+    // Report
+    // ========================================
+
+    // Call while the timer is alive (its mutex is looked up by registry name)
+    void collect(Report& report) {
+        static const char* lock_names[LOCK_COUNT] = {
+            "i2c_mutex", "display_mutex", "stats_mutex", "shadow_state_mutex", "timer_state_mutex"
+        };
+        for (uint8_t i = 0; i < LOCK_COUNT; i++) {
+            LockReport& out = report.locks[i];
+            const freertos_shim::LockStats* lock = freertos_shim::SyncMonitor::findLock(lock_names[i]);
+            if (!lock) continue;
+            const freertos_shim::LockStats& stats = *lock;
+            strncpy(out.name, stats.name, sizeof(out.name) - 1);
+            out.rank = stats.rank;
+            out.takes = stats.takes.load();
+            out.timeouts = stats.timeouts.load();
+            out.wait_p50_us = stats.wait_us.percentile(50);
+            out.wait_p99_us = stats.wait_us.percentile(99);
+            out.wait_max_us = stats.wait_us.max();
+            out.hold_p50_us = stats.hold_us.percentile(50);
+            out.hold_p99_us = stats.hold_us.percentile(99);
+            out.hold_max_us = stats.hold_us.max();
+            out.long_holds = stats.hold_us.countAtLeast(LONG_HOLD_US);
+        }
+
+        QueueHandle_t queues[QUEUE_COUNT] = {g_shadowPublishQueue, g_networkStatusQueue};
+        for (uint8_t i = 0; i < QUEUE_COUNT; i++) {
+            QueueReport& out = report.queues[i];
+            strncpy(out.name, queues[i]->name, sizeof(out.name) - 1);
+            out.length = queues[i]->length;
+            out.sends = queues[i]->sends.load();
+            out.drops = queues[i]->send_failures.load();
+            out.receives = queues[i]->receives.load();
+            out.high_water = queues[i]->high_water.load();
+        }
+
+        report.violation_count = freertos_shim::SyncMonitor::getViolations(report.violations, MAX_VIOLATIONS);
+        for (size_t i = 0; i < report.violation_count; i++) {
+            if (report.violations[i].ranked) {
+                report.ranked_violations += report.violations[i].count;
+            } else {
+                report.inversions += report.violations[i].count;
+            }
+        }
+
+        report.frames = frame_us_.count();
+        report.frame_p50_us = frame_us_.percentile(50);
+        report.frame_p99_us = frame_us_.percentile(99);
+        report.frame_max_us = frame_us_.max();
+        report.frames_over_budget = frames_over_budget_.load();
+        report.event_polls = event_polls_.load();
+        report.event_poll_misses = event_poll_misses_.load();
+        report.state_changes = state_changes_.load();
+        report.sessions_recorded = sessions_recorded_.load();
+        report.publishes = publishes_.load();
+    }
+};
+
+#endif // CONTENTION_HARNESS_H
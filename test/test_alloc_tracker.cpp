@@ -0,0 +1,168 @@
+/**
+ * Unit Test: AllocTracker (heap allocation tracking)
+ *
+ * Runs on the native environment (pio test -e native), where the tracker
+ * interposes malloc/free for the whole test executable.
+ *
+ * Test scenarios:
+ * - Allocations are attributed to the active ALLOC_SCOPE subsystem
+ * - Frees are attributed back to the allocating subsystem
+ * - Nested scopes restore the outer tag
+ * - Peak live bytes and top call sites
+ * - std::vector growth is visible (hidden allocator)
+ */
+
+#include "../src/utils/AllocTracker.h"
+
+#if ALLOC_TRACKING
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <vector>
+
+using Subsystem = AllocTracker::Subsystem;
+
+// Publish the pointer so the optimizer cannot elide malloc/free pairs
+static void* volatile g_sink = nullptr;
+
+static void* escape(void* ptr) {
+    g_sink = ptr;
+    return ptr;
+}
+
+class AllocTrackerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        AllocTracker::reset();
+    }
+};
+
+/**
+ * Test: malloc inside a scope is charged to that subsystem
+ */
+TEST_F(AllocTrackerTest, AttributesAllocationToScope) {
+    ASSERT_TRUE(AllocTracker::isEnabled());
+
+    void* ptr = nullptr;
+    {
+        ALLOC_SCOPE(RENDERER);
+        ptr = escape(malloc(100));
+    }
+
+    auto stats = AllocTracker::getStats(Subsystem::RENDERER);
+    EXPECT_EQ(1u, stats.alloc_count);
+    EXPECT_EQ(100u, stats.live_bytes);
+    EXPECT_EQ(100u, stats.total_bytes);
+
+    // Free outside the scope still credits the allocating subsystem
+    free(ptr);
+    stats = AllocTracker::getStats(Subsystem::RENDERER);
+    EXPECT_EQ(1u, stats.free_count);
+    EXPECT_EQ(0u, stats.live_bytes);
+    EXPECT_EQ(100u, stats.peak_bytes);
+}
+
+/**
+ * Test: nested scopes tag inner allocations and restore the outer tag
+ */
+TEST_F(AllocTrackerTest, NestedScopesRestoreOuterTag) {
+    void* outer = nullptr;
+    void* inner = nullptr;
+    void* after = nullptr;
+    {
+        ALLOC_SCOPE(UI_FRAME);
+        outer = escape(malloc(16));
+        {
+            ALLOC_SCOPE(TOUCH);
+            EXPECT_EQ(Subsystem::TOUCH, AllocTracker::currentSubsystem());
+            inner = escape(malloc(32));
+        }
+        EXPECT_EQ(Subsystem::UI_FRAME, AllocTracker::currentSubsystem());
+        after = escape(malloc(64));
+    }
+    EXPECT_EQ(Subsystem::UNTAGGED, AllocTracker::currentSubsystem());
+
+    EXPECT_EQ(80u, AllocTracker::getStats(Subsystem::UI_FRAME).live_bytes);
+    EXPECT_EQ(32u, AllocTracker::getStats(Subsystem::TOUCH).live_bytes);
+
+    free(outer);
+    free(inner);
+    free(after);
+}
+
+/**
+ * Test: realloc moves the live bytes, calloc counts count*size
+ */
+TEST_F(AllocTrackerTest, TracksReallocAndCalloc) {
+    ALLOC_SCOPE(SD);
+
+    void* ptr = escape(calloc(4, 25));
+    EXPECT_EQ(100u, AllocTracker::getStats(Subsystem::SD).live_bytes);
+
+    ptr = escape(realloc(ptr, 300));
+    auto stats = AllocTracker::getStats(Subsystem::SD);
+    EXPECT_EQ(300u, stats.live_bytes);
+    EXPECT_EQ(2u, stats.alloc_count);
+    EXPECT_EQ(1u, stats.free_count);
+
+    free(ptr);
+    EXPECT_EQ(0u, AllocTracker::getStats(Subsystem::SD).live_bytes);
+}
+
+/**
+ * Test: std::vector growth shows up as repeated allocations
+ */
+TEST_F(AllocTrackerTest, SeesVectorGrowth) {
+    {
+        ALLOC_SCOPE(TOUCH);
+        std::vector<int> widgets;
+        for (int i = 0; i < 64; i++) {
+            widgets.push_back(i);
+        }
+    }
+
+    auto stats = AllocTracker::getStats(Subsystem::TOUCH);
+    EXPECT_GE(stats.alloc_count, 5u);               // Geometric growth: 1,2,4,...,64
+    EXPECT_EQ(stats.alloc_count, stats.free_count);  // Nothing leaked
+    EXPECT_EQ(0u, stats.live_bytes);
+    EXPECT_GE(stats.peak_bytes, 64u * sizeof(int));
+}
+
+/**
+ * Test: top call sites are sorted by bytes
+ */
+TEST_F(AllocTrackerTest, ReportsTopSitesByBytes) {
+    void* small = nullptr;
+    void* large = nullptr;
+    {
+        ALLOC_SCOPE(CONFIG);
+        small = escape(malloc(10));
+    }
+    {
+        ALLOC_SCOPE(AUDIO);
+        large = escape(malloc(5000));
+    }
+
+    AllocTracker::CallSite sites[4];
+    size_t count = AllocTracker::getTopSites(sites, 4);
+    ASSERT_GE(count, 2u);
+    EXPECT_EQ(Subsystem::AUDIO, sites[0].subsystem);
+    EXPECT_EQ(5000u, sites[0].bytes);
+    EXPECT_GE(sites[0].bytes, sites[1].bytes);
+
+    free(small);
+    free(large);
+}
+
+/**
+ * Test: frees of pointers allocated before reset() are counted as untracked
+ */
+TEST_F(AllocTrackerTest, CountsUntrackedFrees) {
+    void* ptr = escape(malloc(8));
+    AllocTracker::reset();
+
+    free(ptr);
+    EXPECT_EQ(1u, AllocTracker::getUntrackedFrees());
+}
+
+#endif  // ALLOC_TRACKING
@@ -0,0 +1,223 @@
+/**
+ * Unit Test: Audio event-to-sound latency instrumentation
+ *
+ * Runs the real sound path in env:native - TimerStateMachine audio
+ * callback, the main.cpp strcmp dispatch, AudioPlayer - into a
+ * FakeSpeakerSink (simulated I2S DMA) on the virtual clock, with the UI
+ * loop cadence of UITask (33 ms frames).
+ * - Warning and session start sounds reach OUTPUT; trigger lateness is
+ *   the frame granularity; the estimated first sample matches the
+ *   simulated DAC and stays out of the measured total
+ * - A starved mixer is reported as an underrun of the true DAC gap; a
+ *   starve shorter than the DMA queue and a stalled UI loop are not
+ * - Direct sounds, cancel/superseded counts, history order and reset
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "../src/core/PomodoroSequence.h"
+#include "../src/core/TimerStateMachine.h"
+#include "../src/hardware/AudioPlayer.h"
+#include "../src/utils/AudioLatency.h"
+#include "mocks/FakeSpeakerSink.h"
+
+using Stage = AudioLatency::Stage;
+
+namespace {
+
+constexpr uint32_t FRAME_MS = 33;       // UITask frame
+constexpr uint32_t PIPELINE_MS = 64;    // DMA ring depth
+
+const AudioLatency::Segment& segment(const AudioLatency::Stats& stats, Stage stage) {
+    return stats.stage[static_cast<size_t>(stage)];
+}
+
+}  // namespace
+
+class AudioLatencyTest : public ::testing::Test {
+protected:
+    FakeSpeakerSink speaker{PIPELINE_MS};
+    AudioPlayer player{speaker};
+
+    void SetUp() override {
+        arduino_shim::setMillis(1000);
+        AudioLatency::reset();
+        ASSERT_TRUE(player.begin());
+    }
+
+    void TearDown() override {
+        AudioLatency::reset();
+    }
+
+    // One UI loop iteration: audio update (sink poll), then the frame time
+    void frame(uint32_t ms) {
+        player.update();
+        speaker.advance(ms);
+    }
+};
+
+/**
+ * Test: Warning through the timer, dispatch lambda and player to the DAC
+ */
+TEST_F(AudioLatencyTest, WarningTracedFromTriggerToFirstSample) {
+    PomodoroSequence sequence;
+    sequence.setWorkDuration(1);
+    TimerStateMachine timer(sequence);
+
+    // Same dispatch as main.cpp
+    timer.onAudioEvent([this](const char* sound_name) {
+        if (strcmp(sound_name, "work_start") == 0) {
+            player.play(IAudioPlayer::Sound::WORK_START);
+        } else if (strcmp(sound_name, "warning") == 0) {
+            player.play(IAudioPlayer::Sound::WARNING);
+        }
+    });
+
+    ASSERT_TRUE(timer.handleEvent(TimerStateMachine::Event::START));
+    uint32_t warning_submit_ms = 0;
+    while (timer.getRemainingMs() > 20000) {
+        uint32_t before = timer.getRemainingMs();
+        timer.update(FRAME_MS);
+        if (before <= 30000 && warning_submit_ms == 0) warning_submit_ms = millis();
+        frame(FRAME_MS);
+    }
+    for (int i = 0; i < 60; i++) frame(FRAME_MS);   // Let the clip finish
+
+    auto stats = AudioLatency::getStats();
+    EXPECT_EQ(2u, stats.events);   // work_start + warning
+    EXPECT_EQ(0u, stats.cancelled);
+    EXPECT_EQ(0u, stats.superseded);
+    EXPECT_EQ(0u, stats.underruns);
+    EXPECT_EQ(2u, segment(stats, Stage::DISPATCH).count);
+    EXPECT_EQ(2u, segment(stats, Stage::SUBMIT).count);
+    EXPECT_EQ(2u, segment(stats, Stage::OUTPUT).count);
+
+    // Warning: checked on the first update at or below 30 s remaining
+    uint32_t first_due_frame = (60000 - 30000 + FRAME_MS - 1) / FRAME_MS;
+    uint32_t expected_late = first_due_frame * FRAME_MS - 30000;
+    AudioLatency::Event history[AudioLatency::HISTORY];
+    ASSERT_EQ(2u, AudioLatency::getHistory(history, AudioLatency::HISTORY));
+    const AudioLatency::Event& warning = history[0];
+    EXPECT_STREQ("warning", warning.name);
+    EXPECT_EQ(expected_late, warning.schedule_late_ms);
+    EXPECT_LT(warning.schedule_late_ms, FRAME_MS);
+    EXPECT_EQ(1u, stats.schedule_late.count);
+    EXPECT_STREQ("work_start", history[1].name);
+    EXPECT_EQ(0u, history[1].schedule_late_ms);
+
+    // Trigger, dispatch and submit happen in one frame; output is behind the DMA queue
+    size_t trigger = static_cast<size_t>(Stage::TRIGGER);
+    size_t submit = static_cast<size_t>(Stage::SUBMIT);
+    size_t output = static_cast<size_t>(Stage::OUTPUT);
+    EXPECT_EQ(warning_submit_ms * 1000, warning.at_us[submit]);
+    EXPECT_EQ(warning.at_us[trigger], warning.at_us[submit]);
+    EXPECT_EQ(PIPELINE_MS * 1000, warning.at_us[output] - warning.at_us[submit]);
+    EXPECT_EQ(PIPELINE_MS * 1000u, segment(stats, Stage::OUTPUT).max_us);
+    EXPECT_EQ(0u, stats.measured.max_us);   // Estimate not counted
+
+    // Estimate vs the simulated DAC (within one 1 ms mixer step)
+    ASSERT_TRUE(speaker.firstSampleOut());
+    EXPECT_NEAR(speaker.firstSampleMs() * 1000.0, warning.at_us[output], 1000.0);
+    EXPECT_EQ(0u, speaker.underrunMs());
+}
+
+/**
+ * Test: Underruns match the simulated DAC gap, short starves and UI stalls don't count
+ */
+TEST_F(AudioLatencyTest, UnderrunsFromStarvedMixer) {
+    constexpr uint32_t POLL_MS = 10;
+
+    // Starved 150 ms mid-clip: the 64 ms queue covers part of it
+    player.playTone(440, 1000);
+    for (int i = 0; i < 30; i++) frame(POLL_MS);
+    speaker.setStarved(true);
+    for (int i = 0; i < 15; i++) frame(POLL_MS);
+    speaker.setStarved(false);
+    while (player.isPlaying()) frame(POLL_MS);
+    frame(POLL_MS);
+
+    EXPECT_NEAR(150 - PIPELINE_MS, speaker.underrunMs(), 1);
+    auto stats = AudioLatency::getStats();
+    EXPECT_EQ(1u, stats.underruns);
+    EXPECT_NEAR(speaker.underrunMs() * 1000.0, stats.max_underrun_us, POLL_MS * 1000.0);
+    EXPECT_EQ(1u, speaker.getMonitor().getStats().underruns);
+
+    // Starve shorter than the queue: no audible gap
+    uint32_t gap_before = speaker.underrunMs();
+    player.playTone(440, 1000);
+    for (int i = 0; i < 30; i++) frame(POLL_MS);
+    speaker.setStarved(true);
+    for (int i = 0; i < 4; i++) frame(POLL_MS);
+    speaker.setStarved(false);
+    while (player.isPlaying()) frame(POLL_MS);
+    frame(POLL_MS);
+
+    EXPECT_EQ(gap_before, speaker.underrunMs());
+    EXPECT_EQ(1u, AudioLatency::getStats().underruns);
+
+    // UI loop stalled 300 ms while the clip plays: not an underrun
+    player.playTone(440, 500);
+    frame(POLL_MS);
+    speaker.advance(300);
+    while (player.isPlaying()) frame(POLL_MS);
+    frame(POLL_MS);
+
+    stats = AudioLatency::getStats();
+    EXPECT_EQ(1u, stats.underruns);
+    EXPECT_EQ(3u, stats.events);
+}
+
+/**
+ * Test: Direct sounds, cancel / superseded counts, history and reset
+ */
+TEST_F(AudioLatencyTest, DirectSoundsCancelAndHistory) {
+    // UI beep: no trigger, starts at DISPATCH
+    player.playBeep();
+    frame(FRAME_MS);
+    auto stats = AudioLatency::getStats();
+    EXPECT_EQ(1u, stats.events);
+    EXPECT_EQ(0u, segment(stats, Stage::DISPATCH).count);
+    EXPECT_EQ(1u, segment(stats, Stage::SUBMIT).count);
+    EXPECT_EQ(1u, stats.measured.count);
+    EXPECT_EQ(0u, stats.measured.max_us);
+    EXPECT_EQ(PIPELINE_MS * 1000u, segment(stats, Stage::OUTPUT).max_us);
+
+    // Muted: cancelled, never output
+    player.mute();
+    player.play(IAudioPlayer::Sound::REST_START);
+    player.unmute();
+    frame(FRAME_MS);
+    EXPECT_EQ(1u, AudioLatency::getStats().cancelled);
+    EXPECT_EQ(1u, AudioLatency::getStats().events);
+
+    // Trigger without a dispatch, then a new trigger: superseded
+    AudioLatency::trigger("rest_start", 0, micros());
+    AudioLatency::trigger("warning", 5, micros());
+    player.play(IAudioPlayer::Sound::WARNING);
+    frame(FRAME_MS);
+    stats = AudioLatency::getStats();
+    EXPECT_EQ(1u, stats.superseded);
+    EXPECT_EQ(2u, stats.events);
+    EXPECT_EQ(1u, segment(stats, Stage::DISPATCH).count);
+
+    // Output without a submitted sound is ignored
+    AudioLatency::output(micros());
+    EXPECT_EQ(2u, AudioLatency::getStats().events);
+
+    AudioLatency::Event history[AudioLatency::HISTORY];
+    ASSERT_EQ(2u, AudioLatency::getHistory(history, AudioLatency::HISTORY));
+    EXPECT_STREQ("warning", history[0].name);
+    EXPECT_EQ(5u, history[0].schedule_late_ms);
+    EXPECT_STREQ("tone", history[1].name);
+    EXPECT_FALSE(history[1].reached[static_cast<size_t>(Stage::TRIGGER)]);
+
+    AudioLatency::reset();
+    stats = AudioLatency::getStats();
+    EXPECT_EQ(0u, stats.events);
+    EXPECT_EQ(0u, stats.superseded);
+    EXPECT_EQ(0u, AudioLatency::getHistory(history, AudioLatency::HISTORY));
+}
+
+#endif  // NATIVE_BUILD
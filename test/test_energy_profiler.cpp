@@ -0,0 +1,219 @@
+/**
+ * Unit Test: Per-subsystem energy attribution profiler
+ *
+ * Drives EnergyProfiler with a synthetic device in env:native: random
+ * subsystem activity, battery current from a known linear model plus
+ * measurement noise, sampled like PowerTelemetry (2 s).
+ * - The fit recovers baseline and per-subsystem mA at full activity
+ * - Per timer state mAh/h adds up to the measured average
+ * - External power windows are discarded; constant subsystems are unexcited
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <random>
+#include "../src/utils/EnergyProfiler.h"
+
+using Subsystem = EnergyProfiler::Subsystem;
+
+namespace {
+
+constexpr size_t N = EnergyProfiler::SUBSYSTEMS;
+constexpr float BASELINE_MA = 45.0f;
+constexpr float TRUE_MA[N] = {
+    60.0f,    // backlight
+    120.0f,   // leds
+    150.0f,   // speaker
+    80.0f,    // haptic
+    90.0f,    // wifi
+    30.0f     // cpu
+};
+
+}  // namespace
+
+class EnergyProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        EnergyProfiler::reset();
+        for (size_t i = 0; i < N; i++) {
+            level_[i] = 0.0f;
+        }
+    }
+
+    void TearDown() override {
+        EnergyProfiler::reset();
+    }
+
+    void set(Subsystem subsystem, float level) {
+        level_[static_cast<size_t>(subsystem)] = level;
+        EnergyProfiler::setActivity(subsystem, level, now_);
+    }
+
+    // Advance in 100 ms steps, charge integrated from the true model
+    void run(uint32_t ms) {
+        for (uint32_t t = 0; t < ms; t += 100) {
+            float ma = BASELINE_MA;
+            for (size_t i = 0; i < N; i++) {
+                ma += TRUE_MA[i] * level_[i];
+            }
+            window_charge_ += ma * 100;
+            window_ms_ += 100;
+            now_ += 100;
+            if (window_ms_ >= 2000) sample();
+        }
+    }
+
+    void sample() {
+        float mean = window_charge_ / window_ms_;
+        EnergyProfiler::addSample(mean + noise_(rng_), now_, on_battery_);
+        window_charge_ = 0.0f;
+        window_ms_ = 0;
+    }
+
+    // Random levels every few seconds, like a user poking the device
+    void randomize(Subsystem subsystem, float max_level = 1.0f) {
+        std::uniform_real_distribution<float> level(0.0f, max_level);
+        set(subsystem, level(rng_));
+    }
+
+    uint32_t now_ = 1000;
+    bool on_battery_ = true;
+    float level_[N];
+    float window_charge_ = 0.0f;
+    uint32_t window_ms_ = 0;
+    std::mt19937 rng_{42};
+    std::normal_distribution<float> noise_{0.0f, 3.0f};
+};
+
+/**
+ * Test: Least-squares fit recovers the synthetic per-subsystem model
+ */
+TEST_F(EnergyProfilerTest, RecoversSyntheticModel) {
+    EnergyProfiler::addSample(0.0f, now_, true);   // Opens the first window
+    std::uniform_int_distribution<int> pick(0, N - 1);
+    std::bernoulli_distribution on(0.3);
+
+    for (int step = 0; step < 1500; step++) {
+        Subsystem subsystem = static_cast<Subsystem>(pick(rng_));
+        if (subsystem == Subsystem::HAPTIC || subsystem == Subsystem::WIFI) {
+            set(subsystem, on(rng_) ? 1.0f : 0.0f);   // On/off reporters
+        } else {
+            randomize(subsystem);
+        }
+        run(1300);
+    }
+
+    EnergyProfiler::Model model = EnergyProfiler::fit();
+    ASSERT_TRUE(model.valid);
+    EXPECT_GT(model.samples, 900u);
+    EXPECT_NEAR(BASELINE_MA, model.baseline_ma, 3.0f);
+    for (size_t i = 0; i < N; i++) {
+        EXPECT_TRUE(model.excited[i]) << EnergyProfiler::subsystemName(static_cast<Subsystem>(i));
+        EXPECT_NEAR(TRUE_MA[i], model.ma[i], 0.05f * TRUE_MA[i] + 2.0f)
+            << EnergyProfiler::subsystemName(static_cast<Subsystem>(i));
+    }
+    EXPECT_GT(model.r2, 0.95f);
+    EXPECT_LT(model.rms_error_ma, 5.0f);
+
+    EnergyProfiler::printReport();
+}
+
+/**
+ * Test: Per timer state breakdown follows what each state turns on
+ */
+TEST_F(EnergyProfilerTest, AttributesByTimerState) {
+    EnergyProfiler::addSample(0.0f, now_, true);
+
+    for (int cycle = 0; cycle < 40; cycle++) {
+        // IDLE: dim screen, LEDs off, radio syncing part of the time
+        EnergyProfiler::setTimerState(0, now_);
+        set(Subsystem::LEDS, 0.0f);
+        set(Subsystem::BACKLIGHT, 0.2f);
+        for (int i = 0; i < 10; i++) {
+            set(Subsystem::WIFI, (i % 3 == 0) ? 1.0f : 0.0f);
+            randomize(Subsystem::CPU, 0.3f);
+            run(3000);
+        }
+
+        // ACTIVE: bright screen, LED progress bar, start chime + haptic
+        EnergyProfiler::setTimerState(1, now_);
+        set(Subsystem::WIFI, 0.0f);
+        set(Subsystem::BACKLIGHT, 0.8f);
+        set(Subsystem::SPEAKER, 0.7f);
+        set(Subsystem::HAPTIC, 1.0f);
+        run(400);
+        set(Subsystem::SPEAKER, 0.0f);
+        set(Subsystem::HAPTIC, 0.0f);
+        for (int i = 0; i < 20; i++) {
+            randomize(Subsystem::LEDS, 0.6f);
+            randomize(Subsystem::CPU, 0.5f);
+            run(3000);
+        }
+    }
+
+    EnergyProfiler::Model model = EnergyProfiler::fit();
+    ASSERT_TRUE(model.valid);
+
+    EnergyProfiler::Attribution idle = EnergyProfiler::attribute(model, 0);
+    EnergyProfiler::Attribution active = EnergyProfiler::attribute(model, 1);
+    EnergyProfiler::Attribution paused = EnergyProfiler::attribute(model, 2);
+    EXPECT_EQ(0.0f, paused.hours);
+    EXPECT_GT(active.hours, idle.hours);
+
+    // Model terms add up to the measured average in each state
+    for (const auto& state : {idle, active}) {
+        float sum = state.baseline_mah_per_hour;
+        for (size_t i = 0; i < N; i++) {
+            sum += state.mah_per_hour[i];
+        }
+        EXPECT_NEAR(state.measured_ma, sum, 2.0f);
+    }
+
+    size_t leds = static_cast<size_t>(Subsystem::LEDS);
+    size_t wifi = static_cast<size_t>(Subsystem::WIFI);
+    size_t backlight = static_cast<size_t>(Subsystem::BACKLIGHT);
+    EXPECT_NEAR(0.0f, idle.mah_per_hour[leds], 0.5f);
+    EXPECT_NEAR(120.0f * 0.3f, active.mah_per_hour[leds], 4.0f);    // Mean LED level 0.3
+    EXPECT_NEAR(90.0f * 0.4f, idle.mah_per_hour[wifi], 4.0f);       // On 4 of 10 windows
+    EXPECT_NEAR(0.0f, active.mah_per_hour[wifi], 0.5f);
+    EXPECT_GT(active.mah_per_hour[backlight], 3.0f * idle.mah_per_hour[backlight]);
+    EXPECT_GT(active.measured_ma, idle.measured_ma);
+}
+
+/**
+ * Test: External power windows are discarded, constant activity is unexcited
+ */
+TEST_F(EnergyProfilerTest, DiscardsExternalPowerAndFlagsConstantActivity) {
+    EnergyProfiler::addSample(0.0f, now_, true);
+    set(Subsystem::WIFI, 1.0f);   // Radio on the whole session
+
+    // Charging: the PMIC reports charge current, nothing to attribute
+    on_battery_ = false;
+    for (int i = 0; i < 20; i++) {
+        randomize(Subsystem::BACKLIGHT);
+        run(2000);
+    }
+    EXPECT_EQ(0u, EnergyProfiler::fit().samples);
+    EXPECT_FALSE(EnergyProfiler::fit().valid);
+
+    on_battery_ = true;
+    for (int i = 0; i < 300; i++) {
+        randomize(Subsystem::BACKLIGHT);
+        run(2000);
+    }
+
+    EnergyProfiler::Model model = EnergyProfiler::fit();
+    ASSERT_TRUE(model.valid);
+    EXPECT_EQ(300u, model.samples);   // First battery sample closes a charging window
+
+    size_t wifi = static_cast<size_t>(Subsystem::WIFI);
+    size_t backlight = static_cast<size_t>(Subsystem::BACKLIGHT);
+    EXPECT_FALSE(model.excited[wifi]);
+    EXPECT_NEAR(0.0f, model.ma[wifi], 1.0f);
+    EXPECT_NEAR(BASELINE_MA + TRUE_MA[wifi], model.baseline_ma, 3.0f);   // Folded in
+    EXPECT_TRUE(model.excited[backlight]);
+    EXPECT_NEAR(TRUE_MA[backlight], model.ma[backlight], 4.0f);
+}
+
+#endif  // NATIVE_BUILD
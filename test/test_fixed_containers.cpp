@@ -0,0 +1,282 @@
+/**
+ * Unit Test: Fixed-capacity containers
+ *
+ * Checks FixedContainers.h in env:native (bounds checks compiled in):
+ * - StaticVector / RingBuffer semantics at capacity, order-keeping and
+ *   unordered erase, bounds check failures abort
+ * - FlatMap sorted insert/update/erase, IntrusiveList link/unlink
+ * - Host benchmark of the two migrated hot paths (Renderer dirty rects,
+ *   TouchEventManager widget list) against std::vector: no heap
+ *   allocations (AllocTracker) and time per frame printed for both
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "../src/utils/AllocTracker.h"
+#include "../src/utils/FixedContainers.h"
+
+namespace {
+
+// Same shape and merge rule as Renderer::Rect
+struct Rect {
+    int16_t x, y, w, h;
+
+    bool intersects(const Rect& o) const {
+        return !(x + w <= o.x || o.x + o.w <= x || y + h <= o.y || o.y + o.h <= y);
+    }
+    void merge(const Rect& o) {
+        int16_t x2 = std::max<int16_t>(x + w, o.x + o.w);
+        int16_t y2 = std::max<int16_t>(y + h, o.y + o.h);
+        x = std::min(x, o.x);
+        y = std::min(y, o.y);
+        w = x2 - x;
+        h = y2 - y;
+    }
+};
+
+struct Job : IntrusiveListNode<Job> {
+    int id;
+    explicit Job(int i) : id(i) {}
+};
+
+constexpr size_t MAX_RECTS = 10;
+
+// One UI frame of Renderer::markDirty() + optimizeDirtyRects() on either container
+template <typename Vec, typename Add, typename Erase>
+uint32_t dirtyFrame(Vec& rects, uint32_t seed, Add add, Erase erase) {
+    rects.clear();
+    for (int n = 0; n < 8; n++) {
+        seed = seed * 1103515245u + 12345u;
+        Rect r = {static_cast<int16_t>((seed >> 8) % 280), static_cast<int16_t>((seed >> 16) % 200),
+                  static_cast<int16_t>(20 + (seed >> 4) % 40), static_cast<int16_t>(12 + (seed >> 12) % 30)};
+        bool merged = false;
+        for (auto& existing : rects) {
+            if (existing.intersects(r)) {
+                existing.merge(r);
+                merged = true;
+                break;
+            }
+        }
+        if (!merged && rects.size() < MAX_RECTS) add(rects, r);
+    }
+    bool merged = true;
+    while (merged && rects.size() > 1) {
+        merged = false;
+        for (size_t i = 0; i < rects.size() && !merged; i++) {
+            for (size_t j = i + 1; j < rects.size(); j++) {
+                if (rects[i].intersects(rects[j])) {
+                    rects[i].merge(rects[j]);
+                    erase(rects, j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+    return seed;
+}
+
+// Screen change: clear, register 20 widgets, remove one, hit-test top to bottom
+template <typename Vec, typename Add>
+size_t widgetFrame(Vec& widgets, int* pool, Add add) {
+    widgets.clear();
+    for (int i = 0; i < 20; i++) add(widgets, &pool[i]);
+    widgets.erase(std::remove(widgets.begin(), widgets.end(), &pool[7]), widgets.end());
+    size_t hits = 0;
+    for (size_t i = widgets.size(); i-- > 0;) {
+        hits += (*widgets[i] & 3) == 0;
+    }
+    return hits;
+}
+
+// Bounds check violations (run in a death test child)
+void indexPastEnd() {
+    StaticVector<int, 2> vec;
+    vec.push_back(1);
+    (void)vec[1];
+}
+
+void popEmpty() {
+    StaticVector<int, 2> vec;
+    vec.pop_back();
+}
+
+void frontOfEmptyRing() {
+    RingBuffer<int, 2> ring;
+    (void)ring.front();
+}
+
+void linkTwice() {
+    Job job(9);
+    IntrusiveList<Job> list;
+    list.push_back(job);
+    list.push_back(job);
+}
+
+}  // namespace
+
+/**
+ * Test: StaticVector and RingBuffer at capacity, bounds checks abort
+ */
+TEST(FixedContainersTest, StaticVectorAndRingBuffer) {
+    StaticVector<int, 4> vec;
+    for (int i = 1; i <= 4; i++) EXPECT_TRUE(vec.push_back(i * 10));
+    EXPECT_FALSE(vec.push_back(50));                       // Full: refused, not grown
+    EXPECT_TRUE(vec.full());
+    EXPECT_EQ(4u, vec.size());
+
+    auto next = vec.erase(vec.begin() + 1);                 // Order kept
+    EXPECT_EQ(30, *next);
+    EXPECT_EQ((std::vector<int>{10, 30, 40}), std::vector<int>(vec.begin(), vec.end()));
+    vec.eraseUnordered(0);                                  // Last moves in
+    EXPECT_EQ((std::vector<int>{40, 30}), std::vector<int>(vec.begin(), vec.end()));
+
+    StaticVector<int, 4> copy = vec;
+    vec.clear();
+    EXPECT_TRUE(vec.empty());
+    EXPECT_EQ(2u, copy.size());
+    EXPECT_EQ(30, copy.back());
+
+    RingBuffer<uint16_t, 4> ring;
+    for (uint16_t i = 1; i <= 4; i++) EXPECT_TRUE(ring.push(i));
+    EXPECT_FALSE(ring.push(5));
+    EXPECT_FALSE(ring.pushOverwrite(5));                    // Drops 1
+    uint16_t out = 0;
+    EXPECT_TRUE(ring.pop(out));
+    EXPECT_EQ(2, out);
+    EXPECT_EQ(3, ring.front());
+    EXPECT_EQ(5, ring.back());
+    EXPECT_EQ(4, ring[1]);
+    while (ring.pop(out)) {}
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.pop(out));
+
+    EXPECT_DEATH(indexPastEnd(), "index out of range");
+    EXPECT_DEATH(popEmpty(), "pop_back");
+    EXPECT_DEATH(frontOfEmptyRing(), "RingBuffer");
+}
+
+/**
+ * Test: FlatMap keeps keys sorted, IntrusiveList links without allocating
+ */
+TEST(FixedContainersTest, FlatMapAndIntrusiveList) {
+    FlatMap<uint16_t, int, 4> map;
+    EXPECT_TRUE(map.insert(30, 3));
+    EXPECT_TRUE(map.insert(10, 1));
+    EXPECT_TRUE(map.insert(20, 2));
+    EXPECT_TRUE(map.insert(10, 11));                        // Update in place
+    EXPECT_TRUE(map.insert(5, 0));
+    EXPECT_FALSE(map.insert(40, 4));                        // Full, new key
+    EXPECT_TRUE(map.insert(20, 22));                        // Full, existing key
+    ASSERT_NE(nullptr, map.find(10));
+    EXPECT_EQ(11, *map.find(10));
+    EXPECT_EQ(nullptr, map.find(15));
+    std::vector<uint16_t> keys;
+    for (const auto& entry : map) keys.push_back(entry.key);
+    EXPECT_EQ((std::vector<uint16_t>{5, 10, 20, 30}), keys);
+    EXPECT_TRUE(map.erase(5));
+    EXPECT_FALSE(map.erase(5));
+    EXPECT_EQ(3u, map.size());
+    EXPECT_EQ(22, *map.find(20));
+
+    Job a(1), b(2), c(3);
+    IntrusiveList<Job> list;
+    list.push_back(b);
+    list.push_back(c);
+    list.push_front(a);
+    EXPECT_EQ(3u, list.size());
+    EXPECT_TRUE(b.isLinked());
+    list.remove(b);                                         // O(1) from the middle
+    EXPECT_FALSE(b.isLinked());
+    std::vector<int> ids;
+    for (Job& job : list) ids.push_back(job.id);
+    EXPECT_EQ((std::vector<int>{1, 3}), ids);
+    EXPECT_EQ(&a, list.pop_front());
+    EXPECT_EQ(&c, &list.front());
+    EXPECT_EQ(&c, &list.back());
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    EXPECT_FALSE(c.isLinked());
+
+    EXPECT_DEATH(linkTwice(), "already linked");
+}
+
+/**
+ * Test: Migrated hot paths allocate nothing and keep up with std::vector
+ */
+TEST(FixedContainersTest, HotPathBenchmark) {
+    constexpr int FRAMES = 200000;
+    using Clock = std::chrono::steady_clock;
+    int pool[20];
+    for (int i = 0; i < 20; i++) pool[i] = i;
+
+    std::vector<Rect> std_rects;
+    StaticVector<Rect, MAX_RECTS> fixed_rects;
+    std::vector<int*> std_widgets;
+    StaticVector<int*, 32> fixed_widgets;
+
+    auto std_add = [](std::vector<Rect>& v, const Rect& r) { v.push_back(r); };
+    auto std_erase = [](std::vector<Rect>& v, size_t j) { v.erase(v.begin() + j); };
+    auto fixed_add = [](StaticVector<Rect, MAX_RECTS>& v, const Rect& r) { v.push_back(r); };
+    auto fixed_erase = [](StaticVector<Rect, MAX_RECTS>& v, size_t j) { v.eraseUnordered(j); };
+    auto std_widget = [](std::vector<int*>& v, int* w) { v.push_back(w); };
+    auto fixed_widget = [](StaticVector<int*, 32>& v, int* w) { v.push_back(w); };
+
+    // Same inputs through both: identical results
+    uint32_t seed_std = 1, seed_fixed = 1;
+    for (int f = 0; f < 1000; f++) {
+        seed_std = dirtyFrame(std_rects, seed_std, std_add, std_erase);
+        seed_fixed = dirtyFrame(fixed_rects, seed_fixed, fixed_add, fixed_erase);
+        ASSERT_EQ(std_rects.size(), fixed_rects.size());
+    }
+    EXPECT_EQ(widgetFrame(std_widgets, pool, std_widget), widgetFrame(fixed_widgets, pool, fixed_widget));
+
+    // Fresh std::vector per screen change (as on a screen switch): allocates
+    AllocTracker::reset();
+    for (int f = 0; f < 100; f++) {
+        std::vector<int*> widgets;
+        widgetFrame(widgets, pool, std_widget);
+    }
+    uint32_t std_allocs = AllocTracker::getTotals().alloc_count;
+    AllocTracker::reset();
+    for (int f = 0; f < 100; f++) {
+        StaticVector<int*, 32> widgets;
+        widgetFrame(widgets, pool, fixed_widget);
+        dirtyFrame(fixed_rects, seed_fixed, fixed_add, fixed_erase);
+    }
+    EXPECT_GT(std_allocs, 0u);
+    EXPECT_EQ(0u, AllocTracker::getTotals().alloc_count);
+
+    auto time_ns = [&](auto&& body) {
+        auto start = Clock::now();
+        for (int f = 0; f < FRAMES; f++) body(f);
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / FRAMES;
+    };
+    volatile size_t sink = 0;
+    double dirty_std = time_ns([&](int f) { sink = dirtyFrame(std_rects, f, std_add, std_erase); });
+    double dirty_fixed = time_ns([&](int f) { sink = dirtyFrame(fixed_rects, f, fixed_add, fixed_erase); });
+    double widgets_std = time_ns([&](int) {
+        std::vector<int*> widgets;
+        sink = widgetFrame(widgets, pool, std_widget);
+    });
+    double widgets_fixed = time_ns([&](int) {
+        StaticVector<int*, 32> widgets;
+        sink = widgetFrame(widgets, pool, fixed_widget);
+    });
+    (void)sink;
+
+    printf("  dirty rects (8 marks + merge): std::vector %.1f ns, StaticVector %.1f ns\n",
+           dirty_std, dirty_fixed);
+    printf("  widget list (register 20, remove, hit-test): std::vector %.1f ns, StaticVector %.1f ns\n",
+           widgets_std, widgets_fixed);
+
+    // Generous bound: only catches a gross regression, host timing is noisy
+    EXPECT_LT(dirty_fixed, dirty_std * 2.0);
+    EXPECT_LT(widgets_fixed, widgets_std * 2.0);
+}
+
+#endif // NATIVE_BUILD
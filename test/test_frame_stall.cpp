@@ -0,0 +1,156 @@
+/**
+ * Unit Test: FrameStallDetector heartbeat / monitor logic
+ *
+ * Drives the UI-side heartbeats and the monitor poll on the virtual clock
+ * (env:native, FRAME_STALL_DETECT=1). Host builds record no backtrace, so
+ * these tests cover detection, attribution and the persisted ring:
+ * - Frames under the threshold are never recorded
+ * - One record per stalled frame, with phase and final duration
+ * - Stalls between iterations (task not rescheduled) are attributed to IDLE
+ * - Ring keeps the newest RING_SIZE stalls across "reboots" (begin())
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "../src/utils/FrameStallDetector.h"
+
+using Phase = FrameStallDetector::Phase;
+using StallRecord = FrameStallDetector::StallRecord;
+
+class FrameStallTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        arduino_shim::setMillis(1000);
+        FrameStallDetector::begin(100);
+        FrameStallDetector::clear();
+    }
+
+    void TearDown() override {
+        arduino_shim::setMillis(0);
+    }
+
+    // One UI loop iteration that spends `busy_ms` in `phase`, polled every POLL_MS
+    static void frame(Phase phase, uint32_t busy_ms) {
+        FrameStallDetector::frameStart();
+        FrameStallDetector::setPhase(phase);
+        for (uint32_t t = 0; t < busy_ms; t += FrameStallDetector::POLL_MS) {
+            arduino_shim::advanceMillis(FrameStallDetector::POLL_MS);
+            FrameStallDetector::poll();
+        }
+        FrameStallDetector::frameEnd();
+        arduino_shim::advanceMillis(1);   // vTaskDelay(1)
+    }
+};
+
+/**
+ * Test: Normal frames leave no record
+ */
+TEST_F(FrameStallTest, FastFramesNotRecorded) {
+    for (int i = 0; i < 100; i++) {
+        frame(Phase::DRAW, 30);
+    }
+
+    auto stats = FrameStallDetector::getStats();
+    EXPECT_EQ(100u, stats.frames);
+    EXPECT_EQ(0u, stats.stalls);
+    EXPECT_EQ(30u, stats.worst_ms);
+    EXPECT_STREQ("DRAW", FrameStallDetector::phaseName(stats.worst_phase));
+
+    StallRecord records[FrameStallDetector::RING_SIZE];
+    EXPECT_EQ(0u, FrameStallDetector::getStalls(records, FrameStallDetector::RING_SIZE));
+}
+
+/**
+ * Test: A long frame is recorded once, with its phase and final duration
+ */
+TEST_F(FrameStallTest, StalledFrameRecordedOnce) {
+    frame(Phase::DRAW, 30);
+    frame(Phase::STATUS, 250);   // e.g. NVS commit in the status block
+    frame(Phase::DRAW, 30);
+
+    auto stats = FrameStallDetector::getStats();
+    EXPECT_EQ(1u, stats.stalls);
+    EXPECT_EQ(250u, stats.worst_ms);
+
+    StallRecord records[FrameStallDetector::RING_SIZE];
+    ASSERT_EQ(1u, FrameStallDetector::getStalls(records, FrameStallDetector::RING_SIZE));
+    const StallRecord& r = records[0];
+    EXPECT_STREQ("STATUS", FrameStallDetector::phaseName(r.phase));
+    EXPECT_EQ(250u, r.frame_ms);
+    EXPECT_GE(r.detected_ms, 100u);
+    EXPECT_LT(r.detected_ms, 100u + FrameStallDetector::POLL_MS);
+    EXPECT_EQ(1000u + 31, r.uptime_ms);   // Second frame started after 30 ms + delay
+    EXPECT_EQ(0u, r.depth);               // No backtrace on the host
+}
+
+/**
+ * Test: Phase at detection, not at frame end, is recorded
+ */
+TEST_F(FrameStallTest, PhaseAtDetection) {
+    FrameStallDetector::frameStart();
+    FrameStallDetector::setPhase(Phase::PUSH);
+    arduino_shim::advanceMillis(120);
+    EXPECT_TRUE(FrameStallDetector::poll());
+    FrameStallDetector::setPhase(Phase::SLEEP_CHECK);
+    arduino_shim::advanceMillis(10);
+    EXPECT_FALSE(FrameStallDetector::poll());   // Same frame
+    FrameStallDetector::frameEnd();
+
+    StallRecord r;
+    ASSERT_EQ(1u, FrameStallDetector::getStalls(&r, 1));
+    EXPECT_STREQ("PUSH", FrameStallDetector::phaseName(r.phase));
+    EXPECT_EQ(130u, r.frame_ms);
+}
+
+/**
+ * Test: UI task not rescheduled after its delay → IDLE stall, closed by the next frame
+ */
+TEST_F(FrameStallTest, StarvedBetweenFrames) {
+    FrameStallDetector::frameStart();
+    arduino_shim::advanceMillis(20);
+    FrameStallDetector::frameEnd();
+
+    arduino_shim::advanceMillis(150);   // Higher priority work on the UI core
+    EXPECT_TRUE(FrameStallDetector::poll());
+    FrameStallDetector::frameStart();
+
+    StallRecord r;
+    ASSERT_EQ(1u, FrameStallDetector::getStalls(&r, 1));
+    EXPECT_STREQ("IDLE", FrameStallDetector::phaseName(r.phase));
+    EXPECT_EQ(170u, r.frame_ms);   // Whole iteration
+}
+
+/**
+ * Test: Ring keeps the newest stalls across begin() (reboot with RTC memory kept)
+ */
+TEST_F(FrameStallTest, RingPersistsAcrossBoots) {
+    const size_t total = FrameStallDetector::RING_SIZE + 3;
+    for (size_t i = 0; i < total; i++) {
+        frame(Phase::DRAW, 120 + 10 * static_cast<uint32_t>(i));
+    }
+    uint16_t boot = FrameStallDetector::getStats().boot;
+
+    FrameStallDetector::begin(100);   // Reboot
+    auto stats = FrameStallDetector::getStats();
+    EXPECT_EQ(boot + 1, stats.boot);
+    EXPECT_EQ(0u, stats.stalls);      // Per-boot counters reset
+
+    frame(Phase::MONITOR, 400);
+    FrameStallDetector::printReport();
+
+    StallRecord records[FrameStallDetector::RING_SIZE];
+    ASSERT_EQ(FrameStallDetector::RING_SIZE,
+              FrameStallDetector::getStalls(records, FrameStallDetector::RING_SIZE));
+    EXPECT_EQ(boot + 1, records[0].boot);
+    EXPECT_EQ(400u, records[0].frame_ms);
+    EXPECT_EQ(total, records[0].seq);   // Sequence continues across boots
+    for (size_t i = 1; i < FrameStallDetector::RING_SIZE; i++) {
+        EXPECT_EQ(boot, records[i].boot);
+        EXPECT_EQ(records[i - 1].seq - 1, records[i].seq);
+        EXPECT_EQ(120u + 10 * (total - i), records[i].frame_ms);
+    }
+}
+
+#endif  // NATIVE_BUILD
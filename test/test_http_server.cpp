@@ -0,0 +1,364 @@
+/**
+ * Unit Test: HTTP dashboard server over loopback
+ *
+ * Runs HttpServer + Dashboard in env:native on a real 127.0.0.1 socket
+ * (ephemeral port), with static assets from a host directory mounted as
+ * LittleFS. Single-threaded: the test pumps server.poll() while its
+ * non-blocking clients send and read.
+ * - JSON endpoints stream as HTTP chunks from the fixed buffers, without
+ *   heap allocation, and carry timer, Statistics and task data
+ * - Static assets: index, precompressed .gz preferred, 404/405/400
+ * - API routes (/api/...) need the Bearer token (401 without or wrong, 403
+ *   with no token configured); assets stay public
+ * - Concurrent clients: small requests finish while a large download is in
+ *   progress, a full pool answers 503, idle clients time out
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <Preferences.h>
+#include "../src/core/PomodoroSequence.h"
+#include "../src/core/Statistics.h"
+#include "../src/core/SyncPrimitives.h"
+#include "../src/core/TimerStateMachine.h"
+#include "../src/network/Dashboard.h"
+#include "../src/network/HttpServer.h"
+#include "../src/utils/AllocTracker.h"
+
+namespace {
+
+constexpr int64_t EPOCH_2025_01_10 = 1736467200;
+constexpr const char* TOKEN = "s3cret-dashboard-token";
+
+struct Reply {
+    int status = 0;
+    std::string headers;
+    std::string body;
+    size_t chunks = 0;     // Chunked responses: data chunks received
+    bool complete = false; // Connection closed by the server
+
+    bool hasHeader(const std::string& line) const { return headers.find(line) != std::string::npos; }
+};
+
+size_t count(const std::string& text, const char* needle) {
+    size_t n = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        n++;
+    }
+    return n;
+}
+
+// Non-blocking loopback client
+class Client {
+public:
+    explicit Client(uint16_t port) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        connected_ = connect(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0;
+        fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    ~Client() { close(fd_); }
+
+    bool connected() const { return connected_; }
+    bool send(const std::string& text) { return ::send(fd_, text.data(), text.size(), 0) == (ssize_t)text.size(); }
+
+    // Read what is available; true once the server closed the connection
+    bool drain() {
+        char buffer[4096];
+        while (true) {
+            ssize_t n = recv(fd_, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                raw_.append(buffer, n);
+            } else {
+                if (n == 0) closed_ = true;
+                return closed_;
+            }
+        }
+    }
+
+    const std::string& raw() const { return raw_; }
+
+    Reply reply() const {
+        Reply reply;
+        reply.complete = closed_;
+        size_t end = raw_.find("\r\n\r\n");
+        if (end == std::string::npos) return reply;
+        reply.headers = raw_.substr(0, end + 2);
+        sscanf(raw_.c_str(), "HTTP/1.1 %d", &reply.status);
+        std::string body = raw_.substr(end + 4);
+        if (!reply.hasHeader("Transfer-Encoding: chunked")) {
+            reply.body = body;
+            return reply;
+        }
+        size_t pos = 0;
+        while (pos < body.size()) {
+            size_t line_end = body.find("\r\n", pos);
+            if (line_end == std::string::npos) break;
+            size_t size = strtoul(body.substr(pos, line_end - pos).c_str(), nullptr, 16);
+            if (size == 0) break;
+            reply.body += body.substr(line_end + 2, size);
+            reply.chunks++;
+            pos = line_end + 2 + size + 2;
+        }
+        return reply;
+    }
+
+private:
+    int fd_ = -1;
+    bool connected_ = false;
+    bool closed_ = false;
+    std::string raw_;
+};
+
+}  // namespace
+
+class HttpServerTest : public ::testing::Test {
+protected:
+    PomodoroSequence sequence;
+    TimerStateMachine timer{sequence};
+    Statistics statistics;
+    HttpServer server;
+    Dashboard dashboard{timer, sequence, statistics};
+    std::string root_;
+
+    void SetUp() override {
+        char dir_template[] = "/tmp/http_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir_template));
+        root_ = dir_template;
+        std::filesystem::create_directories(root_ + "/www");
+        fs_shim::mount(root_.c_str());
+
+        preferences_shim::clearAll();
+        initSyncPrimitives();
+        arduino_shim::setMillis(1000);
+        arduino_shim::setEpoch(EPOCH_2025_01_10);
+        ASSERT_TRUE(statistics.begin());
+
+        dashboard.registerRoutes(server);
+        server.setAccessToken(TOKEN);
+        ASSERT_TRUE(LittleFS.begin());
+        server.setAssets(&LittleFS);
+        ASSERT_TRUE(server.begin(0));
+        ASSERT_NE(0, server.getPort());
+    }
+
+    void TearDown() override {
+        server.end();
+        cleanupSyncPrimitives();
+        fs_shim::unmount();
+        std::filesystem::remove_all(root_);
+        arduino_shim::setEpoch(0);
+        arduino_shim::setMillis(0);
+    }
+
+    void writeAsset(const char* path, const std::string& contents) {
+        std::ofstream out(root_ + "/www" + path, std::ios::binary);
+        out << contents;
+    }
+
+    // One server iteration, allocations attributed to NETWORK
+    void pump() {
+        ALLOC_SCOPE(NETWORK);
+        server.poll(1);
+    }
+
+    Reply get(const std::string& request_line) {
+        return get(request_line, std::string("Authorization: Bearer ") + TOKEN + "\r\n");
+    }
+
+    Reply get(const std::string& request_line, const std::string& headers) {
+        Client client(server.getPort());
+        EXPECT_TRUE(client.connected());
+        client.send(request_line + "\r\nHost: m5\r\n" + headers + "\r\n");
+        for (int i = 0; i < 1000 && !client.drain(); i++) {
+            pump();
+        }
+        return client.reply();
+    }
+};
+
+/**
+ * Test: JSON endpoints stream in chunks without heap allocation
+ */
+TEST_F(HttpServerTest, JsonEndpointsStreamInChunks) {
+    statistics.recordWorkSession(25, true);
+    statistics.recordWorkSession(25, true);
+    statistics.recordWorkSession(25, false);
+    ASSERT_TRUE(timer.handleEvent(TimerStateMachine::Event::START));
+
+    Reply timer_reply = get("GET /api/timer HTTP/1.1");
+    ASSERT_TRUE(timer_reply.complete);
+    EXPECT_EQ(200, timer_reply.status);
+    EXPECT_TRUE(timer_reply.hasHeader("Content-Type: application/json"));
+    EXPECT_TRUE(timer_reply.hasHeader("Transfer-Encoding: chunked"));
+    EXPECT_EQ(1u, timer_reply.chunks);
+    EXPECT_NE(std::string::npos, timer_reply.body.find("\"state\":\"ACTIVE\""));
+    EXPECT_NE(std::string::npos, timer_reply.body.find("\"type\":\"work\""));
+    EXPECT_NE(std::string::npos, timer_reply.body.find("\"total_ms\":1500000"));
+
+    // Serving a route allocates nothing (fixed buffers, no String)
+    auto before = AllocTracker::getStats(AllocTracker::Subsystem::NETWORK);
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(200, get("GET /api/timer HTTP/1.1").status);
+    }
+    auto after = AllocTracker::getStats(AllocTracker::Subsystem::NETWORK);
+    EXPECT_EQ(before.alloc_count, after.alloc_count);
+
+    // 90 days do not fit in one chunk: pieces continue in the next
+    Reply stats = get("GET /api/stats?days=90 HTTP/1.1");
+    ASSERT_TRUE(stats.complete);
+    EXPECT_EQ(200, stats.status);
+    EXPECT_GE(stats.chunks, 6u);
+    EXPECT_EQ(90u, count(stats.body, "\"date\":"));
+    EXPECT_EQ('{', stats.body.front());
+    EXPECT_EQ('}', stats.body.back());
+    char today[80];
+    snprintf(today, sizeof(today), "{\"date\":%lu,\"completed\":2,\"work_min\":50,\"break_min\":0,"
+             "\"interruptions\":1}", (unsigned long)(EPOCH_2025_01_10 / 86400));
+    EXPECT_NE(std::string::npos, stats.body.find(today));
+    EXPECT_EQ(7u, count(get("GET /api/stats HTTP/1.1").body, "\"date\":"));   // Default
+
+    Reply tasks = get("GET /api/tasks HTTP/1.1");
+    EXPECT_EQ(200, tasks.status);
+    EXPECT_NE(std::string::npos, tasks.body.find("\"tasks\":["));
+    EXPECT_NE(std::string::npos, tasks.body.find("\"http\":{\"requests\":"));
+}
+
+/**
+ * Test: Static assets from LittleFS, gzip preferred, error statuses
+ */
+TEST_F(HttpServerTest, ServesStaticAssets) {
+    std::string page = "<!DOCTYPE html><title>M5</title>";
+    std::string script(5000, 'x');
+    std::string script_gz = std::string("\x1f\x8b", 2) + std::string(700, 'z');
+    writeAsset("/index.html", page);
+    writeAsset("/app.js", script);
+    writeAsset("/app.js.gz", script_gz);
+
+    Reply index = get("GET / HTTP/1.1");
+    ASSERT_TRUE(index.complete);
+    EXPECT_EQ(200, index.status);
+    EXPECT_TRUE(index.hasHeader("Content-Type: text/html"));
+    EXPECT_TRUE(index.hasHeader("Content-Length: " + std::to_string(page.size())));
+    EXPECT_EQ(page, index.body);
+
+    Reply js = get("GET /app.js HTTP/1.1");
+    EXPECT_EQ(200, js.status);
+    EXPECT_TRUE(js.hasHeader("Content-Encoding: gzip"));
+    EXPECT_TRUE(js.hasHeader("Content-Type: application/javascript"));
+    EXPECT_EQ(script_gz, js.body);
+
+    EXPECT_EQ(404, get("GET /missing.css HTTP/1.1").status);
+    EXPECT_EQ(404, get("GET /../etc/passwd HTTP/1.1").status);
+    EXPECT_EQ(405, get("POST /api/timer HTTP/1.1").status);
+    EXPECT_EQ(400, get("GARBAGE").status);
+
+    auto stats = server.getStats();
+    EXPECT_EQ(2u, stats.assets);
+    EXPECT_EQ(4u, stats.errors);
+    EXPECT_EQ(0u, stats.active);
+}
+
+/**
+ * Test: JSON API needs the shared secret, assets do not
+ */
+TEST_F(HttpServerTest, ApiRequiresToken) {
+    writeAsset("/index.html", "<!DOCTYPE html>");
+
+    Reply missing = get("GET /api/timer HTTP/1.1", "");
+    EXPECT_EQ(401, missing.status);
+    EXPECT_TRUE(missing.hasHeader("WWW-Authenticate: Bearer"));
+    EXPECT_TRUE(missing.body.empty());
+    EXPECT_EQ(401, get("GET /api/stats?days=7 HTTP/1.1", "Authorization: Bearer wrong\r\n").status);
+    EXPECT_EQ(401, get("GET /api/tasks HTTP/1.1",
+                       std::string("Authorization: Bearer ") + TOKEN + "x\r\n").status);
+    EXPECT_EQ(401, get("GET /api/timer HTTP/1.1",
+                       std::string("Authorization: Basic ") + TOKEN + "\r\n").status);
+    EXPECT_EQ(401, get("GET /api/nope HTTP/1.1", "").status);   // No route probing
+
+    // Header name and scheme are case-insensitive
+    EXPECT_EQ(200, get("GET /api/timer HTTP/1.1",
+                       std::string("authorization: bearer ") + TOKEN + "\r\n").status);
+    EXPECT_EQ(200, get("GET / HTTP/1.1", "").status);
+    EXPECT_EQ(5u, server.getStats().unauthorized);
+
+    // No token configured: the API is closed
+    server.setAccessToken("");
+    EXPECT_EQ(403, get("GET /api/timer HTTP/1.1", "Authorization: Bearer \r\n").status);
+    server.setAccessToken(nullptr);
+    EXPECT_EQ(403, get("GET /api/timer HTTP/1.1").status);
+    EXPECT_EQ(7u, server.getStats().unauthorized);
+}
+
+/**
+ * Test: Concurrent clients - interleaved, pool full answers 503, idle ones time out
+ */
+TEST_F(HttpServerTest, ConcurrentClientsShareThePoll) {
+    std::string big(64 * 1024, 'b');
+    writeAsset("/big.bin", big);
+
+    // Large download and a JSON request at the same time
+    Client download(server.getPort());
+    Client json(server.getPort());
+    download.send("GET /big.bin HTTP/1.1\r\n\r\n");
+    json.send(std::string("GET /api/stats?days=30 HTTP/1.1\r\nAuthorization: Bearer ") + TOKEN + "\r\n\r\n");
+    int json_done = -1;
+    int download_done = -1;
+    for (int i = 0; i < 1000 && (json_done < 0 || download_done < 0); i++) {
+        pump();
+        if (json_done < 0 && json.drain()) json_done = i;
+        if (download_done < 0 && download.drain()) download_done = i;
+    }
+    ASSERT_GE(json_done, 0);
+    ASSERT_GE(download_done, 0);
+    EXPECT_LT(json_done, download_done);   // Not queued behind the download
+    EXPECT_GE(download_done, static_cast<int>(big.size() / HttpServer::CHUNK_SIZE));
+    EXPECT_EQ(big, download.reply().body);
+    EXPECT_EQ(30u, count(json.reply().body, "\"date\":"));
+
+    // Fill the pool with clients that never finish their request
+    Client idle1(server.getPort()), idle2(server.getPort());
+    Client idle3(server.getPort()), idle4(server.getPort());
+    idle1.send("GET /api/timer HTTP/1.1\r\n");
+    for (int i = 0; i < 5; i++) pump();
+    EXPECT_EQ(HttpServer::MAX_CLIENTS, server.getStats().active);
+
+    Client rejected(server.getPort());
+    for (int i = 0; i < 20 && !rejected.drain(); i++) pump();
+    EXPECT_EQ(503, rejected.reply().status);
+    EXPECT_EQ(1u, server.getStats().rejected);
+
+    idle1.send(std::string("Authorization: Bearer ") + TOKEN + "\r\n\r\n");
+    idle1.send("\r\n");
+    for (int i = 0; i < 20 && !idle1.drain(); i++) pump();
+    EXPECT_EQ(200, idle1.reply().status);
+
+    // The rest time out
+    arduino_shim::advanceMillis(HttpServer::IDLE_TIMEOUT_MS);
+    pump();
+    EXPECT_TRUE(idle2.drain());
+    EXPECT_TRUE(idle3.drain());
+    EXPECT_TRUE(idle4.drain());
+    auto stats = server.getStats();
+    EXPECT_EQ(3u, stats.timeouts);
+    EXPECT_EQ(0u, stats.active);
+    EXPECT_EQ(HttpServer::MAX_CLIENTS, stats.peak_active);
+}
+
+#endif  // NATIVE_BUILD
@@ -0,0 +1,245 @@
+/**
+ * Unit Test: Input trace recording and deterministic UI replay
+ *
+ * Records inputs through the real hooks (ScreenManager, env:native with
+ * INPUT_TRACE=1), serializes and decodes the trace, and replays it against
+ * the native UI build:
+ * - Record layout, GAP records for long idle periods, full-buffer drops
+ * - Round trip recorder → bytes → Reader
+ * - Replay reaches the same screens / timer state as the inputs imply
+ * - Replays of the same trace are deterministic (redraws, pixels, waits)
+ * - Every event is resolved by the next frame
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "sim/InputReplayer.h"
+#include "../src/utils/InputTrace.h"
+
+using EventType = InputTrace::EventType;
+
+class InputTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        arduino_shim::setMillis(1000);
+        InputTrace::begin(1735722000);
+    }
+
+    void TearDown() override {
+        InputTrace::stop();
+        arduino_shim::setMillis(0);
+    }
+
+    // Record one event at trace time t_ms (relative to begin())
+    static void recordAt(uint32_t t_ms, EventType type, uint8_t arg = 0, int16_t x = 0, int16_t y = 0) {
+        arduino_shim::setMillis(1000 + t_ms);
+        InputTrace::record(type, arg, x, y);
+    }
+
+    static void tap(uint32_t t_ms, int16_t x, int16_t y) {
+        recordAt(t_ms, EventType::TOUCH_DOWN, 0, x, y);
+        recordAt(t_ms + 80, EventType::TOUCH_UP, 0, x, y);
+    }
+
+    static std::vector<uint8_t> drainAll() {
+        std::vector<uint8_t> bytes(sizeof(InputTrace::Header) +
+                                   InputTrace::BUFFER_RECORDS * sizeof(InputTrace::Record));
+        size_t len = InputTrace::drain(bytes.data(), bytes.size());
+        bytes.resize(len);
+        return bytes;
+    }
+
+    // Start, pause (→ PAUSE screen), resume, stats and back, then settings
+    static std::vector<uint8_t> sessionTrace() {
+        recordAt(500, EventType::BUTTON, InputTrace::BUTTON_A);    // Start
+        recordAt(5000, EventType::BUTTON, InputTrace::BUTTON_A);   // Pause → PauseScreen
+        recordAt(8000, EventType::BUTTON, InputTrace::BUTTON_A);   // Resume
+        recordAt(9000, EventType::BUTTON, InputTrace::BUTTON_B);   // Stats
+        tap(10000, 160, 120);
+        recordAt(11000, EventType::BUTTON, InputTrace::BUTTON_A);  // Back to main
+        recordAt(12000, EventType::BUTTON, InputTrace::BUTTON_C);  // Settings
+        tap(13000, 40, 100);
+        recordAt(14000, EventType::IMU_GESTURE, 1);
+        return drainAll();
+    }
+};
+
+/**
+ * Test: Header + 8-byte records, round trip through the Reader
+ */
+TEST_F(InputTraceTest, RoundTrip) {
+    recordAt(100, EventType::BUTTON, InputTrace::BUTTON_B);
+    recordAt(250, EventType::TOUCH_DOWN, 0, 12, 200);
+    recordAt(250, EventType::TOUCH_UP, 0, 14, 201);
+
+    std::vector<uint8_t> bytes = drainAll();
+    ASSERT_EQ(sizeof(InputTrace::Header) + 3 * sizeof(InputTrace::Record), bytes.size());
+
+    InputTrace::Reader reader(bytes.data(), bytes.size());
+    ASSERT_TRUE(reader.valid());
+    EXPECT_EQ(1000u, reader.header().start_ms);
+    EXPECT_EQ(1735722000u, reader.header().start_epoch);
+
+    InputTrace::Event event;
+    ASSERT_TRUE(reader.next(event));
+    EXPECT_EQ(100u, event.t_ms);
+    EXPECT_EQ(EventType::BUTTON, event.type);
+    EXPECT_EQ(InputTrace::BUTTON_B, event.arg);
+    ASSERT_TRUE(reader.next(event));
+    EXPECT_EQ(250u, event.t_ms);
+    EXPECT_EQ(EventType::TOUCH_DOWN, event.type);
+    EXPECT_EQ(12, event.x);
+    EXPECT_EQ(200, event.y);
+    ASSERT_TRUE(reader.next(event));
+    EXPECT_EQ(EventType::TOUCH_UP, event.type);
+    EXPECT_FALSE(reader.next(event));
+
+    // Header only once: later drains continue the record stream
+    recordAt(300, EventType::BUTTON, InputTrace::BUTTON_C);
+    EXPECT_EQ(sizeof(InputTrace::Record), drainAll().size());
+
+    // Corrupt magic is rejected
+    bytes[0] = 'X';
+    InputTrace::Reader bad(bytes.data(), bytes.size());
+    EXPECT_FALSE(bad.valid());
+    EXPECT_FALSE(bad.next(event));
+}
+
+/**
+ * Test: Idle periods longer than 65.5s are bridged with GAP records
+ */
+TEST_F(InputTraceTest, LongGapsKeepAbsoluteTime) {
+    recordAt(10, EventType::BUTTON, InputTrace::BUTTON_A);
+    recordAt(10 + 3 * 60 * 60 * 1000, EventType::BUTTON, InputTrace::BUTTON_A);   // 3 hours later
+
+    std::vector<uint8_t> bytes = drainAll();
+    size_t records = (bytes.size() - sizeof(InputTrace::Header)) / sizeof(InputTrace::Record);
+    EXPECT_EQ(2u + (3 * 60 * 60 * 1000) / 65536, records);
+
+    InputTrace::Reader reader(bytes.data(), bytes.size());
+    InputTrace::Event event;
+    ASSERT_TRUE(reader.next(event));
+    ASSERT_TRUE(reader.next(event));
+    EXPECT_EQ(10u + 3 * 60 * 60 * 1000, event.t_ms);
+    EXPECT_FALSE(reader.next(event));
+}
+
+/**
+ * Test: A full buffer drops new events, the next stored one keeps its time
+ */
+TEST_F(InputTraceTest, FullBufferDropsAndCounts) {
+    for (uint32_t i = 0; i < InputTrace::BUFFER_RECORDS + 10; i++) {
+        recordAt(i, EventType::TOUCH_DOWN, 0, 1, 1);
+    }
+    auto stats = InputTrace::getStats();
+    EXPECT_EQ(InputTrace::BUFFER_RECORDS, stats.recorded);
+    EXPECT_EQ(10u, stats.dropped);
+    EXPECT_EQ(InputTrace::BUFFER_RECORDS, stats.pending);
+
+    std::vector<uint8_t> first = drainAll();
+    recordAt(5000, EventType::BUTTON, InputTrace::BUTTON_A);
+    std::vector<uint8_t> second = drainAll();
+    first.insert(first.end(), second.begin(), second.end());
+
+    InputTrace::Reader reader(first.data(), first.size());
+    InputTrace::Event event;
+    uint32_t count = 0;
+    while (reader.next(event)) count++;
+    EXPECT_EQ(InputTrace::BUFFER_RECORDS + 1, count);
+    EXPECT_EQ(5000u, event.t_ms);
+}
+
+/**
+ * Test: The ScreenManager hooks record what the UI consumed
+ */
+TEST_F(InputTraceTest, ReplayRecordsThroughHooks) {
+    std::vector<uint8_t> trace = sessionTrace();
+    InputTrace::Reader reader(trace.data(), trace.size());
+
+    // Replay with recording on: the hooks re-record the same inputs
+    // (replay clock starts at 0, so trace times line up)
+    arduino_shim::setMillis(0);
+    InputTrace::begin();
+    InputReplayer replayer;
+    auto report = replayer.run(reader);
+    std::vector<uint8_t> rerecorded = drainAll();
+
+    InputTrace::Reader original(trace.data(), trace.size());
+    InputTrace::Reader copy(rerecorded.data(), rerecorded.size());
+    InputTrace::Event a, b;
+    uint32_t compared = 0;
+    while (original.next(a)) {
+        if (a.type == EventType::IMU_GESTURE) continue;   // No GyroController in the replay
+        ASSERT_TRUE(copy.next(b));
+        EXPECT_EQ(a.type, b.type);
+        EXPECT_EQ(a.arg, b.arg);
+        EXPECT_EQ(a.x, b.x);
+        EXPECT_EQ(a.y, b.y);
+        EXPECT_EQ(a.t_ms, b.t_ms);
+        compared++;
+    }
+    EXPECT_FALSE(copy.next(b));
+    EXPECT_EQ(report.events.size() - 1, compared);
+}
+
+/**
+ * Test: Replay drives the real UI and reports per-event latency
+ */
+TEST_F(InputTraceTest, ReplayNavigatesAndMeasures) {
+    std::vector<uint8_t> trace = sessionTrace();
+    InputTrace::Reader reader(trace.data(), trace.size());
+
+    InputReplayer replayer;
+    auto report = replayer.run(reader);
+    report.print();
+
+    ASSERT_EQ(11u, report.events.size());
+    EXPECT_EQ(ScreenID::SETTINGS, report.final_screen);
+    EXPECT_EQ(TimerStateMachine::State::ACTIVE, report.final_state);
+
+    // ~15s of trace at 33ms frames
+    EXPECT_GE(report.frames, 14000u / 33);
+    EXPECT_GT(report.redraw_frames, 0u);
+    EXPECT_LE(report.redraw_frames, report.frames);
+    EXPECT_GE(report.frame_us_max, report.frame_us_p99);
+    EXPECT_GE(report.frame_us_p99, report.frame_us_p50);
+
+    for (const auto& e : report.events) {
+        EXPECT_LE(e.wait_ms, 33u);   // Resolved by the next frame
+        EXPECT_EQ(e.event.type != EventType::IMU_GESTURE, e.applied);
+    }
+
+    // Button presses always change the screen or the timer display
+    const auto& buttons = report.per_type[static_cast<uint8_t>(EventType::BUTTON)];
+    EXPECT_EQ(6u, buttons.count);
+    EXPECT_EQ(6u, buttons.redrawn);
+    EXPECT_EQ(1u, report.per_type[static_cast<uint8_t>(EventType::IMU_GESTURE)].count);
+}
+
+/**
+ * Test: Same trace, same redraws and waits
+ */
+TEST_F(InputTraceTest, ReplayIsDeterministic) {
+    std::vector<uint8_t> trace = sessionTrace();
+
+    InputTrace::Reader first_reader(trace.data(), trace.size());
+    InputReplayer replayer;
+    auto first = replayer.run(first_reader);
+
+    InputTrace::Reader second_reader(trace.data(), trace.size());
+    auto second = replayer.run(second_reader);
+
+    EXPECT_EQ(first.frames, second.frames);
+    EXPECT_EQ(first.redraw_frames, second.redraw_frames);
+    EXPECT_EQ(first.pixels_pushed, second.pixels_pushed);
+    EXPECT_EQ(first.final_screen, second.final_screen);
+    ASSERT_EQ(first.events.size(), second.events.size());
+    for (size_t i = 0; i < first.events.size(); i++) {
+        EXPECT_EQ(first.events[i].wait_ms, second.events[i].wait_ms);
+        EXPECT_EQ(first.events[i].redrawn, second.events[i].redrawn);
+    }
+}
+
+#endif  // NATIVE_BUILD
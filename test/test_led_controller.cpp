@@ -0,0 +1,70 @@
+/**
+ * Unit Test: LEDController milestone timing
+ *
+ * Runs the real LEDController in env:native (FastLED shim, simulated RMT
+ * strip; the test raises the TX-end interrupt after each frame):
+ * - Confetti milestone lasts its duration and then turns the LEDs off
+ * - A milestone started just before the millis() wraparound still lasts
+ *   its full duration
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "../src/core/SyncPrimitives.h"
+#include "../src/hardware/LEDController.h"
+#include "../src/hardware/LEDStripRMT.h"
+
+namespace {
+
+// Frames until the confetti ends, in 100 ms steps (capped at limit_ms)
+uint32_t confettiMs(LEDController& leds, uint32_t limit_ms) {
+    uint32_t elapsed = 0;
+    while (leds.getPattern() == ILEDController::Pattern::CONFETTI && elapsed < limit_ms) {
+        arduino_shim::advanceMillis(100);
+        elapsed += 100;
+        leds.update();
+        LEDStripRMT::onTxEnd(0);
+    }
+    return elapsed;
+}
+
+}  // namespace
+
+class LEDControllerTest : public ::testing::Test {
+protected:
+    void SetUp() override { initSyncPrimitives(); }
+
+    void TearDown() override {
+        cleanupSyncPrimitives();
+        arduino_shim::setMillis(0);
+    }
+};
+
+/**
+ * Test: Milestone runs its duration, then the LEDs go off
+ */
+TEST_F(LEDControllerTest, MilestoneLastsItsDuration) {
+    arduino_shim::setMillis(5000);
+    LEDController leds;
+    ASSERT_TRUE(leds.begin());
+    leds.triggerMilestone(3000);
+    EXPECT_EQ(ILEDController::Pattern::CONFETTI, leds.getPattern());
+    EXPECT_EQ(3000u, confettiMs(leds, 10000));
+    EXPECT_EQ(ILEDController::Pattern::OFF, leds.getPattern());
+}
+
+/**
+ * Test: Confetti started 3 s before the millis() wrap runs its full 10 s
+ */
+TEST_F(LEDControllerTest, MilestoneSurvivesMillisWraparound) {
+    arduino_shim::setMillis(0u - 3000u);
+    LEDController leds;
+    ASSERT_TRUE(leds.begin());
+    leds.triggerMilestone(10000);
+    EXPECT_EQ(10000u, confettiMs(leds, 20000));
+    EXPECT_EQ(ILEDController::Pattern::OFF, leds.getPattern());
+}
+
+#endif // NATIVE_BUILD
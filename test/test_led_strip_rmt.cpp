@@ -0,0 +1,124 @@
+/**
+ * Unit Test: Non-blocking RMT LED strip output
+ *
+ * Runs LEDStripRMT in env:native, where transmission is simulated and the
+ * test raises the TX-end interrupt with onTxEnd():
+ * - Frame encoding: GRB order, MSB first, SK6812 bit timing, latch on the last bit
+ * - Global scale matches FastLED scale8
+ * - show() while busy keeps only the newest frame; service() sends it after TX end
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "../src/hardware/LEDStripRMT.h"
+
+using Item = LEDStripRMT::Item;
+
+namespace {
+
+uint8_t decodeByte(const Item* items) {
+    uint8_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = static_cast<uint8_t>(value << 1);
+        if (items[i].duration0 == LEDStripRMT::T1H_TICKS) value |= 1;
+    }
+    return value;
+}
+
+void onDone(void* arg) {
+    (*static_cast<int*>(arg))++;
+}
+
+}  // namespace
+
+/**
+ * Test: Pixels become 24 items each, GRB order, SK6812 timing, latch appended
+ */
+TEST(LEDStripRMTTest, EncodesGrbWithTiming) {
+    const uint8_t rgb[6] = {0x80, 0x01, 0xFF, 0x12, 0x34, 0x56};
+    Item items[LEDStripRMT::MAX_ITEMS];
+
+    ASSERT_EQ(48u, LEDStripRMT::encode(rgb, 2, 255, items));
+
+    EXPECT_EQ(0x01, decodeByte(items + 0));    // G
+    EXPECT_EQ(0x80, decodeByte(items + 8));    // R
+    EXPECT_EQ(0xFF, decodeByte(items + 16));   // B
+    EXPECT_EQ(0x34, decodeByte(items + 24));
+    EXPECT_EQ(0x12, decodeByte(items + 32));
+    EXPECT_EQ(0x56, decodeByte(items + 40));
+
+    for (size_t i = 0; i < 47; i++) {
+        bool one = items[i].duration0 == LEDStripRMT::T1H_TICKS;
+        EXPECT_EQ(1u, items[i].level0);
+        EXPECT_EQ(0u, items[i].level1);
+        EXPECT_EQ(one ? LEDStripRMT::T1L_TICKS : LEDStripRMT::T0L_TICKS, items[i].duration1);
+    }
+    // Last bit (B 0x56 LSB = 0) is followed by the 80 µs reset
+    EXPECT_EQ(LEDStripRMT::T0L_TICKS + LEDStripRMT::RESET_TICKS, items[47].duration1);
+
+    // Oversized frames are clipped to the strip
+    uint8_t big[3 * 12] = {};
+    EXPECT_EQ(LEDStripRMT::MAX_ITEMS, LEDStripRMT::encode(big, 12, 255, items));
+}
+
+/**
+ * Test: Global scale is FastLED scale8 (what FastLED.setBrightness() did)
+ */
+TEST(LEDStripRMTTest, AppliesGlobalScale) {
+    const uint8_t rgb[3] = {200, 255, 1};
+    Item items[24];
+
+    LEDStripRMT::encode(rgb, 1, 127, items);
+    EXPECT_EQ(127, decodeByte(items + 0));     // G 255 → 127
+    EXPECT_EQ(100, decodeByte(items + 8));     // R 200 → 100
+    EXPECT_EQ(0, decodeByte(items + 16));      // B 1 → 0
+
+    LEDStripRMT::encode(rgb, 1, 0, items);
+    EXPECT_EQ(0, decodeByte(items + 0));
+}
+
+/**
+ * Test: show() never waits; frames arriving mid-transmission coalesce
+ */
+TEST(LEDStripRMTTest, CoalescesWhileBusy) {
+    LEDStripRMT strip(25, 10, 0);
+    uint8_t frame[30] = {};
+
+    EXPECT_FALSE(strip.show(frame, 10));       // Not started
+    ASSERT_TRUE(strip.begin());
+
+    int done = 0;
+    strip.setDoneCallback(onDone, &done);
+
+    ASSERT_TRUE(strip.show(frame, 10));        // Straight to the wire
+    EXPECT_TRUE(strip.isBusy());
+    EXPECT_FALSE(strip.hasPending());
+
+    frame[0] = 1;
+    EXPECT_TRUE(strip.show(frame, 10));        // Busy: kept pending
+    frame[0] = 2;
+    EXPECT_TRUE(strip.show(frame, 10));        // Replaces the pending frame
+    EXPECT_TRUE(strip.hasPending());
+    EXPECT_FALSE(strip.service());             // Still on the wire
+
+    LEDStripRMT::onTxEnd(0);                   // TX-end interrupt
+    EXPECT_EQ(1, done);
+    EXPECT_FALSE(strip.isBusy());
+
+    EXPECT_TRUE(strip.service());              // Newest frame goes out
+    EXPECT_FALSE(strip.hasPending());
+    LEDStripRMT::onTxEnd(0);
+    LEDStripRMT::onTxEnd(3);                   // Other channels are ignored
+
+    LEDStripRMT::Stats stats = strip.getStats();
+    EXPECT_EQ(2u, stats.frames);
+    EXPECT_EQ(2u, stats.completed);
+    EXPECT_EQ(1u, stats.coalesced);
+    EXPECT_EQ(0u, stats.errors);
+    EXPECT_EQ(2, done);
+    EXPECT_TRUE(strip.waitDone(10));
+}
+
+#endif  // NATIVE_BUILD
@@ -0,0 +1,197 @@
+/**
+ * Microbenchmarks: core primitives against a tracked baseline
+ *
+ * Times the hot primitives in env:native with MicroBench and compares each
+ * case to test/bench/baseline.txt (time per op within the tolerance,
+ * heap allocations per op exact):
+ * - Renderer: Rect::intersects/merge, Color RGB888 → RGB565, markDirty()
+ *   + update() (merge pass) on random scattered, overlapping and overflowing
+ *   dirty rect workloads (no canvas: the push itself costs nothing)
+ * - PomodoroSequence lookups, Statistics aggregates over 90 days in the
+ *   Preferences shim
+ * - TouchEventManager::handleTouch() press + release over 8 and 32 widgets,
+ *   LEDController pattern ticks (pulse, rainbow, confetti) through the
+ *   FastLED shim and LEDStripRMT encoding
+ *
+ * After an intended change in speed: MICROBENCH_UPDATE=1 and commit the
+ * rewritten baseline with the change.
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <Preferences.h>
+#include <string>
+#include "../src/core/PomodoroSequence.h"
+#include "../src/core/Statistics.h"
+#include "../src/core/SyncPrimitives.h"
+#include "../src/hardware/LEDController.h"
+#include "../src/ui/Renderer.h"
+#include "../src/ui/TouchEventManager.h"
+#include "bench/MicroBench.h"
+#include "mocks/MockWidget.h"
+
+namespace {
+
+constexpr int64_t EPOCH_2025_01_10 = 1736467200;
+constexpr int HISTORY_DAYS = 90;   // Statistics keeps 90 days
+
+std::string baselinePath() {
+    const char* path = getenv("MICROBENCH_BASELINE");
+    if (path) return path;
+    std::string file = __FILE__;
+    size_t slash = file.find_last_of('/');
+    return (slash == std::string::npos ? std::string(".") : file.substr(0, slash)) + "/bench/baseline.txt";
+}
+
+// Deterministic pool of random rects (generated outside the timed loop)
+std::vector<Renderer::Rect> randomRects(size_t count, uint32_t seed, int16_t max_x, int16_t max_y,
+                                        int16_t min_size, int16_t max_size) {
+    std::vector<Renderer::Rect> rects;
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int16_t w = static_cast<int16_t>(min_size + (seed >> 4) % (max_size - min_size + 1));
+        int16_t h = static_cast<int16_t>(min_size + (seed >> 12) % (max_size - min_size + 1));
+        rects.push_back({static_cast<int16_t>((seed >> 8) % max_x), static_cast<int16_t>((seed >> 16) % max_y), w, h});
+    }
+    return rects;
+}
+
+}  // namespace
+
+/**
+ * Test: Renderer rect math, color conversion and dirty rect workloads
+ */
+TEST(MicroBenchTest, RendererPrimitives) {
+    MicroBench bench(baselinePath().c_str());
+    auto pool = randomRects(256, 1, 300, 220, 4, 60);
+
+    EXPECT_TRUE(bench.expect("rect.intersects", 200000, [&](uint32_t i) {
+        MicroBench::keep(pool[i & 255].intersects(pool[(i * 7 + 3) & 255]));
+    }));
+    EXPECT_TRUE(bench.expect("rect.merge", 200000, [&](uint32_t i) {
+        Renderer::Rect rect = pool[i & 255];
+        rect.merge(pool[(i * 7 + 3) & 255]);
+        MicroBench::keep(rect);
+    }));
+    EXPECT_TRUE(bench.expect("color.rgb888_to_565", 200000, [&](uint32_t i) {
+        Renderer::Color c(static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 3), static_cast<uint8_t>(i >> 7));
+        MicroBench::keep(c.rgb565);
+    }));
+
+    // One frame = marks + update(); workloads shaped like real screens
+    Renderer renderer;
+    auto scattered = randomRects(8 * 64, 2, 300, 220, 4, 24);      // Few overlaps
+    auto clustered = randomRects(8 * 64, 3, 80, 60, 10, 40);       // Mostly merge
+    auto overflow = randomRects(14 * 64, 4, 310, 230, 2, 6);       // > MAX_DIRTY_RECTS
+    auto frame = [&](const std::vector<Renderer::Rect>& rects, size_t per_frame, uint32_t i) {
+        const Renderer::Rect* marks = &rects[(i & 63) * per_frame];
+        for (size_t n = 0; n < per_frame; n++) {
+            renderer.markDirty(marks[n].x, marks[n].y, marks[n].w, marks[n].h);
+        }
+        renderer.update();
+    };
+
+    EXPECT_TRUE(bench.expect("renderer.dirty_scattered", 20000, [&](uint32_t i) { frame(scattered, 8, i); }));
+    EXPECT_TRUE(bench.expect("renderer.dirty_clustered", 20000, [&](uint32_t i) { frame(clustered, 8, i); }));
+    EXPECT_TRUE(bench.expect("renderer.dirty_overflow", 20000, [&](uint32_t i) { frame(overflow, 14, i); }));
+    EXPECT_FALSE(renderer.isDirty());
+}
+
+/**
+ * Test: PomodoroSequence lookups and Statistics aggregates
+ */
+TEST(MicroBenchTest, SequenceAndStatistics) {
+    MicroBench bench(baselinePath().c_str());
+
+    PomodoroSequence sequence;
+    sequence.setSessionsBeforeLong(4);
+    sequence.setNumCycles(3);
+    sequence.start();
+    for (int i = 0; i < 5; i++) sequence.advance();
+    uint8_t intervals = sequence.getTotalIntervals();
+    ASSERT_GT(intervals, 0);
+
+    EXPECT_TRUE(bench.expect("sequence.current_session", 200000, [&](uint32_t) {
+        MicroBench::keep(sequence.getCurrentSession());
+    }));
+    EXPECT_TRUE(bench.expect("sequence.seconds_to_end", 200000, [&](uint32_t i) {
+        MicroBench::keep(sequence.getSecondsToSequenceEnd(i & 1023));
+    }));
+    EXPECT_TRUE(bench.expect("sequence.interval_lookup", 200000, [&](uint32_t i) {
+        MicroBench::keep(sequence.getInterval(static_cast<uint8_t>(i % intervals + 1)));
+    }));
+
+    // 90 days of history, a few sessions a day
+    preferences_shim::clearAll();
+    initSyncPrimitives();
+    arduino_shim::setEpoch(EPOCH_2025_01_10);
+    Statistics statistics;
+    ASSERT_TRUE(statistics.begin());
+    for (int day = 0; day < HISTORY_DAYS; day++) {
+        arduino_shim::setEpoch(EPOCH_2025_01_10 + day * 86400LL);
+        for (int s = 0; s < 1 + day % 5; s++) statistics.recordWorkSession(25, s % 4 != 3);
+        statistics.recordBreakSession(5);
+    }
+    ASSERT_GT(statistics.getLast30DaysTotal(), 0);
+
+    EXPECT_TRUE(bench.expect("stats.last7_total", 2000, [&](uint32_t) {
+        MicroBench::keep(statistics.getLast7DaysTotal());
+    }));
+    EXPECT_TRUE(bench.expect("stats.last30_total", 500, [&](uint32_t) {
+        MicroBench::keep(statistics.getLast30DaysTotal());
+    }));
+    EXPECT_TRUE(bench.expect("stats.completion_rate", 500, [&](uint32_t) {
+        MicroBench::keep(statistics.getCompletionRate());
+    }));
+
+    cleanupSyncPrimitives();
+    arduino_shim::setEpoch(0);
+}
+
+/**
+ * Test: Touch dispatch over N widgets and LED pattern ticks
+ */
+TEST(MicroBenchTest, TouchAndLeds) {
+    MicroBench bench(baselinePath().c_str());
+
+    // Widgets on a grid, touches spread over the screen (hits and misses)
+    MockWidget widgets[TouchEventManager::MAX_WIDGETS];
+    for (size_t i = 0; i < TouchEventManager::MAX_WIDGETS; i++) {
+        widgets[i].setBounds(static_cast<int16_t>((i % 8) * 40), static_cast<int16_t>(20 + (i / 8) * 50), 36, 40);
+    }
+    auto touch = [&](TouchEventManager& manager, uint32_t i) {
+        int16_t x = static_cast<int16_t>((i * 37) % 320);
+        int16_t y = static_cast<int16_t>((i * 53) % 240);
+        manager.handleTouch(x, y, true);
+        manager.handleTouch(x, y, false);
+    };
+    TouchEventManager few;
+    TouchEventManager many;
+    for (int i = 0; i < 8; i++) ASSERT_TRUE(few.addWidget(&widgets[i]));
+    for (size_t i = 0; i < TouchEventManager::MAX_WIDGETS; i++) ASSERT_TRUE(many.addWidget(&widgets[i]));
+
+    EXPECT_TRUE(bench.expect("touch.handle_8", 100000, [&](uint32_t i) { touch(few, i); }));
+    EXPECT_TRUE(bench.expect("touch.handle_32", 100000, [&](uint32_t i) { touch(many, i); }));
+    EXPECT_GT(widgets[0].onTouchCount(), 0);
+
+    // One tick = 50 ms of virtual time + update() (every tick renders a frame)
+    arduino_shim::setMillis(1000);
+    LEDController leds;
+    ASSERT_TRUE(leds.begin());
+    auto tick = [&](uint32_t) {
+        arduino_shim::advanceMillis(50);
+        leds.update();
+    };
+
+    leds.setPattern(ILEDController::Pattern::PULSE, ILEDController::Color::Red());
+    EXPECT_TRUE(bench.expect("led.tick_pulse", 20000, tick));
+    leds.setPattern(ILEDController::Pattern::RAINBOW);
+    EXPECT_TRUE(bench.expect("led.tick_rainbow", 20000, tick));
+    leds.setPattern(ILEDController::Pattern::CONFETTI);
+    EXPECT_TRUE(bench.expect("led.tick_confetti", 20000, tick));
+
+    arduino_shim::setMillis(0);
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,203 @@
+/**
+ * Unit Test: NVS write accounting and flash lifetime projection
+ *
+ * Checks the NvsAccounting page model against the ESP-IDF NVS layout
+ * (env:native):
+ * - Entry sizes per item type
+ * - Identical writes skipped, overwrites mark the old copy erased
+ * - Garbage collection erase rate and wear spread for a hot key
+ * - Partition full once the live set exceeds the non-reserve pages
+ * - Config::save() through NvsPreferences
+ * - Lifetime projection from a simulated usage profile
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include "sim/NvsLifetimeSim.h"
+#include "../src/utils/NvsPreferences.h"
+
+using ItemType = NvsAccounting::ItemType;
+
+class NvsAccountingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        preferences_shim::clearAll();
+        NvsAccounting::begin();
+    }
+};
+
+/**
+ * Test: Item sizes match the NVS entry layout
+ */
+TEST_F(NvsAccountingTest, EntriesPerItemType) {
+    EXPECT_EQ(1u, NvsAccounting::entriesFor(ItemType::U8, 1));
+    EXPECT_EQ(1u, NvsAccounting::entriesFor(ItemType::U32, 4));
+    EXPECT_EQ(2u, NvsAccounting::entriesFor(ItemType::STR, 1));     // "" → 1 byte
+    EXPECT_EQ(2u, NvsAccounting::entriesFor(ItemType::STR, 32));
+    EXPECT_EQ(3u, NvsAccounting::entriesFor(ItemType::STR, 33));
+    EXPECT_EQ(3u, NvsAccounting::entriesFor(ItemType::BLOB, 12));   // Statistics::DayStats
+    EXPECT_EQ(4u, NvsAccounting::entriesFor(ItemType::BLOB, 33));
+}
+
+/**
+ * Test: Same value is skipped, new value erases the old copy
+ */
+TEST_F(NvsAccountingTest, IdenticalWritesSkipped) {
+    NvsPreferences prefs;
+    ASSERT_TRUE(prefs.begin("test", false));
+
+    prefs.putUShort("value", 25);
+    prefs.putUShort("value", 25);
+    prefs.putUShort("value", 30);
+
+    NvsAccounting::KeyStats stats;
+    ASSERT_TRUE(NvsAccounting::getKey("test", "value", stats));
+    EXPECT_EQ(3u, stats.puts);
+    EXPECT_EQ(1u, stats.skipped);
+    EXPECT_EQ(2u, stats.writes);
+    EXPECT_EQ(2u, stats.entries);
+
+    // Namespace entry + one live copy
+    EXPECT_EQ(2u, NvsAccounting::getLiveEntries());
+
+    NvsAccounting::PageStats pages[NvsAccounting::MAX_PAGES];
+    ASSERT_EQ(5u, NvsAccounting::getPages(pages, NvsAccounting::MAX_PAGES));
+    EXPECT_EQ(NvsAccounting::PAGE_ACTIVE, pages[0].state);
+    EXPECT_EQ(3u, pages[0].used);
+    EXPECT_EQ(1u, pages[0].erased);
+
+    prefs.remove("value");
+    EXPECT_EQ(1u, NvsAccounting::getLiveEntries());
+
+    // Read-only opens never write
+    NvsPreferences reader;
+    ASSERT_TRUE(reader.begin("other", true));
+    reader.putUChar("x", 1);
+    EXPECT_EQ(3u, NvsAccounting::getTotals().writes);
+}
+
+/**
+ * Test: A hot 12-byte blob costs one erase per 42 writes, spread over the pages
+ */
+TEST_F(NvsAccountingTest, HotKeyEraseRateAndWearSpread) {
+    NvsPreferences prefs;
+    ASSERT_TRUE(prefs.begin("stats", false));
+
+    Statistics::DayStats day = {};
+    const uint32_t writes = 10000;
+    for (uint32_t i = 0; i < writes; i++) {
+        day.completed_sessions = static_cast<uint16_t>(i);
+        prefs.putBytes("day_0", &day, sizeof(day));
+    }
+
+    auto totals = NvsAccounting::getTotals();
+    EXPECT_EQ(writes + 1, totals.writes);   // + namespace entry
+    EXPECT_EQ(0u, totals.failed_writes);
+
+    // 126 / 3 entries per page, first 4 pages fill before the first GC
+    uint32_t expected = (writes * 3 + 1) / NvsAccounting::ENTRIES_PER_PAGE - 4;
+    EXPECT_NEAR(expected, totals.page_erases, 2);
+
+    // The page holding the cold namespace entry never has the most erased
+    // entries, so it is never collected: wear rotates over the other four
+    NvsAccounting::PageStats pages[NvsAccounting::MAX_PAGES];
+    size_t count = NvsAccounting::getPages(pages, NvsAccounting::MAX_PAGES);
+    uint32_t min_erases = UINT32_MAX, max_erases = 0, pinned = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (pages[i].erase_count == 0) {
+            pinned++;
+            continue;
+        }
+        min_erases = std::min(min_erases, pages[i].erase_count);
+        max_erases = std::max(max_erases, pages[i].erase_count);
+    }
+    EXPECT_EQ(1u, pinned);
+    EXPECT_LE(max_erases - min_erases, 1u);
+
+    auto projection = NvsAccounting::projectLifetime(1.0f);
+    EXPECT_EQ(max_erases, projection.worst_page_erases);
+    EXPECT_NEAR(NvsAccounting::FLASH_ENDURANCE_CYCLES / (max_erases * 365.0f),
+                projection.years, 0.01f);
+}
+
+/**
+ * Test: Live data beyond the non-reserve pages fails instead of looping
+ */
+TEST_F(NvsAccountingTest, PartitionFullFailsWrites) {
+    NvsPreferences prefs;
+    ASSERT_TRUE(prefs.begin("fill", false));
+
+    uint8_t blob[64] = {};   // 4 entries each
+    char key[16];
+    for (uint32_t i = 0; i < NvsAccounting::MAX_KEYS - 1; i++) {
+        snprintf(key, sizeof(key), "k%lu", (unsigned long)i);
+        prefs.putBytes(key, blob, sizeof(blob));
+    }
+
+    auto totals = NvsAccounting::getTotals();
+    EXPECT_GT(totals.failed_writes, 0u);
+    EXPECT_LE(NvsAccounting::getLiveEntries(), 4 * NvsAccounting::ENTRIES_PER_PAGE);
+}
+
+/**
+ * Test: Config::save() writes every key once, unchanged saves cost nothing
+ */
+TEST_F(NvsAccountingTest, ConfigSaveSkipsUnchangedKeys) {
+    Config config;
+    ASSERT_TRUE(config.begin());   // First boot saves defaults
+
+    auto first = NvsAccounting::getTotals();
+    EXPECT_GT(first.writes, 25u);
+    EXPECT_EQ(0u, first.skipped);
+
+    config.save();
+    auto unchanged = NvsAccounting::getTotals();
+    EXPECT_EQ(first.writes, unchanged.writes);
+    EXPECT_EQ(first.writes - 1, unchanged.skipped);   // Namespace entry is not a put
+
+    Config::UISettings ui = config.getUI();
+    ui.brightness = 40;
+    config.setUI(ui);
+    config.save();
+    auto changed = NvsAccounting::getTotals();
+    EXPECT_EQ(unchanged.writes + 1, changed.writes);
+
+    NvsAccounting::KeyStats ssid;
+    ASSERT_TRUE(NvsAccounting::getKey("config", "net_ssid", ssid));
+    EXPECT_EQ(ItemType::STR, ssid.type);
+    EXPECT_EQ(2u, ssid.entries);
+}
+
+/**
+ * Test: One year of the default usage profile, projected lifetime
+ */
+TEST_F(NvsAccountingTest, LifetimeProjectionFromUsageProfile) {
+    NvsLifetimeSim::UsageProfile profile;
+    NvsLifetimeSim sim(profile);
+    auto result = sim.run(365);
+    result.print();
+    NvsAccounting::printReport(365.0f);
+
+    EXPECT_GT(result.stats_records, 0u);
+    EXPECT_EQ(104u, result.config_saves);
+    EXPECT_EQ(0u, result.totals.failed_writes);
+    EXPECT_GT(result.totals.page_erases, 0u);
+    EXPECT_GT(result.projection.years, 10.0f);
+
+    // Day blobs dominate: 90 rolling keys, one write per record
+    NvsAccounting::KeyStats top[4];
+    ASSERT_GT(NvsAccounting::getTopKeys(top, 4), 0u);
+    EXPECT_STREQ("stats", top[0].ns);
+    EXPECT_EQ(0, strncmp("day_", top[0].key, 4));
+
+    // Twice the usage → at least as many erases
+    profile.day.user.day_end_min = 21 * 60;
+    profile.active_days_per_week = 7;
+    NvsLifetimeSim heavy(profile);
+    auto heavy_result = heavy.run(365);
+    EXPECT_GT(heavy_result.totals.page_erases, result.totals.page_erases);
+    EXPECT_LT(heavy_result.projection.years, result.projection.years);
+}
+
+#endif  // NATIVE_BUILD
@@ -0,0 +1,154 @@
+/**
+ * Unit Test: PomodoroSequence schedule table
+ *
+ * The sequence is compiled into a table when settings change; these tests
+ * check it against the interval arithmetic it replaced:
+ * - Type, duration and work session number for every supported setting
+ * - Queries follow the table through advance() and wrap-around;
+ *   advance() leaves the daily counter to TimerStateMachine
+ * - The daily counter saturates at 255 and clears at midnight
+ * - Remaining time to the end of the sequence ("ends at HH:MM")
+ * - Setters rebuild the table, out-of-range restore wraps to 1
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include "../src/core/PomodoroSequence.h"
+
+using SessionType = PomodoroSequence::SessionType;
+
+namespace {
+
+// Interval arithmetic previously done on every query
+SessionType referenceType(uint8_t number, uint8_t sessions_before_long) {
+    if (number % (sessions_before_long * 2) == 0) return SessionType::LONG_BREAK;
+    if (number % 2 == 0) return SessionType::SHORT_BREAK;
+    return SessionType::WORK;
+}
+
+uint8_t referenceWorkSession(uint8_t number, uint8_t sessions_before_long) {
+    uint8_t completed = 0;
+    for (uint8_t i = 1; i < number; i++) {
+        if (referenceType(i, sessions_before_long) == SessionType::WORK) completed++;
+    }
+    if (referenceType(number, sessions_before_long) == SessionType::WORK) return completed + 1;
+    return completed > 0 ? completed : 1;
+}
+
+void configure(PomodoroSequence& sequence, uint16_t work, uint16_t short_break,
+               uint16_t long_break, uint8_t sessions, uint8_t cycles) {
+    sequence.setWorkDuration(work);
+    sequence.setShortBreakDuration(short_break);
+    sequence.setLongBreakDuration(long_break);
+    sequence.setSessionsBeforeLong(sessions);
+    sequence.setNumCycles(cycles);
+}
+
+}  // namespace
+
+/**
+ * Test: Table matches the old arithmetic for every sessions/cycles setting
+ */
+TEST(PomodoroScheduleTest, MatchesIntervalArithmetic) {
+    for (uint8_t sessions = PomodoroSequence::MIN_SESSIONS_BEFORE_LONG;
+         sessions <= PomodoroSequence::MAX_SESSIONS_BEFORE_LONG; sessions++) {
+        for (uint8_t cycles = PomodoroSequence::MIN_CYCLES; cycles <= PomodoroSequence::MAX_CYCLES; cycles++) {
+            PomodoroSequence sequence;
+            configure(sequence, 45, 10, 30, sessions, cycles);
+            sequence.start();
+
+            uint8_t total = sessions * 2 * cycles;
+            ASSERT_EQ(total, sequence.getTotalIntervals());
+            EXPECT_EQ(sessions * cycles, sequence.getTotalWorkSessions());
+
+            uint16_t elapsed_min = 0;
+            for (uint8_t number = 1; number <= total; number++) {
+                SCOPED_TRACE(testing::Message() << (int)sessions << "x" << (int)cycles << " #" << (int)number);
+                auto session = sequence.getCurrentSession();
+                SessionType expected = referenceType(number, sessions);
+                uint16_t duration = expected == SessionType::WORK ? 45 :
+                                    expected == SessionType::SHORT_BREAK ? 10 : 30;
+
+                EXPECT_EQ(number, session.number);
+                EXPECT_EQ(expected, session.type);
+                EXPECT_EQ(duration, session.duration_min);
+                EXPECT_EQ(referenceWorkSession(number, sessions), sequence.getCurrentWorkSession());
+                EXPECT_EQ(referenceType(number % total + 1, sessions) == SessionType::LONG_BREAK,
+                          sequence.isNextLongBreak());
+                EXPECT_EQ(elapsed_min, sequence.getInterval(number).start_min);
+
+                elapsed_min += duration;
+                EXPECT_EQ(number == total, sequence.advance());
+            }
+            EXPECT_EQ(elapsed_min, sequence.getSchedule().total_min);
+            EXPECT_EQ(1, sequence.getCurrentSessionNumber());
+        }
+    }
+}
+
+/**
+ * Test: Remaining time covers the current interval plus everything after it
+ */
+TEST(PomodoroScheduleTest, ProjectsSequenceEnd) {
+    PomodoroSequence sequence;   // Classic 25/5/15 × 4, 1 cycle = 130 min
+    sequence.start();
+
+    EXPECT_EQ(105u, sequence.getMinutesAfterCurrent());
+    EXPECT_EQ(130u * 60, sequence.getSecondsToSequenceEnd(25 * 60));
+    EXPECT_EQ(105u * 60 + 90, sequence.getSecondsToSequenceEnd(90));
+
+    for (int i = 0; i < 7; i++) sequence.advance();   // Long break
+    EXPECT_TRUE(sequence.isLongBreak());
+    EXPECT_EQ(0u, sequence.getMinutesAfterCurrent());
+    EXPECT_EQ(600u, sequence.getSecondsToSequenceEnd(600));
+
+    // Two cycles: the projection spans both
+    sequence.setNumCycles(2);
+    sequence.reset();
+    EXPECT_EQ(260u - 25, sequence.getMinutesAfterCurrent());
+}
+
+/**
+ * Test: advance() through whole cycles never touches completed_today,
+ * the counter saturates
+ */
+TEST(PomodoroScheduleTest, AdvanceDoesNotCountCompletions) {
+    PomodoroSequence sequence;
+    configure(sequence, 25, 5, 15, 2, 2);
+    sequence.incrementCompletedToday();
+
+    int wraps = 0;
+    for (int i = 0; i < 3 * sequence.getTotalIntervals(); i++) {
+        if (sequence.advance()) wraps++;
+        EXPECT_EQ(1, sequence.getCompletedToday()) << "advance " << i;
+    }
+    EXPECT_EQ(3, wraps);
+    EXPECT_EQ(1, sequence.getCurrentSessionNumber());
+
+    // Saturates instead of wrapping to 0; midnight reset clears it
+    for (int i = 0; i < 300; i++) sequence.incrementCompletedToday();
+    EXPECT_EQ(255, sequence.getCompletedToday());
+    sequence.resetDailyCounter();
+    EXPECT_EQ(0, sequence.getCompletedToday());
+}
+
+/**
+ * Test: Setters rebuild the table; restored positions beyond it wrap to 1
+ */
+TEST(PomodoroScheduleTest, SettersRebuildTable) {
+    PomodoroSequence sequence;
+    sequence.setWorkDuration(50);
+    EXPECT_EQ(50, sequence.getCurrentSession().duration_min);
+    EXPECT_EQ(4 * 50 + 3 * 5 + 15, sequence.getSchedule().total_min);
+
+    sequence.setSessionsBeforeLong(20);   // Clamped to 8
+    EXPECT_EQ(16, sequence.getTotalIntervals());
+    EXPECT_EQ(SessionType::LONG_BREAK, sequence.getInterval(16).type);
+    EXPECT_EQ(SessionType::LONG_BREAK, sequence.getInterval(32).type);   // Wraps like advance()
+
+    sequence.deserialize(40);   // Interval 40 of 16
+    EXPECT_EQ(1, sequence.getCurrentSessionNumber());
+}
+
+#endif  // NATIVE_BUILD
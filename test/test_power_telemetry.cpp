@@ -0,0 +1,141 @@
+/**
+ * Unit Test: Power telemetry sampler
+ *
+ * Feeds synthetic PMIC samples to PowerTelemetry::addSample() (no I2C on
+ * the host) and checks the cached values consumers read:
+ * - I2C glitch readings and voltage spikes are rejected, real steps accepted
+ * - Coulomb counting over a simulated discharge, runtime prediction
+ * - Re-anchor to full when the charger terminates
+ * - Adaptive sampling interval, ring buffer order
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include "../src/hardware/PowerTelemetry.h"
+
+namespace {
+
+PowerTelemetry::Sample battery(uint32_t t_ms, uint16_t mv, int16_t ma) {
+    return {t_ms, mv, ma, 450, PowerTelemetry::FLAG_BATTERY};
+}
+
+}  // namespace
+
+/**
+ * Test: Glitch readings never reach consumers
+ */
+TEST(PowerTelemetryTest, RejectsOutliers) {
+    PowerTelemetry power;
+    EXPECT_FALSE(power.getSnapshot().valid);
+    EXPECT_EQ(100, power.getBatteryLevel());   // No 0% flash before the first sample
+
+    uint32_t t = 0;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(power.addSample(battery(t += 1000, 3890, -120)));
+    }
+    uint8_t level = power.getBatteryLevel();
+
+    EXPECT_FALSE(power.addSample(battery(t += 1000, 0, -120)));       // I2C glitch
+    EXPECT_FALSE(power.addSample(battery(t += 1000, 3890, -4000)));   // Saturated current
+    EXPECT_FALSE(power.addSample(battery(t += 1000, 4300, -120)));    // Single spike
+    EXPECT_EQ(level, power.getBatteryLevel());
+    EXPECT_EQ(3890, power.getSnapshot().battery_mv);
+
+    // A step that persists is real (e.g. load removed)
+    EXPECT_FALSE(power.addSample(battery(t += 1000, 4200, -20)));
+    EXPECT_TRUE(power.addSample(battery(t += 1000, 4200, -20)));
+    EXPECT_EQ(4200, power.getSnapshot().battery_mv);
+    EXPECT_EQ(4u, power.getSnapshot().rejected);
+}
+
+/**
+ * Test: One hour at 150 mA removes 150 mAh; runtime follows the average current
+ */
+TEST(PowerTelemetryTest, CoulombCountsDischarge) {
+    PowerTelemetry power;
+    ASSERT_TRUE(power.addSample(battery(0, 3890, -150)));   // OCV curve: 70%
+    auto start = power.getSnapshot();
+    EXPECT_EQ(70, start.level);
+    EXPECT_NEAR(273.0f, start.charge_mah, 0.5f);
+
+    // Voltage sags slowly; the level must come from the integrated current
+    for (uint32_t t = 10000; t <= 3600000; t += 10000) {
+        uint16_t mv = 3890 - t / 20000;
+        ASSERT_TRUE(power.addSample(battery(t, mv, -150)));
+    }
+
+    auto end = power.getSnapshot();
+    EXPECT_NEAR(123.0f, end.charge_mah, 0.5f);
+    EXPECT_EQ(32, end.level);
+    EXPECT_EQ(150, end.discharge_ma);
+    EXPECT_NEAR(49u, end.runtime_min, 1u);
+    EXPECT_FALSE(end.charging);
+}
+
+/**
+ * Test: Charger termination at full voltage re-anchors the count
+ */
+TEST(PowerTelemetryTest, AnchorsAtFullCharge) {
+    PowerTelemetry power;
+    const uint8_t charging = PowerTelemetry::FLAG_BATTERY | PowerTelemetry::FLAG_CHARGING |
+                             PowerTelemetry::FLAG_EXTERNAL;
+    const uint8_t terminated = PowerTelemetry::FLAG_BATTERY | PowerTelemetry::FLAG_EXTERNAL;
+
+    ASSERT_TRUE(power.addSample({0, 3800, 300, 450, charging}));
+    EXPECT_TRUE(power.isCharging());
+    EXPECT_EQ(0u, power.getSnapshot().runtime_min);
+    EXPECT_LT(power.getBatteryLevel(), 60);
+
+    ASSERT_TRUE(power.addSample({1000, 3900, 300, 450, charging}));
+    ASSERT_TRUE(power.addSample({2000, 4000, 300, 450, charging}));
+    ASSERT_TRUE(power.addSample({3000, 4150, 0, 450, terminated}));
+    EXPECT_FALSE(power.isCharging());
+    EXPECT_EQ(100, power.getBatteryLevel());
+    EXPECT_FLOAT_EQ(PowerTelemetry::CAPACITY_MAH, power.getSnapshot().charge_mah);
+}
+
+/**
+ * Test: Fast sampling while things change, backing off when steady
+ */
+TEST(PowerTelemetryTest, AdaptsSampleInterval) {
+    PowerTelemetry power;
+    uint32_t t = 0;
+    ASSERT_TRUE(power.addSample(battery(t, 3890, -100)));
+    EXPECT_EQ(PowerTelemetry::FAST_INTERVAL_MS, power.getSnapshot().interval_ms);
+
+    for (int i = 0; i < 6; i++) {
+        t += power.getSnapshot().interval_ms;
+        ASSERT_TRUE(power.addSample(battery(t, 3890, -100)));
+    }
+    EXPECT_EQ(PowerTelemetry::SLOW_INTERVAL_MS, power.getSnapshot().interval_ms);
+
+    // Backlight on: current jumps
+    t += power.getSnapshot().interval_ms;
+    ASSERT_TRUE(power.addSample(battery(t, 3880, -250)));
+    EXPECT_EQ(PowerTelemetry::FAST_INTERVAL_MS, power.getSnapshot().interval_ms);
+
+    // poll() on the host has no PMIC: counted as a read error, nothing cached
+    EXPECT_FALSE(power.poll(t + 60000));
+    EXPECT_EQ(1u, power.getSnapshot().read_errors);
+}
+
+/**
+ * Test: History ring keeps the newest samples, oldest first
+ */
+TEST(PowerTelemetryTest, HistoryRing) {
+    PowerTelemetry power;
+    for (uint32_t i = 0; i < PowerTelemetry::HISTORY + 5; i++) {
+        ASSERT_TRUE(power.addSample(battery(i * 1000, 3890, -100 - (int16_t)i)));
+    }
+
+    PowerTelemetry::Sample samples[PowerTelemetry::HISTORY];
+    ASSERT_EQ(PowerTelemetry::HISTORY, power.getHistory(samples, PowerTelemetry::HISTORY));
+    EXPECT_EQ(5000u, samples[0].t_ms);
+    EXPECT_EQ((PowerTelemetry::HISTORY + 4) * 1000, samples[PowerTelemetry::HISTORY - 1].t_ms);
+
+    ASSERT_EQ(2u, power.getHistory(samples, 2));
+    EXPECT_EQ(-100 - (int16_t)(PowerTelemetry::HISTORY + 4), samples[1].current_ma);
+}
+
+#endif  // NATIVE_BUILD
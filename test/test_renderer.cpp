@@ -0,0 +1,58 @@
+/**
+ * Unit Test: Renderer dirty rectangle tracking
+ *
+ * Runs Renderer in env:native without begin() (no sprite needed):
+ * - Disjoint marks are kept as separate rects, overlapping marks merge
+ * - Marks are clipped to the screen, empty marks are ignored
+ * - Past MAX_DIRTY_RECTS the renderer falls back to one full-screen rect
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include "../src/ui/Renderer.h"
+
+/**
+ * Test: Disjoint marks count up, overlapping and off-screen marks do not
+ */
+TEST(RendererTest, DirtyRectsMergeAndClip) {
+    Renderer renderer;
+    renderer.clearDirty();
+    EXPECT_FALSE(renderer.isDirty());
+
+    renderer.markDirty(0, 0, 10, 10);
+    renderer.markDirty(100, 100, 10, 10);
+    EXPECT_EQ(renderer.getDirtyRectCount(), 2u);
+
+    renderer.markDirty(5, 5, 10, 10);           // Overlaps the first
+    EXPECT_EQ(renderer.getDirtyRectCount(), 2u);
+
+    renderer.markDirty(-20, -20, 10, 10);       // Fully off-screen
+    renderer.markDirty(50, 50, 0, 10);          // Empty
+    EXPECT_EQ(renderer.getDirtyRectCount(), 2u);
+
+    renderer.clearDirty();
+    EXPECT_EQ(renderer.getDirtyRectCount(), 0u);
+}
+
+/**
+ * Test: One mark past MAX_DIRTY_RECTS collapses to a full-screen refresh
+ */
+TEST(RendererTest, OverflowFallsBackToFullScreen) {
+    Renderer renderer;
+    renderer.clearDirty();
+
+    for (int i = 0; i < Renderer::MAX_DIRTY_RECTS; i++) {
+        renderer.markDirty(i * 30, 0, 4, 4);
+    }
+    EXPECT_EQ(renderer.getDirtyRectCount(), Renderer::MAX_DIRTY_RECTS);
+
+    renderer.markDirty(0, 200, 4, 4);
+    EXPECT_EQ(renderer.getDirtyRectCount(), 1u);
+
+    // Everything after that merges into the full-screen rect
+    renderer.markDirty(300, 200, 4, 4);
+    EXPECT_EQ(renderer.getDirtyRectCount(), 1u);
+}
+
+#endif // NATIVE_BUILD
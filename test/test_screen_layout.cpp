@@ -0,0 +1,113 @@
+/**
+ * Unit Test: Compile-time screen layout
+ *
+ * Checks Layout.h and the screen layout tables in env:native:
+ * - Box geometry helpers and the column / spread builders
+ * - MainScreen boxes land on the pixels the old runtime arithmetic produced
+ *   (timer center, progress bar, task name with and without progress bar)
+ * - SettingsScreen pages match the old cumulative y += getTotalHeight()
+ *   stacking, and every box stays clear of the hardware button bar
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include "../src/ui/Layout.h"
+#include "../src/ui/screens/MainScreen.h"
+#include "../src/ui/screens/SettingsScreen.h"
+
+/**
+ * Test: Box helpers and builders
+ */
+TEST(ScreenLayoutTest, BoxHelpersAndBuilders) {
+    constexpr layout::Box box = {10, 20, 30, 40};
+    static_assert(box.right() == 40 && box.bottom() == 60, "edges resolved at compile time");
+    EXPECT_EQ(25, box.centerX());
+    EXPECT_EQ(40, box.centerY());
+    EXPECT_TRUE(box.contains(10, 20));
+    EXPECT_FALSE(box.contains(40, 20));                         // Right edge exclusive
+    EXPECT_TRUE(box.overlaps({39, 59, 5, 5}));
+    EXPECT_FALSE(box.overlaps({40, 20, 5, 5}));                 // Touching is not overlapping
+    EXPECT_TRUE(box.inside(layout::SCREEN));
+
+    constexpr auto rows = layout::column(0, 10, 100, {{20, 5}, {10, 0}, {30, 2}});
+    EXPECT_EQ(10, rows[0].y);
+    EXPECT_EQ(35, rows[1].y);
+    EXPECT_EQ(45, rows[2].y);
+    EXPECT_EQ(75, layout::bottomOf(rows));
+    EXPECT_TRUE(layout::disjoint(rows));
+
+    constexpr auto cells = layout::spread<3>(6, 0, 100, 40, 4);
+    EXPECT_EQ(110, cells[1].x);
+    EXPECT_EQ(314, cells[2].right());
+    EXPECT_FALSE(layout::disjoint(layout::spread<2>(0, 0, 10, 10, -1)));
+    EXPECT_FALSE(layout::inside(layout::CONTENT, {layout::BUTTON_BAR}));
+
+    Renderer::Rect rect = box;                                  // Feeds Widget::setBounds / markDirty
+    EXPECT_EQ(30, rect.w);
+    EXPECT_TRUE(rect.contains(39, 59));
+}
+
+/**
+ * Test: MainScreen boxes match the previous runtime positions
+ */
+TEST(ScreenLayoutTest, MainScreenPositions) {
+    using L = MainScreen::Layout;
+
+    // Font heights the tables were built for
+    EXPECT_EQ(fonts::Font8.height, L::TIMER_FONT_HEIGHT);
+    EXPECT_EQ(fonts::Font2.height, L::TEXT_FONT_HEIGHT);
+    EXPECT_EQ(fonts::Font4.height, L::BADGE_FONT_HEIGHT);
+
+    EXPECT_EQ(60, L::SEQUENCE.x);
+    EXPECT_EQ(45, L::SEQUENCE.y);
+    EXPECT_EQ(160, L::TIMER.centerX());
+    EXPECT_EQ(70 + 75 / 2, L::TIMER.centerY());                 // Status + mode + sequence + gap
+    EXPECT_EQ(155, L::PROGRESS.y);                              // 20+20+20+75+10*2
+    EXPECT_EQ(20, L::PROGRESS.x);
+
+    // Task name: centered in 145..220 idle, 175..220 with the progress bar
+    EXPECT_EQ(145 + 75 / 2, L::TASK_IDLE.centerY());
+    EXPECT_EQ(175 + 45 / 2, L::TASK_ACTIVE.centerY());
+    EXPECT_LE(L::TASK_ACTIVE.bottom(), layout::BUTTON_BAR.y);
+    EXPECT_EQ(310, L::COUNT_BADGE.right());
+}
+
+/**
+ * Test: SettingsScreen pages match cumulative stacking, clear of the button bar
+ */
+TEST(ScreenLayoutTest, SettingsPagesStack) {
+    using L = SettingsScreen::Layout;
+    const std::array<layout::Box, 3> pages3[] = {L::PAGE0, L::PAGE2, L::PAGE3};
+    const std::array<layout::Box, 4> pages4[] = {L::PAGE1, L::PAGE4};
+
+    // Old constructor: y starts at 50, y += h + margin-bottom 10
+    auto expectStacked = [](const layout::Box* boxes, size_t n) {
+        int16_t y = 50;
+        for (size_t i = 0; i < n; i++) {
+            EXPECT_EQ(y, boxes[i].y) << "row " << i;
+            EXPECT_EQ(10, boxes[i].x);
+            EXPECT_EQ(300, boxes[i].w);
+            y += boxes[i].h + 10;
+        }
+    };
+    for (const auto& page : pages3) expectStacked(page.data(), page.size());
+    for (const auto& page : pages4) expectStacked(page.data(), page.size());
+
+    EXPECT_EQ(134, L::PAGE0[2].y);
+    EXPECT_EQ(164, L::PAGE1[3].y);
+    EXPECT_EQ(152, L::PAGE4[3].y);
+
+    // MP-50 mode buttons: 3 × 100px, 4px gaps, y=176, end just above the button bar
+    EXPECT_EQ(176, L::MODE_BUTTONS[0].y);
+    EXPECT_EQ(6, L::MODE_BUTTONS[0].x);
+    EXPECT_EQ(214, L::MODE_BUTTONS[2].x);
+    EXPECT_LE(layout::bottomOf(L::MODE_BUTTONS), layout::BUTTON_BAR.y);
+
+    // Page dots keep their centers (240 + i*15, 32)
+    EXPECT_EQ(240, L::PAGE_DOTS[0].centerX());
+    EXPECT_EQ(300, L::PAGE_DOTS[4].centerX());
+    EXPECT_EQ(32, L::PAGE_DOTS[2].centerY());
+}
+
+#endif // NATIVE_BUILD
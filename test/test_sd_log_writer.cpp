@@ -0,0 +1,275 @@
+/**
+ * Unit Test: Persistent buffered SD log writer
+ *
+ * Runs SDLogWriter on the host SD shim (temp directory) in env:native and
+ * measures card traffic with the shim's I/O counters:
+ * - Appends stay in RAM until a sector is full or the flush interval ends
+ * - Card writes are whole sectors except at sync points
+ * - Size-based rotation keeps N files, each starting with the preamble
+ * - Full buffer drops and counts instead of blocking
+ * - Serviced by the SD worker task; input trace round trip through the log
+ * - Telemetry workload: appendFile() per line vs the writer (writes/s, syncs)
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include <SD.h>
+#include "../src/hardware/SDManager.h"
+#include "../src/hardware/SDWorker.h"
+#include "../src/hardware/SDLogWriter.h"
+#include "../src/utils/InputTrace.h"
+
+class SDLogWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char dir_template[] = "/tmp/sdlog_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir_template));
+        root_ = dir_template;
+        fs_shim::mount(root_.c_str());
+        fs_shim::resetStats();
+        arduino_shim::setMillis(1000);
+        ASSERT_TRUE(sd_.begin());
+    }
+
+    void TearDown() override {
+        fs_shim::unmount();
+        std::filesystem::remove_all(root_);
+        arduino_shim::setMillis(0);
+    }
+
+    std::string contents(const char* path) const {
+        std::ifstream in(root_ + path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    bool fileExists(const char* path) const {
+        return std::filesystem::exists(root_ + path);
+    }
+
+    static std::string line(uint32_t i) {
+        char text[64];
+        snprintf(text, sizeof(text), "%lu,telemetry,%05lu,3.97,41.5\n",
+                 (unsigned long)(1735722000 + i), (unsigned long)i);
+        return text;
+    }
+
+    std::string root_;
+    SDManager sd_;
+};
+
+/**
+ * Test: Nothing reaches the card until a sector fills or the interval ends
+ */
+TEST_F(SDLogWriterTest, BuffersUntilSectorOrInterval) {
+    SDLogWriter log(sd_, "/logs/events.csv");
+
+    std::string expected;
+    for (uint32_t i = 0; i < 10; i++) {
+        expected += line(i);
+        ASSERT_TRUE(log.append(line(i).c_str()));
+    }
+    ASSERT_LT(expected.size(), SDLogWriter::WRITE_UNIT);
+
+    EXPECT_FALSE(log.needsService(millis()));
+    EXPECT_FALSE(log.service(millis()));
+    EXPECT_EQ(0u, fs_shim::stats().opens);
+
+    // Interval elapsed: one write + one sync for all ten lines
+    arduino_shim::advanceMillis(5000);
+    EXPECT_TRUE(log.service(millis()));
+    auto io = fs_shim::stats();
+    EXPECT_EQ(1u, io.opens);
+    EXPECT_EQ(1u, io.writes);
+    EXPECT_EQ(1u, io.syncs);
+    EXPECT_EQ(expected, contents("/logs/events.csv"));
+
+    // Nothing new: no further sync
+    arduino_shim::advanceMillis(10000);
+    EXPECT_FALSE(log.service(millis()));
+    EXPECT_EQ(1u, fs_shim::stats().syncs);
+}
+
+/**
+ * Test: Between sync points only whole sectors are written
+ */
+TEST_F(SDLogWriterTest, WritesWholeSectors) {
+    SDLogWriter log(sd_, "/logs/telemetry.csv");
+
+    std::vector<uint8_t> chunk(1800, 'x');
+    ASSERT_TRUE(log.append(chunk.data(), chunk.size()));
+    EXPECT_TRUE(log.service(millis()));
+
+    auto stats = log.getStats();
+    EXPECT_EQ(3 * SDLogWriter::WRITE_UNIT, stats.bytes_written);
+    EXPECT_EQ(1800 - 3 * SDLogWriter::WRITE_UNIT, stats.buffered);
+    EXPECT_EQ(0u, stats.syncs);
+    EXPECT_EQ(0u, fs_shim::stats().syncs);
+
+    EXPECT_TRUE(log.flush());
+    stats = log.getStats();
+    EXPECT_EQ(1800u, stats.bytes_written);
+    EXPECT_EQ(0u, stats.buffered);
+    EXPECT_EQ(1u, stats.syncs);
+    EXPECT_EQ(1800u, contents("/logs/telemetry.csv").size());
+}
+
+/**
+ * Test: Rotation keeps keep_files old files, every file starts with the preamble
+ */
+TEST_F(SDLogWriterTest, RotatesBySize) {
+    SDLogWriter::Options options;
+    options.buffer_bytes = 1024;
+    options.max_file_bytes = 2048;
+    options.keep_files = 2;
+    SDLogWriter log(sd_, "/logs/rot.bin", options);
+    log.setPreamble(reinterpret_cast<const uint8_t*>("HDR!"), 4);
+
+    std::vector<uint8_t> chunk(SDLogWriter::WRITE_UNIT, 'r');
+    for (int i = 0; i < 16; i++) {   // Preamble + 3 units per 2 KB file: 6 files
+        ASSERT_TRUE(log.append(chunk.data(), chunk.size()));
+        log.service(millis());
+    }
+    log.close();
+
+    EXPECT_EQ(5u, log.getStats().rotations);
+    EXPECT_TRUE(fileExists("/logs/rot.bin"));
+    EXPECT_TRUE(fileExists("/logs/rot.bin.1"));
+    EXPECT_TRUE(fileExists("/logs/rot.bin.2"));
+    EXPECT_FALSE(fileExists("/logs/rot.bin.3"));
+    for (const char* path : {"/logs/rot.bin", "/logs/rot.bin.1", "/logs/rot.bin.2"}) {
+        std::string data = contents(path);
+        EXPECT_LE(data.size(), options.max_file_bytes) << path;
+        EXPECT_EQ("HDR!", data.substr(0, 4)) << path;
+    }
+}
+
+/**
+ * Test: A full buffer drops and counts, it never blocks the producer
+ */
+TEST_F(SDLogWriterTest, FullBufferDrops) {
+    SDLogWriter::Options options;
+    options.buffer_bytes = 1024;
+    SDLogWriter log(sd_, "/logs/drop.csv", options);
+
+    std::vector<uint8_t> chunk(1000, 'd');
+    EXPECT_TRUE(log.append(chunk.data(), chunk.size()));
+    EXPECT_FALSE(log.append(chunk.data(), 100));
+    EXPECT_FALSE(log.append(std::vector<uint8_t>(2000, 'd').data(), 2000));
+
+    auto stats = log.getStats();
+    EXPECT_EQ(1u, stats.appends);
+    EXPECT_EQ(2u, stats.dropped);
+    EXPECT_EQ(0u, fs_shim::stats().writes);
+}
+
+/**
+ * Test: Attached to the SD worker, producers never do card I/O
+ */
+TEST_F(SDLogWriterTest, ServicedByWorker) {
+    SDWorker worker(sd_);
+    SDLogWriter log(sd_, "/logs/worker.csv");
+    ASSERT_TRUE(worker.attach(&log));
+    ASSERT_TRUE(worker.start(1));
+
+    std::string expected;
+    for (uint32_t i = 0; i < 300; i++) {
+        expected += line(i);
+        ASSERT_TRUE(log.append(line(i).c_str()));
+    }
+    EXPECT_TRUE(worker.flush(2000));   // Deep sleep path: requests + writers synced
+    worker.stop();
+
+    EXPECT_EQ(expected, contents("/logs/worker.csv"));
+    auto stats = log.getStats();
+    EXPECT_EQ(0u, stats.dropped);
+    EXPECT_GE(stats.syncs, 1u);
+}
+
+/**
+ * Test: Input trace → log writer → file decodes to the recorded events
+ */
+TEST_F(SDLogWriterTest, InputTraceRoundTrip) {
+    InputTrace::begin(1735722000);
+    SDLogWriter log(sd_, InputTrace::getPath());
+
+    for (uint32_t i = 0; i < 100; i++) {
+        arduino_shim::advanceMillis(250);
+        InputTrace::record(InputTrace::EventType::TOUCH_DOWN, 0, static_cast<int16_t>(i), 10);
+        if (i % 30 == 29) {
+            ASSERT_TRUE(InputTrace::flushTo(log));
+        }
+    }
+    ASSERT_TRUE(InputTrace::flushTo(log));
+    ASSERT_TRUE(log.flush());
+    InputTrace::stop();
+
+    std::string data = contents("/traces/input_1735722000.bin");
+    ASSERT_EQ(sizeof(InputTrace::Header) + 100 * sizeof(InputTrace::Record), data.size());
+
+    InputTrace::Reader reader(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    ASSERT_TRUE(reader.valid());
+    EXPECT_EQ(1735722000u, reader.header().start_epoch);
+    InputTrace::Event event;
+    uint32_t count = 0;
+    while (reader.next(event)) {
+        EXPECT_EQ(static_cast<int16_t>(count), event.x);
+        EXPECT_EQ(250u * (count + 1), event.t_ms);
+        count++;
+    }
+    EXPECT_EQ(100u, count);
+}
+
+/**
+ * Test: Telemetry workload, appendFile() per line vs the buffered writer
+ *
+ * 3000 lines at 10 lines/s (5 minutes of virtual time). Syncs are the FAT
+ * metadata updates the card actually has to do; lines/s is host wall clock
+ * (tmpfs) and only meaningful as a ratio.
+ */
+TEST_F(SDLogWriterTest, TelemetryWorkloadComparison) {
+    const uint32_t lines = 3000;
+
+    fs_shim::resetStats();
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < lines; i++) {
+        sd_.appendFile("/logs/direct.csv", line(i));
+        arduino_shim::advanceMillis(100);
+    }
+    double direct_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    auto direct = fs_shim::stats();
+
+    fs_shim::resetStats();
+    SDLogWriter log(sd_, "/logs/buffered.csv");
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < lines; i++) {
+        log.append(line(i).c_str());
+        log.service(millis());   // What the worker does on each wake
+        arduino_shim::advanceMillis(100);
+    }
+    log.flush();
+    double buffered_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    auto buffered = fs_shim::stats();
+
+    printf("\n  Telemetry log, %u lines over %u s\n", (unsigned)lines, (unsigned)(lines / 10));
+    printf("  %-12s %8s %8s %8s %12s\n", "", "opens", "writes", "syncs", "lines/s");
+    printf("  %-12s %8u %8u %8u %12.0f\n", "appendFile", (unsigned)direct.opens,
+           (unsigned)direct.writes, (unsigned)direct.syncs, lines / direct_s);
+    printf("  %-12s %8u %8u %8u %12.0f\n", "SDLogWriter", (unsigned)buffered.opens,
+           (unsigned)buffered.writes, (unsigned)buffered.syncs, lines / buffered_s);
+
+    EXPECT_EQ(contents("/logs/direct.csv"), contents("/logs/buffered.csv"));
+    EXPECT_EQ(lines, direct.syncs);                   // One FAT update per line
+    EXPECT_EQ(1u, buffered.opens);
+    EXPECT_LE(buffered.syncs, lines / 50 + 1);        // One per 5 s interval
+    EXPECT_LE(buffered.writes, direct.writes / 10);   // Sector-sized writes
+}
+
+#endif  // NATIVE_BUILD
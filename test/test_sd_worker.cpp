@@ -0,0 +1,249 @@
+/**
+ * Unit Test: Asynchronous SD I/O worker
+ *
+ * Runs SDManager + SDWorker against the host SD shim (a temp directory,
+ * test/native/SD.h) in env:native:
+ * - Write / append / read round trip, read buffer ownership
+ * - Repeated writes of one file coalesce into a single card write
+ * - Priority order, without overtaking earlier requests for the same file
+ * - Bounded queue rejects instead of blocking
+ * - Without the worker task, wait() on a request another caller is running
+ *   times out instead of spinning
+ * - With the worker task and a slow card, submitting never waits for I/O
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include <SD.h>
+#include "../src/hardware/SDManager.h"
+#include "../src/hardware/SDWorker.h"
+
+using Priority = SDWorker::Priority;
+
+namespace {
+
+struct Completion {
+    uint32_t id;
+    bool ok;
+    bool coalesced;
+    std::string path;
+    std::string data;
+};
+
+std::vector<Completion> g_completions;
+
+void record(SDWorker::Result& result, void*) {
+    std::string data;
+    if (result.data) data.assign(reinterpret_cast<const char*>(result.data), result.len);
+    g_completions.push_back({result.id, result.ok, result.coalesced, result.path, data});
+}
+
+const uint8_t* bytes(const char* text) {
+    return reinterpret_cast<const uint8_t*>(text);
+}
+
+}  // namespace
+
+class SDWorkerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char dir_template[] = "/tmp/sdworker_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir_template));
+        root_ = dir_template;
+        fs_shim::mount(root_.c_str());
+        fs_shim::setLatencyMs(0);
+        fs_shim::resetStats();
+        g_completions.clear();
+        ASSERT_TRUE(sd_.begin());
+    }
+
+    void TearDown() override {
+        fs_shim::setLatencyMs(0);
+        fs_shim::unmount();
+        std::filesystem::remove_all(root_);
+    }
+
+    std::string root_;
+    SDManager sd_;
+};
+
+/**
+ * Test: Requests complete through callbacks, reads hand over a NUL-terminated buffer
+ */
+TEST_F(SDWorkerTest, WriteAppendReadRoundTrip) {
+    SDWorker worker(sd_);
+
+    uint32_t w = worker.write("/config/test.txt", bytes("hello"), 5, record);
+    uint32_t a = worker.append("/config/test.txt", bytes(" world"), 6, record);
+    uint32_t r = worker.read("/config/test.txt", record);
+    uint32_t e = worker.exists("/config/missing.txt", record);
+    ASSERT_NE(0u, w);
+    ASSERT_NE(0u, a);
+    EXPECT_EQ(4u, worker.pendingCount());
+    EXPECT_TRUE(g_completions.empty());   // Nothing runs on submit
+
+    EXPECT_EQ(4u, worker.processPending());
+    ASSERT_EQ(4u, g_completions.size());
+    EXPECT_EQ(w, g_completions[0].id);
+    EXPECT_TRUE(g_completions[1].ok);
+    EXPECT_EQ(r, g_completions[2].id);
+    EXPECT_EQ("hello world", g_completions[2].data);
+    EXPECT_EQ(e, g_completions[3].id);
+    EXPECT_FALSE(g_completions[3].ok);
+
+    // Callback keeps the buffer
+    static uint8_t* kept = nullptr;
+    worker.read("/config/test.txt", [](SDWorker::Result& result, void*) {
+        kept = result.data;
+        result.data = nullptr;
+    });
+    worker.processPending();
+    ASSERT_NE(nullptr, kept);
+    EXPECT_STREQ("hello world", reinterpret_cast<char*>(kept));
+    free(kept);
+
+    auto stats = worker.getStats();
+    EXPECT_EQ(4u, stats.completed);
+    EXPECT_EQ(1u, stats.failed);   // exists() on a missing file
+    EXPECT_EQ(0u, stats.pending);
+    EXPECT_EQ(22u, stats.bytes_read);
+    EXPECT_EQ(11u, stats.bytes_written);
+}
+
+/**
+ * Test: Time backups queued while the card is busy cost one write
+ */
+TEST_F(SDWorkerTest, RepeatedWritesCoalesce) {
+    SDWorker worker(sd_);
+
+    uint32_t first = worker.write("/config/lasttime.txt", bytes("1735722000"), 10, record, nullptr, Priority::LOW);
+    for (uint32_t epoch = 1735722001; epoch <= 1735722005; epoch++) {
+        std::string text = std::to_string(epoch);
+        EXPECT_EQ(first, worker.write("/config/lasttime.txt", bytes(text.c_str()), text.size(),
+                                      record, nullptr, Priority::LOW));
+    }
+    EXPECT_EQ(1u, worker.pendingCount());
+
+    fs_shim::resetStats();
+    worker.processPending();
+    EXPECT_EQ(1u, fs_shim::stats().writes);
+
+    ASSERT_EQ(1u, g_completions.size());
+    EXPECT_TRUE(g_completions[0].coalesced);
+    EXPECT_STREQ("1735722005", sd_.readFile("/config/lasttime.txt").c_str());
+    EXPECT_EQ(5u, worker.getStats().coalesced);
+
+    // Not merged across another request for the same file
+    worker.write("/log.txt", bytes("a"), 1, record);
+    worker.append("/log.txt", bytes("b"), 1, record);
+    worker.write("/log.txt", bytes("c"), 1, record);
+    EXPECT_EQ(3u, worker.pendingCount());
+    worker.processPending();
+    EXPECT_STREQ("c", sd_.readFile("/log.txt").c_str());
+}
+
+/**
+ * Test: HIGH before NORMAL before LOW, but never ahead of earlier requests for the same file
+ */
+TEST_F(SDWorkerTest, PriorityOrderKeepsPerFileOrder) {
+    SDWorker worker(sd_);
+
+    worker.write("/low.txt", bytes("low"), 3, record, nullptr, Priority::LOW);
+    worker.write("/normal.txt", bytes("normal"), 6, record, nullptr, Priority::NORMAL);
+    worker.write("/shared.txt", bytes("queued"), 6, record, nullptr, Priority::LOW);
+    worker.read("/shared.txt", record, nullptr, Priority::HIGH);
+    worker.exists("/normal.txt", record, nullptr, Priority::HIGH);
+
+    worker.processPending();
+    ASSERT_EQ(5u, g_completions.size());
+    EXPECT_EQ("/shared.txt", g_completions[0].path);   // Write promoted by the HIGH read
+    EXPECT_EQ("/shared.txt", g_completions[1].path);
+    EXPECT_EQ("queued", g_completions[1].data);
+    EXPECT_EQ("/normal.txt", g_completions[2].path);   // exists() waits for the earlier write
+    EXPECT_EQ("/normal.txt", g_completions[3].path);
+    EXPECT_TRUE(g_completions[3].ok);
+    EXPECT_EQ("/low.txt", g_completions[4].path);
+}
+
+/**
+ * Test: A full queue rejects new requests instead of blocking
+ */
+TEST_F(SDWorkerTest, FullQueueRejects) {
+    SDWorker worker(sd_);
+
+    for (size_t i = 0; i < SDWorker::QUEUE_SLOTS; i++) {
+        std::string path = "/f" + std::to_string(i) + ".txt";
+        ASSERT_NE(0u, worker.append(path.c_str(), bytes("x"), 1));
+    }
+    EXPECT_EQ(0u, worker.append("/overflow.txt", bytes("x"), 1));
+    EXPECT_EQ(0u, worker.read("relative/path.txt"));
+    EXPECT_EQ(0u, worker.write("/empty.txt", nullptr, 0));
+
+    auto stats = worker.getStats();
+    EXPECT_EQ(3u, stats.rejected);
+    EXPECT_EQ(SDWorker::QUEUE_SLOTS, stats.max_pending);
+
+    EXPECT_TRUE(worker.flush(1000));   // No task: flush runs the queue itself
+    EXPECT_EQ(0u, worker.pendingCount());
+    EXPECT_NE(0u, worker.append("/overflow.txt", bytes("x"), 1));
+}
+
+/**
+ * Test: Without the worker task, waiting on a running request times out
+ */
+TEST_F(SDWorkerTest, WaitWithoutTaskTimesOut) {
+    SDWorker worker(sd_);
+    static bool waited = true;
+
+    // The callback runs while its request is still RUNNING on this caller
+    uint32_t id = worker.write("/busy.txt", bytes("x"), 1, [](SDWorker::Result& result, void* ctx) {
+        waited = static_cast<SDWorker*>(ctx)->wait(result.id, 20);
+    }, &worker);
+    ASSERT_NE(0u, id);
+
+    EXPECT_EQ(1u, worker.processPending());
+    EXPECT_FALSE(waited);
+    EXPECT_TRUE(worker.wait(id, 20));   // Completed once the callback returned
+}
+
+/**
+ * Test: With the worker task and a slow card, callers only pay for the enqueue
+ */
+TEST_F(SDWorkerTest, SlowCardDoesNotBlockCallers) {
+    SDWorker worker(sd_);
+    ASSERT_TRUE(worker.start(1));
+    fs_shim::setLatencyMs(20);   // Per open(): writeFile/readFile pay it at least once
+
+    static std::atomic<uint32_t> done{0};
+    done = 0;
+    auto count = [](SDWorker::Result&, void*) { done++; };
+
+    auto t0 = std::chrono::steady_clock::now();
+    uint32_t ids[4];
+    for (int i = 0; i < 4; i++) {
+        std::string path = "/traces/chunk" + std::to_string(i) + ".bin";
+        ids[i] = worker.write(path.c_str(), bytes("0123456789"), 10, count, nullptr, Priority::LOW);
+        ASSERT_NE(0u, ids[i]);
+    }
+    auto submit_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    EXPECT_LT(submit_us, 10000);   // Far below one card access (20 ms)
+
+    EXPECT_TRUE(worker.wait(ids[0], 2000));
+    EXPECT_TRUE(worker.flush(2000));
+    EXPECT_EQ(4u, done.load());
+
+    worker.stop();
+    EXPECT_FALSE(worker.isRunning());
+    EXPECT_EQ(4u, worker.getStats().completed);
+    EXPECT_TRUE(sd_.exists("/traces/chunk3.bin"));
+}
+
+#endif  // NATIVE_BUILD
@@ -0,0 +1,179 @@
+/**
+ * Unit Test: Shadow delta processor (remote settings)
+ *
+ * Feeds AWS IoT shadow delta documents to ShadowDeltaProcessor in
+ * env:native, with Config on the Preferences shim and the mock audio
+ * player / power manager:
+ * - Only fields that differ are applied, to Config and to the subsystem
+ *   they drive (sequence, volume, brightness); out-of-range and unknown
+ *   fields are skipped without blocking the rest
+ * - Versions: stale and replayed deltas are dropped, the applied version
+ *   survives a Config reload
+ * - One Config save per batch (NVS accounting), malformed documents
+ *   change nothing
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <Preferences.h>
+#include "../src/core/Config.h"
+#include "../src/core/PomodoroSequence.h"
+#include "../src/network/ShadowDelta.h"
+#include "../src/utils/NvsAccounting.h"
+#include "mocks/MockAudioPlayer.h"
+#include "mocks/MockPowerManager.h"
+
+using Status = ShadowDeltaProcessor::Status;
+
+class ShadowDeltaTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        preferences_shim::clearAll();
+        NvsAccounting::begin();
+        config_.begin();
+    }
+
+    ShadowDeltaProcessor::Result apply(ShadowDeltaProcessor& deltas, const char* json) {
+        return deltas.apply(json, strlen(json));
+    }
+
+    Config config_;
+    PomodoroSequence sequence_;
+    MockAudioPlayer audio_;
+    MockPowerManager power_;
+};
+
+/**
+ * Test: Only changed fields reach Config and the affected subsystems
+ */
+TEST_F(ShadowDeltaTest, AppliesOnlyChangedFields) {
+    ShadowDeltaProcessor deltas(config_, sequence_, &audio_, &power_);
+
+    // Delta topic layout; durations equal to Config, volume/cycles/haptics differ
+    auto result = apply(deltas, R"({"version":7,"timestamp":1736467200,
+        "state":{"settings":{"pomodoroDuration":25,"shortRestDuration":5,
+                             "volume":40,"cycles":2,"hapticEnabled":false,
+                             "powerMode":"BALANCED"}},
+        "metadata":{"settings":{"volume":{"timestamp":1736467200}}}})");
+    EXPECT_EQ(Status::APPLIED, result.status);
+    EXPECT_EQ(7u, result.version);
+    EXPECT_EQ(3, result.changed);
+    EXPECT_EQ(1, result.unknown);       // powerMode: no Config field
+    EXPECT_EQ(40, config_.getUI().sound_volume);
+    EXPECT_FALSE(config_.getUI().haptic_enabled);
+    EXPECT_EQ(2, config_.getPomodoro().num_cycles);
+    EXPECT_EQ(40, audio_.getVolume());
+    EXPECT_EQ(1, audio_.setVolumeCount());
+    EXPECT_EQ(0, power_.setBrightnessCount());   // Brightness not in the delta
+    EXPECT_EQ(8, sequence_.getTotalWorkSessions());
+
+    // Desired-state layout; out-of-range and wrong-type fields are rejected alone
+    result = apply(deltas, R"({"state":{"desired":{"settings":{
+        "pomodoroDuration":50,"brightness":30,"volume":400,"showSeconds":1}}},"version":8})");
+    EXPECT_EQ(Status::APPLIED, result.status);
+    EXPECT_EQ(2, result.changed);
+    EXPECT_EQ(2, result.rejected);
+    EXPECT_EQ(50, config_.getPomodoro().work_duration_min);
+    EXPECT_EQ(50, config_.getPomodoro().custom_work_min);      // MP-50: not a preset
+    EXPECT_EQ(50, sequence_.getCurrentSession().duration_min);
+    EXPECT_EQ(30, power_.getBrightness());
+    EXPECT_EQ(40, audio_.getVolume());
+    EXPECT_EQ(1, audio_.setVolumeCount());
+    EXPECT_TRUE(config_.getUI().show_seconds);
+
+    // Everything already matches: version recorded, no subsystem calls
+    result = apply(deltas, R"({"version":9,"state":{"settings":{"brightness":30,"volume":40}}})");
+    EXPECT_EQ(Status::NO_CHANGE, result.status);
+    EXPECT_EQ(9u, deltas.getVersion());
+    EXPECT_EQ(1, power_.setBrightnessCount());
+    EXPECT_EQ(1, audio_.setVolumeCount());
+}
+
+/**
+ * Test: Stale and replayed versions are dropped, version persists
+ */
+TEST_F(ShadowDeltaTest, DropsStaleVersions) {
+    {
+        ShadowDeltaProcessor deltas(config_, sequence_, &audio_, &power_);
+        EXPECT_EQ(Status::APPLIED,
+                  apply(deltas, R"({"version":12,"state":{"settings":{"volume":55}}})").status);
+
+        // Delivered out of order: older desired state must not win
+        EXPECT_EQ(Status::STALE,
+                  apply(deltas, R"({"version":11,"state":{"settings":{"volume":20}}})").status);
+        EXPECT_EQ(Status::STALE,
+                  apply(deltas, R"({"version":12,"state":{"settings":{"volume":20}}})").status);
+        EXPECT_EQ(55, config_.getUI().sound_volume);
+        EXPECT_EQ(55, audio_.getVolume());
+        EXPECT_EQ(2u, deltas.getStats().stale);
+        EXPECT_TRUE(deltas.flush());
+    }
+
+    // After a reboot the last applied version comes back from NVS
+    Config reloaded;
+    ASSERT_TRUE(reloaded.begin());
+    EXPECT_EQ(12u, reloaded.getNetwork().shadow_version);
+    EXPECT_EQ(55, reloaded.getUI().sound_volume);
+
+    ShadowDeltaProcessor deltas(reloaded, sequence_, &audio_, &power_);
+    EXPECT_EQ(Status::STALE,
+              apply(deltas, R"({"version":12,"state":{"settings":{"volume":20}}})").status);
+    EXPECT_EQ(Status::APPLIED,
+              apply(deltas, R"({"version":13,"state":{"settings":{"volume":20}}})").status);
+    EXPECT_EQ(20, reloaded.getUI().sound_volume);
+}
+
+/**
+ * Test: One Config save per batch, malformed documents change nothing
+ */
+TEST_F(ShadowDeltaTest, PersistsOncePerBatch) {
+    ShadowDeltaProcessor deltas(config_, sequence_, &audio_, &power_);
+    NvsAccounting::KeyStats before;
+    ASSERT_TRUE(NvsAccounting::getKey("config", "net_shver", before));
+
+    // Batch of three deltas, then one flush
+    apply(deltas, R"({"version":1,"state":{"settings":{"volume":10}}})");
+    apply(deltas, R"({"version":2,"state":{"settings":{"brightness":20}}})");
+    apply(deltas, R"({"version":3,"state":{"settings":{"sleepAfterMin":90,"gyroWake":false}}})");
+    EXPECT_TRUE(deltas.hasPendingSave());
+    NvsAccounting::KeyStats during;
+    ASSERT_TRUE(NvsAccounting::getKey("config", "net_shver", during));
+    EXPECT_EQ(before.puts, during.puts);          // Nothing written yet
+
+    EXPECT_TRUE(deltas.flush());
+    EXPECT_TRUE(deltas.flush());                  // Nothing pending: no second save
+    NvsAccounting::KeyStats after;
+    ASSERT_TRUE(NvsAccounting::getKey("config", "net_shver", after));
+    EXPECT_EQ(before.puts + 1, after.puts);
+    EXPECT_EQ(1u, deltas.getStats().saves);
+    EXPECT_FALSE(config_.isDirty());
+    EXPECT_EQ(90, config_.getPower().sleep_after_min);
+
+    // Malformed, truncated, unversioned, too deep: rejected before anything applies
+    const char* bad[] = {
+        R"({"version":4,"state":{"settings":{"volume":90}})",
+        R"({"version":4,"state":{"settings":{"volume":90,}}})",
+        R"({"state":{"settings":{"volume":90}}})",
+        R"({"version":4,"state":{"settings":{"volume":"9\x01"}}})",
+        R"({"version":4,"a":{"b":{"c":{"d":{"e":{"f":{"g":{"h":{}}}}}}}},"state":{"settings":{"volume":90}}})",
+    };
+    for (const char* json : bad) {
+        EXPECT_EQ(Status::INVALID, apply(deltas, json).status) << json;
+    }
+    EXPECT_EQ(10, config_.getUI().sound_volume);
+    EXPECT_EQ(3u, deltas.getVersion());
+    EXPECT_FALSE(deltas.hasPendingSave());
+
+    // Buffer not null-terminated: only len bytes are read
+    char buffer[64];
+    const char* doc = R"({"version":5,"state":{"settings":{"volume":15}}})";
+    size_t len = strlen(doc);
+    memcpy(buffer, doc, len);
+    memset(buffer + len, '}', sizeof(buffer) - len);
+    EXPECT_EQ(Status::APPLIED, deltas.apply(buffer, len).status);
+    EXPECT_EQ(15, config_.getUI().sound_volume);
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,92 @@
+/**
+ * Soak Test: 30 simulated days of the UI loop with leak and drift checks
+ *
+ * Runs SoakRunner (test/sim) in env:native: the real screens, timer,
+ * sequence, statistics and LED controller under virtual time, with
+ * millis() wrapping on day 1. Checks:
+ * - Heap live bytes and NVS entries flat after the warm-up day, dirty rects
+ *   bounded
+ * - No session drifts beyond one frame per start/resume (also while the
+ *   Stats screen is open), confetti lasts its 10 s
+ * - Midnight: completed_today restarts every day, Statistics keeps one
+ *   record per day
+ * - A session started just before the millis() wrap ends on time
+ *
+ * Resource curves (one row per day) are printed with the report.
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include "sim/SoakRunner.h"
+
+/**
+ * Test: 30 days - flat heap, bounded queues, no drift, midnight rollovers
+ */
+TEST(SoakTest, ThirtyDaysFlatAndOnTime) {
+    SoakRunner::Options options;
+    options.days = 30;
+    SoakRunner soak(options);
+
+    auto start = std::chrono::steady_clock::now();
+    SoakRunner::Report report = soak.run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.print();
+    printf("  %.1f s host time (%.0fx real time)\n", seconds, options.days * 86400.0 / seconds);
+
+    ASSERT_EQ(options.days, report.days.size());
+    SoakRunner::DayReport total = report.totals();
+    EXPECT_GT(total.work_completed, 255u);              // Enough to wrap an unreset uint8_t counter
+
+    bool wrapped = false;
+    for (const SoakRunner::DayReport& day : report.days) {
+        wrapped |= day.millis_wrapped;
+        EXPECT_GT(day.work_completed, 0u) << "day " << day.day;
+        EXPECT_EQ(day.work_completed, day.completed_today) << "day " << day.day;
+        EXPECT_EQ(0u, day.drifted_sessions) << "day " << day.day;
+        EXPECT_LE(day.dirty_peak, Renderer::MAX_DIRTY_RECTS);
+        if (day.day >= 2) {
+            const SoakRunner::DayReport& first = report.days[1];
+            EXPECT_LE(day.heap_live_bytes, first.heap_live_bytes) << "heap grows, day " << day.day;
+            EXPECT_LE(day.nvs_live_entries, first.nvs_live_entries) << "NVS grows, day " << day.day;
+        }
+    }
+    EXPECT_TRUE(wrapped);
+    EXPECT_EQ(0u, report.stats_mismatched_days);
+    EXPECT_GT(total.glances, 0u);
+    EXPECT_GT(total.milestones, 0u);
+    EXPECT_GE(report.milestone_min_ms, 10000u);
+    EXPECT_LE(report.milestone_max_ms, 10000u + options.frame_ms);
+}
+
+/**
+ * Test: A session started before the millis() wraparound ends on time
+ */
+TEST(SoakTest, MillisWraparound) {
+    initSyncPrimitives();
+
+    // Session started 10 s before the wrap ends on time
+    PomodoroSequence sequence;
+    sequence.setWorkDuration(1);
+    TimerStateMachine timer(sequence);
+    arduino_shim::setMillis(0u - 10000u);
+    ASSERT_TRUE(timer.handleEvent(TimerStateMachine::Event::START));
+    uint32_t last = millis();
+    uint32_t active_ms = 0;
+    while (timer.getState() == TimerStateMachine::State::ACTIVE && active_ms < 120000) {
+        arduino_shim::advanceMillis(33);
+        uint32_t now = millis();
+        timer.update(now - last);               // UITask: uint32_t delta
+        active_ms += now - last;
+        last = now;
+    }
+    EXPECT_EQ(TimerStateMachine::State::IDLE, timer.getState());
+    EXPECT_GE(active_ms, 60000u);
+    EXPECT_LT(active_ms, 60000u + 33u);
+
+    cleanupSyncPrimitives();
+    arduino_shim::setMillis(0);
+}
+
+#endif // NATIVE_BUILD
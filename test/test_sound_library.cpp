@@ -0,0 +1,340 @@
+/**
+ * Unit Test: Sound theme library and PSRAM clip cache
+ *
+ * Runs SoundLibrary + SDWorker against the host SD shim (a temp directory)
+ * in env:native, with the test driving processPending():
+ * - Theme manifest parsing (comments, bad lines, files kept in the folder),
+ *   legacy flat /audio layout when a theme has no manifest
+ * - Requests made before the manifest arrived are served after it
+ * - Misses queue a load and decode (32 kHz → 16 kHz), the next play hits
+ * - LRU eviction within the byte budget, pinned clips are never evicted
+ * - Prefetch of the next sounds from the PomodoroSequence schedule
+ * - AudioPlayer on a FakeSpeakerSink: a miss plays the PROGMEM sound, a hit
+ *   plays the cached clip (pinned until playback ends), update() prefetches
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include <SD.h>
+#include "../src/hardware/AudioPlayer.h"
+#include "../src/hardware/SDManager.h"
+#include "../src/hardware/SDWorker.h"
+#include "../src/hardware/SoundLibrary.h"
+#include "../src/hardware/WavDecoder.h"
+#include "../src/core/PomodoroSequence.h"
+#include "mocks/FakeSpeakerSink.h"
+
+namespace {
+
+constexpr size_t CLIP_SAMPLES = 4000;                          // 250 ms at 16 kHz
+constexpr size_t CLIP_BYTES = WavDecoder::WAV_HEADER_BYTES + CLIP_SAMPLES * 2;
+
+}  // namespace
+
+class SoundLibraryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char dir_template[] = "/tmp/soundlib_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir_template));
+        root_ = dir_template;
+        fs_shim::mount(root_.c_str());
+        fs_shim::setLatencyMs(0);
+        ASSERT_TRUE(sd_.begin());
+    }
+
+    void TearDown() override {
+        fs_shim::unmount();
+        std::filesystem::remove_all(root_);
+    }
+
+    // Mono 16-bit WAV, samples at the given rate
+    void writeWav(const std::string& path, size_t samples, uint32_t rate = WavDecoder::OUTPUT_RATE) {
+        std::vector<uint8_t> wav(WavDecoder::WAV_HEADER_BYTES + samples * 2);
+        WavDecoder::writeWavHeader(wav.data(), samples, rate);
+        for (size_t i = 0; i < samples; i++) {
+            int16_t value = static_cast<int16_t>((i % 64) * 256 - 8192);
+            wav[WavDecoder::WAV_HEADER_BYTES + 2 * i] = value & 0xFF;
+            wav[WavDecoder::WAV_HEADER_BYTES + 2 * i + 1] = (value >> 8) & 0xFF;
+        }
+        writeFile(path, std::string(wav.begin(), wav.end()));
+    }
+
+    void writeFile(const std::string& path, const std::string& data) {
+        std::filesystem::path file = root_ + path;
+        std::filesystem::create_directories(file.parent_path());
+        std::ofstream(file, std::ios::binary) << data;
+    }
+
+    void writeTheme(const char* theme, const char* manifest, const char* const* files, size_t count) {
+        std::string dir = std::string(SoundLibrary::THEMES_DIR) + "/" + theme + "/";
+        writeFile(dir + SoundLibrary::MANIFEST_FILE, manifest);
+        for (size_t i = 0; i < count; i++) {
+            writeWav(dir + files[i], CLIP_SAMPLES);
+        }
+    }
+
+    std::string root_;
+    SDManager sd_;
+};
+
+/**
+ * Test: Manifest names map to files in the theme folder; bad lines are skipped
+ */
+TEST_F(SoundLibraryTest, IndexesThemeManifest) {
+    const char* files[] = {"up.wav", "tick.wav"};
+    writeTheme("bells",
+               "# Bells theme\n"
+               "work_start = up.wav\r\n"
+               "\n"
+               "  warning=tick.wav  \n"
+               "rest_start = ../escape.wav\n"
+               "long_rest_start = /audio/abs.wav\n"
+               "no equals sign\n"
+               "work_start = up.wav\n",
+               files, 2);
+
+    SDWorker worker(sd_);
+    SoundLibrary library(worker);
+    ASSERT_TRUE(library.setTheme("bells"));
+    EXPECT_FALSE(library.setTheme("../x"));
+    EXPECT_EQ(SoundLibrary::IndexState::LOADING, library.getIndexState());
+
+    // Played before the manifest arrived: FLASH now, loaded once indexed
+    const uint8_t* data;
+    size_t len;
+    EXPECT_FALSE(library.acquire("warning", &data, &len));
+    worker.processPending();
+    EXPECT_EQ(SoundLibrary::IndexState::MANIFEST, library.getIndexState());
+    EXPECT_TRUE(library.isCached("warning"));
+
+    char path[SDWorker::MAX_PATH];
+    ASSERT_TRUE(library.resolve("work_start", path, sizeof(path)));
+    EXPECT_STREQ("/audio/themes/bells/up.wav", path);
+    ASSERT_TRUE(library.resolve("warning", path, sizeof(path)));
+    EXPECT_STREQ("/audio/themes/bells/tick.wav", path);
+    EXPECT_FALSE(library.resolve("rest_start", path, sizeof(path)));
+    EXPECT_FALSE(library.resolve("long_rest_start", path, sizeof(path)));
+    EXPECT_EQ(2u, library.getStats().clips);
+
+    ASSERT_TRUE(library.acquire("warning", &data, &len));
+    EXPECT_EQ(CLIP_BYTES, len);
+    EXPECT_EQ(0, memcmp("RIFF", data, 4));
+    library.release(data);
+
+    // Not in the theme: nothing to load, caller keeps its fallback
+    EXPECT_FALSE(library.acquire("rest_start", &data, &len));
+    EXPECT_EQ(0u, worker.pendingCount());
+
+    // Theme without a manifest: legacy flat layout
+    writeWav("/audio/rest_start.wav", CLIP_SAMPLES);
+    ASSERT_TRUE(library.setTheme("missing"));
+    worker.processPending();
+    EXPECT_EQ(SoundLibrary::IndexState::LEGACY, library.getIndexState());
+    ASSERT_TRUE(library.resolve("rest_start", path, sizeof(path)));
+    EXPECT_STREQ("/audio/rest_start.wav", path);
+    EXPECT_FALSE(library.acquire("rest_start", &data, &len));   // Miss queues the load
+    worker.processPending();
+    EXPECT_TRUE(library.acquire("rest_start", &data, &len));
+    library.release(data);
+
+    // Non-native clips are decoded on the worker: 32 kHz → 16 kHz
+    writeTheme("fast", "work_start = fast.wav\n", nullptr, 0);
+    writeWav("/audio/themes/fast/fast.wav", 2 * CLIP_SAMPLES, 32000);
+    ASSERT_TRUE(library.setTheme("fast"));
+    worker.processPending();
+    EXPECT_FALSE(library.acquire("work_start", &data, &len));
+    worker.processPending();
+    ASSERT_TRUE(library.acquire("work_start", &data, &len));
+    EXPECT_NEAR(static_cast<double>(CLIP_BYTES), static_cast<double>(len), 64.0);
+    library.release(data);
+
+    auto stats = library.getStats();
+    EXPECT_EQ(3u, stats.loads);
+    EXPECT_EQ(0u, stats.load_failures);
+    EXPECT_EQ(3u, stats.hits);
+}
+
+/**
+ * Test: Least recently used clips go first; pinned clips stay
+ */
+TEST_F(SoundLibraryTest, EvictsLeastRecentlyUsedWithinBudget) {
+    const char* files[] = {"a.wav", "b.wav", "c.wav"};
+    writeTheme("lru", "a = a.wav\nb = b.wav\nc = c.wav\nbig = big.wav\n", files, 3);
+    writeWav("/audio/themes/lru/big.wav", 3 * CLIP_SAMPLES);
+
+    SDWorker worker(sd_);
+    SoundLibrary library(worker, 2 * CLIP_BYTES + 100);   // Room for two clips
+    ASSERT_TRUE(library.setTheme("lru"));
+    worker.processPending();
+
+    const uint8_t* data;
+    size_t len;
+    EXPECT_TRUE(library.prefetch("a"));
+    EXPECT_TRUE(library.prefetch("b"));
+    worker.processPending();
+    ASSERT_TRUE(library.isCached("a"));
+    ASSERT_TRUE(library.isCached("b"));
+
+    // a played after b was loaded: b is the oldest
+    ASSERT_TRUE(library.acquire("a", &data, &len));
+    library.release(data);
+    EXPECT_TRUE(library.prefetch("c"));
+    worker.processPending();
+    EXPECT_TRUE(library.isCached("a"));
+    EXPECT_FALSE(library.isCached("b"));
+    EXPECT_TRUE(library.isCached("c"));
+    EXPECT_EQ(2 * CLIP_BYTES, library.getStats().bytes);
+
+    // c playing (pinned): b's load evicts a, although c is older
+    const uint8_t* playing;
+    ASSERT_TRUE(library.acquire("c", &playing, &len));
+    ASSERT_TRUE(library.acquire("a", &data, &len));
+    library.release(data);
+    EXPECT_TRUE(library.prefetch("b"));
+    worker.processPending();
+    EXPECT_TRUE(library.isCached("c"));
+    EXPECT_FALSE(library.isCached("a"));
+    EXPECT_TRUE(library.isCached("b"));
+    EXPECT_EQ(0, memcmp("RIFF", playing, 4));   // Still valid for the speaker
+
+    // Larger than everything unpinned can free: rejected, pinned clip intact
+    EXPECT_TRUE(library.prefetch("big"));
+    worker.processPending();
+    EXPECT_FALSE(library.isCached("big"));
+    EXPECT_TRUE(library.isCached("c"));
+    library.release(playing);
+
+    auto stats = library.getStats();
+    EXPECT_EQ(1u, stats.rejected);
+    EXPECT_EQ(3u, stats.evictions);            // b, a, then b for big
+    EXPECT_LE(stats.peak_bytes, stats.budget_bytes);
+    EXPECT_EQ(1u, stats.cached);
+
+    library.clear();
+    EXPECT_EQ(0u, library.getStats().bytes);
+}
+
+/**
+ * Test: The schedule names the next sounds; prefetched clips play as hits
+ */
+TEST_F(SoundLibraryTest, PrefetchesFromSchedule) {
+    PomodoroSequence sequence;
+    sequence.setSessionsBeforeLong(4);
+    sequence.setNumCycles(1);
+    sequence.start();
+
+    // Work session 1 (idle or running): warning, short break, work again
+    const char* names[3];
+    ASSERT_EQ(3u, SoundLibrary::predictNext(sequence, names, 3));
+    EXPECT_STREQ("warning", names[0]);
+    EXPECT_STREQ("rest_start", names[1]);
+    EXPECT_STREQ("work_start", names[2]);
+    EXPECT_EQ(1u, SoundLibrary::predictNext(sequence, names, 1));
+
+    // Work session 4 is followed by the long break
+    while (sequence.getCurrentWorkSession() < 4 || !sequence.isWorkSession()) {
+        sequence.advance();
+    }
+    ASSERT_EQ(3u, SoundLibrary::predictNext(sequence, names, 3));
+    EXPECT_STREQ("long_rest_start", names[1]);
+
+    const char* files[] = {"w.wav", "r.wav", "l.wav", "x.wav"};
+    writeTheme("default",
+               "work_start = w.wav\nrest_start = r.wav\nlong_rest_start = l.wav\nwarning = x.wav\n",
+               files, 4);
+
+    SDWorker worker(sd_);
+    SoundLibrary library(worker);
+    ASSERT_TRUE(library.setTheme(SoundLibrary::DEFAULT_THEME));
+    EXPECT_EQ(3u, library.prefetchNext(sequence));   // Deferred until indexed
+    worker.processPending();
+    EXPECT_TRUE(library.isCached("warning"));
+    EXPECT_TRUE(library.isCached("long_rest_start"));
+    EXPECT_TRUE(library.isCached("work_start"));
+    EXPECT_FALSE(library.isCached("rest_start"));    // Not next: not in memory
+
+    const uint8_t* data;
+    size_t len;
+    ASSERT_TRUE(library.acquire("warning", &data, &len));
+    library.release(data);
+    ASSERT_TRUE(library.acquire("long_rest_start", &data, &len));
+    library.release(data);
+    ASSERT_TRUE(library.acquire("warning", &data, &len));   // Second play: plain hit
+    library.release(data);
+
+    auto stats = library.getStats();
+    EXPECT_EQ(3u, stats.prefetches);
+    EXPECT_EQ(2u, stats.prefetch_hits);
+    EXPECT_EQ(3u, stats.hits);
+    EXPECT_EQ(0u, stats.misses);
+
+    // Already cached: prefetch only refreshes the LRU age
+    EXPECT_EQ(3u, library.prefetchNext(sequence));
+    EXPECT_EQ(0u, worker.pendingCount());
+}
+
+/**
+ * Test: AudioPlayer plays cached clips, falls back to PROGMEM on a miss
+ * and prefetches the schedule's next sounds
+ */
+TEST_F(SoundLibraryTest, AudioPlayerPlaysThroughCache) {
+    const char* files[] = {"w.wav", "r.wav", "l.wav", "x.wav"};
+    writeTheme("default",
+               "work_start = w.wav\nrest_start = r.wav\nlong_rest_start = l.wav\nwarning = x.wav\n",
+               files, 4);
+
+    SDWorker worker(sd_);
+    SoundLibrary library(worker);
+    ASSERT_TRUE(library.setTheme(SoundLibrary::DEFAULT_THEME));
+    worker.processPending();
+
+    FakeSpeakerSink speaker(64);
+    AudioPlayer player(speaker);
+    ASSERT_TRUE(player.begin(&sd_, &library));
+    EXPECT_EQ(AudioPlayer::AudioSource::SD_CARD, player.getAudioSource());
+
+    // Miss: PROGMEM now, the load is queued
+    player.play(IAudioPlayer::Sound::WARNING);
+    EXPECT_EQ(wav_warning, speaker.lastWav());
+    EXPECT_EQ(1u, library.getStats().misses);
+    player.stop();
+    worker.processPending();
+
+    // Hit: the cached clip plays and stays pinned until it has finished
+    player.play(IAudioPlayer::Sound::WARNING);
+    EXPECT_NE(wav_warning, speaker.lastWav());
+    EXPECT_EQ(CLIP_BYTES, speaker.lastWavLen());
+    library.clear();
+    EXPECT_TRUE(library.isCached("warning"));
+    while (player.isPlaying()) {
+        speaker.advance(10);
+        player.update();
+    }
+    player.update();
+    library.clear();
+    EXPECT_FALSE(library.isCached("warning"));
+
+    // update() prefetches the next sounds of the schedule once per interval
+    PomodoroSequence sequence;
+    sequence.start();
+    player.setSequence(&sequence);
+    player.update();
+    worker.processPending();
+    EXPECT_TRUE(library.isCached("rest_start"));
+    player.play(IAudioPlayer::Sound::REST_START);
+    EXPECT_NE(wav_rest_start, speaker.lastWav());
+    player.stop();
+
+    auto stats = library.getStats();
+    EXPECT_EQ(2u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.prefetch_hits);
+}
+
+#endif  // NATIVE_BUILD
@@ -0,0 +1,126 @@
+/**
+ * Unit Test: StackProfiler (host replay on the FreeRTOS shim)
+ *
+ * Runs on env:native: tasks are pthreads with painted stacks, so the
+ * profiler measures real stack usage of host runs.
+ *
+ * Test scenarios:
+ * - Deeper call chains raise the task's worst case
+ * - Worst case is attributed to the scenario that produced it
+ * - Self-deleting tasks are sampled on exit, also when they exit before
+ *   the create call returns
+ * - Recommended size covers worst case + margin, rounded to 512B
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include "../src/utils/StackProfiler.h"
+
+namespace {
+
+struct DepthParam {
+    uint32_t depth;
+};
+
+// Each level burns ~256 bytes of stack; volatile keeps the frame alive
+uint32_t recurse(uint32_t depth) {
+    volatile uint8_t frame[256];
+    frame[0] = static_cast<uint8_t>(depth);
+    if (depth == 0) return frame[0];
+    return recurse(depth - 1) + frame[0];
+}
+
+void workerTask(void* param) {
+    auto* p = static_cast<DepthParam*>(param);
+    recurse(p->depth);
+    StackProfiler::onTaskExit();
+    vTaskDelete(NULL);
+}
+
+uint32_t runScenario(const char* scenario, uint32_t depth) {
+    StackProfiler::setScenario(scenario);
+    DepthParam param{depth};
+    TaskHandle_t handle = NULL;
+    EXPECT_EQ(pdPASS, StackProfiler::createTaskPinnedToCore(workerTask, "worker", 8192,
+                                                            &param, 1, &handle, 1));
+    EXPECT_TRUE(freertos_shim::waitForAllTasks());
+
+    StackProfiler::TaskRecord record;
+    EXPECT_TRUE(StackProfiler::getRecord("worker", record));
+    return record.worst_used;
+}
+
+}  // namespace
+
+class StackProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        StackProfiler::begin();
+        StackProfiler::reset();
+    }
+};
+
+/**
+ * Test: deeper scenario raises worst case, shallower one doesn't lower it
+ */
+TEST_F(StackProfilerTest, TracksWorstCaseAcrossScenarios) {
+    uint32_t shallow = runScenario("shallow", 4);
+    uint32_t deep = runScenario("deep", 40);
+    uint32_t again = runScenario("shallow_again", 4);
+
+    EXPECT_GT(shallow, 0u);
+    EXPECT_GT(deep, shallow);
+    EXPECT_EQ(deep, again);  // Worst case is sticky
+
+    StackProfiler::TaskRecord record;
+    ASSERT_TRUE(StackProfiler::getRecord("worker", record));
+    EXPECT_STREQ("deep", record.worst_scenario);
+    EXPECT_EQ(8192u, record.stack_size);
+    EXPECT_EQ(NULL, record.handle);  // Exited
+    EXPECT_TRUE(record.exited);
+    EXPECT_EQ(3u, record.samples);   // One onTaskExit() sample per run
+}
+
+/**
+ * Test: re-registering a task name keeps one record
+ */
+TEST_F(StackProfilerTest, ReusesRecordForRecreatedTask) {
+    runScenario("first", 2);
+    runScenario("second", 2);
+    EXPECT_EQ(1u, StackProfiler::getRecordCount());
+}
+
+/**
+ * Test: tasks that exit at once are sampled and never keep a stale handle
+ */
+TEST_F(StackProfilerTest, TaskExitingBeforeCreateReturns) {
+    constexpr uint32_t RUNS = 50;
+    for (uint32_t i = 0; i < RUNS; i++) {
+        runScenario("instant", 0);
+    }
+
+    StackProfiler::TaskRecord record;
+    ASSERT_TRUE(StackProfiler::getRecord("worker", record));
+    EXPECT_EQ(NULL, record.handle);
+    EXPECT_TRUE(record.exited);
+    EXPECT_EQ(RUNS, record.samples);
+}
+
+/**
+ * Test: recommended size = worst + max(25%, 1KB), rounded up to 512
+ */
+TEST_F(StackProfilerTest, RecommendsRoundedSizeWithMargin) {
+    StackProfiler::TaskRecord record{};
+
+    record.worst_used = 2000;  // 25% = 500 < 1KB minimum
+    EXPECT_EQ(3072u, StackProfiler::recommendedSize(record));
+
+    record.worst_used = 6000;  // 25% = 1500
+    EXPECT_EQ(7680u, StackProfiler::recommendedSize(record));
+
+    record.worst_used = 0;
+    EXPECT_EQ(1024u, StackProfiler::recommendedSize(record));
+}
+
+#endif  // NATIVE_BUILD
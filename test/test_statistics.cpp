@@ -0,0 +1,78 @@
+/**
+ * Unit Test: Statistics counters on long uptimes
+ *
+ * Runs Statistics in env:native on the Preferences shim and the virtual
+ * epoch:
+ * - Day counters saturate at their field width instead of wrapping
+ * - The next day starts from zero
+ * - 7/30-day and all-time totals saturate at UINT16_MAX
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <Preferences.h>
+#include "../src/core/Statistics.h"
+#include "../src/core/SyncPrimitives.h"
+
+namespace {
+
+constexpr int64_t DAY_20090 = 20090LL * 86400 + 3600;   // 01:00 on day 20090
+
+}  // namespace
+
+class StatisticsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        preferences_shim::clearAll();
+        initSyncPrimitives();
+        arduino_shim::setEpoch(DAY_20090);
+    }
+
+    void TearDown() override {
+        cleanupSyncPrimitives();
+        arduino_shim::setEpoch(0);
+    }
+};
+
+/**
+ * Test: Day counters saturate, the next day starts from zero
+ */
+TEST_F(StatisticsTest, DayCountersSaturate) {
+    Statistics statistics;
+    ASSERT_TRUE(statistics.begin());
+    for (int i = 0; i < 300; i++) statistics.recordInterruption();
+    for (int i = 0; i < 3; i++) statistics.recordWorkSession(25000, true);
+    for (int i = 0; i < 3; i++) statistics.recordBreakSession(30000);
+    Statistics::DayStats today = statistics.getToday();
+    EXPECT_EQ(255, today.interruptions);
+    EXPECT_EQ(UINT16_MAX, today.work_minutes);
+    EXPECT_EQ(UINT16_MAX, today.break_minutes);
+    EXPECT_EQ(3, today.completed_sessions);
+
+    arduino_shim::advanceEpoch(86400);
+    statistics.recordWorkSession(25, true);
+    EXPECT_EQ(1, statistics.getToday().completed_sessions);
+    EXPECT_EQ(0, statistics.getToday().interruptions);
+    EXPECT_EQ(4, statistics.getLast7DaysTotal());
+}
+
+/**
+ * Test: Totals over several days saturate instead of wrapping
+ */
+TEST_F(StatisticsTest, TotalsSaturate) {
+    Statistics statistics;
+    ASSERT_TRUE(statistics.begin());
+    for (int day = 0; day < 2; day++) {
+        for (int i = 0; i < 40000; i++) statistics.recordWorkSession(1, true);
+        arduino_shim::advanceEpoch(86400);
+    }
+    EXPECT_EQ(40000, statistics.getDate(20090).completed_sessions);
+    EXPECT_EQ(UINT16_MAX, statistics.getLast7DaysTotal());
+    EXPECT_EQ(UINT16_MAX, statistics.getLast30DaysTotal());
+    EXPECT_EQ(UINT16_MAX, statistics.getTotalCompleted());
+    EXPECT_FLOAT_EQ(100.0f, statistics.getCompletionRate());
+}
+
+#endif // NATIVE_BUILD
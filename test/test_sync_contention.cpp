@@ -0,0 +1,111 @@
+/**
+ * Stress Test: Dual-core contention on SyncPrimitives
+ *
+ * Runs the UI, sensor and network loops on real threads (env:native) and
+ * checks that the documented design holds under contention:
+ * - No lock-order violations in a clean run; MutexGuard timeouts only
+ *   behind a hold as long as a guard timeout, and such holds rare among
+ *   the takes of the lock (a loaded host may deschedule a holder for
+ *   50-100 ms, a slow operation under a lock makes them common)
+ * - An injected reversed lock order is reported
+ * - A slow NVS commit under stats_mutex shows up as timeouts
+ * - A slow network consumer shows up as shadowPublishQueue drops
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include "stress/ContentionHarness.h"
+
+/**
+ * Test: Clean run keeps lock order and (almost) never times out
+ */
+TEST(SyncContentionTest, CleanRunHasNoViolations) {
+    ContentionHarness::Config config;
+    config.duration_ms = 1000;
+    config.min_frames = 30;
+
+    ContentionHarness harness(config);
+    auto report = harness.run();
+    report.print();
+
+    EXPECT_EQ(0u, report.ranked_violations);
+    EXPECT_EQ(0u, report.inversions);
+    EXPECT_GE(report.frames, config.min_frames);
+
+    for (const auto& lock : report.locks) {
+        EXPECT_GT(lock.takes, 0u) << lock.name;
+        EXPECT_TRUE(lock.timeouts == 0 || lock.long_holds > 0) << lock.name << ": timeout without a long hold";
+        EXPECT_LE(lock.long_holds * 10, lock.takes) << lock.name << ": long holds are not outliers";
+    }
+    EXPECT_GT(report.state_changes, 0u);
+    EXPECT_GT(report.sessions_recorded, 0u);
+    EXPECT_GT(report.publishes, 0u);
+}
+
+/**
+ * Test: Network task taking shadow_state → stats is reported
+ */
+TEST(SyncContentionTest, DetectsReversedLockOrder) {
+    ContentionHarness::Config config;
+    config.duration_ms = 300;
+    config.min_frames = 10;
+    config.inject_inversion = true;
+
+    ContentionHarness harness(config);
+    auto report = harness.run();
+
+    ASSERT_GT(report.ranked_violations, 0u);
+    bool found = false;
+    for (size_t i = 0; i < report.violation_count; i++) {
+        const auto& v = report.violations[i];
+        if (v.ranked && strcmp(v.held, "shadow_state_mutex") == 0 &&
+            strcmp(v.acquired, "stats_mutex") == 0) {
+            found = true;
+            EXPECT_STREQ("networkTask", v.task);
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+/**
+ * Test: 150ms NVS commit under stats_mutex exceeds the 100ms guard timeouts
+ */
+TEST(SyncContentionTest, SlowNvsCommitCausesTimeouts) {
+    ContentionHarness::Config config;
+    config.duration_ms = 1500;
+    config.min_frames = 10;
+    config.nvs_write_delay_us = 150000;
+    config.render_stats_pct = 100;
+
+    ContentionHarness harness(config);
+    auto report = harness.run();
+
+    const auto* stats = report.lock("stats_mutex");
+    ASSERT_NE(nullptr, stats);
+    EXPECT_GT(stats->timeouts, 0u);
+    EXPECT_GT(stats->long_holds, 0u);
+    EXPECT_GT(stats->hold_max_us, 100000u);
+    EXPECT_GT(report.frames_over_budget, 0u);
+}
+
+/**
+ * Test: Slow publisher + bursty producer drops shadow updates
+ */
+TEST(SyncContentionTest, SlowConsumerDropsShadowUpdates) {
+    ContentionHarness::Config config;
+    config.duration_ms = 500;
+    config.publish_min_us = 20000;
+    config.publish_max_us = 40000;
+    config.shadow_burst = 8;
+
+    ContentionHarness harness(config);
+    auto report = harness.run();
+
+    const auto* queue = report.queue("shadowPublishQueue");
+    ASSERT_NE(nullptr, queue);
+    EXPECT_GT(queue->drops, 0u);
+    EXPECT_EQ(queue->length, queue->high_water);
+}
+
+#endif  // NATIVE_BUILD
@@ -0,0 +1,201 @@
+/**
+ * Unit Test: Virtual-time simulator (TimerStateMachine + PomodoroSequence)
+ *
+ * Runs the real state machine through simulated days on the host
+ * (env:native) and checks:
+ * - Determinism (same seed → same per-day report)
+ * - Fast mode matches per-frame stepping callback for callback
+ * - Auto-start policy from Config::PomodoroSettings is respected
+ * - Session timing error stays within one UI frame
+ * - ScreenManager::update() ticks the timer whichever screen is shown
+ * - Throughput (simulated days per second)
+ */
+
+#ifdef NATIVE_BUILD
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <Preferences.h>
+#include "../src/core/Config.h"
+#include "../src/core/Statistics.h"
+#include "../src/core/SyncPrimitives.h"
+#include "../src/ui/ScreenManager.h"
+#include "mocks/MockHapticController.h"
+#include "mocks/MockLEDController.h"
+#include "sim/PomodoroSimulator.h"
+
+namespace {
+
+PomodoroSimulator::SimConfig shortSessionConfig() {
+    PomodoroSimulator::SimConfig config;
+    config.pomodoro.work_duration_min = 3;
+    config.pomodoro.short_break_min = 1;
+    config.pomodoro.long_break_min = 2;
+    config.pomodoro.sessions_before_long = 2;
+    config.user.day_start_min = 9 * 60;
+    config.user.day_end_min = 11 * 60;
+    return config;
+}
+
+}  // namespace
+
+/**
+ * Test: Same seed produces identical days, different seed diverges
+ */
+TEST(TimerSimulatorTest, DeterministicForSeed) {
+    PomodoroSimulator::SimConfig config;
+    config.seed = 42;
+
+    PomodoroSimulator first(config);
+    PomodoroSimulator second(config);
+    for (uint32_t day = 0; day < 20; day++) {
+        auto a = first.runDay(day);
+        auto b = second.runDay(day);
+        EXPECT_TRUE(a.sameAs(b)) << "day " << day;
+        EXPECT_EQ(a.update_calls, b.update_calls);
+    }
+
+    config.seed = 43;
+    PomodoroSimulator other(config);
+    bool any_difference = false;
+    for (uint32_t day = 0; day < 20; day++) {
+        any_difference |= !other.runDay(day).sameAs(first.runDay(day));
+    }
+    EXPECT_TRUE(any_difference);
+}
+
+/**
+ * Test: Collapsed updates fire the same callbacks as per-frame stepping
+ */
+TEST(TimerSimulatorTest, FastModeMatchesExactFrames) {
+    PomodoroSimulator::SimConfig config = shortSessionConfig();
+    config.pomodoro.auto_start_work = true;
+
+    PomodoroSimulator fast(config);
+    config.exact_frames = true;
+    PomodoroSimulator exact(config);
+
+    for (uint32_t day = 0; day < 5; day++) {
+        auto a = fast.runDay(day);
+        auto b = exact.runDay(day);
+        EXPECT_TRUE(a.sameAs(b)) << "day " << day;
+        EXPECT_LT(a.update_calls, b.update_calls);
+        EXPECT_GT(a.audio_warning, 0u);
+    }
+}
+
+/**
+ * Test: Breaks auto-start, work sessions wait for the user
+ */
+TEST(TimerSimulatorTest, RespectsAutoStartPolicy) {
+    PomodoroSimulator::SimConfig config;
+    config.pomodoro.auto_start_breaks = true;
+    config.pomodoro.auto_start_work = false;
+    config.user.skip_break_pct = 0;
+
+    PomodoroSimulator sim(config);
+    auto summary = sim.run(50);
+    const auto& t = summary.totals;
+
+    // Every completed work session rolls straight into its break
+    EXPECT_EQ(t.work_completed, t.auto_starts);
+    // Nothing auto-starts after a break: one ready indicator per completed break
+    // (minus breaks that completed a cycle, which skip the timeout callback)
+    EXPECT_EQ(t.timeout_callbacks, t.work_completed + t.breaks_completed - t.cycles_completed);
+    // Session start sound fires on every entry to ACTIVE (RESUME replays it)
+    EXPECT_EQ(t.audio_work_start + t.audio_rest_start + t.audio_long_rest_start,
+              t.transitions[0][1] + t.transitions[2][1]);
+
+    config.pomodoro.auto_start_breaks = false;
+    PomodoroSimulator manual(config);
+    EXPECT_EQ(0u, manual.run(50).totals.auto_starts);
+}
+
+/**
+ * Test: Completed sessions end within one frame of their nominal duration
+ */
+TEST(TimerSimulatorTest, TimingErrorWithinOneFrame) {
+    PomodoroSimulator::SimConfig config;
+    config.frame_ms = 50;
+
+    PomodoroSimulator sim(config);
+    auto summary = sim.run(200);
+
+    ASSERT_GT(summary.totals.timed_sessions, 0u);
+    EXPECT_LT(summary.timing_error_max_ms, config.frame_ms);
+    EXPECT_GE(summary.totals.timing_error_sum_ms, 0);  // Never ends early
+}
+
+/**
+ * Test: Cycle completion stops at IDLE and triggers the celebrations
+ */
+TEST(TimerSimulatorTest, CycleCompletionStaysIdle) {
+    PomodoroSimulator::SimConfig config = shortSessionConfig();
+    config.pomodoro.auto_start_breaks = true;
+    config.pomodoro.auto_start_work = true;
+    config.user.pause_pct = 0;
+    config.user.skip_break_pct = 0;
+    config.user.stop_pct = 0;
+
+    PomodoroSimulator sim(config);
+    auto day = sim.runDay(0);
+
+    ASSERT_GT(day.cycles_completed, 0u);
+    // Only the first session of each cycle needs the user
+    EXPECT_EQ(day.manual_starts, day.cycles_completed + 1);
+    // One confetti per long break entered, one haptic per timeout (+1 per cycle)
+    EXPECT_EQ(day.led_milestones, day.audio_long_rest_start);
+    EXPECT_EQ(day.haptic_triggers,
+              day.work_completed + day.breaks_completed + day.cycles_completed);
+}
+
+/**
+ * Test: The timer keeps running while Stats or Settings is open
+ */
+TEST(TimerSimulatorTest, ScreenManagerTicksTimerOnEveryScreen) {
+    preferences_shim::clearAll();
+    initSyncPrimitives();
+    PomodoroSequence sequence;
+    TimerStateMachine timer(sequence);
+    Statistics statistics;
+    Config config;
+    MockLEDController leds;
+    MockHapticController haptic;
+    ASSERT_TRUE(config.begin());
+    ASSERT_TRUE(statistics.begin());
+    ScreenManager screens(timer, sequence, statistics, config, leds, haptic);
+
+    ASSERT_TRUE(timer.handleEvent(TimerStateMachine::Event::START));
+    uint32_t remaining = timer.getRemainingMs();
+    for (ScreenID screen : {ScreenID::MAIN, ScreenID::STATS, ScreenID::SETTINGS}) {
+        screens.navigate(screen);
+        for (int i = 0; i < 30; i++) screens.update(100);
+        EXPECT_EQ(screen, screens.getCurrentScreen());
+        EXPECT_EQ(remaining - 3000, timer.getRemainingMs()) << "screen " << static_cast<int>(screen);
+        remaining = timer.getRemainingMs();
+    }
+    EXPECT_EQ(TimerStateMachine::State::ACTIVE, timer.getState());
+
+    cleanupSyncPrimitives();
+}
+
+/**
+ * Test: Throughput - thousands of simulated days per second
+ * (about 20k/s on a single-core x86 host with -O1; printed, not asserted)
+ */
+TEST(TimerSimulatorTest, Throughput) {
+    PomodoroSimulator::SimConfig config;
+    PomodoroSimulator sim(config);
+
+    auto start = std::chrono::steady_clock::now();
+    auto summary = sim.run(2000);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    summary.print();
+    printf("  %.0f simulated days/s\n", summary.days / seconds);
+
+    EXPECT_EQ(2000u, summary.days);
+    EXPECT_GT(summary.totals.work_completed, 0u);
+}
+
+#endif  // NATIVE_BUILD
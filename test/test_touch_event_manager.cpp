@@ -1,3 +1,6 @@
+// Device-only: TouchEventManager pulls in Renderer (M5Unified)
+#ifndef NATIVE_BUILD
+
 #include <gtest/gtest.h>
 #include "../src/ui/TouchEventManager.h"
 #include "mocks/MockWidget.h"
@@ -222,3 +225,5 @@ TEST(TouchEventManagerTest, ZOrderSkipsInvisibleTopWidget) {
     EXPECT_EQ(0, top.onTouchCount());     // Top skipped (invisible)
     EXPECT_EQ(&bottom, mgr.getActiveWidget());
 }
+
+#endif  // NATIVE_BUILD
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""
+PC Sampler Report Resolver
+Turns PCPROF lines from the profiling build (env:m5stack-core2-profile)
+into a per-function profile and lists IRAM placement candidates.
+
+Usage:
+    python pc_profile.py <monitor.log> <firmware.elf> [--addr2line PATH] [--threshold PCT]
+
+Example:
+    pio device monitor -e m5stack-core2-profile | tee monitor.log
+    python pc_profile.py monitor.log .pio/build/m5stack-core2-profile/firmware.elf
+
+Only the last report in the log is used (sample counts are cumulative).
+Flash-resident functions above the threshold (default 1% of samples)
+are reported as HOT_IRAM candidates (see src/utils/Placement.h).
+"""
+
+import argparse
+import subprocess
+import sys
+from collections import defaultdict
+
+
+def read_last_report(log_file):
+    """Return [(pc, count, region)] from the last PC Sampler block in the log"""
+    reports = []
+    current = None
+
+    with open(log_file, 'r', errors='replace') as f:
+        for line in f:
+            if '=== PC Sampler ===' in line:
+                current = []
+                reports.append(current)
+            elif current is not None and 'PCPROF' in line:
+                parts = line[line.index('PCPROF'):].split()
+                if len(parts) >= 4:
+                    current.append((int(parts[1], 16), int(parts[2]), parts[3]))
+
+    return reports[-1] if reports else []
+
+
+def read_total_samples(log_file):
+    """Return total sample count from the last report header (or None)"""
+    total = None
+    with open(log_file, 'r', errors='replace') as f:
+        for line in f:
+            if ' samples (dropped=' in line:
+                total = int(line.split(' samples')[0].split()[-1])
+    return total
+
+
+def resolve(addr2line, elf_file, pcs):
+    """Map PCs to function names with addr2line (one call for all PCs)"""
+    cmd = [addr2line, '-f', '-C', '-e', elf_file] + [f"0x{pc:08x}" for pc in pcs]
+    output = subprocess.run(cmd, capture_output=True, text=True, check=True).stdout.splitlines()
+
+    # addr2line prints two lines per address: function, file:line
+    names = {}
+    for i, pc in enumerate(pcs):
+        func = output[i * 2] if i * 2 < len(output) else '??'
+        where = output[i * 2 + 1] if i * 2 + 1 < len(output) else '??:0'
+        names[pc] = (func, where)
+    return names
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Resolve PC sampler output to functions")
+    parser.add_argument('log_file', help="Serial monitor log containing PCPROF lines")
+    parser.add_argument('elf_file', help="firmware.elf of the profiled build")
+    parser.add_argument('--addr2line', default='xtensa-esp32-elf-addr2line',
+                        help="addr2line binary (default: xtensa-esp32-elf-addr2line)")
+    parser.add_argument('--threshold', type=float, default=1.0,
+                        help="Minimum %% of samples for an IRAM candidate (default: 1.0)")
+    args = parser.parse_args()
+
+    samples = read_last_report(args.log_file)
+    if not samples:
+        print("Error: No PCPROF lines found in log", file=sys.stderr)
+        sys.exit(1)
+
+    total = read_total_samples(args.log_file) or sum(count for _, count, _ in samples)
+
+    try:
+        names = resolve(args.addr2line, args.elf_file, [pc for pc, _, _ in samples])
+    except (OSError, subprocess.CalledProcessError) as e:
+        print(f"Error: addr2line failed: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    # Aggregate per function
+    functions = defaultdict(lambda: {'count': 0, 'region': '', 'where': ''})
+    for pc, count, region in samples:
+        func, where = names[pc]
+        entry = functions[func]
+        entry['count'] += count
+        entry['region'] = region
+        entry['where'] = entry['where'] or where
+
+    ranked = sorted(functions.items(), key=lambda item: item[1]['count'], reverse=True)
+
+    print(f"{'Samples':>8} {'%':>6}  {'Region':<6} Function")
+    for func, entry in ranked:
+        pct = entry['count'] * 100.0 / total
+        print(f"{entry['count']:>8} {pct:>5.1f}%  {entry['region']:<6} {func}")
+
+    print("\nIRAM candidates (flash-resident, >= {:.1f}% of samples):".format(args.threshold))
+    candidates = [(func, entry) for func, entry in ranked
+                  if entry['region'] == 'FLASH' and entry['count'] * 100.0 / total >= args.threshold]
+    if not candidates:
+        print("  (none)")
+    for func, entry in candidates:
+        print(f"  {func}  ({entry['where']})")
+
+
+if __name__ == '__main__':
+    main()